@@ -24,11 +24,12 @@ struct BaseVSInput
     float2 tex_coord   : TEXCOORD;
 #endif
 
-    float3 normal      : NORMAL;
+    // Octahedral encoded, see OctDecode
+    float2 normal      : NORMAL;
 
 #if defined(NORMAL_MAP)
-    float3 tangent     : TANGENT;
-    float3 binormal    : BINORMAL;
+    float2 tangent     : TANGENT;
+    float2 binormal    : BINORMAL;
 #endif
 
 #ifdef INSTANCED
@@ -88,11 +89,11 @@ void BaseVS(BaseVSInput input, out BasePSInput output)
     output.tex_coord = input.tex_coord;
 #endif
 
-    output.normal = mul(camera_view, mul(instance_world, float4(input.normal, 0.0f))).xyz;
+    output.normal = mul(camera_view, mul(instance_world, float4(OctDecode(input.normal), 0.0f))).xyz;
 
 #if defined(NORMAL_MAP)
-    output.tangent = mul(camera_view, mul(instance_world, float4(input.tangent, 0.0f))).xyz;
-    output.binormal = mul(camera_view, mul(instance_world, float4(input.binormal, 0.0f))).xyz;
+    output.tangent = mul(camera_view, mul(instance_world, float4(OctDecode(input.tangent), 0.0f))).xyz;
+    output.binormal = mul(camera_view, mul(instance_world, float4(OctDecode(input.binormal), 0.0f))).xyz;
 #endif
 
 }
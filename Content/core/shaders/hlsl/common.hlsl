@@ -12,4 +12,13 @@ cbuffer global_PerFrameVariables
 	float2 back_buffer_size;
 };
 
+// Decodes a unit vector stored with octahedral encoding, as used for mesh normals and tangents
+float3 OctDecode(float2 e)
+{
+	float3 n = float3(e.xy, 1.0f - abs(e.x) - abs(e.y));
+	float t = saturate(-n.z);
+	n.xy += (n.xy >= 0.0f) ? -t : t;
+	return normalize(n);
+}
+
 #endif // COMMON_HLSL
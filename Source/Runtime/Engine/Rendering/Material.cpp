@@ -46,6 +46,7 @@ namespace sb
 		{
 			Texture* texture = (Texture*)resource_manager->GetResource("texture", entry.second);
 			SetTexture(entry.first, texture->GetRenderResource());
+			_textures.push_back(texture);
 		}
 
 		_initialized = true;
@@ -81,6 +82,11 @@ namespace sb
 		_shader_params.SetResource(channel, texture);
 	}
 
+	const vector<Texture*>& Material::GetTextures() const
+	{
+		return _textures;
+	}
+
 	StringId32 Material::GetName() const
 	{
 		return _name;
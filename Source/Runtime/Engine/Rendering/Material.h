@@ -53,6 +53,9 @@ namespace sb
 		/// @brief Sets the texture for the specified channel.
 		void SetTexture(StringId32 channel, const RTexture& texture);
 
+		/// @brief Returns the texture resources used by this material.
+		const vector<Texture*>& GetTextures() const;
+
 		StringId32 GetName() const;
 
 		MaterialData* GetData();
@@ -71,6 +74,8 @@ namespace sb
 		ShaderParameters _shader_params;
 		ShaderContext* _shader_context;
 
+		vector<Texture*> _textures;
+
 		bool _initialized;
 	};
 
@@ -13,6 +13,8 @@ namespace sb
 
 	//-------------------------------------------------------------------------------
 	MeshData::MeshData()
+		: position_offset(Vec3f::ZERO),
+		position_scale(1.0f)
 	{
 	}
 	MeshData::~MeshData()
@@ -50,6 +52,8 @@ namespace sb
 
 		// Bounding volume
 		stream.Write(&data.bounding_box, sizeof(AABB));
+		stream.Write(&data.position_offset, sizeof(Vec3f));
+		stream.Write(&data.position_scale, sizeof(float));
 
 		// Write vertex data
 		uint32_t buffer_size = (uint32_t)data.vertex_data.size();
@@ -77,36 +81,45 @@ namespace sb
 		if (submesh_count)
 			stream.Write(data.submeshes.data(), submesh_count * sizeof(MeshData::SubMesh));
 
+		// Levels of detail
+		uint32_t lod_count = (uint32_t)data.lods.size();
+		stream.Write(&lod_count, 4);
+		if (lod_count)
+			stream.Write(data.lods.data(), lod_count * sizeof(MeshData::Lod));
+
 
 	}
 
 	void mesh_resource::Load(ResourceLoader::LoadContext& context)
 	{
 		uint32_t version;
-		context.file->Read(&version, 4);
+		StringId32 name;
+		VertexBufferDesc vb_desc;
+		IndexBufferDesc ib_desc;
+
+		// Header and buffer descriptions
+		File::ReadBuffer header[] = {
+			{ &version, 4 },
+			{ &name, sizeof(StringId32) },
+			{ &vb_desc, sizeof(VertexBufferDesc) },
+			{ &ib_desc, sizeof(IndexBufferDesc) }
+		};
+		context.file->ReadMany(header, 4);
 		Assert(version == MESH_RESOURCE_VERSION);
 
 		MeshData* mesh_data = new MeshData();
 		Assert(mesh_data);
 
-		context.file->Read(&mesh_data->name, sizeof(StringId32));
-
-		uint32_t s = sizeof(RenderResource);
-		s;
-
-		// Buffer descriptions
-		VertexBufferDesc vb_desc;
-		context.file->Read(&vb_desc, sizeof(VertexBufferDesc));
+		mesh_data->name = name;
 		mesh_data->vertex_buffer = RVertexBuffer(vb_desc);
-		
-		IndexBufferDesc ib_desc;
-		context.file->Read(&ib_desc, sizeof(IndexBufferDesc));
 		mesh_data->index_buffer = RIndexBuffer(ib_desc);
 
 		mesh_data->vertex_declaration.Deserialize(*context.file);
 
 		// Bounding volume
 		context.file->Read(&mesh_data->bounding_box, sizeof(AABB));
+		context.file->Read(&mesh_data->position_offset, sizeof(Vec3f));
+		context.file->Read(&mesh_data->position_scale, sizeof(float));
 
 		// Write vertex data
 		uint32_t buffer_size;
@@ -134,6 +147,13 @@ namespace sb
 		if (submesh_count)
 			context.file->Read(mesh_data->submeshes.data(), submesh_count * sizeof(MeshData::SubMesh));
 
+		// Levels of detail
+		uint32_t lod_count;
+		context.file->Read(&lod_count, 4);
+		mesh_data->lods.resize(lod_count);
+		if (lod_count)
+			context.file->Read(mesh_data->lods.data(), lod_count * sizeof(MeshData::Lod));
+
 
 		RenderResourceAllocator* render_resource_allocator = ((RenderDevice*)context.user_data)->GetResourceAllocator();
 
@@ -25,6 +25,14 @@ namespace sb
 			uint32_t material_index;
 		};
 
+		/// Level of detail, a range of sub meshes in submeshes
+		struct Lod
+		{
+			uint32_t first_submesh;
+			uint32_t submesh_count;
+			float screen_size; // The level is used when the mesh covers less than this fraction of the viewport height
+		};
+
 		StringId32 name;
 
 		RVertexBuffer vertex_buffer;
@@ -33,11 +41,17 @@ namespace sb
 
 		AABB bounding_box;
 
+		/// Positions may be quantized relative to the bounding box, the position in model space
+		///	is then position_offset + position * position_scale.
+		Vec3f position_offset;
+		float position_scale;
+
 		vector<uint8_t> vertex_data;
 		vector<uint8_t> index_data;
 
 		vector<StringId32> materials;
 		vector<SubMesh> submeshes;
+		vector<Lod> lods; // Sorted from full to lowest detail, the first level always covers the full detail mesh
 
 		MeshData();
 		~MeshData();
@@ -60,7 +74,7 @@ namespace sb
 
 	namespace mesh_resource
 	{
-		enum { MESH_RESOURCE_VERSION = 4 };
+		enum { MESH_RESOURCE_VERSION = 6 };
 
 		void Compile(MeshData& data, Stream& stream);
 
@@ -16,7 +16,10 @@ namespace sb
 			/* ET_FLOAT2 */ 8,
 			/* ET_FLOAT3 */ 12,
 			/* ET_FLOAT4 */ 16,
-			/* ET_UBYTE4 */ 4
+			/* ET_UBYTE4 */ 4,
+			/* ET_USHORT4N */ 8,
+			/* ET_SHORT2N */ 4,
+			/* ET_HALF2 */ 4
 		};
 	}
 
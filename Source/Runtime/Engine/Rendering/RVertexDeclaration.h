@@ -28,7 +28,10 @@ namespace sb
 			ET_FLOAT2,
 			ET_FLOAT3,
 			ET_FLOAT4,
-			ET_UBYTE4
+			ET_UBYTE4,
+			ET_USHORT4N,	///< Four 16-bit unsigned integers normalized to [0, 1]
+			ET_SHORT2N,		///< Two 16-bit signed integers normalized to [-1, 1]
+			ET_HALF2		///< Two 16-bit floats
 		};
 
 		struct Element
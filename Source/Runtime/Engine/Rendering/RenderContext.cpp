@@ -29,9 +29,10 @@ namespace sb
 
 	//-------------------------------------------------------------------------------
 	RenderContext::RenderContext()
-		: _data_stream(&_cmd_buffer)
 	{
-
+		// Reserving is cheap with the scratch allocator and saves growing the buffers from nothing every frame
+		_sort_cmds.reserve(INITIAL_SORT_CMD_COUNT);
+		_cmd_buffer.reserve(INITIAL_CMD_BUFFER_SIZE);
 	}
 	RenderContext::~RenderContext()
 	{
@@ -40,24 +41,30 @@ namespace sb
 	void RenderContext::WriteCommand(uint8_t command, void* data, uint32_t size, uint64_t sort_key)
 	{
 		SortCmd cmd;
-		cmd.offset = (uint32_t)_data_stream.Tell();
+		cmd.offset = (uint32_t)_cmd_buffer.size();
 		cmd.length = size + 1; // +1 for the command header
 		cmd.sort_key = sort_key;
 		cmd.buffer = &_cmd_buffer;
 
 		_sort_cmds.push_back(cmd);
 
-		_data_stream.Write(&command, 1);
-		if (size)
-		{
-			_data_stream.Write(data, size);
-		}
+		Write(&command, 1);
+		Write(data, size);
+	}
+	void RenderContext::Write(const void* data, size_t size)
+	{
+		if (!size)
+			return;
+
+		size_t offset = _cmd_buffer.size();
+		_cmd_buffer.resize(offset + size);
+		memcpy(_cmd_buffer.data() + offset, data, size);
 	}
 	//-------------------------------------------------------------------------------
 	void RenderContext::ClearContext()
 	{
 		_sort_cmds.clear();
-		_data_stream.Seek(0);
+		_cmd_buffer.clear();
 	}
 	//------------------------------------------------------------------------------
 	void RenderContext::ClearState(uint64_t sort_key)
@@ -83,8 +90,8 @@ namespace sb
 
 		WriteCommand(RC_SET_TARGETS, &cmd, sizeof(SetTargetsCmd), sort_key);
 
-		_data_stream.Write(targets.viewports, sizeof(Viewport)* cmd.num_viewports);
-		_data_stream.Write(targets.rects, sizeof(ScissorRect)* cmd.num_scissor_rects);
+		Write(targets.viewports, sizeof(Viewport)* cmd.num_viewports);
+		Write(targets.rects, sizeof(ScissorRect)* cmd.num_scissor_rects);
 	}
 	//-------------------------------------------------------------------------------
 	void RenderContext::ClearTargets(uint64_t sort_key, uint8_t flags, float color[4], float depth, uint8_t stencil)
@@ -139,22 +146,22 @@ namespace sb
 
 		// Write IA resources to stream
 		if (IsValid(block.vertex_buffer.GetHandle()))
-			_data_stream.Write(&block.vertex_buffer, sizeof(RenderResource));
+			Write(&block.vertex_buffer, sizeof(RenderResource));
 		if (IsValid(block.index_buffer.GetHandle()))
-			_data_stream.Write(&block.index_buffer, sizeof(RenderResource));
+			Write(&block.index_buffer, sizeof(RenderResource));
 		if (IsValid(block.vertex_declaration.GetHandle()))
-			_data_stream.Write(&block.vertex_declaration, sizeof(RenderResource));
+			Write(&block.vertex_declaration, sizeof(RenderResource));
 
 		// Write shader resources to stream
-		_data_stream.Write(shader_resources->resources, cmd.shader_resources_count * sizeof(RenderResource));
+		Write(shader_resources->resources, cmd.shader_resources_count * sizeof(RenderResource));
 
 		// Constant buffer info
-		_data_stream.Write(shader_resources->constant_buffers, cmd.constant_buffer_count * sizeof(RConstantBuffer));
+		Write(shader_resources->constant_buffers, cmd.constant_buffer_count * sizeof(RConstantBuffer));
 
 		// Instance data
 		if (cmd.instance_data_size)
 		{
-			_data_stream.Write(shader_resources->instance_data, cmd.instance_data_size);
+			Write(shader_resources->instance_data, cmd.instance_data_size);
 		}
 
 		// Constant data
@@ -170,7 +177,7 @@ namespace sb
 			}
 		}
 
-		_data_stream.Write(shader_resources->constant_buffer_data, constant_data_size);
+		Write(shader_resources->constant_buffer_data, constant_data_size);
 
 	}
 	//-------------------------------------------------------------------------------
@@ -204,10 +211,10 @@ namespace sb
 		WriteCommand(RC_DISPATCH, &cmd, sizeof(DispatchCmd), sort_key);
 
 		// Write shader resources to stream
-		_data_stream.Write(shader_resources->resources, cmd.shader_resources_count * sizeof(RenderResource));
+		Write(shader_resources->resources, cmd.shader_resources_count * sizeof(RenderResource));
 
 		// Constant buffer info
-		_data_stream.Write(shader_resources->constant_buffers, cmd.constant_buffer_count * sizeof(RConstantBuffer));
+		Write(shader_resources->constant_buffers, cmd.constant_buffer_count * sizeof(RConstantBuffer));
 
 		// Constant data
 		uint32_t constant_data_size = 0; // Total constant data size
@@ -222,7 +229,7 @@ namespace sb
 			}
 		}
 
-		_data_stream.Write(shader_resources->constant_buffer_data, constant_data_size);
+		Write(shader_resources->constant_buffer_data, constant_data_size);
 	}
 
 	//-------------------------------------------------------------------------------
@@ -246,7 +253,7 @@ namespace sb
 		uint32_t buffer_size = buffer.GetSize();
 
 		WriteCommand(RC_UPDATE_BUFFER, &cmd, sizeof(UpdateBufferCmd), sort_key);
-		_data_stream.Write(data, buffer_size);
+		Write(data, buffer_size);
 	}
 
 	//-------------------------------------------------------------------------------
@@ -254,7 +261,7 @@ namespace sb
 	{
 		return _sort_cmds;
 	}
-	vector<uint8_t>* RenderContext::GetCmdBuffer()
+	RenderContext::CommandBuffer* RenderContext::GetCmdBuffer()
 	{
 		return &_cmd_buffer;
 	}
@@ -35,6 +35,12 @@ namespace sb
 
 		};
 
+		enum
+		{
+			INITIAL_SORT_CMD_COUNT = 1024,
+			INITIAL_CMD_BUFFER_SIZE = 256 * 1024
+		};
+
 
 
 		struct SetTargetsCmd
@@ -123,6 +129,9 @@ namespace sb
 		};
 
 
+		/// Command data, contexts only live for a frame so the buffer is allocated from the scratch allocator
+		typedef vector<uint8_t, stl_scratch_allocator<uint8_t>> CommandBuffer;
+
 		/// @brief Struct for a sort key
 		///
 		///	Sort key is a uint64_t used for sorting rendering commands
@@ -138,10 +147,10 @@ namespace sb
 			uint32_t offset;		// Offset in the command buffer
 			uint32_t length;		// Length in the command buffer
 
-			vector<uint8_t>* buffer;		// Pointer to the command buffer
+			CommandBuffer* buffer;		// Pointer to the command buffer
 		};
 
-		typedef vector<SortCmd> SortCmdList;
+		typedef vector<SortCmd, stl_scratch_allocator<SortCmd>> SortCmdList;
 
 
 	public:
@@ -186,17 +195,19 @@ namespace sb
 		void ClearContext();
 
 		const SortCmdList& GetSortCmds() const;
-		vector<uint8_t>* GetCmdBuffer();
+		CommandBuffer* GetCmdBuffer();
 
 	private:
 		void WriteCommand(uint8_t command, void* data, uint32_t size, uint64_t sort_key);
 
+		/// Appends data to the command buffer
+		void Write(const void* data, size_t size);
+
 
 	private:
 		SortCmdList	_sort_cmds;
 
-		vector<uint8_t> _cmd_buffer;
-		DynamicMemoryStream	_data_stream; ///< Helper class just to make writing a bit easier
+		CommandBuffer _cmd_buffer;
 
 	};
 
@@ -8,10 +8,22 @@
 namespace sb
 {
 
+	namespace
+	{
+		LinearAllocator::ArenaSettings ResourceDataArena()
+		{
+			// Texture uploads can grow far beyond a typical frame, only the typical amount is kept committed between dispatches.
+			//	Frames exceeding the reserve continue in heap chunks until the allocator is cleared.
+			LinearAllocator::ArenaSettings settings(256 * 1024 * 1024);
+			settings.retain_size = 16 * 1024 * 1024;
+			return settings;
+		}
+	}
+
 	RenderResourceAllocator::RenderResourceAllocator(RenderDevice* device)
 		: _device(device),
 		_data_stream(&_cmd_buffer),
-		_resource_data_allocator(2048 * 2048)
+		_resource_data_allocator(ResourceDataArena())
 	{
 	}
 	RenderResourceAllocator::~RenderResourceAllocator()
@@ -25,8 +37,19 @@ namespace sb
 		uint32_t resource_handle = _handle_generator.New();
 		texture.SetHandle(resource_handle);
 
+		WriteTextureCmd(ALLOCATE_TEXTURE, texture, surface_data);
+	}
+	void RenderResourceAllocator::ReallocateTexture(RTexture& texture, const vector<image::Surface>* surface_data)
+	{
+		Assert(IsValid(texture.GetHandle()));
+		ScopedLock<CriticalSection> scoped_lock(_lock);
+
+		WriteTextureCmd(REALLOCATE_TEXTURE, texture, surface_data);
+	}
+	void RenderResourceAllocator::WriteTextureCmd(uint8_t header, RTexture& texture, const vector<image::Surface>* surface_data)
+	{
 		AllocateTextureCmd cmd;
-		cmd.resource_handle = resource_handle;
+		cmd.resource_handle = texture.GetHandle();
 		cmd.desc = texture.GetDesc();
 		cmd.num_surfaces = 0;
 
@@ -42,7 +65,6 @@ namespace sb
 				memcpy(cmd.surface_data[i], (*surface_data)[i].data, (*surface_data)[i].size);
 			}
 		}
-		uint8_t header = ALLOCATE_TEXTURE;
 		_data_stream.Write(&header, 1);
 		_data_stream.Write(&cmd, sizeof(AllocateTextureCmd));
 
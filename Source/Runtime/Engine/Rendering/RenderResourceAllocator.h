@@ -30,6 +30,8 @@ namespace sb
 			ALLOCATE_TEXTURE,
 			/// @sa ResourceMessage
 			RELEASE_TEXTURE,
+			/// @sa AllocateTextureMsg
+			REALLOCATE_TEXTURE,
 
 			/// @sa AllocateRenderTargetMsg
 			ALLOCATE_RENDER_TARGET,
@@ -131,6 +133,12 @@ namespace sb
 		/// @param surfaces Optional texture surface data.
 		void AllocateTexture(RTexture& texture, const vector<image::Surface>* surface_data = nullptr);
 
+		/// @brief Recreates an already allocated texture from its current description.
+		///	The texture keeps its handle, meaning any existing references to it stays valid. Used for 
+		///		changing the number of resident mips of streamed textures.
+		/// @param surfaces Texture surface data.
+		void ReallocateTexture(RTexture& texture, const vector<image::Surface>* surface_data);
+
 		/// @brief Allocates a new render target from the specified description.
 		void AllocateRenderTarget(RRenderTarget& render_target);
 
@@ -180,6 +188,8 @@ namespace sb
 		HandleGenerator& GetHandleGenerator();
 
 	private:
+		void WriteTextureCmd(uint8_t header, RTexture& texture, const vector<image::Surface>* surface_data);
+
 		RenderDevice* _device;
 		HandleGenerator _handle_generator;
 
@@ -4,7 +4,7 @@
 
 #include "ShaderVariable.h"
 
-#include <Foundation/Container/ConfigValue.h>
+#include <Foundation/Container/CompiledConfig.h>
 
 namespace sb
 {
@@ -106,67 +106,117 @@ namespace sb
 	}
 
 
-	bool shader_variable::ParseScalar(const ConfigValue& object, float& value)
+	namespace
 	{
-		if (object.IsNumber())
+		/// Shared by ConfigValue and CompiledConfigValue which have the same read API
+		template<typename TConfig>
+		bool ParseScalarValue(const TConfig& object, float& value)
 		{
-			value = object.AsFloat();
+			if (object.IsNumber())
+			{
+				value = object.AsFloat();
 
-			return true;
+				return true;
+			}
+			return false;
 		}
-		return false;
-	}
-	bool shader_variable::ParseVector2(const ConfigValue& object, Vec2f& value)
-	{
-		if (object.IsArray() && object.Size() == 2)
+		template<typename TConfig>
+		bool ParseVector2Value(const TConfig& object, Vec2f& value)
 		{
-			value = Vec2f(object[0].AsFloat(), object[1].AsFloat());
+			if (object.IsArray() && object.Size() == 2)
+			{
+				value = Vec2f(object[0].AsFloat(), object[1].AsFloat());
 
-			return true;
+				return true;
+			}
+			return false;
 		}
-		return false;
-	}
-	bool shader_variable::ParseVector3(const ConfigValue& object, Vec3f& value)
-	{
-		if (object.IsArray() && object.Size() == 3)
+		template<typename TConfig>
+		bool ParseVector3Value(const TConfig& object, Vec3f& value)
 		{
-			value = Vec3f(object[0].AsFloat(), object[1].AsFloat(), object[2].AsFloat());
+			if (object.IsArray() && object.Size() == 3)
+			{
+				value = Vec3f(object[0].AsFloat(), object[1].AsFloat(), object[2].AsFloat());
 
-			return true;
+				return true;
+			}
+			return false;
 		}
-		return false;
-	}
-	bool shader_variable::ParseVector4(const ConfigValue& object, Vec4f& value)
-	{
-		if (object.IsArray() && object.Size() == 4)
+		template<typename TConfig>
+		bool ParseVector4Value(const TConfig& object, Vec4f& value)
 		{
-			value = Vec4f(object[0].AsFloat(), object[1].AsFloat(), object[2].AsFloat(), object[3].AsFloat());
+			if (object.IsArray() && object.Size() == 4)
+			{
+				value = Vec4f(object[0].AsFloat(), object[1].AsFloat(), object[2].AsFloat(), object[3].AsFloat());
 
-			return true;
+				return true;
+			}
+			return false;
 		}
-		return false;
-	}
-	bool shader_variable::ParseMatrix4x4(const ConfigValue& object, Mat4x4f& value)
-	{
-		if (object.IsArray() && object.Size() == 4)
+		template<typename TConfig>
+		bool ParseMatrix4x4Value(const TConfig& object, Mat4x4f& value)
 		{
-			Mat4x4f mat;
-			for (uint32_t y = 0; y < 4; ++y)
+			if (object.IsArray() && object.Size() == 4)
 			{
-				if (object[y].IsArray() && object[y].Size() == 4)
-				{
-					mat.SetRow(y, Vec4f(object[y][0].AsFloat(), object[y][1].AsFloat(), object[y][2].AsFloat(), object[y][3].AsFloat()));
-				}
-				else
+				Mat4x4f mat;
+				for (uint32_t y = 0; y < 4; ++y)
 				{
-					return false;
+					if (object[y].IsArray() && object[y].Size() == 4)
+					{
+						mat.SetRow(y, Vec4f(object[y][0].AsFloat(), object[y][1].AsFloat(), object[y][2].AsFloat(), object[y][3].AsFloat()));
+					}
+					else
+					{
+						return false;
+					}
 				}
-			}
 
-			value = mat;
-			return true;
+				value = mat;
+				return true;
+			}
+			return false;
 		}
-		return false;
+	}
+
+	bool shader_variable::ParseScalar(const ConfigValue& object, float& value)
+	{
+		return ParseScalarValue(object, value);
+	}
+	bool shader_variable::ParseScalar(const CompiledConfigValue& object, float& value)
+	{
+		return ParseScalarValue(object, value);
+	}
+	bool shader_variable::ParseVector2(const ConfigValue& object, Vec2f& value)
+	{
+		return ParseVector2Value(object, value);
+	}
+	bool shader_variable::ParseVector2(const CompiledConfigValue& object, Vec2f& value)
+	{
+		return ParseVector2Value(object, value);
+	}
+	bool shader_variable::ParseVector3(const ConfigValue& object, Vec3f& value)
+	{
+		return ParseVector3Value(object, value);
+	}
+	bool shader_variable::ParseVector3(const CompiledConfigValue& object, Vec3f& value)
+	{
+		return ParseVector3Value(object, value);
+	}
+	bool shader_variable::ParseVector4(const ConfigValue& object, Vec4f& value)
+	{
+		return ParseVector4Value(object, value);
+	}
+	bool shader_variable::ParseVector4(const CompiledConfigValue& object, Vec4f& value)
+	{
+		return ParseVector4Value(object, value);
+	}
+	bool shader_variable::ParseMatrix4x4(const ConfigValue& object, Mat4x4f& value)
+	{
+		return ParseMatrix4x4Value(object, value);
+	}
+	bool shader_variable::ParseMatrix4x4(const CompiledConfigValue& object, Mat4x4f& value)
+	{
+		return ParseMatrix4x4Value(object, value);
 	}
 
 } // namespace sb
@@ -13,6 +13,7 @@ namespace sb
 {
 
 	class ConfigValue;
+	class CompiledConfigValue;
 
 	struct ShaderVariable
 	{
@@ -77,26 +78,31 @@ namespace sb
 		/// @param value The resulting value, should be considered invalid if conversion fails.
 		/// @return True if the conversion was successful, false if not.
 		bool ParseScalar(const ConfigValue& object, float& value);
+		bool ParseScalar(const CompiledConfigValue& object, float& value);
 
 		/// Parses the value from a JSON object
 		/// @param value The resulting value, should be considered invalid if conversion fails.
 		/// @return True if the conversion was successful, false if not.
 		bool ParseVector2(const ConfigValue& object, Vec2f& value);
+		bool ParseVector2(const CompiledConfigValue& object, Vec2f& value);
 
 		/// Parses the value from a JSON object
 		/// @param value The resulting value, should be considered invalid if conversion fails.
 		/// @return True if the conversion was successful, false if not.
 		bool ParseVector3(const ConfigValue& object, Vec3f& value);
+		bool ParseVector3(const CompiledConfigValue& object, Vec3f& value);
 
 		/// Parses the value from a JSON object
 		/// @param value The resulting value, should be considered invalid if conversion fails.
 		/// @return True if the conversion was successful, false if not.
 		bool ParseVector4(const ConfigValue& object, Vec4f& value);
+		bool ParseVector4(const CompiledConfigValue& object, Vec4f& value);
 
 		/// Parses the value from a JSON object
 		/// @param value The resulting value, should be considered invalid if conversion fails.
 		/// @return True if the conversion was successful, false if not.
 		bool ParseMatrix4x4(const ConfigValue& object, Mat4x4f& value);
+		bool ParseMatrix4x4(const CompiledConfigValue& object, Mat4x4f& value);
 
 	};
 
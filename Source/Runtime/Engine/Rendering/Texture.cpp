@@ -7,14 +7,22 @@
 #include <Engine/Rendering/DDSImage.h>
 #include <Engine/Rendering/RenderDevice.h>
 #include <Engine/Rendering/RenderResourceAllocator.h>
+#include <Engine/Rendering/TextureStreamer.h>
 
 #include <Foundation/Filesystem/File.h>
+#include <Foundation/IO/Stream.h>
 
 namespace sb
 {
 
 	Texture::Texture()
+		: _resident_mip(0),
+		_tail_mip(0),
+		_file_source(nullptr),
+		_stream_index(Invalid<uint32_t>())
 	{
+		memset(_mips, 0, sizeof(_mips));
+		memset(_levels, 0, sizeof(_levels));
 	}
 	Texture::~Texture()
 	{
@@ -22,11 +30,42 @@ namespace sb
 
 	void Texture::Load(FileStreamPtr file, RenderResourceAllocator* resource_allocator)
 	{
-		// Load dds file
-		dds_image::Load(*file, _render_resource.GetDesc(), _surfaces);
+		uint32_t version;
+		File::ReadBuffer header[] = {
+			{ &version, 4 },
+			{ &_full_desc, sizeof(TextureDesc) }
+		};
+		file->ReadMany(header, 2);
+		Assert(version == texture_resource::TEXTURE_RESOURCE_VERSION);
+		Assert(_full_desc.mip_count > 0 && _full_desc.mip_count <= MAX_MIP_COUNT);
+
+		file->Read(_mips, _full_desc.mip_count * sizeof(MipInfo));
+
+		// Find the first level small enough to always be resident
+		_tail_mip = _full_desc.mip_count - 1;
+		for (uint32_t m = 0; m < _full_desc.mip_count; ++m)
+		{
+			uint32_t w = Max<uint32_t>(1, _full_desc.width >> m);
+			uint32_t h = Max<uint32_t>(1, _full_desc.height >> m);
+			if (w <= TAIL_SIZE && h <= TAIL_SIZE)
+			{
+				_tail_mip = m;
+				break;
+			}
+		}
+
+		// Levels are stored smallest first so the tail is a single block at the start of the data
+		file->Seek(_mips[_full_desc.mip_count - 1].offset);
+		for (uint32_t m = _full_desc.mip_count; m > _tail_mip; --m)
+		{
+			const MipInfo& mip = _mips[m - 1];
+			_levels[m - 1] = (uint8_t*)memory::Malloc(mip.size);
+			file->Read(_levels[m - 1], mip.size);
+		}
+		_resident_mip = _tail_mip;
 
 		// Allocate render resource
-		resource_allocator->AllocateTexture(_render_resource, &_surfaces);
+		UpdateRenderResource(resource_allocator);
 	}
 
 	void Texture::Unload(RenderResourceAllocator* resource_allocator)
@@ -35,26 +74,151 @@ namespace sb
 		resource_allocator->ReleaseResource(_render_resource);
 
 		// Free allocated memory
-		for (auto& surface : _surfaces)
+		for (uint32_t m = 0; m < MAX_MIP_COUNT; ++m)
 		{
-			memory::Free(surface.data);
+			memory::Free(_levels[m]);
+			_levels[m] = nullptr;
 		}
 	}
+	void Texture::SetFile(const char* path, FileSource* file_source)
+	{
+		_file_path = path;
+		_file_source = file_source;
+	}
+	void Texture::AddMip(uint8_t* data, RenderResourceAllocator* resource_allocator)
+	{
+		Assert(data);
+		Assert(_resident_mip > 0);
+
+		--_resident_mip;
+		_levels[_resident_mip] = data;
+
+		UpdateRenderResource(resource_allocator);
+	}
+	void Texture::DropMip(RenderResourceAllocator* resource_allocator)
+	{
+		Assert(_resident_mip < _tail_mip);
 
+		memory::Free(_levels[_resident_mip]);
+		_levels[_resident_mip] = nullptr;
+		++_resident_mip;
+
+		UpdateRenderResource(resource_allocator);
+	}
+	uint32_t Texture::GetResidentMip() const
+	{
+		return _resident_mip;
+	}
+	uint32_t Texture::GetTailMip() const
+	{
+		return _tail_mip;
+	}
+	uint32_t Texture::GetMipCount() const
+	{
+		return _full_desc.mip_count;
+	}
+	const Texture::MipInfo& Texture::GetMipInfo(uint32_t mip) const
+	{
+		Assert(mip < _full_desc.mip_count);
+		return _mips[mip];
+	}
+	uint32_t Texture::GetResidentSize() const
+	{
+		uint32_t size = 0;
+		for (uint32_t m = _resident_mip; m < _full_desc.mip_count; ++m)
+		{
+			size += _mips[m].size;
+		}
+		return size;
+	}
+	const char* Texture::GetFilePath() const
+	{
+		return _file_path.c_str();
+	}
+	FileSource* Texture::GetFileSource() const
+	{
+		return _file_source;
+	}
+	const TextureDesc& Texture::GetFullDesc() const
+	{
+		return _full_desc;
+	}
 	const RTexture& Texture::GetRenderResource() const
 	{
 		return _render_resource;
 	}
+	void Texture::UpdateRenderResource(RenderResourceAllocator* resource_allocator)
+	{
+		TextureDesc& desc = _render_resource.GetDesc();
+		desc = _full_desc;
+		desc.width = Max<uint32_t>(1, _full_desc.width >> _resident_mip);
+		desc.height = Max<uint32_t>(1, _full_desc.height >> _resident_mip);
+		desc.mip_count = _full_desc.mip_count - _resident_mip;
+
+		// The render device expects the surfaces ordered by face and then mip level
+		vector<image::Surface> surfaces;
+		surfaces.reserve(desc.array_size * desc.mip_count);
+		for (uint32_t f = 0; f < desc.array_size; ++f)
+		{
+			for (uint32_t m = _resident_mip; m < _full_desc.mip_count; ++m)
+			{
+				image::Surface surface;
+				surface.size = _mips[m].size / desc.array_size;
+				surface.data = _levels[m] + f * surface.size;
+				surfaces.push_back(surface);
+			}
+		}
+
+		if (IsValid(_render_resource.GetHandle()))
+			resource_allocator->ReallocateTexture(_render_resource, &surfaces);
+		else
+			resource_allocator->AllocateTexture(_render_resource, &surfaces);
+	}
 
 
 	//-------------------------------------------------------------------------------
 
+	void texture_resource::Compile(const TextureDesc& desc, const vector<image::Surface>& surfaces, Stream& stream)
+	{
+		Assert(desc.mip_count > 0 && desc.mip_count <= Texture::MAX_MIP_COUNT);
+		Assert(surfaces.size() == desc.array_size * desc.mip_count);
+
+		uint32_t version = TEXTURE_RESOURCE_VERSION;
+		stream.Write(&version, 4);
+		stream.Write(&desc, sizeof(TextureDesc));
+
+		Texture::MipInfo mips[Texture::MAX_MIP_COUNT];
+		uint32_t offset = 4 + sizeof(TextureDesc) + desc.mip_count * sizeof(Texture::MipInfo);
+		for (uint32_t m = desc.mip_count; m > 0; --m)
+		{
+			Texture::MipInfo& mip = mips[m - 1];
+			mip.offset = offset;
+			mip.size = 0;
+			for (uint32_t f = 0; f < desc.array_size; ++f)
+			{
+				mip.size += surfaces[f * desc.mip_count + (m - 1)].size;
+			}
+			offset += mip.size;
+		}
+		stream.Write(mips, desc.mip_count * sizeof(Texture::MipInfo));
+
+		// Smallest level first, all faces of a level together
+		for (uint32_t m = desc.mip_count; m > 0; --m)
+		{
+			for (uint32_t f = 0; f < desc.array_size; ++f)
+			{
+				const image::Surface& surface = surfaces[f * desc.mip_count + (m - 1)];
+				stream.Write(surface.data, surface.size);
+			}
+		}
+	}
 	void texture_resource::Load(ResourceLoader::LoadContext& context)
 	{
 		Texture* texture = new Texture();
 
-		RenderDevice* render_device = (RenderDevice*)context.user_data;
-		texture->Load(context.file, render_device->GetResourceAllocator());
+		TextureStreamer* texture_streamer = (TextureStreamer*)context.user_data;
+		texture->Load(context.file, texture_streamer->GetResourceAllocator());
+		texture->SetFile(context.resource_path, context.file_source);
 
 		context.result = texture;
 	}
@@ -62,18 +226,29 @@ namespace sb
 	{
 		Texture* texture = (Texture*)context.resource_data;
 
-		RenderDevice* render_device = (RenderDevice*)context.user_data;
-		texture->Unload(render_device->GetResourceAllocator());
+		TextureStreamer* texture_streamer = (TextureStreamer*)context.user_data;
+		texture->Unload(texture_streamer->GetResourceAllocator());
 
 		delete texture;
 	}
+	void texture_resource::BringIn(void* user_data, void* resource_data)
+	{
+		((TextureStreamer*)user_data)->Register((Texture*)resource_data);
+	}
+	void texture_resource::BringOut(void* user_data, void* resource_data)
+	{
+		((TextureStreamer*)user_data)->Unregister((Texture*)resource_data);
+	}
 
-	void texture_resource::RegisterResourceType(ResourceManager* resource_manager, RenderDevice* render_device)
+	void texture_resource::RegisterResourceType(ResourceManager* resource_manager, TextureStreamer* texture_streamer)
 	{
 		ResourceType resource_type;
 		resource_type.load_callback = Load;
 		resource_type.unload_callback = Unload;
-		resource_type.user_data = render_device;
+		resource_type.bring_in_callback = BringIn;
+		resource_type.bring_out_callback = BringOut;
+		resource_type.user_data = texture_streamer;
+		resource_type.read_size = INITIAL_READ_SIZE;
 
 		resource_manager->RegisterType("texture", resource_type);
 	}
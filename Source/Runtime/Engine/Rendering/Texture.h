@@ -10,36 +10,119 @@ namespace sb
 {
 
 	class RenderDevice;
-
+	class TextureStreamer;
+
+	/// @brief Streamed texture
+	///
+	///	Only the smallest mip levels (the tail) are read when the texture is loaded, finer levels are
+	///		streamed in one at a time by the TextureStreamer and may be dropped again when the texture
+	///		memory budget runs out. The render resource keeps its handle when levels are added or
+	///		dropped so any references to it stay valid.
 	class Texture
 	{
 	public:
+		enum
+		{
+			/// Levels with a size (in pixels) no larger than this are always resident
+			TAIL_SIZE = 64,
+			MAX_MIP_COUNT = 15
+		};
+
+		/// Location of a mip level in the resource file
+		struct MipInfo
+		{
+			uint32_t offset; ///< Offset from the start of the file
+			uint32_t size; ///< Size of the level in bytes, for all faces
+		};
+
 		Texture();
 		~Texture();
 
-		/// @brief Loads the texture from the specified file stream.
+		/// @brief Loads the header and the tail mips of the texture from the specified file stream.
 		void Load(FileStreamPtr file, RenderResourceAllocator* resource_allocator);
 
 		/// @brief Unloads the texture, frees any allocated memory and releases render resources.
 		void Unload(RenderResourceAllocator* resource_allocator);
 
+		/// @brief Sets the file that further mip levels are streamed from.
+		void SetFile(const char* path, FileSource* file_source);
+
+		/// @brief Makes the next finer mip level resident
+		///	@param data Data for level GetResidentMip() - 1, allocated with memory::Malloc. The texture
+		///				takes ownership of the data.
+		void AddMip(uint8_t* data, RenderResourceAllocator* resource_allocator);
+
+		/// @brief Drops the finest resident mip level, the tail is never dropped.
+		void DropMip(RenderResourceAllocator* resource_allocator);
+
+		/// @return Finest mip level currently resident, 0 if the full texture is resident
+		uint32_t GetResidentMip() const;
+
+		/// @return Coarsest mip level that can be streamed, levels from this one and down are always resident
+		uint32_t GetTailMip() const;
+
+		/// @return Number of mip levels in the full texture
+		uint32_t GetMipCount() const;
+
+		const MipInfo& GetMipInfo(uint32_t mip) const;
+
+		/// @return Number of bytes of texture data currently resident
+		uint32_t GetResidentSize() const;
+
+		const char* GetFilePath() const;
+		FileSource* GetFileSource() const;
+
+		/// @brief Returns the description of the full texture, including levels not resident.
+		const TextureDesc& GetFullDesc() const;
+
 		/// @brief Returns the textures render resource.
 		const RTexture& GetRenderResource() const;
 
 	private:
+		friend class TextureStreamer;
+
+		/// @brief Creates or recreates the render resource from the resident levels
+		void UpdateRenderResource(RenderResourceAllocator* resource_allocator);
+
 		RTexture _render_resource;
-		vector<image::Surface> _surfaces;
 
+		TextureDesc _full_desc;
+		MipInfo _mips[MAX_MIP_COUNT];
+
+		/// Resident mip levels, each holding the data for all faces
+		uint8_t* _levels[MAX_MIP_COUNT];
+
+		uint32_t _resident_mip;
+		uint32_t _tail_mip;
+
+		string _file_path;
+		FileSource* _file_source;
+
+		uint32_t _stream_index; ///< Index in the streamer, Invalid if not registered
 	};
 
 	namespace texture_resource
 	{
-		enum { TEXTURE_RESOURCE_VERSION = 2 };
+		enum { TEXTURE_RESOURCE_VERSION = 3 };
+
+		/// Number of bytes read when loading a texture, enough to hold the header and the tail of
+		///		most textures. Anything not covered is read through the file stream.
+		enum { INITIAL_READ_SIZE = 128 * 1024 };
+
+		/// @brief Compiles a texture resource
+		///
+		///	Layout: [version][TextureDesc][Texture::MipInfo * mip count][level data]
+		///	Levels are stored smallest first, each level holding the data for all faces, which lets the
+		///		runtime read the tail in one go and stream each finer level with a single read.
+		///	@param surfaces Surfaces ordered by face and then mip level, as given by dds_image::Load
+		void Compile(const TextureDesc& desc, const vector<image::Surface>& surfaces, Stream& stream);
 
 		void Load(ResourceLoader::LoadContext& context);
 		void Unload(ResourceLoader::UnloadContext& context);
+		void BringIn(void* user_data, void* resource_data);
+		void BringOut(void* user_data, void* resource_data);
 
-		void RegisterResourceType(ResourceManager* resource_manager, RenderDevice* render_device);
+		void RegisterResourceType(ResourceManager* resource_manager, TextureStreamer* texture_streamer);
 		void UnregisterResourceType(ResourceManager* resource_manager);
 
 	};
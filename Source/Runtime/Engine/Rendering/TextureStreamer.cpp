@@ -0,0 +1,332 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "TextureStreamer.h"
+#include "Texture.h"
+
+#include <Foundation/Filesystem/AsyncIO.h>
+#include <Foundation/Filesystem/File.h>
+#include <Foundation/Profiler/Profiler.h>
+
+#include <algorithm>
+
+namespace sb
+{
+
+	TextureStreamer::TextureStreamer(ResourceLoader* resource_loader, RenderResourceAllocator* resource_allocator)
+		: _resource_loader(resource_loader),
+		_resource_allocator(resource_allocator),
+		_async_io(nullptr),
+		_budget(DEFAULT_BUDGET),
+		_resident_size(0)
+	{
+		_async_io = async_io::Create();
+		Assert(_async_io);
+	}
+	TextureStreamer::~TextureStreamer()
+	{
+		for (auto& entry : _entries)
+		{
+			if (entry.read)
+				entry.read->texture = nullptr;
+		}
+		_entries.clear();
+
+		// The loader thread writes to reads still being opened, wait for it to let go of them
+		for (auto read : _opening)
+		{
+			if (read->open_request != INVALID_LOAD_REQUEST_ID)
+			{
+				ResourceLoader::Result result;
+				_resource_loader->WaitResult(read->open_request, result);
+			}
+			FinishRead(read, -1);
+		}
+		_opening.clear();
+
+		// Finish any reads still in flight
+		AsyncIO::Completion completions[AsyncIO::DEFAULT_QUEUE_DEPTH];
+		while (_async_io->Pending() != 0)
+		{
+			uint32_t count = _async_io->Wait(completions, AsyncIO::DEFAULT_QUEUE_DEPTH);
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				FinishRead((PendingRead*)completions[i].user_data, completions[i].result);
+			}
+		}
+
+		async_io::Destroy(_async_io);
+	}
+	void TextureStreamer::Register(Texture* texture)
+	{
+		Assert(texture);
+		Assert(IsInvalid(texture->_stream_index));
+
+		Entry entry;
+		entry.texture = texture;
+		entry.wanted_mip = texture->GetTailMip();
+		entry.priority = 0.0f;
+		entry.read = nullptr;
+		entry.failed = false;
+
+		texture->_stream_index = (uint32_t)_entries.size();
+		_entries.push_back(entry);
+
+		_resident_size += texture->GetResidentSize();
+	}
+	void TextureStreamer::Unregister(Texture* texture)
+	{
+		Assert(texture);
+		uint32_t index = texture->_stream_index;
+		if (IsInvalid(index))
+			return;
+
+		Entry& entry = _entries[index];
+		if (entry.read)
+		{
+			// Let the read finish on its own, the data is freed when it completes
+			entry.read->texture = nullptr;
+		}
+		_resident_size -= texture->GetResidentSize();
+
+		// Move the last entry into the free spot
+		if (index != _entries.size() - 1)
+		{
+			entry = _entries.back();
+			entry.texture->_stream_index = index;
+		}
+		_entries.pop_back();
+
+		SetInvalid(texture->_stream_index);
+	}
+	void TextureStreamer::RequestMip(Texture* texture, uint32_t mip, float priority)
+	{
+		if (IsInvalid(texture->_stream_index))
+			return; // Not brought in yet
+
+		Entry& entry = _entries[texture->_stream_index];
+		entry.wanted_mip = Min(entry.wanted_mip, mip);
+		entry.priority = Max(entry.priority, priority);
+	}
+	void TextureStreamer::Update()
+	{
+		PROFILER_SCOPE("TextureStreamer::Update");
+
+		// Complete finished reads
+		AsyncIO::Completion completions[AsyncIO::DEFAULT_QUEUE_DEPTH];
+		uint32_t count;
+		while ((count = _async_io->Poll(completions, AsyncIO::DEFAULT_QUEUE_DEPTH)) != 0)
+		{
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				FinishRead((PendingRead*)completions[i].user_data, completions[i].result);
+			}
+		}
+
+		SubmitOpenedReads();
+
+		// Collect textures wanting finer levels than they have
+		_candidates.clear();
+		for (uint32_t i = 0; i < _entries.size(); ++i)
+		{
+			const Entry& entry = _entries[i];
+			if (!entry.read && !entry.failed && entry.wanted_mip < entry.texture->GetResidentMip())
+				_candidates.push_back(i);
+		}
+
+		const vector<Entry>& entries = _entries;
+		std::sort(_candidates.begin(), _candidates.end(), [&entries](uint32_t a, uint32_t b)
+		{
+			return entries[a].priority > entries[b].priority;
+		});
+
+		for (uint32_t i = 0; i < _candidates.size(); ++i)
+		{
+			if (_async_io->Pending() + _opening.size() >= _async_io->QueueDepth())
+				break;
+
+			Entry& entry = _entries[_candidates[i]];
+			const Texture::MipInfo& mip = entry.texture->GetMipInfo(entry.texture->GetResidentMip() - 1);
+
+			// Candidates are sorted by priority so if this doesn't fit, nothing after it will
+			if (!MakeRoom(mip.size, entry.priority))
+				break;
+
+			BeginRead(entry);
+		}
+
+		// Requests only last for one frame
+		for (auto& entry : _entries)
+		{
+			entry.wanted_mip = entry.texture->GetTailMip();
+			entry.priority = 0.0f;
+		}
+	}
+	void TextureStreamer::SetBudget(uint64_t budget)
+	{
+		_budget = budget;
+	}
+	uint64_t TextureStreamer::GetBudget() const
+	{
+		return _budget;
+	}
+	uint64_t TextureStreamer::GetResidentSize() const
+	{
+		return _resident_size;
+	}
+	RenderResourceAllocator* TextureStreamer::GetResourceAllocator()
+	{
+		return _resource_allocator;
+	}
+	uint32_t TextureStreamer::CalculateMip(const Texture* texture, float screen_size)
+	{
+		const TextureDesc& desc = texture->GetFullDesc();
+
+		// Pick the smallest level that still has at least one texel per pixel
+		float size = (float)Max(desc.width, desc.height);
+		uint32_t mip = 0;
+		while (size * 0.5f >= screen_size && mip + 1 < desc.mip_count)
+		{
+			size *= 0.5f;
+			++mip;
+		}
+		return mip;
+	}
+	void TextureStreamer::BeginRead(Entry& entry)
+	{
+		Texture* texture = entry.texture;
+		const Texture::MipInfo& mip = texture->GetMipInfo(texture->GetResidentMip() - 1);
+
+		PendingRead* read = new (_read_pool.Allocate()) PendingRead;
+		read->texture = texture;
+		read->offset = mip.offset;
+		read->size = mip.size;
+		read->data = (uint8_t*)memory::Malloc(mip.size);
+
+		// Opening files can block for a long time so leave it to the loader thread
+		ResourceLoader::Request request;
+		// A path that doesn't fit fails the open, like a missing file
+		if (!request.resource_path.Set(texture->GetFilePath()))
+			request.resource_path.Clear();
+		request.file_source = texture->GetFileSource();
+		request.open_only = true;
+		request.load_callback = FileOpened;
+		request.user_data = read;
+		read->open_request = _resource_loader->AddRequest(request);
+
+		// Count the level as resident from now so that the budget includes reads in flight
+		_resident_size += mip.size;
+		entry.read = read;
+		_opening.push_back(read);
+	}
+	void TextureStreamer::SubmitOpenedReads()
+	{
+		for (uint32_t i = 0; i < _opening.size(); )
+		{
+			PendingRead* read = _opening[i];
+			if (read->open_request != INVALID_LOAD_REQUEST_ID)
+			{
+				ResourceLoader::Result result;
+				if (!_resource_loader->GetResult(read->open_request, result))
+				{
+					++i;
+					continue;
+				}
+				read->open_request = INVALID_LOAD_REQUEST_ID;
+			}
+
+			if (read->texture && read->file.Get())
+			{
+				AsyncIO::ReadRequest request;
+				request.file = &read->file->GetFile();
+				request.offset = read->offset;
+				request.dst = read->data;
+				request.size = read->size;
+				request.user_data = read;
+				if (!_async_io->Submit(request))
+					break; // Queue is full, try again next frame
+
+				_opening[i] = _opening.back();
+				_opening.pop_back();
+			}
+			else
+			{
+				// File couldn't be opened or the texture was unregistered while opening
+				_opening[i] = _opening.back();
+				_opening.pop_back();
+				FinishRead(read, -1);
+			}
+		}
+	}
+	void TextureStreamer::FinishRead(PendingRead* read, int64_t result)
+	{
+		Texture* texture = read->texture;
+		if (texture)
+		{
+			_entries[texture->_stream_index].read = nullptr;
+		}
+
+		if (texture && result == (int64_t)read->size)
+		{
+			// Texture takes ownership of the data
+			texture->AddMip(read->data, _resource_allocator);
+		}
+		else
+		{
+			if (texture)
+			{
+				logging::Warning("TextureStreamer: Failed to read mip %d of '%s'",
+					texture->GetResidentMip() - 1, texture->GetFilePath());
+				_entries[texture->_stream_index].failed = true;
+			}
+
+			memory::Free(read->data);
+			_resident_size -= read->size;
+		}
+
+		read->~PendingRead();
+		_read_pool.Release(read);
+	}
+	void TextureStreamer::FileOpened(ResourceLoader::LoadContext& context)
+	{
+		PendingRead* read = (PendingRead*)context.user_data;
+		read->file = context.file;
+		context.result = read;
+	}
+	bool TextureStreamer::MakeRoom(uint32_t size, float priority)
+	{
+		while (_resident_size + size > _budget)
+		{
+			// Drop the finest level of the least important texture that has anything to drop,
+			//	textures holding finer levels than they currently need go first.
+			Entry* victim = nullptr;
+			for (auto& entry : _entries)
+			{
+				Texture* texture = entry.texture;
+				if (entry.read || texture->GetResidentMip() >= texture->GetTailMip())
+					continue;
+
+				bool unneeded = texture->GetResidentMip() < entry.wanted_mip;
+				if (!unneeded && entry.priority >= priority)
+					continue;
+
+				bool victim_unneeded = victim && victim->texture->GetResidentMip() < victim->wanted_mip;
+				if (!victim || (unneeded && !victim_unneeded)
+					|| (unneeded == victim_unneeded && entry.priority < victim->priority))
+				{
+					victim = &entry;
+				}
+			}
+
+			if (!victim)
+				return false;
+
+			Texture* texture = victim->texture;
+			_resident_size -= texture->GetMipInfo(texture->GetResidentMip()).size;
+			texture->DropMip(_resource_allocator);
+		}
+		return true;
+	}
+
+} // namespace sb
@@ -0,0 +1,108 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __RENDERING_TEXTURESTREAMER_H__
+#define __RENDERING_TEXTURESTREAMER_H__
+
+#include <Foundation/Filesystem/FileStream.h>
+#include <Foundation/Memory/MemoryPool.h>
+#include <Foundation/Resource/ResourceLoader.h>
+
+namespace sb
+{
+
+	class Texture;
+	class AsyncIO;
+	class RenderResourceAllocator;
+
+	/// @brief Streams texture mip levels in and out under a memory budget
+	///
+	///	Each frame the renderer requests the mip level it wants for every visible texture, together
+	///		with a priority (typically the size on screen of the object using it). Update() then reads
+	///		the next finer level for the most important textures, one level per texture at a time,
+	///		and drops levels from less important textures when the budget runs out.
+	///	Texture files are opened on the resource loader thread, the mip data itself is read
+	///		asynchronously once the file is open.
+	class TextureStreamer : NonCopyable
+	{
+	public:
+		enum { DEFAULT_BUDGET = 256 * 1024 * 1024 };
+
+		TextureStreamer(ResourceLoader* resource_loader, RenderResourceAllocator* resource_allocator);
+		~TextureStreamer();
+
+		/// @brief Registers a loaded texture for streaming
+		void Register(Texture* texture);
+
+		/// @brief Unregisters a texture, any read in flight for it is discarded
+		void Unregister(Texture* texture);
+
+		/// @brief Requests a mip level of a texture for the current frame
+		///	@param mip Finest mip level wanted
+		///	@param priority Textures with higher priority are streamed in first and dropped last
+		void RequestMip(Texture* texture, uint32_t mip, float priority);
+
+		/// @brief Completes finished reads, issues new ones and enforces the budget.
+		///	Should be called once per frame, after all requests for the frame are made.
+		void Update();
+
+		/// @brief Sets the texture memory budget in bytes
+		void SetBudget(uint64_t budget);
+		uint64_t GetBudget() const;
+
+		/// @return Number of bytes of texture data resident, including reads in flight
+		uint64_t GetResidentSize() const;
+
+		RenderResourceAllocator* GetResourceAllocator();
+
+		/// @brief Calculates the mip level needed for a texture covering the specified number of pixels on screen
+		static uint32_t CalculateMip(const Texture* texture, float screen_size);
+
+	private:
+		struct PendingRead
+		{
+			Texture* texture; ///< NULL if the texture was unregistered while reading
+			FileStreamPtr file; ///< Set by the loader thread once the file is open
+			LoadRequestId open_request; ///< Loader request opening the file, invalid once opened
+			uint8_t* data;
+			uint32_t offset;
+			uint32_t size;
+		};
+
+		struct Entry
+		{
+			Texture* texture;
+			uint32_t wanted_mip; ///< Finest mip requested this frame
+			float priority; ///< Highest priority requested this frame
+			PendingRead* read; ///< Read in flight, NULL if none
+			bool failed; ///< Set if the texture file couldn't be read, no further levels are streamed
+		};
+
+		/// @brief Starts opening the texture file for reading the next finer level of the specified entry
+		void BeginRead(Entry& entry);
+		/// @brief Submits reads for files opened by the loader
+		void SubmitOpenedReads();
+		void FinishRead(PendingRead* read, int64_t result);
+
+		/// @brief Called on the loader thread once a texture file is open
+		static void FileOpened(ResourceLoader::LoadContext& context);
+
+		/// @brief Drops levels from textures with lower priority until size bytes fits in the budget
+		///	@return True if there's room
+		bool MakeRoom(uint32_t size, float priority);
+
+		ResourceLoader* _resource_loader;
+		RenderResourceAllocator* _resource_allocator;
+		AsyncIO* _async_io;
+
+		vector<Entry> _entries;
+		vector<uint32_t> _candidates;
+		MemoryPool<PendingRead, 32> _read_pool;
+		vector<PendingRead*> _opening; ///< Reads waiting for their file to be opened or to be submitted
+
+		uint64_t _budget;
+		uint64_t _resident_size;
+	};
+
+} // namespace sb
+
+#endif // __RENDERING_TEXTURESTREAMER_H__
@@ -0,0 +1,108 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Benchmark/Framework.h"
+
+#include <Foundation/Memory/HeapAllocator.h>
+#include <Foundation/Memory/ThreadCacheAllocator.h>
+#include <Foundation/Platform/System.h>
+#include <Foundation/Thread/Thread.h>
+
+using namespace sb;
+
+namespace
+{
+	const uint32_t OPERATIONS_PER_THREAD = 2000000;
+
+	/// Number of live blocks per thread, randomly replaced to get a realistic mix of sizes and lifetimes
+	const uint32_t SLOT_COUNT = 1024;
+
+	struct WorkerParams
+	{
+		Allocator* allocator;
+		uint32_t seed;
+	};
+
+	void AllocateAndFree(void* data)
+	{
+		WorkerParams* params = (WorkerParams*)data;
+		Allocator* allocator = params->allocator;
+
+		void* slots[SLOT_COUNT];
+		memset(slots, 0, sizeof(slots));
+
+		uint32_t random = params->seed;
+		for (uint32_t i = 0; i < OPERATIONS_PER_THREAD; ++i)
+		{
+			random = random * 1664525 + 1013904223;
+			uint32_t slot = (random >> 8) % SLOT_COUNT;
+			if (slots[slot])
+			{
+				allocator->Free(slots[slot]);
+				slots[slot] = nullptr;
+			}
+			else
+			{
+				// Mostly small objects with the occasional larger buffer
+				size_t size = ((random >> 20) % 16) ? 8 + (random >> 20) % 256 : 1024 + (random >> 20) % 4096;
+				slots[slot] = allocator->Allocate(size);
+				*(uint8_t*)slots[slot] = 0;
+			}
+		}
+
+		for (uint32_t i = 0; i < SLOT_COUNT; ++i)
+			allocator->Free(slots[i]);
+	}
+
+	/// @return Time in seconds
+	double RunWorkers(Allocator& allocator, uint32_t thread_count)
+	{
+		vector<WorkerParams> params(thread_count);
+		vector<SimpleThread*> threads;
+
+		double start = benchmark::Seconds();
+
+		// The calling thread runs the first worker itself
+		for (uint32_t i = 0; i < thread_count; ++i)
+		{
+			params[i].allocator = &allocator;
+			params[i].seed = i + 1;
+			if (i != 0)
+			{
+				threads.push_back(new SimpleThread());
+				threads.back()->Start(AllocateAndFree, &params[i]);
+			}
+		}
+		AllocateAndFree(&params[0]);
+
+		// Join waits for the threads to exit, and with that for their caches to be returned to the
+		//	allocator, which is destroyed once we return
+		for (auto thread : threads)
+		{
+			Verify(thread->Join());
+			delete thread;
+		}
+
+		return benchmark::Seconds() - start;
+	}
+}
+
+BENCHMARK(Allocator_Threads)
+{
+	system::SystemInfo info;
+	system::GetSystemInfo(info);
+
+	uint32_t thread_counts[] = { 1, 2, Max(info.num_processors, 4u) };
+	for (auto thread_count : thread_counts)
+	{
+		HeapAllocator heap;
+		double heap_time = RunWorkers(heap, thread_count);
+
+		ThreadCacheAllocator thread_cache(heap);
+		double thread_cache_time = RunWorkers(thread_cache, thread_count);
+
+		double operations = double(OPERATIONS_PER_THREAD) * thread_count;
+		benchmark::Report("%2u threads: HeapAllocator %7.1f Mops/s, ThreadCacheAllocator %7.1f Mops/s (%.2fx)",
+			thread_count, operations / heap_time * 1e-6, operations / thread_cache_time * 1e-6, heap_time / thread_cache_time);
+	}
+}
+
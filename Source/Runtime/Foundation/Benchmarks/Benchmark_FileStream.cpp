@@ -0,0 +1,118 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Benchmark/Framework.h"
+
+#include <Foundation/Filesystem/FileSystem.h>
+#include <Foundation/Filesystem/FileSource.h>
+#include <Foundation/Filesystem/FileUtil.h>
+#include <Foundation/Filesystem/File.h>
+
+using namespace sb;
+
+namespace
+{
+	/// Read sizes mimicking a typical resource loader: version numbers, counts, small structs and the odd blob
+	const uint32_t g_read_pattern[] = { 4, 4, 16, 48, 4, 64, 4, 256, 12, 4096 };
+	const uint32_t g_read_pattern_length = sizeof(g_read_pattern) / sizeof(g_read_pattern[0]);
+
+	struct ReadStats
+	{
+		uint32_t files;
+		int64_t bytes;
+		long syscalls;
+		double seconds;
+	};
+
+	void ReadAll(FileSource* source, const vector<string>& files, uint32_t buffer_size, bool vectored, ReadStats& stats)
+	{
+		uint8_t dst[8192];
+
+		file_stats::Reset();
+		double start = benchmark::Seconds();
+
+		stats.files = 0;
+		stats.bytes = 0;
+		for (auto& f : files)
+		{
+			FileStreamPtr file = source->OpenFile(f.c_str(), File::READ, buffer_size);
+			if (!file.Get())
+				continue;
+
+			++stats.files;
+
+			size_t read = 0;
+			if (vectored)
+			{
+				// Read the whole pattern as a single request
+				File::ReadBuffer buffers[g_read_pattern_length];
+				uint32_t offset = 0;
+				for (uint32_t i = 0; i < g_read_pattern_length; ++i)
+				{
+					buffers[i].dst = dst + offset;
+					buffers[i].size = g_read_pattern[i];
+					offset += g_read_pattern[i];
+				}
+				do
+				{
+					read = file->ReadMany(buffers, g_read_pattern_length);
+					stats.bytes += read;
+				} while (read != 0);
+			}
+			else
+			{
+				uint32_t i = 0;
+				do
+				{
+					read = file->Read(dst, g_read_pattern[i]);
+					stats.bytes += read;
+					i = (i + 1) % g_read_pattern_length;
+				} while (read != 0);
+			}
+		}
+
+		stats.seconds = benchmark::Seconds() - start;
+		stats.syscalls = file_stats::Get().read_calls + file_stats::Get().seek_calls;
+	}
+
+	void ReportStats(const char* name, const ReadStats& stats, const ReadStats& baseline)
+	{
+		benchmark::Report("%-24s %6u files %10lld bytes %9ld syscalls (%6.1f/file, %5.1fx fewer) %8.3f s",
+			name, stats.files, (long long)stats.bytes, stats.syscalls,
+			stats.files ? (double)stats.syscalls / stats.files : 0.0,
+			stats.syscalls ? (double)baseline.syscalls / stats.syscalls : 0.0,
+			stats.seconds);
+	}
+}
+
+BENCHMARK(FileStream_ContentReads)
+{
+	FileSystem file_system("./");
+	FileSource* source = file_system.OpenFileSource(_context.content_dir);
+
+	vector<string> files;
+	file_util::FindFilesRecursive(source, "*", files);
+	if (files.empty())
+	{
+		benchmark::Report("No files found in '%s'", _context.content_dir);
+		return;
+	}
+
+	// Warm the OS file cache so that all runs measure the same thing
+	ReadStats warmup;
+	ReadAll(source, files, FileStream::DEFAULT_BUFFER_SIZE, false, warmup);
+
+	ReadStats unbuffered, buffered_small, buffered, vectored;
+	ReadAll(source, files, 0, false, unbuffered);
+	ReadAll(source, files, 4 * 1024, false, buffered_small);
+	ReadAll(source, files, FileStream::DEFAULT_BUFFER_SIZE, false, buffered);
+	ReadAll(source, files, FileStream::DEFAULT_BUFFER_SIZE, true, vectored);
+
+	ReportStats("unbuffered", unbuffered, unbuffered);
+	ReportStats("buffered (4 KB)", buffered_small, unbuffered);
+	ReportStats("buffered (64 KB)", buffered, unbuffered);
+	ReportStats("buffered + ReadMany", vectored, unbuffered);
+
+#ifndef SANDBOX_FILE_TRACKING
+	benchmark::Report("Syscall counts require a build with SANDBOX_FILE_TRACKING");
+#endif
+}
@@ -0,0 +1,171 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Benchmark/Framework.h"
+
+#include <Foundation/Filesystem/FileSystem.h>
+#include <Foundation/Filesystem/FileSource.h>
+#include <Foundation/Filesystem/FileUtil.h>
+#include <Foundation/Filesystem/FilePath.h>
+#include <Foundation/Filesystem/File.h>
+#include <Foundation/Json/JsonDocument.h>
+#include <Foundation/Json/SimplifiedJson.h>
+#include <Foundation/Json/Json.h>
+#include <Foundation/IO/MemoryStream.h>
+
+using namespace sb;
+
+namespace
+{
+	/// Extensions of all JSON and simplified-JSON files in the content
+	const char* g_extensions[] = { "json", "settings", "package", "render_setup", "material", "shader_src", "texture_src" };
+
+	/// Every run parses the documents until at least this many bytes are parsed
+	const int64_t MIN_BYTES_PER_RUN = 64 * 1024 * 1024;
+
+	/// Every run writes the documents until at least this many bytes are written
+	const int64_t MIN_BYTES_PER_WRITE_RUN = 32 * 1024 * 1024;
+
+	bool IsJsonFile(const string& file)
+	{
+		string extension = FilePath(file.c_str()).Extension();
+		for (uint32_t i = 0; i < sizeof(g_extensions) / sizeof(g_extensions[0]); ++i)
+		{
+			if (extension == g_extensions[i])
+				return true;
+		}
+		return false;
+	}
+
+	void ReportThroughput(const char* name, int64_t bytes, double seconds)
+	{
+		benchmark::Report("%-28s %10lld bytes %8.3f s %8.1f MB/s", name, (long long)bytes, seconds,
+			seconds > 0.0 ? (bytes / (1024.0 * 1024.0)) / seconds : 0.0);
+	}
+}
+
+BENCHMARK(Json_ContentParse)
+{
+	FileSystem file_system("./");
+	FileSource* source = file_system.OpenFileSource(_context.content_dir);
+
+	vector<string> files;
+	file_util::FindFilesRecursive(source, "*", files);
+
+	// Load all documents up front so that only parsing is measured
+	vector<string> documents;
+	int64_t total_size = 0;
+	for (auto& f : files)
+	{
+		if (!IsJsonFile(f))
+			continue;
+
+		FileStreamPtr file = source->OpenFile(f.c_str(), File::READ);
+		if (!file.Get() || file->Length() <= 0)
+			continue;
+
+		string doc((size_t)file->Length(), '\0');
+		file->Read(&doc[0], (uint32_t)doc.size());
+		total_size += doc.size();
+		documents.push_back(doc);
+	}
+	if (documents.empty())
+	{
+		benchmark::Report("No JSON files found in '%s'", _context.content_dir);
+		return;
+	}
+
+	int64_t passes = MIN_BYTES_PER_RUN / total_size + 1;
+	benchmark::Report("%u documents, %lld bytes, %lld passes", (uint32_t)documents.size(), (long long)total_size, (long long)passes);
+
+	uint32_t failed = 0;
+
+	// The same document object is reused, as a loader parsing many files would do
+	JsonDocument document;
+	double start = benchmark::Seconds();
+	for (int64_t p = 0; p < passes; ++p)
+	{
+		for (auto& doc : documents)
+		{
+			if (!document.Read(doc.data(), doc.size()))
+				++failed;
+		}
+	}
+	ReportThroughput("JsonDocument", total_size * passes, benchmark::Seconds() - start);
+
+	// Compatibility path, parses into a JsonDocument and copies the result into ConfigValues
+	start = benchmark::Seconds();
+	for (int64_t p = 0; p < passes; ++p)
+	{
+		for (auto& doc : documents)
+		{
+			ConfigValue root;
+			simplified_json::Reader reader;
+			if (!reader.Read(doc.data(), doc.size(), root))
+				++failed;
+		}
+	}
+	ReportThroughput("simplified_json::Reader", total_size * passes, benchmark::Seconds() - start);
+
+	if (failed)
+		benchmark::Report("%u documents failed to parse", failed);
+}
+
+BENCHMARK(Json_ContentWrite)
+{
+	FileSystem file_system("./");
+	FileSource* source = file_system.OpenFileSource(_context.content_dir);
+
+	vector<string> files;
+	file_util::FindFilesRecursive(source, "*", files);
+
+	vector<ConfigValue> documents;
+	for (auto& f : files)
+	{
+		if (!IsJsonFile(f))
+			continue;
+
+		ConfigValue root;
+		simplified_json::Reader reader;
+		if (reader.ReadFile(source, f.c_str(), root))
+			documents.push_back(root);
+	}
+	if (documents.empty())
+	{
+		benchmark::Report("No JSON files found in '%s'", _context.content_dir);
+		return;
+	}
+
+	// Size of the output from a single pass
+	vector<uint8_t> output;
+	{
+		DynamicMemoryStream stream(&output);
+		json::Writer writer(stream, true);
+		for (auto& doc : documents)
+			writer.Write(doc);
+	}
+	int64_t total_size = (int64_t)output.size();
+	int64_t passes = MIN_BYTES_PER_WRITE_RUN / total_size + 1;
+	benchmark::Report("%u documents, %lld bytes, %lld passes", (uint32_t)documents.size(), (long long)total_size, (long long)passes);
+
+	double start = benchmark::Seconds();
+	for (int64_t p = 0; p < passes; ++p)
+	{
+		output.clear();
+		DynamicMemoryStream stream(&output);
+		json::Writer writer(stream, true);
+		for (auto& doc : documents)
+			writer.Write(doc);
+	}
+	ReportThroughput("json::Writer", total_size * passes, benchmark::Seconds() - start);
+
+	start = benchmark::Seconds();
+	for (int64_t p = 0; p < passes; ++p)
+	{
+		output.clear();
+		DynamicMemoryStream stream(&output);
+		simplified_json::Writer writer(stream, true);
+		for (auto& doc : documents)
+			writer.Write(doc);
+	}
+	ReportThroughput("simplified_json::Writer", total_size * passes, benchmark::Seconds() - start);
+}
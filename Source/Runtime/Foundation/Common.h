@@ -4,10 +4,13 @@
 #define __FOUNDATION_COMMON_H__
 
 #include <math.h>
+#include <float.h>
+#include <stdarg.h>
 #include <limits>
 #include <iostream>
 #include <algorithm>
 #include <stdint.h>
+#include <inttypes.h>
 #include <errno.h>
 
 #include <vector>
@@ -0,0 +1,599 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "CompiledConfig.h"
+#include "Filesystem/FileSource.h"
+#include "IO/MemoryStream.h"
+#include "Json/Json.h"
+
+namespace sb
+{
+
+	namespace compiled_config
+	{
+		static_assert(sizeof(Header) == 24, "Nodes need to be 8 byte aligned");
+		static_assert(sizeof(Node) == 16, "Unexpected node size");
+
+		/// Flattens a ConfigValue tree into node, key and string arrays
+		class Compiler
+		{
+		public:
+			vector<Node> nodes;
+			vector<uint32_t> keys;
+			vector<char> strings;
+
+			Compiler()
+			{
+				nodes.resize(1);
+			}
+
+			void Write(const ConfigValue& value, uint32_t index)
+			{
+				Node node;
+				memset(&node, 0, sizeof(Node));
+				node.type = value.Type();
+				node.size = value.Size();
+
+				switch (value.Type())
+				{
+				case ConfigValue::NULL_VALUE:
+					break;
+				case ConfigValue::INTEGER:
+					node.i = value.AsInt64();
+					break;
+				case ConfigValue::UINTEGER:
+					node.u = value.AsUInt64();
+					break;
+				case ConfigValue::FLOAT:
+					node.d = value.AsDouble();
+					break;
+				case ConfigValue::BOOL:
+					node.b = value.AsBool() ? 1 : 0;
+					break;
+				case ConfigValue::STRING:
+					node.string = AddString(value.AsString(), node.size);
+					break;
+				case ConfigValue::ARRAY:
+				case ConfigValue::OBJECT:
+					// Reserve a contiguous block for all children before writing them
+					node.children.first_child = (uint32_t)nodes.size();
+					nodes.resize(nodes.size() + node.size);
+					if (value.IsObject())
+					{
+						node.children.first_key = (uint32_t)keys.size();
+						keys.resize(keys.size() + node.size);
+					}
+					break;
+				};
+				nodes[index] = node;
+
+				if (value.IsArray())
+				{
+					for (uint32_t i = 0; i < node.size; ++i)
+						Write(value[i], node.children.first_child + i);
+				}
+				else if (value.IsObject())
+				{
+					// Members are already sorted by key
+					uint32_t i = 0;
+					for (ConfigValue::ConstIterator it = value.Begin(); it != value.End(); ++it, ++i)
+					{
+						keys[node.children.first_key + i] = AddString(it->first.c_str(), (uint32_t)it->first.size());
+						Write(it->second, node.children.first_child + i);
+					}
+				}
+			}
+
+		private:
+			map<string, uint32_t> _string_offsets;
+
+			uint32_t AddString(const char* str, uint32_t length)
+			{
+				string s(str, length);
+				map<string, uint32_t>::iterator it = _string_offsets.find(s);
+				if (it != _string_offsets.end())
+					return it->second;
+
+				uint32_t offset = (uint32_t)strings.size();
+				strings.insert(strings.end(), str, str + length);
+				strings.push_back('\0');
+
+				_string_offsets[s] = offset;
+				return offset;
+			}
+		};
+	}
+
+	//-------------------------------------------------------------------------------
+	void compiled_config::Compile(const ConfigValue& root, Stream& stream)
+	{
+		Compiler compiler;
+		compiler.Write(root, 0);
+
+		// Pad so that the total size keeps the next blob in a stream aligned
+		while (compiler.strings.size() % 8 != (compiler.keys.size() % 2) * 4)
+			compiler.strings.push_back('\0');
+
+		Header header;
+		header.magic = MAGIC;
+		header.version = VERSION;
+		header.node_count = (uint32_t)compiler.nodes.size();
+		header.key_count = (uint32_t)compiler.keys.size();
+		header.string_pool_size = (uint32_t)compiler.strings.size();
+		header.total_size = (uint32_t)(sizeof(Header) + compiler.nodes.size() * sizeof(Node) +
+			compiler.keys.size() * sizeof(uint32_t) + compiler.strings.size());
+
+		stream.Write(&header, sizeof(Header));
+		stream.Write(compiler.nodes.data(), compiler.nodes.size() * sizeof(Node));
+		if (!compiler.keys.empty())
+			stream.Write(compiler.keys.data(), compiler.keys.size() * sizeof(uint32_t));
+		if (!compiler.strings.empty())
+			stream.Write(compiler.strings.data(), compiler.strings.size());
+	}
+	bool compiled_config::IsCompiled(const void* data, size_t size)
+	{
+		if (size < sizeof(Header))
+			return false;
+
+		const Header* header = (const Header*)data;
+		if (header->magic != MAGIC || header->version != VERSION)
+			return false;
+
+		uint64_t expected_size = sizeof(Header) + (uint64_t)header->node_count * sizeof(Node) +
+			(uint64_t)header->key_count * sizeof(uint32_t) + header->string_pool_size;
+		if (header->node_count == 0 || header->total_size != expected_size || expected_size > size)
+			return false;
+
+		const Node* nodes = (const Node*)(header + 1);
+		const uint32_t* keys = (const uint32_t*)(nodes + header->node_count);
+		const char* strings = (const char*)(keys + header->key_count);
+
+		// Every string in the pool is null-terminated, so any offset inside the pool gives a terminated string
+		if (header->string_pool_size > 0 && strings[header->string_pool_size - 1] != '\0')
+			return false;
+
+		for (uint32_t i = 0; i < header->key_count; ++i)
+		{
+			if (keys[i] >= header->string_pool_size)
+				return false;
+		}
+
+		for (uint32_t i = 0; i < header->node_count; ++i)
+		{
+			const Node& node = nodes[i];
+			switch (node.type)
+			{
+			case ConfigValue::NULL_VALUE:
+			case ConfigValue::INTEGER:
+			case ConfigValue::UINTEGER:
+			case ConfigValue::FLOAT:
+			case ConfigValue::BOOL:
+				break;
+			case ConfigValue::STRING:
+				if ((uint64_t)node.string + node.size >= header->string_pool_size ||
+					strings[node.string + node.size] != '\0')
+					return false;
+				break;
+			case ConfigValue::ARRAY:
+			case ConfigValue::OBJECT:
+				// Children always follow their parent, which also rules out cycles
+				if (node.size > 0 && node.children.first_child <= i)
+					return false;
+				if ((uint64_t)node.children.first_child + node.size > header->node_count)
+					return false;
+				if (node.type == ConfigValue::OBJECT &&
+					(uint64_t)node.children.first_key + node.size > header->key_count)
+					return false;
+				break;
+			default:
+				return false;
+			};
+		}
+		return true;
+	}
+
+	//-------------------------------------------------------------------------------
+	CompiledConfigValue::CompiledConfigValue()
+		: _header(nullptr),
+		_node(nullptr)
+	{
+	}
+	CompiledConfigValue::CompiledConfigValue(const compiled_config::Header* header, const compiled_config::Node* node)
+		: _header(header),
+		_node(node)
+	{
+	}
+	//-------------------------------------------------------------------------------
+	CompiledConfigValue::ValueType CompiledConfigValue::Type() const
+	{
+		if (!_node)
+			return ConfigValue::NULL_VALUE;
+		return (ValueType)_node->type;
+	}
+	bool CompiledConfigValue::IsNull() const
+	{
+		return (Type() == ConfigValue::NULL_VALUE);
+	}
+	bool CompiledConfigValue::IsInt() const
+	{
+		return (Type() == ConfigValue::INTEGER);
+	}
+	bool CompiledConfigValue::IsUInt() const
+	{
+		return (Type() == ConfigValue::UINTEGER);
+	}
+	bool CompiledConfigValue::IsFloat() const
+	{
+		return (Type() == ConfigValue::FLOAT);
+	}
+	bool CompiledConfigValue::IsBool() const
+	{
+		return (Type() == ConfigValue::BOOL);
+	}
+	bool CompiledConfigValue::IsString() const
+	{
+		return (Type() == ConfigValue::STRING);
+	}
+	bool CompiledConfigValue::IsArray() const
+	{
+		return (Type() == ConfigValue::ARRAY);
+	}
+	bool CompiledConfigValue::IsObject() const
+	{
+		return (Type() == ConfigValue::OBJECT);
+	}
+	bool CompiledConfigValue::IsNumber() const
+	{
+		ValueType type = Type();
+		return (type == ConfigValue::INTEGER || type == ConfigValue::UINTEGER || type == ConfigValue::FLOAT);
+	}
+	//-------------------------------------------------------------------------------
+	int CompiledConfigValue::AsInt() const
+	{
+		return int(AsInt64());
+	}
+	int64_t CompiledConfigValue::AsInt64() const
+	{
+		switch (Type())
+		{
+		case ConfigValue::NULL_VALUE:
+			return 0;
+		case ConfigValue::INTEGER:
+			return _node->i;
+		case ConfigValue::UINTEGER:
+			return int64_t(_node->u);
+		case ConfigValue::FLOAT:
+			return int64_t(_node->d);
+		case ConfigValue::BOOL:
+			return (_node->b ? 1 : 0);
+		case ConfigValue::STRING:
+		case ConfigValue::ARRAY:
+		case ConfigValue::OBJECT:
+			Assert(false);
+		};
+		return 0;
+	}
+	uint32_t CompiledConfigValue::AsUInt() const
+	{
+		return uint32_t(AsUInt64());
+	}
+	uint64_t CompiledConfigValue::AsUInt64() const
+	{
+		switch (Type())
+		{
+		case ConfigValue::NULL_VALUE:
+			return 0;
+		case ConfigValue::INTEGER:
+			return uint64_t(_node->i);
+		case ConfigValue::UINTEGER:
+			return _node->u;
+		case ConfigValue::FLOAT:
+			return uint64_t(_node->d);
+		case ConfigValue::BOOL:
+			return (_node->b ? 1 : 0);
+		case ConfigValue::STRING:
+		case ConfigValue::ARRAY:
+		case ConfigValue::OBJECT:
+			Assert(false);
+		};
+		return 0;
+	}
+	float CompiledConfigValue::AsFloat() const
+	{
+		return float(AsDouble());
+	}
+	double CompiledConfigValue::AsDouble() const
+	{
+		switch (Type())
+		{
+		case ConfigValue::NULL_VALUE:
+			return 0.0;
+		case ConfigValue::INTEGER:
+			return double(_node->i);
+		case ConfigValue::UINTEGER:
+			return double(_node->u);
+		case ConfigValue::FLOAT:
+			return _node->d;
+		case ConfigValue::BOOL:
+			return (_node->b ? 1.0 : 0.0);
+		case ConfigValue::STRING:
+		case ConfigValue::ARRAY:
+		case ConfigValue::OBJECT:
+			Assert(false);
+		};
+		return 0.0;
+	}
+	bool CompiledConfigValue::AsBool() const
+	{
+		switch (Type())
+		{
+		case ConfigValue::NULL_VALUE:
+			return false;
+		case ConfigValue::INTEGER:
+			return _node->i != 0;
+		case ConfigValue::UINTEGER:
+			return _node->u != 0;
+		case ConfigValue::FLOAT:
+			return _node->d != 0.0;
+		case ConfigValue::BOOL:
+			return _node->b != 0;
+		case ConfigValue::STRING:
+		case ConfigValue::ARRAY:
+		case ConfigValue::OBJECT:
+			Assert(false);
+		};
+		return false;
+	}
+	const char* CompiledConfigValue::AsString() const
+	{
+		Assert(IsString());
+		Assert(_node->string < _header->string_pool_size);
+		return Strings() + _node->string;
+	}
+	uint32_t CompiledConfigValue::Size() const
+	{
+		if (!_node)
+			return 0;
+		return _node->size;
+	}
+	//-------------------------------------------------------------------------------
+	CompiledConfigValue::ConstIterator CompiledConfigValue::Begin() const
+	{
+		Assert(IsObject());
+		return ConstIterator(*this, 0);
+	}
+	CompiledConfigValue::ConstIterator CompiledConfigValue::End() const
+	{
+		Assert(IsObject());
+		return ConstIterator(*this, _node->size);
+	}
+	//-------------------------------------------------------------------------------
+	CompiledConfigValue CompiledConfigValue::operator[](const char* key) const
+	{
+		Assert(IsObject());
+
+		// Binary search the sorted keys
+		const uint32_t* keys = Keys() + _node->children.first_key;
+		const char* strings = Strings();
+
+		uint32_t low = 0, high = _node->size;
+		while (low < high)
+		{
+			uint32_t mid = low + (high - low) / 2;
+			int cmp = strcmp(strings + keys[mid], key);
+			if (cmp == 0)
+				return CompiledConfigValue(_header, Nodes() + _node->children.first_child + mid);
+			if (cmp < 0)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+		return CompiledConfigValue();
+	}
+	CompiledConfigValue CompiledConfigValue::operator[](int index) const
+	{
+		Assert(IsArray());
+		Assert(index >= 0 && (uint32_t)index < _node->size);
+		return CompiledConfigValue(_header, Nodes() + _node->children.first_child + index);
+	}
+	//-------------------------------------------------------------------------------
+	const compiled_config::Node* CompiledConfigValue::Nodes() const
+	{
+		return (const compiled_config::Node*)(_header + 1);
+	}
+	const uint32_t* CompiledConfigValue::Keys() const
+	{
+		return (const uint32_t*)(Nodes() + _header->node_count);
+	}
+	const char* CompiledConfigValue::Strings() const
+	{
+		return (const char*)(Keys() + _header->key_count);
+	}
+
+	//-------------------------------------------------------------------------------
+	CompiledConfigConstIterator::CompiledConfigConstIterator()
+		: _index(0)
+	{
+		_entry.first = nullptr;
+	}
+	CompiledConfigConstIterator::CompiledConfigConstIterator(const CompiledConfigValue& object, uint32_t index)
+		: _object(object),
+		_index(index)
+	{
+		SetEntry();
+	}
+	const CompiledConfigConstIterator::Entry& CompiledConfigConstIterator::operator*() const
+	{
+		Assert(_index < _object.Size());
+		return _entry;
+	}
+	const CompiledConfigConstIterator::Entry* CompiledConfigConstIterator::operator->() const
+	{
+		Assert(_index < _object.Size());
+		return &_entry;
+	}
+	CompiledConfigConstIterator& CompiledConfigConstIterator::operator++()
+	{
+		Assert(_index < _object.Size());
+		++_index;
+		SetEntry();
+		return *this;
+	}
+	CompiledConfigConstIterator CompiledConfigConstIterator::operator++(int)
+	{
+		CompiledConfigConstIterator iterator = *this;
+		++(*this);
+		return iterator;
+	}
+	bool CompiledConfigConstIterator::operator==(const CompiledConfigConstIterator& other) const
+	{
+		return (_object._node == other._object._node && _index == other._index);
+	}
+	bool CompiledConfigConstIterator::operator!=(const CompiledConfigConstIterator& other) const
+	{
+		return (_object._node != other._object._node || _index != other._index);
+	}
+	void CompiledConfigConstIterator::SetEntry()
+	{
+		if (_index < _object.Size())
+		{
+			const compiled_config::Node* node = _object._node;
+			_entry.first = _object.Strings() + _object.Keys()[node->children.first_key + _index];
+			_entry.second = CompiledConfigValue(_object._header, _object.Nodes() + node->children.first_child + _index);
+		}
+		else
+		{
+			_entry.first = nullptr;
+			_entry.second = CompiledConfigValue();
+		}
+	}
+
+	//-------------------------------------------------------------------------------
+	CompiledConfig::CompiledConfig()
+		: _data(nullptr),
+		_size(0),
+		_buffer(nullptr)
+	{
+	}
+	CompiledConfig::~CompiledConfig()
+	{
+		Close();
+	}
+	bool CompiledConfig::Open(const void* data, size_t size)
+	{
+		Close();
+
+		Assert(((uintptr_t)data & 7) == 0);
+		if (!compiled_config::IsCompiled(data, size))
+			return false;
+
+		_data = (const uint8_t*)data;
+		_size = size;
+		return true;
+	}
+	bool CompiledConfig::OpenFile(const char* file)
+	{
+		Close();
+
+		if (!_file.Open(file))
+			return false;
+
+		if (!compiled_config::IsCompiled(_file.Data(), (size_t)_file.Size()))
+		{
+			_file.Close();
+			return false;
+		}
+
+		_data = _file.Data();
+		_size = (size_t)_file.Size();
+		return true;
+	}
+	bool CompiledConfig::ReadFile(FileSource* source, const char* file_name)
+	{
+		Close();
+		_error.clear();
+
+		FileStreamPtr file = source->OpenFile(file_name, File::READ);
+		if (!file.Get() || file->Length() < 0)
+		{
+			stringstream ss; ss << "Failed to open file '" << file_name << "'";
+			_error = ss.str();
+			return false;
+		}
+
+		size_t length = (size_t)file->Length();
+		_buffer = (uint8_t*)memory::Malloc(Max<size_t>(length, 1));
+		if (file->Read(_buffer, length) != length)
+		{
+			stringstream ss; ss << "Failed to read file '" << file_name << "'";
+			_error = ss.str();
+			Close();
+			return false;
+		}
+
+		if (compiled_config::IsCompiled(_buffer, length))
+		{
+			_data = _buffer;
+			_size = length;
+			return true;
+		}
+
+		// Not compiled, treat it as a simplified-JSON source file
+		ConfigValue root;
+		if (length == 0)
+		{
+			root.SetEmptyObject();
+		}
+		else
+		{
+			simplified_json::Reader reader;
+			if (!reader.Read((const char*)_buffer, length, root))
+			{
+				_error = reader.GetErrorMessage();
+				Close();
+				return false;
+			}
+		}
+		memory::Free(_buffer);
+
+		vector<uint8_t> data;
+		DynamicMemoryStream stream(&data);
+		compiled_config::Compile(root, stream);
+
+		_buffer = (uint8_t*)memory::Malloc(data.size());
+		memcpy(_buffer, data.data(), data.size());
+		_data = _buffer;
+		_size = data.size();
+		return true;
+	}
+	void CompiledConfig::Close()
+	{
+		_file.Close();
+		if (_buffer)
+		{
+			memory::Free(_buffer);
+			_buffer = nullptr;
+		}
+		_data = nullptr;
+		_size = 0;
+	}
+	bool CompiledConfig::IsOpen() const
+	{
+		return (_data != nullptr);
+	}
+	CompiledConfigValue CompiledConfig::Root() const
+	{
+		if (!_data)
+			return CompiledConfigValue();
+
+		const compiled_config::Header* header = (const compiled_config::Header*)_data;
+		return CompiledConfigValue(header, (const compiled_config::Node*)(header + 1));
+	}
+	const string& CompiledConfig::GetErrorMessage() const
+	{
+		return _error;
+	}
+	//-------------------------------------------------------------------------------
+
+} // namespace sb
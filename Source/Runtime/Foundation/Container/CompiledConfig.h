@@ -0,0 +1,214 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __FOUNDATION_COMPILEDCONFIG_H__
+#define __FOUNDATION_COMPILEDCONFIG_H__
+
+#include "ConfigValue.h"
+#include "Filesystem/MappedFile.h"
+
+namespace sb
+{
+
+	class FileSource;
+	class Stream;
+
+	///
+	///	Compiled config
+	///
+	///	Binary form of a ConfigValue tree that is read in place, it can be memory mapped or loaded
+	///		with a single read and is then used without parsing or any further allocations.
+	///
+	///	Layout, all offsets are from the start of the data:
+	///	- Header
+	///	- Nodes, one 16 byte record per value. Children of an array or object are stored
+	///		contiguously, object members are sorted by key.
+	///	- Keys, one string offset per object member, parallel to the member nodes.
+	///	- String pool, null-terminated strings, every unique string is only stored once.
+	///
+	namespace compiled_config
+	{
+		enum
+		{
+			MAGIC = 0x46434253, // "SBCF"
+			VERSION = 1
+		};
+
+		struct Header
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t node_count;
+			uint32_t key_count;
+			uint32_t string_pool_size;
+			uint32_t total_size;
+		};
+
+		struct Node
+		{
+			uint32_t type; ///< ConfigValue::ValueType
+			uint32_t size; ///< String length or number of children
+			union
+			{
+				int64_t i;
+				uint64_t u;
+				double d;
+				uint64_t b;
+				uint32_t string; ///< Offset into the string pool
+				struct
+				{
+					uint32_t first_child; ///< Index of the first child node
+					uint32_t first_key; ///< Index of the first key, only for objects
+				} children;
+			};
+		};
+
+		/// Writes the specified value tree in the compiled format
+		void Compile(const ConfigValue& root, Stream& stream);
+
+		/// Validates the header and checks that every child, key and string reference stays within the data.
+		/// @return True if the data is a valid compiled config
+		bool IsCompiled(const void* data, size_t size);
+	};
+
+	class CompiledConfigConstIterator;
+
+	/// @brief Read-only view of a value in a compiled config
+	///	Has the same read API as ConfigValue. Views are small and passed by value, they stay valid
+	///		as long as the CompiledConfig they came from. Looking up a key that doesn't exist
+	///		gives a null value.
+	class CompiledConfigValue
+	{
+	public:
+		typedef ConfigValue::ValueType ValueType;
+		typedef CompiledConfigConstIterator ConstIterator;
+
+	public:
+		CompiledConfigValue();
+		CompiledConfigValue(const compiled_config::Header* header, const compiled_config::Node* node);
+
+		ValueType Type() const;
+
+		bool IsNull() const;
+		bool IsInt() const;
+		bool IsUInt() const;
+		bool IsFloat() const;
+		bool IsBool() const;
+		bool IsString() const;
+		bool IsArray() const;
+		bool IsObject() const;
+
+		/// @return True if value is a number, meaning either an integer, unsigned integer or float
+		bool IsNumber() const;
+
+
+		int AsInt() const;
+		int64_t AsInt64() const;
+		uint32_t AsUInt() const;
+		uint64_t AsUInt64() const;
+		float AsFloat() const;
+		double AsDouble() const;
+		bool AsBool() const;
+		const char* AsString() const;
+
+		/// @brief Returns the size of this value, the number of sub elements
+		/// @return Number of sub elements if either an array or an object.
+		///			If the value is a single element type this returns 1, and if
+		///			the value is NULL it returns 0.
+		uint32_t Size() const;
+
+		/// @brief Returns an iterator for the beginning of all object elements
+		/// @remark This only works if the value is of the type OBJECT
+		ConstIterator Begin() const;
+
+		/// @brief Returns the end iterator for the object elements
+		/// @remark This only works if the value is of the type OBJECT
+		ConstIterator End() const;
+
+		/// @brief Looks up an object member, O(log n) in the number of members
+		CompiledConfigValue operator[](const char* key) const;
+		CompiledConfigValue operator[](int index) const;
+
+	private:
+		const compiled_config::Header* _header;
+		const compiled_config::Node* _node;
+
+		const compiled_config::Node* Nodes() const;
+		const uint32_t* Keys() const;
+		const char* Strings() const;
+
+		friend class CompiledConfigConstIterator;
+	};
+
+	class CompiledConfigConstIterator
+	{
+	public:
+		struct Entry
+		{
+			const char* first;
+			CompiledConfigValue second;
+		};
+
+		CompiledConfigConstIterator();
+		CompiledConfigConstIterator(const CompiledConfigValue& object, uint32_t index);
+
+		const Entry& operator*() const;
+		const Entry* operator->() const;
+
+		CompiledConfigConstIterator& operator++();
+		CompiledConfigConstIterator operator++(int);
+
+		bool operator==(const CompiledConfigConstIterator& other) const;
+		bool operator!=(const CompiledConfigConstIterator& other) const;
+
+	private:
+		CompiledConfigValue _object;
+		uint32_t _index;
+		Entry _entry;
+
+		void SetEntry();
+	};
+
+	/// @brief Holds the data for a compiled config
+	class CompiledConfig : NonCopyable
+	{
+	public:
+		CompiledConfig();
+		~CompiledConfig();
+
+		/// @brief Uses compiled data in place
+		/// @param data Compiled config, 8 byte aligned, needs to stay valid until closed
+		/// @return False if the data isn't a valid compiled config
+		bool Open(const void* data, size_t size);
+
+		/// @brief Memory maps a compiled config file
+		///	@param file OS path to the file
+		bool OpenFile(const char* file);
+
+		/// @brief Reads a config from the file source
+		///	Compiled files are used as they are, simplified-JSON files are parsed and compiled on load.
+		///	@return False if the file couldn't be read or parsed, see GetErrorMessage
+		bool ReadFile(FileSource* source, const char* file_name);
+
+		void Close();
+		bool IsOpen() const;
+
+		/// @return The root value, a null value if nothing is open
+		CompiledConfigValue Root() const;
+
+		/// Returns an error message if the last call to ReadFile failed.
+		const string& GetErrorMessage() const;
+
+	private:
+		const uint8_t* _data;
+		size_t _size;
+
+		MappedFile _file;
+		uint8_t* _buffer;
+
+		string _error;
+	};
+
+} // namespace sb
+
+
+#endif // __FOUNDATION_COMPILEDCONFIG_H__
@@ -28,7 +28,8 @@ namespace sb
 			_value.s = new string(*source._value.s);
 			break;
 		case ARRAY:
-			_value.a = new ValueArray(*source._value.a);
+			_value.a = new ValueArray();
+			*_value.a = *source._value.a;
 			break;
 		case OBJECT:
 			_value.o = new ValueMap(*source._value.o);
@@ -245,7 +246,7 @@ namespace sb
 		case STRING:
 			return (uint32_t)_value.s->size();
 		case ARRAY:
-			return (uint32_t)_value.a->size();
+			return (uint32_t)_value.a->Size();
 		case OBJECT:
 			return (uint32_t)_value.o->size();
 		case NULL_VALUE:
@@ -435,7 +436,7 @@ namespace sb
 		Assert(_value.s);
 		*_value.s = s;
 	}
-	void ConfigValue::SetEmptyArray()
+	void ConfigValue::SetEmptyArray(Allocator& allocator)
 	{
 		switch (_type)
 		{
@@ -450,12 +451,17 @@ namespace sb
 			SetNull();
 			break;
 		case ARRAY:
-			_value.a->clear();
-			return;
+			if (&_value.a->GetAllocator() == &allocator)
+			{
+				_value.a->Clear();
+				return;
+			}
+			SetNull();
+			break;
 		};
 
 		_type = ARRAY;
-		_value.a = new ValueArray();
+		_value.a = new ValueArray(allocator);
 		Assert(_value.a);
 	}
 	void ConfigValue::SetEmptyObject()
@@ -484,8 +490,8 @@ namespace sb
 	ConfigValue& ConfigValue::Append()
 	{
 		Assert(_type == ARRAY);
-		_value.a->push_back(ConfigValue());
-		return _value.a->back();
+		_value.a->PushBack(ConfigValue());
+		return _value.a->Back();
 	}
 
 	ConfigValue::Iterator ConfigValue::Begin()
@@ -28,7 +28,7 @@ namespace sb
 		typedef ConfigValueIterator Iterator;
 		typedef ConfigValueConstIterator ConstIterator;
 
-		typedef vector<ConfigValue> ValueArray;
+		typedef Vector<ConfigValue> ValueArray;
 
 
 	public:
@@ -77,7 +77,9 @@ namespace sb
 		void SetString(const char* s);
 
 		/// @brief Sets this value to an empty array
-		void SetEmptyArray();
+		/// @param allocator Allocator for the array elements. Copies of the value always use the default
+		///					allocator, so a copy never depends on the lifetime of the original's allocator.
+		void SetEmptyArray(Allocator& allocator = memory::DefaultAllocator());
 
 		/// @brief Sets this value to an empty object
 		void SetEmptyObject();
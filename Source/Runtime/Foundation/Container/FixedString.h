@@ -0,0 +1,74 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __FOUNDATION_FIXEDSTRING_H__
+#define __FOUNDATION_FIXEDSTRING_H__
+
+#include <stdarg.h>
+
+namespace sb
+{
+
+	/// @brief String with a fixed capacity stored inline
+	///	Never allocates any memory, which makes it suitable for short-lived strings such as paths
+	///		that are built, passed along with a request and then thrown away. Anything that doesn't
+	///		fit within the capacity is truncated, the functions modifying the string return false
+	///		when that happens so that callers can reject the string.
+	///	@tparam N Capacity in characters, including the null terminator
+	template<uint32_t N>
+	class FixedString
+	{
+	public:
+		FixedString();
+		FixedString(const char* str);
+		FixedString(const char* str, uint32_t length);
+
+		/// @return False if the string was truncated
+		bool Set(const char* str);
+		/// @return False if the string was truncated
+		bool Set(const char* str, uint32_t length);
+
+		/// @return False if the string was truncated
+		bool Append(char c);
+		/// @return False if the string was truncated
+		bool Append(const char* str);
+		/// @return False if the string was truncated
+		bool Append(const char* str, uint32_t length);
+
+		/// @return False if the string was truncated
+		bool Format(const char* fmt, ...);
+
+		/// @brief Clears the string
+		void Clear();
+
+		/// @brief Returns the size of the string
+		uint32_t Size() const;
+
+		/// @brief Returns the maximum size of the string, not counting the null terminator
+		uint32_t Capacity() const;
+
+		/// @brief Returns true if the string is empty
+		bool Empty() const;
+
+		const char* Ptr() const;
+
+		FixedString& operator=(const char* str);
+		FixedString& operator+=(char c);
+		FixedString& operator+=(const char* str);
+
+		bool operator==(const char* str) const;
+		bool operator!=(const char* str) const;
+
+	private:
+		uint32_t _size;
+		char _buffer[N];
+	};
+
+	/// Fixed string large enough for any path
+	typedef FixedString<MAX_PATH> PathString;
+
+} // namespace sb
+
+
+#include "FixedString.inl"
+
+#endif // __FOUNDATION_FIXEDSTRING_H__
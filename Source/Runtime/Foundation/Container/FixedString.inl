@@ -0,0 +1,140 @@
+// Copyright 2008-2014 Simon Ekström
+
+namespace sb
+{
+
+	template<uint32_t N>
+	FixedString<N>::FixedString()
+		: _size(0)
+	{
+		_buffer[0] = '\0';
+	}
+	template<uint32_t N>
+	FixedString<N>::FixedString(const char* str)
+		: _size(0)
+	{
+		Set(str);
+	}
+	template<uint32_t N>
+	FixedString<N>::FixedString(const char* str, uint32_t length)
+		: _size(0)
+	{
+		Set(str, length);
+	}
+	template<uint32_t N>
+	bool FixedString<N>::Set(const char* str)
+	{
+		Assert(str);
+		return Set(str, (uint32_t)strlen(str));
+	}
+	template<uint32_t N>
+	bool FixedString<N>::Set(const char* str, uint32_t length)
+	{
+		_size = 0;
+		return Append(str, length);
+	}
+	template<uint32_t N>
+	bool FixedString<N>::Append(char c)
+	{
+		if (_size + 1 >= N)
+			return false;
+
+		_buffer[_size++] = c;
+		_buffer[_size] = '\0';
+		return true;
+	}
+	template<uint32_t N>
+	bool FixedString<N>::Append(const char* str)
+	{
+		Assert(str);
+		return Append(str, (uint32_t)strlen(str));
+	}
+	template<uint32_t N>
+	bool FixedString<N>::Append(const char* str, uint32_t length)
+	{
+		bool truncated = _size + length >= N;
+		if (truncated)
+			length = N - 1 - _size;
+
+		memcpy(_buffer + _size, str, length);
+		_size += length;
+		_buffer[_size] = '\0';
+		return !truncated;
+	}
+	template<uint32_t N>
+	bool FixedString<N>::Format(const char* fmt, ...)
+	{
+		Assert(fmt);
+
+		va_list args;
+		va_start(args, fmt);
+		int length = vsnprintf(_buffer, N, fmt, args);
+		va_end(args);
+
+		bool truncated = length >= (int)N;
+		if (length < 0)
+			length = 0;
+		else if (truncated)
+			length = N - 1;
+
+		_size = (uint32_t)length;
+		_buffer[_size] = '\0';
+		return !truncated;
+	}
+	template<uint32_t N>
+	void FixedString<N>::Clear()
+	{
+		_size = 0;
+		_buffer[0] = '\0';
+	}
+	template<uint32_t N>
+	uint32_t FixedString<N>::Size() const
+	{
+		return _size;
+	}
+	template<uint32_t N>
+	uint32_t FixedString<N>::Capacity() const
+	{
+		return N - 1;
+	}
+	template<uint32_t N>
+	bool FixedString<N>::Empty() const
+	{
+		return _size == 0;
+	}
+	template<uint32_t N>
+	const char* FixedString<N>::Ptr() const
+	{
+		return _buffer;
+	}
+	template<uint32_t N>
+	FixedString<N>& FixedString<N>::operator=(const char* str)
+	{
+		Set(str);
+		return *this;
+	}
+	template<uint32_t N>
+	FixedString<N>& FixedString<N>::operator+=(char c)
+	{
+		Append(c);
+		return *this;
+	}
+	template<uint32_t N>
+	FixedString<N>& FixedString<N>::operator+=(const char* str)
+	{
+		Append(str);
+		return *this;
+	}
+	template<uint32_t N>
+	bool FixedString<N>::operator==(const char* str) const
+	{
+		Assert(str);
+		return strcmp(_buffer, str) == 0;
+	}
+	template<uint32_t N>
+	bool FixedString<N>::operator!=(const char* str) const
+	{
+		return !(*this == str);
+	}
+
+} // namespace sb
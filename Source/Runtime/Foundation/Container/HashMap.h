@@ -0,0 +1,208 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __FOUNDATION_HASHMAP_H__
+#define __FOUNDATION_HASHMAP_H__
+
+#include "Pair.h"
+
+#include <functional>
+
+namespace sb
+{
+
+	/// Function class for hashing keys in a HashMap
+	template<typename T>
+	class Hash
+	{
+	public:
+		size_t operator()(const T& value) const
+		{
+			return std::hash<T>()(value);
+		}
+	};
+
+	/// String identifiers are already hashes
+	template<>
+	class Hash<StringId32>
+	{
+	public:
+		size_t operator()(const StringId32& value) const
+		{
+			return value.GetId();
+		}
+	};
+	template<>
+	class Hash<StringId64>
+	{
+	public:
+		size_t operator()(const StringId64& value) const
+		{
+			return (size_t)value.GetId();
+		}
+	};
+
+	/// @brief Hash map using open addressing with linear probing
+	///	Keys and values are stored in a single flat allocation together with an array of 32 bit
+	///	hashes which is what probing runs over, keys are only compared when the hashes match.
+	///	Unlike Map, iterators and references are invalidated by any insertion or removal.
+	template<typename Key, typename Value, typename HashFunc = Hash<Key>>
+	class HashMap
+	{
+	public:
+		typedef Pair<Key, Value> ValueType;
+
+		class ConstIterator
+		{
+			friend HashMap;
+		public:
+			ConstIterator();
+			ConstIterator(const HashMap* map, size_t index);
+
+			const ValueType& operator*() const;
+			const ValueType* operator->() const;
+
+			ConstIterator& operator++();
+			ConstIterator operator++(int);
+
+			bool operator==(const ConstIterator& other) const;
+			bool operator!=(const ConstIterator& other) const;
+
+		protected:
+			HashMap* _map;
+			size_t _index;
+		};
+
+		class Iterator : public ConstIterator
+		{
+			friend HashMap;
+		public:
+			Iterator();
+			Iterator(HashMap* map, size_t index);
+
+			ValueType& operator*() const;
+			ValueType* operator->() const;
+
+			Iterator& operator++();
+			Iterator operator++(int);
+		};
+
+	public:
+		HashMap(Allocator& allocator = memory::DefaultAllocator());
+		HashMap(const HashMap& other);
+		~HashMap();
+
+		HashMap& operator=(const HashMap& other);
+
+		/// @brief Returns the number of elements in the map
+		size_t Size() const;
+
+		/// @brief Returns true if the map is empty
+		bool Empty() const;
+
+		/// @brief Makes sure the specified number of elements can be inserted without a rehash
+		void Reserve(size_t count);
+
+
+		/// @brief Returns an iterator to the beginning of this map
+		Iterator Begin();
+
+		/// @brief Returns an const iterator to the beginning of this map
+		ConstIterator Begin() const;
+
+		/// @brief Returns an iterator to the end of this map
+		Iterator End();
+
+		/// @brief Returns an const iterator to the end of this map
+		ConstIterator End() const;
+
+
+		/// @brief Find the element with the specified key
+		/// @return Iterator to the element, or End() if there's no such element
+		Iterator Find(const Key& key);
+		/// @brief Find the element with the specified key
+		/// @return Iterator to the element, or End() if there's no such element
+		ConstIterator Find(const Key& key) const;
+
+		/// @brief Returns the value for the specified key, inserting a default value if it doesn't exist
+		Value& operator[](const Key& key);
+
+
+		/// @name Modifiers
+		/// @{
+
+		/// @brief Inserts a new element to the map
+		/// @return A pair containing an iterator and a boolean value. If the value was inserted,
+		///			the boolean will be true and the iterator will reference the inserted element.
+		///			If an element with the same key already exists, then the boolean will be false and
+		///			the iterator will reference the existing element.
+		Pair<Iterator, bool> Insert(const ValueType& val);
+
+		/// @brief Removes an element with the specified key from the map
+		/// @return The number of elements erased
+		size_t Erase(const Key& key);
+
+		/// @brief Removes an element at the specified position
+		void Erase(Iterator position);
+
+		/// @brief Removes all items from the map, keeps the capacity
+		void Clear();
+
+		/// @}
+
+	private:
+		enum { MIN_CAPACITY = 16 };
+
+		Allocator* _allocator;
+
+		/// Hash for each slot, 0 marks an empty slot
+		uint32_t* _hashes;
+		/// Element for each slot, only constructed for non-empty slots
+		ValueType* _entries;
+
+		size_t _size;
+		size_t _capacity; ///< Number of slots, always a power of two
+
+		/// Returns the hash for the specified key, never 0
+		uint32_t HashKey(const Key& key) const;
+
+		/// Returns the slot holding the key, or the capacity if not found
+		size_t FindSlot(const Key& key, uint32_t hash) const;
+
+		/// Returns the first non-empty slot starting at index, or the capacity if there's none
+		size_t NextSlot(size_t index) const;
+
+		/// Claims the first empty slot in the probe chain for the hash, the caller constructs the element
+		size_t InsertSlot(uint32_t hash);
+
+		/// Removes the element at the specified slot and shifts back any following elements in the same probe chain
+		void EraseSlot(size_t index);
+
+		/// Resizes the table to the specified number of slots and reinserts all elements
+		void Rehash(size_t capacity);
+
+	public:
+		INLINE Iterator begin()
+		{
+			return Begin();
+		}
+		INLINE ConstIterator begin() const
+		{
+			return Begin();
+		}
+		INLINE Iterator end()
+		{
+			return End();
+		}
+		INLINE ConstIterator end() const
+		{
+			return End();
+		}
+	};
+
+} // namespace sb
+
+
+#include "HashMap.inl"
+
+
+#endif // __FOUNDATION_HASHMAP_H__
@@ -0,0 +1,371 @@
+// Copyright 2008-2014 Simon Ekström
+
+namespace sb
+{
+
+	//-------------------------------------------------------------------------------
+	template<typename Key, typename Value, typename HashFunc>
+	HashMap<Key, Value, HashFunc>::ConstIterator::ConstIterator()
+		: _map(nullptr), _index(0)
+	{
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	HashMap<Key, Value, HashFunc>::ConstIterator::ConstIterator(const HashMap* map, size_t index)
+		: _map(const_cast<HashMap*>(map)), _index(index)
+	{
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	const typename HashMap<Key, Value, HashFunc>::ValueType&
+		HashMap<Key, Value, HashFunc>::ConstIterator::operator*() const
+	{
+		Assert(_map);
+		Assert(_index < _map->_capacity);
+		return _map->_entries[_index];
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	const typename HashMap<Key, Value, HashFunc>::ValueType*
+		HashMap<Key, Value, HashFunc>::ConstIterator::operator->() const
+	{
+		Assert(_map);
+		Assert(_index < _map->_capacity);
+		return &_map->_entries[_index];
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	typename HashMap<Key, Value, HashFunc>::ConstIterator&
+		HashMap<Key, Value, HashFunc>::ConstIterator::operator++()
+	{
+		Assert(_map);
+		Assert(_index < _map->_capacity);
+		_index = _map->NextSlot(_index + 1);
+		return *this;
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	typename HashMap<Key, Value, HashFunc>::ConstIterator
+		HashMap<Key, Value, HashFunc>::ConstIterator::operator++(int)
+	{
+		ConstIterator iterator = *this;
+		++(*this);
+		return iterator;
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	bool HashMap<Key, Value, HashFunc>::ConstIterator::operator==(const ConstIterator& other) const
+	{
+		return (_map == other._map && _index == other._index);
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	bool HashMap<Key, Value, HashFunc>::ConstIterator::operator!=(const ConstIterator& other) const
+	{
+		return (_map != other._map || _index != other._index);
+	}
+	//-------------------------------------------------------------------------------
+	template<typename Key, typename Value, typename HashFunc>
+	HashMap<Key, Value, HashFunc>::Iterator::Iterator()
+		: ConstIterator()
+	{
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	HashMap<Key, Value, HashFunc>::Iterator::Iterator(HashMap* map, size_t index)
+		: ConstIterator(map, index)
+	{
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	typename HashMap<Key, Value, HashFunc>::ValueType&
+		HashMap<Key, Value, HashFunc>::Iterator::operator*() const
+	{
+		return const_cast<ValueType&>(ConstIterator::operator*());
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	typename HashMap<Key, Value, HashFunc>::ValueType*
+		HashMap<Key, Value, HashFunc>::Iterator::operator->() const
+	{
+		return const_cast<ValueType*>(ConstIterator::operator->());
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	typename HashMap<Key, Value, HashFunc>::Iterator&
+		HashMap<Key, Value, HashFunc>::Iterator::operator++()
+	{
+		ConstIterator::operator++();
+		return *this;
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	typename HashMap<Key, Value, HashFunc>::Iterator
+		HashMap<Key, Value, HashFunc>::Iterator::operator++(int)
+	{
+		Iterator iterator = *this;
+		++(*this);
+		return iterator;
+	}
+
+	//-------------------------------------------------------------------------------
+	template<typename Key, typename Value, typename HashFunc>
+	HashMap<Key, Value, HashFunc>::HashMap(Allocator& allocator)
+		: _allocator(&allocator),
+		_hashes(nullptr),
+		_entries(nullptr),
+		_size(0),
+		_capacity(0)
+	{
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	HashMap<Key, Value, HashFunc>::HashMap(const HashMap& other)
+		: _allocator(other._allocator),
+		_hashes(nullptr),
+		_entries(nullptr),
+		_size(0),
+		_capacity(0)
+	{
+		*this = other;
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	HashMap<Key, Value, HashFunc>::~HashMap()
+	{
+		Clear();
+		if (_hashes)
+			_allocator->Free(_hashes);
+	}
+	//-------------------------------------------------------------------------------
+	template<typename Key, typename Value, typename HashFunc>
+	HashMap<Key, Value, HashFunc>& HashMap<Key, Value, HashFunc>::operator=(const HashMap& other)
+	{
+		if (this == &other)
+			return *this;
+
+		Clear();
+		Reserve(other._size);
+		for (size_t i = 0; i < other._capacity; ++i)
+		{
+			if (other._hashes[i] == 0)
+				continue;
+
+			// Keys are known to be unique so we can skip the lookup
+			size_t mask = _capacity - 1;
+			size_t index = other._hashes[i] & mask;
+			while (_hashes[index] != 0)
+				index = (index + 1) & mask;
+
+			_hashes[index] = other._hashes[i];
+			new (&_entries[index]) ValueType(other._entries[i]);
+			++_size;
+		}
+		return *this;
+	}
+	//-------------------------------------------------------------------------------
+	template<typename Key, typename Value, typename HashFunc>
+	size_t HashMap<Key, Value, HashFunc>::Size() const
+	{
+		return _size;
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	bool HashMap<Key, Value, HashFunc>::Empty() const
+	{
+		return (_size == 0);
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	void HashMap<Key, Value, HashFunc>::Reserve(size_t count)
+	{
+		size_t capacity = MIN_CAPACITY;
+		while (capacity * 3 < count * 4)
+			capacity *= 2;
+
+		if (capacity > _capacity)
+			Rehash(capacity);
+	}
+	//-------------------------------------------------------------------------------
+	template<typename Key, typename Value, typename HashFunc>
+	typename HashMap<Key, Value, HashFunc>::Iterator HashMap<Key, Value, HashFunc>::Begin()
+	{
+		return Iterator(this, NextSlot(0));
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	typename HashMap<Key, Value, HashFunc>::ConstIterator HashMap<Key, Value, HashFunc>::Begin() const
+	{
+		return ConstIterator(this, NextSlot(0));
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	typename HashMap<Key, Value, HashFunc>::Iterator HashMap<Key, Value, HashFunc>::End()
+	{
+		return Iterator(this, _capacity);
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	typename HashMap<Key, Value, HashFunc>::ConstIterator HashMap<Key, Value, HashFunc>::End() const
+	{
+		return ConstIterator(this, _capacity);
+	}
+	//-------------------------------------------------------------------------------
+	template<typename Key, typename Value, typename HashFunc>
+	typename HashMap<Key, Value, HashFunc>::Iterator HashMap<Key, Value, HashFunc>::Find(const Key& key)
+	{
+		return Iterator(this, FindSlot(key, HashKey(key)));
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	typename HashMap<Key, Value, HashFunc>::ConstIterator HashMap<Key, Value, HashFunc>::Find(const Key& key) const
+	{
+		return ConstIterator(this, FindSlot(key, HashKey(key)));
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	Value& HashMap<Key, Value, HashFunc>::operator[](const Key& key)
+	{
+		size_t index = FindSlot(key, HashKey(key));
+		if (index != _capacity)
+			return _entries[index].second;
+
+		return Insert(ValueType(key, Value())).first->second;
+	}
+	//-------------------------------------------------------------------------------
+	template<typename Key, typename Value, typename HashFunc>
+	Pair<typename HashMap<Key, Value, HashFunc>::Iterator, bool> HashMap<Key, Value, HashFunc>::Insert(const ValueType& val)
+	{
+		uint32_t hash = HashKey(val.first);
+		size_t index = FindSlot(val.first, hash);
+		if (index != _capacity)
+			return Pair<Iterator, bool>(Iterator(this, index), false);
+
+		if ((_size + 1) * 4 > _capacity * 3)
+		{
+			// The value may refer to an element of this map, so it has to be copied before the slots are released
+			ValueType copy(val);
+			Rehash(Max<size_t>(_capacity * 2, MIN_CAPACITY));
+			index = InsertSlot(hash);
+			new (&_entries[index]) ValueType(copy);
+		}
+		else
+		{
+			index = InsertSlot(hash);
+			new (&_entries[index]) ValueType(val);
+		}
+		++_size;
+
+		return Pair<Iterator, bool>(Iterator(this, index), true);
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	size_t HashMap<Key, Value, HashFunc>::Erase(const Key& key)
+	{
+		size_t index = FindSlot(key, HashKey(key));
+		if (index == _capacity)
+			return 0;
+
+		EraseSlot(index);
+		return 1;
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	void HashMap<Key, Value, HashFunc>::Erase(Iterator position)
+	{
+		Assert(position._map == this);
+		Assert(position._index < _capacity && _hashes[position._index] != 0);
+		EraseSlot(position._index);
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	void HashMap<Key, Value, HashFunc>::Clear()
+	{
+		for (size_t i = 0; i < _capacity; ++i)
+		{
+			if (_hashes[i] != 0)
+			{
+				_entries[i].~ValueType();
+				_hashes[i] = 0;
+			}
+		}
+		_size = 0;
+	}
+	//-------------------------------------------------------------------------------
+	template<typename Key, typename Value, typename HashFunc>
+	uint32_t HashMap<Key, Value, HashFunc>::HashKey(const Key& key) const
+	{
+		// Fibonacci hashing, spreads keys that only differ in the high bits (e.g. pointers)
+		uint32_t hash = (uint32_t)(((uint64_t)HashFunc()(key) * 0x9E3779B97F4A7C15ull) >> 32);
+		return hash ? hash : 1;
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	size_t HashMap<Key, Value, HashFunc>::FindSlot(const Key& key, uint32_t hash) const
+	{
+		if (_size == 0)
+			return _capacity;
+
+		size_t mask = _capacity - 1;
+		for (size_t index = hash & mask; _hashes[index] != 0; index = (index + 1) & mask)
+		{
+			if (_hashes[index] == hash && _entries[index].first == key)
+				return index;
+		}
+		return _capacity;
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	size_t HashMap<Key, Value, HashFunc>::NextSlot(size_t index) const
+	{
+		while (index < _capacity && _hashes[index] == 0)
+			++index;
+		return index;
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	size_t HashMap<Key, Value, HashFunc>::InsertSlot(uint32_t hash)
+	{
+		size_t mask = _capacity - 1;
+		size_t index = hash & mask;
+		while (_hashes[index] != 0)
+			index = (index + 1) & mask;
+
+		_hashes[index] = hash;
+		return index;
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	void HashMap<Key, Value, HashFunc>::EraseSlot(size_t index)
+	{
+		size_t mask = _capacity - 1;
+		_entries[index].~ValueType();
+
+		// Shift back any elements that would no longer be reachable with the hole in their probe chain
+		size_t hole = index;
+		for (size_t i = (index + 1) & mask; _hashes[i] != 0; i = (i + 1) & mask)
+		{
+			size_t home = _hashes[i] & mask;
+			if (((i - home) & mask) >= ((i - hole) & mask))
+			{
+				_hashes[hole] = _hashes[i];
+				new (&_entries[hole]) ValueType(_entries[i]);
+				_entries[i].~ValueType();
+				hole = i;
+			}
+		}
+		_hashes[hole] = 0;
+		--_size;
+	}
+	template<typename Key, typename Value, typename HashFunc>
+	void HashMap<Key, Value, HashFunc>::Rehash(size_t capacity)
+	{
+		Assert((capacity & (capacity - 1)) == 0);
+		Assert(capacity * 3 >= _size * 4);
+
+		// Hashes and entries share a single allocation
+		size_t align = Max<size_t>(__alignof(ValueType), __alignof(uint32_t));
+		size_t entries_offset = (capacity * sizeof(uint32_t) + align - 1) & ~(align - 1);
+
+		uint8_t* buffer = (uint8_t*)_allocator->Allocate(entries_offset + capacity * sizeof(ValueType), align);
+		uint32_t* hashes = (uint32_t*)buffer;
+		ValueType* entries = (ValueType*)(buffer + entries_offset);
+		memset(hashes, 0, capacity * sizeof(uint32_t));
+
+		size_t mask = capacity - 1;
+		for (size_t i = 0; i < _capacity; ++i)
+		{
+			if (_hashes[i] == 0)
+				continue;
+
+			size_t index = _hashes[i] & mask;
+			while (hashes[index] != 0)
+				index = (index + 1) & mask;
+
+			hashes[index] = _hashes[i];
+			new (&entries[index]) ValueType(_entries[i]);
+			_entries[i].~ValueType();
+		}
+
+		if (_hashes)
+			_allocator->Free(_hashes);
+
+		_hashes = hashes;
+		_entries = entries;
+		_capacity = capacity;
+	}
+	//-------------------------------------------------------------------------------
+
+} // namespace sb
@@ -0,0 +1,135 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "InternedString.h"
+#include "Hash/murmur_hash.h"
+#include "Thread/Lock.h"
+
+namespace sb
+{
+
+	//-------------------------------------------------------------------------------
+
+	namespace
+	{
+		typedef InternedString::Entry Entry;
+
+		/// Address space reserved for the string table, memory is only committed as strings are added
+		///	Kept small on 32 bit where address space is scarce, the arena continues in chunks if it runs out.
+		const size_t STRING_ARENA_RESERVE_SIZE = (sizeof(void*) == 8 ? 256 : 16) * 1024 * 1024;
+		const uint32_t INITIAL_BUCKET_COUNT = 1024;
+
+		/// Strings may be interned by static initializers in other translation units, constructing
+		///	the lock on first use avoids depending on the order of initialization.
+		CriticalSection& GetLock()
+		{
+			static CriticalSection lock;
+			return lock;
+		}
+
+		/// Holds all strings and bucket arrays, nothing in the table is ever released
+		char g_arena_buffer[sizeof(LinearAllocator)];
+		LinearAllocator* g_arena = nullptr;
+
+		Entry** g_buckets = nullptr;
+		uint32_t g_bucket_count = 0;
+		uint32_t g_string_count = 0;
+
+		/// Shared by all empty strings, so that default constructed strings need no lookup
+		const Entry g_empty_string = { nullptr, 0, 0, { '\0' } };
+
+		Entry** AllocateBuckets(uint32_t count)
+		{
+			Entry** buckets = (Entry**)g_arena->Allocate(count * sizeof(Entry*), sizeof(Entry*));
+			memset(buckets, 0, count * sizeof(Entry*));
+			return buckets;
+		}
+
+		/// Doubles the number of buckets, the old bucket array is left in the arena as the
+		///	arena can't free anything. This never wastes more than the size of the current array.
+		void GrowBuckets()
+		{
+			uint32_t bucket_count = g_bucket_count * 2;
+			Entry** buckets = AllocateBuckets(bucket_count);
+
+			for (uint32_t i = 0; i < g_bucket_count; ++i)
+			{
+				Entry* entry = g_buckets[i];
+				while (entry)
+				{
+					Entry* next = entry->next;
+					uint32_t index = entry->hash & (bucket_count - 1);
+					entry->next = buckets[index];
+					buckets[index] = entry;
+					entry = next;
+				}
+			}
+
+			g_buckets = buckets;
+			g_bucket_count = bucket_count;
+		}
+
+		const char* Intern(const char* str, uint32_t length)
+		{
+			Assert(str);
+			if (length == 0)
+				return g_empty_string.str;
+
+			uint32_t hash = murmur_hash_32(str, length, 0);
+
+			ScopedLock<CriticalSection> lock(GetLock());
+			if (!g_arena)
+			{
+				g_arena = new (g_arena_buffer) LinearAllocator(LinearAllocator::ArenaSettings(STRING_ARENA_RESERVE_SIZE));
+				g_buckets = AllocateBuckets(INITIAL_BUCKET_COUNT);
+				g_bucket_count = INITIAL_BUCKET_COUNT;
+			}
+
+			for (Entry* entry = g_buckets[hash & (g_bucket_count - 1)]; entry; entry = entry->next)
+			{
+				if (entry->hash == hash && entry->length == length && memcmp(entry->str, str, length) == 0)
+					return entry->str;
+			}
+
+			if (g_string_count >= g_bucket_count)
+				GrowBuckets();
+
+			Entry* entry = (Entry*)g_arena->Allocate(offsetof(Entry, str) + length + 1, sizeof(Entry*));
+			entry->hash = hash;
+			entry->length = length;
+			memcpy(entry->str, str, length);
+			entry->str[length] = '\0';
+
+			uint32_t index = hash & (g_bucket_count - 1);
+			entry->next = g_buckets[index];
+			g_buckets[index] = entry;
+			++g_string_count;
+
+			return entry->str;
+		}
+	};
+
+	//-------------------------------------------------------------------------------
+
+	InternedString::InternedString()
+		: _str(g_empty_string.str)
+	{
+	}
+	InternedString::InternedString(const char* str)
+		: _str(Intern(str, (uint32_t)strlen(str)))
+	{
+	}
+	InternedString::InternedString(const char* str, uint32_t length)
+		: _str(Intern(str, length))
+	{
+	}
+	InternedString::InternedString(const string& str)
+		: _str(Intern(str.c_str(), (uint32_t)str.size()))
+	{
+	}
+
+	//-------------------------------------------------------------------------------
+
+} // namespace sb
+
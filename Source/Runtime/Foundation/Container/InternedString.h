@@ -0,0 +1,108 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __FOUNDATION_INTERNEDSTRING_H__
+#define __FOUNDATION_INTERNEDSTRING_H__
+
+#include "HashMap.h"
+
+namespace sb
+{
+
+	/// @brief Immutable string stored once in a global string table
+	///	
+	///	Every distinct string is only stored once, in an arena that lives until the application exits.
+	///		Two interned strings are equal if they point to the same characters, which means that
+	///		comparing, copying and hashing is as cheap as for a pointer. Interning a string takes a
+	///		global lock and a hash lookup, so identifiers should be interned once and then passed around.
+	///	Intended for identifiers from a limited set, such as resource types and names or file extensions,
+	///		as memory for interned strings is never released.
+	class InternedString
+	{
+	public:
+		/// Empty string
+		InternedString();
+		InternedString(const char* str);
+		InternedString(const char* str, uint32_t length);
+		InternedString(const string& str);
+
+		const char* c_str() const;
+
+		/// @brief Returns the length of the string
+		uint32_t Size() const;
+
+		/// @brief Returns true if the string is empty
+		bool Empty() const;
+
+		/// @brief Hash of the characters of the string, calculated when the string was interned
+		uint32_t Hash() const;
+
+		bool operator==(const InternedString& other) const;
+		bool operator!=(const InternedString& other) const;
+
+		/// @brief Compares the characters of the strings, giving the same order in every run
+		bool operator<(const InternedString& other) const;
+
+		/// Header stored in the string table in front of the characters of each string
+		struct Entry
+		{
+			Entry* next; ///< Next entry in the same bucket
+			uint32_t hash;
+			uint32_t length;
+			char str[1];
+		};
+
+	private:
+		const char* _str;
+
+		const Entry* GetEntry() const;
+	};
+
+	template<>
+	class Hash<InternedString>
+	{
+	public:
+		size_t operator()(const InternedString& value) const
+		{
+			return value.Hash();
+		}
+	};
+
+	//-------------------------------------------------------------------------------
+	INLINE const char* InternedString::c_str() const
+	{
+		return _str;
+	}
+	INLINE uint32_t InternedString::Size() const
+	{
+		return GetEntry()->length;
+	}
+	INLINE bool InternedString::Empty() const
+	{
+		return *_str == '\0';
+	}
+	INLINE uint32_t InternedString::Hash() const
+	{
+		return GetEntry()->hash;
+	}
+	INLINE bool InternedString::operator==(const InternedString& other) const
+	{
+		return _str == other._str;
+	}
+	INLINE bool InternedString::operator!=(const InternedString& other) const
+	{
+		return _str != other._str;
+	}
+	INLINE bool InternedString::operator<(const InternedString& other) const
+	{
+		return _str != other._str && strcmp(_str, other._str) < 0;
+	}
+	INLINE const InternedString::Entry* InternedString::GetEntry() const
+	{
+		return (const Entry*)(_str - offsetof(Entry, str));
+	}
+	//-------------------------------------------------------------------------------
+
+} // namespace sb
+
+
+#endif // __FOUNDATION_INTERNEDSTRING_H__
@@ -0,0 +1,36 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __FOUNDATION_SMALLVECTOR_H__
+#define __FOUNDATION_SMALLVECTOR_H__
+
+#include "Vector.h"
+
+#include <type_traits>
+
+namespace sb
+{
+
+	/// @brief Vector storing up to N elements inline
+	///	Nothing is allocated until the array grows beyond N elements, after that it behaves like a
+	///	regular Vector using the specified allocator. Can be passed anywhere a Vector<T>& is expected.
+	template<typename T, size_t N>
+	class SmallVector : public Vector<T>
+	{
+	public:
+		SmallVector(Allocator& allocator = memory::DefaultAllocator());
+		SmallVector(const SmallVector& other);
+		SmallVector(const Vector<T>& other);
+
+		SmallVector& operator=(const SmallVector& other);
+		SmallVector& operator=(const Vector<T>& other);
+
+	private:
+		/// Uninitialized storage, elements are constructed and destructed by Vector
+		typename std::aligned_storage<sizeof(T) * N, __alignof(T)>::type _storage;
+	};
+
+} // namespace sb
+
+#include "SmallVector.inl"
+
+#endif // __FOUNDATION_SMALLVECTOR_H__
@@ -0,0 +1,39 @@
+// Copyright 2008-2014 Simon Ekström
+
+namespace sb
+{
+
+	//-------------------------------------------------------------------------------
+	template<typename T, size_t N>
+	SmallVector<T, N>::SmallVector(Allocator& allocator)
+		: Vector<T>(allocator, (T*)&_storage, N)
+	{
+	}
+	template<typename T, size_t N>
+	SmallVector<T, N>::SmallVector(const SmallVector& other)
+		: Vector<T>(other.GetAllocator(), (T*)&_storage, N)
+	{
+		Vector<T>::operator=(other);
+	}
+	template<typename T, size_t N>
+	SmallVector<T, N>::SmallVector(const Vector<T>& other)
+		: Vector<T>(other.GetAllocator(), (T*)&_storage, N)
+	{
+		Vector<T>::operator=(other);
+	}
+	//-------------------------------------------------------------------------------
+	template<typename T, size_t N>
+	SmallVector<T, N>& SmallVector<T, N>::operator=(const SmallVector& other)
+	{
+		Vector<T>::operator=(other);
+		return *this;
+	}
+	template<typename T, size_t N>
+	SmallVector<T, N>& SmallVector<T, N>::operator=(const Vector<T>& other)
+	{
+		Vector<T>::operator=(other);
+		return *this;
+	}
+	//-------------------------------------------------------------------------------
+
+} // namespace sb
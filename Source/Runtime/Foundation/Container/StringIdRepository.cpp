@@ -5,11 +5,41 @@
 #include "StringIdRepository.h"
 #include "ConfigValue.h"
 #include "Filesystem/FileSource.h"
+#include "Filesystem/FileUtil.h"
 #include "Json/Json.h"
+#include "Json/JsonDocument.h"
 
 namespace sb
 {
 
+	namespace
+	{
+		/// Passes writes through to another stream and remembers if any of them came up short
+		class CheckedStream : public Stream
+		{
+		public:
+			explicit CheckedStream(Stream& stream) : _stream(stream), _failed(false) {}
+
+			size_t Read(void*, size_t) { return 0; }
+			size_t Write(const void* src, size_t size)
+			{
+				size_t written = _stream.Write(src, size);
+				if (written != size)
+					_failed = true;
+				return written;
+			}
+			int64_t Seek(int64_t offset) { return _stream.Seek(offset); }
+			int64_t Tell() const { return _stream.Tell(); }
+			int64_t Length() const { return _stream.Length(); }
+
+			bool Failed() const { return _failed; }
+
+		private:
+			Stream& _stream;
+			bool _failed;
+		};
+	}
+
 	StringIdRepository::StringIdRepository(FileSource* file_source, const char* target_path)
 		: _file_source(file_source),
 		_target_path(target_path)
@@ -21,12 +51,14 @@ namespace sb
 
 	void StringIdRepository::Add(uint32_t id, const char* str, uint32_t len)
 	{
+		ScopedLock<CriticalSection> lock(_lock);
 		map<uint32_t, string>::const_iterator it = _strings_32.find(id);
 		if (it == _strings_32.end())
 			_strings_32[id] = string(str, len);
 	}
 	void StringIdRepository::Add(uint64_t id, const char* str, uint32_t len)
 	{
+		ScopedLock<CriticalSection> lock(_lock);
 		map<uint64_t, string>::const_iterator it = _strings_64.find(id);
 		if (it == _strings_64.end())
 			_strings_64[id] = string(str, len);
@@ -34,6 +66,7 @@ namespace sb
 
 	const char* StringIdRepository::LookUp(uint32_t id) const
 	{
+		ScopedLock<CriticalSection> lock(_lock);
 		map<uint32_t, string>::const_iterator it = _strings_32.find(id);
 		if (it != _strings_32.end())
 			return it->second.c_str();
@@ -43,6 +76,7 @@ namespace sb
 
 	const char* StringIdRepository::LookUp(uint64_t id) const
 	{
+		ScopedLock<CriticalSection> lock(_lock);
 		map<uint64_t, string>::const_iterator it = _strings_64.find(id);
 		if (it != _strings_64.end())
 			return it->second.c_str();
@@ -55,41 +89,66 @@ namespace sb
 		Assert(_file_source);
 		Assert(!_target_path.empty());
 
-		ConfigValue root;
-		root.SetEmptyObject();
-
-		root["string_id_32"].SetEmptyArray();
-		for (auto& id : _strings_32)
+		// The lock is only held while copying the entries, other threads keep registering strings
+		//	while the file is written.
+		vector<pair<uint32_t, string>> strings_32;
+		vector<pair<uint64_t, string>> strings_64;
 		{
-			ConfigValue& entry = root["string_id_32"].Append();
-			entry.SetEmptyArray();
-			entry.Append().SetUInt(id.first);
-			entry.Append().SetString(id.second.c_str());
+			ScopedLock<CriticalSection> lock(_lock);
+			strings_32.assign(_strings_32.begin(), _strings_32.end());
+			strings_64.assign(_strings_64.begin(), _strings_64.end());
 		}
 
-
-		root["string_id_64"].SetEmptyArray();
-		for (auto& id : _strings_64)
+		// Written to a temporary file first so that a failed save never leaves a truncated repository behind
+		string temp_path = _target_path + ".tmp";
+		bool written = false;
 		{
-			ConfigValue& entry = root["string_id_64"].Append();
-			entry.SetEmptyArray();
-			entry.Append().SetUInt(id.first);
-			entry.Append().SetString(id.second.c_str());
+			FileStreamPtr file = _file_source->OpenFile(temp_path.c_str(), File::WRITE);
+			if (file.Get())
+			{
+				CheckedStream stream(*file.Get());
+				{
+					// The writer streams the entries to the file through its fixed size buffer
+					json::Writer writer(stream, true);
+					writer.BeginObject();
+
+					writer.Key("string_id_32");
+					writer.BeginArray();
+					for (auto& id : strings_32)
+					{
+						writer.BeginArray();
+						writer.UInt(id.first);
+						writer.String(id.second.c_str());
+						writer.EndArray();
+					}
+					writer.EndArray();
+
+					writer.Key("string_id_64");
+					writer.BeginArray();
+					for (auto& id : strings_64)
+					{
+						writer.BeginArray();
+						writer.UInt(id.first);
+						writer.String(id.second.c_str());
+						writer.EndArray();
+					}
+					writer.EndArray();
+
+					writer.EndObject();
+					writer.Flush();
+				}
+				written = !stream.Failed();
+			}
 		}
 
-		FileStreamPtr file = _file_source->OpenFile(_target_path.c_str(), File::WRITE);
-		if (!file.Get())
+		string full_temp_path = BuildOSPath(temp_path);
+		if (!written || !file_util::RenameFile(full_temp_path.c_str(), BuildOSPath(_target_path).c_str()))
 		{
+			remove(full_temp_path.c_str());
 			logging::Warning("Failed to save StringId repository.");
 			return;
 		}
 
-		json::Writer writer;
-		stringstream ss;
-		writer.Write(root, ss, true);
-
-		file->Write(ss.str().c_str(), (uint32_t)ss.str().size());
-
 		logging::Info("StringId repository successfully saved.");
 	}
 	bool StringIdRepository::Load()
@@ -97,41 +156,48 @@ namespace sb
 		Assert(_file_source);
 		Assert(!_target_path.empty());
 
-		ConfigValue root;
+		JsonDocument document;
+		if (!document.ReadFile(_file_source, _target_path.c_str()))
+		{
+			logging::Warning("Failed loading StringId repository: %s", document.GetErrorMessage().c_str());
+			return false;
+		}
 
-		json::Reader reader;
-		if (!reader.ReadFile(_file_source, _target_path.c_str(), root))
+		JsonValue root = document.Root();
+		if (!root.IsObject())
 		{
-			logging::Warning("Failed loading StringId repository: %s", reader.GetErrorMessage().c_str());
+			logging::Warning("Failed loading StringId repository: Expected an object at the root");
 			return false;
 		}
 
-		const ConfigValue& string_id_32 = root["string_id_32"];
+		JsonValue string_id_32 = root["string_id_32"];
 		if (string_id_32.IsArray())
 		{
 			for (uint32_t i = 0; i < string_id_32.Size(); ++i)
 			{
-				if (string_id_32[i].IsArray() && string_id_32[i].Size() == 2)
+				JsonValue entry = string_id_32[i];
+				if (entry.IsArray() && entry.Size() == 2)
 				{
-					if (!string_id_32[i][0].IsNumber() || !string_id_32[i][1].IsString())
+					if (!entry[0].IsNumber() || !entry[1].IsString())
 						continue;
 
-					Add(string_id_32[i][0].AsUInt(), string_id_32[i][1].AsString(), (uint32_t)strlen(string_id_32[i][1].AsString()));
+					Add(entry[0].AsUInt(), entry[1].AsString(), entry[1].Size());
 				}
 			}
 		}
 
-		const ConfigValue& string_id_64 = root["string_id_64"];
+		JsonValue string_id_64 = root["string_id_64"];
 		if (string_id_64.IsArray())
 		{
 			for (uint32_t i = 0; i < string_id_64.Size(); ++i)
 			{
-				if (string_id_64[i].IsArray() && string_id_64[i].Size() == 2)
+				JsonValue entry = string_id_64[i];
+				if (entry.IsArray() && entry.Size() == 2)
 				{
-					if (!string_id_64[i][0].IsNumber() || !string_id_64[i][1].IsString())
+					if (!entry[0].IsNumber() || !entry[1].IsString())
 						continue;
 
-					Add(string_id_64[i][0].AsUInt64(), string_id_64[i][1].AsString(), (uint32_t)strlen(string_id_64[i][1].AsString()));
+					Add(entry[0].AsUInt64(), entry[1].AsString(), entry[1].Size());
 				}
 			}
 		}
@@ -140,5 +206,14 @@ namespace sb
 		logging::Info("StringId repository successfully loaded.");
 		return true;
 	}
+	string StringIdRepository::BuildOSPath(const string& path) const
+	{
+		string full_path = _file_source->GetFullPath();
+		full_path += PATH_SEPARATOR;
+		full_path += path;
+
+		file_util::FixSlashes(full_path);
+		return full_path;
+	}
 
 } // namespace sb
@@ -3,10 +3,14 @@
 #ifndef __FOUNDATION_STRINGIDREPOSITORY_H__
 #define __FOUNDATION_STRINGIDREPOSITORY_H__
 
+#include <Foundation/Thread/Lock.h>
+
 namespace sb
 {
 
 	class FileSource;
+
+	/// @remark Adding and looking up strings is thread-safe, as string ids may be created from any thread.
 	class StringIdRepository
 	{
 	public:
@@ -31,8 +35,12 @@ namespace sb
 	private:
 		const StringIdRepository& operator=(const StringIdRepository&) { return *this; }
 
+		/// Returns the OS path for a path relative to the file source
+		string BuildOSPath(const string& path) const;
+
 		map<uint32_t, string> _strings_32;
 		map<uint64_t, string> _strings_64;
+		mutable CriticalSection _lock;
 
 		FileSource* _file_source; // File source to save registry in
 		string _target_path;
@@ -20,4 +20,541 @@ namespace sb
 		return std::string(buf);
 	}
 
+	namespace
+	{
+		const char g_digit_pairs[] =
+			"00010203040506070809"
+			"10111213141516171819"
+			"20212223242526272829"
+			"30313233343536373839"
+			"40414243444546474849"
+			"50515253545556575859"
+			"60616263646566676869"
+			"70717273747576777879"
+			"80818283848586878889"
+			"90919293949596979899";
+
+		/// Writes the digits of value to the end of the buffer
+		/// @return Pointer to the first digit
+		INLINE char* WriteDigitsBackwards(char* end, uint64_t value)
+		{
+			while (value >= 100)
+			{
+				uint32_t pair = uint32_t(value % 100) * 2;
+				value /= 100;
+				*--end = g_digit_pairs[pair + 1];
+				*--end = g_digit_pairs[pair];
+			}
+			if (value >= 10)
+			{
+				uint32_t pair = uint32_t(value) * 2;
+				*--end = g_digit_pairs[pair + 1];
+				*--end = g_digit_pairs[pair];
+			}
+			else
+			{
+				*--end = char('0' + value);
+			}
+			return end;
+		}
+
+		//-------------------------------------------------------------------------------
+		// Grisu2, as described in "Printing Floating-Point Numbers Quickly and Accurately with
+		//	Integers" by Florian Loitsch. Always produces digits that read back as the same value,
+		//	and the shortest such digits for all but a small fraction of inputs.
+
+		/// Floating point number f * 2^e with a 64 bit significand
+		struct DiyFp
+		{
+			uint64_t f;
+			int e;
+
+			DiyFp(uint64_t f_, int e_) : f(f_), e(e_) {}
+		};
+
+		INLINE DiyFp Sub(const DiyFp& x, const DiyFp& y)
+		{
+			Assert(x.e == y.e && x.f >= y.f);
+			return DiyFp(x.f - y.f, x.e);
+		}
+
+		/// Multiplies two numbers, the result is rounded to the upper 64 bits of the product
+		INLINE DiyFp Mul(const DiyFp& x, const DiyFp& y)
+		{
+			uint64_t x_lo = x.f & 0xFFFFFFFFu;
+			uint64_t x_hi = x.f >> 32;
+			uint64_t y_lo = y.f & 0xFFFFFFFFu;
+			uint64_t y_hi = y.f >> 32;
+
+			uint64_t p0 = x_lo * y_lo;
+			uint64_t p1 = x_lo * y_hi;
+			uint64_t p2 = x_hi * y_lo;
+			uint64_t p3 = x_hi * y_hi;
+
+			uint64_t q = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+			q += uint64_t(1) << 31; // Round
+
+			return DiyFp(p3 + (p1 >> 32) + (p2 >> 32) + (q >> 32), x.e + y.e + 64);
+		}
+
+		INLINE DiyFp Normalize(DiyFp x)
+		{
+			while ((x.f >> 63) == 0)
+			{
+				x.f <<= 1;
+				x.e--;
+			}
+			return x;
+		}
+
+		/// Computes the value and the boundaries m- and m+ of the interval of numbers rounding to it,
+		///	m+ is normalized and m- has the same exponent as m+.
+		void ComputeBoundaries(double value, DiyFp& v, DiyFp& m_minus, DiyFp& m_plus)
+		{
+			const uint64_t hidden_bit = uint64_t(1) << 52;
+			const int exponent_bias = 1023 + 52;
+
+			uint64_t bits;
+			memcpy(&bits, &value, sizeof(bits));
+
+			uint64_t fraction = bits & (hidden_bit - 1);
+			int exponent = int(bits >> 52) & 0x7FF;
+
+			DiyFp w = (exponent == 0) ? DiyFp(fraction, 1 - exponent_bias) : DiyFp(fraction + hidden_bit, exponent - exponent_bias);
+
+			// The lower boundary is closer if the value is a power of two (except for the smallest normal)
+			bool lower_closer = (fraction == 0 && exponent > 1);
+
+			m_plus = Normalize(DiyFp(2 * w.f + 1, w.e - 1));
+			DiyFp lower = lower_closer ? DiyFp(4 * w.f - 1, w.e - 2) : DiyFp(2 * w.f - 1, w.e - 1);
+			m_minus = DiyFp(lower.f << (lower.e - m_plus.e), m_plus.e);
+			v = Normalize(w);
+		}
+
+		/// Normalized powers of ten, 10^k ~ f * 2^e
+		struct CachedPower
+		{
+			uint64_t f;
+			int e;
+			int k;
+		};
+
+		const CachedPower g_cached_powers[] =
+		{
+			{ 0xAB70FE17C79AC6CA, -1060, -300 },
+			{ 0xFF77B1FCBEBCDC4F, -1034, -292 },
+			{ 0xBE5691EF416BD60C, -1007, -284 },
+			{ 0x8DD01FAD907FFC3C,  -980, -276 },
+			{ 0xD3515C2831559A83,  -954, -268 },
+			{ 0x9D71AC8FADA6C9B5,  -927, -260 },
+			{ 0xEA9C227723EE8BCB,  -901, -252 },
+			{ 0xAECC49914078536D,  -874, -244 },
+			{ 0x823C12795DB6CE57,  -847, -236 },
+			{ 0xC21094364DFB5637,  -821, -228 },
+			{ 0x9096EA6F3848984F,  -794, -220 },
+			{ 0xD77485CB25823AC7,  -768, -212 },
+			{ 0xA086CFCD97BF97F4,  -741, -204 },
+			{ 0xEF340A98172AACE5,  -715, -196 },
+			{ 0xB23867FB2A35B28E,  -688, -188 },
+			{ 0x84C8D4DFD2C63F3B,  -661, -180 },
+			{ 0xC5DD44271AD3CDBA,  -635, -172 },
+			{ 0x936B9FCEBB25C996,  -608, -164 },
+			{ 0xDBAC6C247D62A584,  -582, -156 },
+			{ 0xA3AB66580D5FDAF6,  -555, -148 },
+			{ 0xF3E2F893DEC3F126,  -529, -140 },
+			{ 0xB5B5ADA8AAFF80B8,  -502, -132 },
+			{ 0x87625F056C7C4A8B,  -475, -124 },
+			{ 0xC9BCFF6034C13053,  -449, -116 },
+			{ 0x964E858C91BA2655,  -422, -108 },
+			{ 0xDFF9772470297EBD,  -396, -100 },
+			{ 0xA6DFBD9FB8E5B88F,  -369,  -92 },
+			{ 0xF8A95FCF88747D94,  -343,  -84 },
+			{ 0xB94470938FA89BCF,  -316,  -76 },
+			{ 0x8A08F0F8BF0F156B,  -289,  -68 },
+			{ 0xCDB02555653131B6,  -263,  -60 },
+			{ 0x993FE2C6D07B7FAC,  -236,  -52 },
+			{ 0xE45C10C42A2B3B06,  -210,  -44 },
+			{ 0xAA242499697392D3,  -183,  -36 },
+			{ 0xFD87B5F28300CA0E,  -157,  -28 },
+			{ 0xBCE5086492111AEB,  -130,  -20 },
+			{ 0x8CBCCC096F5088CC,  -103,  -12 },
+			{ 0xD1B71758E219652C,   -77,   -4 },
+			{ 0x9C40000000000000,   -50,    4 },
+			{ 0xE8D4A51000000000,   -24,   12 },
+			{ 0xAD78EBC5AC620000,     3,   20 },
+			{ 0x813F3978F8940984,    30,   28 },
+			{ 0xC097CE7BC90715B3,    56,   36 },
+			{ 0x8F7E32CE7BEA5C70,    83,   44 },
+			{ 0xD5D238A4ABE98068,   109,   52 },
+			{ 0x9F4F2726179A2245,   136,   60 },
+			{ 0xED63A231D4C4FB27,   162,   68 },
+			{ 0xB0DE65388CC8ADA8,   189,   76 },
+			{ 0x83C7088E1AAB65DB,   216,   84 },
+			{ 0xC45D1DF942711D9A,   242,   92 },
+			{ 0x924D692CA61BE758,   269,  100 },
+			{ 0xDA01EE641A708DEA,   295,  108 },
+			{ 0xA26DA3999AEF774A,   322,  116 },
+			{ 0xF209787BB47D6B85,   348,  124 },
+			{ 0xB454E4A179DD1877,   375,  132 },
+			{ 0x865B86925B9BC5C2,   402,  140 },
+			{ 0xC83553C5C8965D3D,   428,  148 },
+			{ 0x952AB45CFA97A0B3,   455,  156 },
+			{ 0xDE469FBD99A05FE3,   481,  164 },
+			{ 0xA59BC234DB398C25,   508,  172 },
+			{ 0xF6C69A72A3989F5C,   534,  180 },
+			{ 0xB7DCBF5354E9BECE,   561,  188 },
+			{ 0x88FCF317F22241E2,   588,  196 },
+			{ 0xCC20CE9BD35C78A5,   614,  204 },
+			{ 0x98165AF37B2153DF,   641,  212 },
+			{ 0xE2A0B5DC971F303A,   667,  220 },
+			{ 0xA8D9D1535CE3B396,   694,  228 },
+			{ 0xFB9B7CD9A4A7443C,   720,  236 },
+			{ 0xBB764C4CA7A44410,   747,  244 },
+			{ 0x8BAB8EEFB6409C1A,   774,  252 },
+			{ 0xD01FEF10A657842C,   800,  260 },
+			{ 0x9B10A4E5E9913129,   827,  268 },
+			{ 0xE7109BFBA19C0C9D,   853,  276 },
+			{ 0xAC2820D9623BF429,   880,  284 },
+			{ 0x80444B5E7AA7CF85,   907,  292 },
+			{ 0xBF21E44003ACDD2D,   933,  300 },
+			{ 0x8E679C2F5E44FF8F,   960,  308 },
+			{ 0xD433179D9C8CB841,   986,  316 },
+			{ 0x9E19DB92B4E31BA9,  1013,  324 },
+		};
+
+		/// Range for the binary exponent of the scaled value, chosen so that the integral part fits in 32 bits
+		const int GRISU_ALPHA = -60;
+		const int GRISU_GAMMA = -32;
+
+		/// Returns a power of ten c such that the exponent of c * 2^e is within [GRISU_ALPHA, GRISU_GAMMA]
+		const CachedPower& GetCachedPower(int e)
+		{
+			const int min_decimal_exponent = -300;
+			const int decimal_step = 8;
+
+			// k = ceil((alpha - e - 1) * log10(2))
+			int f = GRISU_ALPHA - e - 1;
+			int k = (f * 78913) / (1 << 18) + (f > 0 ? 1 : 0);
+
+			int index = (-min_decimal_exponent + k + (decimal_step - 1)) / decimal_step;
+			Assert(index >= 0 && index < int(sizeof(g_cached_powers) / sizeof(g_cached_powers[0])));
+
+			const CachedPower& cached = g_cached_powers[index];
+			Assert(GRISU_ALPHA <= cached.e + e + 64 && cached.e + e + 64 <= GRISU_GAMMA);
+			return cached;
+		}
+
+		/// Returns the number of digits in n and the largest power of ten <= n
+		INLINE int FindLargestPow10(uint32_t n, uint32_t& pow10)
+		{
+			static const uint32_t powers[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000 };
+			int digits = 10;
+			while (digits > 1 && n < powers[digits - 1])
+				--digits;
+			pow10 = powers[digits - 1];
+			return digits;
+		}
+
+		/// Moves the last digit towards the exact value while staying within the rounding interval
+		INLINE void Grisu2Round(char* buffer, int length, uint64_t dist, uint64_t delta, uint64_t rest, uint64_t ten_k)
+		{
+			while (rest < dist && delta - rest >= ten_k && (rest + ten_k < dist || dist - rest > rest + ten_k - dist))
+			{
+				buffer[length - 1]--;
+				rest += ten_k;
+			}
+		}
+
+		/// Generates the shortest digits for a value within (m_minus, m_plus), w being the exact value
+		void Grisu2DigitGen(char* buffer, int& length, int& decimal_exponent, const DiyFp& m_minus, const DiyFp& w, const DiyFp& m_plus)
+		{
+			uint64_t delta = Sub(m_plus, m_minus).f;
+			uint64_t dist = Sub(m_plus, w).f;
+
+			// Split m+ into an integral part p1 and a fractional part p2
+			const int shift = -m_plus.e;
+			const uint64_t one = uint64_t(1) << shift;
+
+			uint32_t p1 = uint32_t(m_plus.f >> shift);
+			uint64_t p2 = m_plus.f & (one - 1);
+
+			uint32_t pow10;
+			int n = FindLargestPow10(p1, pow10);
+			while (n > 0)
+			{
+				buffer[length++] = char('0' + p1 / pow10);
+				p1 %= pow10;
+				n--;
+
+				uint64_t rest = (uint64_t(p1) << shift) + p2;
+				if (rest <= delta)
+				{
+					decimal_exponent += n;
+					Grisu2Round(buffer, length, dist, delta, rest, uint64_t(pow10) << shift);
+					return;
+				}
+				pow10 /= 10;
+			}
+
+			int m = 0;
+			while (1)
+			{
+				p2 *= 10;
+				buffer[length++] = char('0' + (p2 >> shift));
+				p2 &= one - 1;
+				m++;
+
+				delta *= 10;
+				dist *= 10;
+				if (p2 <= delta)
+					break;
+			}
+			decimal_exponent -= m;
+			Grisu2Round(buffer, length, dist, delta, p2, one);
+		}
+
+		/// Generates digits for a positive, finite value
+		///	@return Number of digits, the value is digits * 10^decimal_exponent
+		int Grisu2(double value, char* buffer, int& decimal_exponent)
+		{
+			DiyFp v(0, 0), m_minus(0, 0), m_plus(0, 0);
+			ComputeBoundaries(value, v, m_minus, m_plus);
+
+			const CachedPower& cached = GetCachedPower(m_plus.e);
+			DiyFp c(cached.f, cached.e);
+
+			DiyFp w = Mul(v, c);
+			DiyFp w_minus = Mul(m_minus, c);
+			DiyFp w_plus = Mul(m_plus, c);
+
+			// Shrink the interval by one ulp on both ends to account for the rounding errors of Mul
+			DiyFp lower(w_minus.f + 1, w_minus.e);
+			DiyFp upper(w_plus.f - 1, w_plus.e);
+
+			int length = 0;
+			decimal_exponent = -cached.k;
+			Grisu2DigitGen(buffer, length, decimal_exponent, lower, w, upper);
+			return length;
+		}
+	}
+
+	//-------------------------------------------------------------------------------
+	uint32_t string_util::FormatInt(char* dst, int64_t value)
+	{
+		if (value < 0)
+		{
+			*dst = '-';
+			return FormatUInt(dst + 1, uint64_t(0) - uint64_t(value)) + 1;
+		}
+		return FormatUInt(dst, uint64_t(value));
+	}
+	uint32_t string_util::FormatUInt(char* dst, uint64_t value)
+	{
+		char buffer[20];
+		char* end = buffer + sizeof(buffer);
+		char* begin = WriteDigitsBackwards(end, value);
+
+		uint32_t length = uint32_t(end - begin);
+		memcpy(dst, begin, length);
+		return length;
+	}
+	uint32_t string_util::FormatDouble(char* dst, double value)
+	{
+		Assert(value == value && value - value == 0.0); // No support for NaN or infinity
+
+		uint64_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+
+		char* out = dst;
+		if (bits >> 63)
+		{
+			*out++ = '-';
+			value = -value;
+		}
+		if (value == 0.0)
+		{
+			memcpy(out, "0.0", 3);
+			return uint32_t(out - dst) + 3;
+		}
+
+		int decimal_exponent;
+		int length = Grisu2(value, out, decimal_exponent);
+
+		// Position of the decimal point relative to the first digit
+		int point = length + decimal_exponent;
+		if (length <= point && point <= 15)
+		{
+			// 1234000.0
+			memset(out + length, '0', point - length);
+			out[point] = '.';
+			out[point + 1] = '0';
+			out += point + 2;
+		}
+		else if (0 < point && point <= 15)
+		{
+			// 12.34
+			memmove(out + point + 1, out + point, length - point);
+			out[point] = '.';
+			out += length + 1;
+		}
+		else if (-4 < point && point <= 0)
+		{
+			// 0.001234
+			memmove(out + 2 - point, out, length);
+			out[0] = '0';
+			out[1] = '.';
+			memset(out + 2, '0', -point);
+			out += 2 - point + length;
+		}
+		else
+		{
+			// 1.234e+30
+			if (length > 1)
+			{
+				memmove(out + 2, out + 1, length - 1);
+				out[1] = '.';
+				out += length + 1;
+			}
+			else
+			{
+				out += 1;
+			}
+
+			int exponent = point - 1;
+			*out++ = 'e';
+			*out++ = (exponent < 0) ? '-' : '+';
+			char* end = out + 3;
+			char* begin = WriteDigitsBackwards(end, uint64_t(exponent < 0 ? -exponent : exponent));
+			memmove(out, begin, end - begin);
+			out += end - begin;
+		}
+		return uint32_t(out - dst);
+	}
+	//-------------------------------------------------------------------------------
+	namespace
+	{
+		/// Powers of ten exactly representable by a double
+		const double g_powers_of_ten[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+		};
+
+		bool IsDigit(char c)
+		{
+			return uint32_t(c - '0') < 10;
+		}
+
+		bool IsWhitespace(char c)
+		{
+			return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+		}
+
+		/// Fallback for anything ParseFloat doesn't handle itself (e.g. huge exponents, INF and NAN)
+		const char* ParseFloatSlow(const char* p, const char* end, float& value)
+		{
+			char buffer[64];
+			uint32_t len = 0;
+			while (p + len < end && len < sizeof(buffer) - 1 && !IsWhitespace(p[len]))
+			{
+				buffer[len] = p[len];
+				++len;
+			}
+			buffer[len] = '\0';
+
+			char* number_end;
+			value = strtof(buffer, &number_end);
+			if (number_end == buffer)
+				return NULL;
+			return p + (number_end - buffer);
+		}
+	}
+
+	const char* string_util::ParseFloat(const char* p, const char* end, float& value)
+	{
+		const char* start = p;
+
+		bool negative = false;
+		if (p < end && (*p == '-' || *p == '+'))
+		{
+			negative = (*p == '-');
+			++p;
+		}
+
+		uint64_t mantissa = 0;
+		int32_t exponent = 0;
+		uint32_t digits = 0; // Significant digits in mantissa
+		bool has_digits = false;
+
+		for (; p < end && IsDigit(*p); ++p)
+		{
+			has_digits = true;
+			if (digits < 19)
+			{
+				mantissa = mantissa * 10 + (*p - '0');
+				if (mantissa)
+					++digits;
+			}
+			else
+			{
+				++exponent;
+			}
+		}
+		if (p < end && *p == '.')
+		{
+			for (++p; p < end && IsDigit(*p); ++p)
+			{
+				has_digits = true;
+				if (digits < 19)
+				{
+					mantissa = mantissa * 10 + (*p - '0');
+					if (mantissa)
+						++digits;
+					--exponent;
+				}
+			}
+		}
+		if (!has_digits)
+			return ParseFloatSlow(start, end, value);
+
+		if (p < end && (*p == 'e' || *p == 'E'))
+		{
+			const char* e = p + 1;
+			bool negative_exponent = false;
+			if (e < end && (*e == '-' || *e == '+'))
+			{
+				negative_exponent = (*e == '-');
+				++e;
+			}
+			if (e == end || !IsDigit(*e))
+				return ParseFloatSlow(start, end, value);
+
+			int32_t e_value = 0;
+			for (; e < end && IsDigit(*e); ++e)
+			{
+				if (e_value < 10000)
+					e_value = e_value * 10 + (*e - '0');
+			}
+			exponent += negative_exponent ? -e_value : e_value;
+			p = e;
+		}
+
+		if ((mantissa >> 53) != 0 || exponent < -22 || exponent > 22)
+			return ParseFloatSlow(start, end, value);
+
+		double d = double(mantissa);
+		d = (exponent < 0) ? d / g_powers_of_ten[-exponent] : d * g_powers_of_ten[exponent];
+
+		// d is correctly rounded, so converting it to float only rounds the wrong way if d landed
+		//	exactly halfway between two floats. Leave those rare cases to strtof.
+		float f = float(d);
+		if (double(f) != d)
+		{
+			double other = double(nextafterf(f, (double(f) < d) ? FLT_MAX : -FLT_MAX));
+			if (d - double(f) == other - d)
+				return ParseFloatSlow(start, end, value);
+		}
+		value = negative ? -f : f;
+		return p;
+	}
+
 } // namespace sb
@@ -15,6 +15,28 @@ namespace sb
 
 		std::string Format(const char* fmt, ...);
 
+		/// @brief Writes the decimal representation of an integer, the result isn't null-terminated
+		/// @param dst Needs room for at least 20 characters, 21 for negative numbers
+		/// @return Number of characters written
+		uint32_t FormatInt(char* dst, int64_t value);
+		uint32_t FormatUInt(char* dst, uint64_t value);
+
+		/// @brief Writes the shortest representation of a double that reads back as the same value
+		///	The result always has a decimal point or an exponent (e.g. "1.0" or "1e+30") so that it's
+		///		never mistaken for an integer, and isn't null-terminated.
+		/// @param dst Needs room for at least 32 characters
+		/// @param value Finite value, NaN and infinity are not supported
+		/// @return Number of characters written
+		uint32_t FormatDouble(char* dst, double value);
+
+		/// @brief Parses a float without any of the locale handling of atof
+		///	The significant digits are accumulated in an integer and scaled by an exact power of ten,
+		///		anything unusual (e.g. huge exponents, INF and NAN) falls back to strtof. The result
+		///		is rounded the same way as strtof.
+		/// @param end End of the buffer, the string doesn't need to be null-terminated
+		/// @return Position after the number, NULL if there was no valid number at p
+		const char* ParseFloat(const char* p, const char* end, float& value);
+
 	} // namespace string_util
 
 } // namespace sb
@@ -15,8 +15,8 @@ namespace sb
 
 		IMPLEMENT_TO_STRING(int32_t, "%d");
 		IMPLEMENT_TO_STRING(uint32_t, "%u");
-		IMPLEMENT_TO_STRING(int64_t, "%lld");
-		IMPLEMENT_TO_STRING(uint64_t, "%llu");
+		IMPLEMENT_TO_STRING(int64_t, "%" PRId64);
+		IMPLEMENT_TO_STRING(uint64_t, "%" PRIu64);
 		IMPLEMENT_TO_STRING(const void*, "%p");
 		IMPLEMENT_TO_STRING(double, "%f");
 
@@ -100,6 +100,9 @@ namespace sb
 		/// @brief Returns true if the array is empty
 		bool Empty() const;
 
+		/// @brief Returns the allocator used for the buffer
+		Allocator& GetAllocator() const;
+
 
 		/// @brief Resizes the array
 		void Resize(size_t size);
@@ -185,6 +188,11 @@ namespace sb
 		T&			operator[](size_t index);
 		const T&	operator[](size_t index) const;
 
+	protected:
+		/// @brief Constructor for arrays with inline storage, see SmallVector
+		///	@param inline_buffer Uninitialized storage used as long as the array fits
+		Vector(Allocator& allocator, T* inline_buffer, size_t inline_capacity);
+
 	private:
 		/// @brief Increases the capacity of the array using geometric progression
 		///	@param capacity Specified minimum capacity if not 0
@@ -193,6 +201,13 @@ namespace sb
 		/// @brief Changes the capacity and resizes the buffer
 		void SetCapacity(size_t new_capacity);
 
+		/// @brief Opens up a gap of count uninitialized elements at index, growing the buffer if needed
+		///	The size is not changed, the caller is expected to construct the new elements.
+		void MakeRoom(size_t index, size_t count);
+
+		/// @brief Frees the buffer unless it's the inline buffer
+		void FreeBuffer();
+
 
 		/// @brief Frees any allocated memory
 		void Finalize();
@@ -206,6 +221,9 @@ namespace sb
 		size_t _size;
 		size_t _capacity;
 
+		T* _inline_buffer;
+		size_t _inline_capacity;
+
 	public:
 		INLINE Iterator begin() 
 		{ 
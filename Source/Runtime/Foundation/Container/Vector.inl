@@ -164,16 +164,26 @@ namespace sb
 	//-------------------------------------------------------------------------------
 	template<typename T>
 	Vector<T>::Vector(Allocator& allocator)
-		: _allocator(&allocator), _buffer(0), _size(0), _capacity(0)
+		: _allocator(&allocator), _buffer(0), _size(0), _capacity(0), _inline_buffer(0), _inline_capacity(0)
 	{
 	}
 	template<typename T>
 	Vector<T>::Vector(const Vector<T>& other)
-		: _allocator(other._allocator), _buffer(0), _size(0), _capacity(0)
+		: _allocator(other._allocator), _buffer(0), _size(0), _capacity(0), _inline_buffer(0), _inline_capacity(0)
 	{
 		CopyConstruct(other);
 	}
 	template<typename T>
+	Vector<T>::Vector(Allocator& allocator, T* inline_buffer, size_t inline_capacity)
+		: _allocator(&allocator),
+		_buffer(inline_buffer),
+		_size(0),
+		_capacity(inline_capacity),
+		_inline_buffer(inline_buffer),
+		_inline_capacity(inline_capacity)
+	{
+	}
+	template<typename T>
 	Vector<T>::~Vector()
 	{
 		Finalize();
@@ -216,6 +226,11 @@ namespace sb
 	{
 		return (_size == 0);
 	}
+	template<typename T>
+	Allocator& Vector<T>::GetAllocator() const
+	{
+		return *_allocator;
+	}
 	//-------------------------------------------------------------------------------
 	template<typename T>
 	void Vector<T>::Resize(size_t size)
@@ -273,12 +288,8 @@ namespace sb
 	void Vector<T>::Set(const T* values, size_t count)
 	{
 		Assert(values);
-		ArrayDestruct(_buffer, _size);
-		if (count != _capacity)
-		{
-			_buffer = (T*)_allocator->Reallocate(_buffer, count);
-			_capacity = count;
-		}
+		Clear();
+		Reserve(count);
 
 		ArrayCopy(_buffer, values, count);
 		_size = count;
@@ -288,9 +299,16 @@ namespace sb
 	{
 		size_t new_size = _size + count;
 		if (new_size > _capacity)
+		{
+			// The value may be an element of this array, so it has to be copied before the buffer is released
+			T copy(value);
 			Grow(new_size);
-
-		ArrayFill(_buffer + _size, value, count);
+			ArrayFill(_buffer + _size, copy, count);
+		}
+		else
+		{
+			ArrayFill(_buffer + _size, value, count);
+		}
 
 		_size = new_size;
 	}
@@ -299,7 +317,7 @@ namespace sb
 	{
 		Assert(values);
 		size_t new_size = _size + count;
-		if (new_size >= _capacity)
+		if (new_size > _capacity)
 			Grow(new_size);
 
 		ArrayCopy(_buffer + _size, values, count);
@@ -310,72 +328,24 @@ namespace sb
 	template<typename T>
 	void Vector<T>::Insert(size_t index, const T& value, size_t count)
 	{
-		size_t new_size = _size + count;
-		if (new_size >= _capacity)
-		{
-			// Buffer is too small so we need to allocate more memory
-			size_t new_capacity = Max(new_size, (_capacity * 2 + 8));
-			T* new_buffer = (T*)_allocator->Allocate(sizeof(T)*new_capacity, __alignof(T));
-			Assert(new_buffer);
-
-			// Copy elements from < index to the new buffer
-			ArrayCopy(new_buffer, _buffer, index);
-
-			// Set the new values at index <= i < index + count
-			ArrayFill((new_buffer + index), value, count);
-
-			// Copy the old elements from >= index to the end of the buffer
-			ArrayCopy((new_buffer + index + count), (_buffer + index), (_size - index));
-
-			_allocator->Free(_buffer);
-
-			_buffer = new_buffer;
-			_capacity = new_capacity;
-		}
-		else
-		{
-			// Copy the old elements from >= index to the end of the buffer
-			ArrayCopy((_buffer + index + count), (_buffer + index), (_size - index));
-			// Set our new values at index
-			ArrayFill(_buffer + index, value, count);
+		Assert(index <= _size);
 
-		}
-		_size = new_size;
+		// The value may be an element of this array
+		T copy(value);
+		MakeRoom(index, count);
+		ArrayFill(_buffer + index, copy, count);
+		_size += count;
 	}
 	template<typename T>
 	void Vector<T>::InsertArray(size_t index, const T* values, size_t count)
 	{
 		Assert(index <= _size);
 		Assert(values);
-		size_t new_size = _size + count;
-		if (new_size >= _capacity)
-		{
-			// Buffer is to small so we need to allocate more memory
-			size_t new_capacity = Max(new_size, (_capacity * 2 + 8));
-			T* new_buffer = (T*)_allocator->Allocate(sizeof(T)*new_capacity, __alignof(T));
-			Assert(new_buffer);
-
-			// Copy elements from < index to the new buffer
-			ArrayCopy(new_buffer, _buffer, index);
-			// Set the new values at index <= i < index + count
-			ArrayCopy((new_buffer + index), values, count);
-			// Copy the old elements from >= index to the end of the buffer
-			ArrayCopy((new_buffer + index + count), (_buffer + index), (_size - index));
-
-			_allocator->Free(_buffer);
+		Assert(values + count <= _buffer || values >= _buffer + _size); // Inserting from itself is not supported
 
-			_buffer = new_buffer;
-			_capacity = new_capacity;
-		}
-		else
-		{
-			// Copy the old elements from >= index to the end of the buffer
-			ArrayCopy((_buffer + index + count), (_buffer + index), (_size - index));
-			// Set our new values at index
-			ArrayCopy((_buffer + index), values, count);
-
-		}
-		_size = new_size;
+		MakeRoom(index, count);
+		ArrayCopy(_buffer + index, values, count);
+		_size += count;
 	}
 	template<typename T>
 	typename Vector<T>::Iterator Vector<T>::Erase(size_t index, size_t count)
@@ -478,29 +448,24 @@ namespace sb
 	template<typename T>
 	void Vector<T>::Finalize()
 	{
-		if (!_buffer)
-			return;
-
 		ArrayDestruct(_buffer, _size);
-		_allocator->Free(_buffer);
-		_buffer = 0;
+		FreeBuffer();
+		_buffer = _inline_buffer;
 		_size = 0;
-		_capacity = 0;
+		_capacity = _inline_capacity;
 	}
 	template<typename T>
 	void Vector<T>::CopyConstruct(const Vector<T>& other)
 	{
-		Assert(_buffer == nullptr);
-
-		_size = other._size;
-		_capacity = other._size;
+		Assert(_size == 0);
 
-		if (_size)
+		if (other._size)
 		{
-			_buffer = (T*)_allocator->Allocate(sizeof(T)*_capacity, __alignof(T));
+			Reserve(other._size);
 
 			Assert(other._buffer != nullptr);
-			ArrayCopy(_buffer, other._buffer, _size);
+			ArrayCopy(_buffer, other._buffer, other._size);
+			_size = other._size;
 		}
 	}
 	template<typename T>
@@ -524,17 +489,72 @@ namespace sb
 		}
 
 		T* new_data = 0;
-		if (new_capacity > 0)
+		if (_inline_buffer && new_capacity <= _inline_capacity)
+		{
+			// Fits in the inline buffer, which never shrinks
+			if (_buffer == _inline_buffer)
+				return;
+
+			new_data = _inline_buffer;
+			new_capacity = _inline_capacity;
+		}
+		else if (new_capacity > 0)
 		{
 			new_data = (T*)_allocator->Allocate(sizeof(T)*new_capacity, __alignof(T));
-			ArrayCopy(new_data, _buffer, _size);
 		}
+
+		if (new_data && _size)
+			ArrayCopy(new_data, _buffer, _size);
 		ArrayDestruct(_buffer, _size);
-		_allocator->Free(_buffer);
+		FreeBuffer();
 		_buffer = new_data;
 
 		_capacity = new_capacity;
 	}
+	template<typename T>
+	void Vector<T>::MakeRoom(size_t index, size_t count)
+	{
+		size_t new_size = _size + count;
+		if (new_size > _capacity)
+		{
+			// Buffer is too small so we need to allocate more memory
+			size_t new_capacity = Max(new_size, (_capacity * 2 + 8));
+			T* new_buffer = (T*)_allocator->Allocate(sizeof(T)*new_capacity, __alignof(T));
+			Assert(new_buffer);
+
+			// Copy the elements before and after the gap
+			ArrayCopy(new_buffer, _buffer, index);
+			ArrayCopy((new_buffer + index + count), (_buffer + index), (_size - index));
+
+			ArrayDestruct(_buffer, _size);
+			FreeBuffer();
+
+			_buffer = new_buffer;
+			_capacity = new_capacity;
+			return;
+		}
+
+		// Elements moved beyond the old end are constructed, the rest are assigned
+		//	and whatever remains in the gap is destructed.
+		size_t tail = _size - index;
+		if (count < tail)
+		{
+			ArrayCopy(_buffer + _size, _buffer + _size - count, count);
+			ArrayMove(_buffer + index + count, _buffer + index, tail - count);
+			ArrayDestruct(_buffer + index, count);
+		}
+		else
+		{
+			ArrayCopy(_buffer + index + count, _buffer + index, tail);
+			ArrayDestruct(_buffer + index, tail);
+		}
+	}
+	template<typename T>
+	void Vector<T>::FreeBuffer()
+	{
+		if (_buffer && _buffer != _inline_buffer)
+			_allocator->Free(_buffer);
+	}
 	//-------------------------------------------------------------------------------
 
 } // namespace sb
@@ -30,7 +30,7 @@ namespace sb
 			exit(0);
 		};
 
-#elif SANDBOX_PLATFORM_MACOSX
+#elif defined(SANDBOX_PLATFORM_POSIX)
 		return RET_DEBUGGER; // TODO:
 #endif
 
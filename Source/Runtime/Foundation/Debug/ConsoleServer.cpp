@@ -6,6 +6,7 @@
 #include "Json/Json.h"
 #include "Filesystem/FilePath.h"
 #include "Container/ConfigValue.h"
+#include "IO/MemoryStream.h"
 
 namespace sb
 {
@@ -155,17 +156,19 @@ namespace sb
 	//-------------------------------------------------------------------------------
 	void ConsoleServer::Send(const ConfigValue& value)
 	{
-		json::Writer w;
-		stringstream ss;
-		w.Write(value, ss, false);
+		vector<uint8_t> msg;
+		{
+			DynamicMemoryStream stream(&msg);
+			json::Writer w(stream, false);
+			w.Write(value);
+		}
 
-		string msg = ss.str();
 		for (auto& client : _clients)
 		{
 			if (client == NULL) // Skip empty slots
 				continue;
 
-			client->socket.Send(msg.c_str(), (int)msg.size());
+			client->socket.Send((const char*)msg.data(), (int)msg.size());
 		}
 	}
 
@@ -218,7 +221,7 @@ namespace sb
 		char filename[260];
 #ifdef SANDBOX_PLATFORM_WIN
 		GetModuleFileName(NULL, filename, 260);
-#elif SANDBOX_PLATFORM_MACOSX
+#elif defined(SANDBOX_PLATFORM_POSIX)
 		printf("proc #%d", getpid());
 #endif
 		FilePath path(filename);
@@ -240,11 +243,14 @@ namespace sb
 			cmd["description"].SetString(it->second.description.c_str());
 		}
 
-		json::Writer w;
-		stringstream ss;
-		w.Write(msg, ss, false);
+		vector<uint8_t> data;
+		{
+			DynamicMemoryStream stream(&data);
+			json::Writer w(stream, false);
+			w.Write(msg);
+		}
 
-		client->socket.Send(ss.str().c_str(), (int)ss.str().size());
+		client->socket.Send((const char*)data.data(), (int)data.size());
 	}
 
 	//-------------------------------------------------------------------------------
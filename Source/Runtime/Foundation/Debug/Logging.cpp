@@ -11,7 +11,7 @@
 #ifdef SANDBOX_BUILD_DEBUG
 #ifdef SANDBOX_PLATFORM_WIN
 #define OUTPUTDEBUGSTRING(msg) OutputDebugString(msg)
-#elif SANDBOX_PLATFORM_MACOSX
+#elif defined(SANDBOX_PLATFORM_POSIX)
 #define OUTPUTDEBUGSTRING(msg) printf("%s", msg)
 #endif
 #else
@@ -0,0 +1,35 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "AsyncIO.h"
+#include "ThreadPoolAsyncIO.h"
+
+#ifdef SANDBOX_PLATFORM_LINUX
+#include "Linux/UringAsyncIO.h"
+#endif
+
+namespace sb
+{
+
+	//-------------------------------------------------------------------------------
+	AsyncIO* async_io::Create(uint32_t queue_depth)
+	{
+#ifdef SANDBOX_PLATFORM_LINUX
+		UringAsyncIO* uring = new UringAsyncIO(queue_depth);
+		if (uring->IsValid())
+		{
+			return uring;
+		}
+		// io_uring not supported (old kernel or blocked by seccomp), fall back to threads
+		delete uring;
+#endif
+		return new ThreadPoolAsyncIO(queue_depth);
+	}
+	void async_io::Destroy(AsyncIO* async_io)
+	{
+		delete async_io;
+	}
+	//-------------------------------------------------------------------------------
+
+} // namespace sb
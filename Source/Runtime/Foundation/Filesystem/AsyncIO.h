@@ -0,0 +1,84 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __FOUNDATION_ASYNCIO_H__
+#define __FOUNDATION_ASYNCIO_H__
+
+#include "File.h"
+
+namespace sb
+{
+
+	/// @brief Interface for asynchronous file reads
+	///
+	///	Reads are submitted with a file, an offset and a destination buffer and complete in any
+	///		order. Keeping many reads in flight lets the storage device work on several requests
+	///		at once, which is required to get anywhere near the bandwidth of an SSD.
+	///
+	///	An AsyncIO object is not thread-safe, it's intended to be owned by a single thread
+	///		(e.g. the resource loader thread) that both submits and reaps reads.
+	class AsyncIO : NonCopyable
+	{
+	public:
+		enum { DEFAULT_QUEUE_DEPTH = 32 };
+
+		struct ReadRequest
+		{
+			const File* file;
+			int64_t offset;
+
+			void* dst;
+			uint32_t size;
+
+			/// User data returned with the completion
+			void* user_data;
+		};
+
+		struct Completion
+		{
+			void* user_data;
+
+			/// Number of bytes read, negative on error
+			int64_t result;
+		};
+
+		virtual ~AsyncIO() {}
+
+		/// @brief Queues a read
+		///	@return False if the queue is full, in that case reap some completions and retry
+		virtual bool Submit(const ReadRequest& request) = 0;
+
+		/// @brief Retrieves completed reads without blocking
+		///	@return Number of completions written to completions
+		virtual uint32_t Poll(Completion* completions, uint32_t max_count) = 0;
+
+		/// @brief Blocks until at least one read has completed
+		///	@remark Returns zero directly if there are no reads in flight
+		///	@return Number of completions written to completions
+		virtual uint32_t Wait(Completion* completions, uint32_t max_count) = 0;
+
+		/// @return Number of submitted reads not yet reaped
+		virtual uint32_t Pending() const = 0;
+
+		/// @return Maximum number of reads in flight
+		virtual uint32_t QueueDepth() const = 0;
+
+		/// @return Name of the implementation, for logging
+		virtual const char* Name() const = 0;
+	};
+
+	namespace async_io
+	{
+		/// @brief Creates the best asynchronous IO implementation available on this platform
+		///
+		///	This will be io_uring on Linux (when supported by the kernel) and a thread pool 
+		///		performing positioned reads everywhere else.
+		AsyncIO* Create(uint32_t queue_depth = AsyncIO::DEFAULT_QUEUE_DEPTH);
+
+		void Destroy(AsyncIO* async_io);
+
+	}; // namespace async_io
+
+} // namespace sb
+
+
+#endif // __FOUNDATION_ASYNCIO_H__
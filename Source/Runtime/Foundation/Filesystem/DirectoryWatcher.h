@@ -8,7 +8,7 @@
 namespace sb
 {
 
-#ifdef SANDBOX_PLATFORM_WIN
+#if defined(SANDBOX_PLATFORM_WIN) || defined(SANDBOX_PLATFORM_LINUX)
 
 	/// Struct representing a change in a directory
 	struct DirectoryChange
@@ -33,7 +33,15 @@ namespace sb
 		/// @return True if any change was popped from queue, else false
 		bool PopChange(DirectoryChange& change);
 
+		/// @brief Blocks until there are changes in the queue, the time limit expires or Wake is called.
+		///	@return True if there are any changes to pop
+		bool WaitForChange(uint32_t milliseconds);
+
+		/// @brief Wakes any thread currently blocked in WaitForChange
+		void Wake();
+
 	private:
+#ifdef SANDBOX_PLATFORM_WIN
 		enum { BUFFER_SIZE = 1024 };
 
 		struct DirectoryInfo
@@ -49,9 +57,33 @@ namespace sb
 	private:
 		DirectoryInfo _dir_info;
 		void* _comp_port_handle; // Handle for completion port
+#else
+		enum { BUFFER_SIZE = 4096 };
+
+		int _inotify_fd;
+		int _wake_pipe[2]; // Used to wake the watcher thread when shutting down
+		bool _watch_subtree;
+
+		string _root; // Watched directory, with a trailing separator
+		map<int, string> _watches; // Watch descriptor => directory relative to the root, with a trailing separator
+
+		char _buffer[BUFFER_SIZE];
+
+		/// @brief Adds a watch for the specified directory, and all directories below it if we're watching the subtree.
+		/// @param dir Directory relative to the root, empty for the root itself
+		/// @param report_files Pushes a FILE_ADDED change for any file already in the directory,
+		///						used for directories created or moved in while watching.
+		void AddWatch(const string& dir, bool report_files);
+
+		/// @brief Removes the watches for the specified directory and all directories below it.
+		///	Used when a directory is moved out of the tree, as its watches would otherwise follow it.
+		/// @param dir Directory relative to the root, with a trailing separator
+		void RemoveWatches(const string& dir);
+#endif
 
 		CriticalSection _queue_lock;
 		deque<DirectoryChange> _changes;
+		Event _change_event;
 
 		SimpleThread _thread;
 
@@ -62,7 +94,7 @@ namespace sb
 		void Push(DirectoryChange::Action action, const char* filename);
 	};
 
-#endif // SANDBOX_PLATFORM_WIN
+#endif // SANDBOX_PLATFORM_WIN || SANDBOX_PLATFORM_LINUX
 
 } // namespace sb
 
@@ -0,0 +1,44 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "File.h"
+
+namespace sb
+{
+
+	namespace
+	{
+		file_stats::Counters g_file_counters = { 0, 0, 0, 0 };
+	};
+
+	//-------------------------------------------------------------------------------
+	const file_stats::Counters& file_stats::Get()
+	{
+		return g_file_counters;
+	}
+	void file_stats::Reset()
+	{
+		thread::InterlockedExchange(&g_file_counters.read_calls, 0);
+		thread::InterlockedExchange(&g_file_counters.write_calls, 0);
+		thread::InterlockedExchange(&g_file_counters.seek_calls, 0);
+		thread::InterlockedExchangeAdd64(&g_file_counters.bytes_read, -g_file_counters.bytes_read);
+	}
+#ifdef SANDBOX_FILE_TRACKING
+	void file_stats::RecordRead(uint32_t bytes)
+	{
+		thread::InterlockedIncrement(&g_file_counters.read_calls);
+		thread::InterlockedExchangeAdd64(&g_file_counters.bytes_read, bytes);
+	}
+	void file_stats::RecordWrite()
+	{
+		thread::InterlockedIncrement(&g_file_counters.write_calls);
+	}
+	void file_stats::RecordSeek()
+	{
+		thread::InterlockedIncrement(&g_file_counters.seek_calls);
+	}
+#endif
+	//-------------------------------------------------------------------------------
+
+} // namespace sb
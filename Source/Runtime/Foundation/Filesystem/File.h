@@ -9,6 +9,12 @@ namespace sb
 	class File
 	{
 	public:
+#ifdef SANDBOX_PLATFORM_WIN
+		typedef HANDLE Handle;
+#elif defined(SANDBOX_PLATFORM_POSIX)
+		typedef int Handle;
+#endif
+
 		enum SeekOrigin
 		{
 			SEEK_ORIGIN_CURRENT,
@@ -23,6 +29,13 @@ namespace sb
 			APPEND = (1 << 2)
 		};
 
+		/// @brief Destination for a vectored read
+		struct ReadBuffer
+		{
+			void* dst;
+			uint32_t size;
+		};
+
 		File();
 		~File();
 
@@ -37,6 +50,21 @@ namespace sb
 		///	@param size Number of bytes to read
 		uint32_t Read(void* dst, uint32_t size);
 
+		/// @brief Reads data from the file into several buffers, in order, with a single call
+		///	@param buffers Destination buffers
+		///	@param count Number of buffers
+		///	@return Total number of bytes read
+		uint32_t ReadMany(const ReadBuffer* buffers, uint32_t count);
+
+		/// @brief Reads data from the specified offset in the file
+		///	@remark This does not use or move the current file position, which means it's safe
+		///			to call from several threads at once on the same file.
+		///	@return Number of bytes read
+		uint32_t ReadAt(void* dst, uint32_t size, int64_t offset) const;
+
+		/// @brief Hints the OS that the specified range will be read soon
+		void Prefetch(int64_t offset, uint32_t size);
+
 		/// @brief Writes data to the file
 		///	@param src Pointer to the source buffer
 		///	@param size Number of bytes to write
@@ -53,17 +81,44 @@ namespace sb
 		/// @brief Returns the size of the file
 		int64_t Length() const;
 
-	private:
-#ifdef SANDBOX_PLATFORM_WIN
-		typedef HANDLE Handle;
-#elif SANDBOX_PLATFORM_MACOSX
-		typedef int Handle;
-#endif
+		/// @brief Returns the native handle for the file
+		Handle GetHandle() const;
 
+	private:
 		Handle _handle;
 
 	};
 
+	/// @brief Counters for file system calls, used for profiling IO patterns
+	///	Calls are only recorded in builds with SANDBOX_FILE_TRACKING, otherwise the counters stay at zero.
+	namespace file_stats
+	{
+		struct Counters
+		{
+			volatile long read_calls;
+			volatile long write_calls;
+			volatile long seek_calls;
+			int64_t volatile bytes_read;
+		};
+
+		/// @brief Returns the counters for all file operations since the last reset
+		const Counters& Get();
+
+		/// @brief Resets all counters to zero
+		void Reset();
+
+#ifdef SANDBOX_FILE_TRACKING
+		void RecordRead(uint32_t bytes);
+		void RecordWrite();
+		void RecordSeek();
+#else
+		INLINE void RecordRead(uint32_t) {}
+		INLINE void RecordWrite() {}
+		INLINE void RecordSeek() {}
+#endif
+
+	}; // namespace file_stats
+
 } // namespace sb
 
 
@@ -7,6 +7,7 @@
 #include "File.h"
 #include "FileUtil.h"
 #include "FilePath.h"
+#include "MappedFile.h"
 
 #include <sys/stat.h>
 
@@ -85,7 +86,7 @@ namespace sb
 	{
 	}
 
-	FileStreamPtr FileSource::OpenFile(const char* file_path, const File::FileMode mode)
+	FileStreamPtr FileSource::OpenFile(const char* file_path, const File::FileMode mode, uint32_t buffer_size)
 	{
 		string full_path;
 		const char* _mode;
@@ -103,7 +104,7 @@ namespace sb
 			break;
 		}
 		// Is the sources file path absolute?
-		if (_path.find(':') != string::npos)
+		if (file_util::IsAbsolutePath(_path))
 		{
 			full_path = _path + PATH_SEPARATOR + file_path;
 		}
@@ -119,17 +120,37 @@ namespace sb
 		File file;
 		if (file.Open(full_path.c_str(), mode))
 		{
-			return FileStreamPtr(new FileStream(file));
+			return FileStreamPtr(new FileStream(file, buffer_size));
 		}
 
 		return FileStreamPtr();
 	}
 
+	bool FileSource::MapFile(const char* file_path, MappedFile& mapped_file)
+	{
+		string full_path;
+		// Is the sources file path absolute?
+		if (file_util::IsAbsolutePath(_path))
+		{
+			full_path = _path + PATH_SEPARATOR + file_path;
+		}
+		else
+		{
+			file_util::BuildOSPath(full_path, _file_system->GetBasePath(), _path);
+			full_path += PATH_SEPARATOR;
+			full_path += file_path;
+		}
+
+		file_util::FixSlashes(full_path);
+
+		return mapped_file.Open(full_path.c_str());
+	}
+
 	void FileSource::MakeDirectory(const char* path)
 	{
 		string full_path;
 		// Is the sources file path absolute?
-		if (_path.find(':') != string::npos)
+		if (file_util::IsAbsolutePath(_path))
 		{
 			full_path = _path.c_str();
 			full_path += PATH_SEPARATOR;
@@ -159,15 +180,14 @@ namespace sb
 				CreateDirectory(current_path.c_str(), NULL);
 			}
 		}
-#elif SANDBOX_PLATFORM_MACOSX
+#elif defined(SANDBOX_PLATFORM_POSIX)
 		struct stat stat_info;
-		while((end = full_path.Find(PATH_SEPARATOR, end+1)) != String::npos)
+		while ((end = full_path.find(PATH_SEPARATOR, end + 1)) != string::npos)
 		{
-			stringcurrent_path = full_path.Substr(0, end);
-			if((current_path.RFind(':', 0) != (current_path.Size()-1)) // Avoid trying to create a device (E.g. "C:")
-				|| (stat(current_path.Ptr(), &stat_info) != 0))
+			string current_path = full_path.substr(0, end);
+			if (stat(current_path.c_str(), &stat_info) != 0)
 			{
-				mkdir(current_path.Ptr(), S_IRWXU);
+				mkdir(current_path.c_str(), S_IRWXU);
 			}
 		}
 #endif
@@ -179,7 +199,7 @@ namespace sb
 		string full_path;
 
 		// Is the sources file path absolute?
-		if (_path.find(':') != string::npos)
+		if (file_util::IsAbsolutePath(_path))
 		{
 			full_path = _path + PATH_SEPARATOR + path;
 		}
@@ -197,7 +217,7 @@ namespace sb
 		string full_path;
 
 		// Is the sources file path absolute?
-		if (_path.find(':') != string::npos)
+		if (file_util::IsAbsolutePath(_path))
 		{
 			full_path = _path + PATH_SEPARATOR + path;
 		}
@@ -217,7 +237,7 @@ namespace sb
 		string full_path;
 
 		// Is the sources file path absolute?
-		if (_path.find(':') != string::npos)
+		if (file_util::IsAbsolutePath(_path))
 		{
 			full_path = _path + PATH_SEPARATOR + file_path;
 		}
@@ -240,9 +260,9 @@ namespace sb
 			return true;
 		}
 
-#elif SANDBOX_PLATFORM_MACOSX
+#elif defined(SANDBOX_PLATFORM_POSIX)
 		struct stat stat_info;
-		if(stat(full_path.Ptr(), &stat_info) == 0)
+		if (stat(full_path.c_str(), &stat_info) == 0)
 		{
 			uint64_t t = stat_info.st_mtime;
 			file_time.high = (uint32_t)(t >> 32);
@@ -262,7 +282,7 @@ namespace sb
 	string FileSource::GetFullPath() const
 	{
 		// Is the sources file path absolute?
-		if (_path.find(':') != string::npos)
+		if (file_util::IsAbsolutePath(_path))
 		{
 			return _path;
 		}
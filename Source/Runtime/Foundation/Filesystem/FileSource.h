@@ -26,6 +26,7 @@ namespace sb
 	};
 
 	class FileSystem;
+	class MappedFile;
 
 	/// @brief File source for reading files from directories
 	class FileSource
@@ -41,8 +42,13 @@ namespace sb
 		~FileSource();
 
 		/// @brief Tries to open a file with the specified flags
+		///	@param buffer_size Size of the read buffer for the stream, 0 for an unbuffered stream
 		///	@sa File::FileMode
-		FileStreamPtr OpenFile(const char* file_path, const File::FileMode mode);
+		FileStreamPtr OpenFile(const char* file_path, const File::FileMode mode, uint32_t buffer_size = 0);
+
+		/// @brief Maps the specified file into memory for reading
+		///	@return False if the file couldn't be mapped
+		bool MapFile(const char* file_path, MappedFile& mapped_file);
 
 
 		/// Creates a new directory with the specified name
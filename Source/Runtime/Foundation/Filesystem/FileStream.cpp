@@ -7,39 +7,213 @@
 namespace sb
 {
 
-	FileStream::FileStream(const File& file) : _file(file)
+	//-------------------------------------------------------------------------------
+	FileStream::FileStream(const File& file, uint32_t buffer_size)
+		: _file(file),
+		_buffer(nullptr),
+		_buffer_size(buffer_size),
+		_buffer_offset(0),
+		_buffer_length(0),
+		_buffer_pos(0),
+		_prefetch_end(0)
 	{
 		Assert(_file.IsOpen());
+		if (_buffer_size)
+		{
+			_buffer = (uint8_t*)memory::Malloc(_buffer_size);
+			_buffer_offset = _file.Tell();
+		}
 	}
 	FileStream::~FileStream()
 	{
+		if (_buffer)
+		{
+			memory::Free(_buffer);
+			_buffer = nullptr;
+		}
 		_file.Close();
 	}
-
+	//-------------------------------------------------------------------------------
 	size_t FileStream::Read(void* dst, size_t size)
 	{
-		return _file.Read(dst, (uint32_t)size);
+		File::ReadBuffer buffer;
+		buffer.dst = dst;
+		buffer.size = (uint32_t)size;
+		return ReadMany(&buffer, 1);
 	}
+	size_t FileStream::ReadMany(const File::ReadBuffer* buffers, uint32_t count)
+	{
+		if (!_buffer)
+			return _file.ReadMany(buffers, count);
+
+		size_t total = 0;
+
+		// Serve as many of the reads as possible directly from the buffer
+		uint32_t i = 0;
+		for (; i < count; ++i)
+		{
+			uint32_t size = buffers[i].size;
+			if (size > _buffer_length - _buffer_pos)
+				break;
+
+			memory::Memcpy(buffers[i].dst, _buffer + _buffer_pos, size);
+			_buffer_pos += size;
+			total += size;
+		}
+		if (i == count)
+			return total;
+
+		// Drain what's left of the buffer into the first read that didn't fit
+		uint32_t head = _buffer_length - _buffer_pos;
+		memory::Memcpy(buffers[i].dst, _buffer + _buffer_pos, head);
+		total += head;
+
+		int64_t file_pos = _buffer_offset + _buffer_length;
+		_buffer_offset = file_pos;
+		_buffer_length = 0;
+		_buffer_pos = 0;
+
+		// The remaining reads and a refill of the buffer are issued as vectored reads, this means
+		//	that a large read followed by small reads only results in a single system call.
+		enum { MAX_BATCH = 16 };
+		while (i < count)
+		{
+			File::ReadBuffer batch[MAX_BATCH];
+			uint32_t n = 0;
+			uint32_t requested = 0;
+
+			for (; i < count && n < MAX_BATCH - 1; ++i, ++n)
+			{
+				batch[n].dst = memory::PointerAdd(buffers[i].dst, head);
+				batch[n].size = buffers[i].size - head;
+				requested += batch[n].size;
+				head = 0;
+			}
+
+			bool refill = (i == count);
+			if (refill)
+			{
+				batch[n].dst = _buffer;
+				batch[n].size = _buffer_size;
+				++n;
+			}
 
+			uint32_t bytes_read = _file.ReadMany(batch, n);
+			file_pos += bytes_read;
+
+			if (bytes_read <= requested)
+			{
+				// Nothing went into the buffer
+				total += bytes_read;
+				_buffer_offset = file_pos;
+
+				if (bytes_read < requested)
+					return total; // End of file
+			}
+			else
+			{
+				total += requested;
+				_buffer_length = bytes_read - requested;
+				_buffer_offset = file_pos - _buffer_length;
+			}
+		}
+
+		ReadAhead();
+
+		return total;
+	}
 	size_t FileStream::Write(const void* src, size_t size)
 	{
-		return _file.Write(src, (uint32_t)size);
-	}
+		if (!_buffer)
+			return _file.Write(src, (uint32_t)size);
+
+		DiscardBuffer();
 
+		size_t written = _file.Write(src, (uint32_t)size);
+		_buffer_offset += written;
+		return written;
+	}
 	int64_t FileStream::Seek(int64_t offset)
 	{
-		return _file.Seek(offset, File::SEEK_ORIGIN_BEGIN);
-	}
+		if (!_buffer)
+			return _file.Seek(offset, File::SEEK_ORIGIN_BEGIN);
 
+		// Seeking within the buffer doesn't need to touch the file
+		if (offset >= _buffer_offset && offset <= _buffer_offset + _buffer_length)
+		{
+			_buffer_pos = (uint32_t)(offset - _buffer_offset);
+			return offset;
+		}
+
+		int64_t result = _file.Seek(offset, File::SEEK_ORIGIN_BEGIN);
+		if (result >= 0)
+		{
+			_buffer_offset = result;
+			_buffer_length = 0;
+			_buffer_pos = 0;
+			_prefetch_end = 0;
+		}
+		return result;
+	}
 	int64_t FileStream::Tell() const
 	{
-		return _file.Tell();
-	}
+		if (!_buffer)
+			return _file.Tell();
 
+		return _buffer_offset + _buffer_pos;
+	}
 	int64_t FileStream::Length() const
 	{
 		return _file.Length();
 	}
+	bool FileStream::IsBuffered() const
+	{
+		return _buffer != nullptr;
+	}
+	void FileStream::AttachFileData(void* data, uint32_t length)
+	{
+		Assert(!_buffer);
+		Assert(data);
 
-} // namespace sb
+		_buffer = (uint8_t*)data;
+		_buffer_size = length;
+		_buffer_offset = 0;
+		_buffer_length = length;
+		_buffer_pos = 0;
+
+		// Keep the file position at the end of the buffer, reads past it continue from the file
+		_file.Seek(length, File::SEEK_ORIGIN_BEGIN);
+	}
+	const File& FileStream::GetFile() const
+	{
+		return _file;
+	}
+	//-------------------------------------------------------------------------------
+	void FileStream::DiscardBuffer()
+	{
+		if (_buffer_pos != _buffer_length)
+		{
+			// The file position is at the end of the buffer, move it back to where the stream actually is
+			_file.Seek(_buffer_offset + _buffer_pos, File::SEEK_ORIGIN_BEGIN);
+		}
+		_buffer_offset += _buffer_pos;
+		_buffer_length = 0;
+		_buffer_pos = 0;
+	}
+	void FileStream::ReadAhead()
+	{
+		// A partially filled buffer means we reached the end of the file
+		if (_buffer_length != _buffer_size)
+			return;
+
+		int64_t next = _buffer_offset + _buffer_length;
+		if (next >= _prefetch_end)
+		{
+			// Keep two buffers worth of data in flight
+			_file.Prefetch(next, _buffer_size * 2);
+			_prefetch_end = next + _buffer_size * 2;
+		}
+	}
+	//-------------------------------------------------------------------------------
 
+} // namespace sb
@@ -10,10 +10,19 @@
 namespace sb
 {
 
+	/// @brief Stream for reading and writing files
+	///
+	///	The stream can optionally be buffered, in which case reads are served from an internal
+	///		read buffer. Small reads (e.g. headers and single values) then hit memory instead of
+	///		resulting in a system call each. While the file is read sequentially the stream also
+	///		hints the OS to read ahead the next window of the file.
 	class FileStream : public Stream
 	{
 	public:
-		FileStream(const File& file);
+		enum { DEFAULT_BUFFER_SIZE = 64 * 1024 };
+
+		/// @param buffer_size Size of the read buffer in bytes, 0 means unbuffered
+		FileStream(const File& file, uint32_t buffer_size = 0);
 		~FileStream();
 
 		/// @brief Reads data from the stream
@@ -21,6 +30,13 @@ namespace sb
 		///	@param size Number of bytes to read
 		size_t Read(void* dst, size_t size);
 
+		/// @brief Reads data from the stream into several buffers, in order
+		///
+		///	This is equivalent to calling Read for each of the buffers but results in as few
+		///		system calls as possible.
+		///	@return Total number of bytes read
+		size_t ReadMany(const File::ReadBuffer* buffers, uint32_t count);
+
 		/// @brief Writes data to the stream
 		///	@param src Pointer to the source buffer
 		///	@param size Number of bytes to write
@@ -36,9 +52,38 @@ namespace sb
 		/// @brief Returns the size of the stream
 		int64_t Length() const;
 
+		/// @return True if the stream has a read buffer
+		bool IsBuffered() const;
+
+		/// @brief Hands the stream a buffer holding the start of the file
+		///
+		///	Used when the file was read through other means (e.g. AsyncIO), reads within the buffer
+		///		are then served from memory. The stream takes ownership of the data.
+		///	@param data Buffer allocated with memory::Malloc
+		///	@param length Number of bytes from the start of the file held by the buffer
+		void AttachFileData(void* data, uint32_t length);
+
+		/// @brief Returns the underlying file
+		const File& GetFile() const;
+
 	private:
 		File _file;
 
+		uint8_t* _buffer;
+		uint32_t _buffer_size;
+
+		int64_t _buffer_offset; ///< File offset of the first byte in the buffer
+		uint32_t _buffer_length; ///< Number of valid bytes in the buffer
+		uint32_t _buffer_pos; ///< Current read position within the buffer
+
+		int64_t _prefetch_end; ///< End of the range last handed to File::Prefetch
+
+		/// @brief Discards the buffer contents and moves the file position to the logical stream position
+		void DiscardBuffer();
+
+		/// @brief Hints the OS to read ahead if the stream is read sequentially
+		void ReadAhead();
+
 	};
 
 	typedef SharedPtr<FileStream> FileStreamPtr;
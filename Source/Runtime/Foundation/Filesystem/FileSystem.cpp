@@ -24,13 +24,13 @@ namespace sb
 		}
 		_file_sources.clear();
 	}
-	FileStreamPtr FileSystem::OpenFile(const char* file_path, const File::FileMode mode)
+	FileStreamPtr FileSystem::OpenFile(const char* file_path, const File::FileMode mode, uint32_t buffer_size)
 	{
 		Assert(!_file_sources.empty());
 		FileStreamPtr file;
 		for (auto& source : _file_sources)
 		{
-			file = source->OpenFile(file_path, mode);
+			file = source->OpenFile(file_path, mode, buffer_size);
 			if (file.Get())
 			{
 				return file;
@@ -93,7 +93,7 @@ namespace sb
 		string dir_path(path);
 		string full_path;
 		// Is the sources file path absolute?
-		if (dir_path.find(':') != string::npos)
+		if (file_util::IsAbsolutePath(dir_path))
 		{
 			full_path = dir_path;
 		}
@@ -104,8 +104,8 @@ namespace sb
 
 #ifdef SANDBOX_PLATFORM_WIN
 		CreateDirectory(full_path.c_str(), NULL);
-#elif SANDBOX_PLATFORM_MACOSX
-		mkdir(full_path.Ptr(), S_IRWXU);
+#elif defined(SANDBOX_PLATFORM_POSIX)
+		mkdir(full_path.c_str(), S_IRWXU);
 #endif
 	}
 
@@ -33,9 +33,10 @@ namespace sb
 		/// @brief Tries to open a file with the specified flags
 		///		This will search through all open file sources
 		///	@remark The file must later be closed by calling CloseFile
+		///	@param buffer_size Size of the read buffer for the stream, 0 for an unbuffered stream
 		///	@sa File::FileMode
 		///	@sa CloseFile
-		FileStreamPtr OpenFile(const char* file_path, const File::FileMode mode);
+		FileStreamPtr OpenFile(const char* file_path, const File::FileMode mode, uint32_t buffer_size = 0);
 
 		/// @brief Adds a search path where we will look for files.
 		FileSource* OpenFileSource(const char* path, const PathAddFlags flags = ADD_TO_TAIL);
@@ -22,6 +22,14 @@ namespace sb
 		out += relative;
 		FixSlashes(out);
 	}
+	bool file_util::IsAbsolutePath(const string& path)
+	{
+#ifdef SANDBOX_PLATFORM_WIN
+		return path.find(':') != string::npos;
+#else
+		return !path.empty() && path[0] == '/';
+#endif
+	}
 	//-------------------------------------------------------------------------------
 	void file_util::FixSlashes(char* path)
 	{
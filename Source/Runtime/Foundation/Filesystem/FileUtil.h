@@ -15,6 +15,7 @@ namespace sb
 {
 
 	class FileSource;
+	struct FileTime;
 
 	/// @brief File system utilities
 	namespace file_util
@@ -24,6 +25,9 @@ namespace sb
 		///	@param relative	Relative path (E.g. "content/")
 		void BuildOSPath(string& out, const string& base, const string& relative);
 
+		/// @brief Checks if the path is absolute (E.g. "C:/Game/" or "/home/game/")
+		bool IsAbsolutePath(const string& path);
+
 		/// @brief Fixes all the slashes in a path 
 		void FixSlashes(char* path);
 
@@ -40,6 +44,19 @@ namespace sb
 		/// @brief Finds all directories matching the specified patterns and puts them in the vector files.
 		void FindDirectories(const char* path, vector<string>& directories);
 
+		/// @brief Renames the file src to dst, replacing dst if it already exists
+		///	The replace is atomic where the platform supports it, dst is never left missing.
+		///	@return False if the file couldn't be renamed, both files are left as they were
+		bool RenameFile(const char* src, const char* dst);
+
+		/// @brief Sets the last modified time of the file to the current time
+		///	@return False if the file doesn't exist or its time couldn't be changed
+		bool TouchFile(const char* path);
+
+		/// @brief Retrieves the size and last modified time of a file
+		///	@return False if the file doesn't exist or is a directory
+		bool GetFileInfo(const char* path, uint64_t& size, FileTime& last_modified);
+
 	}; // namespace file_util
 
 } // namespace sb
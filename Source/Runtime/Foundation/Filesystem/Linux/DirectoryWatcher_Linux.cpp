@@ -0,0 +1,252 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "../DirectoryWatcher.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+
+namespace sb
+{
+
+	namespace
+	{
+		// IN_CLOSE_WRITE rather than IN_MODIFY, that way we're only notified once the writer is done
+		//	with the file, instead of once for every write.
+		const uint32_t WATCH_MASK = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO
+			| IN_DELETE_SELF | IN_ONLYDIR;
+	}
+
+	DirectoryWatcher::DirectoryWatcher(const char* dir, bool watch_subtree)
+		: _inotify_fd(-1),
+		_watch_subtree(watch_subtree),
+		_root(dir)
+	{
+		_wake_pipe[0] = _wake_pipe[1] = -1;
+
+		if (!_root.empty() && _root.back() != '/')
+			_root += '/';
+
+		_inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		Assert(_inotify_fd != -1);
+		if (_inotify_fd == -1)
+		{
+			return;
+		}
+
+		if (pipe2(_wake_pipe, O_NONBLOCK | O_CLOEXEC) != 0)
+		{
+			Assert(false);
+			return;
+		}
+
+		AddWatch("", false);
+
+		_thread.Start(this);
+	}
+	DirectoryWatcher::~DirectoryWatcher()
+	{
+		if (_thread.IsRunning())
+		{
+			// Signal thread to exit
+			char c = 0;
+			ssize_t written = write(_wake_pipe[1], &c, 1);
+			Assert(written == 1);
+			(void)written;
+
+			// Wait until it exits
+			_thread.Join();
+		}
+
+		if (_wake_pipe[0] != -1)
+		{
+			close(_wake_pipe[0]);
+			close(_wake_pipe[1]);
+		}
+		if (_inotify_fd != -1)
+			close(_inotify_fd);
+
+		_watches.clear();
+		_changes.clear();
+	}
+
+	bool DirectoryWatcher::PopChange(DirectoryChange& change)
+	{
+		ScopedLock<CriticalSection> scoped_lock(_queue_lock);
+		if (!_changes.empty())
+		{
+			change = _changes.front();
+			_changes.pop_front();
+
+			return true;
+		}
+		return false;
+	}
+	bool DirectoryWatcher::WaitForChange(uint32_t milliseconds)
+	{
+		{
+			ScopedLock<CriticalSection> scoped_lock(_queue_lock);
+			if (!_changes.empty())
+				return true;
+		}
+		_change_event.Wait(milliseconds);
+
+		ScopedLock<CriticalSection> scoped_lock(_queue_lock);
+		return !_changes.empty();
+	}
+	void DirectoryWatcher::Wake()
+	{
+		_change_event.Set();
+	}
+	void DirectoryWatcher::Run()
+	{
+		pollfd fds[2];
+		fds[0].fd = _inotify_fd;
+		fds[0].events = POLLIN;
+		fds[1].fd = _wake_pipe[0];
+		fds[1].events = POLLIN;
+
+		while (true)
+		{
+			fds[0].revents = fds[1].revents = 0;
+			if (poll(fds, 2, -1) < 0)
+			{
+				if (errno == EINTR)
+					continue;
+				break;
+			}
+
+			if (fds[1].revents != 0)
+				break; // Shutting down
+
+			ssize_t num_bytes;
+			while ((num_bytes = read(_inotify_fd, _buffer, BUFFER_SIZE)) > 0)
+			{
+				for (char* ptr = _buffer; ptr < _buffer + num_bytes;)
+				{
+					const inotify_event* event = (const inotify_event*)ptr;
+					ptr += sizeof(inotify_event) + event->len;
+
+					if (event->mask & IN_Q_OVERFLOW)
+					{
+						// Events were dropped, an empty path tells the listener to rescan everything
+						Push(DirectoryChange::UNKNOWN, "");
+						continue;
+					}
+					if (event->mask & IN_IGNORED)
+					{
+						// Watch was removed, either explicitly or because the directory was deleted
+						_watches.erase(event->wd);
+						continue;
+					}
+
+					map<int, string>::iterator it = _watches.find(event->wd);
+					if (it == _watches.end() || event->len == 0)
+						continue;
+
+					string path = it->second + event->name;
+					if (event->mask & IN_ISDIR)
+					{
+						if (_watch_subtree && (event->mask & (IN_CREATE | IN_MOVED_TO)))
+							AddWatch(path + '/', true);
+						else if (_watch_subtree && (event->mask & IN_MOVED_FROM))
+							RemoveWatches(path + '/');
+						continue;
+					}
+
+					if (event->mask & (IN_CREATE | IN_MOVED_TO))
+						Push(DirectoryChange::FILE_ADDED, path.c_str());
+					else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+						Push(DirectoryChange::FILE_REMOVED, path.c_str());
+					else if (event->mask & IN_CLOSE_WRITE)
+						Push(DirectoryChange::FILE_MODIFIED, path.c_str());
+				}
+			}
+		}
+	}
+	void DirectoryWatcher::AddWatch(const string& dir, bool report_files)
+	{
+		string full_path = _root + dir;
+
+		int wd = inotify_add_watch(_inotify_fd, full_path.c_str(), WATCH_MASK);
+		if (wd < 0)
+		{
+			logging::Warning("DirectoryWatcher: Failed to watch '%s' (errno: %d)", full_path.c_str(), errno);
+			return;
+		}
+		_watches[wd] = dir;
+
+		if (!_watch_subtree && !report_files)
+			return;
+
+		DIR* d = opendir(full_path.c_str());
+		if (!d)
+			return;
+
+		// Files may have been written to the directory before the watch was added, so we
+		//	need to scan it after adding the watch to not miss anything.
+		dirent* entry;
+		while ((entry = readdir(d)) != nullptr)
+		{
+			if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+				continue;
+
+			string path = dir + entry->d_name;
+
+			// Not all file systems fill in d_type
+			bool is_dir = entry->d_type == DT_DIR;
+			if (entry->d_type == DT_UNKNOWN)
+			{
+				struct stat stat_info;
+				string entry_path = full_path + entry->d_name;
+				is_dir = stat(entry_path.c_str(), &stat_info) == 0 && S_ISDIR(stat_info.st_mode);
+			}
+
+			if (is_dir)
+			{
+				if (_watch_subtree)
+					AddWatch(path + '/', report_files);
+			}
+			else if (report_files)
+			{
+				Push(DirectoryChange::FILE_ADDED, path.c_str());
+			}
+		}
+		closedir(d);
+	}
+	void DirectoryWatcher::RemoveWatches(const string& dir)
+	{
+		map<int, string>::iterator it = _watches.begin();
+		while (it != _watches.end())
+		{
+			if (it->second.compare(0, dir.size(), dir) == 0)
+			{
+				// The IN_IGNORED event generated by this is skipped as the mapping is already gone
+				inotify_rm_watch(_inotify_fd, it->first);
+				_watches.erase(it++);
+			}
+			else
+			{
+				++it;
+			}
+		}
+	}
+	void DirectoryWatcher::Push(DirectoryChange::Action action, const char* file_name)
+	{
+		ScopedLock<CriticalSection> scoped_lock(_queue_lock);
+
+		_changes.push_back(DirectoryChange());
+		DirectoryChange& change = _changes.back();
+		change.action = action;
+		change.path = file_name;
+
+		_change_event.Set();
+	}
+
+} // namespace sb
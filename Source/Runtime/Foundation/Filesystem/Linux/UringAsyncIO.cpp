@@ -0,0 +1,370 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "UringAsyncIO.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+namespace sb
+{
+
+	namespace
+	{
+		// glibc doesn't provide wrappers for the io_uring system calls
+
+		int io_uring_setup(uint32_t entries, io_uring_params* params)
+		{
+			return (int)syscall(__NR_io_uring_setup, entries, params);
+		}
+		int io_uring_enter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags)
+		{
+			return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+		}
+
+		// The rings are shared with the kernel so head/tail updates need proper ordering
+
+		INLINE uint32_t LoadAcquire(const uint32_t* p)
+		{
+			return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+		}
+		INLINE void StoreRelease(uint32_t* p, uint32_t value)
+		{
+			__atomic_store_n(p, value, __ATOMIC_RELEASE);
+		}
+
+		/// user_data of cancel requests, reads use their slot index
+		const uint64_t CANCEL_USER_DATA = ~0ull;
+	};
+
+	//-------------------------------------------------------------------------------
+	UringAsyncIO::UringAsyncIO(uint32_t queue_depth)
+		: _ring_fd(-1),
+		_sq_ring(MAP_FAILED),
+		_sq_ring_size(0),
+		_sqes((io_uring_sqe*)MAP_FAILED),
+		_sqes_size(0),
+		_cq_ring(MAP_FAILED),
+		_cq_ring_size(0),
+		_queue_depth(queue_depth),
+		_pending(0),
+		_unsubmitted(0),
+		_failed(false),
+		_cancelled(false),
+		_abandoned(false),
+		_iovecs(nullptr)
+	{
+		io_uring_params params;
+		memset(&params, 0, sizeof(params));
+
+		_ring_fd = io_uring_setup(queue_depth, &params);
+		if (_ring_fd < 0)
+		{
+			logging::Warning("UringAsyncIO: io_uring_setup failed (errno: %d)", errno);
+			return;
+		}
+
+		_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+		_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+		bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+		if (single_mmap)
+		{
+			// Both rings share the same mapping
+			_sq_ring_size = Max(_sq_ring_size, _cq_ring_size);
+			_cq_ring_size = _sq_ring_size;
+		}
+
+		_sq_ring = mmap(NULL, _sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_SQ_RING);
+		if (_sq_ring == MAP_FAILED)
+		{
+			logging::Warning("UringAsyncIO: Failed to map submission ring (errno: %d)", errno);
+			return;
+		}
+
+		if (single_mmap)
+		{
+			_cq_ring = _sq_ring;
+		}
+		else
+		{
+			_cq_ring = mmap(NULL, _cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_CQ_RING);
+			if (_cq_ring == MAP_FAILED)
+			{
+				logging::Warning("UringAsyncIO: Failed to map completion ring (errno: %d)", errno);
+				return;
+			}
+		}
+
+		_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+		_sqes = (io_uring_sqe*)mmap(NULL, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring_fd, IORING_OFF_SQES);
+		if (_sqes == MAP_FAILED)
+		{
+			logging::Warning("UringAsyncIO: Failed to map submission entries (errno: %d)", errno);
+			return;
+		}
+
+		uint8_t* sq = (uint8_t*)_sq_ring;
+		_sq_head = (uint32_t*)(sq + params.sq_off.head);
+		_sq_tail = (uint32_t*)(sq + params.sq_off.tail);
+		_sq_mask = (uint32_t*)(sq + params.sq_off.ring_mask);
+		_sq_array = (uint32_t*)(sq + params.sq_off.array);
+
+		uint8_t* cq = (uint8_t*)_cq_ring;
+		_cq_head = (uint32_t*)(cq + params.cq_off.head);
+		_cq_tail = (uint32_t*)(cq + params.cq_off.tail);
+		_cq_mask = (uint32_t*)(cq + params.cq_off.ring_mask);
+		_cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+
+		// The kernel may round the number of entries up, never keep more reads in flight than
+		//	there are submission entries though.
+		_queue_depth = Min(queue_depth, params.sq_entries);
+
+		// IORING_OP_READV is used rather than IORING_OP_READ to support kernels older than 5.6
+		_iovecs = (iovec*)memory::Malloc(sizeof(iovec) * _queue_depth);
+		_slots.resize(_queue_depth);
+		for (uint32_t i = _queue_depth; i > 0; --i)
+		{
+			_slots[i - 1].user_data = nullptr;
+			_slots[i - 1].iov = &_iovecs[i - 1];
+			_slots[i - 1].in_flight = false;
+			_slots[i - 1].cancelled = false;
+			_free_slots.push_back(i - 1);
+		}
+	}
+	UringAsyncIO::~UringAsyncIO()
+	{
+		// Make sure the kernel is done writing to our buffers before we let go of the ring
+		if (IsValid() && _pending > 0)
+			CancelPending();
+
+		if (_sqes != MAP_FAILED)
+			munmap(_sqes, _sqes_size);
+		if (_cq_ring != MAP_FAILED && _cq_ring != _sq_ring)
+			munmap(_cq_ring, _cq_ring_size);
+		if (_sq_ring != MAP_FAILED)
+			munmap(_sq_ring, _sq_ring_size);
+		if (_ring_fd >= 0)
+			close(_ring_fd);
+
+		// The kernel may still read the iovecs of abandoned reads
+		if (_iovecs && !_abandoned)
+			memory::Free(_iovecs);
+	}
+	bool UringAsyncIO::IsValid() const
+	{
+		return _ring_fd >= 0 && _sq_ring != MAP_FAILED && _cq_ring != MAP_FAILED && _sqes != MAP_FAILED;
+	}
+	//-------------------------------------------------------------------------------
+	bool UringAsyncIO::Submit(const ReadRequest& request)
+	{
+		Assert(IsValid());
+		Assert(request.file && request.file->IsOpen());
+
+		if (_failed || _free_slots.empty())
+			return false;
+
+		uint32_t slot_index = _free_slots.back();
+		_free_slots.pop_back();
+
+		Slot& slot = _slots[slot_index];
+		slot.user_data = request.user_data;
+		slot.iov->iov_base = request.dst;
+		slot.iov->iov_len = request.size;
+		slot.in_flight = true;
+		slot.cancelled = false;
+
+		// We are the only producer so the tail can be read without synchronization
+		uint32_t tail = *_sq_tail;
+		uint32_t index = tail & *_sq_mask;
+
+		io_uring_sqe* sqe = &_sqes[index];
+		memset(sqe, 0, sizeof(io_uring_sqe));
+		sqe->opcode = IORING_OP_READV;
+		sqe->fd = request.file->GetHandle();
+		sqe->off = request.offset;
+		sqe->addr = (uint64_t)(uintptr_t)slot.iov;
+		sqe->len = 1;
+		sqe->user_data = slot_index;
+
+		_sq_array[index] = index;
+		StoreRelease(_sq_tail, tail + 1);
+
+		++_pending;
+		++_unsubmitted;
+
+		// Batch submissions, the kernel gets them all at once on the next Poll or Wait
+		return true;
+	}
+	uint32_t UringAsyncIO::Poll(Completion* completions, uint32_t max_count)
+	{
+		Assert(IsValid());
+		if (!_failed && _unsubmitted)
+			Enter(0);
+
+		if (_failed && !CancelPending())
+			return 0;
+
+		return ReapCompletions(completions, max_count);
+	}
+	uint32_t UringAsyncIO::Wait(Completion* completions, uint32_t max_count)
+	{
+		Assert(IsValid());
+		if (_pending == 0)
+			return 0;
+
+		while (!_failed)
+		{
+			uint32_t count = ReapCompletions(completions, max_count);
+			if (count)
+				return count;
+
+			// A busy kernel only needs us to make room in the completion ring, which the
+			//	reap at the top of the loop does.
+			Enter(1);
+		}
+		if (!CancelPending())
+			return 0;
+		return ReapCompletions(completions, max_count);
+	}
+	uint32_t UringAsyncIO::Pending() const
+	{
+		return _pending;
+	}
+	uint32_t UringAsyncIO::QueueDepth() const
+	{
+		return _queue_depth;
+	}
+	const char* UringAsyncIO::Name() const
+	{
+		return "io_uring";
+	}
+	//-------------------------------------------------------------------------------
+	UringAsyncIO::EnterResult UringAsyncIO::Enter(uint32_t min_complete)
+	{
+		uint32_t flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+		while (true)
+		{
+			int result = io_uring_enter(_ring_fd, _unsubmitted, min_complete, flags);
+			if (result >= 0)
+			{
+				_unsubmitted -= (uint32_t)result;
+				return ENTER_OK;
+			}
+			if (errno == EAGAIN || errno == EBUSY)
+				return ENTER_BUSY;
+			if (errno != EINTR)
+			{
+				logging::Error("UringAsyncIO: io_uring_enter failed (errno: %d)", errno);
+				_failed = true;
+				return ENTER_FAILED;
+			}
+		}
+	}
+	uint32_t UringAsyncIO::ReapCompletions(Completion* completions, uint32_t max_count)
+	{
+		uint32_t count = 0;
+
+		uint32_t head = *_cq_head;
+		uint32_t tail = LoadAcquire(_cq_tail);
+		while (head != tail && count < max_count)
+		{
+			const io_uring_cqe& cqe = _cqes[head & *_cq_mask];
+			++head;
+
+			if (cqe.user_data == CANCEL_USER_DATA)
+				continue;
+
+			uint32_t slot_index = (uint32_t)cqe.user_data;
+			completions[count].user_data = _slots[slot_index].user_data;
+			completions[count].result = _slots[slot_index].cancelled ? -ECANCELED : cqe.res;
+			_slots[slot_index].in_flight = false;
+			_free_slots.push_back(slot_index);
+
+			++count;
+		}
+		StoreRelease(_cq_head, head);
+
+		_pending -= count;
+		return count;
+	}
+	bool UringAsyncIO::CancelPending()
+	{
+		if (_cancelled || _abandoned)
+			return _cancelled;
+
+		// No new reads once we start cancelling
+		_failed = true;
+
+		// Reads the kernel hasn't consumed yet are turned into no-ops, they still post a
+		//	completion but never touch their buffers.
+		uint32_t tail = *_sq_tail;
+		for (uint32_t i = LoadAcquire(_sq_head); i != tail; ++i)
+		{
+			io_uring_sqe* sqe = &_sqes[_sq_array[i & *_sq_mask]];
+			uint64_t user_data = sqe->user_data;
+
+			memset(sqe, 0, sizeof(io_uring_sqe));
+			sqe->opcode = IORING_OP_NOP;
+			sqe->user_data = user_data;
+			_slots[(uint32_t)user_data].cancelled = true;
+		}
+
+		// The rest are cancelled by the kernel. There's always room in the submission ring as
+		//	each consumed read has freed up its entry.
+		uint32_t cancel_count = 0;
+		for (uint32_t i = 0; i < _slots.size(); ++i)
+		{
+			if (!_slots[i].in_flight || _slots[i].cancelled)
+				continue;
+
+			uint32_t index = tail & *_sq_mask;
+			io_uring_sqe* sqe = &_sqes[index];
+			memset(sqe, 0, sizeof(io_uring_sqe));
+			sqe->opcode = IORING_OP_ASYNC_CANCEL;
+			sqe->addr = i;
+			sqe->user_data = CANCEL_USER_DATA;
+			_sq_array[index] = index;
+
+			++tail;
+			++cancel_count;
+		}
+		StoreRelease(_sq_tail, tail);
+		_unsubmitted = tail - LoadAcquire(_sq_head);
+
+		// Every read posts exactly one completion, whether it was cancelled or not, and so does
+		//	every cancel request. The completion ring holds twice the number of submission entries
+		//	so they all fit.
+		uint32_t expected = _pending + cancel_count;
+		while (true)
+		{
+			uint32_t ready = LoadAcquire(_cq_tail) - *_cq_head;
+			if (ready >= expected)
+				break;
+
+			int result = io_uring_enter(_ring_fd, _unsubmitted, expected - ready, IORING_ENTER_GETEVENTS);
+			if (result >= 0)
+			{
+				_unsubmitted -= (uint32_t)result;
+			}
+			else if (errno != EINTR && errno != EAGAIN && errno != EBUSY)
+			{
+				// We can't tell when the kernel is done with the buffers, leaking them is the only
+				//	safe option left.
+				logging::Error("UringAsyncIO: Failed to cancel %u reads in flight (errno: %d), their buffers are never released",
+					_pending, errno);
+				_abandoned = true;
+				_pending = 0;
+				return false;
+			}
+		}
+
+		_cancelled = true;
+		return true;
+	}
+	//-------------------------------------------------------------------------------
+
+} // namespace sb
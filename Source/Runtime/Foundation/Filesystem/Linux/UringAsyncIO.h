@@ -0,0 +1,101 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __FOUNDATION_URINGASYNCIO_H__
+#define __FOUNDATION_URINGASYNCIO_H__
+
+#include "../AsyncIO.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct iovec;
+
+namespace sb
+{
+
+	/// @brief Asynchronous IO through Linux io_uring
+	///
+	///	Reads are written straight into the submission ring and handed to the kernel with a single
+	///		io_uring_enter call, so the device sees the full queue depth without any helper threads.
+	class UringAsyncIO : public AsyncIO
+	{
+	public:
+		UringAsyncIO(uint32_t queue_depth);
+		~UringAsyncIO();
+
+		/// @return True if the ring was set up, false if io_uring isn't supported by the kernel
+		bool IsValid() const;
+
+		bool Submit(const ReadRequest& request);
+		uint32_t Poll(Completion* completions, uint32_t max_count);
+		uint32_t Wait(Completion* completions, uint32_t max_count);
+
+		uint32_t Pending() const;
+		uint32_t QueueDepth() const;
+		const char* Name() const;
+
+	private:
+		int _ring_fd;
+
+		// Submission ring
+		void* _sq_ring;
+		size_t _sq_ring_size;
+		uint32_t* _sq_head;
+		uint32_t* _sq_tail;
+		uint32_t* _sq_mask;
+		uint32_t* _sq_array;
+		io_uring_sqe* _sqes;
+		size_t _sqes_size;
+
+		// Completion ring
+		void* _cq_ring;
+		size_t _cq_ring_size;
+		uint32_t* _cq_head;
+		uint32_t* _cq_tail;
+		uint32_t* _cq_mask;
+		io_uring_cqe* _cqes;
+
+		uint32_t _queue_depth;
+		uint32_t _pending; ///< Submitted but not yet reaped
+		uint32_t _unsubmitted; ///< Written to the submission ring but not yet handed to the kernel
+		bool _failed; ///< Set if io_uring_enter failed, the ring is unusable after that
+		bool _cancelled; ///< Set once all reads in flight have been cancelled and their completions posted
+		bool _abandoned; ///< Set if cancelling failed, reads still in flight are never reported
+
+		/// Per-read state, indexed by the user_data passed to the kernel
+		struct Slot
+		{
+			void* user_data;
+			iovec* iov;
+			bool in_flight;
+			bool cancelled; ///< Turned into a no-op before the kernel saw it
+		};
+		vector<Slot> _slots;
+		vector<uint32_t> _free_slots;
+		iovec* _iovecs;
+
+		enum EnterResult
+		{
+			ENTER_OK,
+			ENTER_BUSY, ///< Kernel is out of resources or the completion ring is full, reap and retry
+			ENTER_FAILED
+		};
+
+		/// @brief Hands all unsubmitted reads to the kernel, optionally waiting for completions
+		EnterResult Enter(uint32_t min_complete);
+
+		uint32_t ReapCompletions(Completion* completions, uint32_t max_count);
+
+		/// @brief Cancels all reads in flight and waits until the kernel has posted a completion for each
+		///
+		///	Used once the ring has failed and on destruction. The completions are left in the ring so
+		///		that the reads are reported through ReapCompletions as usual. Buffers must not be
+		///		released before the kernel is done with them, if we can't wait for that the reads are
+		///		abandoned and never reported.
+		///	@return False if the reads were abandoned
+		bool CancelPending();
+	};
+
+} // namespace sb
+
+
+#endif // __FOUNDATION_URINGASYNCIO_H__
@@ -0,0 +1,48 @@
+// Copyright 2008-2014 Simon Ekstrm
+
+#ifndef __FOUNDATION_MAPPEDFILE_H__
+#define __FOUNDATION_MAPPEDFILE_H__
+
+namespace sb
+{
+
+	/// @brief Read-only memory mapping of a complete file
+	///
+	///	Lets files with a layout that can be used in place (e.g. arrays of fixed size records)
+	///		be read without copying or parsing anything, pages are only read from disk as
+	///		they're touched.
+	class MappedFile : NonCopyable
+	{
+	public:
+		MappedFile();
+		~MappedFile();
+
+		/// @brief Maps the specified file
+		///	@param file OS path to the file
+		///	@return False if the file couldn't be opened or mapped
+		bool Open(const char* file);
+		void Close();
+		bool IsOpen() const;
+
+		/// @return Pointer to the start of the mapped file, NULL if not mapped or if the file is empty
+		const uint8_t* Data() const;
+
+		/// @return Size of the mapped file in bytes
+		uint64_t Size() const;
+
+	private:
+		const uint8_t* _data;
+		uint64_t _size;
+		bool _open;
+
+#ifdef SANDBOX_PLATFORM_WIN
+		HANDLE _file;
+		HANDLE _mapping;
+#endif
+	};
+
+} // namespace sb
+
+
+
+#endif // __FOUNDATION_MAPPEDFILE_H__
@@ -3,43 +3,81 @@
 #include "Common.h"
 
 #include "../FileUtil.h"
+#include "../FileSource.h"
 
 #include <glob.h>
+#include <sys/stat.h>
+#include <utime.h>
 
 namespace sb
 {
 
-void file_util::FindFiles(const char* path, Vector<String>& files)
-{
-	glob_t g;
-	glob(path, GLOB_TILDE|GLOB_MARK, NULL, &g);
-	for(int i = 0; i < g.gl_matchc; ++i)
+	namespace
 	{
-		char* entry = g.gl_pathv[i];
-		if(entry[strlen(g.gl_pathv[i])-1] != '/') // Directories end with '/'
+		/// Finds all entries matching the pattern, names are returned without their directory
+		///	to match the Windows implementation.
+		void FindEntries(const char* path, vector<string>& entries, bool directories)
 		{
-			entry[strlen(g.gl_pathv[i])-1] = '\0'; // Stip the trailing '/' from the resulting path
-			files.PushBack(String(entry));
+			glob_t g;
+			if (glob(path, GLOB_MARK, NULL, &g) != 0)
+				return;
+
+			for (size_t i = 0; i < g.gl_pathc; ++i)
+			{
+				string entry = g.gl_pathv[i];
+
+				// GLOB_MARK adds a trailing '/' to directories
+				bool is_directory = !entry.empty() && entry.back() == '/';
+				if (is_directory != directories)
+					continue;
+
+				if (is_directory)
+					entry.pop_back();
+
+				size_t separator = entry.rfind('/');
+				if (separator != string::npos)
+					entry = entry.substr(separator + 1);
+
+				if (entry != "." && entry != "..")
+					entries.push_back(entry);
+			}
+			globfree(&g);
 		}
 	}
-	globfree(&g);
-}
 
-void file_util::FindDirectories(const char* path, Vector<String>& directories)
-{
-	glob_t g;
-	glob(path, GLOB_TILDE|GLOB_MARK, NULL, &g);
-	for(int i = 0; i < g.gl_matchc; ++i)
+	void file_util::FindFiles(const char* path, vector<string>& files)
 	{
-		const char* entry = g.gl_pathv[i];
-		if(entry[strlen(g.gl_pathv[i])-1] == '/') // Directories end with '/'
-			directories.PushBack(String(entry));
+		FindEntries(path, files, false);
 	}
-	globfree(&g);
-}
 
+	void file_util::FindDirectories(const char* path, vector<string>& directories)
+	{
+		FindEntries(path, directories, true);
+	}
 
-} // namespace sb
+	bool file_util::RenameFile(const char* src, const char* dst)
+	{
+		return rename(src, dst) == 0;
+	}
 
+	bool file_util::TouchFile(const char* path)
+	{
+		return utime(path, NULL) == 0;
+	}
 
+	bool file_util::GetFileInfo(const char* path, uint64_t& size, FileTime& last_modified)
+	{
+		struct stat stat_info;
+		if (stat(path, &stat_info) != 0 || !S_ISREG(stat_info.st_mode))
+			return false;
 
+		size = (uint64_t)stat_info.st_size;
+
+		// Same format as FileSource::LastModifiedTime
+		uint64_t t = stat_info.st_mtime;
+		last_modified.high = (uint32_t)(t >> 32);
+		last_modified.low = (uint32_t)(t & 0xFFFFFFFF);
+		return true;
+	}
+
+} // namespace sb
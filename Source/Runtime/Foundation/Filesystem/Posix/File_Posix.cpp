@@ -4,6 +4,9 @@
 
 #include "../File.h"
 
+#include <fcntl.h>
+#include <sys/uio.h>
+
 
 namespace sb
 {
@@ -15,13 +18,11 @@ File::File()
 }
 File::~File()
 {
-	Close();
+	// File handles are copied around by value (e.g. into FileStream), so closing is left to the owner
 }
 bool File::Open(const char* file, File::FileMode file_mode)
 {
-	_file_mode = file_mode;
-
-	mode_t flags = 0;
+	int flags = 0;
 	if(file_mode == File::READ)
 	{
 		flags = O_RDONLY;
@@ -61,18 +62,75 @@ bool File::IsOpen() const
 uint32_t File::Read(void* dst, uint32_t size)
 {
 	Assert(_handle != -1);
-	Assert(dst)
+	Assert(dst);
 	
-	int result = read(_handle, dst, size);
+	ssize_t result = read(_handle, dst, size);
+	file_stats::RecordRead(result >= 0 ? (uint32_t)result : 0);
 
 	return ((result >= 0) ? (uint32_t)result : 0); 
 }
+uint32_t File::ReadMany(const ReadBuffer* buffers, uint32_t count)
+{
+	Assert(_handle != -1);
+	Assert(buffers);
+
+	enum { MAX_BUFFERS = 16 };
+
+	uint32_t total = 0;
+	while (count > 0)
+	{
+		struct iovec iov[MAX_BUFFERS];
+		int iov_count = 0;
+		uint32_t requested = 0;
+		for (; count > 0 && iov_count < MAX_BUFFERS; --count, ++buffers)
+		{
+			iov[iov_count].iov_base = buffers->dst;
+			iov[iov_count].iov_len = buffers->size;
+			requested += buffers->size;
+			++iov_count;
+		}
+
+		ssize_t result = readv(_handle, iov, iov_count);
+		file_stats::RecordRead(result >= 0 ? (uint32_t)result : 0);
+		if (result <= 0)
+			break;
+
+		total += (uint32_t)result;
+		if ((uint32_t)result != requested)
+			break; // End of file
+	}
+	return total;
+}
+uint32_t File::ReadAt(void* dst, uint32_t size, int64_t offset) const
+{
+	Assert(_handle != -1);
+	Assert(dst);
+
+	ssize_t result = pread(_handle, dst, size, offset);
+	file_stats::RecordRead(result >= 0 ? (uint32_t)result : 0);
+
+	return ((result >= 0) ? (uint32_t)result : 0);
+}
+void File::Prefetch(int64_t offset, uint32_t size)
+{
+	Assert(_handle != -1);
+
+#if defined(POSIX_FADV_WILLNEED)
+	posix_fadvise(_handle, offset, size, POSIX_FADV_WILLNEED);
+#elif defined(F_RDADVISE)
+	struct radvisory advice;
+	advice.ra_offset = offset;
+	advice.ra_count = size;
+	fcntl(_handle, F_RDADVISE, &advice);
+#endif
+}
 uint32_t File::Write(const void* src, uint32_t size)
 {
 	Assert(_handle != -1);
-	Assert(src)
+	Assert(src);
 
-	int result = write(_handle, src, size);
+	ssize_t result = write(_handle, src, size);
+	file_stats::RecordWrite();
 
 	return ((result >= 0) ? (uint32_t)result : 0); 
 }
@@ -95,6 +153,7 @@ int64_t File::Seek(int64_t offset, SeekOrigin origin)
 		break;
 	};
 
+	file_stats::RecordSeek();
 	return lseek(_handle, offset, move_method);
 }
 void File::Flush()
@@ -107,6 +166,7 @@ void File::Flush()
 int64_t File::Tell() const
 {
 	Assert(_handle != -1);
+	file_stats::RecordSeek();
 	return lseek(_handle, 0, SEEK_CUR);
 }
 	
@@ -117,6 +177,11 @@ int64_t File::Length() const
 	return (res == 0 ? file_stat.st_size : - 1);
 }
 
+File::Handle File::GetHandle() const
+{
+	return _handle;
+}
+
 //-------------------------------------------------------------------------------
 
 } // namespace sb
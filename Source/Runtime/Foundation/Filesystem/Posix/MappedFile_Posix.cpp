@@ -0,0 +1,82 @@
+// Copyright 2008-2014 Simon Ekstrm
+
+#include "Common.h"
+
+#include "../MappedFile.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace sb
+{
+
+	MappedFile::MappedFile()
+		: _data(NULL),
+		_size(0),
+		_open(false)
+	{
+	}
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+	bool MappedFile::Open(const char* file)
+	{
+		Close();
+
+		int fd = open(file, O_RDONLY | O_CLOEXEC);
+		if (fd == -1)
+			return false;
+
+		struct stat st;
+		if (fstat(fd, &st) != 0)
+		{
+			close(fd);
+			return false;
+		}
+
+		_size = (uint64_t)st.st_size;
+		if (_size != 0)
+		{
+			void* data = mmap(NULL, (size_t)_size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (data == MAP_FAILED)
+			{
+				close(fd);
+				_size = 0;
+				return false;
+			}
+			_data = (const uint8_t*)data;
+		}
+
+		// The mapping keeps its own reference to the file
+		close(fd);
+
+		_open = true;
+		return true;
+	}
+	void MappedFile::Close()
+	{
+		if (_data)
+			munmap((void*)_data, (size_t)_size);
+
+		_data = NULL;
+		_size = 0;
+		_open = false;
+	}
+	bool MappedFile::IsOpen() const
+	{
+		return _open;
+	}
+	const uint8_t* MappedFile::Data() const
+	{
+		return _data;
+	}
+	uint64_t MappedFile::Size() const
+	{
+		return _size;
+	}
+
+} // namespace sb
@@ -0,0 +1,129 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "ThreadPoolAsyncIO.h"
+
+namespace sb
+{
+
+	//-------------------------------------------------------------------------------
+	ThreadPoolAsyncIO::ThreadPoolAsyncIO(uint32_t queue_depth, uint32_t thread_count)
+		: _queue_depth(queue_depth),
+		_pending(0),
+		_stopping(0),
+		_completion_event(false, false)
+	{
+		Assert(thread_count > 0);
+		for (uint32_t i = 0; i < thread_count; ++i)
+		{
+			SimpleThread* thread = new SimpleThread();
+			thread->Start(WorkerThread, this);
+			_threads.push_back(thread);
+		}
+	}
+	ThreadPoolAsyncIO::~ThreadPoolAsyncIO()
+	{
+		thread::InterlockedExchange(&_stopping, 1);
+
+		// Wake all workers so they can see that we're stopping
+		for (uint32_t i = 0; i < _threads.size(); ++i)
+		{
+			_request_semaphore.Set();
+		}
+		for (uint32_t i = 0; i < _threads.size(); ++i)
+		{
+			_threads[i]->Join();
+			delete _threads[i];
+		}
+		_threads.clear();
+	}
+	//-------------------------------------------------------------------------------
+	bool ThreadPoolAsyncIO::Submit(const ReadRequest& request)
+	{
+		Assert(request.file && request.file->IsOpen());
+		if (_pending >= _queue_depth)
+			return false;
+
+		{
+			ScopedLock<CriticalSection> scoped_lock(_lock);
+			_requests.push_back(request);
+		}
+		++_pending;
+		_request_semaphore.Set();
+
+		return true;
+	}
+	uint32_t ThreadPoolAsyncIO::Poll(Completion* completions, uint32_t max_count)
+	{
+		return PopCompletions(completions, max_count);
+	}
+	uint32_t ThreadPoolAsyncIO::Wait(Completion* completions, uint32_t max_count)
+	{
+		if (_pending == 0)
+			return 0;
+
+		uint32_t count;
+		while ((count = PopCompletions(completions, max_count)) == 0)
+		{
+			_completion_event.Wait();
+		}
+		return count;
+	}
+	uint32_t ThreadPoolAsyncIO::Pending() const
+	{
+		return _pending;
+	}
+	uint32_t ThreadPoolAsyncIO::QueueDepth() const
+	{
+		return _queue_depth;
+	}
+	const char* ThreadPoolAsyncIO::Name() const
+	{
+		return "thread pool";
+	}
+	//-------------------------------------------------------------------------------
+	uint32_t ThreadPoolAsyncIO::PopCompletions(Completion* completions, uint32_t max_count)
+	{
+		ScopedLock<CriticalSection> scoped_lock(_lock);
+
+		uint32_t count = 0;
+		while (count < max_count && !_completions.empty())
+		{
+			completions[count++] = _completions.front();
+			_completions.pop_front();
+		}
+		_pending -= count;
+		return count;
+	}
+	void ThreadPoolAsyncIO::WorkerThread(void* param)
+	{
+		ThreadPoolAsyncIO* async_io = (ThreadPoolAsyncIO*)param;
+		while (true)
+		{
+			async_io->_request_semaphore.Wait();
+			if (async_io->_stopping != 0)
+				break;
+
+			ReadRequest request;
+			{
+				ScopedLock<CriticalSection> scoped_lock(async_io->_lock);
+				Assert(!async_io->_requests.empty());
+				request = async_io->_requests.front();
+				async_io->_requests.pop_front();
+			}
+
+			Completion completion;
+			completion.user_data = request.user_data;
+			completion.result = request.file->ReadAt(request.dst, request.size, request.offset);
+
+			{
+				ScopedLock<CriticalSection> scoped_lock(async_io->_lock);
+				async_io->_completions.push_back(completion);
+			}
+			async_io->_completion_event.Set();
+		}
+	}
+	//-------------------------------------------------------------------------------
+
+} // namespace sb
@@ -0,0 +1,53 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __FOUNDATION_THREADPOOLASYNCIO_H__
+#define __FOUNDATION_THREADPOOLASYNCIO_H__
+
+#include "AsyncIO.h"
+
+namespace sb
+{
+
+	/// @brief Asynchronous IO through a pool of threads doing blocking positioned reads
+	///
+	///	Used on platforms without a native asynchronous IO interface, each thread keeps one read
+	///		in flight so the device queue depth is at most the number of threads.
+	class ThreadPoolAsyncIO : public AsyncIO
+	{
+	public:
+		enum { DEFAULT_THREAD_COUNT = 4 };
+
+		ThreadPoolAsyncIO(uint32_t queue_depth, uint32_t thread_count = DEFAULT_THREAD_COUNT);
+		~ThreadPoolAsyncIO();
+
+		bool Submit(const ReadRequest& request);
+		uint32_t Poll(Completion* completions, uint32_t max_count);
+		uint32_t Wait(Completion* completions, uint32_t max_count);
+
+		uint32_t Pending() const;
+		uint32_t QueueDepth() const;
+		const char* Name() const;
+
+	private:
+		uint32_t _queue_depth;
+		uint32_t _pending;
+
+		vector<SimpleThread*> _threads;
+		volatile long _stopping;
+
+		CriticalSection _lock;
+		deque<ReadRequest> _requests;
+		deque<Completion> _completions;
+
+		Semaphore _request_semaphore; ///< Signaled once for every queued request
+		Event _completion_event; ///< Signaled when a read completes
+
+		static void WorkerThread(void* param);
+
+		uint32_t PopCompletions(Completion* completions, uint32_t max_count);
+	};
+
+} // namespace sb
+
+
+#endif // __FOUNDATION_THREADPOOLASYNCIO_H__
@@ -56,6 +56,22 @@ namespace sb
 		}
 		return false;
 	}
+	bool DirectoryWatcher::WaitForChange(uint32_t milliseconds)
+	{
+		{
+			ScopedLock<CriticalSection> scoped_lock(_queue_lock);
+			if (!_changes.empty())
+				return true;
+		}
+		_change_event.Wait(milliseconds);
+
+		ScopedLock<CriticalSection> scoped_lock(_queue_lock);
+		return !_changes.empty();
+	}
+	void DirectoryWatcher::Wake()
+	{
+		_change_event.Set();
+	}
 	void DirectoryWatcher::Run()
 	{
 		Verify(ReadDirectoryChangesW(
@@ -136,6 +152,7 @@ namespace sb
 		change.action = action;
 		change.path = file_name;
 
+		_change_event.Set();
 	}
 
 #endif // SANDBOX_PLATFORM_WIN
@@ -3,6 +3,7 @@
 #include "Common.h"
 
 #include "../FileUtil.h"
+#include "../FileSource.h"
 
 namespace sb
 {
@@ -50,5 +51,40 @@ namespace sb
 		FindClose(fh);
 	}
 
-} // namespace sb
+	bool file_util::RenameFile(const char* src, const char* dst)
+	{
+		// Unlike rename(), MoveFileEx can replace an existing file
+		return MoveFileEx(src, dst, MOVEFILE_REPLACE_EXISTING) != 0;
+	}
+
+	bool file_util::TouchFile(const char* path)
+	{
+		HANDLE file = CreateFile(path, FILE_WRITE_ATTRIBUTES, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+			NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		FILETIME now;
+		GetSystemTimeAsFileTime(&now);
+		BOOL result = SetFileTime(file, NULL, NULL, &now);
+
+		CloseHandle(file);
+		return result != 0;
+	}
+
+	bool file_util::GetFileInfo(const char* path, uint64_t& size, FileTime& last_modified)
+	{
+		WIN32_FILE_ATTRIBUTE_DATA file_attr;
+		if (!GetFileAttributesEx(path, GetFileExInfoStandard, &file_attr) ||
+			(file_attr.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+			return false;
+
+		size = ((uint64_t)file_attr.nFileSizeHigh << 32) | file_attr.nFileSizeLow;
 
+		// Same format as FileSource::LastModifiedTime
+		last_modified.high = file_attr.ftLastWriteTime.dwHighDateTime;
+		last_modified.low = file_attr.ftLastWriteTime.dwLowDateTime;
+		return true;
+	}
+
+} // namespace sb
@@ -62,9 +62,53 @@ namespace sb
 
 		DWORD bytes_read = 0;
 		BOOL result = ::ReadFile(_handle, dst, size, &bytes_read, NULL);
+		file_stats::RecordRead(bytes_read);
 
 		return (result ? bytes_read : 0);
 	}
+	uint32_t File::ReadMany(const ReadBuffer* buffers, uint32_t count)
+	{
+		Assert(_handle != INVALID_HANDLE_VALUE);
+		Assert(buffers);
+
+		// ReadFileScatter requires unbuffered handles and page-sized buffers so we just read
+		//	the buffers one at a time.
+		uint32_t total = 0;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (buffers[i].size == 0)
+				continue;
+
+			uint32_t bytes_read = Read(buffers[i].dst, buffers[i].size);
+			total += bytes_read;
+
+			if (bytes_read != buffers[i].size)
+				break; // End of file
+		}
+		return total;
+	}
+	uint32_t File::ReadAt(void* dst, uint32_t size, int64_t offset) const
+	{
+		Assert(_handle != INVALID_HANDLE_VALUE);
+		Assert(dst);
+
+		// Specifying the offset through an OVERLAPPED structure on a synchronous handle performs
+		//	a positioned read. The file pointer is still updated but we never rely on it for these reads.
+		OVERLAPPED overlapped;
+		memset(&overlapped, 0, sizeof(OVERLAPPED));
+		overlapped.Offset = (DWORD)(offset & 0xFFFFFFFF);
+		overlapped.OffsetHigh = (DWORD)(offset >> 32);
+
+		DWORD bytes_read = 0;
+		BOOL result = ::ReadFile(_handle, dst, size, &bytes_read, &overlapped);
+		file_stats::RecordRead(bytes_read);
+
+		return (result ? bytes_read : 0);
+	}
+	void File::Prefetch(int64_t, uint32_t)
+	{
+		// The Windows cache manager already performs read-ahead for sequential access
+	}
 	uint32_t File::Write(const void* src, uint32_t size)
 	{
 		Assert(_handle != INVALID_HANDLE_VALUE);
@@ -72,6 +116,7 @@ namespace sb
 
 		DWORD bytes_written = 0;
 		BOOL result = ::WriteFile(_handle, src, size, &bytes_written, NULL);
+		file_stats::RecordWrite();
 
 		return (result ? bytes_written : 0);
 	}
@@ -100,6 +145,7 @@ namespace sb
 
 		BOOL result = ::SetFilePointerEx(_handle, distance_to_move, &new_file_pointer, move_method);
 		Assert(result);
+		file_stats::RecordSeek();
 
 		return (result ? new_file_pointer.QuadPart : -1);
 	}
@@ -118,6 +164,7 @@ namespace sb
 
 		BOOL result = ::SetFilePointerEx(_handle, distance_to_move, &new_file_pointer, FILE_CURRENT);
 		Assert(result);
+		file_stats::RecordSeek();
 
 		return (result ? new_file_pointer.QuadPart : -1);
 	}
@@ -133,6 +180,11 @@ namespace sb
 		return (result ? size.QuadPart : -1);
 	}
 
+	File::Handle File::GetHandle() const
+	{
+		return _handle;
+	}
+
 	//-------------------------------------------------------------------------------
 
 } // namespace sb
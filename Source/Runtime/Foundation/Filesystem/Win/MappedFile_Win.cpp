@@ -0,0 +1,87 @@
+// Copyright 2008-2014 Simon Ekstrm
+
+#include "Common.h"
+
+#include "../MappedFile.h"
+
+namespace sb
+{
+
+	MappedFile::MappedFile()
+		: _data(NULL),
+		_size(0),
+		_open(false),
+		_file(INVALID_HANDLE_VALUE),
+		_mapping(NULL)
+	{
+	}
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+	bool MappedFile::Open(const char* file)
+	{
+		Close();
+
+		_file = ::CreateFile(file, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (_file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(_file, &size))
+		{
+			Close();
+			return false;
+		}
+
+		_size = (uint64_t)size.QuadPart;
+		if (_size != 0)
+		{
+			// Empty files can't be mapped
+			_mapping = CreateFileMapping(_file, NULL, PAGE_READONLY, 0, 0, NULL);
+			if (!_mapping)
+			{
+				Close();
+				return false;
+			}
+
+			_data = (const uint8_t*)MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+			if (!_data)
+			{
+				Close();
+				return false;
+			}
+		}
+
+		_open = true;
+		return true;
+	}
+	void MappedFile::Close()
+	{
+		if (_data)
+			UnmapViewOfFile(_data);
+		if (_mapping)
+			CloseHandle(_mapping);
+		if (_file != INVALID_HANDLE_VALUE)
+			CloseHandle(_file);
+
+		_data = NULL;
+		_size = 0;
+		_open = false;
+		_mapping = NULL;
+		_file = INVALID_HANDLE_VALUE;
+	}
+	bool MappedFile::IsOpen() const
+	{
+		return _open;
+	}
+	const uint8_t* MappedFile::Data() const
+	{
+		return _data;
+	}
+	uint64_t MappedFile::Size() const
+	{
+		return _size;
+	}
+
+} // namespace sb
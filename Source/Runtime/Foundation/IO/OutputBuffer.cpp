@@ -0,0 +1,57 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "OutputBuffer.h"
+
+namespace sb
+{
+
+	//-------------------------------------------------------------------------------
+	OutputBuffer::OutputBuffer(Stream& stream)
+		: _stream(stream),
+		_size(0)
+	{
+	}
+	OutputBuffer::~OutputBuffer()
+	{
+		Flush();
+	}
+	//-------------------------------------------------------------------------------
+	void OutputBuffer::Write(const void* data, size_t size)
+	{
+		if (BUFFER_SIZE - _size >= size)
+		{
+			memcpy(_buffer + _size, data, size);
+			_size += size;
+			return;
+		}
+
+		// Fill up the buffer, larger writes then go straight to the stream
+		size_t fill = BUFFER_SIZE - _size;
+		memcpy(_buffer + _size, data, fill);
+		_size = BUFFER_SIZE;
+		Flush();
+
+		const uint8_t* remaining = (const uint8_t*)data + fill;
+		size -= fill;
+		if (size >= BUFFER_SIZE)
+		{
+			_stream.Write(remaining, size);
+			return;
+		}
+
+		memcpy(_buffer, remaining, size);
+		_size = size;
+	}
+	void OutputBuffer::Flush()
+	{
+		if (_size)
+		{
+			_stream.Write(_buffer, _size);
+			_size = 0;
+		}
+	}
+	//-------------------------------------------------------------------------------
+
+} // namespace sb
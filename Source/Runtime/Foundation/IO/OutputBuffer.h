@@ -0,0 +1,65 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __FOUNDATION_OUTPUTBUFFER_H__
+#define __FOUNDATION_OUTPUTBUFFER_H__
+
+#include "Stream.h"
+
+namespace sb
+{
+
+	/// @brief Fixed-size buffer for writing to a stream
+	///	Collects small writes so that the stream only sees writes of the full buffer size. Anything
+	///		left in the buffer is written on Flush() or when the buffer is destroyed.
+	class OutputBuffer : NonCopyable
+	{
+	public:
+		enum { BUFFER_SIZE = 8 * 1024 };
+
+		explicit OutputBuffer(Stream& stream);
+		~OutputBuffer();
+
+		void Put(char c);
+		void Write(const void* data, size_t size);
+
+		/// @brief Returns room for writing at least size bytes directly to the buffer
+		///	The bytes written need to be committed with Commit().
+		///	@param size Number of bytes, at most BUFFER_SIZE
+		char* Reserve(size_t size);
+		void Commit(size_t size);
+
+		/// Writes all buffered data to the stream
+		void Flush();
+
+	private:
+		Stream& _stream;
+
+		size_t _size;
+		char _buffer[BUFFER_SIZE];
+	};
+
+	//-------------------------------------------------------------------------------
+	INLINE void OutputBuffer::Put(char c)
+	{
+		if (_size == BUFFER_SIZE)
+			Flush();
+		_buffer[_size++] = c;
+	}
+	INLINE char* OutputBuffer::Reserve(size_t size)
+	{
+		Assert(size <= BUFFER_SIZE);
+		if (BUFFER_SIZE - _size < size)
+			Flush();
+		return _buffer + _size;
+	}
+	INLINE void OutputBuffer::Commit(size_t size)
+	{
+		Assert(_size + size <= BUFFER_SIZE);
+		_size += size;
+	}
+	//-------------------------------------------------------------------------------
+
+} // namespace sb
+
+
+#endif // __FOUNDATION_OUTPUTBUFFER_H__
@@ -3,9 +3,6 @@
 #include "Common.h"
 
 #include "Json.h"
-#include "Filesystem/FileSource.h"
-#include "Filesystem/File.h"
-#include "IO/InputBuffer.h"
 #include "Container/ConfigValue.h"
 
 
@@ -16,100 +13,185 @@ namespace sb
 
 	namespace json_internal
 	{
-		void WriteTabs(int ilevel, stringstream& out);
-		void WriteString(const char* str, stringstream& out, bool quotes = true);
+		void WriteTabs(int ilevel, OutputBuffer& out);
+		void WriteString(const char* str, OutputBuffer& out, bool quotes = true);
+		void WriteBool(bool b, OutputBuffer& out);
+		void WriteInt(int64_t i, OutputBuffer& out);
+		void WriteUInt(uint64_t u, OutputBuffer& out);
+		void WriteDouble(double d, OutputBuffer& out);
 	}
 
 	//-------------------------------------------------------------------------------
-	json::Writer::Writer() : _ilevel(0)
+	json::Writer::Writer(Stream& out, bool format)
+		: _out(out),
+		_format(format),
+		_ilevel(0),
+		_has_elements(false),
+		_has_key(false)
 	{
 	}
 	json::Writer::~Writer()
 	{
 	}
-	void json::Writer::Write(const ConfigValue& root, stringstream& out, bool format)
+	void json::Writer::Write(const ConfigValue& root)
 	{
-		_format = format;
-		WriteValue(root, out);
-		out << "\n";
+		WriteValue(root);
+		_out.Put('\n');
 	}
-	void json::Writer::WriteValue(const ConfigValue& node, stringstream& out)
+	void json::Writer::Flush()
+	{
+		_out.Flush();
+	}
+	//-------------------------------------------------------------------------------
+	void json::Writer::BeginObject()
+	{
+		BeginValue();
+		_out.Put('{');
+		_ilevel++;
+		_has_elements = false;
+	}
+	void json::Writer::EndObject()
+	{
+		Assert(_ilevel > 0 && !_has_key);
+		_ilevel--;
+		if (_format && _has_elements)
+		{
+			_out.Put('\n');
+			json_internal::WriteTabs(_ilevel, _out);
+		}
+		_out.Put('}');
+
+		// The object itself is an element of its parent
+		_has_elements = true;
+	}
+	void json::Writer::BeginArray()
+	{
+		BeginValue();
+		_out.Put('[');
+		_ilevel++;
+		_has_elements = false;
+	}
+	void json::Writer::EndArray()
+	{
+		Assert(_ilevel > 0 && !_has_key);
+		_ilevel--;
+		if (_format && _has_elements)
+		{
+			_out.Put('\n');
+			json_internal::WriteTabs(_ilevel, _out);
+		}
+		_out.Put(']');
+
+		_has_elements = true;
+	}
+	void json::Writer::Key(const char* key)
+	{
+		Assert(_ilevel > 0 && !_has_key);
+		BeginValue();
+		_out.Put('"');
+		json_internal::WriteString(key, _out);
+		if (_format)
+			_out.Write("\": ", 3);
+		else
+			_out.Write("\":", 2);
+		_has_key = true;
+	}
+	void json::Writer::Null()
+	{
+		BeginValue();
+		_out.Write("null", 4);
+	}
+	void json::Writer::Bool(bool b)
+	{
+		BeginValue();
+		json_internal::WriteBool(b, _out);
+	}
+	void json::Writer::Int(int64_t i)
+	{
+		BeginValue();
+		json_internal::WriteInt(i, _out);
+	}
+	void json::Writer::UInt(uint64_t u)
+	{
+		BeginValue();
+		json_internal::WriteUInt(u, _out);
+	}
+	void json::Writer::Double(double d)
+	{
+		BeginValue();
+		json_internal::WriteDouble(d, _out);
+	}
+	void json::Writer::String(const char* str)
+	{
+		BeginValue();
+		_out.Put('"');
+		json_internal::WriteString(str, _out);
+		_out.Put('"');
+	}
+	//-------------------------------------------------------------------------------
+	void json::Writer::BeginValue()
+	{
+		if (_has_key)
+		{
+			// Value for the key just written
+			_has_key = false;
+			return;
+		}
+		if (_ilevel == 0)
+			return; // Root value
+
+		if (_has_elements)
+			_out.Put(',');
+		_has_elements = true;
+
+		if (_format)
+		{
+			_out.Put('\n');
+			json_internal::WriteTabs(_ilevel, _out);
+		}
+	}
+	void json::Writer::WriteValue(const ConfigValue& node)
 	{
 		switch (node.Type())
 		{
 		case ConfigValue::NULL_VALUE:
-			out << "null";
+			Null();
 			break;
 		case ConfigValue::BOOL:
-			out << node.AsBool();
+			Bool(node.AsBool());
 			break;
 		case ConfigValue::INTEGER:
-			out << node.AsInt64();
+			Int(node.AsInt64());
 			break;
 		case ConfigValue::UINTEGER:
-			out << node.AsUInt64();
+			UInt(node.AsUInt64());
 			break;
 		case ConfigValue::FLOAT:
-			out << node.AsDouble();
+			Double(node.AsDouble());
 			break;
 		case ConfigValue::STRING:
-			out << "\"";
-			json_internal::WriteString(node.AsString(), out);
-			out << "\"";
+			String(node.AsString());
 			break;
 		case ConfigValue::ARRAY:
 		{
-			out << "[";
-
-			_ilevel++;
+			BeginArray();
 			int size = node.Size();
 			for (int i = 0; i < size; ++i)
-			{
-				if (i != 0)
-					out << ",";
-
-				if (_format)
-				{
-					out << "\n";
-					json_internal::WriteTabs(_ilevel, out);
-				}
-				WriteValue(node[i], out);
-			}
-			if (_format)
-				out << "\n";
-			_ilevel--;
-			if (_format)
-				json_internal::WriteTabs(_ilevel, out);
-			out << "]";
+				WriteValue(node[i]);
+			EndArray();
 		}
 			break;
 		case ConfigValue::OBJECT:
 		{
-			out << "{";
-			_ilevel++;
+			BeginObject();
 			ConfigValue::ConstIterator it, end;
 			it = node.Begin(); end = node.End();
 			for (; it != end; ++it)
 			{
-				if (it != node.Begin())
-					out << ",";
-
-				if (_format)
-				{
-					out << "\n";
-					json_internal::WriteTabs(_ilevel, out);
-				}
-				out << "\"";
-				json_internal::WriteString(it->first.c_str(), out);
-				out << "\": ";
-				WriteValue(it->second, out);
+				Key(it->first.c_str());
+				WriteValue(it->second);
 			}
-			if (_format)
-				out << "\n";
-			_ilevel--;
-			if (_format)
-				json_internal::WriteTabs(_ilevel, out);
-			out << "}";
+			EndObject();
 		}
 			break;
 		};
@@ -15,24 +15,59 @@ namespace sb
 	{
 		typedef simplified_json::Reader Reader; // Simplified-JSON parser also works for standard JSON
 
+		/// @brief Writes JSON to a stream
+		///	Either writes a whole ConfigValue tree or single values through the streaming functions,
+		///		which allows writing large documents without building a tree first. Output is buffered
+		///		and written to the stream on Flush() or when the writer is destroyed.
 		class Writer
 		{
 		public:
-			Writer();
+			/// @param out Stream to write to
+			/// @param format Should we use any formatting. Formatting makes it more 
+			///			human readable, otherwise everything is just printed on one line.
+			Writer(Stream& out, bool format);
 			~Writer();
 
 			/// @brief Generates JSON from the specified ConfigValue
 			/// @param root Root config node
-			/// @param out The generated JSON will be stored in this variable
-			/// @param format Should we use any formatting. Formatting makes it more 
-			///			human readable, otherwise everything is just printed on one line.
-			void Write(const ConfigValue& root, stringstream& out, bool format);
+			void Write(const ConfigValue& root);
+
+			/// @name Streaming
+			/// @{
+
+			void BeginObject();
+			void EndObject();
+			void BeginArray();
+			void EndArray();
+
+			/// @brief Writes the key of the next object member
+			void Key(const char* key);
+
+			void Null();
+			void Bool(bool b);
+			void Int(int64_t i);
+			void UInt(uint64_t u);
+			/// @remark NaN and infinity have no JSON representation and are written as null
+			void Double(double d);
+			void String(const char* str);
+
+			/// @}
+
+			/// Writes any buffered output to the stream
+			void Flush();
 
 		private:
+			OutputBuffer _out;
 			bool _format;
 			int _ilevel; // Indent level
 
-			void WriteValue(const ConfigValue& node, stringstream& out);
+			bool _has_elements; // Whether the current array or object has any elements yet
+			bool _has_key; // Whether a key was just written and the next value belongs to it
+
+			/// Writes the separator and indentation before a value or key
+			void BeginValue();
+
+			void WriteValue(const ConfigValue& node);
 		};
 	};
 
@@ -0,0 +1,1155 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "JsonDocument.h"
+#include "Filesystem/FileSource.h"
+#include "Filesystem/File.h"
+#include "IO/FileInputBuffer.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define SANDBOX_JSON_SSE2
+#include <emmintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace sb
+{
+
+	namespace
+	{
+		enum CharClass
+		{
+			CLASS_WHITESPACE = 1,
+			CLASS_OPERATOR = 2, ///< { } [ ] : , =
+			CLASS_QUOTE = 4,
+			CLASS_BACKSLASH = 8
+		};
+
+		/// Characters ending an unquoted string or scalar
+		const uint8_t CLASS_SCALAR_END = CLASS_WHITESPACE | CLASS_OPERATOR | CLASS_QUOTE;
+
+		struct CharTable
+		{
+			uint8_t c[256];
+
+			CharTable()
+			{
+				memset(c, 0, sizeof(c));
+				c[' '] = c['\t'] = c['\r'] = c['\n'] = CLASS_WHITESPACE;
+				c['{'] = c['}'] = c['['] = c[']'] = c[':'] = c[','] = c['='] = CLASS_OPERATOR;
+				c['"'] = CLASS_QUOTE;
+				c['\\'] = CLASS_BACKSLASH;
+			}
+		};
+		const CharTable g_char_table;
+
+		INLINE uint8_t CharClassOf(char c)
+		{
+			return g_char_table.c[(uint8_t)c];
+		}
+
+		/// Masks for a 64 byte block, one bit per byte
+		struct BlockMasks
+		{
+			uint64_t whitespace;
+			uint64_t op;
+			uint64_t quote;
+			uint64_t backslash;
+		};
+
+		INLINE uint32_t TrailingZeros(uint64_t mask)
+		{
+#if defined(_MSC_VER) && defined(_M_X64)
+			unsigned long index;
+			_BitScanForward64(&index, mask);
+			return index;
+#elif defined(_MSC_VER)
+			unsigned long index;
+			if (_BitScanForward(&index, (uint32_t)mask))
+				return index;
+			_BitScanForward(&index, (uint32_t)(mask >> 32));
+			return index + 32;
+#else
+			return (uint32_t)__builtin_ctzll(mask);
+#endif
+		}
+
+		/// Each bit in the result is the XOR of all bits up to and including the same position in the input,
+		///	meaning all bits from an opening quote up to, but not including, the closing quote are set.
+		INLINE uint64_t PrefixXor(uint64_t mask)
+		{
+			mask ^= mask << 1;
+			mask ^= mask << 2;
+			mask ^= mask << 4;
+			mask ^= mask << 8;
+			mask ^= mask << 16;
+			mask ^= mask << 32;
+			return mask;
+		}
+
+#ifdef SANDBOX_JSON_SSE2
+		INLINE uint64_t CompareMask(const __m128i* v, __m128i c)
+		{
+			uint64_t m0 = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v[0], c));
+			uint64_t m1 = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v[1], c));
+			uint64_t m2 = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v[2], c));
+			uint64_t m3 = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v[3], c));
+			return m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+		}
+
+		void ClassifyBlock(const uint8_t* block, BlockMasks& masks)
+		{
+			__m128i v[4];
+			for (int i = 0; i < 4; ++i)
+				v[i] = _mm_loadu_si128((const __m128i*)(block + i * 16));
+
+			masks.whitespace = CompareMask(v, _mm_set1_epi8(' ')) | CompareMask(v, _mm_set1_epi8('\t'))
+				| CompareMask(v, _mm_set1_epi8('\r')) | CompareMask(v, _mm_set1_epi8('\n'));
+
+			// Setting bit 5 maps '[' and ']' to '{' and '}' so that brackets and braces need one compare each
+			__m128i bit5 = _mm_set1_epi8(0x20);
+			__m128i folded[4];
+			for (int i = 0; i < 4; ++i)
+				folded[i] = _mm_or_si128(v[i], bit5);
+
+			masks.op = CompareMask(folded, _mm_set1_epi8('{')) | CompareMask(folded, _mm_set1_epi8('}'))
+				| CompareMask(v, _mm_set1_epi8(':')) | CompareMask(v, _mm_set1_epi8(','))
+				| CompareMask(v, _mm_set1_epi8('='));
+
+			masks.quote = CompareMask(v, _mm_set1_epi8('"'));
+			masks.backslash = CompareMask(v, _mm_set1_epi8('\\'));
+		}
+#else
+		void ClassifyBlock(const uint8_t* block, BlockMasks& masks)
+		{
+			masks.whitespace = masks.op = masks.quote = masks.backslash = 0;
+			for (uint32_t i = 0; i < 64; ++i)
+			{
+				uint64_t bit = uint64_t(1) << i;
+				uint8_t c = g_char_table.c[block[i]];
+				if (c & CLASS_WHITESPACE)
+					masks.whitespace |= bit;
+				if (c & CLASS_OPERATOR)
+					masks.op |= bit;
+				if (c & CLASS_QUOTE)
+					masks.quote |= bit;
+				if (c & CLASS_BACKSLASH)
+					masks.backslash |= bit;
+			}
+		}
+#endif
+
+		/// Stage 1, finds the offsets of all operators outside strings, all opening quotes and the first
+		///	character of every unquoted scalar.
+		/// @param out Needs room for length entries
+		/// @return Number of offsets written
+		size_t FindStructurals(const char* doc, size_t length, uint32_t* out)
+		{
+			uint32_t* begin = out;
+
+			// State carried between blocks
+			uint64_t prev_escaped = 0; // Bit 0 set if the first character of the block is escaped
+			uint64_t prev_in_string = 0; // All bits set if the previous block ended within a string
+			uint64_t prev_scalar = 0; // Bit 0 set if the previous block ended within a scalar
+
+			uint8_t tail[64];
+			for (size_t offset = 0; offset < length; offset += 64)
+			{
+				const uint8_t* block = (const uint8_t*)doc + offset;
+				if (length - offset < 64)
+				{
+					// Pad the last block with whitespace, which never is structural
+					memset(tail, ' ', sizeof(tail));
+					memcpy(tail, block, length - offset);
+					block = tail;
+				}
+
+				BlockMasks masks;
+				ClassifyBlock(block, masks);
+
+				// A backslash escapes the next character unless it's escaped itself. Backslashes are
+				//	rare enough that walking them one by one is cheaper than resolving runs with bit tricks.
+				uint64_t escaped = prev_escaped;
+				prev_escaped = 0;
+				uint64_t backslash = masks.backslash;
+				while (backslash)
+				{
+					uint32_t i = TrailingZeros(backslash);
+					backslash &= backslash - 1;
+
+					uint64_t bit = uint64_t(1) << i;
+					if (escaped & bit)
+						continue;
+					if (i == 63)
+						prev_escaped = 1;
+					else
+						escaped |= bit << 1;
+				}
+
+				uint64_t quotes = masks.quote & ~escaped;
+				uint64_t in_string = PrefixXor(quotes) ^ prev_in_string;
+				prev_in_string = uint64_t(int64_t(in_string) >> 63);
+
+				// Unquoted keys may contain escaped whitespace and operators (e.g. "my\ key")
+				uint64_t scalar = (~(masks.whitespace | masks.op | quotes) | escaped) & ~in_string;
+				uint64_t scalar_start = scalar & ~((scalar << 1) | prev_scalar);
+				prev_scalar = scalar >> 63;
+
+				uint64_t structural = (masks.op & ~escaped & ~in_string) | (quotes & in_string) | scalar_start;
+				while (structural)
+				{
+					*out++ = uint32_t(offset + TrailingZeros(structural));
+					structural &= structural - 1;
+				}
+			}
+			return out - begin;
+		}
+
+		INLINE bool ParseHex4(const char* str, const char* end, uint32_t& value)
+		{
+			if (end - str < 4)
+				return false;
+
+			value = 0;
+			for (int i = 0; i < 4; ++i)
+			{
+				char c = str[i];
+				uint32_t digit;
+				if (c >= '0' && c <= '9')
+					digit = c - '0';
+				else if (c >= 'a' && c <= 'f')
+					digit = c - 'a' + 10;
+				else if (c >= 'A' && c <= 'F')
+					digit = c - 'A' + 10;
+				else
+					return false;
+				value = (value << 4) | digit;
+			}
+			return true;
+		}
+
+		/// @return Number of bytes written
+		INLINE uint32_t EncodeUtf8(uint32_t code_point, char* out)
+		{
+			if (code_point < 0x80)
+			{
+				out[0] = (char)code_point;
+				return 1;
+			}
+			if (code_point < 0x800)
+			{
+				out[0] = (char)(0xC0 | (code_point >> 6));
+				out[1] = (char)(0x80 | (code_point & 0x3F));
+				return 2;
+			}
+			if (code_point < 0x10000)
+			{
+				out[0] = (char)(0xE0 | (code_point >> 12));
+				out[1] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+				out[2] = (char)(0x80 | (code_point & 0x3F));
+				return 3;
+			}
+			out[0] = (char)(0xF0 | (code_point >> 18));
+			out[1] = (char)(0x80 | ((code_point >> 12) & 0x3F));
+			out[2] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+			out[3] = (char)(0x80 | (code_point & 0x3F));
+			return 4;
+		}
+
+		/// @return True if the range is a number as defined by the JSON grammar,
+		///	i.e. -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+		bool IsValidNumber(const char* c, const char* end)
+		{
+			if (c != end && *c == '-')
+				++c;
+
+			if (c == end || uint32_t(*c - '0') > 9)
+				return false;
+			if (*c++ != '0')
+			{
+				while (c != end && uint32_t(*c - '0') <= 9)
+					++c;
+			}
+
+			if (c != end && *c == '.')
+			{
+				++c;
+				if (c == end || uint32_t(*c - '0') > 9)
+					return false;
+				while (c != end && uint32_t(*c - '0') <= 9)
+					++c;
+			}
+
+			if (c != end && (*c == 'e' || *c == 'E'))
+			{
+				++c;
+				if (c != end && (*c == '+' || *c == '-'))
+					++c;
+				if (c == end || uint32_t(*c - '0') > 9)
+					return false;
+				while (c != end && uint32_t(*c - '0') <= 9)
+					++c;
+			}
+			return c == end;
+		}
+
+		struct KeyLess
+		{
+			const char* const* keys;
+
+			bool operator()(uint32_t a, uint32_t b) const
+			{
+				return strcmp(keys[a], keys[b]) < 0;
+			}
+		};
+	}
+
+	//-------------------------------------------------------------------------------
+	JsonValue::JsonValue()
+		: _node(nullptr)
+	{
+	}
+	JsonValue::JsonValue(const json::Node* node)
+		: _node(node)
+	{
+	}
+	//-------------------------------------------------------------------------------
+	JsonValue::ValueType JsonValue::Type() const
+	{
+		if (!_node)
+			return ConfigValue::NULL_VALUE;
+		return (ValueType)_node->type;
+	}
+	bool JsonValue::IsNull() const
+	{
+		return (Type() == ConfigValue::NULL_VALUE);
+	}
+	bool JsonValue::IsInt() const
+	{
+		return (Type() == ConfigValue::INTEGER);
+	}
+	bool JsonValue::IsUInt() const
+	{
+		return (Type() == ConfigValue::UINTEGER);
+	}
+	bool JsonValue::IsFloat() const
+	{
+		return (Type() == ConfigValue::FLOAT);
+	}
+	bool JsonValue::IsBool() const
+	{
+		return (Type() == ConfigValue::BOOL);
+	}
+	bool JsonValue::IsString() const
+	{
+		return (Type() == ConfigValue::STRING);
+	}
+	bool JsonValue::IsArray() const
+	{
+		return (Type() == ConfigValue::ARRAY);
+	}
+	bool JsonValue::IsObject() const
+	{
+		return (Type() == ConfigValue::OBJECT);
+	}
+	bool JsonValue::IsNumber() const
+	{
+		ValueType type = Type();
+		return (type == ConfigValue::INTEGER || type == ConfigValue::UINTEGER || type == ConfigValue::FLOAT);
+	}
+	//-------------------------------------------------------------------------------
+	int JsonValue::AsInt() const
+	{
+		return int(AsInt64());
+	}
+	int64_t JsonValue::AsInt64() const
+	{
+		switch (Type())
+		{
+		case ConfigValue::NULL_VALUE:
+			return 0;
+		case ConfigValue::INTEGER:
+			return _node->i;
+		case ConfigValue::UINTEGER:
+			return int64_t(_node->u);
+		case ConfigValue::FLOAT:
+			return int64_t(_node->d);
+		case ConfigValue::BOOL:
+			return (_node->b ? 1 : 0);
+		case ConfigValue::STRING:
+		case ConfigValue::ARRAY:
+		case ConfigValue::OBJECT:
+			Assert(false);
+		};
+		return 0;
+	}
+	uint32_t JsonValue::AsUInt() const
+	{
+		return uint32_t(AsUInt64());
+	}
+	uint64_t JsonValue::AsUInt64() const
+	{
+		switch (Type())
+		{
+		case ConfigValue::NULL_VALUE:
+			return 0;
+		case ConfigValue::INTEGER:
+			return uint64_t(_node->i);
+		case ConfigValue::UINTEGER:
+			return _node->u;
+		case ConfigValue::FLOAT:
+			return uint64_t(_node->d);
+		case ConfigValue::BOOL:
+			return (_node->b ? 1 : 0);
+		case ConfigValue::STRING:
+		case ConfigValue::ARRAY:
+		case ConfigValue::OBJECT:
+			Assert(false);
+		};
+		return 0;
+	}
+	float JsonValue::AsFloat() const
+	{
+		return float(AsDouble());
+	}
+	double JsonValue::AsDouble() const
+	{
+		switch (Type())
+		{
+		case ConfigValue::NULL_VALUE:
+			return 0.0;
+		case ConfigValue::INTEGER:
+			return double(_node->i);
+		case ConfigValue::UINTEGER:
+			return double(_node->u);
+		case ConfigValue::FLOAT:
+			return _node->d;
+		case ConfigValue::BOOL:
+			return (_node->b ? 1.0 : 0.0);
+		case ConfigValue::STRING:
+		case ConfigValue::ARRAY:
+		case ConfigValue::OBJECT:
+			Assert(false);
+		};
+		return 0.0;
+	}
+	bool JsonValue::AsBool() const
+	{
+		switch (Type())
+		{
+		case ConfigValue::NULL_VALUE:
+			return false;
+		case ConfigValue::INTEGER:
+			return _node->i != 0;
+		case ConfigValue::UINTEGER:
+			return _node->u != 0;
+		case ConfigValue::FLOAT:
+			return _node->d != 0.0;
+		case ConfigValue::BOOL:
+			return _node->b;
+		case ConfigValue::STRING:
+		case ConfigValue::ARRAY:
+		case ConfigValue::OBJECT:
+			Assert(false);
+		};
+		return false;
+	}
+	const char* JsonValue::AsString() const
+	{
+		Assert(IsString());
+		return _node->string;
+	}
+	uint32_t JsonValue::Size() const
+	{
+		if (!_node)
+			return 0;
+		return _node->size;
+	}
+	//-------------------------------------------------------------------------------
+	JsonValue::ConstIterator JsonValue::Begin() const
+	{
+		Assert(IsObject());
+		return ConstIterator(*this, 0);
+	}
+	JsonValue::ConstIterator JsonValue::End() const
+	{
+		Assert(IsObject());
+		return ConstIterator(*this, _node->size);
+	}
+	//-------------------------------------------------------------------------------
+	JsonValue JsonValue::operator[](const char* key) const
+	{
+		Assert(IsObject());
+
+		// Binary search the sorted keys
+		const char* const* keys = Keys();
+
+		uint32_t low = 0, high = _node->size;
+		while (low < high)
+		{
+			uint32_t mid = low + (high - low) / 2;
+			int cmp = strcmp(keys[mid], key);
+			if (cmp == 0)
+				return JsonValue(_node->children + mid);
+			if (cmp < 0)
+				low = mid + 1;
+			else
+				high = mid;
+		}
+		return JsonValue();
+	}
+	JsonValue JsonValue::operator[](int index) const
+	{
+		Assert(IsArray());
+		Assert(index >= 0 && (uint32_t)index < _node->size);
+		return JsonValue(_node->children + index);
+	}
+	//-------------------------------------------------------------------------------
+	void JsonValue::CopyTo(ConfigValue& value) const
+	{
+		switch (Type())
+		{
+		case ConfigValue::NULL_VALUE:
+			value.SetNull();
+			break;
+		case ConfigValue::INTEGER:
+			value.SetInt(_node->i);
+			break;
+		case ConfigValue::UINTEGER:
+			value.SetUInt(_node->u);
+			break;
+		case ConfigValue::FLOAT:
+			value.SetDouble(_node->d);
+			break;
+		case ConfigValue::BOOL:
+			value.SetBool(_node->b);
+			break;
+		case ConfigValue::STRING:
+			value.SetString(_node->string);
+			break;
+		case ConfigValue::ARRAY:
+			value.SetEmptyArray();
+			for (uint32_t i = 0; i < _node->size; ++i)
+				JsonValue(_node->children + i).CopyTo(value.Append());
+			break;
+		case ConfigValue::OBJECT:
+		{
+			value.SetEmptyObject();
+			const char* const* keys = Keys();
+			for (uint32_t i = 0; i < _node->size; ++i)
+				JsonValue(_node->children + i).CopyTo(value[keys[i]]);
+		}
+			break;
+		};
+	}
+	//-------------------------------------------------------------------------------
+	const char* const* JsonValue::Keys() const
+	{
+		return (const char* const*)(_node->children + _node->size);
+	}
+
+	//-------------------------------------------------------------------------------
+	JsonValueConstIterator::JsonValueConstIterator()
+		: _index(0)
+	{
+		_entry.first = nullptr;
+	}
+	JsonValueConstIterator::JsonValueConstIterator(const JsonValue& object, uint32_t index)
+		: _object(object),
+		_index(index)
+	{
+		SetEntry();
+	}
+	const JsonValueConstIterator::Entry& JsonValueConstIterator::operator*() const
+	{
+		Assert(_index < _object.Size());
+		return _entry;
+	}
+	const JsonValueConstIterator::Entry* JsonValueConstIterator::operator->() const
+	{
+		Assert(_index < _object.Size());
+		return &_entry;
+	}
+	JsonValueConstIterator& JsonValueConstIterator::operator++()
+	{
+		Assert(_index < _object.Size());
+		++_index;
+		SetEntry();
+		return *this;
+	}
+	JsonValueConstIterator JsonValueConstIterator::operator++(int)
+	{
+		JsonValueConstIterator iterator = *this;
+		++(*this);
+		return iterator;
+	}
+	bool JsonValueConstIterator::operator==(const JsonValueConstIterator& other) const
+	{
+		return (_object._node == other._object._node && _index == other._index);
+	}
+	bool JsonValueConstIterator::operator!=(const JsonValueConstIterator& other) const
+	{
+		return (_object._node != other._object._node || _index != other._index);
+	}
+	void JsonValueConstIterator::SetEntry()
+	{
+		if (_index < _object.Size())
+		{
+			_entry.first = _object.Keys()[_index];
+			_entry.second = JsonValue(_object._node->children + _index);
+		}
+		else
+		{
+			_entry.first = nullptr;
+			_entry.second = JsonValue();
+		}
+	}
+
+	//-------------------------------------------------------------------------------
+	JsonDocument::JsonDocument()
+		: _arena(64 * 1024),
+		_indices(nullptr),
+		_indices_capacity(0),
+		_doc(nullptr),
+		_length(0),
+		_strings(nullptr),
+		_index(nullptr),
+		_index_end(nullptr)
+	{
+		memset(&_root, 0, sizeof(_root));
+	}
+	JsonDocument::~JsonDocument()
+	{
+		if (_indices)
+			memory::Free(_indices);
+	}
+	//-------------------------------------------------------------------------------
+	bool JsonDocument::Read(const char* doc, size_t length)
+	{
+		_arena.Reset();
+		_error.clear();
+		memset(&_root, 0, sizeof(_root));
+
+		// Offsets into the document are stored as 32 bit
+		if (length >= 0xffffffff)
+		{
+			_error = "Document too large";
+			return false;
+		}
+
+		if (length > _indices_capacity)
+		{
+			if (_indices)
+				memory::Free(_indices);
+			_indices = (uint32_t*)memory::Malloc(length * sizeof(uint32_t));
+			_indices_capacity = length;
+		}
+
+		_doc = doc;
+		_length = length;
+		_strings = (char*)_arena.Allocate(length + 1, 1);
+		_index = _indices;
+		_index_end = _indices + FindStructurals(doc, length, _indices);
+
+		bool result;
+		if (_index != _index_end && (doc[*_index] == '{' || doc[*_index] == '['))
+		{
+			result = ParseValue(_root);
+			if (result && _index != _index_end)
+			{
+				Error(*_index, "Unexpected character after root value");
+				result = false;
+			}
+		}
+		else
+		{
+			// Assume root is an object
+			result = ParseObject(_root, true);
+		}
+
+		_scratch_nodes.Clear();
+		_scratch_keys.Clear();
+
+		if (!result)
+			memset(&_root, 0, sizeof(_root));
+		return result;
+	}
+	bool JsonDocument::ReadFile(FileSource* source, const char* file_name)
+	{
+		FileStreamPtr file = source->OpenFile(file_name, File::READ);
+		if (!file.Get())
+		{
+			stringstream ss; ss << "Failed to open file '" << file_name << "'";
+			_error = ss.str();
+			memset(&_root, 0, sizeof(_root));
+			return false;
+		}
+
+		FileInputBuffer buffer(file);
+		return Read((const char*)buffer.Ptr(), (size_t)buffer.Length());
+	}
+	JsonValue JsonDocument::Root() const
+	{
+		return JsonValue(&_root);
+	}
+	const string& JsonDocument::GetErrorMessage() const
+	{
+		return _error;
+	}
+	//-------------------------------------------------------------------------------
+	void JsonDocument::Error(size_t offset, const char* msg)
+	{
+		int line = 1;
+		size_t line_start = 0;
+		for (size_t i = 0; i < offset; ++i)
+		{
+			char c = _doc[i];
+			if (c == '\n' || (c == '\r' && (i + 1 == _length || _doc[i + 1] != '\n')))
+			{
+				++line;
+				line_start = i + 1;
+			}
+		}
+
+		stringstream ss; ss << "(Line: " << line << ", Column: " << (offset - line_start + 1) << ") Error: " << msg;
+		_error = ss.str();
+	}
+	//-------------------------------------------------------------------------------
+	bool JsonDocument::ParseValue(json::Node& node)
+	{
+		if (_index == _index_end)
+		{
+			Error(_length, "Expected value");
+			return false;
+		}
+
+		uint32_t offset = *_index++;
+		switch (_doc[offset])
+		{
+		case '{':
+			return ParseObject(node, false);
+		case '[':
+			return ParseArray(node);
+		case '"':
+			return ParseString(offset, node);
+		case '0':
+		case '1':
+		case '2':
+		case '3':
+		case '4':
+		case '5':
+		case '6':
+		case '7':
+		case '8':
+		case '9':
+		case '-':
+			return ParseNumber(offset, node);
+		case 't':
+		case 'f':
+		case 'n':
+			return ParseLiteral(offset, node);
+		};
+
+		Error(offset, "Unexpected character");
+		return false;
+	}
+	bool JsonDocument::ParseObject(json::Node& node, bool root)
+	{
+		size_t first_node = _scratch_nodes.Size();
+		size_t first_key = _scratch_keys.Size();
+		while (1)
+		{
+			if (_index == _index_end)
+			{
+				// Objects at the root level are ended by the end of the document
+				if (root)
+					break;
+
+				Error(_length, "Expected '}'");
+				return false;
+			}
+
+			char c = _doc[*_index];
+			if (c == '}' && !root)
+			{
+				++_index;
+				break;
+			}
+			if (c == ',') // Separator between elements (Optional)
+			{
+				++_index;
+				continue;
+			}
+
+			const char* key;
+			if (!ParseKey(key))
+				return false;
+
+			if (_index == _index_end || (_doc[*_index] != '=' && _doc[*_index] != ':'))
+			{
+				Error(_index == _index_end ? _length : *_index, "Expected '=' or ':'");
+				return false;
+			}
+			++_index;
+
+			json::Node value;
+			if (!ParseValue(value))
+				return false;
+
+			_scratch_nodes.PushBack(value);
+			_scratch_keys.PushBack(key);
+		}
+
+		CommitObject(node, first_node, first_key);
+		return true;
+	}
+	bool JsonDocument::ParseArray(json::Node& node)
+	{
+		size_t first = _scratch_nodes.Size();
+		while (1)
+		{
+			if (_index == _index_end)
+			{
+				Error(_length, "Expected ']'");
+				return false;
+			}
+
+			char c = _doc[*_index];
+			if (c == ']')
+			{
+				++_index;
+				break;
+			}
+			if (c == ',') // Separator between elements (Optional)
+			{
+				++_index;
+				continue;
+			}
+
+			json::Node value;
+			if (!ParseValue(value))
+				return false;
+
+			_scratch_nodes.PushBack(value);
+		}
+
+		CommitArray(node, first);
+		return true;
+	}
+	bool JsonDocument::ParseKey(const char*& key)
+	{
+		// Quotes around keys are optional
+		uint32_t offset = *_index;
+		if (CharClassOf(_doc[offset]) & CLASS_OPERATOR)
+		{
+			Error(offset, "Expected key");
+			return false;
+		}
+		++_index;
+
+		uint32_t length;
+		key = DecodeString(offset, length);
+		return (key != nullptr);
+	}
+	bool JsonDocument::ParseString(uint32_t offset, json::Node& node)
+	{
+		uint32_t length;
+		const char* str = DecodeString(offset, length);
+		if (!str)
+			return false;
+
+		node.type = ConfigValue::STRING;
+		node.size = length;
+		node.string = str;
+		return true;
+	}
+	bool JsonDocument::ParseNumber(uint32_t offset, json::Node& node)
+	{
+		uint32_t end = ScalarEnd(offset);
+		const char* c = _doc + offset;
+		const char* c_end = _doc + end;
+
+		// strtod accepts more than JSON does (e.g. hex, INF and NAN)
+		if (!IsValidNumber(c, c_end))
+		{
+			Error(offset, "Invalid number");
+			return false;
+		}
+
+		bool negative = (*c == '-');
+		if (negative)
+			++c;
+
+		// Integers are parsed directly, anything else (fractions, exponents or integers too
+		//	large for 64 bits) is left to strtod.
+		bool integer = (c != c_end);
+		uint64_t number = 0;
+		for (; c != c_end; ++c)
+		{
+			uint32_t digit = uint32_t(*c - '0');
+			if (digit > 9 || number > (UINT64_MAX - digit) / 10)
+			{
+				integer = false;
+				break;
+			}
+			number = number * 10 + digit;
+		}
+
+		node.size = 1;
+		if (integer)
+		{
+			if (!negative && number <= INT64_MAX)
+			{
+				node.type = ConfigValue::INTEGER;
+				node.i = int64_t(number);
+				return true;
+			}
+			if (!negative)
+			{
+				node.type = ConfigValue::UINTEGER;
+				node.u = number;
+				return true;
+			}
+			if (number <= uint64_t(INT64_MAX) + 1)
+			{
+				node.type = ConfigValue::INTEGER;
+				node.i = -int64_t(number - 1) - 1;
+				return true;
+			}
+		}
+
+		char buffer[64];
+		size_t length = end - offset;
+		if (length < sizeof(buffer))
+		{
+			memcpy(buffer, _doc + offset, length);
+			buffer[length] = '\0';
+
+			char* number_end;
+			double d = strtod(buffer, &number_end);
+			if (number_end == buffer + length)
+			{
+				node.type = ConfigValue::FLOAT;
+				node.d = d;
+				return true;
+			}
+		}
+
+		Error(offset, "Invalid number");
+		return false;
+	}
+	bool JsonDocument::ParseLiteral(uint32_t offset, json::Node& node)
+	{
+		uint32_t length = ScalarEnd(offset) - offset;
+		const char* str = _doc + offset;
+
+		if (length == 4 && memcmp(str, "true", 4) == 0)
+		{
+			node.type = ConfigValue::BOOL;
+			node.size = 1;
+			node.u = 0;
+			node.b = true;
+			return true;
+		}
+		if (length == 5 && memcmp(str, "false", 5) == 0)
+		{
+			node.type = ConfigValue::BOOL;
+			node.size = 1;
+			node.u = 0;
+			node.b = false;
+			return true;
+		}
+		if (length == 4 && memcmp(str, "null", 4) == 0)
+		{
+			node.type = ConfigValue::NULL_VALUE;
+			node.size = 0;
+			node.u = 0;
+			return true;
+		}
+
+		Error(offset, "Expected \"true\", \"false\" or \"null\"");
+		return false;
+	}
+	//-------------------------------------------------------------------------------
+	const char* JsonDocument::DecodeString(uint32_t offset, uint32_t& length)
+	{
+		const char* src = _doc + offset;
+		const char* end = _doc + _length;
+
+		// A string without quotes is considered to end at the first whitespace, operator or quote
+		bool quotes = (*src == '"');
+		if (quotes)
+			++src;
+
+		// Decoded strings are never longer than in the document, storing them at the same offset
+		//	(after the opening quote) means that they can never overlap.
+		char* str = _strings + (src - _doc);
+		char* dst = str;
+		while (1)
+		{
+			if (src == end)
+			{
+				if (quotes)
+				{
+					Error(offset, "Unterminated string");
+					return nullptr;
+				}
+				break;
+			}
+
+			char c = *src;
+			if (quotes ? (c == '"') : (CharClassOf(c) & CLASS_SCALAR_END) != 0)
+				break;
+			++src;
+
+			if (c == '\\')
+			{
+				if (src == end)
+				{
+					Error(offset, "Unterminated string");
+					return nullptr;
+				}
+
+				char esc = *src++;
+				switch (esc)
+				{
+				case 'n':
+					c = '\n';
+					break;
+				case 'r':
+					c = '\r';
+					break;
+				case 't':
+					c = '\t';
+					break;
+				case 'b':
+					c = '\b';
+					break;
+				case 'f':
+					c = '\f';
+					break;
+				case 'u':
+				{
+					uint32_t code_point;
+					if (!ParseHex4(src, end, code_point))
+					{
+						Error(offset, "Invalid unicode escape sequence");
+						return nullptr;
+					}
+					src += 4;
+
+					// Combine surrogate pairs
+					uint32_t low;
+					if (code_point >= 0xD800 && code_point < 0xDC00 && end - src >= 6 && src[0] == '\\' && src[1] == 'u'
+						&& ParseHex4(src + 2, end, low) && low >= 0xDC00 && low < 0xE000)
+					{
+						code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+						src += 6;
+					}
+					dst += EncodeUtf8(code_point, dst);
+					continue;
+				}
+				default:
+					// '"', '\\', '/' and any escaped whitespace or operator in unquoted strings
+					c = esc;
+				};
+			}
+
+			*dst++ = c;
+		}
+		*dst = '\0';
+
+		length = uint32_t(dst - str);
+		return str;
+	}
+	uint32_t JsonDocument::ScalarEnd(uint32_t offset) const
+	{
+		const char* c = _doc + offset;
+		const char* end = _doc + _length;
+		while (c != end && !(CharClassOf(*c) & CLASS_SCALAR_END))
+			++c;
+		return uint32_t(c - _doc);
+	}
+	//-------------------------------------------------------------------------------
+	void JsonDocument::CommitArray(json::Node& node, size_t first)
+	{
+		uint32_t count = uint32_t(_scratch_nodes.Size() - first);
+
+		node.type = ConfigValue::ARRAY;
+		node.size = count;
+		node.children = nullptr;
+		if (count)
+		{
+			json::Node* children = (json::Node*)_arena.Allocate(count * sizeof(json::Node));
+			memcpy(children, _scratch_nodes.Ptr() + first, count * sizeof(json::Node));
+			node.children = children;
+		}
+
+		_scratch_nodes.Resize(first);
+	}
+	void JsonDocument::CommitObject(json::Node& node, size_t first_node, size_t first_key)
+	{
+		uint32_t count = uint32_t(_scratch_nodes.Size() - first_node);
+		const json::Node* values = _scratch_nodes.Ptr() + first_node;
+		const char* const* keys = _scratch_keys.Ptr() + first_key;
+
+		// Members are usually already sorted and unique, otherwise sort them by key with the last
+		//	of any duplicates winning, same as when assigning them to a ConfigValue one by one.
+		bool sorted = true;
+		for (uint32_t i = 1; i < count && sorted; ++i)
+			sorted = (strcmp(keys[i - 1], keys[i]) < 0);
+
+		uint32_t size = count;
+		if (!sorted)
+		{
+			_scratch_order.Resize(count);
+			uint32_t* order = _scratch_order.Ptr();
+			for (uint32_t i = 0; i < count; ++i)
+				order[i] = i;
+
+			KeyLess less = { keys };
+			std::stable_sort(order, order + count, less);
+
+			size = 0;
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				if (i + 1 < count && strcmp(keys[order[i]], keys[order[i + 1]]) == 0)
+					continue;
+				order[size++] = order[i];
+			}
+		}
+
+		node.type = ConfigValue::OBJECT;
+		node.size = size;
+		node.children = nullptr;
+		if (size)
+		{
+			json::Node* children = (json::Node*)_arena.Allocate(size * (sizeof(json::Node) + sizeof(const char*)));
+			const char** member_keys = (const char**)(children + size);
+			if (sorted)
+			{
+				memcpy(children, values, size * sizeof(json::Node));
+				memcpy(member_keys, keys, size * sizeof(const char*));
+			}
+			else
+			{
+				const uint32_t* order = _scratch_order.Ptr();
+				for (uint32_t i = 0; i < size; ++i)
+				{
+					children[i] = values[order[i]];
+					member_keys[i] = keys[order[i]];
+				}
+			}
+			node.children = children;
+		}
+
+		_scratch_nodes.Resize(first_node);
+		_scratch_keys.Resize(first_key);
+	}
+	//-------------------------------------------------------------------------------
+
+} // namespace sb
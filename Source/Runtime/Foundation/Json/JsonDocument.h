@@ -0,0 +1,213 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __FOUNDATION_JSONDOCUMENT_H__
+#define __FOUNDATION_JSONDOCUMENT_H__
+
+#include "Container/ConfigValue.h"
+#include "Container/Vector.h"
+
+namespace sb
+{
+
+	class FileSource;
+
+	namespace json
+	{
+		/// Value in a parsed JSON document, allocated from the arena of the document
+		struct Node
+		{
+			uint32_t type; ///< ConfigValue::ValueType
+			uint32_t size; ///< String length or number of children
+			union
+			{
+				int64_t i;
+				uint64_t u;
+				double d;
+				bool b;
+				const char* string;
+				/// Children of an array or object. Object members are sorted by key and the
+				///	array of children is directly followed by an array with the key for each member.
+				const Node* children;
+			};
+		};
+	};
+
+	class JsonValueConstIterator;
+
+	/// @brief Read-only view of a value in a JsonDocument
+	///	Has the same read API as ConfigValue. Views are small and passed by value, they stay valid
+	///		until the document is destroyed or parses another document. Looking up a key that
+	///		doesn't exist gives a null value.
+	class JsonValue
+	{
+	public:
+		typedef ConfigValue::ValueType ValueType;
+		typedef JsonValueConstIterator ConstIterator;
+
+	public:
+		JsonValue();
+		explicit JsonValue(const json::Node* node);
+
+		ValueType Type() const;
+
+		bool IsNull() const;
+		bool IsInt() const;
+		bool IsUInt() const;
+		bool IsFloat() const;
+		bool IsBool() const;
+		bool IsString() const;
+		bool IsArray() const;
+		bool IsObject() const;
+
+		/// @return True if value is a number, meaning either an integer, unsigned integer or float
+		bool IsNumber() const;
+
+
+		int AsInt() const;
+		int64_t AsInt64() const;
+		uint32_t AsUInt() const;
+		uint64_t AsUInt64() const;
+		float AsFloat() const;
+		double AsDouble() const;
+		bool AsBool() const;
+		const char* AsString() const;
+
+		/// @brief Returns the size of this value, the number of sub elements
+		/// @return Number of sub elements if either an array or an object.
+		///			If the value is a single element type this returns 1, and if
+		///			the value is NULL it returns 0.
+		uint32_t Size() const;
+
+		/// @brief Returns an iterator for the beginning of all object elements
+		/// @remark This only works if the value is of the type OBJECT
+		ConstIterator Begin() const;
+
+		/// @brief Returns the end iterator for the object elements
+		/// @remark This only works if the value is of the type OBJECT
+		ConstIterator End() const;
+
+		/// @brief Looks up an object member, O(log n) in the number of members
+		JsonValue operator[](const char* key) const;
+		JsonValue operator[](int index) const;
+
+		/// @brief Copies this value and all its children into a ConfigValue tree
+		void CopyTo(ConfigValue& value) const;
+
+	private:
+		const json::Node* _node;
+
+		const char* const* Keys() const;
+
+		friend class JsonValueConstIterator;
+	};
+
+	class JsonValueConstIterator
+	{
+	public:
+		struct Entry
+		{
+			const char* first;
+			JsonValue second;
+		};
+
+		JsonValueConstIterator();
+		JsonValueConstIterator(const JsonValue& object, uint32_t index);
+
+		const Entry& operator*() const;
+		const Entry* operator->() const;
+
+		JsonValueConstIterator& operator++();
+		JsonValueConstIterator operator++(int);
+
+		bool operator==(const JsonValueConstIterator& other) const;
+		bool operator!=(const JsonValueConstIterator& other) const;
+
+	private:
+		JsonValue _object;
+		uint32_t _index;
+		Entry _entry;
+
+		void SetEntry();
+	};
+
+	///
+	///	Parsed JSON or simplified-JSON document
+	///
+	///	Parsing is done in two stages:
+	///	- Stage 1 classifies the document 64 bytes at a time, using SSE2 where available, and
+	///		builds an index of all structural characters and the start of every string and scalar.
+	///		Quotes and escapes are resolved with bit operations so that nothing within a string
+	///		is mistaken for structure.
+	///	- Stage 2 walks the index and builds the value tree. All nodes and strings are allocated
+	///		from an arena owned by the document, which is reused when parsing the next document.
+	///
+	///	Both standard JSON and the simplified-JSON dialect (see SimplifiedJson.h) are accepted.
+	///
+	class JsonDocument : NonCopyable
+	{
+	public:
+		JsonDocument();
+		~JsonDocument();
+
+		/// Parses a JSON or simplified-JSON document
+		///	@param doc Document, doesn't need to be null-terminated and isn't referenced after parsing
+		///	@return True if the parsing was successful, else false
+		bool Read(const char* doc, size_t length);
+
+		/// Reads a JSON or simplified-JSON document from a file
+		///	@return True if the parsing was successful, else false
+		bool ReadFile(FileSource* source, const char* file_name);
+
+		/// @return The root value, always an object or an array after a successful parse
+		JsonValue Root() const;
+
+		/// Returns an error message if the last call to Read or ReadFile failed.
+		const string& GetErrorMessage() const;
+
+	private:
+		LinearAllocator _arena;
+		json::Node _root;
+
+		/// Offsets of all structural characters found by stage 1
+		uint32_t* _indices;
+		size_t _indices_capacity;
+
+		/// Children of all containers currently being parsed, moved to the arena once a container is closed
+		Vector<json::Node> _scratch_nodes;
+		Vector<const char*> _scratch_keys;
+		Vector<uint32_t> _scratch_order;
+
+		const char* _doc;
+		size_t _length;
+		char* _strings; ///< Decoded strings, each string is stored at the same offset as in the document
+		const uint32_t* _index;
+		const uint32_t* _index_end;
+
+		string _error;
+
+		void Error(size_t offset, const char* msg);
+
+		bool ParseValue(json::Node& node);
+		bool ParseObject(json::Node& node, bool root);
+		bool ParseArray(json::Node& node);
+		bool ParseKey(const char*& key);
+		bool ParseString(uint32_t offset, json::Node& node);
+		bool ParseNumber(uint32_t offset, json::Node& node);
+		bool ParseLiteral(uint32_t offset, json::Node& node);
+
+		/// Decodes a quoted or unquoted string into the string buffer
+		///	@return Null-terminated string, or null if the string was invalid
+		const char* DecodeString(uint32_t offset, uint32_t& length);
+
+		/// @return Offset of the end of the scalar starting at the specified offset
+		uint32_t ScalarEnd(uint32_t offset) const;
+
+		/// Moves the children from the scratch stack to the arena
+		void CommitArray(json::Node& node, size_t first);
+		void CommitObject(json::Node& node, size_t first_node, size_t first_key);
+	};
+
+} // namespace sb
+
+
+#endif // __FOUNDATION_JSONDOCUMENT_H__
@@ -3,10 +3,9 @@
 #include "Common.h"
 
 #include "SimplifiedJson.h"
-#include "Filesystem/FileSource.h"
-#include "Filesystem/File.h"
-#include "IO/FileInputBuffer.h"
+#include "JsonDocument.h"
 #include "Container/ConfigValue.h"
+#include "Container/StringUtil.h"
 
 
 namespace sb
@@ -15,7 +14,6 @@ namespace sb
 	//-------------------------------------------------------------------------------
 	simplified_json::Reader::Reader()
 	{
-		_cur = _end = _begin = 0;
 	}
 	simplified_json::Reader::~Reader()
 	{
@@ -25,538 +23,239 @@ namespace sb
 	{
 		return _error;
 	}
-	void simplified_json::Reader::Error(const char* msg)
-	{
-		int line, column;
-		GetCurrentPosition(line, column);
-
-		stringstream ss; ss << "(Line: " << line << ", Column: " << column << ") Error: " << msg;
-		_error = ss.str();
-	}
-	void simplified_json::Reader::GetCurrentPosition(int& line, int& column)
-	{
-		line = 0; column = 0;
-
-		const char* current = _begin;
-		const char* line_start = _begin;
-		while (current < _cur)
-		{
-			if (*current == '\r')
-			{
-				if (*(current + 1) == '\n')
-					++current;
-
-				line_start = current;
-				++line;
-			}
-			else if (*current == '\n')
-			{
-				line_start = current;
-				++line;
-			}
-			++current;
-		}
-		++line;
-		column = (int)(_cur - line_start) - 1;
-	}
 	//-------------------------------------------------------------------------------
 	bool simplified_json::Reader::Read(const char* doc, int64_t length, ConfigValue& root)
 	{
-		_cur = _begin = doc;
-		_end = doc + length;
-
-		SkipSpaces();
-		if (*_cur == '{')
-			return ParseObject(root);
-
-		// Assume root is an object
-		root.SetEmptyObject();
-
-		string name;
-		while (1)
+		JsonDocument document;
+		if (!document.Read(doc, (size_t)length))
 		{
-			SkipSpaces();
-			if (_cur == _end)
-				break;
-
-
-			name = "";
-			if (!ParseString(name))
-			{
-				Error("Failed to parse string");
-				return false;
-			}
-
-			SkipSpaces();
-			if (*_cur != '=' && *_cur != ':')
-			{
-				Error("Expected '=' or ':'");
-				return false;
-			}
-			_cur++;
-
-			ConfigValue& elem = root[name.c_str()];
-			if (!ParseValue(elem))
-			{
-				return false; // Failed to parse value
-			}
-
-			SkipSpaces();
-
-			char c = *_cur;
-			if (c == ',') // Separator between elements (Optional)
-			{
-				_cur++;
-				continue;
-			}
+			_error = document.GetErrorMessage();
+			return false;
 		}
 
+		document.Root().CopyTo(root);
 		return true;
 	}
 	bool simplified_json::Reader::ReadFile(FileSource* source, const char* file_name, ConfigValue& root)
 	{
-		// and then load any settings from settings file
-		FileStreamPtr file = source->OpenFile(file_name, File::READ);
-		if (!file.Get())
+		JsonDocument document;
+		if (!document.ReadFile(source, file_name))
 		{
-			stringstream ss; ss << "Failed to open file '" << file_name << "'";
-			_error = ss.str();
+			_error = document.GetErrorMessage();
 			return false;
 		}
 
-		bool res = true;
-
-		FileInputBuffer buffer(file);
-		if (buffer.Length() == 0)
-		{
-			// Empty file, just set root as empty object
-			root.SetEmptyObject();
-			res = true;
-		}
-		else
-			res = Read((const char*)buffer.Ptr(), buffer.Length(), root);
-
-		return res;
+		document.Root().CopyTo(root);
+		return true;
 	}
+	//-------------------------------------------------------------------------------
 
-	void simplified_json::Reader::SkipSpaces()
+	namespace json_internal
 	{
-		while (_cur != _end)
+		void WriteTabs(int ilevel, OutputBuffer& out)
 		{
-			char c = *_cur;
-			if (c == ' ' || c == '\t' || c == '\r' || c == '\n')
+			for (int i = 0; i < ilevel; ++i)
 			{
-				++_cur;
+				out.Put('\t');
 			}
-			else
-				break;
 		}
-	}
-
-	bool simplified_json::Reader::ParseString(string& str)
-	{
-		// Typically a string is surrounded by quotes but we also support strings without quotes
-		//	a string without quotes is considered to end at the first whitespace character (E.g. ' ' or '\t')
 
-		// Count length first
-		const char* str_end = _cur;
-		bool quotes = (*_cur == '"'); // Keep track if this string is surrounded by quotes
-		if (quotes)
-			++str_end; // Skip starting "
-		while (str_end != _end)
-		{
-			char c = *str_end++;
-			if (c == '\\')
-				str_end++; // Skip checking next character	
-			else if ((quotes && (c == '"')) || (!quotes && (c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '=' || c == ':')))
-				break;
-		}
-		if (quotes)
+		/// @param quotes Specifies whetever the string is supposed to be surrounded by quotes
+		void WriteString(const char* str, OutputBuffer& out, bool quotes = true)
 		{
-			_cur += 1; // Skip starting "
-		}
-		str_end -= 1; // Skip trailing " or any trailing whitespace
+			static const char hex[] = "0123456789abcdef";
 
-		while (_cur != str_end)
-		{
-			char c = *_cur++;
-			if (c == '\\')
+			// We need to escape any special characters before writing them to the JSON doc,
+			//	everything in between is written in runs.
+			const char* run = str;
+			const char* c = str;
+			for (; *c != '\0'; ++c)
 			{
-				char esc = *_cur++;
-				switch (esc)
+				char escape;
+				switch (*c)
 				{
-				case '"':
-					c = '"';
-					break;
-				case '/':
-					c = '/';
-					break;
 				case '\\':
-					c = '\\';
+				case '\"':
+					escape = *c;
 					break;
 				case '\n':
-					c = '\n';
+					escape = 'n';
 					break;
 				case '\r':
-					c = '\r';
+					escape = 'r';
 					break;
 				case '\t':
-					c = '\t';
+					escape = 't';
+					break;
+				case '\b':
+					escape = 'b';
+					break;
+				case '\f':
+					escape = 'f';
+					break;
+				case ' ':
+				case '=':
+				case ':':
+				case ',':
+				case '{':
+				case '}':
+				case '[':
+				case ']':
+					// Operators would end a string that isn't surrounded by quotes
+					if (quotes)
+						continue;
+					escape = *c;
 					break;
 				default:
-					c = esc;
-				};
-			}
-
-			str += c;
-		}
-		if (quotes)
-			_cur++; // Trailing "
-
-		return true;
-	}
-
-	bool simplified_json::Reader::ParseObject(ConfigValue& value)
-	{
-		value.SetEmptyObject();
-
-		_cur++; // Skip '{'
-		SkipSpaces();
-		if (*_cur == '}') // Empty object
-		{
-			_cur++;
-			return true;
-		}
-
-		string name;
-		while (1)
-		{
-			SkipSpaces();
-
-			name = "";
-			if (!ParseString(name))
-			{
-				Error("Failed to parse string");
-				break; // Failed to parse string
-			}
-
-			SkipSpaces();
-			if (*_cur != '=' && *_cur != ':')
-			{
-				Error("Expected '=' or ':'");
-				return false;
-			}
-			_cur++;
-
-			ConfigValue& elem = value[name.c_str()];
-			if (!ParseValue(elem))
-				break; // Failed to parse value
-
-			SkipSpaces();
-
-			char c = *_cur;
-			if (c == ',') // Separator between elements (Optional)
-			{
-				_cur++;
-				continue;
-			}
-			if (c == '}') // End of object
-			{
-				_cur++;
-				return true;
-			}
-		}
-
-		return false;
-	}
-	bool simplified_json::Reader::ParseArray(ConfigValue& value)
-	{
-		value.SetEmptyArray();
-
-		_cur++; // Skip '['
-		SkipSpaces();
-		if (*_cur == ']')
-		{
-			_cur++;
-			return true;
-		}
-		while (1)
-		{
-			ConfigValue& elem = value.Append();
-
-			if (!ParseValue(elem))
-				return false;
+					if ((unsigned char)*c >= 0x20)
+						continue;
+					escape = 'u';
+					break;
+				}
 
-			SkipSpaces();
+				out.Write(run, c - run);
+				run = c + 1;
 
-			char c = *_cur;
-			if (c == ',') // Separator between elements (Optional)
-			{
-				_cur++;
-				continue;
-			}
-			if (c == ']') // End of array
-			{
-				_cur++;
-				break;
+				out.Put('\\');
+				out.Put(escape);
+				if (escape == 'u')
+				{
+					char* dst = out.Reserve(4);
+					dst[0] = '0';
+					dst[1] = '0';
+					dst[2] = hex[(*c >> 4) & 0xf];
+					dst[3] = hex[*c & 0xf];
+					out.Commit(4);
+				}
 			}
+			out.Write(run, c - run);
 		}
-		return true;
-	}
 
-
-	bool simplified_json::Reader::ParseDouble(ConfigValue& value)
-	{
-		char* number_end;
-		double number = std::strtod(_cur, &number_end);
-		value.SetDouble(number);
-		_cur = number_end;
-		return true;
-	}
-
-	bool simplified_json::Reader::ParseNumber(ConfigValue& value)
-	{
-		bool integer = true; // Number is either integer or float
-		for (const char* c = _cur; c != _end; ++c)
+		void WriteBool(bool b, OutputBuffer& out)
 		{
-			if ((*c >= '0' && *c <= '9') || ((*c == '-' || *c == '+') && (c == _cur))) // Allow a negative sign at the start for integers
-				continue;
-			else if (*c == '.' || *c == 'e' || *c == 'E' || *c == '+')
-			{
-				integer = false;
-				break;
-			}
+			if (b)
+				out.Write("true", 4);
 			else
-				break;
+				out.Write("false", 5);
 		}
-		if (!integer)
-			return ParseDouble(value);
-
-
-		bool negative = (*_cur == '-');
-		if (negative)
-			_cur++;
 
-		uint64_t number = 0;
-		while (_cur != _end)
+		void WriteInt(int64_t i, OutputBuffer& out)
 		{
-			if (*_cur >= '0' && *_cur <= '9')
-			{
-				uint32_t digit = *_cur - '0';
-				number = number * 10 + digit;
-				_cur++;
-			}
-			else
-				break;
+			char* dst = out.Reserve(32);
+			out.Commit(string_util::FormatInt(dst, i));
 		}
-		if (negative)
-		{
-			value.SetInt(-int64_t(number));
-		}
-		else if (number <= INT64_MAX)
-		{
-			value.SetInt(int64_t(number));
-		}
-		else
-		{
-			value.SetUInt(number);
-		}
-
-		return true;
-	}
 
-	bool simplified_json::Reader::ParseValue(ConfigValue& value)
-	{
-		SkipSpaces();
-		bool b = true;
-		char c = *_cur;
-		switch (c)
-		{
-		case '{':
-			b = ParseObject(value);
-			break;
-		case '[':
-			b = ParseArray(value);
-			break;
-		case '"':
+		void WriteUInt(uint64_t u, OutputBuffer& out)
 		{
-			string str;
-			b = ParseString(str);
-			if (b)
-				value.SetString(str.c_str());
-			else
-				Error("Failed to parse string");
+			char* dst = out.Reserve(32);
+			out.Commit(string_util::FormatUInt(dst, u));
 		}
-			break;
-		case '0':
-		case '1':
-		case '2':
-		case '3':
-		case '4':
-		case '5':
-		case '6':
-		case '7':
-		case '8':
-		case '9':
-		case '-':
-			b = ParseNumber(value);
-			break;
-		case 't': // true
-			if (*(++_cur) != 'r' || *(++_cur) != 'u' || *(++_cur) != 'e')
-			{
-				Error("Expected \"true\"");
-				return false;
-			}
-			++_cur;
-			value.SetBool(true);
-			break;
-		case 'f': // false
-			if (*(++_cur) != 'a' || *(++_cur) != 'l' || *(++_cur) != 's' || *(++_cur) != 'e')
-			{
-				Error("Expected \"false\"");
-				return false;
-			}
-			++_cur;
-			value.SetBool(false);
-			break;
-		case 'n': // null
-			if (*(++_cur) != 'u' || *(++_cur) != 'l' || *(++_cur) != 'l')
-			{
-				Error("Expected \"null\"");
-				return false;
-			}
-			++_cur;
-			value.SetNull();
-			break;
-		default:
-			b = false;
-		};
-		return b;
-	}
-	//-------------------------------------------------------------------------------
 
-	namespace json_internal
-	{
-		void WriteTabs(int ilevel, stringstream& out)
+		void WriteDouble(double d, OutputBuffer& out)
 		{
-			for (int i = 0; i < ilevel; ++i)
+			// JSON has no representation of NaN or infinity
+			if (d != d || d - d != 0.0)
 			{
-				out << "\t";
+				out.Write("null", 4);
+				return;
 			}
+			char* dst = out.Reserve(32);
+			out.Commit(string_util::FormatDouble(dst, d));
 		}
 
-		/// @param quotes Specifies whetever the string is supposed to be surrounded by quotes
-		void WriteString(const char* str, stringstream& out, bool quotes = true)
+		/// Writes a key for a simplified-JSON document, unquoted if possible
+		void WriteKey(const char* key, OutputBuffer& out)
 		{
-			// We need to escape any special characters before writing them to the JSON doc
-			for (const char* c = str; *c != '\0'; ++c)
+			if (*key == '\0')
 			{
-				switch (*c)
-				{
-				case '\\':
-					out << "\\\\";
-					break;
-				case '\"':
-					out << "\\\"";
-					break;
-				case '\n':
-					out << "\\n";
-					break;
-				case '\r':
-					out << "\\r";
-					break;
-				case '\t':
-					out << "\\t";
-					break;
-				case ' ':
-					if (!quotes) // If string isn't supposed to be surrouneded by quotes, we escape spaces
-						out << "\\ ";
-					else
-						out << " ";
-					break;
-				default:
-					out << *c;
-					break;
-
-				}
+				out.Write("\"\"", 2);
+				return;
 			}
+			WriteString(key, out, false);
 		}
-
 	}
 
 	//-------------------------------------------------------------------------------
-	simplified_json::Writer::Writer() : _format(false), _ilevel(0)
+	simplified_json::Writer::Writer(Stream& out, bool format)
+		: _out(out),
+		_format(format),
+		_ilevel(0)
 	{
 	}
 	simplified_json::Writer::~Writer()
 	{
 	}
-	void simplified_json::Writer::Write(const ConfigValue& root, stringstream& out, bool format)
+	void simplified_json::Writer::Write(const ConfigValue& root)
 	{
-		_format = format;
 		ConfigValue::ConstIterator it, end;
 		it = root.Begin(); end = root.End();
 		for (; it != end; ++it)
 		{
-			if (_format)
-				json_internal::WriteTabs(_ilevel, out);
-			json_internal::WriteString(it->first.c_str(), out, false);
-			out << " = ";
-			WriteValue(it->second, out);
-			if (!format)
-				out << " ";
+			json_internal::WriteKey(it->first.c_str(), _out);
+			_out.Write(" = ", 3);
+			WriteValue(it->second);
+			_out.Put(_format ? '\n' : ' ');
 		}
-		out << "\n";
+		_out.Put('\n');
 	}
-	void simplified_json::Writer::WriteValue(const ConfigValue& node, stringstream& out)
+	void simplified_json::Writer::Flush()
+	{
+		_out.Flush();
+	}
+	void simplified_json::Writer::WriteValue(const ConfigValue& node)
 	{
 		switch (node.Type())
 		{
 		case ConfigValue::NULL_VALUE:
-			out << "null";
+			_out.Write("null", 4);
 			break;
 		case ConfigValue::BOOL:
-			out << node.AsBool();
+			json_internal::WriteBool(node.AsBool(), _out);
 			break;
 		case ConfigValue::INTEGER:
-			out << node.AsInt64();
+			json_internal::WriteInt(node.AsInt64(), _out);
 			break;
 		case ConfigValue::UINTEGER:
-			out << node.AsUInt64();
+			json_internal::WriteUInt(node.AsUInt64(), _out);
 			break;
 		case ConfigValue::FLOAT:
-			out << node.AsDouble();
+			json_internal::WriteDouble(node.AsDouble(), _out);
 			break;
 		case ConfigValue::STRING:
-			out << "\"";
-			json_internal::WriteString(node.AsString(), out);
-			out << "\"";
+			_out.Put('"');
+			json_internal::WriteString(node.AsString(), _out);
+			_out.Put('"');
 			break;
 		case ConfigValue::ARRAY:
 		{
-			out << "[";
+			_out.Put('[');
 			_ilevel++;
 			int size = node.Size();
 			for (int i = 0; i < size; ++i)
 			{
 				if (_format)
 				{
-					out << "\n";
-					json_internal::WriteTabs(_ilevel, out);
+					_out.Put('\n');
+					json_internal::WriteTabs(_ilevel, _out);
+				}
+				else if (i != 0)
+				{
+					_out.Put(' ');
 				}
-				WriteValue(node[i], out);
+				WriteValue(node[i]);
 			}
-			if (_format)
-				out << "\n";
 			_ilevel--;
-			if (_format)
-				json_internal::WriteTabs(_ilevel, out);
-			out << "]";
+			if (_format && size != 0)
+			{
+				_out.Put('\n');
+				json_internal::WriteTabs(_ilevel, _out);
+			}
+			_out.Put(']');
 		}
 			break;
 		case ConfigValue::OBJECT:
 		{
-			out << "{";
+			_out.Put('{');
 			_ilevel++;
 			ConfigValue::ConstIterator it, end;
 			it = node.Begin(); end = node.End();
@@ -564,23 +263,24 @@ namespace sb
 			{
 				if (_format)
 				{
-					out << "\n";
-					json_internal::WriteTabs(_ilevel, out);
+					_out.Put('\n');
+					json_internal::WriteTabs(_ilevel, _out);
 				}
-				json_internal::WriteString(it->first.c_str(), out, false);
-				out << " = ";
-				WriteValue(it->second, out);
-				out << " ";
+				else if (it != node.Begin())
+				{
+					_out.Put(' ');
+				}
+				json_internal::WriteKey(it->first.c_str(), _out);
+				_out.Write(" = ", 3);
+				WriteValue(it->second);
 			}
-			if (_format)
-				out << "\n";
-
 			_ilevel--;
-			if (_format)
-				json_internal::WriteTabs(_ilevel, out);
-			out << "}";
-			if (_format)
-				out << "\n";
+			if (_format && node.Size() != 0)
+			{
+				_out.Put('\n');
+				json_internal::WriteTabs(_ilevel, _out);
+			}
+			_out.Put('}');
 		}
 			break;
 		};
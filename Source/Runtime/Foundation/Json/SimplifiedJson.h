@@ -3,6 +3,7 @@
 #ifndef __FOUNDATION_SIMPLIFIEDJSON_H__
 #define __FOUNDATION_SIMPLIFIEDJSON_H__
 
+#include "IO/OutputBuffer.h"
 
 namespace sb
 {
@@ -27,6 +28,8 @@ namespace sb
 			~Reader();
 
 			/// Parses a simplified-JSON document into ConfigValues
+			///	@remark Parses with JsonDocument and copies the result, prefer using JsonDocument
+			///		directly where a read-only tree is enough.
 			///	@param doc JSON docoument
 			///	@param root This is going to be the root node
 			///	@return True if the parsing was successful, else false
@@ -41,45 +44,34 @@ namespace sb
 
 
 		private:
-			const char* _begin;
-			const char* _cur;
-			const char* _end;
-
 			string _error;
-
-			void Error(const char* msg);
-			void GetCurrentPosition(int& line, int& column);
-
-			bool ParseValue(ConfigValue& value);
-			bool ParseNumber(ConfigValue& value);
-			bool ParseDouble(ConfigValue& value);
-			bool ParseArray(ConfigValue& value);
-			bool ParseObject(ConfigValue& value);
-
-			bool ParseString(string& str);
-			void SkipSpaces();
-
 		};
 
 
+		/// @brief Writes simplified-JSON to a stream
+		///	Output is buffered and written to the stream on Flush() or when the writer is destroyed.
 		class Writer
 		{
 		public:
-			Writer();
-			~Writer();
-
-			/// @brief Generates JSON from the specified ConfigValue
-			/// @param root Root config node
-			/// @param out The generated JSON will be stored in this variable
+			/// @param out Stream to write to
 			/// @param format Should we use any formatting. Formatting makes it more 
 			///			human readable, otherwise everything is just printed on one line.
-			void Write(const ConfigValue& root, stringstream& out, bool format);
+			Writer(Stream& out, bool format);
+			~Writer();
+
+			/// @brief Generates simplified-JSON from the specified ConfigValue
+			/// @param root Root config node, an object which is written without the surrounding braces
+			void Write(const ConfigValue& root);
+
+			/// Writes any buffered output to the stream
+			void Flush();
 
 		private:
+			OutputBuffer _out;
 			bool _format;
 			int _ilevel; // Indent level
 
-			void WriteValue(const ConfigValue& node, stringstream& out);
+			void WriteValue(const ConfigValue& node);
 
 		};
 
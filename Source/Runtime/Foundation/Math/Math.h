@@ -1,7 +1,7 @@
 // Copyright 2008-2014 Simon Ekström
 
-#ifndef _MATH_H
-#define _MATH_H
+#ifndef __MATH_MATH_H__
+#define __MATH_MATH_H__
 
 // Constants
 #define MATH_PI 3.14159265358979323846
@@ -206,4 +206,4 @@ namespace sb
 } // namespace sb
 
 
-#endif // _MATH_H
+#endif // __MATH_MATH_H__
@@ -3,6 +3,7 @@
 #ifndef _MATH_VEC2_H
 #define _MATH_VEC2_H
 
+#include "Math.h"
 
 namespace sb
 {
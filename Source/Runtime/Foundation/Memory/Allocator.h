@@ -30,6 +30,60 @@ namespace sb
 
 	};
 
+	//-------------------------------------------------------------------------------
+	// memory::Delete, NewArray and DeleteArray are defined here as they need the complete Allocator
+
+	template<typename T> void memory::Delete(Allocator& allocator, T* p)
+	{
+		if (p)
+		{
+			Destruct<T>(p);
+			allocator.Free(p);
+		}
+	}
+	template<typename T> T* memory::NewArray(Allocator& allocator, size_t n)
+	{
+		union
+		{
+			void*	_p;
+			size_t*	_n;
+			T*		_obj;
+		};
+
+		// Since we need to worry about destruction of the elements we store the number
+		//	of elements immediately before our array.
+		_p = allocator.Allocate(sizeof(T)* n + sizeof(size_t));
+		*_n++ = n;
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			// Construct our instances with placement new
+			new(_obj)T;
+			++_obj;
+		}
+
+		return _obj - n;
+	}
+	template<typename T> void memory::DeleteArray(Allocator& allocator, T* p)
+	{
+		if (p)
+		{
+			// Retrieve our N that we stored immediately before our array
+			size_t* pn = reinterpret_cast<size_t*>(p)-1;
+			size_t n = *pn;
+
+			// Call the destructor for all elements
+			for (size_t i = 0; i < n; ++i)
+			{
+				p[i].~T();
+			}
+			// Free all memory
+			allocator.Free(pn);
+		}
+	}
+
+	//-------------------------------------------------------------------------------
+
 } // namespace sb
 
 #endif // __FOUNDATION_ALLOCATOR_H__
@@ -0,0 +1,293 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "FrameAllocator.h"
+
+#include "Thread/Thread.h"
+
+namespace sb
+{
+
+	namespace
+	{
+		/// Protects the lists of allocators and thread blocks. The lock is global as a thread may exit
+		///	while the allocator owning its block is being destroyed.
+		CriticalSection g_lock;
+		FrameAllocator* g_allocators = nullptr;
+
+		/// Size of the blocks threads take from the pages
+		const size_t THREAD_BLOCK_SIZE = 16 * 1024;
+
+		/// Allocations larger than this are taken directly from the pages to avoid wasting most of a block
+		const size_t MAX_BLOCK_ALLOCATION_SIZE = THREAD_BLOCK_SIZE / 4;
+
+		const uint32_t PAGE_ALIGNMENT = 16;
+	}
+
+	//-------------------------------------------------------------------------------
+	FrameAllocator::FrameAllocator(size_t page_size, uint32_t frame_count, Allocator& backing)
+		: _backing(backing),
+		_page_size(Max(page_size, THREAD_BLOCK_SIZE)),
+		_frame_count(frame_count),
+		_frame(0),
+		_frame_usage(0),
+		_peak_usage(0),
+		_thread_blocks(nullptr),
+		_prev(nullptr),
+		_next(nullptr)
+	{
+		Assert(frame_count > 0 && frame_count <= MAX_FRAME_COUNT);
+		for (uint32_t i = 0; i < MAX_FRAME_COUNT; ++i)
+		{
+			_buffers[i].first = nullptr;
+			_buffers[i].current = nullptr;
+		}
+		_thread_block = SB_NEW(_backing, ThreadLocalPtr, &ThreadExit);
+
+		ScopedLock<CriticalSection> lock(g_lock);
+		_next = g_allocators;
+		if (g_allocators)
+			g_allocators->_prev = this;
+		g_allocators = this;
+	}
+	FrameAllocator::~FrameAllocator()
+	{
+		// Unregister the key first so that no new calls to ThreadExit are made for it
+		SB_DELETE(_backing, _thread_block);
+		_thread_block = nullptr;
+
+		{
+			// Threads already in ThreadExit either finish before this or find the allocator gone
+			ScopedLock<CriticalSection> lock(g_lock);
+			if (_prev)
+				_prev->_next = _next;
+			else
+				g_allocators = _next;
+			if (_next)
+				_next->_prev = _prev;
+
+			while (_thread_blocks)
+				DestroyThreadBlock(_thread_blocks);
+		}
+
+		for (uint32_t i = 0; i < MAX_FRAME_COUNT; ++i)
+		{
+			Page* page = _buffers[i].first;
+			while (page)
+			{
+				Page* next = page->next;
+				_backing.Free(page);
+				page = next;
+			}
+		}
+	}
+	//-------------------------------------------------------------------------------
+	void* FrameAllocator::Allocate(size_t size, uint32_t alignment)
+	{
+		Assert(size != 0);
+		alignment = Max(alignment, (uint32_t)memory::DEFAULT_ALIGNMENT);
+
+		ThreadBlock* block = GetThreadBlock();
+		if (block->frame != _frame)
+		{
+			// Whatever was left of the block belongs to a frame that has ended
+			block->frame = _frame;
+			block->position = block->end = nullptr;
+		}
+
+		uint8_t* p = nullptr;
+		size_t needed = size + sizeof(Header) + alignment;
+		if (needed > MAX_BLOCK_ALLOCATION_SIZE)
+		{
+			p = (uint8_t*)memory::AlignForward(AllocateFromPage(needed) + sizeof(Header), alignment);
+		}
+		else
+		{
+			if (!block->position || size_t(block->end - block->position) < needed)
+			{
+				block->position = AllocateFromPage(THREAD_BLOCK_SIZE);
+				block->end = block->position + THREAD_BLOCK_SIZE;
+			}
+			p = (uint8_t*)memory::AlignForward(block->position + sizeof(Header), alignment);
+			block->position = p + size;
+		}
+
+		Header* header = (Header*)p - 1;
+		header->size = (uint32_t)size;
+		header->frame = _frame;
+
+		return p;
+	}
+	void* FrameAllocator::Reallocate(void* p, size_t size)
+	{
+		Assert(size != 0);
+		if (p == nullptr)
+			return Allocate(size);
+
+		Header* header = GetHeader(p);
+
+		// The last allocation in the block of this thread can be resized in place
+		ThreadBlock* block = GetThreadBlock();
+		uint8_t* block_end = (uint8_t*)p + size;
+		if (block->frame == _frame && block->position == (uint8_t*)p + header->size && block_end <= block->end)
+		{
+			header->size = (uint32_t)size;
+			block->position = block_end;
+			return p;
+		}
+
+		if (size <= header->size)
+			return p;
+
+		void* new_p = Allocate(size);
+		memcpy(new_p, p, header->size);
+		return new_p;
+	}
+	void FrameAllocator::Free(void* p)
+	{
+		if (p == nullptr)
+			return;
+
+		// Nothing to release but we still want to catch blocks outliving their frame
+		GetHeader(p);
+	}
+	size_t FrameAllocator::GetAllocatedSize(void* p)
+	{
+		return GetHeader(p)->size;
+	}
+	void FrameAllocator::EndFrame()
+	{
+		Buffer& buffer = _buffers[_frame % _frame_count];
+
+		size_t usage = 0;
+		for (Page* page = buffer.first; page; page = page->next)
+		{
+			usage += Min((size_t)page->used, page->size);
+			if (page == buffer.current)
+				break;
+		}
+		_frame_usage = usage;
+		_peak_usage = Max(_peak_usage, usage);
+
+		++_frame;
+
+		// The buffer for the new frame was last used frame_count frames ago
+		Buffer& next = _buffers[_frame % _frame_count];
+		for (Page* page = next.first; page; page = page->next)
+		{
+#ifdef SANDBOX_BUILD_DEBUG
+			// Make any use of memory from an old frame obvious
+			memset(page + 1, 0xdd, Min((size_t)page->used, page->size));
+#endif
+			page->used = 0;
+		}
+		next.current = next.first;
+	}
+	size_t FrameAllocator::GetFrameUsage() const
+	{
+		return _frame_usage;
+	}
+	size_t FrameAllocator::GetPeakUsage() const
+	{
+		return _peak_usage;
+	}
+	//-------------------------------------------------------------------------------
+	FrameAllocator::ThreadBlock* FrameAllocator::GetThreadBlock()
+	{
+		ThreadBlock* block = (ThreadBlock*)_thread_block->Get();
+		if (block)
+			return block;
+
+		block = (ThreadBlock*)_backing.Allocate(sizeof(ThreadBlock));
+		memset(block, 0, sizeof(ThreadBlock));
+		block->frame = _frame;
+		{
+			ScopedLock<CriticalSection> lock(g_lock);
+			block->next = _thread_blocks;
+			if (_thread_blocks)
+				_thread_blocks->prev = block;
+			_thread_blocks = block;
+		}
+		_thread_block->Set(block);
+		return block;
+	}
+	uint8_t* FrameAllocator::AllocateFromPage(size_t size)
+	{
+		Buffer& buffer = _buffers[_frame % _frame_count];
+		while (true)
+		{
+			Page* page = buffer.current;
+			if (page)
+			{
+				int64_t offset = thread::InterlockedExchangeAdd64(&page->used, (int64_t)size);
+				if (offset + (int64_t)size <= (int64_t)page->size)
+					return (uint8_t*)(page + 1) + offset;
+			}
+
+			// Page is full, only one thread gets to move on to the next page
+			ScopedLock<CriticalSection> lock(_lock);
+			if (buffer.current != page)
+				continue;
+
+			Page* next = page ? page->next : buffer.first;
+			if (!next || next->size < size)
+			{
+				size_t page_size = Max(_page_size, size);
+				Page* new_page = (Page*)_backing.Allocate(sizeof(Page) + page_size, PAGE_ALIGNMENT);
+				new_page->next = next;
+				new_page->size = page_size;
+				new_page->used = 0;
+
+				if (page)
+					page->next = new_page;
+				else
+					buffer.first = new_page;
+				next = new_page;
+			}
+			thread::InterlockedExchangePointer((void* volatile*)&buffer.current, next);
+		}
+	}
+	FrameAllocator::Header* FrameAllocator::GetHeader(void* p)
+	{
+		Header* header = (Header*)p - 1;
+		AssertMsg(_frame - header->frame < _frame_count, "FrameAllocator: Block belongs to a frame that has already been reset");
+		return header;
+	}
+	void FrameAllocator::DestroyThreadBlock(ThreadBlock* block)
+	{
+		if (block->prev)
+			block->prev->next = block->next;
+		else
+			_thread_blocks = block->next;
+		if (block->next)
+			block->next->prev = block->prev;
+
+		_backing.Free(block);
+	}
+#ifdef SANDBOX_PLATFORM_WIN
+	void WINAPI FrameAllocator::ThreadExit(void* block)
+#else
+	void FrameAllocator::ThreadExit(void* block)
+#endif
+	{
+		if (!block)
+			return;
+
+		// The block is only touched if its allocator is still alive, the destructor may already have freed it
+		ScopedLock<CriticalSection> lock(g_lock);
+		for (FrameAllocator* allocator = g_allocators; allocator; allocator = allocator->_next)
+		{
+			for (ThreadBlock* b = allocator->_thread_blocks; b; b = b->next)
+			{
+				if (b == block)
+				{
+					allocator->DestroyThreadBlock(b);
+					return;
+				}
+			}
+		}
+	}
+	//-------------------------------------------------------------------------------
+
+} // namespace sb
@@ -0,0 +1,126 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __FOUNDATION_FRAMEALLOCATOR_H__
+#define __FOUNDATION_FRAMEALLOCATOR_H__
+
+#include "Memory.h"
+#include "Allocator.h"
+
+#include "Thread/Lock.h"
+
+namespace sb
+{
+
+	class ThreadLocalPtr;
+
+	/// @brief Allocator for temporary data that only needs to live for the current frame
+	///	Every thread bumps through its own block, blocks are taken from large pages without any
+	///	locking. The pages are buffered over several frames, so memory allocated during one frame
+	///	stays valid until frame_count frames have ended, it is never freed individually.
+	///
+	///	In debug builds memory is overwritten when reused and freeing, reallocating or asking
+	///	for the size of a block from a frame that has been reset causes an assertion.
+	class FrameAllocator : public Allocator
+	{
+	public:
+		enum { MAX_FRAME_COUNT = 3 };
+
+		/// Constructor
+		/// @param page_size Size of the pages allocated from the backing allocator
+		/// @param frame_count Number of frames allocations stay valid, 2 for double buffering and 3 for triple buffering
+		FrameAllocator(size_t page_size, uint32_t frame_count = 2, Allocator& backing = memory::DefaultAllocator());
+		~FrameAllocator();
+
+		void* Allocate(size_t size, uint32_t alignment = memory::DEFAULT_ALIGNMENT);
+		void* Reallocate(void* p, size_t size);
+
+		/// @remark Memory is only released when the frame is reset
+		void Free(void* p);
+
+		size_t GetAllocatedSize(void* p);
+
+		/// Ends the current frame, memory allocated frame_count frames ago is reused from here on
+		///	This may not be called while other threads are allocating from this allocator.
+		void EndFrame();
+
+		/// @return Number of bytes used during the last ended frame, including per-thread blocks
+		size_t GetFrameUsage() const;
+
+		/// @return Highest frame usage seen so far
+		size_t GetPeakUsage() const;
+
+	private:
+		/// Stored in front of every allocation
+		struct Header
+		{
+			uint32_t size;
+			uint32_t frame;
+		};
+
+		struct Page
+		{
+			Page* next;
+			size_t size; ///< Size of the data following the header
+			volatile int64_t used;
+		};
+
+		/// Pages of one frame, pages are kept when reset and reused the next time around
+		struct Buffer
+		{
+			Page* first;
+			Page* volatile current;
+		};
+
+		/// Block the calling thread is currently allocating from
+		struct ThreadBlock
+		{
+			ThreadBlock* prev;
+			ThreadBlock* next;
+
+			uint32_t frame;
+			uint8_t* position;
+			uint8_t* end;
+		};
+
+		ThreadBlock* GetThreadBlock();
+
+		/// Takes size bytes from the current page of the current frame, moving on to another page if needed
+		uint8_t* AllocateFromPage(size_t size);
+
+		Header* GetHeader(void* p);
+
+		/// Unlinks and frees a thread block, expects the global lock to be held
+		void DestroyThreadBlock(ThreadBlock* block);
+
+#ifdef SANDBOX_PLATFORM_WIN
+		static void WINAPI ThreadExit(void* block);
+#else
+		static void ThreadExit(void* block);
+#endif
+
+		Allocator& _backing;
+		size_t _page_size;
+		uint32_t _frame_count;
+
+		volatile uint32_t _frame; ///< Frame counter, current buffer is _frame % _frame_count
+		Buffer _buffers[MAX_FRAME_COUNT];
+
+		size_t _frame_usage;
+		size_t _peak_usage;
+
+		ThreadLocalPtr* _thread_block;
+
+		CriticalSection _lock; ///< Protects page creation
+		ThreadBlock* _thread_blocks; ///< Protected by the global lock
+
+		/// Links in the list of live allocators, which lets an exiting thread check that its block is still valid
+		FrameAllocator* _prev;
+		FrameAllocator* _next;
+
+	};
+
+} // namespace sb
+
+
+
+#endif // __FOUNDATION_FRAMEALLOCATOR_H__
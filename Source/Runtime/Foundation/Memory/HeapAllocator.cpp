@@ -145,6 +145,31 @@ namespace sb
 	{
 		return mspace_usable_size(p);
 	}
+	bool HeapAllocator::AllocateBatch(size_t size, uint32_t count, void** blocks)
+	{
+		Assert(size != 0);
+
+		// independent_calloc would zero the blocks, comalloc with equal sizes doesn't
+		const uint32_t max_batch = 64;
+		size_t sizes[max_batch];
+		for (uint32_t i = 0; i < max_batch; ++i)
+			sizes[i] = size;
+
+		for (uint32_t i = 0; i < count; i += max_batch)
+		{
+			uint32_t n = Min(count - i, max_batch);
+			if (!mspace_independent_comalloc(_mspace, n, sizes, blocks + i))
+			{
+				FreeBatch(blocks, i);
+				return false;
+			}
+		}
+		return true;
+	}
+	void HeapAllocator::FreeBatch(void** blocks, uint32_t count)
+	{
+		mspace_bulk_free(_mspace, blocks, count);
+	}
 	//-------------------------------------------------------------------------------
 
 } // namespace sb
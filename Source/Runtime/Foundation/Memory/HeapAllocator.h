@@ -22,6 +22,15 @@ namespace sb
 
 		size_t GetAllocatedSize(void* p);
 
+		/// Allocates several blocks of the same size while only taking the lock once
+		///	The blocks are carved out of a single chunk but can still be freed one by one.
+		/// @param blocks Receives the count allocated blocks
+		/// @return False if out of memory, in which case no blocks were allocated
+		bool AllocateBatch(size_t size, uint32_t count, void** blocks);
+
+		/// Frees several blocks while only taking the lock once
+		void FreeBatch(void** blocks, uint32_t count);
+
 	private:
 		void* _mspace;
 
@@ -4,33 +4,86 @@
 
 #include "LinearAllocator.h"
 
+#include "Platform/System.h"
 
 namespace sb
 {
 
+	namespace
+	{
+		size_t AlignSize(size_t size, size_t alignment)
+		{
+			return (size + alignment - 1) & ~(alignment - 1);
+		}
+	}
+
 	LinearAllocator::LinearAllocator(size_t chunk_size, Allocator& backing)
 		: _backing(backing),
 		_default_chunk_size(chunk_size),
 		_first_chunk(nullptr),
 		_current_chunk(nullptr),
 		_chunk_position(nullptr),
-		_remaining_bytes(0)
+		_remaining_bytes(0),
+		_arena(nullptr),
+		_arena_reserved(0),
+		_arena_committed(0),
+		_arena_retain(0),
+		_commit_granularity(0)
 	{
 		AllocateChunk(_default_chunk_size);
 	}
+	LinearAllocator::LinearAllocator(const ArenaSettings& settings)
+		: _backing(memory::DefaultAllocator()),
+		_default_chunk_size(0),
+		_first_chunk(nullptr),
+		_current_chunk(nullptr),
+		_chunk_position(nullptr),
+		_remaining_bytes(0),
+		_arena(nullptr),
+		_arena_reserved(0),
+		_arena_committed(0),
+		_arena_retain(0)
+	{
+		// Committing in larger steps keeps the number of system calls down for arenas growing
+		//	a little at a time, huge pages can only be committed as a whole anyway.
+		_commit_granularity = settings.huge_pages ? 2 * 1024 * 1024 : 64 * 1024;
+
+		_arena_reserved = AlignSize(settings.reserve_size, _commit_granularity);
+		_arena_retain = AlignSize(settings.retain_size, _commit_granularity);
+
+		// Only used if the arena runs out of memory
+		_default_chunk_size = Max(_arena_reserved / 16, _commit_granularity);
+		_arena = (uint8_t*)system::ReserveVirtualMemory(_arena_reserved, settings.huge_pages);
+		AssertMsg(_arena, "LinearAllocator: Failed to reserve address space for arena.");
+
+		_chunk_position = _arena;
+	}
 	LinearAllocator::~LinearAllocator()
 	{
-		ChunkHeader* chunk = (ChunkHeader*)_first_chunk;
-		while (chunk)
+		if (_arena)
 		{
-			ChunkHeader* next = (ChunkHeader*)chunk->next_chunk;
-			_backing.Free(chunk);
-
-			chunk = next;
+			system::ReleaseVirtualMemory(_arena, _arena_reserved);
 		}
+		FreeChunks();
 	}
 
 	void* LinearAllocator::Allocate(size_t size, uint32_t alignment)
+	{
+		// Once the arena has overflowed into chunks we stay there until the next reset
+		if (_arena && !_first_chunk)
+		{
+			uint8_t* p = (uint8_t*)memory::AlignForward(_chunk_position, (size_t)alignment);
+			size_t end = (p - _arena) + size;
+			if (end <= _arena_committed || CommitArena(end))
+			{
+				_chunk_position = p + size;
+				return p;
+			}
+			logging::Warning("LinearAllocator: Arena out of reserved memory (%u bytes), falling back to chunks.", (uint32_t)_arena_reserved);
+		}
+		return AllocateFromChunk(size, alignment);
+	}
+	void* LinearAllocator::AllocateFromChunk(size_t size, uint32_t alignment)
 	{
 		// Do we need to allocate a new chunk?
 		if ((size + alignment) > _remaining_bytes)
@@ -56,6 +109,19 @@ namespace sb
 
 	void LinearAllocator::Reset()
 	{
+		if (_arena)
+		{
+			FreeChunks();
+
+			_chunk_position = _arena;
+			if (_arena_committed > _arena_retain)
+			{
+				system::DecommitVirtualMemory(_arena + _arena_retain, _arena_committed - _arena_retain);
+				_arena_committed = _arena_retain;
+			}
+			return;
+		}
+
 		_current_chunk = _first_chunk;
 		_remaining_bytes = ((ChunkHeader*)_current_chunk)->chunk_size;
 		_chunk_position = memory::PointerAdd(_current_chunk, sizeof(ChunkHeader));
@@ -116,6 +182,33 @@ namespace sb
 		_chunk_position = memory::PointerAdd(_current_chunk, sizeof(ChunkHeader));
 		_remaining_bytes = ((ChunkHeader*)_current_chunk)->chunk_size;
 	}
+	void LinearAllocator::FreeChunks()
+	{
+		ChunkHeader* chunk = (ChunkHeader*)_first_chunk;
+		while (chunk)
+		{
+			ChunkHeader* next = (ChunkHeader*)chunk->next_chunk;
+			_backing.Free(chunk);
+
+			chunk = next;
+		}
+
+		_first_chunk = nullptr;
+		_current_chunk = nullptr;
+		_remaining_bytes = 0;
+	}
+	bool LinearAllocator::CommitArena(size_t size)
+	{
+		if (size > _arena_reserved)
+			return false;
+
+		size_t commit_end = Min(AlignSize(size, _commit_granularity), _arena_reserved);
+		if (!system::CommitVirtualMemory(_arena + _arena_committed, commit_end - _arena_committed))
+			return false;
+
+		_arena_committed = commit_end;
+		return true;
+	}
 
 } // namespace sb
 
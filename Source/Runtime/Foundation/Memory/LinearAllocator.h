@@ -10,13 +10,31 @@ namespace sb
 	/// @brief A simple non-thread-safe allocator performing linear allocations.
 	///	This allocator supports releasing all memory in one go, but it doesn't support releasing individual blocks.
 	///		Therefore this allocator is very fitting when you know that you can release all memory at the same time.
+	///
+	///	The allocator either chains chunks from a backing allocator or, in arena mode, reserves a range of
+	///		virtual memory up front and commits memory as it grows. Allocations from an arena are contiguous
+	///		and growing never allocates or links any chunks, unless the arena runs out of reserved memory.
+	///		In that case allocations continue in chunks from the default allocator until the next Reset().
 	class LinearAllocator
 	{
 	public:
+		/// @brief Settings for an arena backed directly by virtual memory
+		struct ArenaSettings
+		{
+			ArenaSettings(size_t reserve) : reserve_size(reserve), retain_size(0), huge_pages(false) {}
+
+			size_t reserve_size; ///< Size of the reserved address range, anything beyond this is allocated in chunks.
+			size_t retain_size; ///< Memory kept committed on Reset(), anything committed above this is returned to the system.
+			bool huge_pages; ///< Ask for huge pages where the system supports them.
+		};
+
 		/// Constructor
 		/// @param allocator The backing allocator.
 		/// @param chunk_size Size of each chunk allocated.
 		LinearAllocator(size_t chunk_size, Allocator& backing = memory::DefaultAllocator());
+
+		/// Constructor for arena mode
+		explicit LinearAllocator(const ArenaSettings& settings);
 		~LinearAllocator();
 
 		void* Allocate(size_t size, uint32_t alignment = memory::DEFAULT_ALIGNMENT);
@@ -26,6 +44,7 @@ namespace sb
 		void Free(void* p);
 
 		/// Resets the allocator, basically releasing all allocations.
+		///	An arena also decommits anything above ArenaSettings::retain_size and frees any overflow chunks.
 		void Reset();
 
 		/// @remark This is not supported by this allocator and will therefore cause an assertion.
@@ -35,6 +54,16 @@ namespace sb
 		/// @param min_size Minimum size of the new chunk, in case we need chunks larger than the default size.
 		void AllocateChunk(size_t min_size);
 
+		/// Allocates from the chunks, allocating a new chunk if needed
+		void* AllocateFromChunk(size_t size, uint32_t alignment);
+
+		/// Frees all chunks
+		void FreeChunks();
+
+		/// Makes sure at least size bytes from the start of the arena are committed
+		/// @return False if the arena is out of reserved address space
+		bool CommitArena(size_t size);
+
 	private:
 		/// @brief This object will be on the top of each chunk.
 		struct ChunkHeader
@@ -52,6 +81,11 @@ namespace sb
 		void* _chunk_position; // Position in the current chunk
 		size_t _remaining_bytes; // Remaining bytes in the current chunk
 
+		uint8_t* _arena; // Start of the reserved range, NULL if not in arena mode
+		size_t _arena_reserved;
+		size_t _arena_committed;
+		size_t _arena_retain;
+		size_t _commit_granularity; // Memory is committed and decommitted in multiples of this
 
 	};
 
@@ -4,7 +4,12 @@
 
 #include "Memory.h"
 #include "HeapAllocator.h"
+#include "ThreadCacheAllocator.h"
+#include "FrameAllocator.h"
 #include "ProxyAllocator.h"
+#include "MemoryProfiler.h"
+
+#include "Profiler/Profiler.h"
 
 namespace sb
 {
@@ -15,6 +20,15 @@ namespace sb
 		char g_allocator_buffer[2 * ALLOCATOR_SIZE];
 
 		HeapAllocator* g_default_alloc = nullptr;
+
+		// Small allocations from the default allocator go through a thread cache in front of the heap
+		char g_thread_cache_buffer[sizeof(ThreadCacheAllocator)];
+		ThreadCacheAllocator* g_thread_cache_alloc = nullptr;
+
+		// Temporary per-frame allocations, double buffered so that data from the previous frame can still be in use
+		const size_t SCRATCH_PAGE_SIZE = 2 * 1024 * 1024;
+		char g_scratch_buffer[sizeof(FrameAllocator)];
+		FrameAllocator* g_scratch_alloc = nullptr;
 #ifdef SANDBOX_MEMORY_TRACKING
 		HeapAllocator* g_debug_alloc = nullptr;
 #endif
@@ -25,10 +39,13 @@ namespace sb
 	void memory::Initialize()
 	{
 		g_default_alloc = new (g_allocator_buffer)HeapAllocator();
+		g_thread_cache_alloc = new (g_thread_cache_buffer)ThreadCacheAllocator(*g_default_alloc);
+		g_scratch_alloc = new (g_scratch_buffer)FrameAllocator(SCRATCH_PAGE_SIZE, 2, *g_default_alloc);
 
 #ifdef SANDBOX_MEMORY_TRACKING
 		g_debug_alloc = new (g_allocator_buffer + ALLOCATOR_SIZE) HeapAllocator();
-		g_default_proxy_allocator = SB_NEW(*g_debug_alloc, TraceAllocator, "Default", *g_default_alloc);
+		memory_profiler::Initialize();
+		g_default_proxy_allocator = SB_NEW(*g_debug_alloc, TraceAllocator, "Default", *g_thread_cache_alloc);
 #endif
 
 	}
@@ -39,10 +56,17 @@ namespace sb
 		{
 			SB_DELETE(*g_debug_alloc, g_default_proxy_allocator);
 		}
+		memory_profiler::Shutdown();
 #endif
 
 		// Because the allocator is stored on the stack and we can't use delete we have 
 		//	to call the destructor ourself
+		g_scratch_alloc->~FrameAllocator();
+		g_scratch_alloc = nullptr;
+
+		g_thread_cache_alloc->~ThreadCacheAllocator();
+		g_thread_cache_alloc = nullptr;
+
 		g_default_alloc->~HeapAllocator();
 		g_default_alloc = nullptr;
 
@@ -56,15 +80,23 @@ namespace sb
 #ifdef SANDBOX_MEMORY_TRACKING
 		return *g_default_proxy_allocator;
 #else
-		return *g_default_alloc;
+		return *g_thread_cache_alloc;
 #endif
 	}
 	Allocator& memory::ScratchAllocator()
 	{
+		// Not traced, allocations from the scratch allocator are never expected to be freed
+		return *g_scratch_alloc;
+	}
+	void memory::EndFrame()
+	{
+		Assert(g_scratch_alloc);
+		g_scratch_alloc->EndFrame();
+
+		MICROPROFILE_META_CPU("Scratch memory (KB)", int(g_scratch_alloc->GetFrameUsage() / 1024));
+
 #ifdef SANDBOX_MEMORY_TRACKING
-		return *g_default_proxy_allocator;
-#else
-		return *g_default_alloc; // TODO
+		memory_profiler::EndFrame();
 #endif
 	}
 
@@ -77,23 +109,23 @@ namespace sb
 
 	void* memory::Malloc(size_t size, uint32_t alignment)
 	{
-		Assert(g_default_alloc);
-		return g_default_alloc->Allocate(size, alignment);
+		Assert(g_thread_cache_alloc);
+		return g_thread_cache_alloc->Allocate(size, alignment);
 	}
 	void* memory::Realloc(void* p, size_t size)
 	{
-		Assert(g_default_alloc);
-		return g_default_alloc->Reallocate(p, size);
+		Assert(g_thread_cache_alloc);
+		return g_thread_cache_alloc->Reallocate(p, size);
 	}
 	void memory::Free(void* p)
 	{
-		Assert(g_default_alloc);
-		g_default_alloc->Free(p);
+		Assert(g_thread_cache_alloc);
+		g_thread_cache_alloc->Free(p);
 	}
 	size_t memory::GetAllocatedSize(void* p)
 	{
-		Assert(g_default_alloc);
-		return g_default_alloc->GetAllocatedSize(p);
+		Assert(g_thread_cache_alloc);
+		return g_thread_cache_alloc->GetAllocatedSize(p);
 	}
 
 } // namespace sb
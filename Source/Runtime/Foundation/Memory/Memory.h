@@ -32,7 +32,15 @@ namespace sb
 		void Shutdown();
 
 		Allocator& DefaultAllocator();
+
+		/// @brief Allocator for temporary data, valid until the end of the next frame
+		///	Blocks don't have to be freed, see FrameAllocator.
 		Allocator& ScratchAllocator();
+
+		/// @brief Ends the frame for the scratch allocator, reclaiming memory from the frame before
+		///	Must be called once per frame while no other threads are using the scratch allocator.
+		///	With memory tracking this also ends the frame for the memory profiler.
+		void EndFrame();
 #ifdef SANDBOX_MEMORY_TRACKING
 		Allocator& DebugAllocator();
 #endif
@@ -114,57 +122,6 @@ namespace sb
 
 	//-------------------------------------------------------------------------------
 
-	template<typename T> void memory::Delete(Allocator& allocator, T* p)
-	{
-		if (p)
-		{
-			Destruct<T>(p);
-			allocator.Free(p);
-		}
-	}
-	template<typename T> T* memory::NewArray(Allocator& allocator, size_t n)
-	{
-		union
-		{
-			void*	_p;
-			size_t*	_n;
-			T*		_obj;
-		};
-
-		// Since we need to worry about destruction of the elements we store the number
-		//	of elements immediately before our array.
-		_p = allocator.Allocate(sizeof(T)* n + sizeof(size_t));
-		*_n++ = n;
-
-		for (size_t i = 0; i < n; ++i)
-		{
-			// Construct our instances with placement new
-			new(_obj)T;
-			++_obj;
-		}
-
-		return _obj - n;
-	}
-	template<typename T> void memory::DeleteArray(Allocator& allocator, T* p)
-	{
-		if (p)
-		{
-			// Retrieve our N that we stored immediately before our array
-			size_t* pn = reinterpret_cast<size_t*>(p)-1;
-			size_t n = *pn;
-
-			// Call the destructor for all elements
-			for (size_t i = 0; i < n; ++i)
-			{
-				p[i].~T();
-			}
-			// Free all memory
-			allocator.Free(pn);
-		}
-	}
-
-	//-------------------------------------------------------------------------------
-
 	void* memory::PointerAdd(void *p, size_t bytes)
 	{
 		return (void*)((char *)p + bytes);
@@ -14,17 +14,26 @@ namespace sb
 	/// This is not really an allocator in the same way as for example HeapAllocator
 	///	as it doesn't allocate raw memory, it's just a memory pool for objects. The objects
 	///	are not destroyed when released, therefore the pool handle all objects as POD-objects
+	///
+	///	Allocate and Release are lock-free, free objects are kept in a stack of indices with a tag
+	///	against the ABA problem. A lock is only taken when the pool needs to grow.
+	///
+	///	Blocks double in size, block n holds BLOCK_SIZE << n objects. This keeps the table of blocks
+	///	fixed, which lock-free readers rely on, while the pool still grows until it runs out of 32-bit
+	///	object indices.
 	template<typename T, int BLOCK_SIZE>
 	class MemoryPool
 	{
 	public:
+		enum { MAX_BLOCK_COUNT = 32 };
+
 		/// Constructor
 		///	@param backing Backing allocator
 		MemoryPool(Allocator& backing = memory::DefaultAllocator());
 		~MemoryPool();
 
 		/// @brief Allocates an object
-		///	@return Returns NULL if pool is full
+		///	@return Returns NULL if the backing allocator is out of memory or the pool has run out of object indices
 		T* Allocate();
 
 		/// @brief Releases an object
@@ -39,98 +48,119 @@ namespace sb
 		T* GetObject(uint32_t index);
 
 	private:
-		struct Block
-		{
-			/// Object buffer
-			T buffer[BLOCK_SIZE];
+		enum { EMPTY = 0xffffffff };
 
-			/// Next block in the pool
-			Block* next;
-		};
-		Block* _head_block;
-		uint32_t _block_count; ///< Number of allocated blocks
+		/// Objects of each block, entries are never changed once set
+		T* volatile _blocks[MAX_BLOCK_COUNT];
 
-		T** _free_objects; ///< List of free object slots
-		uint32_t _free_object_count;
+		/// Index of the next free object for each free object of each block, kept outside the
+		///	objects so that released objects are left untouched.
+		uint32_t* volatile _next_free[MAX_BLOCK_COUNT];
+		volatile long _block_count;
 
-		CriticalSection _lock;
+		/// Top of the free stack, index of the first free object in the low 32 bits and a tag
+		///	that changes on every push and pop in the high 32 bits.
+		volatile int64_t _free_head;
+
+		CriticalSection _grow_lock;
 		Allocator& _backing;
 
-		/// @brief Allocates a new block for objects
-		///	@remark This is not thread-safe so it's assumed that any locks needed are in place
-		void AllocateBlock();
+		uint32_t& NextFree(uint32_t index);
+
+		/// @return Index of the first object in the specified block
+		static uint64_t FirstIndex(uint32_t block);
+
+		/// @return Block holding the object with the specified index
+		static uint32_t BlockOf(uint32_t index);
+
+		/// @return New top of the free stack with the specified index, tagged one higher than head
+		static int64_t NextHead(int64_t head, uint32_t index);
+
+		/// @brief Allocates a new block and pushes its objects on the free stack
+		///	@return False if the allocation failed or the new block wouldn't fit in the object index range
+		bool AllocateBlock();
 	};
 
 
 	//-------------------------------------------------------------------------------
 	template<typename T, int BLOCK_SIZE>
 	MemoryPool<T, BLOCK_SIZE>::MemoryPool(Allocator& backing)
-		: _head_block(nullptr),
-		_block_count(0),
-		_free_objects(nullptr),
-		_free_object_count(0),
+		: _block_count(0),
+		_free_head(EMPTY),
 		_backing(backing)
 	{
+		for (uint32_t i = 0; i < MAX_BLOCK_COUNT; ++i)
+		{
+			_blocks[i] = nullptr;
+			_next_free[i] = nullptr;
+		}
 		AllocateBlock();
 	}
 	template<typename T, int BLOCK_SIZE>
 	MemoryPool<T, BLOCK_SIZE>::~MemoryPool()
 	{
-		Block* block = 0;
-		Block* next_block = _head_block;
-		while (next_block)
+		for (long i = 0; i < _block_count; ++i)
 		{
-			block = next_block;
-			next_block = block->next;
-
-			_backing.Free(block);
+			_backing.Free(_blocks[i]);
 		}
-		_backing.Free(_free_objects);
 	}
 	//-------------------------------------------------------------------------------
 	template<typename T, int BLOCK_SIZE>
 	T* MemoryPool<T, BLOCK_SIZE>::Allocate()
 	{
-		ScopedLock<CriticalSection> scoped_lock(_lock);
-
-		if (_free_object_count > 0) // Check if pool is full
+		while (true)
 		{
-			T* object = _free_objects[--_free_object_count];
+			int64_t head = _free_head;
+			uint32_t index = uint32_t(head);
+			if (index == EMPTY)
+			{
+				if (!AllocateBlock())
+					return nullptr;
+				continue;
+			}
 
-			return object;
+			// The next index may be stale if another thread popped the object first, the
+			//	tag makes sure the exchange fails in that case.
+			int64_t new_head = NextHead(head, NextFree(index));
+			if (thread::InterlockedCompareExchange64(&_free_head, new_head, head) == head)
+			{
+				uint32_t block = BlockOf(index);
+				return _blocks[block] + (index - FirstIndex(block));
+			}
 		}
-
-		AllocateBlock();
-
-		Assert(_free_object_count > 0);
-		T* object = _free_objects[--_free_object_count];
-
-		return object;
 	}
 	template<typename T, int BLOCK_SIZE>
 	void MemoryPool<T, BLOCK_SIZE>::Release(T* obj)
 	{
 		Assert(obj);
-		ScopedLock<CriticalSection> scoped_lock(_lock);
 
-		_free_objects[_free_object_count] = obj;
-		++_free_object_count;
+		uint32_t index = GetIndex(obj);
+		Assert(IsValid(index));
+
+		while (true)
+		{
+			int64_t head = _free_head;
+			NextFree(index) = uint32_t(head);
+
+			int64_t new_head = NextHead(head, index);
+			if (thread::InterlockedCompareExchange64(&_free_head, new_head, head) == head)
+			{
+				return;
+			}
+		}
 	}
 	template<typename T, int BLOCK_SIZE>
 	uint32_t MemoryPool<T, BLOCK_SIZE>::GetIndex(T* obj)
 	{
-		ScopedLock<CriticalSection> scoped_lock(_lock);
-
-		uint32_t index = 0;
-		for (Block* block = _head_block; block != nullptr; block = block->next)
+		long block_count = _block_count;
+		for (long i = 0; i < block_count; ++i)
 		{
-			T* objects = block->buffer;
+			T* objects = _blocks[i];
 			// Is the object in this block?
-			if (obj >= objects && obj < objects + BLOCK_SIZE)
+			if (obj >= objects && obj < objects + (uint64_t(BLOCK_SIZE) << i))
 			{
-				return index + (uint32_t)(obj - objects);
+				return uint32_t(FirstIndex(i)) + (uint32_t)(obj - objects);
 			}
-			index += BLOCK_SIZE;
 		}
 		return Invalid<uint32_t>();
 	}
@@ -139,56 +169,96 @@ namespace sb
 	{
 		Assert(IsValid(index));
 
-		ScopedLock<CriticalSection> scoped_lock(_lock);
-		for (Block* block = _head_block; block != nullptr; block = block->next)
+		uint32_t block = BlockOf(index);
+		if (block >= (uint32_t)_block_count)
 		{
-			// Is the index in this block?
-			if (index < BLOCK_SIZE)
-			{
-				return block->buffer + index;
-			}
-			index -= BLOCK_SIZE;
+			return nullptr;
 		}
-		return nullptr;
+		return _blocks[block] + (index - FirstIndex(block));
 	}
 	template<typename T, int BLOCK_SIZE>
-	void MemoryPool<T, BLOCK_SIZE>::AllocateBlock()
+	uint32_t& MemoryPool<T, BLOCK_SIZE>::NextFree(uint32_t index)
 	{
-		Assert(_free_object_count == 0);
-
-		_block_count++;
-
-		// Put the Block object at the end of the buffer
-		Block* block = (Block*)_backing.Allocate(sizeof(Block));
-		block->next = nullptr;
+		uint32_t block = BlockOf(index);
+		return _next_free[block][index - FirstIndex(block)];
+	}
+	template<typename T, int BLOCK_SIZE>
+	uint64_t MemoryPool<T, BLOCK_SIZE>::FirstIndex(uint32_t block)
+	{
+		return uint64_t(BLOCK_SIZE) * ((uint64_t(1) << block) - 1);
+	}
+	template<typename T, int BLOCK_SIZE>
+	uint32_t MemoryPool<T, BLOCK_SIZE>::BlockOf(uint32_t index)
+	{
+		// Block n starts at BLOCK_SIZE * (2^n - 1), so the block is log2(index / BLOCK_SIZE + 1)
+		uint32_t n = index / BLOCK_SIZE + 1;
+		uint32_t block = 0;
+		while (n >>= 1)
+		{
+			++block;
+		}
+		return block;
+	}
+	template<typename T, int BLOCK_SIZE>
+	int64_t MemoryPool<T, BLOCK_SIZE>::NextHead(int64_t head, uint32_t index)
+	{
+		uint64_t tag = (uint64_t(head) >> 32) + 1;
+		return int64_t((tag << 32) | index);
+	}
+	template<typename T, int BLOCK_SIZE>
+	bool MemoryPool<T, BLOCK_SIZE>::AllocateBlock()
+	{
+		ScopedLock<CriticalSection> scoped_lock(_grow_lock);
 
-		if (_head_block == nullptr)
+		// Another thread may already have grown the pool while we were waiting for the lock
+		if (uint32_t(_free_head) != EMPTY)
 		{
-			_head_block = block;
+			return true;
 		}
-		else
+		// EMPTY is reserved, which also keeps the block count below MAX_BLOCK_COUNT
+		uint32_t block_index = (uint32_t)_block_count;
+		uint64_t block_size = uint64_t(BLOCK_SIZE) << block_index;
+		if (FirstIndex(block_index) + block_size > EMPTY)
 		{
-			// Put the new block at the end of the list
-			Block* tmp = _head_block;
-			while (tmp->next)
-			{
-				tmp = tmp->next;
-			}
-			tmp->next = block;
+			return false;
 		}
 
-		_free_objects = (T**)_backing.Reallocate(_free_objects, sizeof(T*)* _block_count * BLOCK_SIZE);
-		_free_object_count = BLOCK_SIZE;
-
-		T* objects = block->buffer;
+		// Objects first, followed by the free list links
+		size_t objects_size = size_t(block_size * sizeof(T));
+		objects_size = (objects_size + sizeof(uint32_t) - 1) & ~(sizeof(uint32_t) - 1);
+		uint8_t* memory = (uint8_t*)_backing.Allocate(objects_size + size_t(block_size * sizeof(uint32_t)),
+			Max((uint32_t)__alignof(T), (uint32_t)__alignof(uint32_t)));
+		if (!memory)
+		{
+			return false;
+		}
+		uint32_t* next_free = (uint32_t*)(memory + objects_size);
 
-		// Add new block to free objects
-		for (uint32_t i = BLOCK_SIZE; i > 0; --i)
+		// Chain the new objects together, lowest index first
+		uint32_t first = uint32_t(FirstIndex(block_index));
+		uint32_t count = uint32_t(block_size);
+		for (uint32_t i = 0; i < count - 1; ++i)
 		{
-			_free_objects[i-1] = objects;
-			++objects;
+			next_free[i] = first + i + 1;
 		}
 
+		// Publish the block before any of its objects can be allocated
+		_blocks[block_index] = (T*)memory;
+		_next_free[block_index] = next_free;
+		thread::InterlockedIncrement(&_block_count);
+
+		// Push the whole chain at once
+		while (true)
+		{
+			int64_t head = _free_head;
+			next_free[count - 1] = uint32_t(head);
+
+			int64_t new_head = NextHead(head, first);
+			if (thread::InterlockedCompareExchange64(&_free_head, new_head, head) == head)
+			{
+				return true;
+			}
+		}
 	}
 	//-------------------------------------------------------------------------------
 
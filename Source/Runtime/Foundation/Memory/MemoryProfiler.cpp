@@ -0,0 +1,685 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "MemoryProfiler.h"
+
+#ifdef SANDBOX_MEMORY_TRACKING
+
+#include "Container/ConfigValue.h"
+#include "Debug/Console.h"
+#include "Debug/ConsoleServer.h"
+#include "Filesystem/File.h"
+#include "Platform/System.h"
+#include "Profiler/Profiler.h"
+#include "Thread/Thread.h"
+
+#include <math.h>
+
+namespace sb
+{
+
+	namespace
+	{
+		const uint32_t MAX_THREADS = 256;
+		const uint32_t MAX_TAG_DEPTH = 16;
+
+		const uint32_t MAX_STACK_DEPTH = 24;
+		const uint32_t MAX_STACKS = 8192;
+		const uint32_t STACK_TABLE_SIZE = 2 * MAX_STACKS;
+		const uint32_t NO_STACK = 0xffffffff;
+
+		/// The sample table is open addressed, a block is never further than MAX_PROBE_COUNT slots from its home slot
+		const uint32_t SAMPLE_TABLE_BITS = 16;
+		const uint32_t SAMPLE_TABLE_SIZE = 1 << SAMPLE_TABLE_BITS;
+		const uint32_t MAX_PROBE_COUNT = 16;
+
+		/// Markers for sample slots, real blocks are never at these addresses
+		void* const SLOT_FREED = (void*)1;
+		void* const SLOT_BUSY = (void*)2;
+
+		struct Counters
+		{
+			int64_t alloc_bytes;
+			int64_t alloc_count;
+			int64_t free_bytes;
+			int64_t free_count;
+		};
+
+		/// Per-thread counters, only written by the owning thread
+		struct ThreadState
+		{
+			volatile long used;
+			uint32_t index;
+
+			int64_t bytes_until_sample;
+			uint32_t random;
+			bool sampling; ///< Guards against recursion while taking a sample
+
+			uint32_t tags[MAX_TAG_DEPTH];
+			uint32_t tag_depth;
+
+			Counters allocators[memory_profiler::MAX_ALLOCATORS];
+			Counters tags_counters[memory_profiler::MAX_TAGS];
+		};
+
+		struct StackTrace
+		{
+			uint32_t hash;
+			uint32_t depth;
+			void* addresses[MAX_STACK_DEPTH];
+		};
+
+		struct Sample
+		{
+			void* volatile p;
+			uint32_t size;
+			uint16_t allocator;
+			uint16_t tag;
+			uint32_t stack;
+		};
+
+		bool g_initialized = false;
+		volatile int64_t g_sample_interval = memory_profiler::DEFAULT_SAMPLE_INTERVAL;
+		bool g_send_frame_stats = false;
+
+		char g_thread_state_buffer[sizeof(ThreadLocalPtr)];
+		ThreadLocalPtr* g_thread_state = nullptr;
+		ThreadState g_threads[MAX_THREADS];
+
+		CriticalSection g_lock; ///< Protects registration, counters of exited threads and frame stats
+		const char* g_allocator_names[memory_profiler::MAX_ALLOCATORS]; ///< NULL for free slots
+		uint32_t g_allocator_count = 0; ///< Number of slots ever used
+		const char* g_tag_names[memory_profiler::MAX_TAGS];
+		uint32_t g_tag_count = 0;
+
+		Counters g_exited_allocators[memory_profiler::MAX_ALLOCATORS];
+		Counters g_exited_tags[memory_profiler::MAX_TAGS];
+		memory_profiler::Stats g_allocator_stats[memory_profiler::MAX_ALLOCATORS];
+		memory_profiler::Stats g_tag_stats[memory_profiler::MAX_TAGS];
+
+		CriticalSection g_stack_lock; ///< Only taken when a sample is recorded
+		StackTrace g_stacks[MAX_STACKS];
+		uint32_t g_stack_count = 0;
+		uint32_t g_stack_table[STACK_TABLE_SIZE]; ///< Index + 1 into g_stacks, 0 for empty slots
+
+		Sample g_samples[SAMPLE_TABLE_SIZE];
+
+		/// Number of live samples per home slot, lets frees of blocks that weren't sampled
+		///	(almost all of them) skip probing the sample table.
+		volatile long g_sample_homes[SAMPLE_TABLE_SIZE];
+
+		uint32_t SampleHome(void* p)
+		{
+			return uint32_t(((uint64_t)(uintptr_t)p >> 4) * 0x9E3779B97F4A7C15ull >> (64 - SAMPLE_TABLE_BITS));
+		}
+
+		/// @return Distance to the next sample, exponentially distributed to make sampling independent of allocation patterns
+		int64_t NextSampleDistance(ThreadState* state)
+		{
+			int64_t interval = g_sample_interval;
+			if (interval == 0)
+				return memory_profiler::DEFAULT_SAMPLE_INTERVAL;
+
+			// xorshift32
+			uint32_t x = state->random;
+			x ^= x << 13;
+			x ^= x >> 17;
+			x ^= x << 5;
+			state->random = x;
+
+			double u = (double(x >> 8) + 1.0) / double(1 << 24);
+			return int64_t(-log(u) * double(interval)) + 1;
+		}
+
+		void AddCounters(Counters& dst, const Counters& src)
+		{
+			dst.alloc_bytes += src.alloc_bytes;
+			dst.alloc_count += src.alloc_count;
+			dst.free_bytes += src.free_bytes;
+			dst.free_count += src.free_count;
+		}
+
+		/// Sums the counters of all threads, expects g_lock to be held
+		///	Counters of threads currently allocating may be off by a few allocations.
+		void CollectCounters(Counters* allocators, Counters* tags)
+		{
+			memcpy(allocators, g_exited_allocators, sizeof(g_exited_allocators));
+			memcpy(tags, g_exited_tags, sizeof(g_exited_tags));
+			for (uint32_t t = 0; t < MAX_THREADS; ++t)
+			{
+				if (!g_threads[t].used)
+					continue;
+				for (uint32_t i = 0; i < g_allocator_count; ++i)
+					AddCounters(allocators[i], g_threads[t].allocators[i]);
+				for (uint32_t i = 0; i < g_tag_count; ++i)
+					AddCounters(tags[i], g_threads[t].tags_counters[i]);
+			}
+		}
+
+		void UpdateStats(memory_profiler::Stats& stats, const Counters& counters, const char* name)
+		{
+			stats.name = name;
+			stats.live_bytes = counters.alloc_bytes - counters.free_bytes;
+			stats.live_count = counters.alloc_count - counters.free_count;
+			stats.frame_bytes = counters.alloc_bytes - stats.total_bytes;
+			stats.frame_count = counters.alloc_count - stats.total_count;
+			stats.total_bytes = counters.alloc_bytes;
+			stats.total_count = counters.alloc_count;
+		}
+
+#ifdef SANDBOX_PLATFORM_WIN
+		void WINAPI ThreadExit(void* value)
+#else
+		void ThreadExit(void* value)
+#endif
+		{
+			ThreadState* state = (ThreadState*)value;
+			if (!state)
+				return;
+
+			ScopedLock<CriticalSection> lock(g_lock);
+			for (uint32_t i = 0; i < memory_profiler::MAX_ALLOCATORS; ++i)
+				AddCounters(g_exited_allocators[i], state->allocators[i]);
+			for (uint32_t i = 0; i < memory_profiler::MAX_TAGS; ++i)
+				AddCounters(g_exited_tags[i], state->tags_counters[i]);
+
+			memset(state->allocators, 0, sizeof(state->allocators));
+			memset(state->tags_counters, 0, sizeof(state->tags_counters));
+			state->used = 0;
+		}
+
+		ThreadState* GetThreadState()
+		{
+			if (!g_initialized)
+				return nullptr;
+
+			ThreadState* state = (ThreadState*)g_thread_state->Get();
+			if (state)
+				return state;
+
+			for (uint32_t i = 0; i < MAX_THREADS; ++i)
+			{
+				if (g_threads[i].used || thread::InterlockedCompareExchange(&g_threads[i].used, 1, 0) != 0)
+					continue;
+
+				state = &g_threads[i];
+				state->index = i;
+				state->random = 2463534242u ^ (i * 2654435761u);
+				state->sampling = false;
+				state->tag_depth = 0;
+				state->bytes_until_sample = NextSampleDistance(state);
+
+				g_thread_state->Set(state);
+				return state;
+			}
+
+			// Out of thread slots, this thread goes unprofiled
+			return nullptr;
+		}
+
+		uint32_t AddStackTrace(void** addresses, uint32_t depth)
+		{
+			uint32_t hash = 2166136261u;
+			for (uint32_t i = 0; i < depth; ++i)
+				hash = (hash ^ uint32_t((uintptr_t)addresses[i] >> 2)) * 16777619u;
+
+			ScopedLock<CriticalSection> lock(g_stack_lock);
+			for (uint32_t i = 0; i < STACK_TABLE_SIZE; ++i)
+			{
+				uint32_t& slot = g_stack_table[(hash + i) & (STACK_TABLE_SIZE - 1)];
+				if (slot == 0)
+				{
+					if (g_stack_count == MAX_STACKS)
+						return NO_STACK;
+
+					StackTrace& stack = g_stacks[g_stack_count];
+					stack.hash = hash;
+					stack.depth = depth;
+					memcpy(stack.addresses, addresses, depth * sizeof(void*));
+					slot = ++g_stack_count;
+					return slot - 1;
+				}
+
+				StackTrace& stack = g_stacks[slot - 1];
+				if (stack.hash == hash && stack.depth == depth &&
+					memcmp(stack.addresses, addresses, depth * sizeof(void*)) == 0)
+					return slot - 1;
+			}
+			return NO_STACK;
+		}
+
+		void RecordSample(ThreadState* state, uint32_t allocator, uint32_t tag, void* p, size_t size)
+		{
+			state->bytes_until_sample = NextSampleDistance(state);
+			if (g_sample_interval == 0 || state->sampling)
+				return;
+
+			state->sampling = true;
+
+			void* addresses[MAX_STACK_DEPTH];
+			// Only skipping ourself, how many of the profiler and proxy frames are left depends on inlining
+			uint32_t depth = system::GetStackTrace(addresses, MAX_STACK_DEPTH, 1);
+			uint32_t stack = AddStackTrace(addresses, depth);
+
+			uint32_t home = SampleHome(p);
+			for (uint32_t i = 0; i < MAX_PROBE_COUNT; ++i)
+			{
+				Sample& sample = g_samples[(home + i) & (SAMPLE_TABLE_SIZE - 1)];
+				void* current = sample.p;
+				if (current != nullptr && current != SLOT_FREED)
+					continue;
+				if (thread::InterlockedCompareExchangePointer(&sample.p, SLOT_BUSY, current) != current)
+					continue;
+
+				sample.size = (uint32_t)Min(size, (size_t)0xffffffff);
+				sample.allocator = (uint16_t)allocator;
+				sample.tag = (uint16_t)tag;
+				sample.stack = stack;
+
+				// The home count goes up before the block is published and before the block
+				//	is handed to the caller, so no free of it can miss it
+				thread::InterlockedIncrement(&g_sample_homes[home]);
+				thread::InterlockedExchangePointer(&sample.p, p);
+				break;
+			}
+
+			state->sampling = false;
+		}
+
+		void RemoveSample(void* p)
+		{
+			uint32_t home = SampleHome(p);
+			if (g_sample_homes[home] == 0)
+				return;
+
+			for (uint32_t i = 0; i < MAX_PROBE_COUNT; ++i)
+			{
+				Sample& sample = g_samples[(home + i) & (SAMPLE_TABLE_SIZE - 1)];
+				if (sample.p == p)
+				{
+					thread::InterlockedDecrement(&g_sample_homes[home]);
+					thread::InterlockedExchangePointer(&sample.p, SLOT_FREED);
+					return;
+				}
+			}
+		}
+
+		bool IsSampledBlock(void* p)
+		{
+			return p != nullptr && p != SLOT_FREED && p != SLOT_BUSY;
+		}
+
+		void SendFrameStats()
+		{
+			ConfigValue msg;
+			msg.SetEmptyObject();
+			msg["type"].SetString("memory_stats");
+
+			ConfigValue& allocators = msg["allocators"];
+			allocators.SetEmptyArray();
+			for (uint32_t i = 0; i < g_allocator_count; ++i)
+			{
+				const memory_profiler::Stats& stats = g_allocator_stats[i];
+				if (!stats.name)
+					continue;
+
+				ConfigValue& value = allocators.Append();
+				value.SetEmptyObject();
+				value["name"].SetString(stats.name);
+				value["live_bytes"].SetInt(stats.live_bytes);
+				value["live_count"].SetInt(stats.live_count);
+				value["frame_bytes"].SetInt(stats.frame_bytes);
+				value["frame_count"].SetInt(stats.frame_count);
+			}
+
+			ConfigValue& tags = msg["tags"];
+			tags.SetEmptyArray();
+			for (uint32_t i = 0; i < g_tag_count; ++i)
+			{
+				const memory_profiler::Stats& stats = g_tag_stats[i];
+				ConfigValue& value = tags.Append();
+				value.SetEmptyObject();
+				value["name"].SetString(stats.name);
+				value["total_bytes"].SetInt(stats.total_bytes);
+				value["frame_bytes"].SetInt(stats.frame_bytes);
+				value["frame_count"].SetInt(stats.frame_count);
+			}
+
+			console::Server()->Send(msg);
+		}
+
+		/// Writes formatted text to the file, returns false on failure
+		bool WriteLine(File& file, const char* fmt, ...)
+		{
+			char line[512];
+
+			va_list args;
+			va_start(args, fmt);
+			int len = vsnprintf(line, sizeof(line) - 1, fmt, args);
+			va_end(args);
+
+			if (len < 0 || len >= (int)sizeof(line) - 1)
+				len = (int)sizeof(line) - 2;
+			line[len] = '\0';
+			return file.Write(line, (uint32_t)len) == (uint32_t)len;
+		}
+	}
+
+	//-------------------------------------------------------------------------------
+	void memory_profiler::Initialize()
+	{
+		if (g_initialized)
+			return;
+
+		g_thread_state = new (g_thread_state_buffer) ThreadLocalPtr(&ThreadExit);
+
+		// Tag 0 is for allocations made outside of any tagged scope
+		g_tag_names[0] = "Untagged";
+		g_tag_count = 1;
+
+		g_initialized = true;
+	}
+	void memory_profiler::Shutdown()
+	{
+		if (!g_initialized)
+			return;
+
+		g_initialized = false;
+		g_thread_state->~ThreadLocalPtr();
+		g_thread_state = nullptr;
+	}
+	void memory_profiler::SetSampleInterval(size_t bytes)
+	{
+		// Threads pick up the new interval after their next sample
+		g_sample_interval = (int64_t)bytes;
+	}
+	uint32_t memory_profiler::RegisterAllocator(const char* name)
+	{
+		ScopedLock<CriticalSection> lock(g_lock);
+		for (uint32_t i = 0; i < OTHER_ALLOCATOR; ++i)
+		{
+			if (g_allocator_names[i])
+				continue;
+
+			g_allocator_names[i] = name ? name : "Unnamed";
+			g_allocator_count = Max(g_allocator_count, i + 1);
+			return i;
+		}
+
+		if (!g_allocator_names[OTHER_ALLOCATOR])
+		{
+			logging::Warning("MemoryProfiler: Too many allocators, '%s' and any further allocators are counted as 'Other', "
+				"increase MAX_ALLOCATORS.", name ? name : "Unnamed");
+			g_allocator_names[OTHER_ALLOCATOR] = "Other";
+			g_allocator_count = MAX_ALLOCATORS;
+		}
+		return OTHER_ALLOCATOR;
+	}
+	void memory_profiler::UnregisterAllocator(uint32_t allocator)
+	{
+		Assert(allocator < MAX_ALLOCATORS);
+		if (allocator == OTHER_ALLOCATOR)
+			return; // Shared, may still be in use
+
+		ScopedLock<CriticalSection> lock(g_lock);
+		g_allocator_names[allocator] = nullptr;
+
+		// Nothing allocates through the slot anymore, so it's safe to reset the counters of other threads
+		memset(&g_exited_allocators[allocator], 0, sizeof(Counters));
+		memset(&g_allocator_stats[allocator], 0, sizeof(Stats));
+		for (uint32_t t = 0; t < MAX_THREADS; ++t)
+			memset(&g_threads[t].allocators[allocator], 0, sizeof(Counters));
+
+		// Drop any leaked samples so they don't show up for the next allocator in the slot
+		for (uint32_t i = 0; i < SAMPLE_TABLE_SIZE; ++i)
+		{
+			Sample& sample = g_samples[i];
+			void* p = sample.p;
+			if (!IsSampledBlock(p) || sample.allocator != allocator)
+				continue;
+			if (thread::InterlockedCompareExchangePointer(&sample.p, SLOT_FREED, p) == p)
+				thread::InterlockedDecrement(&g_sample_homes[SampleHome(p)]);
+		}
+	}
+	uint32_t memory_profiler::RegisterTag(const char* name)
+	{
+		ScopedLock<CriticalSection> lock(g_lock);
+		for (uint32_t i = 0; i < g_tag_count; ++i)
+		{
+			if (strcmp(g_tag_names[i], name) == 0)
+				return i;
+		}
+
+		AssertMsg(g_tag_count < MAX_TAGS, "MemoryProfiler: Too many tags, increase MAX_TAGS.");
+		if (g_tag_count == MAX_TAGS)
+			return 0;
+
+		g_tag_names[g_tag_count] = name;
+		return g_tag_count++;
+	}
+	void memory_profiler::PushTag(uint32_t tag)
+	{
+		ThreadState* state = GetThreadState();
+		if (!state)
+			return;
+
+		// Tags nested too deep are attributed to the innermost tag that fit
+		if (state->tag_depth < MAX_TAG_DEPTH)
+			state->tags[state->tag_depth] = tag;
+		++state->tag_depth;
+	}
+	void memory_profiler::PopTag()
+	{
+		ThreadState* state = GetThreadState();
+		if (state && state->tag_depth)
+			--state->tag_depth;
+	}
+	void memory_profiler::OnAllocate(uint32_t allocator, void* p, size_t size)
+	{
+		ThreadState* state = GetThreadState();
+		if (!state)
+			return;
+
+		uint32_t tag = 0;
+		if (state->tag_depth)
+			tag = state->tags[Min(state->tag_depth, MAX_TAG_DEPTH) - 1];
+
+		Counters& counters = state->allocators[allocator];
+		counters.alloc_bytes += size;
+		++counters.alloc_count;
+
+		Counters& tag_counters = state->tags_counters[tag];
+		tag_counters.alloc_bytes += size;
+		++tag_counters.alloc_count;
+
+		state->bytes_until_sample -= size;
+		if (state->bytes_until_sample < 0)
+			RecordSample(state, allocator, tag, p, size);
+	}
+	void memory_profiler::OnFree(uint32_t allocator, void* p, size_t size)
+	{
+		ThreadState* state = GetThreadState();
+		if (!state)
+			return;
+
+		Counters& counters = state->allocators[allocator];
+		counters.free_bytes += size;
+		++counters.free_count;
+
+		RemoveSample(p);
+	}
+	void memory_profiler::EndFrame()
+	{
+		Counters allocators[MAX_ALLOCATORS];
+		Counters tags[MAX_TAGS];
+
+		int64_t frame_count = 0;
+		{
+			ScopedLock<CriticalSection> lock(g_lock);
+			CollectCounters(allocators, tags);
+			for (uint32_t i = 0; i < g_allocator_count; ++i)
+			{
+				if (!g_allocator_names[i])
+					continue;
+
+				UpdateStats(g_allocator_stats[i], allocators[i], g_allocator_names[i]);
+				frame_count += g_allocator_stats[i].frame_count;
+			}
+			for (uint32_t i = 0; i < g_tag_count; ++i)
+			{
+				UpdateStats(g_tag_stats[i], tags[i], g_tag_names[i]);
+				g_tag_stats[i].live_bytes = g_tag_stats[i].live_count = 0;
+			}
+		}
+
+		MICROPROFILE_META_CPU("Allocations", int(frame_count));
+
+		if (g_send_frame_stats && console::Server())
+			SendFrameStats();
+	}
+	void memory_profiler::SetSendFrameStats(bool enable)
+	{
+		g_send_frame_stats = enable;
+	}
+	memory_profiler::Stats memory_profiler::GetAllocatorStats(uint32_t allocator)
+	{
+		Assert(allocator < MAX_ALLOCATORS);
+
+		Counters allocators[MAX_ALLOCATORS];
+		Counters tags[MAX_TAGS];
+
+		ScopedLock<CriticalSection> lock(g_lock);
+		CollectCounters(allocators, tags);
+
+		Stats stats = g_allocator_stats[allocator];
+		stats.name = g_allocator_names[allocator];
+		stats.live_bytes = allocators[allocator].alloc_bytes - allocators[allocator].free_bytes;
+		stats.live_count = allocators[allocator].alloc_count - allocators[allocator].free_count;
+		stats.total_bytes = allocators[allocator].alloc_bytes;
+		stats.total_count = allocators[allocator].alloc_count;
+		return stats;
+	}
+	memory_profiler::Stats memory_profiler::GetTagStats(uint32_t tag)
+	{
+		Assert(tag < MAX_TAGS);
+
+		Counters allocators[MAX_ALLOCATORS];
+		Counters tags[MAX_TAGS];
+
+		ScopedLock<CriticalSection> lock(g_lock);
+		CollectCounters(allocators, tags);
+
+		Stats stats = g_tag_stats[tag];
+		stats.name = g_tag_names[tag];
+		stats.live_bytes = stats.live_count = 0;
+		stats.total_bytes = tags[tag].alloc_bytes;
+		stats.total_count = tags[tag].alloc_count;
+		return stats;
+	}
+	uint32_t memory_profiler::GetAllocatorCount()
+	{
+		return g_allocator_count;
+	}
+	uint32_t memory_profiler::GetTagCount()
+	{
+		return g_tag_count;
+	}
+	bool memory_profiler::WriteHeapSnapshot(const char* path)
+	{
+		// Sum up the live samples per stack, the table is scanned without locking so blocks
+		//	allocated or freed while writing may or may not be included
+		uint32_t stack_count = g_stack_count;
+		int64_t* stack_bytes = (int64_t*)memory::DebugAllocator().Allocate(sizeof(int64_t) * 2 * (stack_count + 1));
+		int64_t* stack_blocks = stack_bytes + stack_count + 1;
+		memset(stack_bytes, 0, sizeof(int64_t) * 2 * (stack_count + 1));
+
+		int64_t total_bytes = 0, total_blocks = 0;
+		for (uint32_t i = 0; i < SAMPLE_TABLE_SIZE; ++i)
+		{
+			if (!IsSampledBlock(g_samples[i].p))
+				continue;
+
+			// Samples without a stack trace end up in the last entry
+			uint32_t stack = Min(g_samples[i].stack, stack_count);
+			stack_bytes[stack] += g_samples[i].size;
+			++stack_blocks[stack];
+			total_bytes += g_samples[i].size;
+			++total_blocks;
+		}
+
+		File file;
+		bool result = file.Open(path, File::WRITE);
+		if (result)
+		{
+			// Counts are the raw samples, pprof scales them by the sampling rate given in the header
+			result = WriteLine(file, "heap profile: %lld: %lld [%lld: %lld] @ heap_v2/%lld\n",
+				(long long)total_blocks, (long long)total_bytes, (long long)total_blocks, (long long)total_bytes,
+				(long long)g_sample_interval);
+
+			for (uint32_t s = 0; s <= stack_count && result; ++s)
+			{
+				if (stack_blocks[s] == 0)
+					continue;
+
+				result = WriteLine(file, "%lld: %lld [%lld: %lld] @",
+					(long long)stack_blocks[s], (long long)stack_bytes[s], (long long)stack_blocks[s], (long long)stack_bytes[s]);
+				if (s < stack_count)
+				{
+					const StackTrace& stack = g_stacks[s];
+					for (uint32_t i = 0; i < stack.depth && result; ++i)
+						result = WriteLine(file, " 0x%llx", (unsigned long long)(uintptr_t)stack.addresses[i]);
+				}
+				result = result && WriteLine(file, "\n");
+			}
+
+#ifdef SANDBOX_PLATFORM_LINUX
+			// Lets pprof map the addresses to the executable and shared libraries
+			File maps;
+			if (result && maps.Open("/proc/self/maps", File::READ))
+			{
+				result = WriteLine(file, "\nMAPPED_LIBRARIES:\n");
+
+				char buffer[4096];
+				uint32_t read;
+				while (result && (read = maps.Read(buffer, sizeof(buffer))) > 0)
+					result = file.Write(buffer, read) == read;
+				maps.Close();
+			}
+#endif
+			file.Close();
+		}
+
+		memory::DebugAllocator().Free(stack_bytes);
+
+		if (!result)
+			logging::Warning("MemoryProfiler: Failed to write heap snapshot to '%s'", path);
+		return result;
+	}
+	void memory_profiler::PrintLiveSamples(uint32_t allocator)
+	{
+		string symbol;
+		for (uint32_t i = 0; i < SAMPLE_TABLE_SIZE; ++i)
+		{
+			const Sample& sample = g_samples[i];
+			if (!IsSampledBlock(sample.p) || sample.allocator != allocator)
+				continue;
+
+			logging::Info("Allocation: 0x%p (Size: %u, Tag: %s):", sample.p, sample.size, g_tag_names[sample.tag]);
+			if (sample.stack == NO_STACK)
+				continue;
+
+			const StackTrace& stack = g_stacks[sample.stack];
+			for (uint32_t a = 0; a < stack.depth; ++a)
+			{
+				symbol.clear();
+				system::GetAddressSymbol(symbol, stack.addresses[a]);
+				logging::Info("\t%s", symbol.c_str());
+			}
+		}
+	}
+	//-------------------------------------------------------------------------------
+
+} // namespace sb
+
+#endif // SANDBOX_MEMORY_TRACKING
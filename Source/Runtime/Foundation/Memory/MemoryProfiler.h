@@ -0,0 +1,114 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __FOUNDATION_MEMORYPROFILER_H__
+#define __FOUNDATION_MEMORYPROFILER_H__
+
+#ifdef SANDBOX_MEMORY_TRACKING
+
+/// @brief Attributes allocations made by the calling thread within the current scope to the named tag
+#define MEMORY_TAG(name) \
+	static uint32_t sb_memory_tag_id = sb::memory_profiler::RegisterTag(name); \
+	sb::memory_profiler::ScopedTag sb_memory_tag(sb_memory_tag_id)
+
+#else
+
+#define MEMORY_TAG(name)
+
+#endif
+
+#ifdef SANDBOX_MEMORY_TRACKING
+
+namespace sb
+{
+
+	/// @brief Sampling memory profiler
+	///	Counts every allocation going through a traced allocator and records a stack trace for
+	///	about one allocation per sample interval bytes. Counters are kept in per-thread slots which
+	///	are only ever written by their own thread, the only shared state touched on allocation is
+	///	the table of sampled blocks, which is lock-free. All bookkeeping is in fixed tables so the
+	///	profiler itself never allocates.
+	namespace memory_profiler
+	{
+		enum
+		{
+			MAX_ALLOCATORS = 32,
+			OTHER_ALLOCATOR = MAX_ALLOCATORS - 1, ///< Shared by all allocators registered when the other slots are taken
+			MAX_TAGS = 64,
+			DEFAULT_SAMPLE_INTERVAL = 512 * 1024
+		};
+
+		struct Stats
+		{
+			const char* name;
+
+			int64_t live_bytes; ///< Bytes currently allocated, not available for tags
+			int64_t live_count; ///< Number of blocks currently allocated, not available for tags
+			int64_t total_bytes; ///< Bytes allocated since startup
+			int64_t total_count; ///< Number of allocations since startup
+
+			int64_t frame_bytes; ///< Bytes allocated during the last ended frame
+			int64_t frame_count; ///< Number of allocations during the last ended frame
+		};
+
+		void Initialize();
+		void Shutdown();
+
+		/// Sets the average number of bytes allocated between two samples, 0 disables sampling
+		void SetSampleInterval(size_t bytes);
+
+		/// @return Index for the allocator, used when reporting allocations
+		///	Returns OTHER_ALLOCATOR if all slots are taken, stats for it are the sum of all those allocators.
+		uint32_t RegisterAllocator(const char* name);
+
+		/// Releases the slot of an allocator so that it can be reused, any stats for it are lost
+		void UnregisterAllocator(uint32_t allocator);
+
+		/// @return Index for the tag with the specified name, the same name always gives the same tag
+		uint32_t RegisterTag(const char* name);
+
+		/// Tag for allocations made by the calling thread, see MEMORY_TAG
+		void PushTag(uint32_t tag);
+		void PopTag();
+
+		void OnAllocate(uint32_t allocator, void* p, size_t size);
+		void OnFree(uint32_t allocator, void* p, size_t size);
+
+		/// Collects the counters from all threads and calculates the rates for the frame
+		///	Sends the stats to the console if enabled by SetSendFrameStats.
+		void EndFrame();
+
+		/// Enables sending of per-frame stats to any console clients
+		void SetSendFrameStats(bool enable);
+
+		/// @return Stats for the allocator, the live and total counters are current while the
+		///		frame counters are from the last ended frame
+		Stats GetAllocatorStats(uint32_t allocator);
+
+		/// @return Stats for the tag as of the last ended frame
+		Stats GetTagStats(uint32_t tag);
+
+		/// @return Number of allocator slots ever used, the name of slots not currently in use is NULL
+		uint32_t GetAllocatorCount();
+		uint32_t GetTagCount();
+
+		/// Writes the sampled live blocks as a heap profile in the legacy gperftools format
+		///	The file can be read by pprof, e.g. "pprof --text <executable> <file>".
+		/// @return False if the file couldn't be written
+		bool WriteHeapSnapshot(const char* path);
+
+		/// Logs the sampled blocks still allocated through the specified allocator together with their stack traces
+		void PrintLiveSamples(uint32_t allocator);
+
+		class ScopedTag
+		{
+		public:
+			ScopedTag(uint32_t tag) { PushTag(tag); }
+			~ScopedTag() { PopTag(); }
+		};
+	};
+
+} // namespace sb
+
+#endif // SANDBOX_MEMORY_TRACKING
+
+#endif // __FOUNDATION_MEMORYPROFILER_H__
@@ -32,7 +32,7 @@ namespace sb
 		ProxyAllocator(const char* name, Allocator& backing);
 		~ProxyAllocator();
 
-		void* Allocate(size_t size, uint32_t alignment = DEFAULT_ALIGN);
+		void* Allocate(size_t size, uint32_t alignment = memory::DEFAULT_ALIGNMENT);
 		void* Reallocate(void* p, size_t size);
 		void Free(void* p);
 
@@ -72,43 +72,26 @@ namespace sb
 		void OnFree(void* p);
 	};
 
-	class VerboseMemoryTracker
+	/// @brief Tracker reporting to the sampling memory profiler
+	///	Cheap enough to keep enabled on realistic workloads, see memory_profiler for details.
+	class SamplingMemoryTracker
 	{
-	public:
-		static const uint32_t MAX_STACKTRACE_DEPTH = 32;
-
-		struct AllocationStackTrace
-		{
-			void* addresses[MAX_STACKTRACE_DEPTH];
-		};
+		ProxyAllocator<SamplingMemoryTracker>& _allocator;
+		uint32_t _index;
 
+		const SamplingMemoryTracker& operator=(const SamplingMemoryTracker&) { return *this; }
 	public:
-		ProxyAllocator<VerboseMemoryTracker>& _allocator;
-
-		// TODO: Change to alternative for std::hash_map
-		typedef std::unordered_map<void*, AllocationStackTrace, std::hash<void*>, std::equal_to<void*>, stl_debug_allocator<pair<void*, AllocationStackTrace>>> StackTraceMap;
-		StackTraceMap _allocation_stack_traces;
-		CriticalSection _allocation_stack_traces_lock;
-		static bool s_disable_stack_trace;
-
-		volatile uint32_t _allocation_count;
-		volatile uint32_t _bytes_allocated;
-
-		const VerboseMemoryTracker& operator=(const VerboseMemoryTracker&) { return *this; }
-	public:
-		VerboseMemoryTracker(ProxyAllocator<VerboseMemoryTracker>& owner);
-		~VerboseMemoryTracker();
+		SamplingMemoryTracker(ProxyAllocator<SamplingMemoryTracker>& owner);
+		~SamplingMemoryTracker();
 
 		void OnAllocate(void* p);
 		void OnFree(void* p);
 
-		/// @brief Prints memory stats about this proxy
-		void PrintMemoryStats();
+		/// @return Index of the allocator within the memory profiler
+		uint32_t GetIndex() const { return _index; }
 	};
-	typedef ProxyAllocator<VerboseMemoryTracker> VerboseTraceAllocator;
-
 
-	typedef ProxyAllocator<BasicMemoryTracker> TraceAllocator;
+	typedef ProxyAllocator<SamplingMemoryTracker> TraceAllocator;
 
 #else // SANDBOX_MEMORY_TRACKING
 
@@ -60,6 +60,52 @@ namespace sb
 	template <typename T, typename U>
 	inline bool operator!=(const stl_debug_allocator<T>&, const stl_debug_allocator<U>){ return false; }
 
+	/// @brief STL allocator using memory::ScratchAllocator
+	///
+	///	For containers that only live for the current frame, deallocation is essentially free
+	///	and memory is reclaimed when the frame ends.
+	template<typename T>
+	class stl_scratch_allocator : public std::allocator<T>
+	{
+	public:
+		typedef T          value_type;
+		typedef size_t     size_type;
+		typedef ptrdiff_t  difference_type;
+
+		typedef T*         pointer;
+		typedef const T*   const_pointer;
+
+		typedef T&         reference;
+		typedef const T&   const_reference;
+
+		template<typename U>
+		struct rebind
+		{
+			typedef stl_scratch_allocator<U> other;
+		};
+
+		stl_scratch_allocator() throw() {}
+		stl_scratch_allocator(const stl_scratch_allocator&) throw() {}
+		template<typename U> stl_scratch_allocator(const stl_scratch_allocator<U>&) throw() {}
+		~stl_scratch_allocator() throw() {}
+
+		pointer allocate(size_type n, const void* = 0)
+		{
+			return (pointer)memory::ScratchAllocator().Allocate(n*sizeof(T), __alignof(T));
+		}
+		void deallocate(pointer p, size_type)
+		{
+			memory::ScratchAllocator().Free(p);
+		}
+
+	};
+
+	template <typename T, typename U>
+	inline bool operator==(const stl_scratch_allocator<T>&, const stl_scratch_allocator<U>){ return true; }
+
+	template <typename T, typename U>
+	inline bool operator!=(const stl_scratch_allocator<T>&, const stl_scratch_allocator<U>){ return false; }
+
 } // namespace sb
 
 #endif // __FOUNDATION_STLALLOCATOR_H__
@@ -0,0 +1,270 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "ThreadCacheAllocator.h"
+#include "HeapAllocator.h"
+
+#include "Thread/Thread.h"
+#include "Thread/Lock.h"
+
+namespace sb
+{
+
+	namespace
+	{
+		/// Protects the lists of allocators and caches. The lock is global as a thread may exit
+		///	while the allocator owning its cache is being destroyed.
+		CriticalSection g_lock;
+		ThreadCacheAllocator* g_allocators = nullptr;
+
+		// Size classes are 16 bytes apart up to 256 bytes and 64 bytes apart up to MAX_SMALL_SIZE
+		const uint32_t FINE_CLASS_MAX_SIZE = 256;
+		const uint32_t FINE_CLASS_COUNT = FINE_CLASS_MAX_SIZE / 16;
+
+		/// Number of blocks moved between a thread cache and the heap at a time
+		const uint32_t BATCH_BYTES = 4096;
+		const uint32_t MIN_BATCH_COUNT = 4;
+		const uint32_t MAX_BATCH_COUNT = 64;
+
+		uint32_t ClassSize(uint32_t size_class)
+		{
+			if (size_class < FINE_CLASS_COUNT)
+				return (size_class + 1) * 16;
+			return FINE_CLASS_MAX_SIZE + (size_class - FINE_CLASS_COUNT + 1) * 64;
+		}
+
+		/// @return Smallest class fitting an allocation of the specified size
+		uint32_t SizeClass(size_t size)
+		{
+			if (size <= FINE_CLASS_MAX_SIZE)
+				return uint32_t((size + 15) / 16) - 1;
+			return FINE_CLASS_COUNT - 1 + uint32_t((size - FINE_CLASS_MAX_SIZE + 63) / 64);
+		}
+
+		/// @return Largest class fitting within a heap block of the specified size
+		uint32_t BlockClass(size_t block_size)
+		{
+			if (block_size <= FINE_CLASS_MAX_SIZE)
+				return uint32_t(block_size / 16) - 1;
+			return FINE_CLASS_COUNT - 1 + uint32_t((block_size - FINE_CLASS_MAX_SIZE) / 64);
+		}
+
+		/// @return True if a heap block of the specified size belongs in one of the classes. The heap rounds
+		///	blocks up, so a block from the largest class may be larger than MAX_SMALL_SIZE.
+		bool IsCachedBlock(size_t block_size)
+		{
+			return block_size >= ClassSize(0) && BlockClass(block_size) < ThreadCacheAllocator::SIZE_CLASS_COUNT;
+		}
+
+		uint32_t BatchCount(uint32_t size_class)
+		{
+			return Max(MIN_BATCH_COUNT, Min(BATCH_BYTES / ClassSize(size_class), MAX_BATCH_COUNT));
+		}
+	}
+
+	//-------------------------------------------------------------------------------
+	ThreadCacheAllocator::ThreadCacheAllocator(HeapAllocator& backing)
+		: _backing(backing),
+		_caches(nullptr),
+		_prev(nullptr),
+		_next(nullptr)
+	{
+		Assert(SizeClass(MAX_SMALL_SIZE) == SIZE_CLASS_COUNT - 1);
+		_thread_cache = SB_NEW(_backing, ThreadLocalPtr, &ThreadExit);
+
+		ScopedLock<CriticalSection> lock(g_lock);
+		_next = g_allocators;
+		if (g_allocators)
+			g_allocators->_prev = this;
+		g_allocators = this;
+	}
+	ThreadCacheAllocator::~ThreadCacheAllocator()
+	{
+		// Unregister the key first so that no new calls to ThreadExit are made for it
+		SB_DELETE(_backing, _thread_cache);
+		_thread_cache = nullptr;
+
+		// Threads already in ThreadExit either finish before this or find the allocator gone. Caches of
+		//	threads still running are destroyed as well, those threads may not use the allocator after this.
+		ScopedLock<CriticalSection> lock(g_lock);
+		if (_prev)
+			_prev->_next = _next;
+		else
+			g_allocators = _next;
+		if (_next)
+			_next->_prev = _prev;
+
+		while (_caches)
+			DestroyThreadCache(_caches);
+	}
+	//-------------------------------------------------------------------------------
+	void* ThreadCacheAllocator::Allocate(size_t size, uint32_t alignment)
+	{
+		Assert(size != 0);
+
+		if (size > MAX_SMALL_SIZE || alignment > memory::DEFAULT_ALIGNMENT)
+			return _backing.Allocate(size, alignment);
+
+		uint32_t size_class = SizeClass(size);
+		FreeList& list = GetThreadCache()->lists[size_class];
+		if (!list.head)
+			return Refill(list, size_class);
+
+		void* p = list.head;
+		list.head = *(void**)p;
+		--list.count;
+		return p;
+	}
+	void* ThreadCacheAllocator::Reallocate(void* p, size_t size)
+	{
+		Assert(size != 0);
+		if (p == nullptr)
+			return Allocate(size);
+
+		size_t block_size = _backing.GetAllocatedSize(p);
+		bool cached = IsCachedBlock(block_size);
+		if (!cached && size > MAX_SMALL_SIZE)
+			return _backing.Reallocate(p, size);
+
+		// Small blocks are only moved when growing, the heap would round a shrink up to about the same size anyway
+		if (size <= block_size && cached)
+			return p;
+
+		void* new_p = Allocate(size);
+		memcpy(new_p, p, Min(size, block_size));
+		Free(p);
+		return new_p;
+	}
+	void ThreadCacheAllocator::Free(void* p)
+	{
+		if (p == nullptr)
+			return;
+
+		size_t block_size = _backing.GetAllocatedSize(p);
+		if (!IsCachedBlock(block_size))
+		{
+			_backing.Free(p);
+			return;
+		}
+
+		uint32_t size_class = BlockClass(block_size);
+		FreeList& list = GetThreadCache()->lists[size_class];
+		*(void**)p = list.head;
+		list.head = p;
+		++list.count;
+
+		uint32_t batch_count = BatchCount(size_class);
+		if (list.count > 2 * batch_count)
+			Release(list, batch_count);
+	}
+	size_t ThreadCacheAllocator::GetAllocatedSize(void* p)
+	{
+		return _backing.GetAllocatedSize(p);
+	}
+	void ThreadCacheAllocator::FlushThreadCache()
+	{
+		ThreadCache* cache = (ThreadCache*)_thread_cache->Get();
+		if (!cache)
+			return;
+
+		for (uint32_t i = 0; i < SIZE_CLASS_COUNT; ++i)
+			Release(cache->lists[i], cache->lists[i].count);
+	}
+	//-------------------------------------------------------------------------------
+	ThreadCacheAllocator::ThreadCache* ThreadCacheAllocator::GetThreadCache()
+	{
+		ThreadCache* cache = (ThreadCache*)_thread_cache->Get();
+		if (cache)
+			return cache;
+
+		// The cache itself comes from the heap, allocating it through the cache would recurse
+		cache = (ThreadCache*)_backing.Allocate(sizeof(ThreadCache));
+		memset(cache, 0, sizeof(ThreadCache));
+		{
+			ScopedLock<CriticalSection> lock(g_lock);
+			cache->next = _caches;
+			if (_caches)
+				_caches->prev = cache;
+			_caches = cache;
+		}
+		_thread_cache->Set(cache);
+		return cache;
+	}
+	void* ThreadCacheAllocator::Refill(FreeList& list, uint32_t size_class)
+	{
+		Assert(!list.head);
+
+		void* blocks[MAX_BATCH_COUNT];
+		uint32_t count = BatchCount(size_class);
+		if (!_backing.AllocateBatch(ClassSize(size_class), count, blocks))
+			return nullptr;
+
+		// First block goes to the caller, the rest are linked in order
+		for (uint32_t i = 1; i < count - 1; ++i)
+			*(void**)blocks[i] = blocks[i + 1];
+		*(void**)blocks[count - 1] = nullptr;
+
+		list.head = blocks[1];
+		list.count = count - 1;
+		return blocks[0];
+	}
+	void ThreadCacheAllocator::Release(FreeList& list, uint32_t count)
+	{
+		void* blocks[MAX_BATCH_COUNT];
+		while (count)
+		{
+			uint32_t n = 0;
+			for (; n < MAX_BATCH_COUNT && n < count && list.head; ++n)
+			{
+				blocks[n] = list.head;
+				list.head = *(void**)list.head;
+			}
+			if (n == 0)
+				break;
+
+			list.count -= n;
+			count -= n;
+			_backing.FreeBatch(blocks, n);
+		}
+	}
+	void ThreadCacheAllocator::DestroyThreadCache(ThreadCache* cache)
+	{
+		for (uint32_t i = 0; i < SIZE_CLASS_COUNT; ++i)
+			Release(cache->lists[i], cache->lists[i].count);
+
+		if (cache->prev)
+			cache->prev->next = cache->next;
+		else
+			_caches = cache->next;
+		if (cache->next)
+			cache->next->prev = cache->prev;
+
+		_backing.Free(cache);
+	}
+#ifdef SANDBOX_PLATFORM_WIN
+	void WINAPI ThreadCacheAllocator::ThreadExit(void* cache)
+#else
+	void ThreadCacheAllocator::ThreadExit(void* cache)
+#endif
+	{
+		if (!cache)
+			return;
+
+		// The cache is only touched if its allocator is still alive, the destructor may already have freed it
+		ScopedLock<CriticalSection> lock(g_lock);
+		for (ThreadCacheAllocator* allocator = g_allocators; allocator; allocator = allocator->_next)
+		{
+			for (ThreadCache* c = allocator->_caches; c; c = c->next)
+			{
+				if (c == cache)
+				{
+					allocator->DestroyThreadCache(c);
+					return;
+				}
+			}
+		}
+	}
+	//-------------------------------------------------------------------------------
+
+} // namespace sb
@@ -0,0 +1,89 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __FOUNDATION_THREADCACHEALLOCATOR_H__
+#define __FOUNDATION_THREADCACHEALLOCATOR_H__
+
+#include "Memory.h"
+#include "Allocator.h"
+
+namespace sb
+{
+
+	class HeapAllocator;
+	class ThreadLocalPtr;
+
+	/// @brief Thread caching allocator for small objects
+	///	Keeps a free list per size class for every thread, so that most small allocations never
+	///	touch the lock of the backing heap. Lists are refilled from and returned to the heap in
+	///	batches. Cached blocks are regular heap blocks and the size class is derived from the heap
+	///	block size, which means blocks can be freed through either this allocator or the heap.
+	///	Large and over-aligned allocations go straight to the heap.
+	class ThreadCacheAllocator : public Allocator
+	{
+	public:
+		enum
+		{
+			MAX_SMALL_SIZE = 1024, ///< Largest allocation served by the cache
+			SIZE_CLASS_COUNT = 28
+		};
+
+		ThreadCacheAllocator(HeapAllocator& backing);
+		~ThreadCacheAllocator();
+
+		void* Allocate(size_t size, uint32_t alignment = memory::DEFAULT_ALIGNMENT);
+		void* Reallocate(void* p, size_t size);
+		void Free(void* p);
+
+		size_t GetAllocatedSize(void* p);
+
+		/// Returns all blocks cached by the calling thread to the heap
+		void FlushThreadCache();
+
+	private:
+		struct FreeList
+		{
+			void* head;
+			uint32_t count;
+		};
+
+		struct ThreadCache
+		{
+			ThreadCache* prev;
+			ThreadCache* next;
+
+			FreeList lists[SIZE_CLASS_COUNT];
+		};
+
+		ThreadCache* GetThreadCache();
+
+		/// Fills an empty list with a new batch of blocks from the heap
+		void* Refill(FreeList& list, uint32_t size_class);
+
+		/// Returns count blocks from the head of the list to the heap
+		void Release(FreeList& list, uint32_t count);
+
+		/// Returns all cached blocks and the cache itself to the heap, expects the global lock to be held
+		void DestroyThreadCache(ThreadCache* cache);
+
+#ifdef SANDBOX_PLATFORM_WIN
+		static void WINAPI ThreadExit(void* cache);
+#else
+		static void ThreadExit(void* cache);
+#endif
+
+		HeapAllocator& _backing;
+		ThreadLocalPtr* _thread_cache;
+
+		ThreadCache* _caches; ///< Protected by the global lock
+
+		/// Links in the list of live allocators, which lets an exiting thread check that its cache is still valid
+		ThreadCacheAllocator* _prev;
+		ThreadCacheAllocator* _next;
+
+	};
+
+} // namespace sb
+
+
+
+#endif // __FOUNDATION_THREADCACHEALLOCATOR_H__
@@ -68,7 +68,7 @@ namespace sb
 	{
 #ifdef SANDBOX_PLATFORM_WIN
 		_addr = addr.S_un.S_addr;
-#elif SANDBOX_PLATFORM_MACOSX
+#elif defined(SANDBOX_PLATFORM_POSIX)
 		_addr = addr.s_addr;
 #endif
 	}
@@ -81,7 +81,7 @@ namespace sb
 		in_addr addr;
 #ifdef SANDBOX_PLATFORM_WIN
 		addr.S_un.S_addr = _addr;
-#elif SANDBOX_PLATFORM_MACOSX
+#elif defined(SANDBOX_PLATFORM_POSIX)
 		addr.s_addr = _addr;
 #endif
 
@@ -93,7 +93,7 @@ namespace sb
 
 #ifdef SANDBOX_PLATFORM_WIN
 		addr.S_un.S_addr = _addr;
-#elif SANDBOX_PLATFORM_MACOSX
+#elif defined(SANDBOX_PLATFORM_POSIX)
 		addr.s_addr = _addr;
 #endif
 
@@ -239,7 +239,7 @@ namespace sb
 #ifdef SANDBOX_PLATFORM_WIN
 		shutdown(_socket, SD_BOTH);
 		closesocket(_socket);
-#elif SANDBOX_PLATFORM_MACOSX
+#elif defined(SANDBOX_PLATFORM_POSIX)
 		shutdown(_socket, SHUT_RDWR);
 		close(_socket);
 #endif
@@ -271,7 +271,7 @@ namespace sb
 		{
 			logging::Warning("Failed to set blocking mode for socket (Error: %d)", Socket::GetLastError());
 		}
-#elif SANDBOX_PLATFORM_MACOSX
+#elif defined(SANDBOX_PLATFORM_POSIX)
 		int flags = fcntl(_socket, F_GETFL, 0);
 		if (flags < 0)
 		{
@@ -8,7 +8,7 @@
 
 typedef int socklen_t;
 
-#elif SANDBOX_PLATFORM_MACOSX
+#elif defined(SANDBOX_PLATFORM_POSIX)
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
@@ -88,7 +88,7 @@ namespace sb
 	public:
 #ifdef SANDBOX_PLATFORM_WIN
 		typedef SOCKET Handle;
-#elif SANDBOX_PLATFORM_MACOSX
+#elif defined(SANDBOX_PLATFORM_POSIX)
 		typedef int Handle;
 #endif
 
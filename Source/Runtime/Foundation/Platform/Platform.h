@@ -8,6 +8,8 @@
 #include "Platform_Win.h"
 #elif SANDBOX_PLATFORM_MACOSX
 #include "Platform_Mac.h"
+#elif SANDBOX_PLATFORM_LINUX
+#include "Platform_Linux.h"
 #endif
 
 
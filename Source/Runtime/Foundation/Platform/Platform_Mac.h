@@ -5,6 +5,8 @@
 
 // Some macros and defines 
 
+#define SANDBOX_PLATFORM_POSIX
+
 #define DEBUG_BREAK __builtin_trap()
 #define ANALYSIS_ASSUME(expr)
 
@@ -37,14 +39,6 @@
 // type traits
 #include <type_traits>
 
-namespace std
-{
-	template< class T > struct has_trivial_assign : is_trivially_assignable< T, T > {};
-	template< class T > struct has_trivial_constructor : is_trivially_constructible< T > {};
-	template< class T > struct has_trivial_destructor : is_trivially_destructible< T > {};
-	template< class T > struct has_trivial_copy : is_trivially_copyable< T > {};
-}
-
 // Types
 
 // Some typedefs from windows, try avoid using these
@@ -30,6 +30,20 @@ namespace sb
 		///	@param address	Address to translate
 		void GetAddressSymbol(string& symbol, void* address);
 
+		/// @brief Reserves a range of address space without any memory backing it
+		///	@param huge_pages Asks for the range to be backed by huge pages once committed, ignored where not supported
+		///	@return Start of the range, NULL on failure
+		void* ReserveVirtualMemory(size_t size, bool huge_pages = false);
+
+		/// @brief Backs pages within a reserved range with memory, p and size should be page aligned
+		bool CommitVirtualMemory(void* p, size_t size);
+
+		/// @brief Returns the memory backing pages within a reserved range, the range itself stays reserved
+		void DecommitVirtualMemory(void* p, size_t size);
+
+		/// @brief Releases a range reserved with ReserveVirtualMemory
+		void ReleaseVirtualMemory(void* p, size_t size);
+
 	};
 
 } // namespace sb
@@ -0,0 +1,88 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "System.h"
+
+///
+/// @file System_Linux.cpp
+///	@brief Some platform dependent functions for the system
+///
+
+#include <execinfo.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+
+namespace sb
+{
+
+	uint32_t system::GetStackTrace(void** addresses, uint32_t max_addresses, uint32_t skip_count)
+	{
+		Assert(addresses);
+		Assert(max_addresses != 0);
+
+		// Skip this function as well
+		++skip_count;
+
+		void* frames[128];
+		int count = backtrace(frames, 128);
+		if (count <= (int)skip_count)
+			return 0;
+
+		uint32_t num_addresses = Min((uint32_t)count - skip_count, max_addresses);
+		memcpy(addresses, frames + skip_count, num_addresses * sizeof(void*));
+		return num_addresses;
+	}
+	void system::GetAddressSymbol(string& symbol, void* address)
+	{
+		char** symbols = backtrace_symbols(&address, 1);
+		if (symbols)
+		{
+			symbol = symbols[0];
+			free(symbols);
+		}
+		else
+		{
+			symbol = "(undefined)";
+		}
+	}
+
+	//-------------------------------------------------------------------------------
+	void system::GetSystemInfo(SystemInfo& info)
+	{
+		info.num_processors = (uint32_t)sysconf(_SC_NPROCESSORS_ONLN);
+		info.page_size = (uint32_t)sysconf(_SC_PAGESIZE);
+	}
+	//-------------------------------------------------------------------------------
+	void* system::ReserveVirtualMemory(size_t size, bool huge_pages)
+	{
+		void* p = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if (p == MAP_FAILED)
+			return nullptr;
+
+#ifdef MADV_HUGEPAGE
+		if (huge_pages)
+			madvise(p, size, MADV_HUGEPAGE);
+#else
+		(void)huge_pages;
+#endif
+		return p;
+	}
+	bool system::CommitVirtualMemory(void* p, size_t size)
+	{
+		return mprotect(p, size, PROT_READ | PROT_WRITE) == 0;
+	}
+	void system::DecommitVirtualMemory(void* p, size_t size)
+	{
+		// Drop the pages first, PROT_NONE alone would keep them resident
+		madvise(p, size, MADV_DONTNEED);
+		mprotect(p, size, PROT_NONE);
+	}
+	void system::ReleaseVirtualMemory(void* p, size_t size)
+	{
+		munmap(p, size);
+	}
+	//-------------------------------------------------------------------------------
+
+} // namespace sb
@@ -9,6 +9,8 @@
 ///	@brief Some platform dependent functions for the system
 ///
 
+#include <sys/mman.h>
+
 
 namespace sb
 {
@@ -41,6 +43,30 @@ void system::GetSystemInfo(SystemInfo& info)
 	info.page_size = getpagesize();
 }
 //-------------------------------------------------------------------------------
+void* system::ReserveVirtualMemory(size_t size, bool)
+{
+	// No transparent huge pages on OS X, huge_pages is ignored
+	void* p = mmap(NULL, size, PROT_NONE, MAP_PRIVATE | MAP_ANON, -1, 0);
+	if (p == MAP_FAILED)
+		return nullptr;
+
+	return p;
+}
+bool system::CommitVirtualMemory(void* p, size_t size)
+{
+	return mprotect(p, size, PROT_READ | PROT_WRITE) == 0;
+}
+void system::DecommitVirtualMemory(void* p, size_t size)
+{
+	// Drop the pages first, PROT_NONE alone would keep them resident
+	madvise(p, size, MADV_DONTNEED);
+	mprotect(p, size, PROT_NONE);
+}
+void system::ReleaseVirtualMemory(void* p, size_t size)
+{
+	munmap(p, size);
+}
+//-------------------------------------------------------------------------------
 
 } // namespace sb
 
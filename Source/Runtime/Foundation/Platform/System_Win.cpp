@@ -44,66 +44,12 @@ namespace sb
 
 	uint32_t system::GetStackTrace(void** addresses, uint32_t max_addresses, uint32_t skip_count)
 	{
-#ifdef SANDBOX_PLATFORM_WIN64
-		Assert(false); // Not implemtented
-#endif
-
 		Assert(addresses);
 		Assert(max_addresses != 0);
 
-		ScopedLock<CriticalSection> scoped_lock(g_stack_walk_lock);
-		system::SymInitialize();
-
-		HANDLE process_handle = GetCurrentProcess();
-		HANDLE thread_handle = GetCurrentThread();
-
-		// Capture current context
-		CONTEXT context;
-		RtlCaptureContext(&context);
-
-		// Intialize our stack frame struct
-		STACKFRAME64 frame;
-		ZeroMemory(&frame, sizeof(STACKFRAME64));
-
-		frame.AddrPC.Mode = AddrModeFlat;
-		frame.AddrFrame.Mode = AddrModeFlat;
-		frame.AddrStack.Mode = AddrModeFlat;
-
-#ifdef SANDBOX_PLATFORM_WIN64
-		frame.AddrPC.Offset = context.Rip;
-		frame.AddrFrame.Offset = context.Rbp;
-		frame.AddrStack.Offset = context.Rsp;
-#else
-		frame.AddrPC.Offset = context.Eip;
-		frame.AddrFrame.Offset = context.Ebp;
-		frame.AddrStack.Offset = context.Esp;
-#endif
-
-		// Skip the call here
-		skip_count++;
-		// Just walk through and skip storing our first skipped frames
-		for (uint32_t i = 0; i < skip_count; ++i)
-		{
-			BOOL res = StackWalk64(IMAGE_FILE_MACHINE_I386, process_handle, thread_handle, &frame, &context, NULL,
-				SymFunctionTableAccess64, SymGetModuleBase64, NULL);
-			if (!res || frame.AddrPC.Offset == 0) // Is this the end of our walk?
-			{
-				return 0;
-			}
-		}
-
-		for (uint32_t i = 0; i < max_addresses; ++i)
-		{
-			BOOL res = StackWalk64(IMAGE_FILE_MACHINE_I386, process_handle, thread_handle, &frame, &context, NULL,
-				SymFunctionTableAccess64, SymGetModuleBase64, NULL);
-
-			if (!res || frame.AddrPC.Offset == 0) // Is this the end of our walk?
-			{
-				return i;
-			}
-			addresses[i] = (void*)frame.AddrPC.Offset;
-		}
-		return max_addresses;
+		// Walks the stack using the unwind data (x64) or frame pointers (x86) without the symbol handler,
+		//	cheap enough to be used by the memory profiler when sampling allocations. Skips this function as well.
+		return RtlCaptureStackBackTrace(skip_count + 1, Min(max_addresses, 62u), addresses, NULL);
 	}
 	void system::GetAddressSymbol(string& symbol, void* address)
 	{
@@ -158,6 +104,25 @@ namespace sb
 		info.page_size = si.dwPageSize;
 	}
 	//-------------------------------------------------------------------------------
+	void* system::ReserveVirtualMemory(size_t size, bool)
+	{
+		// Large pages on Windows have to be committed when reserved and need a user privilege,
+		//	which doesn't fit committing on demand so huge_pages is ignored.
+		return VirtualAlloc(NULL, size, MEM_RESERVE, PAGE_NOACCESS);
+	}
+	bool system::CommitVirtualMemory(void* p, size_t size)
+	{
+		return VirtualAlloc(p, size, MEM_COMMIT, PAGE_READWRITE) != NULL;
+	}
+	void system::DecommitVirtualMemory(void* p, size_t size)
+	{
+		VirtualFree(p, size, MEM_DECOMMIT);
+	}
+	void system::ReleaseVirtualMemory(void* p, size_t)
+	{
+		VirtualFree(p, 0, MEM_RELEASE);
+	}
+	//-------------------------------------------------------------------------------
 
 } // namespace sb
 
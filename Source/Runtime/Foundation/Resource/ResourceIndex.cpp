@@ -0,0 +1,310 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "ResourceIndex.h"
+
+namespace sb
+{
+
+	namespace
+	{
+		enum { INITIAL_CAPACITY = 256 };
+
+		/// Marks a removed entry in the probe table, lookups have to probe past these
+		ResourceIndex::Slot* const TOMBSTONE = (ResourceIndex::Slot*)uintptr_t(1);
+
+		/// Reads the generation of a slot with a full barrier, so that reads of the slot can't be
+		///	moved across it.
+		INLINE long ReadGeneration(const ResourceIndex::Slot* slot)
+		{
+			return thread::InterlockedCompareExchange(const_cast<volatile long*>(&slot->generation), 0, 0);
+		}
+		/// Reads a counter with a full barrier
+		INLINE long ReadCounter(volatile long* counter)
+		{
+			return thread::InterlockedCompareExchange(counter, 0, 0);
+		}
+	}
+
+	//-------------------------------------------------------------------------------
+	ResourceIndex::ResourceIndex(Allocator& allocator)
+		: _table(nullptr),
+		_purge_count(0),
+		_size(0),
+		_tombstones(0),
+		_slot_blocks(nullptr),
+		_allocator(allocator)
+	{
+		_table = AllocateTable(INITIAL_CAPACITY);
+	}
+	ResourceIndex::~ResourceIndex()
+	{
+		FreeTable(_table);
+		for (uint32_t i = 0; i < _retired_tables.size(); ++i)
+		{
+			FreeTable(_retired_tables[i]);
+		}
+		_retired_tables.clear();
+
+		SlotBlock* block = _slot_blocks;
+		while (block)
+		{
+			SlotBlock* next = block->next;
+			_allocator.Free(block);
+			block = next;
+		}
+	}
+	//-------------------------------------------------------------------------------
+	ResourceIndex::Slot* ResourceIndex::Find(StringId64 type_id, StringId64 resource_id, long* generation_out) const
+	{
+		bool retry;
+		do
+		{
+			retry = false;
+
+			// Entries are moved around while tombstones are purged, we can't trust a miss until
+			//	the purge is done.
+			long purge_count = ReadCounter(const_cast<volatile long*>(&_purge_count));
+			if (purge_count & 1)
+			{
+				retry = true;
+				continue;
+			}
+
+			const Table* table = _table;
+
+			uint32_t mask = table->capacity - 1;
+			uint32_t i = Hash(type_id, resource_id) & mask;
+			for (uint32_t n = 0; n < table->capacity; ++n, i = (i + 1) & mask)
+			{
+				Slot* slot = table->entries[i];
+				if (slot == nullptr)
+					break; // End of the probe sequence
+
+				if (slot == TOMBSTONE)
+					continue;
+
+				// The slot may be removed and reused for another resource while we're reading it. The
+				//	generation is odd while a slot is free and changes on both release and reuse, so
+				//	the ids are only valid if the generation is even and the same before and after.
+				long generation = ReadGeneration(slot);
+				if (generation & 1)
+					continue; // Released after we read the table entry
+
+				bool match = (slot->type_id == type_id && slot->resource_id == resource_id);
+				if (ReadGeneration(slot) != generation)
+				{
+					retry = true;
+					break;
+				}
+
+				if (match)
+				{
+					if (generation_out)
+						*generation_out = generation;
+					return slot;
+				}
+			}
+
+			if (!retry && ReadCounter(const_cast<volatile long*>(&_purge_count)) != purge_count)
+				retry = true;
+		} while (retry);
+
+		return nullptr;
+	}
+	ResourceIndex::Slot* ResourceIndex::Insert(StringId64 type_id, StringId64 resource_id)
+	{
+		ScopedLock<CriticalSection> scoped_lock(_write_lock);
+		Assert(Find(type_id, resource_id) == nullptr);
+
+		// Keep the load factor, including tombstones, below 3/4
+		if ((_size + _tombstones + 1) * 4 > _table->capacity * 3)
+		{
+			// Only grow if the live entries actually need the space, otherwise just drop the tombstones
+			if ((_size + 1) * 2 > _table->capacity)
+				Grow();
+			else
+				PurgeTombstones();
+		}
+
+		Slot* slot = AllocateSlot();
+		slot->type_id = type_id;
+		slot->resource_id = resource_id;
+		slot->data = nullptr;
+		slot->ref_count = 0;
+
+		// Mark the slot as live again, this also orders the writes above before the slot is published
+		thread::InterlockedIncrement(&slot->generation);
+		Assert((slot->generation & 1) == 0);
+
+		if (InsertEntry(_table, slot))
+			--_tombstones;
+		++_size;
+
+		return slot;
+	}
+	void ResourceIndex::Remove(Slot* slot)
+	{
+		Assert(slot);
+		ScopedLock<CriticalSection> scoped_lock(_write_lock);
+
+		Table* table = _table;
+		uint32_t mask = table->capacity - 1;
+		uint32_t i = Hash(slot->type_id, slot->resource_id) & mask;
+		for (uint32_t n = 0; n < table->capacity; ++n, i = (i + 1) & mask)
+		{
+			if (table->entries[i] == slot)
+			{
+				thread::InterlockedExchangePointer((void* volatile*)&table->entries[i], TOMBSTONE);
+				--_size;
+				++_tombstones;
+				break;
+			}
+			Assert(table->entries[i] != nullptr); // Slot not in index
+		}
+
+		slot->data = nullptr;
+		slot->ref_count = 0;
+
+		// Odd generation marks the slot as free, invalidating handles and concurrent lookups
+		thread::InterlockedIncrement(&slot->generation);
+
+		_free_slots.push_back(slot);
+	}
+	void* ResourceIndex::GetData(const Slot* slot, long generation)
+	{
+		if (ReadGeneration(slot) != generation)
+			return nullptr;
+
+		// The slot may be released and reused for another resource while we read the data
+		void* data = slot->data;
+		if (ReadGeneration(slot) != generation)
+			return nullptr;
+
+		return data;
+	}
+	void ResourceIndex::Publish(Slot* slot, void* data)
+	{
+		Assert(slot);
+		thread::InterlockedExchangePointer((void* volatile*)&slot->data, data);
+	}
+	uint32_t ResourceIndex::Size() const
+	{
+		return _size;
+	}
+	void ResourceIndex::GetSlots(vector<Slot*>& slots) const
+	{
+		ScopedLock<CriticalSection> scoped_lock(_write_lock);
+
+		slots.reserve(slots.size() + _size);
+
+		const Table* table = _table;
+		for (uint32_t i = 0; i < table->capacity; ++i)
+		{
+			Slot* slot = table->entries[i];
+			if (slot != nullptr && slot != TOMBSTONE)
+				slots.push_back(slot);
+		}
+	}
+	//-------------------------------------------------------------------------------
+	ResourceIndex::Table* ResourceIndex::AllocateTable(uint32_t capacity)
+	{
+		Assert((capacity & (capacity - 1)) == 0); // Power of two
+
+		Table* table = (Table*)_allocator.Allocate(sizeof(Table) + sizeof(Slot*) * capacity);
+		table->capacity = capacity;
+		table->entries = (Slot* volatile*)memory::PointerAdd(table, sizeof(Table));
+		memory::Memset((void*)table->entries, 0, sizeof(Slot*) * capacity);
+
+		return table;
+	}
+	void ResourceIndex::FreeTable(Table* table)
+	{
+		_allocator.Free(table);
+	}
+	void ResourceIndex::Grow()
+	{
+		Table* table = AllocateTable(_table->capacity * 2);
+
+		const Table* old_table = _table;
+		for (uint32_t n = 0; n < old_table->capacity; ++n)
+		{
+			Slot* slot = old_table->entries[n];
+			if (slot != nullptr && slot != TOMBSTONE)
+				InsertEntry(table, slot);
+		}
+		_tombstones = 0;
+
+		// Readers may still be probing the old table so we can't free it here
+		Table* retired = (Table*)thread::InterlockedExchangePointer((void* volatile*)&_table, table);
+		_retired_tables.push_back(retired);
+	}
+	void ResourceIndex::PurgeTombstones()
+	{
+		Table* table = _table;
+
+		_purge_slots.clear();
+		for (uint32_t n = 0; n < table->capacity; ++n)
+		{
+			Slot* slot = table->entries[n];
+			if (slot != nullptr && slot != TOMBSTONE)
+				_purge_slots.push_back(slot);
+		}
+
+		// Odd count makes lookups retry any miss until we're done
+		thread::InterlockedIncrement(&_purge_count);
+
+		for (uint32_t n = 0; n < table->capacity; ++n)
+			thread::InterlockedExchangePointer((void* volatile*)&table->entries[n], nullptr);
+		for (uint32_t n = 0; n < _purge_slots.size(); ++n)
+			InsertEntry(table, _purge_slots[n]);
+		_tombstones = 0;
+
+		thread::InterlockedIncrement(&_purge_count);
+	}
+	bool ResourceIndex::InsertEntry(Table* table, Slot* slot)
+	{
+		uint32_t mask = table->capacity - 1;
+		uint32_t i = Hash(slot->type_id, slot->resource_id) & mask;
+		while (table->entries[i] != nullptr && table->entries[i] != TOMBSTONE)
+		{
+			i = (i + 1) & mask;
+		}
+		bool tombstone = (table->entries[i] == TOMBSTONE);
+
+		// Slot needs to be fully written before readers can see it
+		thread::InterlockedExchangePointer((void* volatile*)&table->entries[i], slot);
+		return tombstone;
+	}
+	ResourceIndex::Slot* ResourceIndex::AllocateSlot()
+	{
+		if (_free_slots.empty())
+		{
+			SlotBlock* block = (SlotBlock*)_allocator.Allocate(sizeof(SlotBlock));
+			block->next = _slot_blocks;
+			_slot_blocks = block;
+
+			for (uint32_t i = SLOT_BLOCK_SIZE; i > 0; --i)
+			{
+				Slot* slot = &block->slots[i - 1];
+				slot->data = nullptr;
+				slot->ref_count = 0;
+				slot->generation = 1; // Free
+				_free_slots.push_back(slot);
+			}
+		}
+
+		Slot* slot = _free_slots.back();
+		_free_slots.pop_back();
+		return slot;
+	}
+	uint32_t ResourceIndex::Hash(StringId64 type_id, StringId64 resource_id)
+	{
+		// Both ids already are murmur hashes so we only need to combine them
+		uint64_t h = type_id.GetId() ^ (resource_id.GetId() * 0x9E3779B97F4A7C15ull);
+		return (uint32_t)(h ^ (h >> 32));
+	}
+	//-------------------------------------------------------------------------------
+
+} // namespace sb
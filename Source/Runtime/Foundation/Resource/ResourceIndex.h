@@ -0,0 +1,128 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __FOUNDATION_RESOURCEINDEX_H__
+#define __FOUNDATION_RESOURCEINDEX_H__
+
+#include <Foundation/Thread/Thread.h>
+
+namespace sb
+{
+
+	/// @brief Open-addressing hash index mapping <Type ID, Resource ID> to resource slots
+	///
+	///	Slots are allocated in fixed blocks and never move, which means a pointer to a slot stays
+	///		valid for the lifetime of the index. A removed slot is recycled for later entries, its
+	///		generation is bumped when that happens so that cached handles can detect it.
+	///
+	///	Lookups are lock-free and may be performed from any thread, while inserts and removals
+	///		are serialized by an internal lock. The probe table is replaced when it grows, retired
+	///		tables are kept until the index is destroyed so that concurrent readers never touch
+	///		freed memory. Tables only ever double in size so the retired tables together are
+	///		smaller than the current one. Tombstones are purged in place, lookups that miss while
+	///		a purge is running are retried.
+	class ResourceIndex : NonCopyable
+	{
+	public:
+		struct Slot
+		{
+			StringId64 type_id;
+			StringId64 resource_id;
+
+			/// Resource data, NULL while the resource still is queued for loading
+			void* volatile data;
+
+			/// Every resource is reference counted to allow the same resource to be loaded/unloaded multiple times
+			///		without risking unloading it before all users are done with it.
+			uint32_t ref_count;
+
+			/// Incremented every time the slot is released and every time it's reused, odd while
+			///	the slot is free. Lookups check it to make sure the slot wasn't reused while reading it.
+			volatile long generation;
+		};
+
+		enum { SLOT_BLOCK_SIZE = 256 };
+
+		ResourceIndex(Allocator& allocator = memory::DefaultAllocator());
+		~ResourceIndex();
+
+		/// @brief Finds the slot for the specified resource
+		///	@remark Lock-free, can be called from any thread
+		///	@param generation Set to the generation of the slot the ids were matched at, if not NULL
+		///	@return The slot or NULL if the resource isn't in the index
+		Slot* Find(StringId64 type_id, StringId64 resource_id, long* generation = nullptr) const;
+
+		/// @brief Reads the resource data of a slot, making sure the slot wasn't reused meanwhile
+		///	@remark Lock-free, can be called from any thread
+		///	@return The data or NULL if the slot no longer has the specified generation
+		static void* GetData(const Slot* slot, long generation);
+
+		/// @brief Inserts a new empty slot for the specified resource
+		///	@remark The resource may not already exist in the index
+		Slot* Insert(StringId64 type_id, StringId64 resource_id);
+
+		/// @brief Removes a slot from the index and releases it for reuse
+		void Remove(Slot* slot);
+
+		/// @brief Publishes the resource data for the specified slot
+		void Publish(Slot* slot, void* data);
+
+		/// @return Number of resources in the index
+		uint32_t Size() const;
+
+		/// @brief Collects all slots currently in the index
+		void GetSlots(vector<Slot*>& slots) const;
+
+	private:
+		struct Table
+		{
+			uint32_t capacity; ///< Number of entries, always a power of two
+			Slot* volatile* entries;
+		};
+
+		struct SlotBlock
+		{
+			Slot slots[SLOT_BLOCK_SIZE];
+			SlotBlock* next;
+		};
+
+		Table* volatile _table;
+		vector<Table*> _retired_tables;
+
+		/// Incremented before and after every in-place purge of the table, odd while purging
+		volatile long _purge_count;
+		vector<Slot*> _purge_slots; ///< Scratch space for purging
+
+		uint32_t _size; ///< Number of live entries
+		uint32_t _tombstones; ///< Number of removed entries still occupying the probe table
+
+		SlotBlock* _slot_blocks;
+		vector<Slot*> _free_slots;
+
+		mutable CriticalSection _write_lock;
+		Allocator& _allocator;
+
+		Table* AllocateTable(uint32_t capacity);
+		void FreeTable(Table* table);
+
+		/// @brief Moves all entries into a new probe table of twice the size, dropping any tombstones
+		///	@remark Assumes _write_lock is held
+		void Grow();
+
+		/// @brief Rebuilds the probe table in place, dropping any tombstones
+		///	@remark Assumes _write_lock is held
+		void PurgeTombstones();
+
+		/// @brief Inserts the slot into the first free entry of its probe sequence
+		///	@return True if the entry was a tombstone
+		static bool InsertEntry(Table* table, Slot* slot);
+
+		Slot* AllocateSlot();
+
+		static uint32_t Hash(StringId64 type_id, StringId64 resource_id);
+	};
+
+} // namespace sb
+
+
+
+#endif // __FOUNDATION_RESOURCEINDEX_H__
@@ -5,6 +5,7 @@
 #include "ResourceLoader.h"
 #include "ResourceManager.h"
 
+#include "Filesystem/AsyncIO.h"
 #include "Filesystem/File.h"
 #include "Filesystem/FileSystem.h"
 #include "Profiler/Profiler.h"
@@ -110,7 +111,7 @@ namespace sb
 	//-------------------------------------------------------------------------------
 
 	ResourceLoader::LoadWorker::LoadWorker(FileSystem* file_system)
-		: _file_system(file_system), _stopping(0)
+		: _file_system(file_system), _async_io(nullptr), _stopping(0)
 	{
 	}
 	ResourceLoader::LoadWorker::~LoadWorker()
@@ -169,46 +170,163 @@ namespace sb
 	}
 	void ResourceLoader::LoadWorker::Run()
 	{
+		_async_io = async_io::Create();
+		Assert(_async_io);
+
+		AsyncIO::Completion completions[AsyncIO::DEFAULT_QUEUE_DEPTH];
+
 		while (_stopping == 0)
 		{
+			// Keep the IO queue filled
 			RequestInternal* internal_request = 0;
-			if (!PopRequest(&internal_request))
+			while (_async_io->Pending() < _async_io->QueueDepth() && PopRequest(&internal_request))
 			{
-				// If queue is empty: Sleep until notified
+				Assert(internal_request);
+				BeginRequest(internal_request);
+			}
+
+			if (_async_io->Pending() == 0)
+			{
+				// No reads in flight and queue is empty: Sleep until notified
 				_thread_wakeup_event.Wait();
 				continue;
 			}
-			Assert(internal_request);
 
+			uint32_t count = _async_io->Wait(completions, AsyncIO::DEFAULT_QUEUE_DEPTH);
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				FinishRead((PendingRead*)completions[i].user_data, completions[i].result);
+			}
+		}
+
+		// Finish any reads still in flight so that no request is left unprocessed
+		while (_async_io->Pending() != 0)
+		{
+			uint32_t count = _async_io->Wait(completions, AsyncIO::DEFAULT_QUEUE_DEPTH);
+			for (uint32_t i = 0; i < count; ++i)
+			{
+				FinishRead((PendingRead*)completions[i].user_data, completions[i].result);
+			}
+		}
+
+		async_io::Destroy(_async_io);
+		_async_io = nullptr;
+	}
+	void ResourceLoader::LoadWorker::BeginRequest(RequestInternal* request)
+	{
+		if (!request->request.load_callback)
+		{
+			ProcessRequest(request, FileStreamPtr());
+			return;
+		}
+		if (request->request.resource_path.Empty())
+		{
+			// Nothing to load, fails with a NULL result
+			thread::InterlockedExchange(&request->processed, 1);
+			return;
+		}
+
+		FileStreamPtr file = OpenFile(request->request, 0);
+		if (request->request.open_only)
+		{
+			if (file.Get())
+			{
+				ProcessRequest(request, file);
+			}
+			else
+			{
+				thread::InterlockedExchange(&request->processed, 1);
+			}
+			return;
+		}
+
+		int64_t length = file.Get() ? file->Length() : 0;
+		if (length <= 0 || length > MAX_ASYNC_READ_SIZE)
+		{
+			// Loaders typically perform lots of small reads so we give them a buffered stream
+			if (file.Get())
+			{
+				file.Reset();
+				file = OpenFile(request->request, FileStream::DEFAULT_BUFFER_SIZE);
+			}
+			ProcessRequest(request, file);
+			return;
+		}
+
+		if (request->request.read_size != 0 && request->request.read_size < length)
+			length = request->request.read_size;
+
+		PendingRead* read = new (_read_pool.Allocate()) PendingRead;
+		read->request = request;
+		read->file = file;
+		read->size = (uint32_t)length;
+		read->data = memory::Malloc(read->size);
+
+		AsyncIO::ReadRequest read_request;
+		read_request.file = &file->GetFile();
+		read_request.offset = 0;
+		read_request.dst = read->data;
+		read_request.size = read->size;
+		read_request.user_data = read;
+		if (!_async_io->Submit(read_request))
+		{
+			FinishRead(read, -1);
+		}
+	}
+	void ResourceLoader::LoadWorker::FinishRead(PendingRead* read, int64_t result)
+	{
+		Assert(read);
+		FileStreamPtr file = read->file;
+		if (result == (int64_t)read->size)
+		{
+			// The stream takes ownership of the data and serves all reads from memory
+			file->AttachFileData(read->data, read->size);
+		}
+		else
+		{
+			// Short or failed read, let the loader fall back to reading through a buffered stream
+			memory::Free(read->data);
+			file.Reset();
+			read->file.Reset();
+			file = OpenFile(read->request->request, FileStream::DEFAULT_BUFFER_SIZE);
+		}
+
+		RequestInternal* request = read->request;
+		read->~PendingRead();
+		_read_pool.Release(read);
+
+		ProcessRequest(request, file);
+	}
+	void ResourceLoader::LoadWorker::ProcessRequest(RequestInternal* request, FileStreamPtr file)
+	{
+		{
+			PROFILER_SCOPE("Load resource");
+
+			LoadContext context;
+			context.user_data = request->request.user_data;
+			context.file = file;
+			context.resource_path = request->request.resource_path.Ptr();
+			context.file_source = request->request.file_source;
+			context.result = 0;
+
+			// Process request
+			if (request->request.load_callback)
 			{
-				PROFILER_SCOPE("Load resource");
-
-				LoadContext context;
-				context.user_data = internal_request->request.user_data;
-				if (internal_request->request.file_source)
-				{
-					if (!internal_request->request.resource_path.empty())
-						context.file = internal_request->request.file_source->OpenFile(internal_request->request.resource_path.c_str(), File::READ);
-				}
-				else
-				{
-					if (!internal_request->request.resource_path.empty())
-						context.file = _file_system->OpenFile(internal_request->request.resource_path.c_str(), File::READ);
-				}
-				context.result = 0;
-
-				// Process request
-				if (internal_request->request.load_callback)
-				{
-					Assert(context.file.Get());
-					internal_request->request.load_callback(context);
-				}
-				context.file.Reset();
-
-				internal_request->request.result = context.result;
+				Assert(context.file.Get());
+				request->request.load_callback(context);
 			}
-			thread::InterlockedExchange(&internal_request->processed, 1);
+			context.file.Reset();
+
+			request->request.result = context.result;
 		}
+		thread::InterlockedExchange(&request->processed, 1);
+	}
+	FileStreamPtr ResourceLoader::LoadWorker::OpenFile(const Request& request, uint32_t buffer_size)
+	{
+		if (request.file_source)
+			return request.file_source->OpenFile(request.resource_path.Ptr(), File::READ, buffer_size);
+
+		return _file_system->OpenFile(request.resource_path.Ptr(), File::READ, buffer_size);
 	}
 
 } // namespace sb
@@ -4,6 +4,7 @@
 #define __FOUNDATION_RESOURCELOADER_H__
 
 #include <Foundation/Filesystem/FileStream.h>
+#include <Foundation/Container/FixedString.h>
 
 
 namespace sb
@@ -16,8 +17,12 @@ namespace sb
 	class FileSource;
 	class FileSystem;
 	class RenderResourceAllocator;
+	class AsyncIO;
 
 	/// @brief ResourceLoader is used to load resources on a separate thread
+	///
+	///	The loader thread reads whole resource files through AsyncIO, keeping several reads in flight
+	///		at once, and runs the load callback for each resource as soon as its data has arrived.
 	class ResourceLoader : NonCopyable
 	{
 	public:
@@ -28,6 +33,10 @@ namespace sb
 			StringId64 resource_id; ///< String id from resource name
 			FileStreamPtr file;
 
+			/// Path and source of the resource file, for resources that read more of their data after loading
+			const char* resource_path;
+			FileSource* file_source;
+
 			void* result; ///< Result from the load operation
 		};
 
@@ -42,11 +51,20 @@ namespace sb
 		/// @brief Load request
 		struct Request
 		{
-			Request() {}
+			Request() : file_source(nullptr), read_size(0), open_only(false), load_callback(nullptr), user_data(nullptr), result(nullptr) {}
 
-			string resource_path;
+			/// Stored inline so that queueing a request doesn't allocate. Requests with an empty path
+			///	fail without calling load_callback, leave it empty if the path didn't fit.
+			PathString resource_path;
 			FileSource* file_source;
 
+			/// Number of bytes to read before load_callback is called, 0 reads the whole file
+			uint32_t read_size;
+
+			/// Only open the file, the load callback gets an unbuffered stream and does its own reading.
+			///	The callback isn't called if the file couldn't be opened.
+			bool open_only;
+
 			// Callbacks
 			LoadFn load_callback;
 			void* user_data;
@@ -101,11 +119,27 @@ namespace sb
 		/// @brief Worker thread for loading resources
 		class LoadWorker : public Runnable
 		{
+			/// Files larger than this are read synchronously through a buffered stream instead
+			///		of being read into memory as a whole.
+			enum { MAX_ASYNC_READ_SIZE = 64 * 1024 * 1024 };
+
+			/// A file read in flight
+			struct PendingRead
+			{
+				RequestInternal* request;
+				FileStreamPtr file;
+				void* data;
+				uint32_t size;
+			};
+
 			SimpleThread _thread;
 			Event _thread_wakeup_event;
 
 			FileSystem* _file_system;
 
+			AsyncIO* _async_io;
+			MemoryPool<PendingRead, 32> _read_pool;
+
 			CriticalSection _request_lock;
 			deque<RequestInternal*> _request_queue;
 
@@ -135,6 +169,19 @@ namespace sb
 			/// @brief Is the thread running? 
 			bool IsRunning() const { return _thread.IsRunning(); }
 
+		private:
+			/// @brief Opens the file for a request and starts reading it
+			///	@remark Requests that can't be read asynchronously are processed directly
+			void BeginRequest(RequestInternal* request);
+
+			/// @brief Called when the read for a request has completed
+			void FinishRead(PendingRead* read, int64_t result);
+
+			/// @brief Runs the load callback for a request and marks it as processed
+			void ProcessRequest(RequestInternal* request, FileStreamPtr file);
+
+			FileStreamPtr OpenFile(const Request& request, uint32_t buffer_size);
+
 		};
 
 		FileSystem* _file_system;
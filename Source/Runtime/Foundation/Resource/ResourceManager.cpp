@@ -59,19 +59,19 @@ namespace sb
 	{
 		StringId64 type_id = resource_type, resource_id = resource_name;
 
-		ResourceDataMap::iterator data_it = _resource_data.find(ResourceId(type_id, resource_id));
+		ResourceIndex::Slot* slot = _resource_index.Find(type_id, resource_id);
 
 		// Check if resource is already loaded
-		if (data_it != _resource_data.end())
+		if (slot)
 		{
 			// Resource is already loaded so we just increase its reference count.
-			++data_it->second.ref_count;
+			++slot->ref_count;
 
 			return;
 		}
 
-		ResourceTypeMap::iterator type_it = _resource_types.find(type_id);
-		Assert(type_it != _resource_types.end());
+		ResourceTypeMap::Iterator type_it = _resource_types.Find(type_id);
+		Assert(type_it != _resource_types.End());
 
 		ResourceType& type = type_it->second;
 
@@ -83,10 +83,15 @@ namespace sb
 		ResourceLoader::Request request;
 		request.load_callback = type.load_callback;
 		request.user_data = type.user_data;
+		request.read_size = type.read_size;
 
 		// Resource path = {Resource name}.{Resource type} (e.g. "materials/floor.material")
-		stringstream ss; ss << resource_name << "." << resource_type;
-		request.resource_path = ss.str();
+		if (!request.resource_path.Format("%s.%s", resource_name, resource_type))
+		{
+			// Fail the request rather than loading whatever the truncated path points to
+			logging::Error("ResourceManager: Path of resource %s.%s is too long.", resource_name, resource_type);
+			request.resource_path.Clear();
+		}
 		request.file_source = source;
 		request.result = 0;
 
@@ -97,10 +102,8 @@ namespace sb
 		_load_requests.push_back(internal_request);
 
 		// Create a resource entry now so we still can keep track of the reference count while resource is queued
-		ResourceData resource_data;
-		resource_data.data = nullptr;
-		resource_data.ref_count = 1;
-		_resource_data[ResourceId(type_id, resource_id)] = resource_data;
+		slot = _resource_index.Insert(type_id, resource_id);
+		slot->ref_count = 1;
 
 		logging::Info("ResourceManager: Resource %s.%s (0x%llx) queued for loading.", resource_name, resource_type, resource_id.GetId());
 	}
@@ -120,64 +123,26 @@ namespace sb
 
 	void ResourceManager::Unload(const StringId64& type_id, const StringId64& resource_id)
 	{
-		ResourceDataMap::iterator data_it = _resource_data.find(ResourceId(type_id, resource_id));
-		Assert(data_it != _resource_data.end());
+		ResourceIndex::Slot* slot = _resource_index.Find(type_id, resource_id);
+		Assert(slot);
 
-		ResourceData& data = data_it->second;
-		if (--data.ref_count != 0) // There's still someone using this resource
+		if (--slot->ref_count != 0) // There's still someone using this resource
 			return;
 
-		void* resource_data = data.data;
-		Assert(resource_data != nullptr); // Resource isn't fully loaded
-
-		ResourceType& type = _resource_types[type_id];
-
-		// Call bring-out
-		if (type.bring_out_callback)
-			type.bring_out_callback(type.user_data, resource_data);
-
-		// Remove resource data from map
-		_resource_data.erase(data_it);
-
-		ResourceLoader::UnloadContext context;
-		context.user_data = type.user_data;
-		context.resource_data = resource_data;
-
-		// Call unload
-		if (type.unload_callback)
-			type.unload_callback(context);
-
+		ReleaseResource(slot);
 	}
 	void ResourceManager::UnloadAll()
 	{
-		ResourceDataMap::iterator data_it = _resource_data.begin(), data_end = _resource_data.end();
+		vector<ResourceIndex::Slot*> slots;
+		_resource_index.GetSlots(slots);
 
-		for (; data_it != data_end; ++data_it)
+		for (uint32_t i = 0; i < slots.size(); ++i)
 		{
-			ResourceData& data = data_it->second;
-			if (--data.ref_count != 0) // There's still someone using this resource
-				return;
-
-			void* resource_data = data.data;
-			Assert(resource_data != nullptr); // Resource isn't fully loaded
-
-			ResourceType& type = _resource_types[data_it->first.first];
-
-			// Call bring-out
-			if (type.bring_out_callback)
-				type.bring_out_callback(type.user_data, resource_data);
-
-			// Remove resource data from map
-			_resource_data.erase(data_it);
-
-			ResourceLoader::UnloadContext context;
-			context.user_data = type.user_data;
-			context.resource_data = resource_data;
-
-			// Call unload
-			if (type.unload_callback)
-				type.unload_callback(context);
+			ResourceIndex::Slot* slot = slots[i];
+			if (--slot->ref_count != 0) // There's still someone using this resource
+				continue;
 
+			ReleaseResource(slot);
 		}
 
 	}
@@ -270,14 +235,14 @@ namespace sb
 	//-------------------------------------------------------------------------------
 	bool ResourceManager::HasResource(const StringId64& type_id, const StringId64& resource_id)
 	{
-		ResourceDataMap::const_iterator it = _resource_data.find(ResourceId(type_id, resource_id));
-		if (it == _resource_data.end())
+		const ResourceIndex::Slot* slot = _resource_index.Find(type_id, resource_id);
+		if (!slot)
 		{
 			return false;
 		}
 
 		// If the data pointer is still NULL, the resource is still queued.
-		if (it->second.data == nullptr)
+		if (slot->data == nullptr)
 		{
 			return false;
 		}
@@ -286,20 +251,28 @@ namespace sb
 	}
 	void* ResourceManager::GetResource(const StringId64& type_id, const StringId64& resource_id)
 	{
-		ResourceDataMap::const_iterator it = _resource_data.find(ResourceId(type_id, resource_id));
-		Assert(it != _resource_data.end());
+		const ResourceIndex::Slot* slot = _resource_index.Find(type_id, resource_id);
+		Assert(slot);
 
-		const ResourceData& data = it->second;
+		void* data = slot->data;
 		// If the data pointer is still NULL, the resource is still queued.
-		Assert(data.data != nullptr);
+		Assert(data != nullptr);
 
-		return data.data;
+		return data;
+	}
+	FileSystem* ResourceManager::GetFileSystem()
+	{
+		return _file_system;
+	}
+	ResourceLoader* ResourceManager::GetResourceLoader()
+	{
+		return _resource_loader;
 	}
 	//-------------------------------------------------------------------------------
 	void ResourceManager::RegisterType(StringId64 type_id, const ResourceType& type)
 	{
-		ResourceTypeMap::const_iterator iter = _resource_types.find(type_id);
-		if (iter != _resource_types.end())
+		ResourceTypeMap::ConstIterator iter = _resource_types.Find(type_id);
+		if (iter != _resource_types.End())
 			return; // Already exists
 
 		logging::Info("ResourceManager: Registering resource type 0x%llx", type_id.GetId());
@@ -308,21 +281,21 @@ namespace sb
 	}
 	void ResourceManager::UnregisterType(StringId64 type_id)
 	{
-		ResourceTypeMap::iterator iter = _resource_types.find(type_id);
-		if (iter != _resource_types.end())
+		ResourceTypeMap::Iterator iter = _resource_types.Find(type_id);
+		if (iter != _resource_types.End())
 		{
 			logging::Info("ResourceManager: Unregistering resource type 0x%llx", type_id.GetId());
-			_resource_types.erase(iter);
+			_resource_types.Erase(iter);
 		}
 	}
 	void ResourceManager::UnregisterAllTypes()
 	{
-		_resource_types.clear();
+		_resource_types.Clear();
 	}
 	bool ResourceManager::HasType(StringId64 type_id)
 	{
-		ResourceTypeMap::const_iterator iter = _resource_types.find(type_id);
-		if (iter != _resource_types.end())
+		ResourceTypeMap::ConstIterator iter = _resource_types.Find(type_id);
+		if (iter != _resource_types.End())
 			return true;
 		return false;
 	}
@@ -343,19 +316,42 @@ namespace sb
 			}
 
 			// Resource entry was created when the request was made, we only need to its data
-			ResourceDataMap::iterator data_it = _resource_data.find(ResourceId(request.type_id, request.resource_id));
-			Assert(data_it != _resource_data.end());
-
-			data_it->second.data = result.result;
+			ResourceIndex::Slot* slot = _resource_index.Find(request.type_id, request.resource_id);
+			Assert(slot);
 
-			ResourceTypeMap::iterator type_it = _resource_types.find(request.type_id);
-			Assert(type_it != _resource_types.end());
+			ResourceTypeMap::Iterator type_it = _resource_types.Find(request.type_id);
+			Assert(type_it != _resource_types.End());
 
 			// Call bring-in function
 			if (type_it->second.bring_in_callback)
 				type_it->second.bring_in_callback(type_it->second.user_data, result.result);
+
+			// Publish the data after bring-in so that readers on other threads never see a resource that isn't brought in
+			_resource_index.Publish(slot, result.result);
 		}
 	}
+	void ResourceManager::ReleaseResource(ResourceIndex::Slot* slot)
+	{
+		void* resource_data = slot->data;
+		Assert(resource_data != nullptr); // Resource isn't fully loaded
+
+		ResourceType& type = _resource_types[slot->type_id];
+
+		// Call bring-out
+		if (type.bring_out_callback)
+			type.bring_out_callback(type.user_data, resource_data);
+
+		// Remove resource from the index, this also invalidates any handles to it
+		_resource_index.Remove(slot);
+
+		ResourceLoader::UnloadContext context;
+		context.user_data = type.user_data;
+		context.resource_data = resource_data;
+
+		// Call unload
+		if (type.unload_callback)
+			type.unload_callback(context);
+	}
 	//-------------------------------------------------------------------------------
 
 } // namespace sb
@@ -4,6 +4,9 @@
 #define __FOUNDATION_RESOURCEMANAGER_H__
 
 #include "ResourceLoader.h"
+#include "ResourceIndex.h"
+
+#include "Container/HashMap.h"
 
 
 
@@ -23,7 +26,8 @@ namespace sb
 			load_callback(nullptr),
 			unload_callback(nullptr),
 			bring_in_callback(nullptr),
-			bring_out_callback(nullptr)
+			bring_out_callback(nullptr),
+			read_size(0)
 		{
 		}
 
@@ -38,24 +42,49 @@ namespace sb
 		BringInFn	bring_in_callback;
 		/// Bring-out callback: Called on main-thread when resource is removed from the resource manager, should reverse the effect of bring_in_callback
 		BringOutFn	bring_out_callback;
+
+		/// Number of bytes read from the start of the resource file before load_callback is called,
+		///		0 reads the whole file. Types that only need the first part of their file to load
+		///		(e.g. streamed textures) should set this to avoid reading data they won't use.
+		uint32_t	read_size;
 	};
 
-	class ResourceManager
+	/// @brief Cached handle to a resource in the ResourceManager
+	///
+	///	A handle points directly at the resource slot in the manager, which means that once
+	///		a handle has been retrieved no further lookups are needed to access the resource.
+	///		The handle is invalidated if the resource is unloaded.
+	template<typename T>
+	class ResourceHandle
 	{
 	public:
-		struct ResourceData
+		ResourceHandle() : _slot(nullptr), _generation(0) {}
+		/// @param generation Generation of the slot when it was found, see ResourceIndex::Find
+		ResourceHandle(ResourceIndex::Slot* slot, long generation) : _slot(slot), _generation(generation) {}
+
+		/// @return True if the handle still refers to a resource in the manager
+		bool IsValid() const
 		{
-			ResourceData() : data(0), ref_count(0) {}
-			ResourceData(void* _data) : data(_data), ref_count(0) {}
+			return _slot != nullptr && _slot->generation == _generation;
+		}
 
-			void* data;
+		/// @return The resource data, or NULL if the resource is still queued or the handle is invalid
+		T* Get() const
+		{
+			if (_slot == nullptr)
+				return nullptr;
+			return (T*)ResourceIndex::GetData(_slot, _generation);
+		}
 
-			/// Every resource is reference counted to allow the same resource to be loaded/unloaded multiple times
-			///		without risking unloading it before all users are done with it.
-			uint32_t ref_count;
-		};
+		T* operator->() const { return Get(); }
 
+	private:
+		ResourceIndex::Slot* _slot;
+		long _generation;
+	};
 
+	class ResourceManager
+	{
 	public:
 		ResourceManager(FileSystem* file_system);
 		~ResourceManager();
@@ -107,12 +136,22 @@ namespace sb
 		/// @brief Returns the resoruce data for the specifed resource
 		void* GetResource(const StringId64& type_id, const StringId64& resource_id);
 
+		/// @brief Returns a cached handle for the specified resource
+		///
+		///	Lookups through the handle don't touch the resource index, use this for resources
+		///		that are accessed frequently (e.g. every frame).
+		template<typename T>
+		ResourceHandle<T> GetHandle(const StringId64& type_id, const StringId64& resource_id);
+
 		void RegisterType(StringId64 type_id, const ResourceType& type);
 		void UnregisterType(StringId64 type_id);
 		void UnregisterAllTypes();
 
 		bool HasType(StringId64 type_id);
 
+		FileSystem* GetFileSystem();
+		ResourceLoader* GetResourceLoader();
+
 	private:
 		/// Internal struct for request in the manager
 		struct ResourceRequest
@@ -125,15 +164,13 @@ namespace sb
 			ResourceRequest() : marker(false) {}
 		};
 
-		typedef map<StringId64, ResourceType> ResourceTypeMap;
-		typedef pair<StringId64, StringId64> ResourceId; // <Type ID, Resource ID>
-		typedef map<ResourceId, ResourceData> ResourceDataMap; // <Type ID, Resource ID> => Resource data
+		typedef HashMap<StringId64, ResourceType> ResourceTypeMap;
 		typedef deque<ResourceRequest> LoadRequestQueue;
 
 		FileSystem*		_file_system;
 
 		ResourceTypeMap _resource_types;
-		ResourceDataMap _resource_data;
+		ResourceIndex _resource_index; // <Type ID, Resource ID> => Resource data
 
 		LoadRequestQueue _load_requests;
 		uint32_t _queued_markers;
@@ -145,8 +182,22 @@ namespace sb
 		///	@param result Result from the ResourceLoader
 		void FinalizeRequest(const ResourceRequest& request, const ResourceLoader::Result& result);
 
+		/// @brief Calls bring-out and unload for a resource and removes it from the index
+		void ReleaseResource(ResourceIndex::Slot* slot);
+
 	};
 
+	//-------------------------------------------------------------------------------
+	template<typename T>
+	ResourceHandle<T> ResourceManager::GetHandle(const StringId64& type_id, const StringId64& resource_id)
+	{
+		long generation = 0;
+		ResourceIndex::Slot* slot = _resource_index.Find(type_id, resource_id, &generation);
+		Assert(slot);
+
+		return ResourceHandle<T>(slot, generation);
+	}
+
 } // namespace sb
 
 
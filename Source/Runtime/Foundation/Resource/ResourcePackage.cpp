@@ -3,6 +3,7 @@
 #include "Common.h"
 
 #include "ResourcePackage.h"
+#include "Container/FixedString.h"
 #include "Filesystem/File.h"
 #include "IO/MemoryStream.h"
 #include "Container/ConfigValue.h"
@@ -37,7 +38,7 @@ namespace sb
 	{
 		for (auto& resource : _resources)
 		{
-			_resource_manager->Unload(resource.type, resource.name);
+			_resource_manager->Unload(resource.type_id, resource.resource_id);
 		}
 		_state = UNLOADED;
 	}
@@ -109,31 +110,35 @@ namespace sb
 
 		Assert(package_type == ResourcePackage::DIRECTORY_PACKAGE);
 
-		string type = "";
-		string name = "";
+		PathString type;
+		PathString name;
 		for (uint32_t i = 0; i < count; ++i)
 		{
 			uint64_t id;
 			context.file->Read(&id, sizeof(uint64_t));
 
+			bool truncated = false;
 			char c;
 			while (context.file->Read(&c, 1))
 			{
 				if (c == '\0')
 					break;
-				type += c;
+				truncated |= !type.Append(c);
 			}
 			while (context.file->Read(&c, 1))
 			{
 				if (c == '\0')
 					break;
-				name += c;
+				truncated |= !name.Append(c);
 			}
 
-			package->AddResource(type.c_str(), name.c_str());
+			if (truncated)
+				logging::Error("Failed loading package: Path of resource %s.%s is too long.", name.Ptr(), type.Ptr());
+			else
+				package->AddResource(type.Ptr(), name.Ptr());
 
-			type.clear();
-			name.clear();
+			type.Clear();
+			name.Clear();
 		}
 	}
 	void package_resource::Unload(ResourceLoader::UnloadContext& context)
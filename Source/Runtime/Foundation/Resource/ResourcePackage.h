@@ -4,6 +4,7 @@
 #define __FOUNDATION_RESOURCEPACKAGE_H__
 
 #include "ResourceManager.h"
+#include "Container/InternedString.h"
 
 namespace sb
 {
@@ -42,11 +43,15 @@ namespace sb
 		struct Resource
 		{
 			Resource(const char* resource_type, const char* resource_name)
-				: type(resource_type), name(resource_name)
+				: type(resource_type), name(resource_name), type_id(resource_type), resource_id(resource_name)
 			{}
 
-			string type;
-			string name;
+			InternedString type;
+			InternedString name;
+
+			// Identifiers are kept so that unloading doesn't need to hash the strings again
+			StringId64 type_id;
+			StringId64 resource_id;
 		};
 
 		ResourceManager* _resource_manager;
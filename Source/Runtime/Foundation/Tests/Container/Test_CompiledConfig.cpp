@@ -0,0 +1,161 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Testing/Framework.h"
+#include <Foundation/Container/CompiledConfig.h>
+#include <Foundation/IO/MemoryStream.h>
+
+using namespace sb;
+
+namespace
+{
+	void Compile(const ConfigValue& root, vector<uint8_t>& data)
+	{
+		DynamicMemoryStream stream(&data);
+		compiled_config::Compile(root, stream);
+	}
+}
+
+TEST_CASE(CompiledConfig_Types)
+{
+	ConfigValue root;
+	root.SetEmptyObject();
+	root["int"].SetInt(-123);
+	root["uint"].SetUInt(uint64_t(1) << 40);
+	root["float"].SetFloat(0.5f);
+	root["bool"].SetBool(true);
+	root["string"].SetString("test");
+	root["null"].SetNull();
+
+	vector<uint8_t> data;
+	Compile(root, data);
+	ASSERT_EQUAL(data.size() % 8, 0);
+
+	CompiledConfig config;
+	ASSERT_EXPR(config.Open(data.data(), data.size()));
+
+	CompiledConfigValue value = config.Root();
+	ASSERT_EXPR(value.IsObject());
+	ASSERT_EQUAL(value.Size(), 6);
+	ASSERT_EQUAL(value["int"].AsInt(), -123);
+	ASSERT_EQUAL(value["uint"].AsUInt64(), uint64_t(1) << 40);
+	ASSERT_EQUAL_F(value["float"].AsFloat(), 0.5f, FLT_EPSILON);
+	ASSERT_EXPR(value["bool"].AsBool());
+	ASSERT_EQUAL_STR(value["string"].AsString(), "test");
+	ASSERT_EQUAL(value["string"].Size(), 4);
+	ASSERT_EXPR(value["null"].IsNull());
+
+	// Missing keys give null values, just like ConfigValue
+	ASSERT_EXPR(value["missing"].IsNull());
+	ASSERT_EQUAL(value["missing"].AsInt(), 0);
+}
+
+TEST_CASE(CompiledConfig_Nested)
+{
+	ConfigValue root;
+	root.SetEmptyObject();
+	ConfigValue& layers = root["layers"];
+	layers.SetEmptyArray();
+	for (int i = 0; i < 10; ++i)
+	{
+		ConfigValue& layer = layers.Append();
+		layer.SetEmptyObject();
+		layer["name"].SetString("layer");
+		layer["index"].SetInt(i);
+		layer["targets"].SetEmptyArray();
+		layer["targets"].Append().SetString("back_buffer");
+	}
+
+	vector<uint8_t> data;
+	Compile(root, data);
+
+	CompiledConfig config;
+	ASSERT_EXPR(config.Open(data.data(), data.size()));
+
+	CompiledConfigValue compiled_layers = config.Root()["layers"];
+	ASSERT_EXPR(compiled_layers.IsArray());
+	ASSERT_EQUAL(compiled_layers.Size(), 10);
+	for (uint32_t i = 0; i < compiled_layers.Size(); ++i)
+	{
+		ASSERT_EQUAL(compiled_layers[i]["index"].AsInt(), (int)i);
+		ASSERT_EQUAL_STR(compiled_layers[i]["targets"][0].AsString(), "back_buffer");
+	}
+
+	// Identical strings share storage in the string pool
+	ASSERT_EXPR(compiled_layers[0]["name"].AsString() == compiled_layers[9]["name"].AsString());
+}
+
+TEST_CASE(CompiledConfig_Iterator)
+{
+	ConfigValue root;
+	root.SetEmptyObject();
+	root["c"].SetInt(3);
+	root["a"].SetInt(1);
+	root["b"].SetInt(2);
+
+	vector<uint8_t> data;
+	Compile(root, data);
+
+	CompiledConfig config;
+	ASSERT_EXPR(config.Open(data.data(), data.size()));
+
+	// Members are iterated in key order, same as ConfigValue
+	int i = 1;
+	CompiledConfigValue value = config.Root();
+	for (CompiledConfigValue::ConstIterator it = value.Begin(); it != value.End(); ++it, ++i)
+	{
+		ASSERT_EQUAL(it->second.AsInt(), i);
+		ASSERT_EQUAL((int)it->first[0], 'a' + i - 1);
+	}
+	ASSERT_EQUAL(i, 4);
+}
+
+TEST_CASE(CompiledConfig_Invalid)
+{
+	CompiledConfig config;
+	ASSERT_EXPR(!config.IsOpen());
+	ASSERT_EXPR(config.Root().IsNull());
+
+	uint64_t garbage[8] = { 0 };
+	ASSERT_EXPR(!config.Open(garbage, sizeof(garbage)));
+
+	ConfigValue root;
+	root.SetEmptyObject();
+	root["a"].SetInt(1);
+
+	// Truncated data is rejected
+	vector<uint8_t> data;
+	Compile(root, data);
+	ASSERT_EXPR(!config.Open(data.data(), data.size() - 8));
+	ASSERT_EXPR(config.Open(data.data(), data.size()));
+	config.Close();
+
+	compiled_config::Node* nodes = (compiled_config::Node*)(data.data() + sizeof(compiled_config::Header));
+	compiled_config::Node* member = nodes + 1;
+	ASSERT_EQUAL(member->type, ConfigValue::INTEGER);
+
+	// References outside of the data are rejected
+	nodes[0].children.first_child = 1000;
+	ASSERT_EXPR(!config.Open(data.data(), data.size()));
+	nodes[0].children.first_child = 0;
+	ASSERT_EXPR(!config.Open(data.data(), data.size()));
+	nodes[0].children.first_child = 1;
+
+	nodes[0].children.first_key = 1;
+	ASSERT_EXPR(!config.Open(data.data(), data.size()));
+	nodes[0].children.first_key = 0;
+
+	member->type = ConfigValue::STRING;
+	member->string = 1000;
+	member->size = 0;
+	ASSERT_EXPR(!config.Open(data.data(), data.size()));
+	member->string = 0;
+	member->size = 100;
+	ASSERT_EXPR(!config.Open(data.data(), data.size()));
+	member->size = 1;
+	ASSERT_EXPR(config.Open(data.data(), data.size()));
+	ASSERT_EQUAL_STR(config.Root()["a"].AsString(), "a");
+	config.Close();
+
+	member->type = 100;
+	ASSERT_EXPR(!config.Open(data.data(), data.size()));
+}
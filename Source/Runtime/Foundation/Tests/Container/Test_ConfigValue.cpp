@@ -5,6 +5,36 @@
 
 using namespace sb;
 
+namespace
+{
+	/// Keeps track of the number of live allocations
+	class CountingAllocator : public Allocator
+	{
+	public:
+		CountingAllocator() : allocation_count(0) {}
+
+		void* Allocate(size_t size, uint32_t alignment)
+		{
+			++allocation_count;
+			return memory::Malloc(size, alignment);
+		}
+		void* Reallocate(void*, size_t)
+		{
+			return nullptr;
+		}
+		void Free(void* p)
+		{
+			--allocation_count;
+			memory::Free(p);
+		}
+		size_t GetAllocatedSize(void* p)
+		{
+			return memory::GetAllocatedSize(p);
+		}
+
+		uint32_t allocation_count;
+	};
+}
 
 TEST_CASE(ConfigValue_Types)
 {
@@ -55,6 +85,30 @@ TEST_CASE(ConfigValue_Array)
 	ASSERT_EQUAL(n.Size(), 0);
 }
 
+TEST_CASE(ConfigValue_ArrayAllocator)
+{
+	CountingAllocator allocator;
+	{
+		ConfigValue n;
+		n.SetEmptyArray(allocator);
+		for (uint32_t i = 0; i < 100; ++i)
+			n.Append().SetUInt(i);
+		ASSERT_EQUAL(allocator.allocation_count, 1);
+
+		// Copies don't use the allocator of the original
+		ConfigValue copy(n);
+		ASSERT_EQUAL(allocator.allocation_count, 1);
+		ASSERT_EQUAL(copy.Size(), 100);
+		ASSERT_EQUAL(copy[99].AsUInt(), 99);
+
+		// Switching to the default allocator releases the elements
+		n.SetEmptyArray();
+		ASSERT_EQUAL(allocator.allocation_count, 0);
+		ASSERT_EQUAL(n.Size(), 0);
+	}
+	ASSERT_EQUAL(allocator.allocation_count, 0);
+}
+
 TEST_CASE(ConfigValue_Object)
 {
 	ConfigValue n;
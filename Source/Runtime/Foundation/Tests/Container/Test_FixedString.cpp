@@ -0,0 +1,53 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Testing/Framework.h"
+
+#include <Foundation/Container/FixedString.h>
+
+using namespace sb;
+
+TEST_CASE(FixedString_Append)
+{
+	PathString str("textures/");
+	str += "floor";
+	str += '.';
+	str.Append("texture_src", 7);
+
+	ASSERT_EQUAL(str.Size(), 22);
+	ASSERT_EQUAL_STR(str.Ptr(), "textures/floor.texture");
+	ASSERT_EXPR(str == "textures/floor.texture");
+
+	str.Clear();
+	ASSERT_EXPR(str.Empty());
+	ASSERT_EQUAL_STR(str.Ptr(), "");
+}
+
+TEST_CASE(FixedString_Format)
+{
+	FixedString<16> str;
+	str.Format("%s.%s", "floor", "material");
+	ASSERT_EQUAL(str.Size(), 14);
+	ASSERT_EQUAL_STR(str.Ptr(), "floor.material");
+	ASSERT_EQUAL(str.Capacity(), 15);
+}
+
+TEST_CASE(FixedString_Truncate)
+{
+	FixedString<8> str;
+	ASSERT_EXPR(str.Set("1234567"));
+	ASSERT_EXPR(!str.Append('8'));
+	ASSERT_EQUAL_STR(str.Ptr(), "1234567");
+
+	ASSERT_EXPR(!str.Set("123456789"));
+	ASSERT_EQUAL(str.Size(), 7);
+	ASSERT_EQUAL_STR(str.Ptr(), "1234567");
+
+	ASSERT_EXPR(str.Format("%d", 1234567));
+	ASSERT_EXPR(!str.Format("%d", 12345678));
+	ASSERT_EQUAL_STR(str.Ptr(), "1234567");
+
+	str.Clear();
+	ASSERT_EXPR(str.Append("1234"));
+	ASSERT_EXPR(!str.Append("5678"));
+	ASSERT_EQUAL_STR(str.Ptr(), "1234567");
+}
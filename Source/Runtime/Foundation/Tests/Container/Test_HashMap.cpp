@@ -0,0 +1,109 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Testing/Framework.h"
+
+#include <Foundation/Container/HashMap.h>
+
+using namespace sb;
+
+namespace
+{
+	int instance_count = 0;
+
+	struct A
+	{
+		A() { ++instance_count; }
+		A(const A&) { ++instance_count; }
+		~A() { --instance_count; }
+	};
+}
+
+TEST_CASE(HashMap_Insert)
+{
+	HashMap<int, int> map;
+	ASSERT_EXPR(map.Find(1) == map.End());
+
+	ASSERT_EXPR(map.Insert(Pair<int, int>(1, 10)).second);
+	ASSERT_EXPR(!map.Insert(Pair<int, int>(1, 20)).second);
+	map[2] = 20;
+
+	ASSERT_EQUAL(map.Size(), 2);
+	ASSERT_EQUAL(map.Find(1)->second, 10);
+	ASSERT_EQUAL(map[2], 20);
+	ASSERT_EXPR(map.Find(3) == map.End());
+}
+
+TEST_CASE(HashMap_Iterator)
+{
+	HashMap<int, int> map;
+	for (int i = 0; i < 100; ++i)
+		map[i] = i * 2;
+
+	int count = 0, sum = 0;
+	for (HashMap<int, int>::Iterator it = map.Begin(); it != map.End(); ++it)
+	{
+		ASSERT_EQUAL(it->second, it->first * 2);
+		sum += it->first;
+		++count;
+	}
+	ASSERT_EQUAL(count, 100);
+	ASSERT_EQUAL(sum, 4950);
+}
+
+TEST_CASE(HashMap_Erase)
+{
+	HashMap<int, int> map;
+	for (int i = 0; i < 1000; ++i)
+		map[i * 16] = i;
+
+	// Erasing every other key shifts back the elements in the probe chains
+	for (int i = 0; i < 1000; i += 2)
+		ASSERT_EQUAL(map.Erase(i * 16), 1);
+	ASSERT_EQUAL(map.Erase(0), 0);
+	ASSERT_EQUAL(map.Size(), 500);
+
+	for (int i = 0; i < 1000; ++i)
+	{
+		HashMap<int, int>::Iterator it = map.Find(i * 16);
+		if (i % 2)
+		{
+			ASSERT_EXPR(it != map.End());
+			ASSERT_EQUAL(it->second, i);
+		}
+		else
+		{
+			ASSERT_EXPR(it == map.End());
+		}
+	}
+
+	map.Erase(map.Find(16));
+	ASSERT_EQUAL(map.Size(), 499);
+}
+
+TEST_CASE(HashMap_ConstructDestruct)
+{
+	{
+		HashMap<int, A> map;
+		for (int i = 0; i < 100; ++i)
+			map.Insert(Pair<int, A>(i, A()));
+
+		HashMap<int, A> copy(map);
+		ASSERT_EQUAL(instance_count, 200);
+
+		map.Erase(0);
+		copy.Clear();
+		ASSERT_EQUAL(instance_count, 99);
+	}
+	ASSERT_EQUAL(instance_count, 0);
+}
+
+TEST_CASE(HashMap_StringId)
+{
+	HashMap<StringId64, int> map;
+	map[StringId64("a")] = 1;
+	map[StringId64("b")] = 2;
+
+	ASSERT_EQUAL(map[StringId64("a")], 1);
+	ASSERT_EQUAL(map[StringId64("b")], 2);
+	ASSERT_EXPR(map.Find(StringId64("c")) == map.End());
+}
@@ -0,0 +1,70 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Testing/Framework.h"
+
+#include <Foundation/Container/InternedString.h>
+
+using namespace sb;
+
+namespace
+{
+	/// Interned during static initialization, possibly before anything in InternedString.cpp is initialized
+	const InternedString g_static_string("static");
+}
+
+TEST_CASE(InternedString_StaticInitialization)
+{
+	ASSERT_EXPR(g_static_string == InternedString("static"));
+	ASSERT_EQUAL_STR(g_static_string.c_str(), "static");
+}
+
+TEST_CASE(InternedString_Equality)
+{
+	InternedString a("texture");
+	InternedString b(string("texture"));
+	InternedString c("texture_src", 7);
+	InternedString d("material");
+
+	// Equal strings share the same characters
+	ASSERT_EXPR(a == b);
+	ASSERT_EXPR(a == c);
+	ASSERT_EXPR(a.c_str() == c.c_str());
+	ASSERT_EXPR(a != d);
+	ASSERT_EQUAL_STR(c.c_str(), "texture");
+	ASSERT_EQUAL(a.Size(), 7);
+	ASSERT_EQUAL(a.Hash(), b.Hash());
+
+	ASSERT_EXPR(d < a);
+	ASSERT_EXPR(!(a < d));
+	ASSERT_EXPR(!(a < b));
+
+	InternedString empty;
+	ASSERT_EXPR(empty.Empty());
+	ASSERT_EQUAL(empty.Size(), 0);
+	ASSERT_EQUAL_STR(empty.c_str(), "");
+	ASSERT_EXPR(empty == InternedString(""));
+}
+
+TEST_CASE(InternedString_Many)
+{
+	// Enough strings for the table to grow a few times
+	char buffer[32];
+	for (int i = 0; i < 10000; ++i)
+	{
+		sprintf(buffer, "string_%d", i);
+		InternedString str(buffer);
+	}
+	for (int i = 0; i < 10000; ++i)
+	{
+		sprintf(buffer, "string_%d", i);
+		InternedString str(buffer);
+		ASSERT_EQUAL_STR(str.c_str(), buffer);
+		ASSERT_EXPR(str == InternedString(buffer));
+	}
+
+	HashMap<InternedString, int> map;
+	map[InternedString("a")] = 1;
+	map[InternedString("b")] = 2;
+	ASSERT_EQUAL(map[InternedString("a")], 1);
+	ASSERT_EXPR(map.Find(InternedString("c")) == map.End());
+}
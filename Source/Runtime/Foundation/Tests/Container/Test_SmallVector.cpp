@@ -0,0 +1,61 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Testing/Framework.h"
+#include <Foundation/Container/SmallVector.h>
+
+using namespace sb;
+
+namespace
+{
+	template<typename T>
+	bool IsInline(const T& vec)
+	{
+		const uint8_t* p = (const uint8_t*)vec.Ptr();
+		return p >= (const uint8_t*)&vec && p < (const uint8_t*)(&vec + 1);
+	}
+}
+
+TEST_CASE(SmallVector_Inline)
+{
+	SmallVector<int, 4> vec;
+	ASSERT_EQUAL(vec.GetCapacity(), 4);
+
+	for (int i = 0; i < 4; ++i)
+		vec.PushBack(i);
+	ASSERT_EXPR(IsInline(vec));
+
+	vec.PushBack(4);
+	ASSERT_EXPR(!IsInline(vec));
+	ASSERT_EQUAL(vec.Size(), 5);
+	for (int i = 0; i < 5; ++i)
+		ASSERT_EQUAL(vec[i], i);
+
+	// Trimming moves the elements back to the inline buffer once they fit
+	vec.Erase(0, 2);
+	vec.Trim();
+	ASSERT_EXPR(IsInline(vec));
+	ASSERT_EQUAL(vec.GetCapacity(), 4);
+	ASSERT_EQUAL(vec[0], 2);
+	ASSERT_EQUAL(vec[2], 4);
+}
+
+TEST_CASE(SmallVector_Copy)
+{
+	SmallVector<int, 2> a;
+	a.PushBack(1);
+	a.PushBack(2);
+
+	SmallVector<int, 2> b(a);
+	ASSERT_EXPR(IsInline(b));
+	ASSERT_EQUAL(b.Size(), 2);
+	ASSERT_EQUAL(b[1], 2);
+
+	a.PushBack(3);
+	b = a;
+	ASSERT_EQUAL(b.Size(), 3);
+	ASSERT_EQUAL(b[2], 3);
+
+	Vector<int>& base = b;
+	base.Erase(0, 3);
+	ASSERT_EXPR(base.Empty());
+}
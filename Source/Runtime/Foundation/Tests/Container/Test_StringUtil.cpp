@@ -0,0 +1,109 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Testing/Framework.h"
+
+#include <Foundation/Container/StringUtil.h>
+
+using namespace sb;
+
+namespace
+{
+	string FormatInt(int64_t value)
+	{
+		char buffer[32];
+		return string(buffer, string_util::FormatInt(buffer, value));
+	}
+	string FormatDouble(double value)
+	{
+		char buffer[32];
+		return string(buffer, string_util::FormatDouble(buffer, value));
+	}
+	bool ParseFloat(const char* str, float& value)
+	{
+		const char* end = str + strlen(str);
+		return string_util::ParseFloat(str, end, value) == end;
+	}
+}
+
+TEST_CASE(StringUtil_FormatInt)
+{
+	ASSERT_EQUAL_STR(FormatInt(0).c_str(), "0");
+	ASSERT_EQUAL_STR(FormatInt(7).c_str(), "7");
+	ASSERT_EQUAL_STR(FormatInt(-10).c_str(), "-10");
+	ASSERT_EQUAL_STR(FormatInt(1234567890).c_str(), "1234567890");
+	ASSERT_EQUAL_STR(FormatInt(INT64_MIN).c_str(), "-9223372036854775808");
+	ASSERT_EQUAL_STR(FormatInt(INT64_MAX).c_str(), "9223372036854775807");
+
+	char buffer[32];
+	ASSERT_EQUAL(string_util::FormatUInt(buffer, UINT64_MAX), 20);
+	ASSERT_EXPR(strncmp(buffer, "18446744073709551615", 20) == 0);
+}
+
+TEST_CASE(StringUtil_FormatDouble)
+{
+	ASSERT_EQUAL_STR(FormatDouble(0.0).c_str(), "0.0");
+	ASSERT_EQUAL_STR(FormatDouble(-0.0).c_str(), "-0.0");
+	ASSERT_EQUAL_STR(FormatDouble(1.0).c_str(), "1.0");
+	ASSERT_EQUAL_STR(FormatDouble(-2.5).c_str(), "-2.5");
+	ASSERT_EQUAL_STR(FormatDouble(0.1).c_str(), "0.1");
+	ASSERT_EQUAL_STR(FormatDouble(0.001).c_str(), "0.001");
+	ASSERT_EQUAL_STR(FormatDouble(123456.75).c_str(), "123456.75");
+	ASSERT_EQUAL_STR(FormatDouble(1e20).c_str(), "1e+20");
+	ASSERT_EQUAL_STR(FormatDouble(1.5e-7).c_str(), "1.5e-7");
+
+	// Formatted values should read back to the exact same value
+	double values[] = { 1.0 / 3.0, 3.14159265358979, 1.7976931348623157e308, 4.9e-324, 2.2250738585072014e-308, 0.1f };
+	for (double value : values)
+	{
+		ASSERT_EXPR(strtod(FormatDouble(value).c_str(), nullptr) == value);
+	}
+}
+
+TEST_CASE(StringUtil_ParseFloat)
+{
+	float value;
+	ASSERT_EXPR(ParseFloat("0", value) && value == 0.0f);
+	ASSERT_EXPR(ParseFloat("-0.0", value) && value == 0.0f && signbit(value));
+	ASSERT_EXPR(ParseFloat("1.5", value) && value == 1.5f);
+	ASSERT_EXPR(ParseFloat("+2", value) && value == 2.0f);
+	ASSERT_EXPR(ParseFloat("-.25", value) && value == -0.25f);
+	ASSERT_EXPR(ParseFloat("3.", value) && value == 3.0f);
+	ASSERT_EXPR(ParseFloat("1e10", value) && value == 1e10f);
+	ASSERT_EXPR(ParseFloat("2.5E-3", value) && value == strtof("2.5E-3", nullptr));
+	ASSERT_EXPR(ParseFloat("1e-40", value) && value == strtof("1e-40", nullptr)); // Denormal, through strtod
+	ASSERT_EXPR(ParseFloat("3.4028235e38", value) && value == FLT_MAX);
+	ASSERT_EXPR(ParseFloat("12345678901234567890123", value) && value == strtof("12345678901234567890123", nullptr));
+	ASSERT_EXPR(ParseFloat("1.0000000596046448", value) && value == strtof("1.0000000596046448", nullptr)); // Rounds to a float midpoint as a double
+	ASSERT_EXPR(ParseFloat("-1.0000000596046448", value) && value == strtof("-1.0000000596046448", nullptr));
+	ASSERT_EXPR(ParseFloat("inf", value) && isinf(value));
+	ASSERT_EXPR(ParseFloat("nan", value) && isnan(value));
+
+	// Stops at the end of the number
+	const char* str = "1.25 2";
+	ASSERT_EXPR(string_util::ParseFloat(str, str + 6, value) == str + 4 && value == 1.25f);
+	ASSERT_EXPR(string_util::ParseFloat(str, str + 2, value) == str + 2 && value == 1.0f);
+
+	ASSERT_EXPR(string_util::ParseFloat(str, str, value) == nullptr);
+	ASSERT_EXPR(!ParseFloat("abc", value));
+	ASSERT_EXPR(!ParseFloat("1e", value));
+
+	// Printed with enough digits every float should read back exactly, same as with strtof
+	uint32_t seed = 12345;
+	char buffer[64];
+	for (uint32_t i = 0; i < 100000; ++i)
+	{
+		seed = seed * 1664525u + 1013904223u;
+		uint32_t bits = seed & 0x7f7fffff; // No INF or NaN
+		float expected;
+		memcpy(&expected, &bits, sizeof(float));
+		if (i & 1)
+			expected = (float)((seed >> 8) % 2000000) * 0.001f - 1000.0f; // Typical vertex data
+
+		const char* formats[] = { "%.9g", "%.6f", "%.3e" };
+		const char* format = formats[i % 3];
+		snprintf(buffer, sizeof(buffer), format, expected);
+
+		ASSERT_EXPR(ParseFloat(buffer, value));
+		ASSERT_EXPR(value == strtof(buffer, nullptr));
+	}
+}
@@ -115,4 +115,45 @@ TEST_CASE(Vector_PushBack)
 	ASSERT_EQUAL(vec[31], 1);
 }
 
+TEST_CASE(Vector_InsertNonPod)
+{
+	{
+		A a;
+		Vector<A> vec;
+		vec.Append(a, 4);
+
+		// Shifts some elements into unconstructed memory and some over existing elements
+		vec.Insert(1, a, 2);
+		ASSERT_EQUAL(vec.Size(), 6);
+		ASSERT_EQUAL(instance_count, 7);
+
+		vec.Reserve(32);
+		vec.Insert(5, a, 10);
+		ASSERT_EQUAL(vec.Size(), 16);
+		ASSERT_EQUAL(instance_count, 17);
+
+		vec.InsertArray(0, &a, 1);
+		vec.Erase(2, 8);
+		ASSERT_EQUAL(vec.Size(), 9);
+		ASSERT_EQUAL(instance_count, 10);
+	}
+	ASSERT_EQUAL(instance_count, 0);
+}
 
+TEST_CASE(Vector_InsertSelf)
+{
+	Vector<int> vec;
+	vec.PushBack(1);
+	vec.PushBack(2);
+	vec.PushBack(3);
+	vec.Trim();
+
+	// Element references stay valid even when the buffer has to grow
+	vec.PushBack(vec[0]);
+	vec.Insert(0, vec[2], 2);
+	ASSERT_EQUAL(vec.Size(), 6);
+	ASSERT_EQUAL(vec[0], 3);
+	ASSERT_EQUAL(vec[1], 3);
+	ASSERT_EQUAL(vec[2], 1);
+	ASSERT_EQUAL(vec[5], 1);
+}
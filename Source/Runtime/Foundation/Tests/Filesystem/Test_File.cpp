@@ -6,6 +6,7 @@
 #include <Foundation/Filesystem/FileSource.h>
 #include <Foundation/Filesystem/FileUtil.h>
 #include <Foundation/Filesystem/File.h>
+#include <Foundation/Filesystem/AsyncIO.h>
 
 using namespace sb;
 
@@ -60,6 +61,65 @@ TEST_CASE(File_Read)
 	ASSERT_EQUAL_STR(str, "string");
 }
 
+TEST_CASE(File_RenameReplace)
+{
+	FileSystem file_system("./");
+
+	FileSource* file_source = file_system.OpenFileSource("test");
+	{
+		FileStreamPtr file = file_source->OpenFile("rename_src", File::WRITE);
+		ASSERT_EXPR(file.Get() != NULL);
+		file->Write("new", 4);
+
+		file = file_source->OpenFile("rename_dst", File::WRITE);
+		ASSERT_EXPR(file.Get() != NULL);
+		file->Write("old", 4);
+	}
+
+	// Replaces the existing file
+	ASSERT_EXPR(file_util::RenameFile("./test/rename_src", "./test/rename_dst"));
+	ASSERT_EXPR(!file_util::RenameFile("./test/rename_src", "./test/rename_dst"));
+
+	FileStreamPtr file = file_source->OpenFile("rename_dst", File::READ);
+	ASSERT_EXPR(file.Get() != NULL);
+
+	char str[4];
+	ASSERT_EQUAL(file->Read(str, 4), 4);
+	ASSERT_EQUAL_STR(str, "new");
+}
+
+TEST_CASE(File_FileInfo)
+{
+	FileSystem file_system("./");
+
+	FileSource* file_source = file_system.OpenFileSource("test");
+	{
+		FileStreamPtr file = file_source->OpenFile("info_file", File::WRITE);
+		ASSERT_EXPR(file.Get() != NULL);
+		file->Write("12345", 5);
+	}
+
+	uint64_t size = 0;
+	FileTime modified;
+	ASSERT_EXPR(file_util::GetFileInfo("./test/info_file", size, modified));
+	ASSERT_EQUAL(size, 5);
+
+	FileTime source_modified;
+	ASSERT_EXPR(file_source->LastModifiedTime("info_file", source_modified));
+	ASSERT_EXPR(modified == source_modified);
+
+	// Touching only updates the time
+	ASSERT_EXPR(file_util::TouchFile("./test/info_file"));
+	FileTime touched;
+	ASSERT_EXPR(file_util::GetFileInfo("./test/info_file", size, touched));
+	ASSERT_EXPR(touched >= modified);
+	ASSERT_EQUAL(size, 5);
+
+	ASSERT_EXPR(!file_util::GetFileInfo("./test", size, modified));
+	ASSERT_EXPR(!file_util::GetFileInfo("./test/missing_file", size, modified));
+	ASSERT_EXPR(!file_util::TouchFile("./test/missing_file"));
+}
+
 TEST_CASE(File_Length)
 {
 	FileSystem file_system("./");
@@ -73,3 +133,116 @@ TEST_CASE(File_Length)
 	ASSERT_EQUAL(length, 7);
 }
 
+
+TEST_CASE(File_ReadBuffered)
+{
+	FileSystem file_system("./");
+
+	FileSource* file_source = file_system.OpenFileSource("test");
+	FileStreamPtr file = file_source->OpenFile("test_file", File::READ, 4);
+	ASSERT_EXPR(file.Get() != NULL);
+	ASSERT_EXPR(file->IsBuffered());
+
+	char str[7];
+	ASSERT_EQUAL(file->Read(str, 2), 2);
+	ASSERT_EQUAL(file->Read(str + 2, 5), 5);
+	ASSERT_EQUAL_STR(str, "string");
+	ASSERT_EQUAL(file->Tell(), 7);
+	ASSERT_EQUAL(file->Read(str, 1), 0);
+
+	// Seeking back within the file
+	ASSERT_EQUAL(file->Seek(3), 3);
+	ASSERT_EQUAL(file->Read(str, 4), 4);
+	ASSERT_EQUAL_STR(str, "ing");
+}
+
+TEST_CASE(File_ReadMany)
+{
+	FileSystem file_system("./");
+
+	FileSource* file_source = file_system.OpenFileSource("test");
+	for (uint32_t buffer_size = 0; buffer_size <= 8; buffer_size += 4)
+	{
+		FileStreamPtr file = file_source->OpenFile("test_file", File::READ, buffer_size);
+		ASSERT_EXPR(file.Get() != NULL);
+
+		char a[3], b[4];
+		File::ReadBuffer buffers[] = { { a, 3 }, { b, 4 } };
+		ASSERT_EQUAL(file->ReadMany(buffers, 2), 7);
+		ASSERT_EQUAL(a[0], 's');
+		ASSERT_EQUAL(a[2], 'r');
+		ASSERT_EQUAL_STR(b, "ing");
+	}
+}
+
+TEST_CASE(File_AsyncRead)
+{
+	FileSystem file_system("./");
+
+	FileSource* file_source = file_system.OpenFileSource("test");
+	FileStreamPtr file = file_source->OpenFile("test_file", File::READ);
+	ASSERT_EXPR(file.Get() != NULL);
+
+	AsyncIO* async_io = async_io::Create();
+	ASSERT_EXPR(async_io != NULL);
+
+	char a[4], b[3];
+	AsyncIO::ReadRequest requests[] = {
+		{ &file->GetFile(), 0, a, 3, a },
+		{ &file->GetFile(), 3, b, 3, b }
+	};
+	ASSERT_EXPR(async_io->Submit(requests[0]));
+	ASSERT_EXPR(async_io->Submit(requests[1]));
+
+	uint32_t completed = 0;
+	while (async_io->Pending() != 0)
+	{
+		AsyncIO::Completion completions[2];
+		uint32_t count = async_io->Wait(completions, 2);
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			ASSERT_EQUAL(completions[i].result, 3);
+			ASSERT_EXPR(completions[i].user_data == a || completions[i].user_data == b);
+			++completed;
+		}
+	}
+	ASSERT_EQUAL(completed, 2);
+
+	a[3] = '\0';
+	ASSERT_EQUAL_STR(a, "str");
+	ASSERT_EQUAL(b[0], 'i');
+	ASSERT_EQUAL(b[2], 'g');
+
+	async_io::Destroy(async_io);
+}
+
+TEST_CASE(File_AsyncReadDestroyInFlight)
+{
+	FileSystem file_system("./");
+
+	FileSource* file_source = file_system.OpenFileSource("test");
+	FileStreamPtr file = file_source->OpenFile("test_file", File::READ);
+	ASSERT_EXPR(file.Get() != NULL);
+
+	// Destroying the AsyncIO must not return before the kernel is done with the buffers
+	for (uint32_t submit = 0; submit < 2; ++submit)
+	{
+		AsyncIO* async_io = async_io::Create();
+		ASSERT_EXPR(async_io != NULL);
+
+		uint32_t count = async_io->QueueDepth();
+		char* buffers = new char[count * 3];
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			AsyncIO::ReadRequest request = { &file->GetFile(), 0, buffers + i * 3, 3, nullptr };
+			ASSERT_EXPR(async_io->Submit(request));
+		}
+
+		// Either with the reads still in the submission queue or handed to the kernel
+		if (submit)
+			async_io->Poll(nullptr, 0);
+
+		async_io::Destroy(async_io);
+		delete[] buffers;
+	}
+}
@@ -0,0 +1,117 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Testing/Framework.h"
+
+#include <Foundation/Json/Json.h>
+#include <Foundation/Json/JsonDocument.h>
+#include <Foundation/IO/MemoryStream.h>
+
+using namespace sb;
+
+namespace
+{
+	void MakeTestValue(ConfigValue& root)
+	{
+		root.SetEmptyObject();
+		root["int"].SetInt(-123);
+		root["uint"].SetUInt(UINT64_MAX);
+		root["float"].SetDouble(1.0);
+		root["bool"].SetBool(false);
+		root["string"].SetString("a \"quoted\"\n\tstring\x01");
+		root["null"].SetNull();
+		root["key with spaces = {}"].SetInt(1);
+		root["array"].SetEmptyArray();
+		root["array"].Append().SetDouble(0.1);
+		root["array"].Append().SetEmptyArray();
+		root["array"].Append().SetEmptyObject();
+		root["object"].SetEmptyObject();
+		root["object"]["a"].SetString("");
+	}
+
+	void CheckTestValue(const JsonValue& root, TestResult& _test_result)
+	{
+		ASSERT_EXPR(root.IsObject());
+		ASSERT_EQUAL(root.Size(), 9);
+		ASSERT_EQUAL(root["int"].AsInt(), -123);
+		ASSERT_EXPR(root["uint"].IsUInt());
+		ASSERT_EQUAL(root["uint"].AsUInt64(), UINT64_MAX);
+		ASSERT_EXPR(root["float"].IsFloat());
+		ASSERT_EXPR(root["float"].AsDouble() == 1.0);
+		ASSERT_EXPR(root["bool"].IsBool());
+		ASSERT_EXPR(!root["bool"].AsBool());
+		ASSERT_EQUAL_STR(root["string"].AsString(), "a \"quoted\"\n\tstring\x01");
+		ASSERT_EXPR(root["null"].IsNull());
+		ASSERT_EQUAL(root["key with spaces = {}"].AsInt(), 1);
+		ASSERT_EQUAL(root["array"].Size(), 3);
+		ASSERT_EXPR(root["array"][0].AsDouble() == 0.1);
+		ASSERT_EXPR(root["array"][1].IsArray());
+		ASSERT_EXPR(root["array"][2].IsObject());
+		ASSERT_EQUAL_STR(root["object"]["a"].AsString(), "");
+	}
+}
+
+TEST_CASE(Json_Writer)
+{
+	ConfigValue value;
+	MakeTestValue(value);
+
+	for (int format = 0; format < 2; ++format)
+	{
+		vector<uint8_t> data;
+		{
+			DynamicMemoryStream stream(&data);
+			json::Writer writer(stream, format != 0);
+			writer.Write(value);
+		}
+
+		JsonDocument document;
+		ASSERT_EXPR(document.Read((const char*)data.data(), data.size()));
+		CheckTestValue(document.Root(), _test_result);
+		if (_test_result.result == TestResult::FAILED)
+			return;
+	}
+}
+
+TEST_CASE(Json_WriterStreaming)
+{
+	vector<uint8_t> data;
+	{
+		DynamicMemoryStream stream(&data);
+		json::Writer writer(stream, false);
+		writer.BeginObject();
+		writer.Key("a");
+		writer.BeginArray();
+		writer.Int(1);
+		writer.Double(2.0);
+		writer.Null();
+		writer.EndArray();
+		writer.Key("b");
+		writer.Bool(true);
+		writer.EndObject();
+	}
+
+	string str((const char*)data.data(), data.size());
+	ASSERT_EQUAL_STR(str.c_str(), "{\"a\":[1,2.0,null],\"b\":true}");
+}
+
+TEST_CASE(SimplifiedJson_Writer)
+{
+	ConfigValue value;
+	MakeTestValue(value);
+
+	for (int format = 0; format < 2; ++format)
+	{
+		vector<uint8_t> data;
+		{
+			DynamicMemoryStream stream(&data);
+			simplified_json::Writer writer(stream, format != 0);
+			writer.Write(value);
+		}
+
+		JsonDocument document;
+		ASSERT_EXPR(document.Read((const char*)data.data(), data.size()));
+		CheckTestValue(document.Root(), _test_result);
+		if (_test_result.result == TestResult::FAILED)
+			return;
+	}
+}
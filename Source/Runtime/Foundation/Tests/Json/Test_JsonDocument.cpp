@@ -0,0 +1,143 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Testing/Framework.h"
+#include <Foundation/Json/JsonDocument.h>
+#include <Foundation/Json/SimplifiedJson.h>
+
+using namespace sb;
+
+namespace
+{
+	bool Parse(JsonDocument& document, const char* doc)
+	{
+		return document.Read(doc, strlen(doc));
+	}
+}
+
+TEST_CASE(JsonDocument_Json)
+{
+	const char* doc = "{ \"int\": -123, \"uint\": 18446744073709551615, \"float\": 0.5e1, \"bool\": true,"
+		" \"string\": \"test\", \"null\": null, \"array\": [1, 2, [3]], \"object\": {} }";
+
+	JsonDocument document;
+	ASSERT_EXPR(Parse(document, doc));
+
+	JsonValue root = document.Root();
+	ASSERT_EXPR(root.IsObject());
+	ASSERT_EQUAL(root.Size(), 8);
+	ASSERT_EQUAL(root["int"].AsInt(), -123);
+	ASSERT_EXPR(root["uint"].IsUInt());
+	ASSERT_EQUAL(root["uint"].AsUInt64(), UINT64_MAX);
+	ASSERT_EXPR(root["float"].IsFloat());
+	ASSERT_EQUAL_F(root["float"].AsFloat(), 5.0f, FLT_EPSILON);
+	ASSERT_EXPR(root["bool"].AsBool());
+	ASSERT_EQUAL_STR(root["string"].AsString(), "test");
+	ASSERT_EQUAL(root["string"].Size(), 4);
+	ASSERT_EXPR(root["null"].IsNull());
+	ASSERT_EQUAL(root["array"].Size(), 3);
+	ASSERT_EQUAL(root["array"][1].AsInt(), 2);
+	ASSERT_EQUAL(root["array"][2][0].AsInt(), 3);
+	ASSERT_EXPR(root["object"].IsObject());
+	ASSERT_EQUAL(root["object"].Size(), 0);
+	ASSERT_EXPR(root["missing"].IsNull());
+
+	// Members are sorted by key
+	const char* prev = "";
+	for (JsonValue::ConstIterator it = root.Begin(); it != root.End(); ++it)
+	{
+		ASSERT_EXPR(strcmp(prev, it->first) < 0);
+		prev = it->first;
+	}
+
+	ASSERT_EXPR(Parse(document, "[{\"a\": 1}, {\"a\": 2}]"));
+	ASSERT_EXPR(document.Root().IsArray());
+	ASSERT_EQUAL(document.Root()[1]["a"].AsInt(), 2);
+}
+
+TEST_CASE(JsonDocument_SimplifiedJson)
+{
+	const char* doc =
+		"name = \"test\"\n"
+		"size = [ 1 2 3 ]\n"
+		"my\\ key: { b = 2, a = 1 }\n"
+		"name = \"duplicate\"\n";
+
+	JsonDocument document;
+	ASSERT_EXPR(Parse(document, doc));
+
+	JsonValue root = document.Root();
+	ASSERT_EXPR(root.IsObject());
+	ASSERT_EQUAL(root.Size(), 3);
+	ASSERT_EQUAL_STR(root["name"].AsString(), "duplicate"); // Last one wins
+	ASSERT_EQUAL(root["size"].Size(), 3);
+	ASSERT_EQUAL(root["size"][2].AsInt(), 3);
+	ASSERT_EQUAL(root["my key"]["a"].AsInt(), 1);
+	ASSERT_EQUAL(root["my key"]["b"].AsInt(), 2);
+
+	// Empty documents are empty objects
+	ASSERT_EXPR(Parse(document, " \n"));
+	ASSERT_EXPR(document.Root().IsObject());
+	ASSERT_EQUAL(document.Root().Size(), 0);
+}
+
+TEST_CASE(JsonDocument_Strings)
+{
+	// Put strings with escapes across 64 byte block boundaries
+	string doc = "a = \"";
+	doc.append(57, 'x');
+	doc += "\\\\\", b = \"";
+	doc.append(60, 'y');
+	doc += "\\\"{}\\u00e5\\n\", c = \"\"";
+
+	JsonDocument document;
+	ASSERT_EXPR(document.Read(doc.c_str(), doc.size()));
+
+	JsonValue root = document.Root();
+	ASSERT_EQUAL(root.Size(), 3);
+	ASSERT_EQUAL(root["a"].Size(), 58);
+	ASSERT_EQUAL(root["a"].AsString()[57], '\\');
+	ASSERT_EQUAL(root["b"].Size(), 66);
+	ASSERT_EQUAL_STR(root["b"].AsString() + 60, "\"{}\xc3\xa5\n");
+	ASSERT_EQUAL_STR(root["c"].AsString(), "");
+}
+
+TEST_CASE(JsonDocument_Errors)
+{
+	JsonDocument document;
+	ASSERT_EXPR(!Parse(document, "a = \"unterminated"));
+	ASSERT_EXPR(!Parse(document, "a = [1, 2"));
+	ASSERT_EXPR(!Parse(document, "{ a = 1"));
+	ASSERT_EXPR(!Parse(document, "a 1"));
+	ASSERT_EXPR(!Parse(document, "a = tru"));
+	ASSERT_EXPR(!Parse(document, "a = 1x"));
+	ASSERT_EXPR(!Parse(document, "a = 0x10"));
+	ASSERT_EXPR(!Parse(document, "a = -inf"));
+	ASSERT_EXPR(!Parse(document, "a = -nan"));
+	ASSERT_EXPR(!Parse(document, "a = 01"));
+	ASSERT_EXPR(!Parse(document, "a = 1."));
+	ASSERT_EXPR(!Parse(document, "a = 1e"));
+	ASSERT_EXPR(!Parse(document, "a = -"));
+	ASSERT_EXPR(Parse(document, "a = -0.5E+2"));
+
+	// Rejected up front, the document is never read
+	ASSERT_EXPR(!document.Read("a = 1", 0xffffffff));
+	ASSERT_EQUAL_STR(document.GetErrorMessage().c_str(), "Document too large");
+
+	ASSERT_EXPR(!Parse(document, "a = 1\nb = ?"));
+	ASSERT_EQUAL_STR(document.GetErrorMessage().c_str(), "(Line: 2, Column: 5) Error: Unexpected character");
+	ASSERT_EXPR(document.Root().IsNull());
+}
+
+TEST_CASE(JsonDocument_ConfigValue)
+{
+	const char* doc = "a = 1 b = { c = [ \"d\" 2.5 ] }";
+
+	ConfigValue root;
+	simplified_json::Reader reader;
+	ASSERT_EXPR(reader.Read(doc, strlen(doc), root));
+
+	ASSERT_EXPR(root.IsObject());
+	ASSERT_EQUAL(root["a"].AsInt(), 1);
+	ASSERT_EQUAL_STR(root["b"]["c"][0].AsString(), "d");
+	ASSERT_EQUAL_F(root["b"]["c"][1].AsFloat(), 2.5f, FLT_EPSILON);
+}
@@ -0,0 +1,134 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Testing/Framework.h"
+#include <Foundation/Memory/HeapAllocator.h>
+#include <Foundation/Memory/FrameAllocator.h>
+#include <Foundation/Thread/Thread.h>
+#include <Foundation/Thread/Event.h>
+
+using namespace sb;
+
+namespace
+{
+	struct ThreadParams
+	{
+		FrameAllocator* allocator;
+		Event allocated;
+		Event* exit;
+	};
+
+	/// Allocates and then keeps the thread, and its block, alive until told to exit
+	void AllocateAndWait(void* data)
+	{
+		ThreadParams* params = (ThreadParams*)data;
+		for (uint32_t i = 0; i < 100; ++i)
+			memset(params->allocator->Allocate(64), 0xab, 64);
+		params->allocated.Set();
+		params->exit->Wait();
+	}
+}
+
+TEST_CASE(FrameAllocator_Allocate)
+{
+	HeapAllocator heap;
+	FrameAllocator allocator(64 * 1024, 2, heap);
+
+	void* p = allocator.Allocate(100);
+	ASSERT_EXPR(p != nullptr);
+	ASSERT_EQUAL(allocator.GetAllocatedSize(p), 100);
+
+	// Larger than a page
+	void* large = allocator.Allocate(1024 * 1024);
+	ASSERT_EXPR(large != nullptr);
+	ASSERT_EQUAL(allocator.GetAllocatedSize(large), 1024 * 1024);
+
+	allocator.Free(p);
+	allocator.Free(large);
+}
+
+TEST_CASE(FrameAllocator_Alignment)
+{
+	HeapAllocator heap;
+	FrameAllocator allocator(64 * 1024, 2, heap);
+
+	void* p8 = allocator.Allocate(3);
+	void* p16 = allocator.Allocate(100, 16);
+	void* p64 = allocator.Allocate(100, 64);
+
+	ASSERT_EQUAL(p8, memory::AlignForward(p8, 8));
+	ASSERT_EQUAL(p16, memory::AlignForward(p16, 16));
+	ASSERT_EQUAL(p64, memory::AlignForward(p64, 64));
+}
+
+TEST_CASE(FrameAllocator_Reallocate)
+{
+	HeapAllocator heap;
+	FrameAllocator allocator(64 * 1024, 2, heap);
+
+	uint8_t* p = (uint8_t*)allocator.Allocate(16);
+	for (uint32_t i = 0; i < 16; ++i)
+		p[i] = uint8_t(i);
+
+	// Last allocation grows in place
+	uint8_t* q = (uint8_t*)allocator.Reallocate(p, 256);
+	ASSERT_EQUAL(p, q);
+	ASSERT_EQUAL(allocator.GetAllocatedSize(q), 256);
+
+	allocator.Allocate(16);
+	q = (uint8_t*)allocator.Reallocate(q, 512);
+	ASSERT_NOT_EQUAL(p, q);
+	for (uint32_t i = 0; i < 16; ++i)
+		ASSERT_EQUAL(q[i], i);
+}
+
+TEST_CASE(FrameAllocator_Frames)
+{
+	HeapAllocator heap;
+	FrameAllocator allocator(64 * 1024, 2, heap);
+
+	void* first = allocator.Allocate(1000);
+	allocator.EndFrame();
+	ASSERT_EXPR(allocator.GetFrameUsage() >= 1000);
+
+	// Memory from the previous frame is still valid
+	void* second = allocator.Allocate(1000);
+	ASSERT_NOT_EQUAL(first, second);
+	ASSERT_EQUAL(allocator.GetAllocatedSize(first), 1000);
+	allocator.EndFrame();
+
+	// The first frame has now been reset and its memory is reused
+	void* third = allocator.Allocate(1000);
+	ASSERT_EQUAL(first, third);
+	allocator.EndFrame();
+
+	ASSERT_EXPR(allocator.GetPeakUsage() >= allocator.GetFrameUsage());
+}
+
+TEST_CASE(FrameAllocator_DestroyWithRunningThreads)
+{
+	HeapAllocator heap;
+
+	const uint32_t thread_count = 4;
+
+	ThreadParams params[thread_count];
+	SimpleThread threads[thread_count];
+	Event exit(true);
+	{
+		FrameAllocator allocator(64 * 1024, 2, heap);
+		for (uint32_t i = 0; i < thread_count; ++i)
+		{
+			params[i].allocator = &allocator;
+			params[i].exit = &exit;
+			threads[i].Start(AllocateAndWait, &params[i]);
+		}
+		for (uint32_t i = 0; i < thread_count; ++i)
+			params[i].allocated.Wait();
+
+		// Destroys the blocks of all threads while they're still running
+	}
+
+	// Exiting threads must not touch the destroyed allocator
+	exit.Set();
+	for (uint32_t i = 0; i < thread_count; ++i)
+		ASSERT_EXPR(threads[i].Join());
+}
@@ -12,8 +12,8 @@ TEST_CASE(LinearAllocator_Allocate)
 	void* p100 = allocator.Allocate(100);
 	void* p200 = allocator.Allocate(100);
 
-	ASSERT_NOT_EQUAL(p100, nullptr);
-	ASSERT_NOT_EQUAL(p200, nullptr);
+	ASSERT_EXPR(p100 != nullptr);
+	ASSERT_EXPR(p200 != nullptr);
 	ASSERT_EXPR(p200 > p100);
 
 	allocator.Reset();
@@ -35,3 +35,56 @@ TEST_CASE(LinearAllocator_Alignment)
 	ASSERT_EQUAL(p64, memory::AlignForward(p64, 64));
 
 }
+
+TEST_CASE(LinearAllocator_Arena)
+{
+	LinearAllocator::ArenaSettings settings(16 * 1024 * 1024);
+	settings.retain_size = 64 * 1024;
+
+	LinearAllocator allocator(settings);
+	uint8_t* p100 = (uint8_t*)allocator.Allocate(100);
+	ASSERT_EXPR(p100 != nullptr);
+
+	// Allocations are contiguous, even when growing beyond the committed memory
+	uint8_t* p1mb = (uint8_t*)allocator.Allocate(1024 * 1024, 16);
+	ASSERT_EQUAL(p1mb, memory::AlignForward(p100 + 100, 16));
+	memset(p1mb, 0xab, 1024 * 1024);
+
+	void* p64 = allocator.Allocate(100, 64);
+	ASSERT_EQUAL(p64, memory::AlignForward(p64, 64));
+
+	allocator.Reset();
+
+	uint8_t* p = (uint8_t*)allocator.Allocate(100);
+	ASSERT_EQUAL(p100, p);
+
+	// Decommitted memory is committed again when needed
+	p = (uint8_t*)allocator.Allocate(2 * 1024 * 1024);
+	memset(p, 0, 2 * 1024 * 1024);
+}
+
+TEST_CASE(LinearAllocator_ArenaOverflow)
+{
+	LinearAllocator::ArenaSettings settings(64 * 1024);
+
+	LinearAllocator allocator(settings);
+	uint8_t* first = (uint8_t*)allocator.Allocate(100);
+	ASSERT_EXPR(first != nullptr);
+
+	// Larger than the whole arena, continues in chunks
+	uint8_t* p = (uint8_t*)allocator.Allocate(1024 * 1024);
+	ASSERT_EXPR(p != nullptr);
+	memset(p, 0xab, 1024 * 1024);
+
+	for (uint32_t i = 0; i < 100; ++i)
+	{
+		p = (uint8_t*)allocator.Allocate(4096, 64);
+		ASSERT_EXPR(p != nullptr);
+		ASSERT_EQUAL(p, memory::AlignForward(p, 64));
+		memset(p, 0xcd, 4096);
+	}
+
+	// Back to the arena after a reset
+	allocator.Reset();
+	ASSERT_EQUAL((uint8_t*)allocator.Allocate(100), first);
+}
@@ -2,6 +2,7 @@
 
 #include "Testing/Framework.h"
 #include <Foundation/Memory/MemoryPool.h>
+#include <Foundation/Thread/Thread.h>
 
 using namespace sb;
 
@@ -17,7 +18,7 @@ TEST_CASE(MemoryPool_Allocate)
 
 	MemoryPool<Obj, 4> pool;
 	Obj* obj = new (pool.Allocate()) Obj();
-	ASSERT_NOT_EQUAL(obj, nullptr);
+	ASSERT_EXPR(obj != nullptr);
 	ASSERT_EQUAL(obj->a, 1);
 
 	obj->a = 2;
@@ -28,7 +29,7 @@ TEST_CASE(MemoryPool_Allocate)
 	for (int i = 0; i < 128; ++i)
 	{
 		objs[i] = new (pool.Allocate()) Obj();
-		ASSERT_NOT_EQUAL(objs[i], nullptr);
+		ASSERT_EXPR(objs[i] != nullptr);
 		int j = pool.GetIndex(objs[i]);
 		ASSERT_EQUAL(pool.GetObject(j), objs[i]);
 	}
@@ -47,9 +48,96 @@ TEST_CASE(MemoryPool_Allocate)
 	for (int i = 0; i < 128; ++i)
 	{
 		objs[i] = new (pool.Allocate()) Obj();
-		ASSERT_NOT_EQUAL(objs[i], nullptr);
+		ASSERT_EXPR(objs[i] != nullptr);
 		int j = pool.GetIndex(objs[i]);
 		ASSERT_EQUAL(pool.GetObject(j), objs[i]);
 	}
 }
 
+TEST_CASE(MemoryPool_Grow)
+{
+	// Far more objects than the first blocks hold, the pool keeps growing
+	MemoryPool<uint32_t, 4> pool;
+
+	const uint32_t count = 100000;
+	vector<uint32_t*> objs(count);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		objs[i] = pool.Allocate();
+		ASSERT_EXPR(objs[i] != nullptr);
+		*objs[i] = i;
+	}
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		ASSERT_EQUAL(*objs[i], i);
+		ASSERT_EXPR(pool.GetObject(pool.GetIndex(objs[i])) == objs[i]);
+	}
+	ASSERT_EXPR(pool.GetObject(count * 4) == nullptr);
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		pool.Release(objs[i]);
+	}
+}
+
+namespace
+{
+	struct PoolObj
+	{
+		uint32_t owner;
+		uint32_t value;
+	};
+	typedef MemoryPool<PoolObj, 64> ThreadedPool;
+
+	struct PoolThreadParams
+	{
+		ThreadedPool* pool;
+		uint32_t id;
+		bool failed;
+	};
+
+	void AllocateAndRelease(void* data)
+	{
+		PoolThreadParams* params = (PoolThreadParams*)data;
+
+		PoolObj* objs[32];
+		for (uint32_t i = 0; i < 10000; ++i)
+		{
+			uint32_t count = 1 + i % 32;
+			for (uint32_t j = 0; j < count; ++j)
+			{
+				objs[j] = params->pool->Allocate();
+				objs[j]->owner = params->id;
+				objs[j]->value = j;
+			}
+			// No other thread may have been handed the same object
+			for (uint32_t j = 0; j < count; ++j)
+			{
+				if (objs[j]->owner != params->id || objs[j]->value != j)
+					params->failed = true;
+				params->pool->Release(objs[j]);
+			}
+		}
+	}
+}
+
+TEST_CASE(MemoryPool_Threads)
+{
+	ThreadedPool pool;
+
+	const uint32_t thread_count = 4;
+	PoolThreadParams params[thread_count];
+	SimpleThread threads[thread_count];
+	for (uint32_t i = 0; i < thread_count; ++i)
+	{
+		params[i].pool = &pool;
+		params[i].id = i;
+		params[i].failed = false;
+		threads[i].Start(AllocateAndRelease, &params[i]);
+	}
+	for (uint32_t i = 0; i < thread_count; ++i)
+	{
+		threads[i].Join();
+		ASSERT_EQUAL(params[i].failed, false);
+	}
+}
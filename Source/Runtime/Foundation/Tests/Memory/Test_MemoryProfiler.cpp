@@ -0,0 +1,106 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Testing/Framework.h"
+#include <Foundation/Memory/HeapAllocator.h>
+#include <Foundation/Memory/ProxyAllocator.h>
+#include <Foundation/Memory/MemoryProfiler.h>
+
+using namespace sb;
+
+#ifdef SANDBOX_MEMORY_TRACKING
+
+TEST_CASE(MemoryProfiler_Counters)
+{
+	HeapAllocator heap;
+	TraceAllocator allocator("Test", heap);
+	uint32_t index = allocator.Tracker().GetIndex();
+
+	void* blocks[100];
+	for (uint32_t i = 0; i < 100; ++i)
+		blocks[i] = allocator.Allocate(100);
+
+	memory_profiler::Stats stats = memory_profiler::GetAllocatorStats(index);
+	ASSERT_EQUAL(stats.live_count, 100);
+	ASSERT_EQUAL(stats.total_count, 100);
+
+	for (uint32_t i = 0; i < 50; ++i)
+		allocator.Free(blocks[i]);
+
+	stats = memory_profiler::GetAllocatorStats(index);
+	ASSERT_EQUAL(stats.live_count, 50);
+	ASSERT_EQUAL(stats.total_count, 100);
+
+	for (uint32_t i = 50; i < 100; ++i)
+		allocator.Free(blocks[i]);
+
+	stats = memory_profiler::GetAllocatorStats(index);
+	ASSERT_EQUAL(stats.live_count, 0);
+	ASSERT_EQUAL(stats.live_bytes, 0);
+}
+
+TEST_CASE(MemoryProfiler_Tags)
+{
+	HeapAllocator heap;
+	TraceAllocator allocator("Test", heap);
+
+	uint32_t tag = memory_profiler::RegisterTag("Test_MemoryProfiler");
+	ASSERT_EQUAL(tag, memory_profiler::RegisterTag("Test_MemoryProfiler"));
+
+	int64_t count = memory_profiler::GetTagStats(tag).total_count;
+	{
+		memory_profiler::ScopedTag scoped_tag(tag);
+		allocator.Free(allocator.Allocate(100));
+		allocator.Free(allocator.Allocate(100));
+	}
+	allocator.Free(allocator.Allocate(100));
+
+	ASSERT_EQUAL(memory_profiler::GetTagStats(tag).total_count, count + 2);
+}
+
+TEST_CASE(MemoryProfiler_Unregister)
+{
+	HeapAllocator heap;
+	uint32_t index;
+	{
+		TraceAllocator allocator("Test", heap);
+		index = allocator.Tracker().GetIndex();
+		allocator.Free(allocator.Allocate(100));
+	}
+	ASSERT_EXPR(memory_profiler::GetAllocatorStats(index).name == nullptr);
+
+	// Slots are reused and start from zero
+	for (uint32_t i = 0; i < 2 * memory_profiler::MAX_ALLOCATORS; ++i)
+	{
+		TraceAllocator allocator("Test", heap);
+		ASSERT_EQUAL(allocator.Tracker().GetIndex(), index);
+		ASSERT_EQUAL(memory_profiler::GetAllocatorStats(index).total_count, 0);
+		allocator.Free(allocator.Allocate(100));
+	}
+}
+
+TEST_CASE(MemoryProfiler_TooManyAllocators)
+{
+	HeapAllocator heap;
+
+	TraceAllocator* allocators[memory_profiler::MAX_ALLOCATORS + 1];
+	for (uint32_t i = 0; i < memory_profiler::MAX_ALLOCATORS + 1; ++i)
+		allocators[i] = new TraceAllocator("Test", heap);
+
+	// Allocators that didn't get a slot of their own share the last one
+	TraceAllocator* last = allocators[memory_profiler::MAX_ALLOCATORS];
+	ASSERT_EQUAL(last->Tracker().GetIndex(), memory_profiler::OTHER_ALLOCATOR);
+	ASSERT_EQUAL_STR(memory_profiler::GetAllocatorStats(memory_profiler::OTHER_ALLOCATOR).name, "Other");
+
+	int64_t count = memory_profiler::GetAllocatorStats(memory_profiler::OTHER_ALLOCATOR).total_count;
+	last->Free(last->Allocate(100));
+	ASSERT_EQUAL(memory_profiler::GetAllocatorStats(memory_profiler::OTHER_ALLOCATOR).total_count, count + 1);
+
+	for (uint32_t i = 0; i < memory_profiler::MAX_ALLOCATORS + 1; ++i)
+		delete allocators[i];
+
+	// Freed slots are available again
+	TraceAllocator allocator("Test", heap);
+	ASSERT_EXPR(allocator.Tracker().GetIndex() != memory_profiler::OTHER_ALLOCATOR);
+}
+
+#endif // SANDBOX_MEMORY_TRACKING
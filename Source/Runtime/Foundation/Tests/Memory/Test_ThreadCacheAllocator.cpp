@@ -0,0 +1,200 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Testing/Framework.h"
+#include <Foundation/Memory/HeapAllocator.h>
+#include <Foundation/Memory/ThreadCacheAllocator.h>
+#include <Foundation/Thread/Thread.h>
+#include <Foundation/Thread/Event.h>
+
+using namespace sb;
+
+namespace
+{
+	struct ThreadParams
+	{
+		ThreadCacheAllocator* allocator;
+		void** blocks;
+		uint32_t count;
+	};
+
+	void AllocateBlocks(void* data)
+	{
+		ThreadParams* params = (ThreadParams*)data;
+		for (uint32_t i = 0; i < params->count; ++i)
+		{
+			params->blocks[i] = params->allocator->Allocate(8 + i % 500);
+			memset(params->blocks[i], 0xab, 8 + i % 500);
+		}
+	}
+
+	struct WaitingThreadParams
+	{
+		ThreadParams params;
+		Event allocated;
+		Event* exit;
+	};
+
+	/// Allocates and then keeps the thread, and its cache, alive until told to exit
+	void AllocateBlocksAndWait(void* data)
+	{
+		WaitingThreadParams* params = (WaitingThreadParams*)data;
+		AllocateBlocks(&params->params);
+		params->allocated.Set();
+		params->exit->Wait();
+	}
+}
+
+TEST_CASE(ThreadCacheAllocator_Allocate)
+{
+	HeapAllocator heap;
+	ThreadCacheAllocator allocator(heap);
+
+	void* p = allocator.Allocate(100);
+	ASSERT_EXPR(p != nullptr);
+	ASSERT_EXPR(allocator.GetAllocatedSize(p) >= 100);
+
+	// The block should come straight back from the cache
+	allocator.Free(p);
+	void* q = allocator.Allocate(100);
+	ASSERT_EQUAL(p, q);
+	allocator.Free(q);
+
+	void* large = allocator.Allocate(64 * 1024);
+	ASSERT_EXPR(allocator.GetAllocatedSize(large) >= 64 * 1024);
+	allocator.Free(large);
+}
+
+TEST_CASE(ThreadCacheAllocator_LargestClass)
+{
+	HeapAllocator heap;
+	ThreadCacheAllocator allocator(heap);
+
+	// The heap may round the block up past the class size, it should still go back to the cache
+	void* p = allocator.Allocate(ThreadCacheAllocator::MAX_SMALL_SIZE);
+	ASSERT_EXPR(p != nullptr);
+	ASSERT_EXPR(allocator.GetAllocatedSize(p) >= ThreadCacheAllocator::MAX_SMALL_SIZE);
+
+	allocator.Free(p);
+	void* q = allocator.Allocate(ThreadCacheAllocator::MAX_SMALL_SIZE);
+	ASSERT_EQUAL(p, q);
+	allocator.Free(q);
+
+	// Anything larger is never cached
+	void* large = allocator.Allocate(ThreadCacheAllocator::MAX_SMALL_SIZE + 1);
+	ASSERT_EXPR(allocator.GetAllocatedSize(large) > ThreadCacheAllocator::MAX_SMALL_SIZE);
+	allocator.Free(large);
+}
+
+TEST_CASE(ThreadCacheAllocator_Alignment)
+{
+	HeapAllocator heap;
+	ThreadCacheAllocator allocator(heap);
+
+	void* p8 = allocator.Allocate(24);
+	void* p64 = allocator.Allocate(24, 64);
+
+	ASSERT_EQUAL(p8, memory::AlignForward(p8, 8));
+	ASSERT_EQUAL(p64, memory::AlignForward(p64, 64));
+
+	allocator.Free(p8);
+	allocator.Free(p64);
+}
+
+TEST_CASE(ThreadCacheAllocator_Reallocate)
+{
+	HeapAllocator heap;
+	ThreadCacheAllocator allocator(heap);
+
+	uint8_t* p = (uint8_t*)allocator.Allocate(16);
+	for (uint32_t i = 0; i < 16; ++i)
+		p[i] = uint8_t(i);
+
+	p = (uint8_t*)allocator.Reallocate(p, 2000);
+	ASSERT_EXPR(allocator.GetAllocatedSize(p) >= 2000);
+	for (uint32_t i = 0; i < 16; ++i)
+		ASSERT_EQUAL(p[i], i);
+
+	p = (uint8_t*)allocator.Reallocate(p, 32);
+	for (uint32_t i = 0; i < 16; ++i)
+		ASSERT_EQUAL(p[i], i);
+
+	allocator.Free(p);
+}
+
+TEST_CASE(ThreadCacheAllocator_MixedHeap)
+{
+	HeapAllocator heap;
+	ThreadCacheAllocator allocator(heap);
+
+	// Blocks are interchangeable between the cache and the heap
+	void* p = heap.Allocate(40);
+	allocator.Free(p);
+
+	void* q = allocator.Allocate(40);
+	heap.Free(q);
+}
+
+TEST_CASE(ThreadCacheAllocator_Threads)
+{
+	HeapAllocator heap;
+	ThreadCacheAllocator allocator(heap);
+
+	const uint32_t thread_count = 4;
+	const uint32_t block_count = 10000;
+
+	vector<void*> blocks(thread_count * block_count);
+	ThreadParams params[thread_count];
+	SimpleThread threads[thread_count];
+	for (uint32_t i = 0; i < thread_count; ++i)
+	{
+		params[i].allocator = &allocator;
+		params[i].blocks = blocks.data() + i * block_count;
+		params[i].count = block_count;
+		threads[i].Start(AllocateBlocks, &params[i]);
+	}
+	for (uint32_t i = 0; i < thread_count; ++i)
+		threads[i].Join();
+
+	// Blocks allocated by other threads, freed on this one
+	for (auto p : blocks)
+	{
+		ASSERT_EXPR(p != nullptr);
+		allocator.Free(p);
+	}
+}
+
+TEST_CASE(ThreadCacheAllocator_DestroyWithRunningThreads)
+{
+	HeapAllocator heap;
+
+	const uint32_t thread_count = 4;
+	const uint32_t block_count = 1000;
+
+	vector<void*> blocks(thread_count * block_count);
+	WaitingThreadParams params[thread_count];
+	SimpleThread threads[thread_count];
+	Event exit(true);
+	{
+		ThreadCacheAllocator allocator(heap);
+		for (uint32_t i = 0; i < thread_count; ++i)
+		{
+			params[i].params.allocator = &allocator;
+			params[i].params.blocks = blocks.data() + i * block_count;
+			params[i].params.count = block_count;
+			params[i].exit = &exit;
+			threads[i].Start(AllocateBlocksAndWait, &params[i]);
+		}
+		for (uint32_t i = 0; i < thread_count; ++i)
+			params[i].allocated.Wait();
+
+		for (auto p : blocks)
+			allocator.Free(p);
+
+		// Destroys the caches of all threads while they're still running
+	}
+
+	// Exiting threads must not touch the destroyed allocator
+	exit.Set();
+	for (uint32_t i = 0; i < thread_count; ++i)
+		ASSERT_EXPR(threads[i].Join());
+}
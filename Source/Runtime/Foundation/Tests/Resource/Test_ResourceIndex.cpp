@@ -0,0 +1,224 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Testing/Framework.h"
+#include <Foundation/Resource/ResourceIndex.h>
+#include <Foundation/Thread/Thread.h>
+
+using namespace sb;
+
+namespace
+{
+	/// Keeps track of the number of live allocations
+	class CountingAllocator : public Allocator
+	{
+	public:
+		CountingAllocator() : allocation_count(0) {}
+
+		void* Allocate(size_t size, uint32_t alignment)
+		{
+			++allocation_count;
+			return memory::Malloc(size, alignment);
+		}
+		void* Reallocate(void*, size_t)
+		{
+			return nullptr;
+		}
+		void Free(void* p)
+		{
+			--allocation_count;
+			memory::Free(p);
+		}
+		size_t GetAllocatedSize(void* p)
+		{
+			return memory::GetAllocatedSize(p);
+		}
+
+		uint32_t allocation_count;
+	};
+
+	struct ChurnParams
+	{
+		ResourceIndex* index;
+		volatile long stop;
+	};
+
+	void ChurnResources(void* data)
+	{
+		ChurnParams* params = (ChurnParams*)data;
+
+		char name[64];
+		for (int i = 0; thread::InterlockedCompareExchange(&params->stop, 0, 0) == 0; ++i)
+		{
+			sprintf(name, "temp_%d", i);
+			params->index->Remove(params->index->Insert("mesh", name));
+		}
+	}
+}
+
+
+TEST_CASE(ResourceIndex_InsertFind)
+{
+	ResourceIndex index;
+
+	ResourceIndex::Slot* slot = index.Insert("texture", "textures/floor");
+	ASSERT_EXPR(slot != nullptr);
+	ASSERT_EQUAL(index.Size(), 1);
+
+	ASSERT_EQUAL(index.Find("texture", "textures/floor"), slot);
+	ASSERT_EXPR(index.Find("material", "textures/floor") == nullptr);
+	ASSERT_EXPR(index.Find("texture", "textures/wall") == nullptr);
+
+	int data = 0;
+	index.Publish(slot, &data);
+	ASSERT_EQUAL(index.Find("texture", "textures/floor")->data, &data);
+}
+
+TEST_CASE(ResourceIndex_GetData)
+{
+	ResourceIndex index;
+
+	ResourceIndex::Slot* slot = index.Insert("texture", "textures/floor");
+	int data = 0;
+	index.Publish(slot, &data);
+
+	long generation = 0;
+	ASSERT_EQUAL(index.Find("texture", "textures/floor", &generation), slot);
+	ASSERT_EQUAL(ResourceIndex::GetData(slot, generation), &data);
+
+	// Data of a reused slot belongs to another resource
+	index.Remove(slot);
+	ASSERT_EXPR(ResourceIndex::GetData(slot, generation) == nullptr);
+	ASSERT_EQUAL(index.Insert("texture", "textures/wall"), slot);
+	index.Publish(slot, &data);
+	ASSERT_EXPR(ResourceIndex::GetData(slot, generation) == nullptr);
+}
+
+TEST_CASE(ResourceIndex_Grow)
+{
+	ResourceIndex index;
+
+	ResourceIndex::Slot* slots[2048];
+	char name[64];
+	for (int i = 0; i < 2048; ++i)
+	{
+		sprintf(name, "resource_%d", i);
+		slots[i] = index.Insert("mesh", name);
+	}
+	ASSERT_EQUAL(index.Size(), 2048);
+
+	// Slots should not move when the table grows
+	for (int i = 0; i < 2048; ++i)
+	{
+		sprintf(name, "resource_%d", i);
+		ASSERT_EQUAL(index.Find("mesh", name), slots[i]);
+	}
+}
+
+TEST_CASE(ResourceIndex_Remove)
+{
+	ResourceIndex index;
+
+	char name[64];
+	for (int i = 0; i < 512; ++i)
+	{
+		sprintf(name, "resource_%d", i);
+		index.Insert("mesh", name);
+	}
+
+	// Remove every other resource
+	for (int i = 0; i < 512; i += 2)
+	{
+		sprintf(name, "resource_%d", i);
+		ResourceIndex::Slot* slot = index.Find("mesh", name);
+		long generation = slot->generation;
+		index.Remove(slot);
+		ASSERT_NOT_EQUAL(slot->generation, generation);
+	}
+	ASSERT_EQUAL(index.Size(), 256);
+
+	for (int i = 0; i < 512; ++i)
+	{
+		sprintf(name, "resource_%d", i);
+		if (i % 2)
+		{
+			ASSERT_EXPR(index.Find("mesh", name) != nullptr);
+		}
+		else
+		{
+			ASSERT_EXPR(index.Find("mesh", name) == nullptr);
+		}
+	}
+
+	// Removed slots should be reinsertable
+	ASSERT_EXPR(index.Insert("mesh", "resource_0") != nullptr);
+	ASSERT_EXPR(index.Find("mesh", "resource_0") != nullptr);
+
+	// A reused slot is live again and only found under its new ids
+	ResourceIndex::Slot* slot = index.Find("mesh", "resource_1");
+	index.Remove(slot);
+	ASSERT_EXPR((slot->generation & 1) != 0);
+	ASSERT_EXPR(index.Insert("mesh", "new_resource") == slot);
+	ASSERT_EXPR((slot->generation & 1) == 0);
+	ASSERT_EXPR(index.Find("mesh", "resource_1") == nullptr);
+	ASSERT_EXPR(index.Find("mesh", "new_resource") == slot);
+}
+
+TEST_CASE(ResourceIndex_PurgeTombstones)
+{
+	CountingAllocator allocator;
+	{
+		ResourceIndex index(allocator);
+
+		char name[64];
+		for (int i = 0; i < 64; ++i)
+		{
+			sprintf(name, "resource_%d", i);
+			index.Insert("mesh", name);
+		}
+		uint32_t allocation_count = allocator.allocation_count;
+
+		// Tombstones left by removals should be purged without allocating new tables
+		for (int i = 0; i < 100000; ++i)
+		{
+			sprintf(name, "temp_%d", i);
+			index.Remove(index.Insert("mesh", name));
+		}
+		ASSERT_EQUAL(allocator.allocation_count, allocation_count);
+		ASSERT_EQUAL(index.Size(), 64);
+
+		for (int i = 0; i < 64; ++i)
+		{
+			sprintf(name, "resource_%d", i);
+			ASSERT_EXPR(index.Find("mesh", name) != nullptr);
+		}
+	}
+	ASSERT_EQUAL(allocator.allocation_count, 0);
+}
+
+TEST_CASE(ResourceIndex_FindWhilePurging)
+{
+	ResourceIndex index;
+
+	char name[64];
+	ResourceIndex::Slot* slots[64];
+	for (int i = 0; i < 64; ++i)
+	{
+		sprintf(name, "resource_%d", i);
+		slots[i] = index.Insert("mesh", name);
+	}
+
+	ChurnParams params = { &index, 0 };
+	SimpleThread thread;
+	thread.Start(ChurnResources, &params);
+
+	// Lookups must never miss a resource while the table is purged
+	for (int n = 0; n < 20000; ++n)
+	{
+		int i = n % 64;
+		sprintf(name, "resource_%d", i);
+		ASSERT_EQUAL(index.Find("mesh", name), slots[i]);
+	}
+
+	thread::InterlockedExchange(&params.stop, 1);
+	ASSERT_EXPR(thread.Join());
+}
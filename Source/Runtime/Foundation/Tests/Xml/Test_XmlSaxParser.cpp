@@ -0,0 +1,137 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Testing/Framework.h"
+
+#include <Foundation/Xml/XmlSaxParser.h>
+
+using namespace sb;
+
+namespace
+{
+	/// Records all events as a string, e.g. "<a>text</a>"
+	class RecordingHandler : public XmlSaxParser::Handler
+	{
+	public:
+		RecordingHandler() : stop_at_element(NULL) {}
+
+		bool StartElement(const XmlSaxParser::StringRange& name, const XmlSaxParser::Attributes& attributes)
+		{
+			log += "<";
+			log.append(name.begin, name.end);
+			log += ">";
+
+			if (name.Equals("attr"))
+			{
+				value = attributes.GetString("value");
+				count = attributes.GetUInt("count", 0xffffffff);
+				missing_count = attributes.GetUInt("missing", 7);
+			}
+			return !stop_at_element || !name.Equals(stop_at_element);
+		}
+		bool EndElement(const XmlSaxParser::StringRange& name)
+		{
+			log += "</";
+			log.append(name.begin, name.end);
+			log += ">";
+			return true;
+		}
+		bool Text(const char* begin, const char* end)
+		{
+			log.append(begin, end);
+			return true;
+		}
+
+		const char* stop_at_element;
+
+		string log;
+		string value;
+		uint32_t count;
+		uint32_t missing_count;
+	};
+
+	bool Parse(XmlSaxParser& parser, RecordingHandler& handler, const char* xml)
+	{
+		return parser.Parse(xml, (uint32_t)strlen(xml), &handler);
+	}
+}
+
+TEST_CASE(XmlSaxParser_Elements)
+{
+	XmlSaxParser parser;
+	RecordingHandler handler;
+	const char* xml =
+		"<?xml version=\"1.0\" encoding=\"utf-8\"?>\n"
+		"<!DOCTYPE root>\n"
+		"<root>\n"
+		"<a>1 2 3</a><!-- comment --><b/>"
+		"<c><![CDATA[<not a tag>]]>x</c>"
+		"</root>\n";
+
+	ASSERT_EXPR(Parse(parser, handler, xml));
+	ASSERT_EXPR(parser.GetError() == NULL);
+	ASSERT_EQUAL_STR(handler.log.c_str(), "<root>\n<a>1 2 3</a><b></b><c><not a tag>x</c></root>");
+}
+
+TEST_CASE(XmlSaxParser_Attributes)
+{
+	XmlSaxParser parser;
+	RecordingHandler handler;
+	const char* xml = "<attr value=\"&amp;&lt;&gt;&quot;&apos;&unknown;\" count = ' 42 '/>";
+
+	ASSERT_EXPR(Parse(parser, handler, xml));
+	ASSERT_EQUAL_STR(handler.value.c_str(), "&<>\"'&unknown;");
+	ASSERT_EQUAL(handler.count, 42);
+	ASSERT_EQUAL(handler.missing_count, 7);
+}
+
+TEST_CASE(XmlSaxParser_Errors)
+{
+	XmlSaxParser parser;
+	{
+		RecordingHandler handler;
+		ASSERT_EXPR(!Parse(parser, handler, "<a>\n<b>\n</a>"));
+		ASSERT_EQUAL_STR(parser.GetError(), "Mismatched end tag");
+		ASSERT_EQUAL(parser.GetErrorLine(), 3);
+	}
+	{
+		RecordingHandler handler;
+		ASSERT_EXPR(!Parse(parser, handler, "<a><b>"));
+		ASSERT_EXPR(parser.GetError() != NULL);
+	}
+	{
+		RecordingHandler handler;
+		ASSERT_EXPR(!Parse(parser, handler, "<a/><b/>"));
+		ASSERT_EQUAL_STR(parser.GetError(), "Multiple root elements");
+	}
+	{
+		RecordingHandler handler;
+		ASSERT_EXPR(!Parse(parser, handler, "<a x=1/>"));
+		ASSERT_EQUAL_STR(parser.GetError(), "Expected quoted attribute value");
+	}
+	{
+		RecordingHandler handler;
+		ASSERT_EXPR(!Parse(parser, handler, "<a><!-- </a>"));
+		ASSERT_EQUAL_STR(parser.GetError(), "Unterminated comment");
+	}
+	{
+		RecordingHandler handler;
+		ASSERT_EXPR(!Parse(parser, handler, ""));
+		ASSERT_EQUAL_STR(parser.GetError(), "No root element");
+	}
+	{
+		// Parsing again resets the error
+		RecordingHandler handler;
+		ASSERT_EXPR(Parse(parser, handler, "<a/>"));
+		ASSERT_EXPR(parser.GetError() == NULL);
+	}
+}
+
+TEST_CASE(XmlSaxParser_StopByHandler)
+{
+	XmlSaxParser parser;
+	RecordingHandler handler;
+	handler.stop_at_element = "b";
+
+	ASSERT_EXPR(!Parse(parser, handler, "<a><b/><c/></a>"));
+	ASSERT_EQUAL_STR(handler.log.c_str(), "<a><b>");
+}
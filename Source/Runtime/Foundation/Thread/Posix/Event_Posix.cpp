@@ -1,13 +1,14 @@
 // Copyright 2008-2014 Simon Ekström
 
-#include <foundation/Common.h>
+#include "Common.h"
 
 #include "../Event.h"
 
-#include <process.h>
+#include <errno.h>
+#include <time.h>
 
 
-namespace edge
+namespace sb
 {
 
 //-------------------------------------------------------------------------------
@@ -61,30 +62,36 @@ void Event::Wait()
 
 bool Event::Wait(uint32_t milliseconds)
 {
+	// pthread_cond_timedwait expects an absolute time
 	struct timespec timeout;
-	timeout.tv_sec  = milliseconds / 1000;
-	timeout.tv_nsec = (milliseconds % 1000)*1000000;
+	clock_gettime(CLOCK_REALTIME, &timeout);
+	timeout.tv_sec += milliseconds / 1000;
+	timeout.tv_nsec += (milliseconds % 1000) * 1000000;
+	if (timeout.tv_nsec >= 1000000000)
+	{
+		timeout.tv_sec += 1;
+		timeout.tv_nsec -= 1000000000;
+	}
 
 	int res = 0;
 
 	pthread_mutex_lock(&_mutex);
 	
-	if(_state)
-	{
-		if(_auto_reset)
-			_state = false;
-	}
-	else
+	while (!_state && res != ETIMEDOUT)
 	{
 		res = pthread_cond_timedwait(&_cond, &_mutex, &timeout);
 	}
 
+	bool signaled = _state;
+	if (signaled && _auto_reset)
+		_state = false;
+
 	pthread_mutex_unlock(&_mutex);
-	return res == 0;
+	return signaled;
 }
 
 //-------------------------------------------------------------------------------
 
 
-}; // namespace edge
+} // namespace sb
 
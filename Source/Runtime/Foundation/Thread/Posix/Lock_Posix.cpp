@@ -1,13 +1,11 @@
 // Copyright 2008-2014 Simon Ekström
 
-#include <foundation/Common.h>
+#include "Common.h"
 
 #include "../Lock.h"
 
-#include <process.h>
 
-
-namespace edge
+namespace sb
 {
 
 //-------------------------------------------------------------------------------
@@ -50,5 +48,5 @@ bool Mutex::TryLock()
 //-------------------------------------------------------------------------------
 
 
-}; // namespace edge
+} // namespace sb
 
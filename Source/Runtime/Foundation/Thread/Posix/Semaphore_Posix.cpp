@@ -1,13 +1,11 @@
 // Copyright 2008-2014 Simon Ekström
 
-#include <foundation/Common.h>
+#include "Common.h"
 
 #include "../Semaphore.h"
 
-#include <process.h>
 
-
-namespace edge
+namespace sb
 {
 
 //-------------------------------------------------------------------------------
@@ -53,5 +51,5 @@ void Semaphore::Wait()
 //-------------------------------------------------------------------------------
 
 
-}; // namespace edge
+} // namespace sb
 
@@ -2,15 +2,18 @@
 
 #include "Common.h"
 
-#include "Thread_posix.h"
-#include "Thread.h"
+#include "../Thread.h"
 
+#include <errno.h>
 #include <pthread.h>
+#include <time.h>
 
 
 /// @file Thread_posix.cpp
 ///	@brief Threading implementations for POSIX
 
+#ifndef SANDBOX_PLATFORM_LINUX
+// glibc already has pthread_timedjoin_np
 namespace
 {
 
@@ -61,14 +64,15 @@ namespace
 	}
 
 }
+#endif
 
 namespace sb
 {
 
 //-------------------------------------------------------------------------------
-ThreadLocalPtr::ThreadLocalPtr()
+ThreadLocalPtr::ThreadLocalPtr(Destructor destructor)
 {
-	int res = pthread_key_create(&_key, NULL);
+	int res = pthread_key_create(&_key, destructor);
 	Assert(res == 0); // Check if we successfully created the key
 	Set(NULL);
 }
@@ -87,7 +91,8 @@ void* ThreadLocalPtr::Get() const
 
 //-------------------------------------------------------------------------------
 SimpleThread::SimpleThread()
-	: _thread_handle(NULL),
+	: _thread_handle(0),
+	_running(0),
 	_runnable(NULL)
 {
 	_thread_payload.function = NULL;
@@ -109,19 +114,36 @@ bool SimpleThread::Join(uint32_t time_out)
 		if(time_out)
 		{
 			struct timespec spec;
+#ifdef SANDBOX_PLATFORM_LINUX
+			// Timeout is absolute for the glibc version
+			clock_gettime(CLOCK_REALTIME, &spec);
+			spec.tv_sec += time_out / 1000;
+			spec.tv_nsec += (time_out % 1000) * 1000000;
+			if (spec.tv_nsec >= 1000000000)
+			{
+				spec.tv_sec += 1;
+				spec.tv_nsec -= 1000000000;
+			}
+#else
 			spec.tv_sec = time_out / 1000;
 			spec.tv_nsec = (time_out % 1000) * 1000000;
+#endif
 			result = pthread_timedjoin_np(_thread_handle, NULL, &spec) == 0;
 		}
 		else
 		{
 			result = pthread_join(_thread_handle, NULL) == 0;
 		}
-	}
-	if(result)
-		_thread_handle = NULL;
 
-	return true;
+		if(result)
+			_thread_handle = 0;
+	}
+	else
+	{
+		// Never started or already joined
+		result = true;
+	}
+	return result;
 }
 //-------------------------------------------------------------------------------
 void SimpleThread::StartThread(void* (*func)(void *), void* arg_list)
@@ -132,6 +154,12 @@ void SimpleThread::StartThread(void* (*func)(void *), void* arg_list)
 
 	res = pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
 	Assert(res == 0);
+
+	// A previous run that was never joined
+	if(_thread_handle)
+		pthread_detach(_thread_handle);
+
+	thread::InterlockedExchange(&_running, 1);
 	res = pthread_create(&_thread_handle, &attr, func, arg_list);
 	Assert(res == 0);
 
@@ -149,7 +177,7 @@ void* SimpleThread::RunRunnable(void* param)
 	if(thread->_runnable)
 		thread->_runnable->Run();
 
-	thread->_thread_handle = NULL;
+	thread::InterlockedExchange(&thread->_running, 0);
 	return 0;
 }
 void* SimpleThread::RunFunction(void* param)
@@ -159,13 +187,13 @@ void* SimpleThread::RunFunction(void* param)
 	if(thread->_thread_payload.function)
 		thread->_thread_payload.function(thread->_thread_payload.params);
 	
-	thread->_thread_handle = NULL;
+	thread::InterlockedExchange(&thread->_running, 0);
 	return 0;
 }
 
 //-------------------------------------------------------------------------------
 
-#ifdef SANDBOX_PLATFORM_MACOSX
+#ifdef SANDBOX_PLATFORM_POSIX
 
 long thread::InterlockedIncrement(long volatile* addend)
 {
@@ -189,7 +217,33 @@ long thread::InterlockedCompareExchange(long volatile* dest, long exchange, long
 }
 long thread::InterlockedExchange(long volatile* dest, long value)
 {
-	return __sync_val_compare_and_swap(dest, *dest, value);
+	return __atomic_exchange_n(dest, value, __ATOMIC_SEQ_CST);
+}
+
+int64_t thread::InterlockedIncrement64(int64_t volatile* addend)
+{
+	return __sync_fetch_and_add(addend, 1) + 1;
+}
+int64_t thread::InterlockedDecrement64(int64_t volatile* addend)
+{
+	return __sync_fetch_and_sub(addend, 1) - 1;
+}
+int64_t thread::InterlockedExchangeAdd64(int64_t volatile* addend, int64_t value)
+{
+	return __sync_fetch_and_add(addend, value);
+}
+int64_t thread::InterlockedCompareExchange64(int64_t volatile* dest, int64_t exchange, int64_t comparand)
+{
+	return __sync_val_compare_and_swap(dest, comparand, exchange);
+}
+
+void* thread::InterlockedCompareExchangePointer(void* volatile* dest, void* exchange, void* comparand)
+{
+	return __sync_val_compare_and_swap(dest, comparand, exchange);
+}
+void* thread::InterlockedExchangePointer(void* volatile* dest, void* value)
+{
+	return __atomic_exchange_n(dest, value, __ATOMIC_SEQ_CST);
 }
 
 #endif
@@ -19,7 +19,14 @@ namespace sb
 	class ThreadLocalPtr
 	{
 	public:
-		ThreadLocalPtr();
+		/// Called when a thread exits with the value it had set, unless the value is NULL
+#ifdef SANDBOX_PLATFORM_WIN
+		typedef void (WINAPI *Destructor)(void* value);
+#else
+		typedef void (*Destructor)(void* value);
+#endif
+
+		ThreadLocalPtr(Destructor destructor = NULL);
 		~ThreadLocalPtr();
 
 		void	Set(void* value);
@@ -75,7 +82,11 @@ namespace sb
 		bool Join(uint32_t time_out = 0);
 
 		/// @brief Is the thread running?
-		bool IsRunning() const { return (_thread_handle != NULL); }
+#ifdef SANDBOX_PLATFORM_WIN
+		bool IsRunning() const { return (_thread_handle != 0); }
+#else
+		bool IsRunning() const { return (_running != 0); }
+#endif
 
 	protected:
 		struct ThreadPayload
@@ -89,7 +100,8 @@ namespace sb
 		uint32_t _thread_id;
 
 #else
-		pthread_t _thread_handle;
+		pthread_t _thread_handle; ///< Kept until the thread is joined
+		volatile long _running; ///< Cleared by the thread itself when it's done
 #endif
 
 		ThreadPayload _thread_payload;
@@ -136,6 +148,15 @@ namespace sb
 
 		int64_t InterlockedExchangeAdd64(int64_t volatile* addend, int64_t value);
 
+		/// @return The initial value of the dest parameter.
+		int64_t InterlockedCompareExchange64(int64_t volatile* dest, int64_t exchange, int64_t comparand);
+
+		/// @return The initial value of the dest parameter.
+		void* InterlockedCompareExchangePointer(void* volatile* dest, void* exchange, void* comparand);
+
+		/// @return Initial value of dest.
+		void* InterlockedExchangePointer(void* volatile* dest, void* value);
+
 	}; // namespace thread
 
 } // namespace sb
@@ -14,23 +14,25 @@ namespace sb
 {
 
 	//-------------------------------------------------------------------------------
-	ThreadLocalPtr::ThreadLocalPtr()
+	// Fiber local storage behaves as thread local storage for threads not using fibers, but
+	//	unlike TlsAlloc it supports a callback on thread exit.
+	ThreadLocalPtr::ThreadLocalPtr(Destructor destructor)
 	{
-		_tls_index = TlsAlloc();
-		Assert(_tls_index != TLS_OUT_OF_INDEXES);
+		_tls_index = FlsAlloc(destructor);
+		Assert(_tls_index != FLS_OUT_OF_INDEXES);
 		Set(NULL);
 	}
 	ThreadLocalPtr::~ThreadLocalPtr()
 	{
-		TlsFree(_tls_index);
+		FlsFree(_tls_index);
 	}
 	void ThreadLocalPtr::Set(void* value)
 	{
-		TlsSetValue(_tls_index, value);
+		FlsSetValue(_tls_index, value);
 	}
 	void* ThreadLocalPtr::Get() const
 	{
-		return TlsGetValue(_tls_index);
+		return FlsGetValue(_tls_index);
 	}
 	//-------------------------------------------------------------------------------
 	SimpleThread::SimpleThread()
@@ -138,6 +140,19 @@ namespace sb
 	{
 		return ::InterlockedExchangeAdd64(addend, value);
 	}
+	int64_t thread::InterlockedCompareExchange64(int64_t volatile* dest, int64_t exchange, int64_t comparand)
+	{
+		return ::InterlockedCompareExchange64(dest, exchange, comparand);
+	}
+
+	void* thread::InterlockedCompareExchangePointer(void* volatile* dest, void* exchange, void* comparand)
+	{
+		return ::InterlockedCompareExchangePointer(dest, exchange, comparand);
+	}
+	void* thread::InterlockedExchangePointer(void* volatile* dest, void* value)
+	{
+		return ::InterlockedExchangePointer(dest, value);
+	}
 
 
 	//-------------------------------------------------------------------------------
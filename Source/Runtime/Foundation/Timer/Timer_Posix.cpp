@@ -0,0 +1,57 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "Timer.h"
+
+#include <time.h>
+
+
+namespace sb
+{
+
+	namespace
+	{
+		// Ticks are nanoseconds of the monotonic clock
+		const double g_seconds_per_tick = 1.0 / 1000000000.0;
+
+		uint64_t g_start_tick_count = 0;
+
+		bool g_initialized = false;
+
+		uint64_t ReadClock()
+		{
+			timespec ts;
+			clock_gettime(CLOCK_MONOTONIC, &ts);
+			return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+		}
+	};
+
+	void timer::Initialize()
+	{
+		g_start_tick_count = ReadClock();
+		g_initialized = true;
+	}
+
+	uint64_t timer::StartTickCount()
+	{
+		Assert(g_initialized);
+		return g_start_tick_count;
+	}
+	uint64_t timer::TickCount()
+	{
+		Assert(g_initialized);
+		return ReadClock();
+	}
+	double timer::Seconds()
+	{
+		Assert(g_initialized);
+		return double(ReadClock() - g_start_tick_count) * g_seconds_per_tick;
+	}
+
+	double timer::SecondsPerTick()
+	{
+		return g_seconds_per_tick;
+	}
+
+} // namespace sb
@@ -35,7 +35,7 @@ namespace sb
 		void ArrayMove(T* dst, const T* src, size_t count, const std::true_type&)
 		{
 			// Object with a trival assignment operator
-			memory::Memmove(dst, src, sizeof(T)*count);
+			memmove(dst, src, sizeof(T)*count);
 		}
 
 
@@ -136,31 +136,31 @@ namespace sb
 	template<typename T>
 	void ArrayMove(T* dst, const T* src, size_t count)
 	{
-		util_internal::ArrayMove(dst, src, count, std::has_trivial_assign<T>());
+		util_internal::ArrayMove(dst, src, count, std::is_trivially_copy_assignable<T>());
 	}
 
 	template<typename T>
 	void ArrayCopy(T* dst, const T* src, size_t count)
 	{
-		util_internal::ArrayCopy(dst, src, count, std::has_trivial_copy<T>());
+		util_internal::ArrayCopy(dst, src, count, std::is_trivially_copy_constructible<T>());
 	}
 
 	template<typename T>
 	void ArrayConstruct(T* arr, size_t count)
 	{
-		util_internal::ArrayConstruct<T>(arr, count, std::has_trivial_constructor<T>());
+		util_internal::ArrayConstruct<T>(arr, count, std::is_trivially_default_constructible<T>());
 	}
 
 	template<typename T>
 	void ArrayDestruct(T* arr, size_t count)
 	{
-		util_internal::ArrayDestruct<T>(arr, count, std::has_trivial_destructor<T>());
+		util_internal::ArrayDestruct<T>(arr, count, std::is_trivially_destructible<T>());
 	}
 
 	template<typename T>
 	void Destruct(T* arr)
 	{
-		util_internal::Destruct<T>(arr, std::has_trivial_destructor<T>());
+		util_internal::Destruct<T>(arr, std::is_trivially_destructible<T>());
 	}
 
 	//-------------------------------------------------------------------------------
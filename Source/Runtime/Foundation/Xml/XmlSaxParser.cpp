@@ -0,0 +1,318 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "XmlSaxParser.h"
+
+namespace sb
+{
+
+	namespace
+	{
+		bool IsWhitespace(char c)
+		{
+			return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+		}
+
+		bool IsNameEnd(char c)
+		{
+			return IsWhitespace(c) || c == '/' || c == '>' || c == '=';
+		}
+
+		const char* SkipWhitespace(const char* p, const char* end)
+		{
+			while (p < end && IsWhitespace(*p))
+				++p;
+			return p;
+		}
+
+		const char* ParseName(const char* p, const char* end)
+		{
+			while (p < end && !IsNameEnd(*p))
+				++p;
+			return p;
+		}
+
+		/// @return Position of the first occurrence of str in [p, end), NULL if not found
+		const char* Find(const char* p, const char* end, const char* str)
+		{
+			size_t len = strlen(str);
+			while (p + len <= end)
+			{
+				p = (const char*)memchr(p, str[0], end - p);
+				if (!p || p + len > end)
+					return NULL;
+				if (memcmp(p, str, len) == 0)
+					return p;
+				++p;
+			}
+			return NULL;
+		}
+
+		bool StartsWith(const char* p, const char* end, const char* str)
+		{
+			size_t len = strlen(str);
+			return p + len <= end && memcmp(p, str, len) == 0;
+		}
+	}
+
+	bool XmlSaxParser::StringRange::Equals(const char* str) const
+	{
+		size_t len = strlen(str);
+		return len == Length() && memcmp(begin, str, len) == 0;
+	}
+
+	//-------------------------------------------------------------------------------
+
+	bool XmlSaxParser::Attributes::Find(const char* name, StringRange& value) const
+	{
+		for (auto& attribute : _attributes)
+		{
+			if (attribute.name.Equals(name))
+			{
+				value = attribute.value;
+				return true;
+			}
+		}
+		return false;
+	}
+	string XmlSaxParser::Attributes::GetString(const char* name) const
+	{
+		StringRange value;
+		if (!Find(name, value))
+			return "";
+
+		string result;
+		result.reserve(value.Length());
+		for (const char* p = value.begin; p < value.end; ++p)
+		{
+			if (*p == '&')
+			{
+				if (StartsWith(p, value.end, "&amp;")) { result += '&'; p += 4; continue; }
+				if (StartsWith(p, value.end, "&lt;")) { result += '<'; p += 3; continue; }
+				if (StartsWith(p, value.end, "&gt;")) { result += '>'; p += 3; continue; }
+				if (StartsWith(p, value.end, "&quot;")) { result += '"'; p += 5; continue; }
+				if (StartsWith(p, value.end, "&apos;")) { result += '\''; p += 5; continue; }
+			}
+			result += *p;
+		}
+		return result;
+	}
+	uint32_t XmlSaxParser::Attributes::GetUInt(const char* name, uint32_t default_value) const
+	{
+		StringRange value;
+		if (!Find(name, value))
+			return default_value;
+
+		const char* p = SkipWhitespace(value.begin, value.end);
+		if (p == value.end || *p < '0' || *p > '9')
+			return default_value;
+
+		uint32_t result = 0;
+		for (; p < value.end && *p >= '0' && *p <= '9'; ++p)
+			result = result * 10 + (*p - '0');
+		return result;
+	}
+
+	//-------------------------------------------------------------------------------
+
+	XmlSaxParser::XmlSaxParser() : _data(NULL), _error(NULL), _error_line(0)
+	{
+	}
+	XmlSaxParser::~XmlSaxParser()
+	{
+	}
+
+	bool XmlSaxParser::Parse(const char* data, uint32_t len, Handler* handler)
+	{
+		_data = data;
+		_error = NULL;
+		_error_line = 0;
+		_stack.clear();
+
+		const char* p = data;
+		const char* end = data + len;
+
+		bool has_root = false;
+		while (p < end)
+		{
+			if (*p != '<')
+			{
+				// Character data, runs until the next tag
+				const char* text = p;
+				p = (const char*)memchr(p, '<', end - p);
+				if (!p)
+					p = end;
+
+				if (!_stack.empty())
+				{
+					if (!handler->Text(text, p))
+						return SetError(text, "Stopped by handler");
+				}
+				else if (SkipWhitespace(text, p) != p)
+				{
+					return SetError(text, "Text outside of the root element");
+				}
+				continue;
+			}
+
+			const char* tag = p++;
+			if (StartsWith(p, end, "?"))
+			{
+				// Processing instruction (e.g. the XML declaration)
+				p = Find(p, end, "?>");
+				if (!p)
+					return SetError(tag, "Unterminated processing instruction");
+				p += 2;
+			}
+			else if (StartsWith(p, end, "!--"))
+			{
+				p = Find(p + 3, end, "-->");
+				if (!p)
+					return SetError(tag, "Unterminated comment");
+				p += 3;
+			}
+			else if (StartsWith(p, end, "![CDATA["))
+			{
+				const char* text = p + 8;
+				p = Find(text, end, "]]>");
+				if (!p)
+					return SetError(tag, "Unterminated CDATA section");
+				if (_stack.empty())
+					return SetError(tag, "CDATA outside of the root element");
+				if (!handler->Text(text, p))
+					return SetError(text, "Stopped by handler");
+				p += 3;
+			}
+			else if (StartsWith(p, end, "!"))
+			{
+				// Document type declaration, may contain an internal subset within brackets
+				uint32_t depth = 0;
+				for (; p < end; ++p)
+				{
+					if (*p == '[')
+						++depth;
+					else if (*p == ']' && depth)
+						--depth;
+					else if (*p == '>' && !depth)
+						break;
+				}
+				if (p == end)
+					return SetError(tag, "Unterminated declaration");
+				++p;
+			}
+			else if (StartsWith(p, end, "/"))
+			{
+				StringRange name(p + 1, ParseName(p + 1, end));
+				p = SkipWhitespace(name.end, end);
+				if (p == end || *p != '>')
+					return SetError(tag, "Expected '>'");
+				++p;
+
+				if (_stack.empty() || _stack.back().Length() != name.Length() ||
+					memcmp(_stack.back().begin, name.begin, name.Length()) != 0)
+					return SetError(tag, "Mismatched end tag");
+
+				_stack.pop_back();
+				if (!handler->EndElement(name))
+					return SetError(tag, "Stopped by handler");
+			}
+			else
+			{
+				StringRange name(p, ParseName(p, end));
+				if (name.Length() == 0)
+					return SetError(tag, "Expected element name");
+				if (_stack.empty() && has_root)
+					return SetError(tag, "Multiple root elements");
+				has_root = true;
+
+				// Attributes
+				_attributes._attributes.clear();
+				bool empty_element = false;
+
+				p = name.end;
+				while (true)
+				{
+					p = SkipWhitespace(p, end);
+					if (p == end)
+						return SetError(tag, "Unterminated start tag");
+
+					if (*p == '>')
+					{
+						++p;
+						break;
+					}
+					if (*p == '/')
+					{
+						if (p + 1 == end || p[1] != '>')
+							return SetError(tag, "Expected '>'");
+						p += 2;
+						empty_element = true;
+						break;
+					}
+
+					Attributes::Attribute attribute;
+					attribute.name = StringRange(p, ParseName(p, end));
+					if (attribute.name.Length() == 0)
+						return SetError(p, "Expected attribute name");
+
+					p = SkipWhitespace(attribute.name.end, end);
+					if (p == end || *p != '=')
+						return SetError(p, "Expected '='");
+
+					p = SkipWhitespace(p + 1, end);
+					if (p == end || (*p != '"' && *p != '\''))
+						return SetError(p, "Expected quoted attribute value");
+
+					const char* value_end = (const char*)memchr(p + 1, *p, end - (p + 1));
+					if (!value_end)
+						return SetError(p, "Unterminated attribute value");
+
+					attribute.value = StringRange(p + 1, value_end);
+					_attributes._attributes.push_back(attribute);
+					p = value_end + 1;
+				}
+
+				_stack.push_back(name);
+				if (!handler->StartElement(name, _attributes))
+					return SetError(tag, "Stopped by handler");
+
+				if (empty_element)
+				{
+					_stack.pop_back();
+					if (!handler->EndElement(name))
+						return SetError(tag, "Stopped by handler");
+				}
+			}
+		}
+
+		if (!has_root)
+			return SetError(end, "No root element");
+		if (!_stack.empty())
+			return SetError(end, "Unexpected end of document");
+
+		return true;
+	}
+	const char* XmlSaxParser::GetError() const
+	{
+		return _error;
+	}
+	uint32_t XmlSaxParser::GetErrorLine() const
+	{
+		return _error_line;
+	}
+	bool XmlSaxParser::SetError(const char* position, const char* error)
+	{
+		_error = error;
+
+		// Only counted when needed, keeping the parsing itself free from line bookkeeping
+		_error_line = 1;
+		for (const char* p = _data; p < position; ++p)
+		{
+			if (*p == '\n')
+				++_error_line;
+		}
+		return false;
+	}
+
+} // namespace sb
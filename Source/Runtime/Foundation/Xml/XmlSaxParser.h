@@ -0,0 +1,93 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __FOUNDATION_XMLSAXPARSER_H__
+#define __FOUNDATION_XMLSAXPARSER_H__
+
+namespace sb
+{
+
+	/// Streaming (SAX) XML parser
+	///	Parses a document in memory without building a DOM. Names, attribute values and text are
+	///	passed to the handler as ranges in the source buffer, which means nothing is copied and
+	///	entities are only decoded when asking for an attribute value as a string.
+	class XmlSaxParser
+	{
+	public:
+		/// Range of characters in the parsed buffer, not null-terminated
+		struct StringRange
+		{
+			StringRange() : begin(NULL), end(NULL) {}
+			StringRange(const char* b, const char* e) : begin(b), end(e) {}
+
+			const char* begin;
+			const char* end;
+
+			uint32_t Length() const { return uint32_t(end - begin); }
+			bool Equals(const char* str) const;
+		};
+
+		class Attributes
+		{
+		public:
+			/// @return True if the attribute was found
+			bool Find(const char* name, StringRange& value) const;
+
+			/// @return Attribute value with entities decoded, an empty string if the attribute wasn't found
+			string GetString(const char* name) const;
+
+			/// @return Attribute value as an integer, default_value if the attribute wasn't found
+			uint32_t GetUInt(const char* name, uint32_t default_value) const;
+
+		private:
+			friend class XmlSaxParser;
+
+			struct Attribute
+			{
+				StringRange name;
+				StringRange value;
+			};
+			vector<Attribute> _attributes;
+		};
+
+		class Handler
+		{
+		public:
+			virtual ~Handler() {}
+
+			/// @return False to stop parsing
+			virtual bool StartElement(const StringRange& name, const Attributes& attributes) = 0;
+			virtual bool EndElement(const StringRange& name) = 0;
+
+			/// Character data of the current element, may be called several times for the same element
+			///	if the text is broken up by comments, CDATA sections or child elements.
+			virtual bool Text(const char* begin, const char* end) = 0;
+		};
+
+		XmlSaxParser();
+		~XmlSaxParser();
+
+		/// Parses a document, calling the handler for every element and piece of text
+		/// @return True if the whole document was parsed, false if there was an error or the handler stopped the parsing
+		bool Parse(const char* data, uint32_t len, Handler* handler);
+
+		/// @return Description of the last error, NULL if there was none
+		const char* GetError() const;
+
+		/// @return Line number (starting at 1) of the last error
+		uint32_t GetErrorLine() const;
+
+	private:
+		bool SetError(const char* position, const char* error);
+
+		const char* _data;
+		const char* _error;
+		uint32_t _error_line;
+
+		vector<StringRange> _stack; ///< Open elements
+		Attributes _attributes;
+	};
+
+} // namespace sb
+
+
+#endif // __FOUNDATION_XMLSAXPARSER_H__
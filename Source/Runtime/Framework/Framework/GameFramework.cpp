@@ -15,12 +15,15 @@
 #include <Foundation/Resource/ResourcePackage.h>
 #include <Foundation/IO/InputBuffer.h>
 #include <Foundation/Json/Json.h>
+#include <Foundation/Container/CompiledConfig.h>
 #include <Foundation/Debug/Console.h>
 #include <Foundation/Debug/ConsoleServer.h>
+#include <Foundation/Memory/MemoryProfiler.h>
 #include <Foundation/Timer/Timer.h>
 #include <Foundation/Thread/TaskScheduler.h>
 
 #include <Engine/Input/Input.h>
+#include <Engine/Rendering/TextureStreamer.h>
 
 
 
@@ -53,6 +56,31 @@ namespace
 	}
 #endif // SANDBOX_DEVELOPMENT
 
+#ifdef SANDBOX_MEMORY_TRACKING
+	void MemorySnapshotCommand(void*, const ConfigValue& cmd)
+	{
+		if (cmd["args"].Size() == 0 || !cmd["args"][0].IsString())
+		{
+			logging::Info("Usage: memory_snapshot <file>");
+			logging::Info("Example: memory_snapshot heap.prof");
+			return;
+		}
+
+		if (memory_profiler::WriteHeapSnapshot(cmd["args"][0].AsString()))
+			logging::Info("Heap snapshot written to '%s'", cmd["args"][0].AsString());
+	}
+	void MemoryStatsCommand(void*, const ConfigValue& cmd)
+	{
+		if (cmd["args"].Size() == 0 || !cmd["args"][0].IsString())
+		{
+			logging::Info("Usage: memory_stats <on|off>");
+			return;
+		}
+
+		memory_profiler::SetSendFrameStats(strcmp(cmd["args"][0].AsString(), "on") == 0);
+	}
+#endif // SANDBOX_MEMORY_TRACKING
+
 
 	LRESULT WndMessageCallback(void* data, HWND hwnd, UINT msg, WPARAM wparam, LPARAM lparam)
 	{
@@ -107,6 +135,7 @@ void GameFramework::SetDefaultSettings(ConfigValue& settings)
 	settings["renderer"]["fullscreen"].SetBool(false);
 	settings["renderer"]["adapter_index"].SetInt(0);
 	settings["renderer"]["vsync"].SetBool(true);
+	settings["renderer"]["texture_budget_mb"].SetInt(TextureStreamer::DEFAULT_BUDGET / (1024 * 1024));
 
 }
 void GameFramework::Initialize()
@@ -132,6 +161,10 @@ void GameFramework::Initialize()
 	console::Initialize(_settings["console_server_port"].AsInt());
 	logging::SetCallback(LoggingCallback, nullptr);
 #endif
+#ifdef SANDBOX_MEMORY_TRACKING
+	ADD_CONSOLE_COMMAND("memory_snapshot", MemorySnapshotCommand, nullptr, "Writes the sampled live heap to a file readable by pprof.");
+	ADD_CONSOLE_COMMAND("memory_stats", MemoryStatsCommand, nullptr, "Enables or disables sending of per-frame allocation stats.");
+#endif
 
 	_resource_manager = new ResourceManager(_file_system);
 	_resource_manager->Initialize();
@@ -160,18 +193,17 @@ void GameFramework::Initialize()
 	_window->SetMessageCallback(WndMessageCallback, _input);
 
 
-	ConfigValue render_setup;
-
-	// Set up renderer
+	// Set up renderer, the render setup is normally compiled by the builder and read in place
+	CompiledConfig render_setup;
 	if (_settings["render_setup"].IsString())
 	{
-		if (!reader.ReadFile(file_source, _settings["render_setup"].AsString(), render_setup))
+		if (!render_setup.ReadFile(file_source, _settings["render_setup"].AsString()))
 		{
-			logging::Warning("Failed to load render setup: %s", reader.GetErrorMessage().c_str());
+			logging::Warning("Failed to load render setup: %s", render_setup.GetErrorMessage().c_str());
 		}
 	}
 
-	_renderer->LoadRenderSetup(render_setup);
+	_renderer->LoadRenderSetup(render_setup.Root());
 
 	_game = _create_game(*this);
 	_game->Initialize();
@@ -229,6 +261,9 @@ void GameFramework::InitalizeRenderer()
 
 	_renderer->Initialize(render_params);
 
+	uint64_t texture_budget = _settings["renderer"]["texture_budget_mb"].AsInt();
+	_renderer->GetTextureStreamer()->SetBudget(texture_budget * 1024 * 1024);
+
 }
 void GameFramework::ShutdownRenderer()
 {
@@ -267,11 +302,19 @@ void GameFramework::Run()
 #ifdef SANDBOX_DEVELOPMENT
 		console::Server()->Update();
 #endif
-		_game->Update(dtime);
-		_game->Render();
+		{
+			MEMORY_TAG("Game");
+			_game->Update(dtime);
+		}
+		{
+			MEMORY_TAG("Render");
+			_game->Render();
+		}
 
+		_renderer->UpdateTextureStreaming();
 		_renderer->GetDevice()->Present();
 
+		memory::EndFrame();
 		profiler::Flip();
 	}
 
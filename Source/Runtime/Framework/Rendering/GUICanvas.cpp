@@ -79,7 +79,13 @@ void GUICanvas::DrawText(const GUIText& rect)
 	Material* material = _material_manager->GetMaterial(rect.material);
 	Assert(material);
 
-	Font* font = (Font*) _resource_manager->GetResource("font", rect.font);
+	if (rect.font != _font_id || !_font.IsValid())
+	{
+		_font = _resource_manager->GetHandle<Font>("font", rect.font);
+		_font_id = rect.font;
+	}
+	Font* font = _font.Get();
+	Assert(font);
 	material->SetTexture("diffuse_map", font->texture); // TODO: Cloning materials
 
 	Batch* batch = GetBatch(material);
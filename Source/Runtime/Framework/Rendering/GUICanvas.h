@@ -8,6 +8,8 @@
 
 #include <Engine/Rendering/RenderBlock.h>
 
+#include <Foundation/Resource/ResourceManager.h>
+
 namespace sb
 {
 
@@ -103,6 +105,10 @@ private:
 	MaterialManager* _material_manager;
 	ResourceManager* _resource_manager;
 
+	/// Handle to the last used font, text is usually drawn with the same font over and over
+	StringId64 _font_id;
+	ResourceHandle<Font> _font;
+
 	RVertexDeclaration* _vertex_decl; ///< Vertex declaration for the textured rectangles
 
 	map<Material*, Batch*> _batches;
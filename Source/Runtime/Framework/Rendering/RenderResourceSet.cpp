@@ -5,7 +5,7 @@
 #include "RenderResourceSet.h"
 
 #include <Engine/Rendering/RenderResourceAllocator.h>
-#include <Foundation/Container/ConfigValue.h>
+#include <Foundation/Container/CompiledConfig.h>
 
 
 namespace sb
@@ -35,14 +35,14 @@ namespace sb
 		_resources.clear();
 	}
 
-	void RenderResourceSet::Load(const ConfigValue& resources, RenderResourceAllocator* allocator)
+	void RenderResourceSet::Load(const CompiledConfigValue& resources, RenderResourceAllocator* allocator)
 	{
 		Assert(resources.IsArray());
 
 		for (uint32_t r = 0; r < resources.Size(); ++r)
 		{
 			Assert(resources[r].IsObject());
-			const ConfigValue& resource = resources[r];
+			CompiledConfigValue resource = resources[r];
 
 			Assert(resource["name"].IsString());
 			StringId32 name = resource["name"].AsString();
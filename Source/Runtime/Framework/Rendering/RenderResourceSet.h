@@ -7,7 +7,7 @@
 namespace sb
 {
 
-	class ConfigValue;
+	class CompiledConfigValue;
 	class RenderResource;
 	class RenderResourceAllocator;
 
@@ -18,7 +18,7 @@ namespace sb
 		RenderResourceSet();
 		~RenderResourceSet();
 
-		void Load(const ConfigValue& resources, RenderResourceAllocator* allocator);
+		void Load(const CompiledConfigValue& resources, RenderResourceAllocator* allocator);
 		void Unload(RenderResourceAllocator* allocator);
 
 
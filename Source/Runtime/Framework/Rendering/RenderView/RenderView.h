@@ -15,7 +15,8 @@ namespace sb
 	class RenderWorld;
 	class RenderContext;
 	class RenderResourceAllocator;
-	class ConfigValue;
+	class CompiledConfigValue;
+	class TextureStreamer;
 
 	struct Layer;
 	struct Viewport;
@@ -36,10 +37,13 @@ namespace sb
 
 			RenderWorld* world;
 
+			/// Texture streamer to request texture mips from, NULL if the view shouldn't affect streaming
+			TextureStreamer* texture_streamer;
+
 		};
 		virtual ~RenderView() {}
 
-		virtual void Load(const ConfigValue& ,
+		virtual void Load(const CompiledConfigValue& ,
 						  RenderResourceAllocator* ,
 						  RenderResourceSet* ) {}
 
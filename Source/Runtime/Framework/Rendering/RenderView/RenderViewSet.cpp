@@ -7,7 +7,7 @@
 #include "WorldRenderView.h"
 #include "ShadowMappingView.h"
 
-#include <Foundation/Container/ConfigValue.h>
+#include <Foundation/Container/CompiledConfig.h>
 
 
 
@@ -21,14 +21,14 @@ namespace sb
 	{
 	}
 
-	void RenderViewSet::Load(	const ConfigValue& config, 
+	void RenderViewSet::Load(	const CompiledConfigValue& config, 
 								RenderResourceAllocator* resource_allocator, 
 								RenderResourceSet* resource_set)
 	{
 		Assert(config.IsArray());
 		for (uint32_t i = 0; i < config.Size(); ++i)
 		{
-			const ConfigValue& view_cfg = config[i];
+			CompiledConfigValue view_cfg = config[i];
 			Assert(view_cfg["name"].IsString());
 			StringId32 name = view_cfg["name"].AsString();
 
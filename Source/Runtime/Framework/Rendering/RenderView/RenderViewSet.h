@@ -8,7 +8,7 @@ namespace sb
 {
 
 	class RenderView;
-	class ConfigValue;
+	class CompiledConfigValue;
 	class RenderResourceAllocator;
 	class RenderResourceSet;
 
@@ -18,7 +18,7 @@ namespace sb
 		RenderViewSet();
 		~RenderViewSet();
 
-		void Load(	const ConfigValue& config, 
+		void Load(	const CompiledConfigValue& config, 
 					RenderResourceAllocator* resource_allocator,
 					RenderResourceSet* resource_set);
 
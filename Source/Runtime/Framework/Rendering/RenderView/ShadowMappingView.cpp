@@ -12,7 +12,7 @@
 
 #include <Foundation/Thread/TaskScheduler.h>
 #include <Foundation/Math/MatrixUtil.h>
-#include <Foundation/Container/ConfigValue.h>
+#include <Foundation/Container/CompiledConfig.h>
 #include <Foundation/Profiler/Profiler.h>
 
 #include <Engine/Rendering/RRenderTarget.h>
@@ -178,7 +178,7 @@ namespace sb
 	{
 
 	}
-	void ShadowMappingView::Load(const ConfigValue& config, RenderResourceAllocator*, RenderResourceSet*)
+	void ShadowMappingView::Load(const CompiledConfigValue& config, RenderResourceAllocator*, RenderResourceSet*)
 	{
 		Assert(config.IsObject());
 		_slices.resize(SHADOW_MAPPING_SLICE_COUNT);
@@ -10,7 +10,7 @@
 
 namespace sb
 {
-	class ConfigValue;
+	class CompiledConfigValue;
 	class RenderResourceAllocator;
 	class RenderResourceSet;
 
@@ -38,7 +38,7 @@ namespace sb
 		ShadowMappingView();
 		~ShadowMappingView();
 
-		void Load(const ConfigValue& config, 
+		void Load(const CompiledConfigValue& config, 
 				  RenderResourceAllocator* resource_allocator, 
 				  RenderResourceSet* resource_set) OVERRIDE;
 		void Unload(RenderResourceAllocator* resource_allocator) OVERRIDE;
@@ -10,7 +10,7 @@
 #include "Rendering/Layer.h"
 #include "Rendering/RenderResourceSet.h"
 
-#include <Foundation/Container/ConfigValue.h>
+#include <Foundation/Container/CompiledConfig.h>
 
 #include <Engine/Rendering/ShaderParameters.h>
 
@@ -26,16 +26,16 @@ namespace sb
 
 	}
 
-	void WorldRenderView::Load(const ConfigValue& config,
+	void WorldRenderView::Load(const CompiledConfigValue& config,
 							   RenderResourceAllocator* ,
 							   RenderResourceSet* )
 	{
-		const ConfigValue& resources = config["resources"];
+		CompiledConfigValue resources = config["resources"];
 		if (resources.IsArray())
 		{
 			for (uint32_t i = 0; i < resources.Size(); ++i)
 			{
-				const ConfigValue& res_cfg = resources[i];
+				CompiledConfigValue res_cfg = resources[i];
 				Assert(res_cfg.IsArray() && (res_cfg.Size() == 2));
 
 				_resources.push_back(pair<StringId32, StringId32>(res_cfg[0].AsString(),
@@ -66,6 +66,10 @@ namespace sb
 			{
 			case RenderComponent::MESH:
 				((MeshComponent*)object)->Render(render_context, params.shader_params, params.camera, params.layer, sort_key);
+				if (params.texture_streamer)
+				{
+					((MeshComponent*)object)->RequestTextureMips(params.texture_streamer, params.camera, params.viewport->height);
+				}
 
 			default:
 				break;
@@ -8,14 +8,14 @@
 
 namespace sb
 {
-	class ConfigValue;
+	class CompiledConfigValue;
 	class WorldRenderView : public RenderView
 	{
 	public:
 		WorldRenderView();
 		~WorldRenderView();
 
-		void Load(const ConfigValue& config,
+		void Load(const CompiledConfigValue& config,
 				  RenderResourceAllocator* resource_allocator,
 				  RenderResourceSet* resource_set) OVERRIDE;
 		void Render(uint64_t sort_key, 
@@ -11,7 +11,7 @@
 #include "Font.h"
 #include "GUICanvas.h"
 
-#include <Foundation/Container/ConfigValue.h>
+#include <Foundation/Container/CompiledConfig.h>
 #include <Foundation/Profiler/Profiler.h>
 
 #include <Engine/Rendering/NullRenderDevice.h>
@@ -20,6 +20,7 @@
 #include <Engine/Rendering/ShaderManager.h>
 #include <Engine/Rendering/MaterialManager.h>
 #include <Engine/Rendering/Texture.h>
+#include <Engine/Rendering/TextureStreamer.h>
 #include <Engine/Rendering/Mesh.h>
 
 #include <RenderD3D11/Common.h>
@@ -36,7 +37,8 @@ Renderer::Renderer(ResourceManager* resource_manager, TaskScheduler* scheduler)
 	_scheduler(scheduler),
 	_device(nullptr),
 	_shader_manager(nullptr),
-	_material_manager(nullptr)
+	_material_manager(nullptr),
+	_texture_streamer(nullptr)
 {
 }
 Renderer::~Renderer()
@@ -51,8 +53,9 @@ void Renderer::Initialize(const RenderDevice::InitParams& params)
 
 	_shader_manager = new ShaderManager(_device, _resource_manager);
 	_material_manager = new MaterialManager(_shader_manager, _resource_manager);
+	_texture_streamer = new TextureStreamer(_resource_manager->GetResourceLoader(), _device->GetResourceAllocator());
 
-	texture_resource::RegisterResourceType(_resource_manager, _device);
+	texture_resource::RegisterResourceType(_resource_manager, _texture_streamer);
 	mesh_resource::RegisterResourceType(_resource_manager, _device);
 	font_resource::RegisterResourceType(_resource_manager, _device->GetResourceAllocator());
 }
@@ -63,6 +66,9 @@ void Renderer::Shutdown()
 	mesh_resource::UnregisterResourceType(_resource_manager);
 	texture_resource::UnregisterResourceType(_resource_manager);
 
+	delete _texture_streamer;
+	_texture_streamer = nullptr;
+
 	delete _material_manager;
 	_material_manager = nullptr;
 
@@ -77,7 +83,7 @@ void Renderer::Shutdown()
 
 //-------------------------------------------------------------------------------
 
-void Renderer::LoadRenderSetup(const ConfigValue& render_setup)
+void Renderer::LoadRenderSetup(const CompiledConfigValue& render_setup)
 {
 	RenderResourceAllocator* resource_allocator = _device->GetResourceAllocator();
 	if (render_setup.IsObject())
@@ -126,13 +132,13 @@ void Renderer::UnloadRenderSetup()
 
 //-------------------------------------------------------------------------------
 
-void Renderer::LoadLayerConfig(const ConfigValue& layers)
+void Renderer::LoadLayerConfig(const CompiledConfigValue& layers)
 {
 	Assert(layers.IsArray());
 	AssertMsg(layers.Size() < 256, "Maximum number of layers");
 	for (uint32_t l = 0; l < layers.Size(); ++l)
 	{
-		const ConfigValue& layer_cfg = layers[l];
+		CompiledConfigValue layer_cfg = layers[l];
 		Assert(layer_cfg.IsObject());
 
 		Layer* layer = new Layer();
@@ -229,14 +235,14 @@ void Renderer::LoadLayerConfig(const ConfigValue& layers)
 		_layers.push_back(layer);
 	}
 }
-void Renderer::LoadShadingEnvironments(const ConfigValue& envs)
+void Renderer::LoadShadingEnvironments(const CompiledConfigValue& envs)
 {
 	if (!envs.IsArray())
 		return;
 
 	for (uint32_t i = 0; i < envs.Size(); ++i)
 	{
-		const ConfigValue& env_cfg = envs[i];
+		CompiledConfigValue env_cfg = envs[i];
 		Assert(env_cfg.IsObject());
 
 		Assert(env_cfg["name"].IsString());
@@ -269,6 +275,7 @@ void Renderer::DrawWorld(World* world, Camera* camera, Viewport* viewport, Shadi
 	render_params.camera = camera;
 	render_params.shader_params = &shading_env->GetShaderParameters();
 	render_params.viewport = viewport;
+	render_params.texture_streamer = _texture_streamer;
 
 	for (auto& layer : _layers)
 	{
@@ -325,6 +332,10 @@ void Renderer::FlushGUI(GUICanvas* gui)
 
 	_device->ReleaseRenderContext(render_context);
 }
+void Renderer::UpdateTextureStreaming()
+{
+	_texture_streamer->Update();
+}
 void Renderer::UpdatePerFrameData(Camera* camera, RenderContext* render_context)
 {
 	// Update global constant buffers
@@ -363,6 +374,10 @@ MaterialManager* Renderer::GetMaterialManager()
 {
 	return _material_manager;
 }
+TextureStreamer* Renderer::GetTextureStreamer()
+{
+	return _texture_streamer;
+}
 RenderResourceSet* Renderer::GetGlobalResourceSet()
 {
 	return &_global_resource_set;
@@ -19,13 +19,14 @@ namespace sb
 	class TaskScheduler;
 	class ShaderManager;
 	class MaterialManager;
-	class ConfigValue;
+	class CompiledConfigValue;
 	class World;
 	class GUICanvas;
 	class RenderWorld;
 	class Camera;
 	class ShadingEnvironment;
 	class RenderResourceAllocator;
+	class TextureStreamer;
 
 	/// @brief Interface for the render system
 	class Renderer
@@ -40,18 +41,22 @@ namespace sb
 		/// Loads a render setup from json, this should be called after all render settings are set up 
 		///		and after you have created a swap-chain, as the global resource setup may be dependent
 		///		on the back buffer.
-		void LoadRenderSetup(const ConfigValue& render_setup);
+		void LoadRenderSetup(const CompiledConfigValue& render_setup);
 		void UnloadRenderSetup();
 
 		void DrawWorld(World* world, Camera* camera, Viewport* viewport, ShadingEnvironment* shading_env, Camera* external_frustum = nullptr);
 		void FlushGUI(GUICanvas* gui);
 
+		/// @brief Streams texture mips requested by the worlds drawn this frame, call once per frame.
+		void UpdateTextureStreaming();
+
 		/// Gets the size of the active back buffer
 		void GetBackbufferSize(uint32_t& width, uint32_t& height) const;
 
 		RenderDevice* GetDevice();
 		ShaderManager* GetShaderManager();
 		MaterialManager* GetMaterialManager();
+		TextureStreamer* GetTextureStreamer();
 		RenderResourceSet* GetGlobalResourceSet();
 		ResourceManager* GetResourceManager();
 
@@ -66,8 +71,8 @@ namespace sb
 		ShadingEnvironment* GetShadingEnvironment(StringId32 name);
 
 	private:
-		void LoadLayerConfig(const ConfigValue& layers);
-		void LoadShadingEnvironments(const ConfigValue& envs);
+		void LoadLayerConfig(const CompiledConfigValue& layers);
+		void LoadShadingEnvironments(const CompiledConfigValue& envs);
 
 		void UpdatePerFrameData(Camera* camera, RenderContext* render_context);
 
@@ -77,6 +82,7 @@ namespace sb
 		RenderDevice* _device;
 		ShaderManager* _shader_manager;
 		MaterialManager* _material_manager;
+		TextureStreamer* _texture_streamer;
 		RenderViewSet _render_views;
 
 		vector<Layer*> _layers;
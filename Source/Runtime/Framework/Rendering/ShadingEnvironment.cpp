@@ -4,7 +4,7 @@
 
 #include "ShadingEnvironment.h"
 
-#include <Foundation/Container/ConfigValue.h>
+#include <Foundation/Container/CompiledConfig.h>
 
 
 namespace sb
@@ -17,14 +17,14 @@ namespace sb
 	{
 	}
 
-	void ShadingEnvironment::Load(const ConfigValue& cfg)
+	void ShadingEnvironment::Load(const CompiledConfigValue& cfg)
 	{
 		if (!cfg["variables"].IsArray())
 			return;
 
 		for (uint32_t v = 0; v < cfg["variables"].Size(); ++v)
 		{
-			const ConfigValue& var = cfg["variables"][v];
+			CompiledConfigValue var = cfg["variables"][v];
 			Assert(var["name"].IsString());
 			Assert(var["type"].IsString());
 
@@ -13,7 +13,7 @@
 namespace sb
 {
 
-	class ConfigValue;
+	class CompiledConfigValue;
 
 	/// ShadingEnvironment is used for handling global variables in the shader system
 	class ShadingEnvironment
@@ -22,7 +22,7 @@ namespace sb
 		ShadingEnvironment();
 		~ShadingEnvironment();
 
-		void Load(const ConfigValue& cfg);
+		void Load(const CompiledConfigValue& cfg);
 
 		void SetScalar(StringId32 name, float value);
 		void SetVector2(StringId32 name, const Vec2f& value);
@@ -14,6 +14,8 @@
 #include <Engine/Rendering/ShaderParameters.h>
 #include <Engine/Rendering/RenderContext.h>
 #include <Engine/Rendering/RShader.h>
+#include <Engine/Rendering/Texture.h>
+#include <Engine/Rendering/TextureStreamer.h>
 
 
 namespace sb
@@ -79,8 +81,29 @@ namespace sb
 
 		sort_key |= uint64_t(sort_depth) << render_sorting::DEPTH_BIT;
 
-		for (auto& submesh : _sub_meshes)
+		// Only the sub meshes of the selected level of detail are drawn
+		uint32_t first_submesh = 0;
+		uint32_t submesh_count = (uint32_t)_sub_meshes.size();
+		if (!_mesh->lods.empty())
 		{
+			const MeshData::Lod& lod = _mesh->lods[SelectLod(CalculateScreenSize(camera))];
+			first_submesh = lod.first_submesh;
+			submesh_count = lod.submesh_count;
+		}
+
+		// Quantized positions are relative to the bounds of the mesh, folding the dequantization into
+		//	the world matrix lets the shaders use them as they are.
+		Mat4x4f dequantize;
+		dequantize.SetScale(Vec3f(_mesh->position_scale, _mesh->position_scale, _mesh->position_scale));
+		dequantize.SetTranslation(_mesh->position_offset);
+		world = world * dequantize;
+
+		for (uint32_t i = first_submesh; i < first_submesh + submesh_count; ++i)
+		{
+			const SubMesh& submesh = _sub_meshes[i];
+			if (submesh.render_block.draw_call.index_count == 0)
+				continue; // Sub mesh simplified away completely
+
 			Shader* shader = submesh.material->GetShader();
 			ShaderContext* shader_context = submesh.material->GetShaderContext();
 			ShaderResourceBinder& resource_binder = shader->GetShaderResourceBinder();
@@ -113,6 +136,63 @@ namespace sb
 
 	}
 
+	void MeshComponent::RequestTextureMips(TextureStreamer* texture_streamer, const Camera* camera, float viewport_height) const
+	{
+		if (!_mesh)
+			return;
+
+		// Approximate size of the mesh on screen, in pixels
+		float screen_size = viewport_height * CalculateScreenSize(camera);
+
+		// Lower levels of detail share the materials of the full detail mesh
+		uint32_t submesh_count = (uint32_t)_sub_meshes.size();
+		if (!_mesh->lods.empty())
+			submesh_count = _mesh->lods[0].submesh_count;
+
+		for (uint32_t i = 0; i < submesh_count; ++i)
+		{
+			const SubMesh& submesh = _sub_meshes[i];
+			for (auto& texture : submesh.material->GetTextures())
+			{
+				uint32_t mip = TextureStreamer::CalculateMip(texture, screen_size);
+				texture_streamer->RequestMip(texture, mip, screen_size);
+			}
+		}
+	}
+
+	float MeshComponent::CalculateScreenSize(const Camera* camera) const
+	{
+		AABB bounds = _mesh->bounding_box;
+		if (_game_object)
+		{
+			bounds.Transform(_transform.GetWorld());
+		}
+
+		Vec3f center = (bounds.min + bounds.max) * 0.5f;
+		float radius = (bounds.max - bounds.min).Length() * 0.5f;
+
+		if (camera->GetProjectionType() == Camera::PERSPECTIVE)
+		{
+			float distance = (camera->GetViewMatrix() * center).Length();
+			if (distance > radius)
+			{
+				return radius / (distance * math::Tan(camera->GetVerticalFov() * 0.5f));
+			}
+		}
+		return 1.0f;
+	}
+
+	uint32_t MeshComponent::SelectLod(float screen_size) const
+	{
+		uint32_t lod = 0;
+		for (uint32_t i = 1; i < _mesh->lods.size(); ++i)
+		{
+			if (screen_size < _mesh->lods[i].screen_size)
+				lod = i;
+		}
+		return lod;
+	}
+
 	void MeshComponent::GetBounds(AABB& aabb) const
 	{
 		if (_mesh)
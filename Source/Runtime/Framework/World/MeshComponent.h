@@ -17,6 +17,7 @@ namespace sb
 	class RenderContext;
 	class Camera;
 	class ShaderParameters;
+	class TextureStreamer;
 	struct Layer;
 
 	class MeshComponent : public RenderComponent
@@ -38,12 +39,21 @@ namespace sb
 		void Render(RenderContext* context, const ShaderParameters* shader_parameters,
 			const Camera* camera, const Layer* layer, uint64_t sort_key) const;
 
+		/// @brief Requests the texture mip levels needed to render this mesh at its current size on screen
+		void RequestTextureMips(TextureStreamer* texture_streamer, const Camera* camera, float viewport_height) const;
+
 		virtual void GetBounds(AABB& aabb) const OVERRIDE;
 		virtual uint8_t GetVisibilityFlags() const OVERRIDE;
 
 		MeshData* GetMesh();
 
 	private:
+		/// @return Approximate height of the mesh on screen, as a fraction of the viewport height
+		float CalculateScreenSize(const Camera* camera) const;
+
+		/// @return Index of the level of detail to use for the specified screen size
+		uint32_t SelectLod(float screen_size) const;
+
 		vector<SubMesh> _sub_meshes;
 
 		MeshData* _mesh;
@@ -28,7 +28,7 @@ namespace sb
 		{
 			child->_parent = nullptr;
 		}
-		_children.clear();
+		_children.Clear();
 	}
 
 	void Transform::SetLocalRotation(const Mat3x3f& rotation)
@@ -78,15 +78,15 @@ namespace sb
 	{
 		child->Detach();
 
-		_children.push_back(child);
+		_children.PushBack(child);
 		child->_parent = this;
 	}
 	void Transform::DetachChild(Transform* child)
 	{
-		vector<Transform*>::iterator it = std::find(_children.begin(), _children.end(), child);
-		if (it != _children.end())
+		Vector<Transform*>::Iterator it = Find(_children.Begin(), _children.End(), child);
+		if (it != _children.End())
 		{
-			_children.erase(it);
+			_children.Erase(it);
 		}
 	}
 
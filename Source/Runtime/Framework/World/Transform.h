@@ -6,6 +6,7 @@
 #include <Foundation/Math/Matrix4x4.h>
 #include <Foundation/Math/Matrix3x3.h>
 #include <Foundation/Math/Vec3.h>
+#include <Foundation/Container/SmallVector.h>
 
 
 namespace sb
@@ -45,7 +46,7 @@ namespace sb
 		Mat4x4f BuildTransform() const;
 
 		Transform* _parent;
-		vector<Transform*> _children;
+		SmallVector<Transform*, 4> _children;
 
 		Mat3x3f _rotation;
 		Vec3f _position;
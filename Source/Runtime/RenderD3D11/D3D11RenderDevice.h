@@ -75,7 +75,7 @@ namespace sb
 
 		InitParams _device_params;
 
-		RenderContext::SortCmdList _sort_cmds; // Temporary arrays for holding merged sort commands
+		vector<RenderContext::SortCmd> _sort_cmds; // Temporary arrays for holding merged sort commands, kept between frames
 	};
 
 } // namespace sb
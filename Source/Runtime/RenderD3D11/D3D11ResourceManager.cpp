@@ -52,7 +52,10 @@ namespace sb
 			/* ET_FLOAT2 */ DXGI_FORMAT_R32G32_FLOAT,
 			/* ET_FLOAT3 */ DXGI_FORMAT_R32G32B32_FLOAT,
 			/* ET_FLOAT4 */ DXGI_FORMAT_R32G32B32A32_FLOAT,
-			/* ET_UBYTE4 */ DXGI_FORMAT_R8G8B8A8_UINT
+			/* ET_UBYTE4 */ DXGI_FORMAT_R8G8B8A8_UINT,
+			/* ET_USHORT4N */ DXGI_FORMAT_R16G16B16A16_UNORM,
+			/* ET_SHORT2N */ DXGI_FORMAT_R16G16_SNORM,
+			/* ET_HALF2 */ DXGI_FORMAT_R16G16_FLOAT
 		};
 	};
 
@@ -251,6 +254,14 @@ namespace sb
 				ReleaseTexture(cmd->resource_handle);
 				break;
 			}
+			case RenderResourceAllocator::REALLOCATE_TEXTURE:
+			{
+				RenderResourceAllocator::AllocateTextureCmd* cmd = (RenderResourceAllocator::AllocateTextureCmd*)cur;
+				cur += sizeof(RenderResourceAllocator::AllocateTextureCmd);
+
+				ReallocateTexture(cmd->resource_handle, cmd->desc, cmd->surface_data);
+				break;
+			}
 
 			case RenderResourceAllocator::ALLOCATE_RAW_BUFFER:
 			{
@@ -556,6 +567,20 @@ namespace sb
 
 		_num_allocations++;
 	}
+	void D3D11ResourceManager::ReallocateTexture(uint32_t handle, const TextureDesc& desc, uint8_t** surface_data)
+	{
+		Assert(IsValid(handle));
+		Assert(_handle_lut.size() > handle);
+
+		// Recreate the texture in place, keeping the handle mapped to the same pool object
+		uint32_t idx = GetIndex(_handle_lut[handle], RenderResource::TEXTURE);
+		D3D11Texture* texture = _texture_pool.GetObject(idx);
+		_texture_manager->DestroyTexture(texture);
+
+		texture->srv = nullptr;
+		texture->srv_srgb = nullptr;
+		_texture_manager->CreateTexture(texture, desc, surface_data);
+	}
 	void D3D11ResourceManager::ReleaseTexture(uint32_t handle)
 	{
 		Assert(IsValid(handle));
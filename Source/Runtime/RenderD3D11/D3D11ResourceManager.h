@@ -84,6 +84,7 @@ namespace sb
 		/// @brief Allocates a texture
 		/// @sa ReleaseResource
 		void AllocateTexture(uint32_t handle, const TextureDesc& desc, uint8_t** surface_data);
+		void ReallocateTexture(uint32_t handle, const TextureDesc& desc, uint8_t** surface_data);
 
 		/// @brief Allocates a vertex buffer
 		/// @sa ReleaseResource
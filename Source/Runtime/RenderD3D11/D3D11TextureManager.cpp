@@ -123,7 +123,7 @@ namespace sb
 			D3D11_SHADER_RESOURCE_VIEW_DESC srv_desc;
 			srv_desc.Format = ToDXGIFormat(desc.pixel_format, false);
 			srv_desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-			srv_desc.Texture2D.MipLevels = 1;
+			srv_desc.Texture2D.MipLevels = desc.mip_count;
 			srv_desc.Texture2D.MostDetailedMip = 0;
 
 			D3D_VERIFY(device->CreateShaderResourceView(d3d_tex_impl->texture.Get(), &srv_desc, &d3d_texture->srv));
@@ -134,7 +134,7 @@ namespace sb
 				D3D11_SHADER_RESOURCE_VIEW_DESC srv_srgb_desc;
 				srv_srgb_desc.Format = ToDXGIFormat(desc.pixel_format, true);
 				srv_srgb_desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
-				srv_srgb_desc.Texture2D.MipLevels = 1;
+				srv_srgb_desc.Texture2D.MipLevels = desc.mip_count;
 				srv_srgb_desc.Texture2D.MostDetailedMip = 0;
 
 				D3D_VERIFY(device->CreateShaderResourceView(d3d_tex_impl->texture.Get(), &srv_srgb_desc, &d3d_texture->srv_srgb));
@@ -219,7 +219,7 @@ namespace sb
 			D3D11_SHADER_RESOURCE_VIEW_DESC srv_desc;
 			srv_desc.Format = ToDXGIFormat(desc.pixel_format, false);
 			srv_desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBE;
-			srv_desc.TextureCube.MipLevels = 1;
+			srv_desc.TextureCube.MipLevels = desc.mip_count;
 			srv_desc.TextureCube.MostDetailedMip = 0;
 
 			D3D_VERIFY(device->CreateShaderResourceView(d3d_tex_impl->texture.Get(), &srv_desc, &d3d_texture->srv));
@@ -230,7 +230,7 @@ namespace sb
 				D3D11_SHADER_RESOURCE_VIEW_DESC srv_srgb_desc;
 				srv_srgb_desc.Format = ToDXGIFormat(desc.pixel_format, true);
 				srv_srgb_desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURECUBE;
-				srv_srgb_desc.TextureCube.MipLevels = 1;
+				srv_srgb_desc.TextureCube.MipLevels = desc.mip_count;
 				srv_srgb_desc.TextureCube.MostDetailedMip = 0;
 
 				D3D_VERIFY(device->CreateShaderResourceView(d3d_tex_impl->texture.Get(), &srv_srgb_desc, &d3d_texture->srv_srgb));
@@ -0,0 +1,106 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Framework.h"
+
+#include <Foundation/Timer/Timer.h>
+
+namespace sb
+{
+
+	//-------------------------------------------------------------------------------
+	Benchmark* Benchmark::Next() const
+	{
+		return _next;
+	}
+	void Benchmark::SetNext(Benchmark* benchmark)
+	{
+		_next = benchmark;
+	}
+	const char* Benchmark::Name() const
+	{
+		return _name;
+	}
+	//-------------------------------------------------------------------------------
+
+
+	//-------------------------------------------------------------------------------
+	namespace
+	{
+		Benchmark* g_head_benchmark = nullptr;
+	};
+
+	void benchmark::RegisterBenchmark(Benchmark* benchmark)
+	{
+		if (g_head_benchmark)
+		{
+			// Put the new benchmark last in the chain.
+
+			Benchmark* next = g_head_benchmark;
+			while (next->Next())
+			{
+				next = next->Next();
+			}
+			next->SetNext(benchmark);
+		}
+		else
+			g_head_benchmark = benchmark;
+	}
+
+	uint32_t benchmark::RunBenchmarks(const BenchmarkContext& context, const char* filter)
+	{
+		uint32_t count = 0;
+
+		Benchmark* benchmark = g_head_benchmark;
+		while (benchmark)
+		{
+			if (!filter || strstr(benchmark->Name(), filter) != nullptr)
+			{
+				printf("[RUN] %s\n", benchmark->Name());
+
+				double start = Seconds();
+				benchmark->Run(context);
+				printf("[---] %s: %.3f s\n", benchmark->Name(), Seconds() - start);
+
+				++count;
+			}
+			benchmark = benchmark->Next();
+		}
+
+		printf("\nSummary: %d benchmarks run.\n", count);
+
+		return count;
+	}
+	double benchmark::Seconds()
+	{
+		return timer::Seconds();
+	}
+	void benchmark::Report(const char* fmt, ...)
+	{
+		va_list args;
+		va_start(args, fmt);
+		printf("      ");
+		vprintf(fmt, args);
+		printf("\n");
+		va_end(args);
+	}
+
+	//-------------------------------------------------------------------------------
+
+
+} // namespace sb
+
+/// Usage: Benchmark_Foundation [content directory] [name filter]
+int main(int argc, char* argv[])
+{
+	sb::timer::Initialize();
+	sb::memory::Initialize();
+
+	sb::BenchmarkContext context;
+	context.content_dir = (argc > 1) ? argv[1] : "Binaries/Content";
+
+	sb::benchmark::RunBenchmarks(context, (argc > 2) ? argv[2] : nullptr);
+
+	sb::memory::Shutdown();
+
+	return 0;
+}
@@ -0,0 +1,76 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __BENCHMARK_FRAMEWORK_H__
+#define __BENCHMARK_FRAMEWORK_H__
+
+#include <Foundation/Common.h>
+
+namespace sb
+{
+
+	//-------------------------------------------------------------------------------
+	/// @brief Parameters passed to all benchmarks
+	struct BenchmarkContext
+	{
+		/// Directory with real content to run IO and parsing benchmarks on (E.g. "Binaries/Content")
+		const char* content_dir;
+	};
+
+	class Benchmark
+	{
+	public:
+		Benchmark(const char* name) : _name(name), _next(NULL) {}
+
+		virtual void Run(const BenchmarkContext& context) = 0;
+
+		Benchmark* Next() const;
+		void SetNext(Benchmark* benchmark);
+
+		const char* Name() const;
+
+	private:
+		const char* _name;
+		Benchmark* _next;
+	};
+
+	//-------------------------------------------------------------------------------
+	namespace benchmark
+	{
+		void RegisterBenchmark(Benchmark* benchmark);
+
+		/// Runs all benchmarks with a name containing the specified filter
+		/// @param filter Name filter, NULL runs all benchmarks
+		/// @return Number of benchmarks run
+		uint32_t RunBenchmarks(const BenchmarkContext& context, const char* filter);
+
+		/// Returns the current time in seconds
+		double Seconds();
+
+		/// Prints a single result line for the running benchmark
+		void Report(const char* fmt, ...) ATTR_PRINTF(1, 2);
+
+	};
+
+	//-------------------------------------------------------------------------------
+
+} // namespace sb
+
+//-------------------------------------------------------------------------------
+
+#define BENCHMARK_CLASS_NAME(benchmark_name) benchmark_name##_Benchmark
+
+#define BENCHMARK(benchmark_name) \
+class BENCHMARK_CLASS_NAME(benchmark_name) : protected sb::Benchmark \
+{ \
+public: \
+	BENCHMARK_CLASS_NAME(benchmark_name)() : Benchmark(#benchmark_name) { \
+	sb::benchmark::RegisterBenchmark(this); \
+	} \
+	virtual void Run(const sb::BenchmarkContext& _context); \
+}; \
+	static BENCHMARK_CLASS_NAME(benchmark_name) s_benchmark_##benchmark_name; \
+	void BENCHMARK_CLASS_NAME(benchmark_name)::Run(const sb::BenchmarkContext& _context) \
+
+//-------------------------------------------------------------------------------
+
+#endif // __BENCHMARK_FRAMEWORK_H__
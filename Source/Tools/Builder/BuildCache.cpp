@@ -0,0 +1,219 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "BuildCache.h"
+
+#include <Foundation/Filesystem/FileSource.h>
+#include <Foundation/Filesystem/FileUtil.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Timer/Timer.h>
+
+#include <stdio.h>
+
+namespace sb
+{
+
+	BuildCache::BuildCache(FileSource* file_source)
+		: _file_source(file_source),
+		_temp_counter(0)
+	{
+		Assert(_file_source);
+	}
+	BuildCache::~BuildCache()
+	{
+	}
+	bool BuildCache::GetDependencies(uint64_t base_key, vector<string>& dependencies)
+	{
+		string path;
+		BuildPath(base_key, ".manifest", path);
+
+		vector<uint8_t> data;
+		if (!ReadFile(path, data))
+			return false;
+
+		// [version][count]{[length][path]}
+		const uint8_t* ptr = data.data();
+		const uint8_t* end = ptr + data.size();
+		if (end - ptr < 8 || *(const uint32_t*)ptr != MANIFEST_VERSION)
+			return false;
+
+		uint32_t count = *(const uint32_t*)(ptr + 4);
+		ptr += 8;
+
+		dependencies.clear();
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (end - ptr < 4)
+				return false;
+			uint32_t length = *(const uint32_t*)ptr;
+			ptr += 4;
+
+			if ((uint32_t)(end - ptr) < length)
+				return false;
+			dependencies.push_back(string((const char*)ptr, length));
+			ptr += length;
+		}
+		return true;
+	}
+	bool BuildCache::Read(uint64_t key, vector<uint8_t>& data)
+	{
+		string path;
+		BuildPath(key, ".data", path);
+		return ReadFile(path, data);
+	}
+	void BuildCache::Write(uint64_t base_key, const vector<string>& dependencies, uint64_t key, const uint8_t* data, uint32_t size)
+	{
+		string path;
+
+		// Data first, a manifest should never lead to data that isn't there
+		BuildPath(key, ".data", path);
+		if (!WriteFile(path, data, size))
+			return;
+
+		vector<uint8_t> manifest;
+		DynamicMemoryStream stream(&manifest);
+
+		uint32_t version = MANIFEST_VERSION;
+		uint32_t count = (uint32_t)dependencies.size();
+		stream.Write(&version, 4);
+		stream.Write(&count, 4);
+		for (auto& dependency : dependencies)
+		{
+			uint32_t length = (uint32_t)dependency.size();
+			stream.Write(&length, 4);
+			stream.Write(dependency.c_str(), length);
+		}
+
+		BuildPath(base_key, ".manifest", path);
+		WriteFile(path, manifest.data(), (uint32_t)manifest.size());
+	}
+	void BuildCache::Write(uint64_t key, const uint8_t* data, uint32_t size)
+	{
+		string path;
+		BuildPath(key, ".data", path);
+		WriteFile(path, data, size);
+	}
+	void BuildCache::Trim(uint64_t max_size)
+	{
+		struct Entry
+		{
+			string path;
+			uint64_t size;
+			FileTime last_used;
+		};
+
+		vector<string> files;
+		file_util::FindFilesRecursive(_file_source, "*", files);
+
+		vector<Entry> entries;
+		entries.reserve(files.size());
+
+		uint64_t total_size = 0;
+		for (auto& file : files)
+		{
+			// Temporary files belong to writes in progress
+			if (file.size() >= 4 && file.compare(file.size() - 4, 4, ".tmp") == 0)
+				continue;
+
+			Entry entry;
+			entry.path = BuildOSPath(file);
+			if (!file_util::GetFileInfo(entry.path.c_str(), entry.size, entry.last_used))
+				continue;
+
+			total_size += entry.size;
+			entries.push_back(entry);
+		}
+
+		if (total_size <= max_size)
+			return;
+
+		std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.last_used < b.last_used; });
+
+		// A manifest may be removed without its data and the other way around, either just gives a cache miss
+		uint32_t removed = 0;
+		for (auto& entry : entries)
+		{
+			if (total_size <= max_size)
+				break;
+
+			if (remove(entry.path.c_str()) == 0)
+			{
+				total_size -= entry.size;
+				++removed;
+			}
+		}
+		logging::Info("BuildCache: Removed %u least recently used entries", removed);
+	}
+	void BuildCache::BuildPath(uint64_t key, const char* extension, string& path)
+	{
+		char name[32];
+		sprintf(name, "%02x/%016llx", (uint32_t)(key >> 56), (unsigned long long)key);
+
+		path = name;
+		path += extension;
+	}
+	bool BuildCache::ReadFile(const string& path, vector<uint8_t>& data)
+	{
+		FileStreamPtr file = _file_source->OpenFile(path.c_str(), File::READ);
+		if (!file.Get() || file->Length() < 0)
+			return false;
+
+		data.resize((size_t)file->Length());
+		if (!data.empty() && file->Read(data.data(), data.size()) != data.size())
+			return false;
+
+		file.Reset();
+		file_util::TouchFile(BuildOSPath(path).c_str());
+		return true;
+	}
+	string BuildCache::BuildOSPath(const string& path)
+	{
+		string full_path = _file_source->GetFullPath();
+		full_path += PATH_SEPARATOR;
+		full_path += path;
+
+		file_util::FixSlashes(full_path);
+		return full_path;
+	}
+	bool BuildCache::WriteFile(const string& path, const uint8_t* data, uint32_t size)
+	{
+		// Make sure folder exists
+		_file_source->MakeDirectory(path.substr(0, 2).c_str());
+
+		// Temporary names only need to be unique between concurrent writers, the time together with a
+		//	counter and the address of the cache makes collisions very unlikely.
+		char suffix[64];
+		sprintf(suffix, ".%llx.%lx.%llx.tmp", (unsigned long long)timer::TickCount(), thread::InterlockedIncrement(&_temp_counter),
+			(unsigned long long)(uintptr_t)this);
+
+		string temp_path = path + suffix;
+		{
+			FileStreamPtr file = _file_source->OpenFile(temp_path.c_str(), File::WRITE);
+			if (!file.Get())
+			{
+				logging::Warning("BuildCache: Failed to write '%s'", temp_path.c_str());
+				return false;
+			}
+			bool written = (file->Write(data, size) == size);
+			file.Reset();
+
+			if (!written)
+			{
+				remove(BuildOSPath(temp_path).c_str());
+				return false;
+			}
+		}
+
+		string full_temp_path = BuildOSPath(temp_path);
+		string full_path = BuildOSPath(path);
+
+		if (!file_util::RenameFile(full_temp_path.c_str(), full_path.c_str()))
+		{
+			remove(full_temp_path.c_str());
+			return false;
+		}
+		return true;
+	}
+
+} // namespace sb
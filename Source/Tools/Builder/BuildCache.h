@@ -0,0 +1,73 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __BUILDER_BUILDCACHE_H__
+#define __BUILDER_BUILDCACHE_H__
+
+namespace sb
+{
+
+	class FileSource;
+
+	/// @brief Content-addressed cache of compiled assets
+	///
+	///	Entries are found in two steps. The base key (hash of the source file, the compiler and the
+	///		build settings) leads to a manifest listing the files the asset depended on when it was
+	///		compiled. Hashing the current contents of those files together with the base key then
+	///		gives the key of the compiled data. That way the cache can be used without knowing the
+	///		dependencies of an asset beforehand, e.g. in a fresh checkout.
+	///
+	///	Files are written under temporary names and renamed into place, so several builders (other
+	///		checkouts on the same machine or machines sharing the directory) can use the same cache.
+	///
+	///	Reading an entry updates its modification time, which lets Trim() remove the least recently used entries.
+	class BuildCache
+	{
+	public:
+		/// @param file_source FileSource for the cache directory
+		BuildCache(FileSource* file_source);
+		~BuildCache();
+
+		/// Reads the manifest for the specified base key
+		/// @param dependencies Paths of the dependencies when the entry was written, sorted
+		/// @return True if the manifest was found
+		bool GetDependencies(uint64_t base_key, vector<string>& dependencies);
+
+		/// Reads compiled data from the cache
+		/// @return True if the data was found
+		bool Read(uint64_t key, vector<uint8_t>& data);
+
+		/// Writes compiled data together with its manifest
+		void Write(uint64_t base_key, const vector<string>& dependencies, uint64_t key, const uint8_t* data, uint32_t size);
+
+		/// Writes data without a manifest, for entries where the key already covers all inputs
+		void Write(uint64_t key, const uint8_t* data, uint32_t size);
+
+		/// Removes the least recently used entries until the cache holds at most max_size bytes
+		void Trim(uint64_t max_size);
+
+	private:
+		const BuildCache& operator=(const BuildCache&) { return *this; }
+
+		enum { MANIFEST_VERSION = 1 };
+
+		/// Builds the path for the specified key, entries are spread over 256 directories
+		void BuildPath(uint64_t key, const char* extension, string& path);
+
+		/// Builds the OS path for a file in the cache
+		string BuildOSPath(const string& path);
+
+		/// Reads the file and marks it as used
+		bool ReadFile(const string& path, vector<uint8_t>& data);
+
+		/// Writes the data to a temporary file and then moves it to the specified path
+		bool WriteFile(const string& path, const uint8_t* data, uint32_t size);
+
+		FileSource* _file_source;
+		volatile long _temp_counter;
+	};
+
+} // namespace sb
+
+
+
+#endif // __BUILDER_BUILDCACHE_H__
@@ -0,0 +1,183 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "BuildReport.h"
+
+#include <Foundation/Filesystem/File.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Json/Json.h>
+#include <Foundation/Timer/Timer.h>
+
+namespace sb
+{
+
+	BuildReport::BuildReport()
+		: _skip_count(0),
+		_failed_count(0),
+		_start(timer::Seconds())
+	{
+	}
+	BuildReport::~BuildReport()
+	{
+	}
+	void BuildReport::OnCompileBatch(AssetSource* , uint32_t )
+	{
+	}
+	void BuildReport::OnCompile(const FilePath& , const FilePath& )
+	{
+	}
+	void BuildReport::OnCompileSkip(const FilePath& , const FilePath& )
+	{
+		++_skip_count;
+	}
+	void BuildReport::OnCompileSuccessful(const FilePath& , const FilePath& )
+	{
+	}
+	void BuildReport::OnCompileFailed(const FilePath& , const FilePath& , const string& )
+	{
+		++_failed_count;
+	}
+	void BuildReport::OnCompileStats(const AssetSource& source, const CompilerSystem::JobStats& stats)
+	{
+		_entries.push_back(Entry());
+		Entry& entry = _entries.back();
+		entry.source = source.source_path.c_str();
+		entry.type = source.source_type;
+		entry.stats = stats;
+	}
+	uint32_t BuildReport::GetFailedCount() const
+	{
+		return _failed_count;
+	}
+	bool BuildReport::Write(const char* path, Format format) const
+	{
+		ConfigValue root;
+		if (format == CHROME_TRACE)
+			BuildTrace(root);
+		else
+			BuildJson(root);
+
+		vector<uint8_t> data;
+		{
+			DynamicMemoryStream stream(&data);
+			json::Writer writer(stream, format == JSON);
+			writer.Write(root);
+		}
+
+		File file;
+		if (!file.Open(path, File::WRITE))
+		{
+			logging::Warning("Failed to open '%s' for writing", path);
+			return false;
+		}
+		bool written = (file.Write(data.data(), (uint32_t)data.size()) == data.size());
+		file.Close();
+
+		return written;
+	}
+	void BuildReport::BuildJson(ConfigValue& root) const
+	{
+		struct Totals
+		{
+			Totals() : count(0), cached(0), failed(0), time(0.0), bytes_in(0), bytes_out(0) {}
+
+			uint32_t count;
+			uint32_t cached;
+			uint32_t failed;
+			double time;
+			uint64_t bytes_in;
+			uint64_t bytes_out;
+		};
+
+		map<InternedString, Totals> types;
+		Totals all;
+
+		root.SetEmptyObject();
+
+		ConfigValue& assets = root["assets"];
+		assets.SetEmptyArray();
+		for (auto& entry : _entries)
+		{
+			const CompilerSystem::JobStats& stats = entry.stats;
+			bool failed = (stats.result == CompilerSystem::FAILED);
+
+			ConfigValue& asset = assets.Append();
+			asset.SetEmptyObject();
+			asset["source"].SetString(entry.source.c_str());
+			asset["type"].SetString(entry.type.c_str());
+			asset["time"].SetDouble(stats.duration);
+			asset["bytes_in"].SetUInt(stats.bytes_in);
+			asset["bytes_out"].SetUInt(stats.bytes_out);
+			asset["cached"].SetBool(stats.cached);
+			asset["failed"].SetBool(failed);
+
+			Totals* totals[] = { &types[entry.type], &all };
+			for (Totals* t : totals)
+			{
+				t->count++;
+				t->cached += stats.cached ? 1 : 0;
+				t->failed += failed ? 1 : 0;
+				t->time += stats.duration;
+				t->bytes_in += stats.bytes_in;
+				t->bytes_out += stats.bytes_out;
+			}
+		}
+
+		ConfigValue& summary = root["summary"];
+		summary.SetEmptyObject();
+		summary["wall_time"].SetDouble(timer::Seconds() - _start);
+		summary["compiled"].SetUInt(all.count);
+		summary["skipped"].SetUInt(_skip_count);
+		summary["cached"].SetUInt(all.cached);
+		summary["failed"].SetUInt(all.failed);
+		summary["time"].SetDouble(all.time);
+		summary["bytes_in"].SetUInt(all.bytes_in);
+		summary["bytes_out"].SetUInt(all.bytes_out);
+
+		ConfigValue& types_cfg = root["types"];
+		types_cfg.SetEmptyObject();
+		for (auto& type : types)
+		{
+			ConfigValue& t = types_cfg[type.first.c_str()];
+			t.SetEmptyObject();
+			t["count"].SetUInt(type.second.count);
+			t["cached"].SetUInt(type.second.cached);
+			t["failed"].SetUInt(type.second.failed);
+			t["time"].SetDouble(type.second.time);
+			t["bytes_in"].SetUInt(type.second.bytes_in);
+			t["bytes_out"].SetUInt(type.second.bytes_out);
+		}
+	}
+	void BuildReport::BuildTrace(ConfigValue& root) const
+	{
+		// Trace Event Format, every asset becomes a complete event ("X") on the thread of its worker
+		root.SetEmptyObject();
+		root["displayTimeUnit"].SetString("ms");
+
+		ConfigValue& events = root["traceEvents"];
+		events.SetEmptyArray();
+		for (auto& entry : _entries)
+		{
+			const CompilerSystem::JobStats& stats = entry.stats;
+
+			ConfigValue& event = events.Append();
+			event.SetEmptyObject();
+			event["name"].SetString(entry.source.c_str());
+			event["cat"].SetString(entry.type.c_str());
+			event["ph"].SetString("X");
+			event["ts"].SetDouble((stats.start - _start) * 1000000.0);
+			event["dur"].SetDouble(stats.duration * 1000000.0);
+			event["pid"].SetUInt(0u);
+			event["tid"].SetUInt(stats.worker);
+
+			ConfigValue& args = event["args"];
+			args.SetEmptyObject();
+			args["bytes_in"].SetUInt(stats.bytes_in);
+			args["bytes_out"].SetUInt(stats.bytes_out);
+			args["cached"].SetBool(stats.cached);
+			args["failed"].SetBool(stats.result == CompilerSystem::FAILED);
+		}
+	}
+
+} // namespace sb
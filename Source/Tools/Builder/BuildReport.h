@@ -0,0 +1,61 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __BUILDER_BUILDREPORT_H__
+#define __BUILDER_BUILDREPORT_H__
+
+#include "BuildUICallback.h"
+
+namespace sb
+{
+
+	/// @brief Collects statistics for every compiled asset during a batch build
+	///
+	///	The report can be written either as JSON, with totals per asset type followed by the
+	///		individual assets, or as a trace that can be loaded in chrome://tracing.
+	class BuildReport : public BuildUICallback
+	{
+	public:
+		enum Format
+		{
+			JSON,
+			CHROME_TRACE
+		};
+
+		BuildReport();
+		~BuildReport();
+
+		void OnCompileBatch(AssetSource* sources, uint32_t num);
+		void OnCompile(const FilePath& source, const FilePath& target);
+		void OnCompileSkip(const FilePath& source, const FilePath& target);
+		void OnCompileSuccessful(const FilePath& source, const FilePath& target);
+		void OnCompileFailed(const FilePath& source, const FilePath& target, const string& error);
+		void OnCompileStats(const AssetSource& source, const CompilerSystem::JobStats& stats);
+
+		/// @return Number of assets that failed to compile
+		uint32_t GetFailedCount() const;
+
+		/// Writes the report to the specified file (OS path)
+		bool Write(const char* path, Format format) const;
+
+	private:
+		struct Entry
+		{
+			string source;
+			InternedString type;
+			CompilerSystem::JobStats stats;
+		};
+
+		void BuildJson(ConfigValue& root) const;
+		void BuildTrace(ConfigValue& root) const;
+
+		vector<Entry> _entries;
+
+		uint32_t _skip_count;
+		uint32_t _failed_count;
+		double _start;
+	};
+
+} // namespace sb
+
+
+#endif // __BUILDER_BUILDREPORT_H__
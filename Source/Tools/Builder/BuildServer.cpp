@@ -6,23 +6,29 @@
 #include "ShaderDatabase.h"
 #include "DependencyDatabase.h"
 #include "BuildUICallback.h"
+#include "BuildCache.h"
 
 #include <Foundation/Debug/Console.h>
 #include <Foundation/Debug/ConsoleServer.h>
 #include <Foundation/Filesystem/DirectoryWatcher.h>
+#include <Foundation/Filesystem/File.h>
 #include <Foundation/Filesystem/FilePath.h>
 #include <Foundation/Filesystem/FileUtil.h>
 #include <Foundation/Json/Json.h>
 #include <Foundation/Container/StringIdRepository.h>
+#include <Foundation/Timer/Timer.h>
 
 
 #include "MaterialCompiler.h"
+#ifdef SANDBOX_PLATFORM_WIN
 #include "ShaderCompiler.h"
 #include "TextureCompiler.h"
+#endif
 #include "MeshCompiler.h"
 #include "ScriptCompiler.h"
 #include "PackageCompiler.h"
 #include "CopyCompiler.h"
+#include "ConfigCompiler.h"
 #include "FontCompiler.h"
 
 namespace sb
@@ -95,7 +101,7 @@ namespace sb
 			else
 			{
 				uint64_t id;
-				id = _strtoui64(hex_str, NULL, 0);
+				id = strtoull(hex_str, NULL, 0);
 				result = repo->LookUp(id);
 			}
 
@@ -108,12 +114,20 @@ namespace sb
 
 	BuildServer::BuildServer(const BuilderParams& params)
 		: _file_system(params.base_path.c_str()),
+		_dir_watcher(NULL),
+		_change_debounce(DEFAULT_CHANGE_DEBOUNCE * 0.001),
+		_shader_cache_size(uint64_t(DEFAULT_SHADER_CACHE_SIZE) << 20),
 		_params(params),
-		_stop(false),
+		_callback(NULL),
+		_active_settings(NULL),
+		_compiler_system(NULL),
+		_build_cache_source(NULL),
+		_build_cache(NULL),
+		_shader_cache_source(NULL),
+		_shader_cache(NULL),
 		_dependency_database(NULL),
 		_shader_database(NULL),
-		_callback(NULL),
-		_active_settings(NULL)
+		_stop(false)
 	{
 		logging::SetCallback(LoggingCallback, nullptr);
 
@@ -129,6 +143,18 @@ namespace sb
 
 		_dependency_database = new DependencyDatabase(_source);
 		_shader_database = new ShaderDatabase(_source);
+
+		// Compiled shader programs are cached by their preprocessed source, so unchanged programs are
+		//	never recompiled even if a shared include file changes.
+		_source->MakeDirectory(".builder/shader_cache");
+		string shader_cache_path;
+		file_util::BuildOSPath(shader_cache_path, _source->GetFullPath(), ".builder/shader_cache");
+		_shader_cache_source = _file_system.OpenFileSource(shader_cache_path.c_str());
+		if (_shader_cache_source)
+		{
+			_shader_cache = new BuildCache(_shader_cache_source);
+			_shader_database->SetProgramCache(_shader_cache);
+		}
 		_string_id_repository = new StringIdRepository(_source, ".builder/string_id_repository");
 		_string_id_repository->Load();
 
@@ -142,12 +168,8 @@ namespace sb
 
 		ConfigValue settings_cfg;
 
-		simplified_json::Reader reader;
-		if (!reader.ReadFile(_source, "builder.settings", settings_cfg))
-		{
-			logging::Warning("Failed to load builder settings: %s", reader.GetErrorMessage().c_str());
+		if (!LoadSettings(settings_cfg))
 			return;
-		}
 
 		if (_params.server && (settings_cfg["console_server_port"].IsNumber())) // No need to start the console server if we're not running in server mode
 		{
@@ -155,10 +177,20 @@ namespace sb
 			logging::SetCallback(LoggingCallback, (void*)console::Server());
 		}
 
-		if (settings_cfg["setting_profiles"].IsObject())
+		if (settings_cfg["change_debounce_ms"].IsNumber())
+			_change_debounce = settings_cfg["change_debounce_ms"].AsDouble() * 0.001;
+
+		// Every change to a shader adds new programs to the cache, trimmed both here and on exit
+		if (settings_cfg["shader_cache_size_mb"].IsNumber())
+			_shader_cache_size = settings_cfg["shader_cache_size_mb"].AsUInt64() << 20;
+		if (_shader_cache)
+			_shader_cache->Trim(_shader_cache_size);
+
+		const ConfigValue& profiles = settings_cfg["setting_profiles"];
+		if (profiles.IsObject())
 		{
-			ConfigValueConstIterator	prof_it = settings_cfg["setting_profiles"].Begin(),
-				prof_end = settings_cfg["setting_profiles"].End();
+			ConfigValueConstIterator	prof_it = profiles.Begin(),
+				prof_end = profiles.End();
 			for (; prof_it != prof_end; ++prof_it)
 			{
 				BuildSettings* settings = new BuildSettings();
@@ -178,10 +210,42 @@ namespace sb
 
 		}
 
-		_compiler_system = new CompilerSystem(this, _source, _target, _dependency_database, _shader_database, _active_settings);
+		// Number of threads used for compiling, defaults to one per processor
+		uint32_t compile_threads = 0;
+		if (settings_cfg["compile_threads"].IsNumber())
+			compile_threads = settings_cfg["compile_threads"].AsUInt();
+
+		_compiler_system = new CompilerSystem(this, _source, _target, _dependency_database, _shader_database,
+			_active_settings, compile_threads);
 
 		RegisterCompilers(settings_cfg["compilers"]);
 
+		// The build cache can be shared between checkouts, so the environment variable takes
+		//	precedence over the settings file.
+		string build_cache_path;
+		const char* build_cache_env = getenv("SANDBOX_BUILD_CACHE");
+		if (build_cache_env && *build_cache_env)
+			build_cache_path = build_cache_env;
+		else if (settings_cfg["build_cache"].IsString())
+			build_cache_path = settings_cfg["build_cache"].AsString();
+
+		if (!build_cache_path.empty())
+		{
+			// Relative paths are relative to the base path, same as the source and target paths
+			_file_system.MakeDirectory(build_cache_path.c_str());
+			_build_cache_source = _file_system.OpenFileSource(build_cache_path.c_str());
+			if (_build_cache_source)
+			{
+				logging::Info("Using build cache '%s'", build_cache_path.c_str());
+				_build_cache = new BuildCache(_build_cache_source);
+				_compiler_system->SetBuildCache(_build_cache);
+			}
+			else
+			{
+				logging::Warning("Failed to open build cache '%s'", build_cache_path.c_str());
+			}
+		}
+
 		// Parse ignore list
 		if (settings_cfg["ignore_list"].IsArray())
 		{
@@ -225,12 +289,20 @@ namespace sb
 		string_id::SetRepository(NULL);
 
 		delete _compiler_system;
+		delete _build_cache;
 		delete _shader_database;
+		if (_shader_cache)
+			_shader_cache->Trim(_shader_cache_size);
+		delete _shader_cache;
 		delete _dependency_database;
 		delete _string_id_repository;
 
 		_file_system.CloseFileSource(_source);
 		_file_system.CloseFileSource(_target);
+		if (_build_cache_source)
+			_file_system.CloseFileSource(_build_cache_source);
+		if (_shader_cache_source)
+			_file_system.CloseFileSource(_shader_cache_source);
 
 		if (_params.server && console::Initialized())
 		{
@@ -244,14 +316,16 @@ namespace sb
 	}
 	void BuildServer::Run()
 	{
-		bool force_compile = false;
-		if (!_dependency_database->Load() || !_shader_database->Load()) // Force a complete compile if the dependency/shader database failed to load
+		if (!_dependency_database->Load() || !_shader_database->Load())
 		{
-			logging::Info("Missing shader or dependency database: Forcing a full compile");
-			force_compile = true;
+			// Without build keys every asset is compiled, but unlike a forced rebuild the
+			//	build cache can still be used.
+			logging::Info("Missing shader or dependency database: Compiling all assets");
+			_dependency_database->Clear();
+			_shader_database->Clear();
 		}
 
-		if (force_compile || _params.force_recompile)
+		if (_params.force_recompile)
 		{
 			FullRebuild();
 		}
@@ -269,46 +343,62 @@ namespace sb
 
 		vector<Action> actions;
 		vector<AssetSource> changes;
-		vector<DirectoryChange> pending_changes;
+
+		// Changed files waiting to be compiled, mapped to the time of their latest notification
+		map<string, double> pending_changes;
 
 		DirectoryChange dir_change;
 		while (!_stop)
 		{
+			// Sleep until something happens, but no longer than until the next pending change is due. We
+			//	still need to wake up regularly to serve the console.
+			uint32_t timeout = IDLE_TIMEOUT;
+			if (!pending_changes.empty())
+			{
+				double now = timer::Seconds();
+				for (auto& change : pending_changes)
+				{
+					double due = Max(change.second + _change_debounce - now, 0.0);
+					timeout = Min(timeout, (uint32_t)(due * 1000.0) + 1);
+				}
+			}
+			_dir_watcher->WaitForChange(timeout);
+
 			// Handle any directory changes
+			double now = timer::Seconds();
 			while (_dir_watcher->PopChange(dir_change))
 			{
+				if (dir_change.path.empty())
+				{
+					// Watcher lost track of changes, fall back to scanning everything
+					QueueScan();
+					continue;
+				}
+
 				FilePath path(dir_change.path);
 				path.SetSeparator('/');
-				if (path.Directory() == ".builder/") // Skip .builder as builder uses that directory internally
+				if (strncmp(path.c_str(), ".builder/", 9) == 0) // Skip .builder as builder uses that directory internally
 					continue;
 
-				// Windows always sends two FILE_MODIFIED notifications when a file is modified,
-				//	to make sure we only dispatch the asset to the compiler when the file is actually
-				//	ready we let the first notifaction pend until the second one arrives.
-
-				if (dir_change.action != DirectoryChange::FILE_MODIFIED)
-					changes.push_back(AssetSource(path.c_str()));
-
-				// Filter any duplicated notifications as we always get two when file is modified
-				bool found = false;
-				for (vector<DirectoryChange>::iterator it = pending_changes.begin(); it != pending_changes.end(); ++it)
+				// A single save usually produces several notifications (Windows always sends two FILE_MODIFIED
+				//	and the file may still be open by the writer when they arrive), so rather than compiling
+				//	right away we wait until the file has been quiet for a while.
+				pending_changes[path.c_str()] = now;
+			}
+			for (map<string, double>::iterator it = pending_changes.begin(); it != pending_changes.end();)
+			{
+				if (now - it->second >= _change_debounce)
 				{
-					if (it->path == dir_change.path) // this is the second notifaction
-					{
-						found = true;
-						changes.push_back(AssetSource(path.c_str()));
-						pending_changes.erase(it);
-						break;
-					}
+					changes.push_back(AssetSource(it->first.c_str()));
+					it = pending_changes.erase(it);
+				}
+				else
+				{
+					++it;
 				}
-				if (!found)
-					pending_changes.push_back(dir_change);
 			}
 			if (!changes.empty())
 			{
-				// If we dispatch the changed file to the compiler to quickly it won't be able to open the source file 
-				//		as the file is already opened by another program.
-				Sleep(100); // TODO: Find better solution than this maybe?
 				_compiler_system->Compile(changes.data(), (uint32_t)changes.size(), false, _callback);
 				changes.clear();
 			}
@@ -317,7 +407,8 @@ namespace sb
 				_shader_database->GetDirtyShaders(changes);
 				if (!changes.empty())
 				{
-					_compiler_system->Compile(changes.data(), (uint32_t)changes.size(), true, _callback);
+					// The requested permutations are part of the build key, no need to force
+					_compiler_system->Compile(changes.data(), (uint32_t)changes.size(), false, _callback);
 					changes.clear();
 				}
 			}
@@ -360,12 +451,13 @@ namespace sb
 			actions.clear();
 
 			console::Server()->Update();
-			Sleep(1);
 		}
 	}
 	void BuildServer::Stop()
 	{
 		_stop = true;
+		if (_dir_watcher)
+			_dir_watcher->Wake();
 	}
 	bool BuildServer::IsStopping() const
 	{
@@ -376,11 +468,17 @@ namespace sb
 	{
 		ScopedLock<CriticalSection> lock(_action_queue_lock);
 		_action_queue.push(FULL_REBUILD);
+
+		if (_dir_watcher)
+			_dir_watcher->Wake();
 	}
 	void BuildServer::QueueScan()
 	{
 		ScopedLock<CriticalSection> lock(_action_queue_lock);
 		_action_queue.push(SCAN);
+
+		if (_dir_watcher)
+			_dir_watcher->Wake();
 	}
 
 	void BuildServer::SetActiveProfile(const string& profile)
@@ -388,6 +486,9 @@ namespace sb
 		_queued_profile = profile;
 		ScopedLock<CriticalSection> lock(_action_queue_lock);
 		_action_queue.push(CHANGE_PROFILE);
+
+		if (_dir_watcher)
+			_dir_watcher->Wake();
 	}
 
 	void BuildServer::FullRebuild()
@@ -460,6 +561,7 @@ namespace sb
 				_compiler_system->RegisterCompiler(source_type, compiler);
 				_compilers.push_back(compiler);
 			}
+#ifdef SANDBOX_PLATFORM_WIN
 			else if (action == "shader_compiler")
 			{
 				compiler = new ShaderCompiler(compilers[i]);
@@ -474,6 +576,14 @@ namespace sb
 				_compiler_system->RegisterCompiler(source_type, compiler);
 				_compilers.push_back(compiler);
 			}
+#else
+			else if (action == "shader_compiler" || action == "texture_compiler")
+			{
+				// Shaders are compiled with D3D and textures with NVTT, neither is available here
+				logging::Warning("Build action '%s' not supported on this platform, skipping '%s' files", action.c_str(), source_type);
+				continue;
+			}
+#endif
 			else if (action == "mesh_compiler")
 			{
 				compiler = new MeshCompiler(compilers[i]);
@@ -500,6 +610,12 @@ namespace sb
 				_compiler_system->RegisterCompiler(source_type, compiler);
 				_compilers.push_back(compiler);
 			}
+			else if (action == "config_compiler")
+			{
+				compiler = new ConfigCompiler(compilers[i]);
+				_compiler_system->RegisterCompiler(source_type, compiler);
+				_compilers.push_back(compiler);
+			}
 			else if (action == "font_compiler")
 			{
 				compiler = new FontCompiler(compilers[i]);
@@ -516,6 +632,42 @@ namespace sb
 
 	}
 
+	bool BuildServer::LoadSettings(ConfigValue& settings_cfg)
+	{
+		simplified_json::Reader reader;
+		if (_params.settings_path.empty())
+		{
+			if (!reader.ReadFile(_source, "builder.settings", settings_cfg))
+			{
+				logging::Warning("Failed to load builder settings: %s", reader.GetErrorMessage().c_str());
+				return false;
+			}
+			return true;
+		}
+
+		File file;
+		if (!file.Open(_params.settings_path.c_str(), File::READ))
+		{
+			logging::Warning("Failed to open builder settings '%s'", _params.settings_path.c_str());
+			return false;
+		}
+
+		vector<char> data((size_t)Max(file.Length(), (int64_t)0));
+		bool read = data.empty() || file.Read(data.data(), (uint32_t)data.size()) == data.size();
+		file.Close();
+
+		if (!read || !reader.Read(data.data(), data.size(), settings_cfg))
+		{
+			logging::Warning("Failed to load builder settings '%s': %s", _params.settings_path.c_str(), reader.GetErrorMessage().c_str());
+			return false;
+		}
+		return true;
+	}
+	bool BuildServer::IsInitialized() const
+	{
+		return _compiler_system != NULL;
+	}
+
 	const map<string, BuildSettings*>& BuildServer::GetSettingProfiles() const
 	{
 		return _setting_profiles;
@@ -23,6 +23,7 @@ namespace sb
 		string base_path;
 		string source_path;
 		string target_path;
+		string settings_path;	///< Builder settings file, "builder.settings" in the source directory if empty
 
 		string relay_host;
 		bool server;			///< Specifies if the builder should run in server mode
@@ -32,6 +33,7 @@ namespace sb
 
 	class StringIdRepository;
 	class DirectoryWatcher;
+	class BuildCache;
 	class ConsoleServer;
 	class BuildServer : public Runnable
 	{
@@ -59,6 +61,9 @@ namespace sb
 
 		bool IsStopping() const;
 
+		/// @return False if the builder failed to start, e.g. if the settings couldn't be loaded
+		bool IsInitialized() const;
+
 		/// Rebuilds the whole source directroy
 		/// @remark Do not call if not running in build server thread.
 		void FullRebuild();
@@ -77,12 +82,23 @@ namespace sb
 
 		void RegisterCompilers(const ConfigValue& compilers);
 
+		bool LoadSettings(ConfigValue& settings_cfg);
+
 		FileSource* _source;
 		FileSource* _target;
 		FileSystem _file_system;
 
 		DirectoryWatcher* _dir_watcher;
 
+		enum
+		{
+			IDLE_TIMEOUT = 50, ///< Longest time (ms) the server sleeps waiting for changes
+			DEFAULT_CHANGE_DEBOUNCE = 100, ///< Default time (ms) a changed file needs to be left alone before it's compiled
+			DEFAULT_SHADER_CACHE_SIZE = 512 ///< Default size limit (MB) of the shader cache
+		};
+		double _change_debounce; ///< Seconds
+		uint64_t _shader_cache_size; ///< Bytes, the least recently used programs are removed above this
+
 		BuilderParams _params;
 		BuildUICallback* _callback;
 
@@ -94,6 +110,12 @@ namespace sb
 		CompilerSystem* _compiler_system;
 		vector<CompilerSystem::Compiler*> _compilers;
 
+		FileSource* _build_cache_source;
+		BuildCache* _build_cache; ///< NULL if no cache is used
+
+		FileSource* _shader_cache_source;
+		BuildCache* _shader_cache; ///< Compiled shader programs, kept in .builder/shader_cache
+
 		DependencyDatabase*	_dependency_database;
 		ShaderDatabase*	_shader_database;
 		StringIdRepository* _string_id_repository;
@@ -20,7 +20,7 @@ namespace sb
 		/// Called before dispatching a batch of sources to the compiler
 		virtual void OnCompileBatch(AssetSource* sources, uint32_t num) = 0;
 
-		/// Called before compiler starts compile
+		/// Called for every compiled asset, right before its result is reported
 		virtual void OnCompile(const FilePath& source, const FilePath& target) = 0;
 
 		/// Called when a asset is skipped in the compilation process
@@ -32,6 +32,9 @@ namespace sb
 		/// Called when a resource compiled
 		virtual void OnCompileFailed(const FilePath& source, const FilePath& target, const string& error) = 0;
 
+		/// Called after the result of a compiled asset has been reported, with timings and sizes
+		virtual void OnCompileStats(const AssetSource&, const CompilerSystem::JobStats&) {}
+
 
 	};
 
@@ -4,7 +4,8 @@
 
 #include "Collada.h"
 
-#include <Foundation/tinyxml2/tinyxml2.h>
+#include <Foundation/Container/StringUtil.h>
+#include <Foundation/Xml/XmlSaxParser.h>
 
 namespace sb
 {
@@ -29,8 +30,367 @@ namespace sb
 				return geometry::Stream::Channel::UNKNOWN;
 
 		}
+
+		bool IsDigit(char c)
+		{
+			return uint32_t(c - '0') < 10;
+		}
+
+		bool IsWhitespace(char c)
+		{
+			return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+		}
+
+		const char* SkipWhitespace(const char* p, const char* end)
+		{
+			while (p < end && IsWhitespace(*p))
+				++p;
+			return p;
+		}
+
+		/// @return Position after the number, NULL if there was no valid number at p
+		const char* ParseUInt(const char* p, const char* end, uint32_t& value)
+		{
+			if (p == end || !IsDigit(*p))
+				return NULL;
+
+			value = 0;
+			for (; p < end && IsDigit(*p); ++p)
+				value = value * 10 + (*p - '0');
+			return p;
+		}
+	};
+
+	/// Builds the collada file from the parsed elements as they are streamed
+	///	Elements are identified by their parent so that only the ones needed for meshes are looked at,
+	///	everything else (including anything within an unknown element) is skipped.
+	class collada::ColladaFile::Parser : public XmlSaxParser::Handler
+	{
+	public:
+		Parser(ColladaFile* file) : _file(file), _has_float_array(false), _expected(0), _parsed(0) {}
+
+		bool StartElement(const XmlSaxParser::StringRange& name, const XmlSaxParser::Attributes& attributes);
+		bool EndElement(const XmlSaxParser::StringRange& name);
+		bool Text(const char* begin, const char* end);
+
+	private:
+		enum Element
+		{
+			UNKNOWN,
+			COLLADA,
+			ASSET,
+			UP_AXIS,
+			LIBRARY_MATERIALS,
+			MATERIAL,
+			LIBRARY_GEOMETRIES,
+			GEOMETRY,
+			MESH,
+			SOURCE,
+			FLOAT_ARRAY,
+			TECHNIQUE_COMMON,
+			ACCESSOR,
+			VERTICES,
+			TRIANGLES,
+			POLYLIST,
+			INPUT,
+			VCOUNT,
+			P
+		};
+
+		Element Identify(const XmlSaxParser::StringRange& name) const;
+		void ParseInput(const XmlSaxParser::Attributes& attributes, vector<InputChannel>& inputs);
+
+		ColladaFile* _file;
+		vector<Element> _stack;
+
+		string _up_axis;
+
+		Source _source;
+		bool _has_float_array;
+
+		TriangleSet _triangle_set;
+
+		// Values expected and parsed so far for the current <float_array>, <vcount> or <p>
+		uint32_t _expected;
+		uint32_t _parsed;
 	};
 
+	collada::ColladaFile::Parser::Element collada::ColladaFile::Parser::Identify(const XmlSaxParser::StringRange& name) const
+	{
+		struct ElementDesc
+		{
+			Element parent;
+			const char* name;
+			Element element;
+		};
+
+		static const ElementDesc elements[] = {
+			{ COLLADA, "asset", ASSET },
+			{ ASSET, "up_axis", UP_AXIS },
+			{ COLLADA, "library_materials", LIBRARY_MATERIALS },
+			{ LIBRARY_MATERIALS, "material", MATERIAL },
+			{ COLLADA, "library_geometries", LIBRARY_GEOMETRIES },
+			{ LIBRARY_GEOMETRIES, "geometry", GEOMETRY },
+			{ GEOMETRY, "mesh", MESH },
+			{ MESH, "source", SOURCE },
+			{ SOURCE, "float_array", FLOAT_ARRAY },
+			{ SOURCE, "technique_common", TECHNIQUE_COMMON },
+			{ TECHNIQUE_COMMON, "accessor", ACCESSOR },
+			{ MESH, "vertices", VERTICES },
+			{ MESH, "triangles", TRIANGLES },
+			{ MESH, "polylist", POLYLIST },
+			{ VERTICES, "input", INPUT },
+			{ TRIANGLES, "input", INPUT },
+			{ POLYLIST, "input", INPUT },
+			{ POLYLIST, "vcount", VCOUNT },
+			{ TRIANGLES, "p", P },
+			{ POLYLIST, "p", P },
+		};
+
+		Element parent = _stack.back();
+		if (parent == UNKNOWN)
+			return UNKNOWN;
+
+		for (uint32_t i = 0; i < sizeof(elements) / sizeof(elements[0]); ++i)
+		{
+			if (elements[i].parent == parent && name.Equals(elements[i].name))
+				return elements[i].element;
+		}
+		return UNKNOWN;
+	}
+
+	void collada::ColladaFile::Parser::ParseInput(const XmlSaxParser::Attributes& attributes, vector<InputChannel>& inputs)
+	{
+		InputChannel input;
+		input.offset = attributes.GetUInt("offset", 0);
+		input.set = attributes.GetUInt("set", 0);
+		input.semantic = attributes.GetString("semantic");
+		input.source = attributes.GetString("source");
+		if (!input.source.empty() && input.source[0] == '#') // Remove any leading number sign (For ids in collada files)
+			input.source.erase(0, 1);
+
+		inputs.push_back(input);
+	}
+
+	bool collada::ColladaFile::Parser::StartElement(const XmlSaxParser::StringRange& name, const XmlSaxParser::Attributes& attributes)
+	{
+		if (_stack.empty())
+		{
+			if (!name.Equals("COLLADA"))
+			{
+				logging::Warning("ColladaFile: Root element is not <COLLADA>");
+				return false;
+			}
+			_stack.push_back(COLLADA);
+			return true;
+		}
+
+		Element element = Identify(name);
+		switch (element)
+		{
+		case UP_AXIS:
+			_up_axis.clear();
+			break;
+		case MATERIAL:
+			{
+				string material_id = attributes.GetString("id");
+				string material_name = attributes.GetString("name");
+				if (!material_id.empty() && !material_name.empty())
+					_file->_materials[material_id.c_str()] = material_name;
+			}
+			break;
+		case GEOMETRY:
+			_file->_geometry.push_back(Geometry());
+			break;
+		case SOURCE:
+			_source = Source();
+			_source.id = attributes.GetString("id");
+			_has_float_array = false;
+			break;
+		case FLOAT_ARRAY:
+			_expected = attributes.GetUInt("count", 0);
+			_parsed = 0;
+			_source.data.resize(_expected * sizeof(float));
+			_has_float_array = true;
+			break;
+		case ACCESSOR:
+			_source.stride = attributes.GetUInt("stride", 1);
+			break;
+		case VERTICES:
+			_file->_geometry.back().vertices.id = attributes.GetString("id");
+			break;
+		case TRIANGLES:
+		case POLYLIST:
+			// We support both triangles and polylist, assuming that the polylist is triangulated
+			_triangle_set = TriangleSet();
+			_triangle_set.count = attributes.GetUInt("count", 0);
+			_triangle_set.material_id = attributes.GetString("material");
+			break;
+		case INPUT:
+			if (_stack.back() == VERTICES)
+				ParseInput(attributes, _file->_geometry.back().vertices.inputs);
+			else
+				ParseInput(attributes, _triangle_set.inputs);
+			break;
+		case VCOUNT:
+			_expected = _triangle_set.count;
+			_parsed = 0;
+			break;
+		case P:
+			// Index count for collada: Number of triangles * 3 * number of input streams
+			_expected = _triangle_set.count * (uint32_t)_triangle_set.inputs.size() * 3;
+			_parsed = 0;
+			_triangle_set.indices.resize(_expected);
+			break;
+		default:
+			break;
+		};
+
+		_stack.push_back(element);
+		return true;
+	}
+
+	bool collada::ColladaFile::Parser::EndElement(const XmlSaxParser::StringRange& )
+	{
+		Element element = _stack.back();
+		_stack.pop_back();
+
+		switch (element)
+		{
+		case UP_AXIS:
+			{
+				size_t begin = _up_axis.find_first_not_of(" \t\r\n");
+				size_t end = _up_axis.find_last_not_of(" \t\r\n");
+				string up_axis = (begin != string::npos) ? _up_axis.substr(begin, end - begin + 1) : "";
+				if (up_axis != "Z_UP")
+				{
+					logging::Warning("ColladaFile: Up-axis setting for collada file: %s, engine uses Z-axis as Up-axis.", up_axis.c_str());
+				}
+			}
+			break;
+		case FLOAT_ARRAY:
+			if (_parsed < _expected)
+			{
+				logging::Warning("Expected more values in float_array");
+				return false;
+			}
+			break;
+		case SOURCE:
+			{
+				if (!_has_float_array)
+				{
+					logging::Warning("Expected float_array.");
+					return false;
+				}
+
+				// Swapped rather than copied, the float array may be huge
+				vector<Source>& sources = _file->_geometry.back().sources;
+				sources.push_back(Source());
+				sources.back().id.swap(_source.id);
+				sources.back().data.swap(_source.data);
+				sources.back().stride = _source.stride;
+			}
+			break;
+		case VCOUNT:
+			if (_parsed < _expected)
+			{
+				logging::Warning("Expected more values in <vcount>");
+				return false;
+			}
+			break;
+		case P:
+			if (_parsed < _expected)
+			{
+				logging::Warning("Expected more values in <p>");
+				return false;
+			}
+			break;
+		case TRIANGLES:
+		case POLYLIST:
+			{
+				vector<TriangleSet>& triangle_sets = _file->_geometry.back().triangle_sets;
+				triangle_sets.push_back(TriangleSet());
+				TriangleSet& triangle_set = triangle_sets.back();
+				triangle_set.count = _triangle_set.count;
+				triangle_set.material_id.swap(_triangle_set.material_id);
+				triangle_set.indices.swap(_triangle_set.indices);
+				triangle_set.inputs.swap(_triangle_set.inputs);
+			}
+			break;
+		default:
+			break;
+		};
+		return true;
+	}
+
+	bool collada::ColladaFile::Parser::Text(const char* begin, const char* end)
+	{
+		const char* p = SkipWhitespace(begin, end);
+
+		switch (_stack.back())
+		{
+		case UP_AXIS:
+			_up_axis.append(begin, end);
+			break;
+		case FLOAT_ARRAY:
+			{
+				float* values = (float*)_source.data.data();
+				while (p < end && _parsed < _expected)
+				{
+					p = string_util::ParseFloat(p, end, values[_parsed]);
+					if (!p || (p < end && !IsWhitespace(*p)))
+					{
+						logging::Warning("ColladaFile: Invalid value in float_array");
+						return false;
+					}
+					++_parsed;
+					p = SkipWhitespace(p, end);
+				}
+			}
+			break;
+		case VCOUNT:
+			while (p < end && _parsed < _expected)
+			{
+				uint32_t count;
+				p = ParseUInt(p, end, count);
+				if (!p || (p < end && !IsWhitespace(*p)))
+				{
+					logging::Warning("ColladaFile: Invalid value in <vcount>");
+					return false;
+				}
+				if (count != 3)
+				{
+					logging::Warning("Expected triangles in polylist, vcount = %d, should be 3", count);
+					return false;
+				}
+				++_parsed;
+				p = SkipWhitespace(p, end);
+			}
+			break;
+		case P:
+			{
+				uint32_t* indices = _triangle_set.indices.data();
+				while (p < end && _parsed < _expected)
+				{
+					p = ParseUInt(p, end, indices[_parsed]);
+					if (!p || (p < end && !IsWhitespace(*p)))
+					{
+						logging::Warning("ColladaFile: Invalid value in <p>");
+						return false;
+					}
+					++_parsed;
+					p = SkipWhitespace(p, end);
+				}
+			}
+			break;
+		default:
+			break;
+		};
+		return true;
+	}
+
+	//-------------------------------------------------------------------------------
+
 
 	collada::ColladaFile::ColladaFile()
 	{
@@ -68,8 +428,7 @@ namespace sb
 			geometry::Stream& stream = mesh.streams.back();
 
 			stream.stride = source.stride * sizeof(float); // source.stride is number of floats per vertex, convert to bytes
-			stream.data.resize(source.data.size() * sizeof(float));
-			memory::Memcpy(stream.data.data(), source.data.data(), stream.data.size());
+			stream.data.swap(source.data);
 
 			// One index stream for each vertex stream
 			mesh.index_streams.push_back(geometry::IndexStream());
@@ -147,6 +506,8 @@ namespace sb
 
 			mesh.sub_meshes.push_back(sub_mesh);
 
+			vector<uint32_t>().swap(triangles.indices); // Not needed anymore
+
 			mesh.index_count += sub_mesh.index_count; // Always 3 indices per triangle
 		}
 
@@ -154,51 +515,14 @@ namespace sb
 
 	bool collada::ColladaFile::Parse(const char* data, uint32_t len)
 	{
-		tinyxml2::XMLDocument doc;
-		tinyxml2::XMLError error = doc.Parse(data, len);
-		if (error != tinyxml2::XML_NO_ERROR)
-		{
-			logging::Warning("ColladaFile: XMLError (error = %d) str1 = %s str2 = %s", error, doc.GetErrorStr1(), doc.GetErrorStr2());
-			return false;
-		}
-
-		tinyxml2::XMLElement* root = doc.RootElement();
-		Assert(strcmp(root->Name(), "COLLADA") == 0);
-
-		tinyxml2::XMLElement* asset = root->FirstChildElement("asset");
-		if (asset)
-		{
-			tinyxml2::XMLElement* up_axis = asset->FirstChildElement("up_axis");
-			if (up_axis)
-			{
-				if (strcmp(up_axis->GetText(), "Z_UP") != 0)
-				{
-					logging::Warning("ColladaFile: Up-axis setting for collada file: %s, engine uses Z-axis as Up-axis.", up_axis->GetText());
-				}
-			}
-		}
+		Parser parser(this);
 
-		// Parse material library
-		tinyxml2::XMLElement* material_library = root->FirstChildElement("library_materials");
-		tinyxml2::XMLElement* material_elem = material_library->FirstChildElement("material");
-		while (material_elem)
+		XmlSaxParser xml_parser;
+		if (!xml_parser.Parse(data, len, &parser))
 		{
-			const char* material_id = material_elem->Attribute("id");
-			const char* material_name = material_elem->Attribute("name");
-			if (!material_id || !material_name)
-				continue;
-
-			_materials[material_id] = material_name;
-
-			material_elem = material_elem->NextSiblingElement("material");
-		}
-
-
-
-
-		tinyxml2::XMLElement* geometry_library = root->FirstChildElement("library_geometries");
-		if (!ParseGeometryLibrary(geometry_library))
+			logging::Warning("ColladaFile: Failed to parse XML at line %d: %s", xml_parser.GetErrorLine(), xml_parser.GetError());
 			return false;
+		}
 
 		if (_geometry.size() > 1)
 		{
@@ -208,208 +532,4 @@ namespace sb
 		return true;
 	}
 
-
-	bool collada::ColladaFile::ParseGeometryLibrary(tinyxml2::XMLElement* element)
-	{
-		tinyxml2::XMLElement* geometry = element->FirstChildElement("geometry");
-		while (geometry)
-		{
-			if (!ParseGeometry(geometry))
-				return false;
-			geometry = geometry->NextSiblingElement("geometry");
-		}
-
-		return true;
-	}
-	bool collada::ColladaFile::ParseGeometry(tinyxml2::XMLElement* element)
-	{
-		Geometry geometry;
-
-		tinyxml2::XMLElement* mesh = element->FirstChildElement("mesh");
-		if (mesh)
-		{
-			// Parse sources
-			tinyxml2::XMLElement* source_elem = mesh->FirstChildElement("source");
-			while (source_elem)
-			{
-				Source source;
-				source.id = source_elem->Attribute("id");
-
-				tinyxml2::XMLElement* data_elem = source_elem->FirstChildElement("float_array");
-				if (!data_elem)
-				{
-					logging::Warning("Expected float_array.");
-					return false;
-				}
-
-				uint32_t count = (uint32_t)atoi(data_elem->Attribute("count"));
-				const char* data = data_elem->GetText();
-				for (uint32_t i = 0; i < count; ++i)
-				{
-					if (*data == 0)
-					{
-						logging::Warning("Expected more values in float_array");
-						return false;
-					}
-
-					float v = (float)atof(data);
-					source.data.push_back(v);
-
-					while (*data != ' ' && *data != '\0') ++data;
-					if (*data != '\0')
-						++data;
-				}
-
-				tinyxml2::XMLElement* accessor_elem = source_elem->FirstChildElement("technique_common")->FirstChildElement("accessor");
-				if (accessor_elem)
-				{
-					source.stride = atoi(accessor_elem->Attribute("stride"));
-				}
-
-				geometry.sources.push_back(source);
-
-				source_elem = source_elem->NextSiblingElement("source");
-			}
-
-			// Parse vertices
-			tinyxml2::XMLElement* vert_elem = mesh->FirstChildElement("vertices");
-			if (vert_elem)
-			{
-				geometry.vertices.id = vert_elem->Attribute("id");
-				ParseInputs(vert_elem, geometry.vertices.inputs);
-			}
-
-
-			// Parse triangles
-			// We support both triangles and polylist, assuming that the polylist is triangulated
-
-
-			tinyxml2::XMLElement* triangles_elem = mesh->FirstChildElement("triangles");
-			while (triangles_elem)
-			{
-				TriangleSet triangle_set;
-
-				triangle_set.count = atoi(triangles_elem->Attribute("count"));
-				// Lookup material name from the id
-				triangle_set.material_id = triangles_elem->Attribute("material");
-
-				ParseInputs(triangles_elem, triangle_set.inputs);
-
-				// Index count for collada: Number of triangles * 3 * number of input streams
-				uint32_t index_count = triangle_set.count * (uint32_t)triangle_set.inputs.size() * 3; 
-				tinyxml2::XMLElement* indices_elem = triangles_elem->FirstChildElement("p");
-
-				const char* indices_data = indices_elem->GetText();
-				for (uint32_t i = 0; i < index_count; ++i)
-				{
-					if (*indices_data == 0)
-					{
-						logging::Warning("Expected more values in <p>");
-						return false;
-					}
-
-					uint32_t index = atoi(indices_data);
-					triangle_set.indices.push_back(index);
-
-					while (*indices_data != ' ' && *indices_data != '\0') ++indices_data;
-					if (*indices_data != '\0')
-						++indices_data;
-				}
-				geometry.triangle_sets.push_back(triangle_set);
-
-				triangles_elem = triangles_elem->NextSiblingElement("triangles");
-			}
-
-			tinyxml2::XMLElement* polylist_elem = mesh->FirstChildElement("polylist");
-			while (polylist_elem)
-			{
-				TriangleSet triangle_set;
-
-				triangle_set.count = atoi(polylist_elem->Attribute("count"));
-				triangle_set.material_id = polylist_elem->Attribute("material");
-
-				ParseInputs(polylist_elem, triangle_set.inputs);
-
-				tinyxml2::XMLElement* vcount = polylist_elem->FirstChildElement("vcount");
-				const char* vcount_data = vcount->GetText();
-				for (uint32_t i = 0; i < triangle_set.count; ++i)
-				{
-					if (*vcount_data == 0)
-					{
-						logging::Warning("Expected more values in <vcount>");
-						return false;
-					}
-					uint32_t count = atoi(vcount_data);
-					if (count != 3)
-					{
-						logging::Warning("Expected triangles in polylist, vcount = %d, should be 3", count);
-						return false;
-					}
-
-					while (*vcount_data != ' ' && *vcount_data != '\0') ++vcount_data;
-					if (*vcount_data != '\0')
-						++vcount_data;
-				}
-
-				// Index count for collada: Number of triangles * 3 * number of input streams
-				uint32_t index_count = triangle_set.count * (uint32_t)triangle_set.inputs.size() * 3; 
-				tinyxml2::XMLElement* indices_elem = polylist_elem->FirstChildElement("p");
-
-				const char* indices_data = indices_elem->GetText();
-				for (uint32_t i = 0; i < index_count; ++i)
-				{
-					if (*indices_data == 0)
-					{
-						logging::Warning("Expected more values in <p>");
-						return false;
-					}
-
-					uint32_t index = atoi(indices_data);
-					triangle_set.indices.push_back(index);
-
-					while (*indices_data != ' ' && *indices_data != '\0') ++indices_data;
-					if (*indices_data != '\0')
-						++indices_data;
-				}
-				geometry.triangle_sets.push_back(triangle_set);
-
-				polylist_elem = polylist_elem->NextSiblingElement("polylist");
-			}
-
-
-		}
-
-		_geometry.push_back(geometry);
-
-		return true;
-	}
-	bool collada::ColladaFile::ParseInputs(tinyxml2::XMLElement* triangles_elem, vector<InputChannel>& inputs)
-	{
-		tinyxml2::XMLElement* input_elem = triangles_elem->FirstChildElement("input");
-		while (input_elem)
-		{
-			InputChannel input;
-
-			if (input_elem->Attribute("offset") != '\0')
-				input.offset = atoi(input_elem->Attribute("offset"));
-			else
-				input.offset = 0;
-
-			if (input_elem->Attribute("set") != '\0')
-				input.set = atoi(input_elem->Attribute("set"));
-			else
-				input.set = 0;
-
-			input.semantic = input_elem->Attribute("semantic");
-			input.source = input_elem->Attribute("source");
-			if (input.source[0] == '#') // Remove any leading number sign (For ids in collada files)
-				input.source.erase(0, 1);
-
-			inputs.push_back(input);
-
-			input_elem = input_elem->NextSiblingElement("input");
-		}
-		return true;
-	}
-
 } // namespace sb
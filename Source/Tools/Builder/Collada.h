@@ -5,11 +5,6 @@
 
 #include "Geometry.h"
 
-namespace tinyxml2
-{
-	class XMLElement;
-};
-
 namespace sb
 {
 
@@ -20,7 +15,7 @@ namespace sb
 			Source() : stride(0) {}
 
 			string id;
-			vector<float> data;
+			vector<uint8_t> data; // Floats, parsed straight into the layout of geometry::Stream::data
 			uint32_t stride; // Number of floats per vertex
 		};
 
@@ -73,10 +68,12 @@ namespace sb
 			~ColladaFile();
 
 			/// @brief Parses a collada document
+			///	The document is streamed through a SAX parser, only the elements needed for meshes are kept.
 			/// @return True if parsing was successful, false if failed
 			bool Parse(const char* data, uint32_t len);
 
 			/// Converts the collada file into a mesh object
+			///	The vertex data is moved into the mesh rather than copied, so this can only be done once.
 			/// @param mesh Target object
 			void Convert(geometry::Mesh& mesh);
 
@@ -84,11 +81,8 @@ namespace sb
 		private:
 			const ColladaFile& operator=(const ColladaFile&) { return *this; }
 
-
-			bool ParseGeometryLibrary(tinyxml2::XMLElement* element);
-			bool ParseGeometry(tinyxml2::XMLElement* element);
-
-			bool ParseInputs(tinyxml2::XMLElement* triangles_elem, vector<InputChannel>& inputs);
+			class Parser;
+			friend class Parser;
 
 			vector<Geometry> _geometry;
 
@@ -5,8 +5,10 @@
 
 #include <Foundation/Common.h>
 
+#ifdef SANDBOX_PLATFORM_WIN
 #pragma comment(linker,"/manifestdependency:\"type='win32' name='Microsoft.Windows.Common-Controls' \
 	version='6.0.0.0' processorArchitecture='*' publicKeyToken='6595b64144ccf1df' language='*'\"")
+#endif
 
 #endif // __BUILDER_PCH_H__
 
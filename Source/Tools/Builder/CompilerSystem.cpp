@@ -7,14 +7,38 @@
 #include "DependencyDatabase.h"
 #include "ShaderDatabase.h"
 #include "BuildUICallback.h"
+#include "BuildCache.h"
+#include "JobPool.h"
 
-#include <Foundation/Thread/TaskScheduler.h>
+#include <Foundation/Hash/murmur_hash.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Json/Json.h>
+#include <Foundation/Platform/System.h>
+#include <Foundation/Timer/Timer.h>
+
+#include <algorithm>
 
 namespace sb
 {
 
+	namespace
+	{
+		/// Error message for the asset currently being compiled on this thread
+		__thread string* t_compile_error = nullptr;
+
+		/// @return Size of the file in bytes, 0 if it couldn't be opened
+		uint64_t FileLength(FileSource* file_source, const char* path)
+		{
+			FileStreamPtr file = file_source->OpenFile(path, File::READ);
+			if (!file.Get() || file->Length() < 0)
+				return 0;
+			return (uint64_t)file->Length();
+		}
+	}
+
 	//-------------------------------------------------------------------------------
 	CompilerSystem::Compiler::Compiler(const ConfigValue& config)
+		: _max_jobs(0)
 	{
 		Assert(config["type"].IsString());
 		Assert(config["source_type"].IsString());
@@ -22,11 +46,40 @@ namespace sb
 		_type = config["type"].AsString();
 		_source_type = config["source_type"].AsString();
 
+		if (config["max_jobs"].IsNumber())
+			_max_jobs = config["max_jobs"].AsUInt();
+
+		vector<uint8_t> data;
+		{
+			DynamicMemoryStream stream(&data);
+			json::Writer writer(stream, false);
+			writer.Write(config);
+		}
+		_config_hash = murmur_hash_64(data.data(), (uint32_t)data.size(), 0);
 	}
 
 	void CompilerSystem::Compiler::SetError(const char* msg)
 	{
-		_last_error = msg;
+		Assert(t_compile_error);
+		if (t_compile_error)
+			*t_compile_error = msg;
+	}
+	bool CompilerSystem::Compiler::ReadAsset(FileSource* asset_source, const FilePath& path, vector<uint8_t>& data)
+	{
+		FileStreamPtr file = asset_source->OpenFile(path.c_str(), File::READ);
+		if (!file.Get() || file->Length() < 0)
+		{
+			SetError("Could not open file.");
+			return false;
+		}
+
+		data.resize((size_t)file->Length());
+		if (!data.empty() && file->Read(data.data(), data.size()) != data.size())
+		{
+			SetError("Failed to read file.");
+			return false;
+		}
+		return true;
 	}
 	bool CompilerSystem::Compiler::WriteAsset(FileSource* asset_target, const FilePath& path, const uint8_t* data, uint32_t len)
 	{
@@ -43,188 +96,247 @@ namespace sb
 		file->Write(data, len);
 		return true;
 	}
-	bool CompilerSystem::Compiler::NeedCompile(const FilePath& source_file, const FilePath& target_file, const CompilerContext& context)
+	uint32_t CompilerSystem::Compiler::GetVersion() const
 	{
-		FileTime source_time, target_time;
-
-		if (!context.asset_source->LastModifiedTime(source_file.c_str(), source_time))
-		{
-			// Source file not found?
-			logging::Warning("Failed to retrieve last modified time for source file '%s'", source_file.c_str());
-			return false;
-		}
-
-		if (!context.asset_target->LastModifiedTime(target_file.c_str(), target_time)
-			|| (target_time < source_time))
-		{
-			return true;
-		}
-		return false;
+		return 1;
+	}
+	uint64_t CompilerSystem::Compiler::HashInputs(const FilePath&, const CompilerContext&, uint64_t hash)
+	{
+		return hash;
+	}
+	bool CompilerSystem::Compiler::IsCacheable() const
+	{
+		return true;
+	}
+	bool CompilerSystem::Compiler::OnSkipCompile(const FilePath&, const CompilerContext&)
+	{
+		return true;
 	}
 
 	const string& CompilerSystem::Compiler::GetType() const
 	{
 		return _type;
 	}
-	const string& CompilerSystem::Compiler::GetSourceType() const
+	const InternedString& CompilerSystem::Compiler::GetSourceType() const
 	{
 		return _source_type;
 	}
-	const string& CompilerSystem::Compiler::GetLastError() const
+	uint32_t CompilerSystem::Compiler::GetMaxJobs() const
+	{
+		return _max_jobs;
+	}
+	uint64_t CompilerSystem::Compiler::GetConfigHash() const
 	{
-		return _last_error;
+		return _config_hash;
 	}
 
 	//-------------------------------------------------------------------------------
 
+	/// Thread compiling one job at a time as handed out by the CompilerSystem
+	class CompilerSystem::Worker : public Runnable
+	{
+	public:
+		Worker(CompilerSystem* owner, uint32_t index)
+			: _owner(owner),
+			_index(index),
+			_job(Invalid<uint32_t>()),
+			_stop(false)
+		{
+			_thread.Start(this);
+		}
+		~Worker()
+		{
+			_stop = true;
+			_start_event.Set();
+			_thread.Join();
+		}
+
+		/// Starts compiling the specified job
+		void Start(uint32_t job)
+		{
+			_job = job;
+			_start_event.Set();
+		}
+
+		// Runnable
+		void Run()
+		{
+			while (true)
+			{
+				_start_event.Wait();
+				if (_stop)
+					break;
+
+				Job& job = _owner->_jobs[_job];
+				job.stats.worker = _index;
+				job.stats.start = timer::Seconds();
+
+				_owner->RunJob(job);
+
+				job.stats.duration = timer::Seconds() - job.stats.start;
+				_owner->OnJobDone(this, _job);
+			}
+		}
+
+	private:
+		CompilerSystem* _owner;
+		uint32_t _index;
+		uint32_t _job;
+		volatile bool _stop;
+
+		Event _start_event;
+		SimpleThread _thread;
+	};
+
+	//-------------------------------------------------------------------------------
+
 	CompilerSystem::CompilerSystem(BuildServer* builder, FileSource* asset_source, FileSource* asset_target,
-		DependencyDatabase* dependency_db, ShaderDatabase* shader_db, BuildSettings* settings)
+		DependencyDatabase* dependency_db, ShaderDatabase* shader_db, BuildSettings* settings, uint32_t worker_count)
 		: _builder(builder),
 		_asset_source(asset_source),
 		_asset_target(asset_target),
-		_shader_database(shader_db),
 		_dependency_database(dependency_db),
-		_active_settings(settings)
+		_shader_database(shader_db),
+		_active_settings(settings),
+		_settings_hash(build_settings::Hash(*settings)),
+		_build_cache(NULL),
+		_job_pool(NULL),
+		_num_finished(0)
 	{
+		if (worker_count == 0)
+		{
+			system::SystemInfo system_info;
+			system::GetSystemInfo(system_info);
+			worker_count = Max(system_info.num_processors, 1u);
+		}
+
+		// Workers waiting on the pool help with their own jobs, so one thread less than the number of workers
+		//	keeps a single large asset from running on more threads than there are workers.
+		_job_pool = new JobPool(worker_count - 1);
+
+		for (uint32_t i = 0; i < worker_count; ++i)
+		{
+			Worker* worker = new Worker(this, i);
+			_workers.push_back(worker);
+			_idle_workers.push_back(worker);
+		}
 	}
 	CompilerSystem::~CompilerSystem()
 	{
+		for (Worker* worker : _workers)
+		{
+			delete worker;
+		}
+		_workers.clear();
+		_idle_workers.clear();
 
+		delete _job_pool;
+		_job_pool = NULL;
 	}
 	void CompilerSystem::Compile(AssetSource* sources, uint32_t num, bool force, BuildUICallback* callback)
 	{
 		Assert(sources);
 		Assert(_builder);
 
-		CompilerContext context(_asset_source, _asset_target, _dependency_database,
-			_shader_database, _active_settings);
-
-		FilePath target_path;
-		vector<string> dependents;
-
-
 		if (num > 1 && callback)
 		{
 			callback->OnCompileBatch(sources, num);
 		}
 
+		// Build the dependency graph, starting with the given sources and then adding anything that depends on them.
 		for (uint32_t i = 0; i < num; ++i)
 		{
-			if (_builder->IsStopping())
-				break;
-			if (sources[i].source_type == "") // Skip sources without types (Files without extensions)
-				continue;
-
-			// Skip ignored assets
-			if (std::find(_ignores.begin(), _ignores.end(), sources[i].source_path.c_str()) != _ignores.end())
-				continue;
-
-			Compiler* compiler;
+			AddJob(sources[i], true, force);
+		}
 
-			map<StringId32, Compiler*>::iterator it = _compilers.find(sources[i].source_type);
-			if (it == _compilers.end())
+		vector<string> dependents;
+		for (uint32_t i = 0; i < _jobs.size(); ++i)
+		{
+			_dependency_database->GetDependents(_jobs[i].source.source_path.c_str(), dependents);
+			for (vector<string>::iterator it = dependents.begin(); it != dependents.end(); ++it)
 			{
-				// File is an external resource, check with dependency database if it has any last modified time
-				//	to check if it has changed since last time.
-				FileTime old_file_time;
-				FileTime new_file_time;
-
-				bool need_compile = true;
-				if (context.asset_source->LastModifiedTime(sources[i].source_path.c_str(), new_file_time)
-					&& _dependency_database->GetModifiedTime(sources[i].source_path.c_str(), old_file_time))
-				{
-					if (new_file_time <= old_file_time)
-						need_compile = false;
-				}
+				uint32_t dependent = AddJob(AssetSource(it->c_str()), false, false);
+				if (IsInvalid(dependent) || dependent == i)
+					continue;
 
-				if (need_compile)
-				{
-					// Files without compilers may still have dependents so check them now
+				_jobs[i].dependents.push_back(dependent);
+				++_jobs[dependent].pending;
+			}
+			dependents.clear();
+		}
 
-					_dependency_database->GetDependents(sources[i].source_path.c_str(), dependents);
-					if (dependents.size() > 0)
-					{
-						logging::Info("Compiling %d dependencies for %s", dependents.size(), sources[i].source_path.c_str());
-					}
-					for (vector<string>::iterator it = dependents.begin(); it != dependents.end(); ++it)
-					{
-						AssetSource dependent_source(it->c_str());
-						Compile(&dependent_source, 1, true);
-					}
-					if (dependents.size())
-					{
-						// Only update time for resources with dependencies
-						_dependency_database->UpdateModifiedTime(sources[i].source_path.c_str(), new_file_time);
-					}
+		// Start with the jobs not depending on anything
+		_num_finished = 0;
 
-					dependents.clear();
-				}
+		vector<uint32_t> roots;
+		for (uint32_t i = 0; i < _jobs.size(); ++i)
+		{
+			if (_jobs[i].pending == 0)
+				roots.push_back(i);
+		}
+		for (uint32_t i = 0; i < roots.size(); ++i)
+		{
+			ResolveJob(roots[i]);
+		}
 
+		vector<pair<Worker*, uint32_t>> done;
+		uint32_t next_report = 0;
+		while (true)
+		{
+			if (!_builder->IsStopping())
+				DispatchJobs();
 
-				if (callback)
-				{
-					callback->OnCompileSkip(sources[i].source_path, target_path);
-				}
-				continue;
+			// Results are reported in job order to keep the output the same from build to build
+			while (next_report < _jobs.size() && _jobs[next_report].finished)
+			{
+				ReportJob(_jobs[next_report++], callback);
 			}
-			compiler = it->second;
-			Assert(compiler);
 
-			target_path += sources[i].source_path.c_str();
-			target_path.TrimExtension();
-			target_path += ".";
-			target_path += compiler->GetType();
+			if (_num_finished == _jobs.size())
+				break;
 
-			if (force || compiler->NeedCompile(sources[i].source_path, target_path, context))
+			if (_idle_workers.size() == _workers.size())
 			{
-				// Needs recompile
-				if (callback)
-				{
-					callback->OnCompile(sources[i].source_path, target_path);
-				}
+				// Nothing is running
+				if (_builder->IsStopping())
+					break;
 
-				Result res = compiler->Compile(sources[i].source_path, target_path, context);
-				if (res == FAILED)
+				if (_ready.empty())
 				{
-					logging::Warning("Failed to compile '%s': %s", sources[i].source_path.c_str(), compiler->GetLastError().c_str());
-					if (callback)
+					// Remaining jobs are all waiting on each other, break the cycle by starting the first one
+					for (uint32_t i = 0; i < _jobs.size(); ++i)
 					{
-						callback->OnCompileFailed(sources[i].source_path, target_path, compiler->GetLastError());
+						if (!_jobs[i].finished && _jobs[i].pending != 0)
+						{
+							logging::Warning("Circular dependency involving '%s'", _jobs[i].source.source_path.c_str());
+							_jobs[i].pending = 0;
+							ResolveJob(i);
+							break;
+						}
 					}
+					continue;
 				}
-				else if (res == SUCCESSFUL)
-				{
-					logging::Info("File successfuly compiled: %s (Type: %s)", sources[i].source_path.c_str(), sources[i].source_type.c_str());
-					if (callback)
-					{
-						callback->OnCompileSuccessful(sources[i].source_path, target_path);
-					}
-
-					// Compile dependencies
-					_dependency_database->GetDependents(sources[i].source_path.c_str(), dependents);
-					if (dependents.size() > 0)
-					{
-						logging::Info("Compiling %d dependencies for %s", dependents.size(), sources[i].source_path.c_str());
-					}
-					for (vector<string>::iterator it = dependents.begin(); it != dependents.end(); ++it)
-					{
-						AssetSource dependent_source(it->c_str());
-						Compile(&dependent_source, 1, true);
-					}
-					dependents.clear();
-				}
-
 			}
-			else
+
+			_done_event.Wait();
 			{
-				if (callback)
-				{
-					callback->OnCompileSkip(sources[i].source_path, target_path);
-				}
+				ScopedLock<CriticalSection> lock(_done_lock);
+				done.swap(_done);
 			}
+			for (uint32_t i = 0; i < done.size(); ++i)
+			{
+				_idle_workers.push_back(done[i].first);
+				--_running[_jobs[done[i].second].compiler];
 
-			target_path.Clear();
+				FinishJob(done[i].second);
+			}
+			done.clear();
 		}
+
+		_jobs.clear();
+		_job_map.clear();
+		_ready.clear();
+		_running.clear();
 	}
 
 	void CompilerSystem::RegisterCompiler(const char* source_type, Compiler* compiler)
@@ -233,12 +345,17 @@ namespace sb
 	}
 	void CompilerSystem::UnregisterCompiler(Compiler* compiler)
 	{
-		_compilers.erase(compiler->GetSourceType());
+		_compilers.Erase(compiler->GetSourceType());
 	}
 
 	void CompilerSystem::SetBuildSettings(BuildSettings* settings)
 	{
 		_active_settings = settings;
+		_settings_hash = build_settings::Hash(*settings);
+	}
+	void CompilerSystem::SetBuildCache(BuildCache* build_cache)
+	{
+		_build_cache = build_cache;
 	}
 
 	void CompilerSystem::AddIgnoreAsset(const char* asset_name)
@@ -246,5 +363,287 @@ namespace sb
 		_ignores.push_back(asset_name);
 	}
 
+	uint32_t CompilerSystem::AddJob(const AssetSource& source, bool in_batch, bool force)
+	{
+		if (source.source_type.Empty()) // Skip sources without types (Files without extensions)
+			return Invalid<uint32_t>();
+
+		// Skip ignored assets
+		if (std::find(_ignores.begin(), _ignores.end(), source.source_path.c_str()) != _ignores.end())
+			return Invalid<uint32_t>();
+
+		map<string, uint32_t>::iterator job_it = _job_map.find(source.source_path.c_str());
+		if (job_it != _job_map.end())
+			return job_it->second;
+
+		uint32_t index = (uint32_t)_jobs.size();
+		_job_map[source.source_path.c_str()] = index;
+
+		_jobs.push_back(Job(source));
+		Job& job = _jobs.back();
+
+		// Jobs only added as dependents are only checked if anything they depend on was compiled
+		job.in_batch = in_batch;
+		job.need_compile = in_batch;
+		job.force = in_batch && force;
+
+		// Files without a compiler are external resources (e.g. images used by textures), they may still have dependents
+		HashMap<InternedString, Compiler*>::Iterator it = _compilers.Find(source.source_type);
+		if (it != _compilers.End())
+		{
+			job.compiler = it->second;
+			Assert(job.compiler);
+
+			job.target_path += source.source_path.c_str();
+			job.target_path.TrimExtension();
+			job.target_path += ".";
+			job.target_path += job.compiler->GetType();
+		}
+		return index;
+	}
+	void CompilerSystem::ResolveJob(uint32_t index)
+	{
+		Job& job = _jobs[index];
+		if (job.need_compile || job.triggered)
+		{
+			job.run = true;
+			_ready.insert(std::lower_bound(_ready.begin(), _ready.end(), index), index);
+			return;
+		}
+
+		FinishJob(index);
+	}
+	void CompilerSystem::FinishJob(uint32_t index)
+	{
+		Job& job = _jobs[index];
+		job.finished = true;
+		++_num_finished;
+
+		for (uint32_t i = 0; i < job.dependents.size(); ++i)
+		{
+			Job& dependent = _jobs[job.dependents[i]];
+			if (job.compiled)
+				dependent.triggered = true;
+
+			if (dependent.pending > 0 && --dependent.pending == 0)
+				ResolveJob(job.dependents[i]);
+		}
+	}
+	void CompilerSystem::ReportJob(Job& job, BuildUICallback* callback)
+	{
+		if (job.compiler && (job.compiled || job.result == FAILED))
+		{
+			if (callback)
+			{
+				callback->OnCompile(job.source.source_path, job.target_path);
+			}
+
+			if (job.result == FAILED)
+			{
+				logging::Warning("Failed to compile '%s': %s", job.source.source_path.c_str(), job.error.c_str());
+				if (callback)
+				{
+					callback->OnCompileFailed(job.source.source_path, job.target_path, job.error);
+				}
+			}
+			else
+			{
+				if (job.cached)
+					logging::Info("File restored from build cache: %s (Type: %s)", job.source.source_path.c_str(), job.source.source_type.c_str());
+				else
+					logging::Info("File successfuly compiled: %s (Type: %s)", job.source.source_path.c_str(), job.source.source_type.c_str());
+
+				if (callback)
+				{
+					callback->OnCompileSuccessful(job.source.source_path, job.target_path);
+				}
+			}
+
+			if (callback)
+			{
+				job.stats.result = job.result;
+				job.stats.cached = job.cached;
+				callback->OnCompileStats(job.source, job.stats);
+			}
+			return;
+		}
+
+		if (job.in_batch && callback)
+		{
+			callback->OnCompileSkip(job.source.source_path, job.target_path);
+		}
+	}
+	void CompilerSystem::DispatchJobs()
+	{
+		for (uint32_t i = 0; i < _ready.size() && !_idle_workers.empty();)
+		{
+			uint32_t index = _ready[i];
+			Compiler* compiler = _jobs[index].compiler;
+
+			uint32_t& running = _running[compiler];
+			if (compiler && compiler->GetMaxJobs() != 0 && running >= compiler->GetMaxJobs())
+			{
+				++i;
+				continue;
+			}
+			++running;
+			_ready.erase(_ready.begin() + i);
+
+			Worker* worker = _idle_workers.back();
+			_idle_workers.pop_back();
+			worker->Start(index);
+		}
+	}
+	void CompilerSystem::OnJobDone(Worker* worker, uint32_t index)
+	{
+		ScopedLock<CriticalSection> lock(_done_lock);
+		_done.push_back(pair<Worker*, uint32_t>(worker, index));
+		_done_event.Set();
+	}
+	void CompilerSystem::RunJob(Job& job)
+	{
+		const char* source_path = job.source.source_path.c_str();
+		if (!job.compiler)
+		{
+			// For files without compilers we only need to tell the dependents if the file has changed,
+			//	the build key is simply the content hash.
+			uint64_t hash = 0;
+			_dependency_database->GetContentHash(source_path, hash);
+
+			job.compiled = job.triggered || hash != _dependency_database->GetBuildKey(source_path);
+			if (job.compiled && !job.dependents.empty())
+			{
+				// Only update resources with dependencies
+				_dependency_database->SetBuildKey(source_path, hash);
+			}
+			return;
+		}
+
+		CompilerContext context(_asset_source, _asset_target, _dependency_database,
+			_shader_database, _active_settings, _job_pool);
+
+		// A source we can't read is left for the compiler to fail on
+		uint64_t base_key = 0;
+		bool has_key = CalculateBaseKey(job, context, base_key);
+
+		vector<string> dependencies;
+		if (has_key)
+		{
+			_dependency_database->GetDependencies(source_path, dependencies);
+
+			FileTime target_time;
+			uint64_t key = CalculateKey(base_key, dependencies);
+			if (!job.force && key == _dependency_database->GetBuildKey(source_path)
+				&& _asset_target->LastModifiedTime(job.target_path.c_str(), target_time)
+				&& job.compiler->OnSkipCompile(job.source.source_path, context))
+			{
+				return; // Up to date
+			}
+
+			vector<string> cached_dependencies;
+			vector<uint8_t> data;
+			if (_build_cache && !job.force && job.compiler->IsCacheable()
+				&& _build_cache->GetDependencies(base_key, cached_dependencies)
+				&& _build_cache->Read(CalculateKey(base_key, cached_dependencies), data)
+				&& job.compiler->OnSkipCompile(job.source.source_path, context)
+				&& WriteTarget(job.target_path, data))
+			{
+				// Restore the dependencies recorded when the asset was compiled
+				for (auto& dependency : cached_dependencies)
+				{
+					_dependency_database->AddDependent(dependency.c_str(), source_path);
+				}
+				dependencies.clear();
+				_dependency_database->GetDependencies(source_path, dependencies);
+				_dependency_database->SetBuildKey(source_path, CalculateKey(base_key, dependencies));
+
+				job.compiled = true;
+				job.cached = true;
+				job.stats.bytes_in = FileLength(_asset_source, source_path);
+				job.stats.bytes_out = data.size();
+				return;
+			}
+		}
+
+		t_compile_error = &job.error;
+		job.result = job.compiler->Compile(job.source.source_path, job.target_path, context);
+		t_compile_error = nullptr;
+
+		job.stats.bytes_in = FileLength(_asset_source, source_path);
+		if (job.result != SUCCESSFUL)
+		{
+			_dependency_database->SetBuildKey(source_path, 0);
+			return;
+		}
+		job.compiled = true;
+		job.stats.bytes_out = FileLength(_asset_target, job.target_path.c_str());
+
+		if (!has_key)
+			return;
+
+		// The compiler may have found new dependencies
+		dependencies.clear();
+		_dependency_database->GetDependencies(source_path, dependencies);
+
+		uint64_t key = CalculateKey(base_key, dependencies);
+		_dependency_database->SetBuildKey(source_path, key);
+
+		if (_build_cache && job.compiler->IsCacheable())
+		{
+			FileStreamPtr file = _asset_target->OpenFile(job.target_path.c_str(), File::READ);
+			if (file.Get() && file->Length() >= 0)
+			{
+				vector<uint8_t> data((size_t)file->Length());
+				if (data.empty() || file->Read(data.data(), data.size()) == data.size())
+					_build_cache->Write(base_key, dependencies, key, data.data(), (uint32_t)data.size());
+			}
+		}
+	}
+	bool CompilerSystem::CalculateBaseKey(Job& job, const CompilerContext& context, uint64_t& base_key)
+	{
+		uint64_t content_hash;
+		if (!_dependency_database->GetContentHash(job.source.source_path.c_str(), content_hash))
+			return false;
+
+		uint32_t version = job.compiler->GetVersion();
+		uint64_t config_hash = job.compiler->GetConfigHash();
+
+		// Assets are compiled with their name so the path is part of the key as well
+		uint64_t hash = murmur_hash_64(job.source.source_path.c_str(), (uint32_t)strlen(job.source.source_path.c_str()), content_hash);
+		hash = murmur_hash_64(&version, sizeof(version), hash);
+		hash = murmur_hash_64(&config_hash, sizeof(config_hash), hash);
+		hash = murmur_hash_64(&_settings_hash, sizeof(_settings_hash), hash);
+		base_key = job.compiler->HashInputs(job.source.source_path, context, hash);
+		return true;
+	}
+	uint64_t CompilerSystem::CalculateKey(uint64_t base_key, const vector<string>& dependencies)
+	{
+		uint64_t hash = base_key;
+		for (auto& dependency : dependencies)
+		{
+			// Missing dependencies hash as 0
+			uint64_t content_hash = 0;
+			_dependency_database->GetContentHash(dependency.c_str(), content_hash);
+
+			hash = murmur_hash_64(dependency.c_str(), (uint32_t)dependency.size(), hash);
+			hash = murmur_hash_64(&content_hash, sizeof(content_hash), hash);
+		}
+		return (hash != 0) ? hash : 1; // 0 is reserved for unknown
+	}
+	bool CompilerSystem::WriteTarget(const FilePath& path, const vector<uint8_t>& data)
+	{
+		// Make sure folder exists
+		_asset_target->MakeDirectory(path.Directory().c_str());
+
+		FileStreamPtr file = _asset_target->OpenFile(path.c_str(), File::WRITE);
+		if (!file.Get())
+		{
+			logging::Warning("Failed to write to target file '%s'", path.c_str());
+			return false;
+		}
+
+		return file->Write(data.data(), data.size()) == data.size();
+	}
+
 } // namespace sb
 
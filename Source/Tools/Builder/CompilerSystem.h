@@ -6,6 +6,9 @@
 #include <Foundation/Filesystem/FileSystem.h>
 #include <Foundation/Filesystem/FilePath.h>
 #include <Foundation/Container/ConfigValue.h>
+#include <Foundation/Container/HashMap.h>
+#include <Foundation/Container/InternedString.h>
+#include <Foundation/Thread/Thread.h>
 
 #include "Settings.h"
 
@@ -16,6 +19,8 @@ namespace sb
 	class ShaderDatabase;
 	class DependencyDatabase;
 	class BuildUICallback;
+	class BuildCache;
+	class JobPool;
 	struct BuildSettings;
 
 	struct AssetSource
@@ -28,7 +33,7 @@ namespace sb
 		}
 
 		FilePath source_path;
-		string source_type;
+		InternedString source_type; ///< File extension, interned as it's compared for every asset scanned
 	};
 
 	class CompilerSystem
@@ -38,15 +43,31 @@ namespace sb
 		enum ResultEnum { SUCCESSFUL, FAILED };
 		typedef uint8_t Result;
 
+		/// Statistics for an asset that was compiled or restored from the build cache
+		struct JobStats
+		{
+			JobStats() : start(0.0), duration(0.0), bytes_in(0), bytes_out(0), worker(0), result(SUCCESSFUL), cached(false) {}
+
+			double start; ///< Seconds since the timer was initialized
+			double duration; ///< Seconds, including checking if the asset was up to date
+			uint64_t bytes_in; ///< Size of the source file
+			uint64_t bytes_out; ///< Size of the compiled asset
+			uint32_t worker; ///< Index of the worker thread
+
+			Result result;
+			bool cached; ///< Was restored from the build cache
+		};
+
 		struct CompilerContext
 		{
 			CompilerContext(FileSource* source, FileSource* target, DependencyDatabase* dependency_db,
-				ShaderDatabase* shader_db, BuildSettings* settings)
+				ShaderDatabase* shader_db, BuildSettings* settings, JobPool* job_pool)
 				: asset_source(source),
 				asset_target(target),
 				dependency_database(dependency_db),
 				shader_database(shader_db),
-				settings(settings)
+				settings(settings),
+				job_pool(job_pool)
 			{
 			}
 
@@ -57,6 +78,9 @@ namespace sb
 			ShaderDatabase* shader_database;
 
 			BuildSettings* settings;
+
+			/// Compilers wanting to split up the work on an asset use this rather than threads of their own
+			JobPool* job_pool;
 		};
 
 		class Compiler
@@ -69,38 +93,77 @@ namespace sb
 			/// @return Pointer to the memory holding the compiled asset 
 			virtual Result Compile(const FilePath& source_file, const FilePath& target_file, const CompilerContext& context) = 0;
 
-			/// @return True if the given asset needs to be compiled, false if not
-			virtual bool NeedCompile(const FilePath& source_file, const FilePath& target_file, const CompilerContext& context);
+			/// Version of the compiled output, increase whenever the output changes for the same input
+			///	to invalidate previously built assets and build cache entries.
+			virtual uint32_t GetVersion() const;
+
+			/// Adds anything affecting the compiled asset, besides the source file, the compiler config,
+			///	the build settings and the dependencies of the asset, to the specified hash.
+			/// @return The new hash
+			virtual uint64_t HashInputs(const FilePath& source_file, const CompilerContext& context, uint64_t hash);
+
+			/// @return False if compiled assets of this type can't be restored from the build cache, which
+			///			is the case if compiling has any side effects besides writing the target file.
+			virtual bool IsCacheable() const;
+
+			/// Called instead of Compile when the asset is up to date or was restored from the build cache,
+			///	lets compilers update any state that Compile would have updated.
+			/// @return False to compile the asset anyway
+			virtual bool OnSkipCompile(const FilePath& source_file, const CompilerContext& context);
 
 			const string& GetType() const;
-			const string& GetSourceType() const;
+			const InternedString& GetSourceType() const;
+
+			/// @return Hash of the config for the compiler
+			uint64_t GetConfigHash() const;
 
-			const string& GetLastError() const;
+			/// @return Maximum number of assets of this type compiled at the same time, 0 if unlimited.
+			///			Set with "max_jobs" in the compiler config.
+			uint32_t GetMaxJobs() const;
 
 		protected:
 			const Compiler& operator=(const Compiler&) { return *this; }
 
+			/// Reads the whole source file into data, sets the error message on failure
+			/// @return False if the file couldn't be opened or read
+			bool ReadAsset(FileSource* asset_source, const FilePath& path, vector<uint8_t>& data);
+
 			bool WriteAsset(FileSource* asset_target, const FilePath& path, const uint8_t* data, uint32_t len);
 
+			/// Sets the error message for the asset currently being compiled on this thread
 			void SetError(const char* msg);
 
 			string _type;
-			string _source_type;
+			InternedString _source_type;
 
 			string _target_path;
 			string _source_path;
 
-			string _last_error;
+			uint32_t _max_jobs;
+			uint64_t _config_hash;
 		};
 
 
 	public:
+		/// @param worker_count Number of threads used for compiling, 0 for one per processor.
 		CompilerSystem(BuildServer* builder, FileSource* asset_source, FileSource* asset_target,
-			DependencyDatabase* dependency_db, ShaderDatabase* shader_db, BuildSettings* settings);
+			DependencyDatabase* dependency_db, ShaderDatabase* shader_db, BuildSettings* settings,
+			uint32_t worker_count = 0);
 		~CompilerSystem();
 
-		/// Compiles the given asset sources
-		/// @param force If true, all given files will be forced to recompiled even if not needed.
+		/// Compiles the given asset sources, together with any assets depending on them.
+		///
+		///	Assets are compiled in parallel on the worker threads, an asset is never compiled before
+		///		the assets it depends on (according to the dependency database) are finished. Results
+		///		are reported through the callback from the calling thread, in the order the assets
+		///		were given (with dependents last), no matter in which order they finished.
+		///
+		///	An asset is only compiled if its build key, a hash of the contents of its source and its
+		///		dependencies together with the compiler, its config and the build settings, differs
+		///		from when it last was built. Before compiling, the build cache (if any) is checked
+		///		for an asset compiled from the same inputs.
+		/// @param force If true, all given files will be forced to recompiled even if not needed,
+		///				without using the build cache.
 		void Compile(AssetSource* sources, uint32_t num, bool force = false, BuildUICallback* callback = NULL);
 
 		/// Assigns a compiler to a specific source type
@@ -109,12 +172,90 @@ namespace sb
 
 		void SetBuildSettings(BuildSettings* settings);
 
+		/// Sets the build cache to use, NULL to disable caching
+		void SetBuildCache(BuildCache* build_cache);
+
 		void AddIgnoreAsset(const char* asset_name);
 
 	private:
+		class Worker;
+
+		struct Job
+		{
+			Job(const AssetSource& src)
+				: source(src),
+				compiler(NULL),
+				need_compile(false),
+				in_batch(false),
+				triggered(false),
+				force(false),
+				compiled(false),
+				cached(false),
+				run(false),
+				finished(false),
+				pending(0),
+				result(SUCCESSFUL)
+			{
+			}
+
+			AssetSource source;
+			FilePath target_path;
+			Compiler* compiler; ///< NULL for files without a compiler, these may still have dependents
+
+			bool need_compile; ///< Needs to be checked regardless of its dependencies
+			bool in_batch; ///< Given to Compile, false for jobs only added as dependents
+			bool triggered; ///< Set when any of its dependencies was compiled
+			bool force; ///< Compile even if up to date
+			bool compiled; ///< Was compiled or restored from the cache, or for files without a compiler, has changed
+			bool cached; ///< Was restored from the build cache
+			bool run; ///< Was handed to a worker
+			bool finished;
+
+			uint32_t pending; ///< Number of dependencies not finished yet
+			vector<uint32_t> dependents;
+
+			Result result;
+			string error;
+
+			JobStats stats;
+		};
+
+		/// Adds a job for the specified source unless there already is one
+		/// @return Index of the job, Invalid if the source should be ignored
+		uint32_t AddJob(const AssetSource& source, bool in_batch, bool force);
+
+		/// Called when a job has no unfinished dependencies left, either makes the job ready for
+		///	compiling or finishes it right away if it doesn't need to be compiled.
+		void ResolveJob(uint32_t index);
+
+		/// Marks a job as finished and resolves any dependents that were waiting for it
+		void FinishJob(uint32_t index);
+
+		/// Reports the result of a job through the callback
+		void ReportJob(Job& job, BuildUICallback* callback);
+
+		/// Hands out ready jobs to idle workers
+		void DispatchJobs();
+
+		/// Called from a worker thread when it's done with its job
+		void OnJobDone(Worker* worker, uint32_t index);
+
+		/// Checks whether the job is up to date and compiles it if not, called from the worker threads
+		void RunJob(Job& job);
+
+		/// Calculates the part of the build key not depending on the dependencies of the asset
+		/// @return False if the source file couldn't be read
+		bool CalculateBaseKey(Job& job, const CompilerContext& context, uint64_t& base_key);
+
+		/// Calculates the build key from the base key and the current contents of the dependencies
+		uint64_t CalculateKey(uint64_t base_key, const vector<string>& dependencies);
+
+		/// Writes a compiled asset restored from the build cache to the target directory
+		bool WriteTarget(const FilePath& path, const vector<uint8_t>& data);
+
 		BuildServer* _builder;
 
-		map<StringId32, Compiler*> _compilers;
+		HashMap<InternedString, Compiler*> _compilers;
 		vector<string> _ignores;
 
 		FileSource* _asset_source;
@@ -124,6 +265,25 @@ namespace sb
 		ShaderDatabase* _shader_database;
 
 		BuildSettings* _active_settings;
+		uint64_t _settings_hash;
+
+		BuildCache* _build_cache;
+
+		vector<Worker*> _workers;
+		vector<Worker*> _idle_workers;
+		JobPool* _job_pool;
+
+		// State for the batch being compiled, only touched by the thread calling Compile
+		vector<Job> _jobs;
+		map<string, uint32_t> _job_map; ///< Source path => index in _jobs
+		vector<uint32_t> _ready; ///< Jobs ready for compiling, lowest index first
+		map<Compiler*, uint32_t> _running; ///< Number of running jobs for each compiler
+		uint32_t _num_finished;
+
+		// Finished jobs posted by the workers
+		CriticalSection _done_lock;
+		vector<pair<Worker*, uint32_t>> _done;
+		Event _done_event;
 
 	};
 
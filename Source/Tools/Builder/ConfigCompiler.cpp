@@ -0,0 +1,53 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "ConfigCompiler.h"
+
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Container/CompiledConfig.h>
+#include <Foundation/Json/Json.h>
+
+namespace sb
+{
+
+	ConfigCompiler::ConfigCompiler(const ConfigValue& config)
+		: Compiler(config)
+	{
+	}
+	ConfigCompiler::~ConfigCompiler()
+	{
+	}
+
+	CompilerSystem::Result ConfigCompiler::Compile(const FilePath& source_file, const FilePath& target_file, const CompilerSystem::CompilerContext& context)
+	{
+		vector<uint8_t> source_data;
+		if (!ReadAsset(context.asset_source, source_file, source_data))
+			return CompilerSystem::FAILED;
+
+		ConfigValue root;
+		root.SetEmptyObject();
+
+		simplified_json::Reader reader;
+		if (!source_data.empty() && !reader.Read((const char*)source_data.data(), (int64_t)source_data.size(), root))
+		{
+			SetError(reader.GetErrorMessage().c_str());
+			return CompilerSystem::FAILED;
+		}
+
+		vector<uint8_t> data;
+		DynamicMemoryStream stream(&data);
+
+		compiled_config::Compile(root, stream);
+
+		if (!WriteAsset(context.asset_target, target_file, data.data(), (uint32_t)data.size()))
+			return CompilerSystem::FAILED;
+
+		return CompilerSystem::SUCCESSFUL;
+	}
+	uint32_t ConfigCompiler::GetVersion() const
+	{
+		return compiled_config::VERSION;
+	}
+
+} // namespace sb
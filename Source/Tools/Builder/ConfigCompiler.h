@@ -0,0 +1,27 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __BUILDER_CONFIGCOMPILER_H__
+#define __BUILDER_CONFIGCOMPILER_H__
+
+
+#include "CompilerSystem.h"
+
+namespace sb
+{
+
+	/// Compiles simplified-JSON config files, e.g. render setups, into the binary
+	///		compiled config format which the runtime reads in place.
+	class ConfigCompiler : public CompilerSystem::Compiler
+	{
+	public:
+		ConfigCompiler(const ConfigValue& config);
+		~ConfigCompiler();
+
+		CompilerSystem::Result Compile(const FilePath& source_file, const FilePath& target_file, const CompilerSystem::CompilerContext& context);
+		uint32_t GetVersion() const;
+
+	};
+
+} // namespace sb
+
+#endif // __BUILDER_CONFIGCOMPILER_H__
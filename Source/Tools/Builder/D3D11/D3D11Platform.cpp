@@ -10,8 +10,10 @@
 #include "D3D11Platform.h"
 #include "ShaderCompiler.h"
 #include "DependencyDatabase.h"
+#include "BuildCache.h"
 
 #include <Engine/Rendering/Shader.h>
+#include <Foundation/Hash/murmur_hash.h>
 #include <Foundation/Json/Json.h>
 
 #include "RenderState.h"
@@ -21,6 +23,9 @@ namespace sb
 
 	namespace
 	{
+		/// Changing this invalidates all programs in the shader cache
+		const uint64_t PROGRAM_CACHE_VERSION = 1;
+
 		ShaderVariable::Class StringToType(const char* type)
 		{
 			if (strcmp(type, "matrix4x4") == 0)
@@ -508,40 +513,55 @@ namespace sb
 
 		D3DInclude include(_file_cache, _base_path, file_path);
 
-		ID3DBlob* bytecode = NULL;
+		// Programs are cached by their preprocessed source rather than by the permutation, so a change
+		//	to an include file or an option only recompiles the programs it actually affects.
+		ID3DBlob* preprocessed = NULL;
 		ID3DBlob* errors = NULL;
-		HRESULT hr = D3DCompile(buffer->Ptr(), (SIZE_T)buffer->Length(), file_path.c_str(), macros.data(), &include, program_node["entry"].AsString(),
-			program_node["target"].AsString(), hlsl_flags, 0, &bytecode, &errors);
-
+		HRESULT hr = D3DPreprocess(buffer->Ptr(), (SIZE_T)buffer->Length(), file_path.c_str(), macros.data(), &include, &preprocessed, &errors);
 		if (FAILED(hr))
 		{
-			if (errors)
-			{
-				stringstream ss;
-				ss << "\n" << (char*)errors->GetBufferPointer();
-				_error = ss.str();
+			SetCompileError(hr, errors);
+			return false;
+		}
+		if (errors)
+		{
+			errors->Release();
+			errors = NULL;
+		}
 
-				// Remove \n that dx added at the end
-				size_t p = _error.rfind('\n');
-				_error.erase(p, 1);
+		const char* entry = program_node["entry"].AsString();
+		const char* target = program_node["target"].AsString();
 
-				// Do some formatting
-				p = _error.find('\n');
-				while (p != string::npos)
-				{
-					_error.insert(p + 1, '\t', 1);
-					p = _error.find('\n', p + 1);
-				}
+		uint64_t key = murmur_hash_64(preprocessed->GetBufferPointer(), (uint32_t)preprocessed->GetBufferSize(), PROGRAM_CACHE_VERSION);
+		key = murmur_hash_64(entry, (uint32_t)strlen(entry) + 1, key);
+		key = murmur_hash_64(target, (uint32_t)strlen(target) + 1, key);
+		key = murmur_hash_64(&hlsl_flags, sizeof(hlsl_flags), key);
 
+		BuildCache* cache = _context.shader_database->GetProgramCache();
+		if (cache && cache->Read(key, program.byte_code) && !program.byte_code.empty())
+		{
+			preprocessed->Release();
+			return true;
+		}
 
-				errors->Release();
-			}
-			else
-			{
-				_error = string_util::Format("Failed to compile shader (HRESULT: 0x%x).", hr);
-			}
+		// The preprocessed source keeps the line directives, so errors still point to the original files
+		ID3DBlob* bytecode = NULL;
+		hr = D3DCompile(preprocessed->GetBufferPointer(), preprocessed->GetBufferSize(), file_path.c_str(), NULL, NULL, entry,
+			target, hlsl_flags, 0, &bytecode, &errors);
+
+		preprocessed->Release();
+		preprocessed = NULL;
+
+		if (FAILED(hr))
+		{
+			SetCompileError(hr, errors);
 			return false;
 		}
+		if (errors)
+		{
+			errors->Release();
+			errors = NULL;
+		}
 
 		program.byte_code.clear();
 		program.byte_code.insert(
@@ -552,8 +572,39 @@ namespace sb
 		bytecode->Release();
 		bytecode = NULL;
 
+		if (cache)
+			cache->Write(key, program.byte_code.data(), (uint32_t)program.byte_code.size());
+
 		return true;
 	}
+	void D3D11Platform::SetCompileError(HRESULT hr, ID3DBlob* errors)
+	{
+		if (errors)
+		{
+			stringstream ss;
+			ss << "\n" << (char*)errors->GetBufferPointer();
+			_error = ss.str();
+
+			// Remove \n that dx added at the end
+			size_t p = _error.rfind('\n');
+			_error.erase(p, 1);
+
+			// Do some formatting
+			p = _error.find('\n');
+			while (p != string::npos)
+			{
+				_error.insert(p + 1, '\t', 1);
+				p = _error.find('\n', p + 1);
+			}
+
+
+			errors->Release();
+		}
+		else
+		{
+			_error = string_util::Format("Failed to compile shader (HRESULT: 0x%x).", hr);
+		}
+	}
 	void D3D11Platform::ReflectProgram(ShaderData& shader_data, D3D11ShaderPassData& d3d_shader_pass_data,
 		D3D11ShaderPassData::ShaderProgram& shader_program)
 	{
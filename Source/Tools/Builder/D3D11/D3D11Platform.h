@@ -48,6 +48,9 @@ namespace sb
 			D3D11ShaderPassData& d3d_shader_pass_data);
 		bool CompileProgram(const ConfigValue& program_node, const vector<D3D_SHADER_MACRO>& macros, UINT hlsl_flags, D3D11ShaderPassData::ShaderProgram& program);
 
+		/// Sets the error from a failed call to the HLSL compiler
+		void SetCompileError(HRESULT hr, ID3DBlob* errors);
+
 		void ReflectProgram(ShaderData& shader_data, D3D11ShaderPassData& d3d_shader_pass_data, D3D11ShaderPassData::ShaderProgram& shader_program);
 		void ReflectConstantBuffer(ID3D11ShaderReflectionConstantBuffer* d3d_reflection, ConstantBufferReflection& buffer_reflection);
 
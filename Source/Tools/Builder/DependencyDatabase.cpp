@@ -6,16 +6,119 @@
 
 #include <Foundation/Filesystem/FilePath.h>
 #include <Foundation/Filesystem/FileSource.h>
-#include <Foundation/Container/ConfigValue.h>
-#include <Foundation/Json/Json.h>
+#include <Foundation/Filesystem/FileUtil.h>
+#include <Foundation/Hash/murmur_hash.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Timer/Timer.h>
+
+#include <algorithm>
+#include <stdio.h>
 
 
 namespace sb
 {
 
+	//-------------------------------------------------------------------------------
+	// Database file layout, all sections are laid out directly after each other:
+	//	FileHeader
+	//	FileRecord records[path_count], sorted by path
+	//	uint32_t dependent_offsets[path_count + 1]
+	//	uint32_t dependents[link_count], path indices, sorted for each path
+	//	uint32_t dependency_offsets[path_count + 1]
+	//	uint32_t dependencies[link_count]
+	//	char strings[string_size], null-terminated paths
+	//
+	// Journal layout:
+	//	JournalHeader
+	//	{[type][path]([FileTime][content hash][build key] | [dependent path])}, paths are stored as [length][chars]
+	//-------------------------------------------------------------------------------
+	namespace
+	{
+		const char* DATABASE_FILE = ".builder/dependency_database";
+		const char* JOURNAL_FILE = ".builder/dependency_database.journal";
+
+		const uint32_t FILE_MAGIC = 0x44444253; // "SBDD"
+		const uint32_t JOURNAL_MAGIC = 0x4a444253; // "SBDJ"
+		const uint32_t FILE_VERSION = 1;
+
+		enum JournalRecordType
+		{
+			JOURNAL_ENTRY = 1,
+			JOURNAL_LINK = 2
+		};
+
+		struct JournalHeader
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint64_t file_id; ///< Id of the database file the journal applies to
+		};
+
+		void WritePath(Stream& stream, const char* path)
+		{
+			uint32_t length = (uint32_t)strlen(path);
+			stream.Write(&length, 4);
+			stream.Write(path, length);
+		}
+		bool ReadPath(const uint8_t*& ptr, const uint8_t* end, string& path)
+		{
+			if (end - ptr < 4)
+				return false;
+			uint32_t length;
+			memcpy(&length, ptr, 4); // Records aren't aligned
+			ptr += 4;
+
+			if ((uint32_t)(end - ptr) < length)
+				return false;
+			path.assign((const char*)ptr, length);
+			ptr += length;
+			return true;
+		}
+		template<typename T>
+		bool ReadValue(const uint8_t*& ptr, const uint8_t* end, T& value)
+		{
+			if ((size_t)(end - ptr) < sizeof(T))
+				return false;
+			memcpy(&value, ptr, sizeof(T));
+			ptr += sizeof(T);
+			return true;
+		}
+	}
+
+	struct DependencyDatabase::FileHeader
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t id; ///< Unique for every written file, ties journals to the file
+
+		uint32_t path_count;
+		uint32_t link_count;
+		uint32_t string_size;
+		uint32_t padding;
+	};
+	struct DependencyDatabase::FileRecord
+	{
+		uint32_t path; ///< Offset in the string table
+		uint32_t padding;
+
+		FileTime last_modified;
+		uint64_t content_hash;
+		uint64_t build_key;
+	};
+
 	//-------------------------------------------------------------------------------
 	DependencyDatabase::DependencyDatabase(FileSource* file_source)
-		: _file_source(file_source)
+		: _file_source(file_source),
+		_header(NULL),
+		_records(NULL),
+		_dependent_offsets(NULL),
+		_dependents(NULL),
+		_dependency_offsets(NULL),
+		_dependencies(NULL),
+		_strings(NULL),
+		_file_path_count(0),
+		_journal_records(0),
+		_journal_damaged(false)
 	{
 	}
 	DependencyDatabase::~DependencyDatabase()
@@ -27,166 +130,620 @@ namespace sb
 		FilePath res_file_path(resource_path);
 		res_file_path.SetSeparator('/');
 
-		DependencyMap::iterator map_it = _dependencies.find(res_file_path.Get());
-		if (map_it == _dependencies.end())
-		{
-			// Make sure the entry gets constructed with the right allocator
-			map_it = _dependencies.insert(pair<string, Entry>(res_file_path.Get(), Entry())).first;
-		}
-		Entry& entry = map_it->second;
-
 		FilePath dep_file_path(dependent_path);
 		dep_file_path.SetSeparator('/');
 
-		// Check if it already is in there
-		vector<string>::iterator it, end;
-		it = entry.dependents.begin(); end = entry.dependents.end();
-		for (; it != end; ++it)
+		ScopedLock<CriticalSection> lock(_lock);
+
+		uint32_t resource = InternPath(res_file_path.Get());
+		uint32_t dependent = InternPath(dep_file_path.Get());
+		if (AddLink(resource, dependent))
 		{
-			if ((*it) == dep_file_path.Get())
-				return;
+			_new_links.push_back(pair<uint32_t, uint32_t>(resource, dependent));
 		}
-		entry.dependents.push_back(dep_file_path.Get());
 	}
 	void DependencyDatabase::GetDependents(const char* resource_path, vector<string>& dependents)
 	{
 		FilePath res_file_path(resource_path);
 		res_file_path.SetSeparator('/');
 
-		DependencyMap::iterator map_it = _dependencies.find(res_file_path.Get());
-		if (map_it == _dependencies.end())
+		ScopedLock<CriticalSection> lock(_lock);
+
+		uint32_t id;
+		if (!FindPath(res_file_path.Get(), id))
+			return;
+
+		if (id < _file_path_count)
 		{
+			for (uint32_t i = _dependent_offsets[id]; i < _dependent_offsets[id + 1]; ++i)
+				dependents.push_back(GetPath(_dependents[i]));
+		}
+		for (auto dependent : _entries[id].dependents)
+			dependents.push_back(GetPath(dependent));
+	}
+	void DependencyDatabase::GetDependencies(const char* dependent_path, vector<string>& dependencies)
+	{
+		FilePath dep_file_path(dependent_path);
+		dep_file_path.SetSeparator('/');
+
+		ScopedLock<CriticalSection> lock(_lock);
+
+		uint32_t id;
+		if (!FindPath(dep_file_path.Get(), id))
 			return;
+
+		if (id < _file_path_count)
+		{
+			for (uint32_t i = _dependency_offsets[id]; i < _dependency_offsets[id + 1]; ++i)
+				dependencies.push_back(GetPath(_dependencies[i]));
+		}
+		if (!_entries[id].dependencies.empty())
+		{
+			for (auto dependency : _entries[id].dependencies)
+				dependencies.push_back(GetPath(dependency));
+
+			// Dependencies are hashed in this order
+			std::sort(dependencies.begin(), dependencies.end());
 		}
-		Entry& entry = map_it->second;
-		dependents = entry.dependents;
 	}
 	void DependencyDatabase::Clear()
 	{
-		_dependencies.clear();
+		ScopedLock<CriticalSection> lock(_lock);
+		Reset();
 	}
 	//-------------------------------------------------------------------------------
-	void DependencyDatabase::UpdateModifiedTime(const char* resource_path, const FileTime& modified_time)
+	bool DependencyDatabase::GetContentHash(const char* resource_path, uint64_t& hash)
 	{
 		FilePath res_file_path(resource_path);
 		res_file_path.SetSeparator('/');
 
-		DependencyMap::iterator map_it = _dependencies.find(res_file_path.Get());
-		if (map_it == _dependencies.end())
+		FileTime file_time;
+		if (!_file_source->LastModifiedTime(res_file_path.c_str(), file_time))
+			return false;
+
 		{
-			// Make sure the entry gets constructed with the right allocator
-			map_it = _dependencies.insert(pair<string, Entry>(res_file_path.Get(), Entry())).first;
+			ScopedLock<CriticalSection> lock(_lock);
+
+			uint32_t id;
+			if (FindPath(res_file_path.Get(), id) && _entries[id].content_hash != 0
+				&& _entries[id].last_modified == file_time)
+			{
+				hash = _entries[id].content_hash;
+				return true;
+			}
 		}
-		map_it->second.last_modified = modified_time;
+
+		// Hash the file without holding the lock, as this may take a while for big files
+		FileStreamPtr file = _file_source->OpenFile(res_file_path.c_str(), File::READ);
+		if (!file.Get() || file->Length() < 0)
+			return false;
+
+		vector<uint8_t> data((size_t)file->Length());
+		if (!data.empty() && file->Read(data.data(), data.size()) != data.size())
+			return false;
+
+		hash = murmur_hash_64(data.data(), (uint32_t)data.size(), 0);
+		if (hash == 0)
+			hash = 1; // 0 is reserved for unknown
+
+		ScopedLock<CriticalSection> lock(_lock);
+
+		uint32_t id = InternPath(res_file_path.Get());
+		_entries[id].last_modified = file_time;
+		_entries[id].content_hash = hash;
+		MarkDirty(id);
+		return true;
 	}
-	bool DependencyDatabase::GetModifiedTime(const char* resource_path, FileTime& modified_time)
+	void DependencyDatabase::SetBuildKey(const char* resource_path, uint64_t key)
 	{
 		FilePath res_file_path(resource_path);
 		res_file_path.SetSeparator('/');
 
-		DependencyMap::iterator map_it = _dependencies.find(res_file_path.Get());
-		if (map_it == _dependencies.end())
+		ScopedLock<CriticalSection> lock(_lock);
+
+		uint32_t id = InternPath(res_file_path.Get());
+		if (_entries[id].build_key != key)
+		{
+			_entries[id].build_key = key;
+			MarkDirty(id);
+		}
+	}
+	uint64_t DependencyDatabase::GetBuildKey(const char* resource_path)
+	{
+		FilePath res_file_path(resource_path);
+		res_file_path.SetSeparator('/');
+
+		ScopedLock<CriticalSection> lock(_lock);
+
+		uint32_t id;
+		if (!FindPath(res_file_path.Get(), id))
+			return 0;
+
+		return _entries[id].build_key;
+	}
+	//-------------------------------------------------------------------------------
+	bool DependencyDatabase::FindPath(const string& path, uint32_t& id) const
+	{
+		// Paths in the file are sorted
+		uint32_t first = 0, count = _file_path_count;
+		while (count > 0)
 		{
+			uint32_t step = count / 2;
+			int cmp = strcmp(_strings + _records[first + step].path, path.c_str());
+			if (cmp == 0)
+			{
+				id = first + step;
+				return true;
+			}
+			if (cmp < 0)
+			{
+				first += step + 1;
+				count -= step + 1;
+			}
+			else
+			{
+				count = step;
+			}
+		}
+
+		unordered_map<string, uint32_t>::const_iterator it = _new_path_ids.find(path);
+		if (it == _new_path_ids.end())
 			return false;
+
+		id = it->second;
+		return true;
+	}
+	uint32_t DependencyDatabase::InternPath(const string& path)
+	{
+		uint32_t id;
+		if (FindPath(path, id))
+			return id;
+
+		id = _file_path_count + (uint32_t)_new_paths.size();
+		_new_paths.push_back(path);
+		_new_path_ids[path] = id;
+		_entries.push_back(Entry());
+		return id;
+	}
+	const char* DependencyDatabase::GetPath(uint32_t id) const
+	{
+		if (id < _file_path_count)
+			return _strings + _records[id].path;
+		return _new_paths[id - _file_path_count].c_str();
+	}
+	bool DependencyDatabase::AddLink(uint32_t resource, uint32_t dependent)
+	{
+		// Check if it already is in there
+		if (resource < _file_path_count)
+		{
+			const uint32_t* begin = _dependents + _dependent_offsets[resource];
+			const uint32_t* end = _dependents + _dependent_offsets[resource + 1];
+			if (std::binary_search(begin, end, dependent))
+				return false;
 		}
-		modified_time = map_it->second.last_modified;
+		vector<uint32_t>& dependents = _entries[resource].dependents;
+		if (std::find(dependents.begin(), dependents.end(), dependent) != dependents.end())
+			return false;
+
+		dependents.push_back(dependent);
+		_entries[dependent].dependencies.push_back(resource);
 		return true;
 	}
+	void DependencyDatabase::MarkDirty(uint32_t id)
+	{
+		if (!_entries[id].dirty)
+		{
+			_entries[id].dirty = true;
+			_dirty.push_back(id);
+		}
+	}
 	//-------------------------------------------------------------------------------
 	void DependencyDatabase::Save()
 	{
 		Assert(_file_source);
 
-		ConfigValue root;
-		root.SetEmptyObject();
+		ScopedLock<CriticalSection> lock(_lock);
+
+		if (_header && _dirty.empty() && _new_links.empty())
+			return; // Nothing changed
 
+		// Make sure .builder folder exists
+		_file_source->MakeDirectory(".builder");
 
-		for (auto& dep_list : _dependencies)
+		uint32_t journal_limit = JOURNAL_LIMIT + _file_path_count / 4;
+		bool journaled = _header && !_journal_damaged && _journal_records + _dirty.size() + _new_links.size() <= journal_limit
+			&& AppendJournal();
+		if (!journaled && !WriteFile())
 		{
-			FileTime file_time;
+			logging::Warning("Failed to save dependency database");
+			return;
+		}
 
-			if (!_file_source->LastModifiedTime(dep_list.first.c_str(), file_time))
-				continue;
+		logging::Info("Dependency database successfully saved.");
+	}
+	bool DependencyDatabase::Load()
+	{
+		Assert(_file_source);
 
-			ConfigValue& entry = root[dep_list.first.c_str()];
-			entry.SetEmptyObject();
+		ScopedLock<CriticalSection> lock(_lock);
 
-			entry["time"].SetEmptyArray();
-			entry["time"].Append().SetUInt(file_time.high);
-			entry["time"].Append().SetUInt(file_time.low);
+		Reset();
+		if (!LoadFile())
+		{
+			logging::Warning("Failed loading dependency database");
+			Reset();
+			return false;
+		}
+		ReplayJournal();
 
-			ConfigValue& dependents = entry["dependents"];
-			dependents.SetEmptyArray();
+		logging::Info("Dependency database successfully loaded.");
+		return true;
+	}
+	//-------------------------------------------------------------------------------
+	void DependencyDatabase::Reset()
+	{
+		_file.Close();
+		_header = NULL;
+		_records = NULL;
+		_dependent_offsets = _dependents = NULL;
+		_dependency_offsets = _dependencies = NULL;
+		_strings = NULL;
+		_file_path_count = 0;
+
+		_entries.clear();
+		_new_paths.clear();
+		_new_path_ids.clear();
+		_dirty.clear();
+		_new_links.clear();
+		_journal_records = 0;
+		_journal_damaged = false;
+	}
+	bool DependencyDatabase::MapFile()
+	{
+		if (!_file_source->MapFile(DATABASE_FILE, _file))
+			return false;
 
-			for (auto& dep : dep_list.second.dependents)
-			{
-				dependents.Append().SetString(dep.c_str());
-			}
+		const uint8_t* data = _file.Data();
+		uint64_t size = _file.Size();
+		if (size < sizeof(FileHeader))
+			return false;
+
+		const FileHeader* header = (const FileHeader*)data;
+		if (header->magic != FILE_MAGIC || header->version != FILE_VERSION)
+			return false;
+
+		uint64_t expected_size = sizeof(FileHeader) + uint64_t(header->path_count) * sizeof(FileRecord)
+			+ 2 * (uint64_t(header->path_count) + 1 + header->link_count) * sizeof(uint32_t) + header->string_size;
+		if (size != expected_size || header->string_size == 0 || data[size - 1] != '\0')
+			return false;
+
+		uint32_t path_count = header->path_count;
+		const uint8_t* ptr = data + sizeof(FileHeader);
+		_records = (const FileRecord*)ptr;
+		ptr += path_count * sizeof(FileRecord);
+		_dependent_offsets = (const uint32_t*)ptr;
+		ptr += (path_count + 1) * sizeof(uint32_t);
+		_dependents = (const uint32_t*)ptr;
+		ptr += header->link_count * sizeof(uint32_t);
+		_dependency_offsets = (const uint32_t*)ptr;
+		ptr += (path_count + 1) * sizeof(uint32_t);
+		_dependencies = (const uint32_t*)ptr;
+		ptr += header->link_count * sizeof(uint32_t);
+		_strings = (const char*)ptr;
+
+		// Everything is used directly from the file so every offset and index has to be checked
+		for (uint32_t i = 0; i < path_count; ++i)
+		{
+			if (_records[i].path >= header->string_size)
+				return false;
+			if (_dependent_offsets[i] > _dependent_offsets[i + 1] || _dependency_offsets[i] > _dependency_offsets[i + 1])
+				return false;
 		}
+		if (_dependent_offsets[path_count] != header->link_count || _dependency_offsets[path_count] != header->link_count)
+			return false;
 
-		// Make sure .builder folder exists
-		_file_source->MakeDirectory(".builder");
+		for (uint32_t l = 0; l < header->link_count; ++l)
+		{
+			if (_dependents[l] >= path_count || _dependencies[l] >= path_count)
+				return false;
+		}
 
-		FileStreamPtr file = _file_source->OpenFile(".builder/dependency_database", File::WRITE);
-		if (!file.Get())
+		_header = header;
+		_file_path_count = path_count;
+		return true;
+	}
+	bool DependencyDatabase::LoadFile()
+	{
+		if (!MapFile())
+			return false;
+
+		// Only the values need copying, links and paths are used directly from the file
+		_entries.resize(_file_path_count);
+		for (uint32_t i = 0; i < _file_path_count; ++i)
 		{
-			logging::Warning("Failed to save dependency database");
+			const FileRecord& record = _records[i];
+			_entries[i].last_modified = record.last_modified;
+			_entries[i].content_hash = record.content_hash;
+			_entries[i].build_key = record.build_key;
+		}
+		return true;
+	}
+	void DependencyDatabase::ReplayJournal()
+	{
+		FileStreamPtr file = _file_source->OpenFile(JOURNAL_FILE, File::READ);
+		if (!file.Get() || file->Length() <= 0)
+			return;
+
+		// Any records appended after a damaged part would be lost, the next save rewrites the
+		//	database instead, which also removes the journal.
+		_journal_damaged = true;
+
+		vector<uint8_t> data((size_t)file->Length());
+		if (file->Read(data.data(), data.size()) != data.size())
+			return;
+
+		const uint8_t* ptr = data.data();
+		const uint8_t* end = ptr + data.size();
+
+		JournalHeader header;
+		if (!ReadValue(ptr, end, header) || header.magic != JOURNAL_MAGIC || header.version != FILE_VERSION
+			|| header.file_id != _header->id)
+		{
+			// Left from an earlier database, the changes it holds are already in the file
+			logging::Warning("Ignoring outdated dependency database journal");
 			return;
 		}
 
-		json::Writer writer;
-		stringstream ss;
-		writer.Write(root, ss, true);
+		// Replay until the end, or until a record that was only partially written
+		string path, dependent_path;
+		while (ptr < end)
+		{
+			uint8_t type;
+			if (!ReadValue(ptr, end, type) || !ReadPath(ptr, end, path))
+				break;
 
-		file->Write(ss.str().c_str(), ss.str().size());
+			if (type == JOURNAL_ENTRY)
+			{
+				FileTime last_modified;
+				uint64_t content_hash, build_key;
+				if (!ReadValue(ptr, end, last_modified) || !ReadValue(ptr, end, content_hash)
+					|| !ReadValue(ptr, end, build_key))
+					break;
+
+				Entry& entry = _entries[InternPath(path)];
+				entry.last_modified = last_modified;
+				entry.content_hash = content_hash;
+				entry.build_key = build_key;
+			}
+			else if (type == JOURNAL_LINK)
+			{
+				if (!ReadPath(ptr, end, dependent_path))
+					break;
 
-		logging::Info("Dependency database successfully saved.");
+				AddLink(InternPath(path), InternPath(dependent_path));
+			}
+			else
+			{
+				break;
+			}
+			++_journal_records;
+		}
+
+		if (ptr != end)
+		{
+			logging::Warning("Dependency database journal is damaged, ignoring the last %u bytes", (uint32_t)(end - ptr));
+			return;
+		}
+		_journal_damaged = false;
 	}
-	bool DependencyDatabase::Load()
+	bool DependencyDatabase::AppendJournal()
 	{
-		Assert(_file_source);
-		ConfigValue root;
+		vector<uint8_t> data;
+		DynamicMemoryStream stream(&data);
 
-		json::Reader reader;
-		if (!reader.ReadFile(_file_source, ".builder/dependency_database", root))
+		FileStreamPtr file = _file_source->OpenFile(JOURNAL_FILE, File::APPEND);
+		if (!file.Get())
 		{
-			logging::Warning("Failed loading dependency database: %s", reader.GetErrorMessage().c_str());
+			logging::Warning("Failed to open dependency database journal");
 			return false;
 		}
 
-		ConfigValue::Iterator it, end;
-		it = root.Begin(); end = root.End();
-		for (; it != end; ++it)
+		if (file->Length() == 0)
+		{
+			JournalHeader header;
+			header.magic = JOURNAL_MAGIC;
+			header.version = FILE_VERSION;
+			header.file_id = _header->id;
+			stream.Write(&header, sizeof(header));
+		}
+
+		uint8_t type = JOURNAL_ENTRY;
+		for (auto id : _dirty)
+		{
+			Entry& entry = _entries[id];
+			stream.Write(&type, 1);
+			WritePath(stream, GetPath(id));
+			stream.Write(&entry.last_modified, sizeof(FileTime));
+			stream.Write(&entry.content_hash, 8);
+			stream.Write(&entry.build_key, 8);
+		}
+
+		type = JOURNAL_LINK;
+		for (auto& link : _new_links)
 		{
-			FileTime last_time;
-			FileTime cur_time;
-			ConfigValue& entry = it->second;
+			stream.Write(&type, 1);
+			WritePath(stream, GetPath(link.first));
+			WritePath(stream, GetPath(link.second));
+		}
 
-			Assert(entry.IsObject());
-			if (!entry.IsObject())
-				continue;
+		// One write, a crash leaves at most one partial record which is skipped on load
+		if (file->Write(data.data(), data.size()) != data.size())
+		{
+			// Whatever made it to the file can't be appended to anymore
+			logging::Warning("Failed to write dependency database journal");
+			_journal_damaged = true;
+			return false;
+		}
 
-			Assert(entry["time"].IsArray());
-			Assert(entry["time"].Size() == 2);
-			last_time.high = entry["time"][0].AsUInt();
-			last_time.low = entry["time"][1].AsUInt();
+		for (auto id : _dirty)
+			_entries[id].dirty = false;
 
-			Assert(entry["dependents"].IsArray());
-			ConfigValue& dependents = entry["dependents"];
-			for (uint32_t i = 0; i < dependents.Size(); ++i)
+		_journal_records += (uint32_t)(_dirty.size() + _new_links.size());
+		_dirty.clear();
+		_new_links.clear();
+		return true;
+	}
+	bool DependencyDatabase::WriteFile()
+	{
+		uint32_t path_count = _file_path_count + (uint32_t)_new_paths.size();
+
+		// Skip files that no longer exist and sort the rest by path, which gives them their new ids
+		vector<uint32_t> order;
+		order.reserve(path_count);
+		for (uint32_t id = 0; id < path_count; ++id)
+		{
+			FileTime file_time;
+			if (_file_source->LastModifiedTime(GetPath(id), file_time))
+				order.push_back(id);
+		}
+		std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b)
+		{
+			return strcmp(GetPath(a), GetPath(b)) < 0;
+		});
+
+		vector<uint32_t> remap(path_count, Invalid<uint32_t>());
+		for (uint32_t i = 0; i < order.size(); ++i)
+			remap[order[i]] = i;
+
+		FileHeader header;
+		header.magic = FILE_MAGIC;
+		header.version = FILE_VERSION;
+		header.id = timer::TickCount();
+		if (_header && header.id == _header->id)
+			++header.id;
+		header.path_count = (uint32_t)order.size();
+		header.padding = 0;
+
+		vector<FileRecord> records(order.size());
+		vector<uint32_t> dependent_offsets, dependents, dependency_offsets, dependencies;
+		string strings;
+
+		// Dependents and dependencies in the file are needed while building the new lists so we
+		//	can't let go of the file until the new one has been written.
+		vector<uint32_t> links;
+		for (uint32_t i = 0; i < order.size(); ++i)
+		{
+			uint32_t id = order[i];
+			const Entry& entry = _entries[id];
+
+			FileRecord& record = records[i];
+			record.path = (uint32_t)strings.size();
+			record.padding = 0;
+			record.last_modified = entry.last_modified;
+			record.content_hash = entry.content_hash;
+			record.build_key = entry.build_key;
+
+			strings += GetPath(id);
+			strings += '\0';
+
+			for (int pass = 0; pass < 2; ++pass)
 			{
-				Assert(dependents[i].IsString());
-				if (!dependents[i].IsString())
-					continue;
+				const uint32_t* offsets = pass == 0 ? _dependent_offsets : _dependency_offsets;
+				const uint32_t* file_links = pass == 0 ? _dependents : _dependencies;
+				const vector<uint32_t>& new_links = pass == 0 ? entry.dependents : entry.dependencies;
+
+				links.clear();
+				if (id < _file_path_count)
+				{
+					for (uint32_t l = offsets[id]; l < offsets[id + 1]; ++l)
+						links.push_back(file_links[l]);
+				}
+				links.insert(links.end(), new_links.begin(), new_links.end());
+
+				vector<uint32_t>& out_offsets = pass == 0 ? dependent_offsets : dependency_offsets;
+				vector<uint32_t>& out_links = pass == 0 ? dependents : dependencies;
+
+				size_t first = out_links.size();
+				out_offsets.push_back((uint32_t)first);
+				for (auto link : links)
+				{
+					if (IsValid(remap[link]))
+						out_links.push_back(remap[link]);
+				}
+				std::sort(out_links.begin() + first, out_links.end());
+			}
+		}
+		dependent_offsets.push_back((uint32_t)dependents.size());
+		dependency_offsets.push_back((uint32_t)dependencies.size());
+		Assert(dependents.size() == dependencies.size());
 
-				AddDependent(it->first.c_str(), dependents[i].AsString());
+		if (strings.empty())
+			strings += '\0';
+
+		header.link_count = (uint32_t)dependents.size();
+		header.string_size = (uint32_t)strings.size();
+
+		string temp_path = string(DATABASE_FILE) + ".tmp";
+		{
+			FileStreamPtr file = _file_source->OpenFile(temp_path.c_str(), File::WRITE);
+			if (!file.Get())
+				return false;
+
+			size_t size = sizeof(header) + records.size() * sizeof(FileRecord)
+				+ (dependent_offsets.size() + dependents.size() + dependency_offsets.size() + dependencies.size()) * sizeof(uint32_t)
+				+ strings.size();
+
+			size_t written = file->Write(&header, sizeof(header));
+			written += file->Write(records.data(), records.size() * sizeof(FileRecord));
+			written += file->Write(dependent_offsets.data(), dependent_offsets.size() * sizeof(uint32_t));
+			written += file->Write(dependents.data(), dependents.size() * sizeof(uint32_t));
+			written += file->Write(dependency_offsets.data(), dependency_offsets.size() * sizeof(uint32_t));
+			written += file->Write(dependencies.data(), dependencies.size() * sizeof(uint32_t));
+			written += file->Write(strings.data(), strings.size());
+			file.Reset();
+
+			if (written != size)
+			{
+				remove(BuildOSPath(temp_path.c_str()).c_str());
+				return false;
 			}
+		}
+
+		// The old file needs to be unmapped before it can be replaced
+		const FileHeader* old_header = _header;
+		uint64_t old_id = old_header ? old_header->id : 0;
+		_header = NULL;
+		_file.Close();
 
-			UpdateModifiedTime(it->first.c_str(), last_time);
+		string full_path = BuildOSPath(DATABASE_FILE);
+		string full_temp_path = BuildOSPath(temp_path.c_str());
+		if (!file_util::RenameFile(full_temp_path.c_str(), full_path.c_str()))
+		{
+			remove(full_temp_path.c_str());
+
+			// Everything not in the old file is still in memory, so nothing is lost as long as the
+			//	old file can be mapped again. The changes are saved with the next Save.
+			if (old_header && (!MapFile() || _header->id != old_id))
+			{
+				logging::Warning("Failed to reload dependency database, changes are lost");
+				Reset();
+			}
+			return false;
 		}
 
-		logging::Info("Dependency database successfully loaded.");
-		return true;
+		Reset();
+		remove(BuildOSPath(JOURNAL_FILE).c_str());
+
+		return LoadFile();
+	}
+	string DependencyDatabase::BuildOSPath(const char* path) const
+	{
+		string full_path = _file_source->GetFullPath();
+		full_path += PATH_SEPARATOR;
+		full_path += path;
+
+		file_util::FixSlashes(full_path);
+		return full_path;
 	}
 	//-------------------------------------------------------------------------------
 
@@ -194,3 +751,4 @@ namespace sb
 
 
 
+
@@ -5,10 +5,22 @@
 
 #include "CompilerSystem.h"
 
+#include <Foundation/Filesystem/FileSource.h>
+#include <Foundation/Filesystem/MappedFile.h>
+
 namespace sb
 {
 
 	class FileSource;
+
+	/// @brief Database of dependencies between source files, and their content hashes and build keys
+	///
+	///	The database is stored in a binary file that is memory mapped and used in place when loaded.
+	///		Paths are stored once in a sorted table and referred to by index, dependents and
+	///		dependencies of each path are stored as ranges of path indices. Changes are kept in
+	///		memory on top of the mapped file.
+	///
+	/// @remark All methods are safe to call from multiple compiler threads at once.
 	class DependencyDatabase
 	{
 	public:
@@ -19,15 +31,25 @@ namespace sb
 		void AddDependent(const char* resource_path, const char* dependent_path);
 		void GetDependents(const char* resource_path, vector<string>& dependents);
 
-		/// Updates the last modified time for a specific file 
-		void UpdateModifiedTime(const char* resource_path, const FileTime& modified_time);
+		/// Retrieves all resources the specified resource depends on, sorted by path
+		void GetDependencies(const char* dependent_path, vector<string>& dependencies);
+
+		/// Retrieves a hash of the contents of the specified source file.
+		///	The hash is kept together with the last modified time of the file and only recalculated
+		///		if the file has been modified since.
+		/// @return False if the file could not be read
+		bool GetContentHash(const char* resource_path, uint64_t& hash);
+
+		/// Sets the build key (a hash of everything going into the compiled resource) from when the
+		///	resource last was built, 0 if it needs to be rebuilt.
+		void SetBuildKey(const char* resource_path, uint64_t key);
 
-		/// Tries to retrieve the last modified time for the specified file
-		/// @return True if file was found, false if not (meaning modified_time is useless).
-		bool GetModifiedTime(const char* resource_path, FileTime& modified_time);
+		/// @return Build key from when the resource last was built, 0 if unknown
+		uint64_t GetBuildKey(const char* resource_path);
 
 
-		/// Saves dependencies to a file on the disk
+		/// Saves changes since the last save to the disk. Changes are appended to a journal and
+		///	only once the journal has grown large the complete database is rewritten.
 		void Save();
 
 		/// Tries to load database from file
@@ -40,18 +62,86 @@ namespace sb
 	private:
 		const DependencyDatabase& operator=(const DependencyDatabase&) { return *this; }
 
-		struct Entry
+		enum
 		{
-			Entry() {}
-			vector<string> dependents;
-			FileTime last_modified;
+			/// Number of journal records allowed, in addition to 1/4th of the number of paths
+			///	in the database, before the database is rewritten.
+			JOURNAL_LIMIT = 1024
 		};
-		typedef map<string, Entry> DependencyMap;
 
-		FileSource* _file_source;
-		DependencyMap _dependencies;
+		struct FileHeader;
+		struct FileRecord;
+
+		/// @brief State of a path, paths are identified by their index
+		///
+		///	Values are copied from the mapped database file on load, dependents and dependencies
+		///		only hold links added since, the rest are in the file.
+		struct Entry
+		{
+			Entry() : content_hash(0), build_key(0), dirty(false) {}
+			vector<uint32_t> dependents;
+			vector<uint32_t> dependencies;
 
+			FileTime last_modified; ///< Modified time of the file when content_hash was calculated
+			uint64_t content_hash; ///< 0 if not calculated
+			uint64_t build_key;
+
+			bool dirty; ///< Values changed since last save
+		};
 
+		/// @remark Methods below assume _lock is held
+
+		/// @return True if the path was found
+		bool FindPath(const string& path, uint32_t& id) const;
+		/// Finds the specified path, adding it if it doesn't exist
+		uint32_t InternPath(const string& path);
+		const char* GetPath(uint32_t id) const;
+
+		/// @return True if the link was added, false if it already existed
+		bool AddLink(uint32_t resource, uint32_t dependent);
+		void MarkDirty(uint32_t id);
+
+		/// Unmaps the database file and clears the in-memory state
+		void Reset();
+		/// Maps the database file and sets up the pointers into it, the in-memory state is left untouched
+		bool MapFile();
+		/// Maps the database file and copies its values
+		bool LoadFile();
+		/// Applies all changes recorded in the journal
+		void ReplayJournal();
+		/// Appends all changes since the last save to the journal
+		///	@return False if the journal couldn't be written, the database needs to be rewritten
+		bool AppendJournal();
+		/// Writes the complete database, including all changes, and clears the journal
+		bool WriteFile();
+
+		string BuildOSPath(const char* path) const;
+
+		FileSource* _file_source;
+		CriticalSection _lock;
+
+		MappedFile _file;
+		const FileHeader* _header; ///< NULL if no file is loaded
+		const FileRecord* _records;
+		const uint32_t* _dependent_offsets;
+		const uint32_t* _dependents;
+		const uint32_t* _dependency_offsets;
+		const uint32_t* _dependencies;
+		const char* _strings;
+		uint32_t _file_path_count;
+
+		vector<Entry> _entries;
+
+		/// Paths not in the database file, ids continue after the ones in the file
+		vector<string> _new_paths;
+		unordered_map<string, uint32_t> _new_path_ids;
+
+		/// Changes since the last save
+		vector<uint32_t> _dirty;
+		vector<pair<uint32_t, uint32_t>> _new_links;
+
+		uint32_t _journal_records;
+		bool _journal_damaged; ///< The journal holds records we couldn't replay, appending to it would lose changes
 	};
 
 } // namespace sb
@@ -59,4 +149,3 @@ namespace sb
 
 
 #endif // __BUILDER_DEPENDENCYDATABASE_H__
-
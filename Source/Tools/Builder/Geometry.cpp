@@ -3,6 +3,7 @@
 #include "Common.h"
 
 #include "Geometry.h"
+#include "JobPool.h"
 
 #include <Foundation/Math/Vec3.h>
 #include <Foundation/Hash/murmur_hash.h>
@@ -41,22 +42,22 @@ namespace sb
 
 
 		/// Converts geometry::Stream::Channel::Semantic to VertexDeclaration semantic and type
-		void GetSemanticAndType(geometry::Stream::Channel::Semantic semantic,
+		void GetSemanticAndType(geometry::Stream::Channel::Semantic semantic, const geometry::QuantizeSettings& quantize,
 			RVertexDeclaration::ElementSemantic& out_semantic, RVertexDeclaration::ElementType& out_type)
 		{
 			switch (semantic)
 			{
 			case geometry::Stream::Channel::POSITION:
 				out_semantic = RVertexDeclaration::ES_POSITION;
-				out_type = RVertexDeclaration::ET_FLOAT3;
+				out_type = quantize.position ? RVertexDeclaration::ET_USHORT4N : RVertexDeclaration::ET_FLOAT3;
 				return;
 			case geometry::Stream::Channel::NORMAL:
 				out_semantic = RVertexDeclaration::ES_NORMAL;
-				out_type = RVertexDeclaration::ET_FLOAT3;
+				out_type = RVertexDeclaration::ET_SHORT2N;
 				return;
 			case geometry::Stream::Channel::TEXCOORD:
 				out_semantic = RVertexDeclaration::ES_TEXCOORD;
-				out_type = RVertexDeclaration::ET_FLOAT2;
+				out_type = quantize.texcoord ? RVertexDeclaration::ET_HALF2 : RVertexDeclaration::ET_FLOAT2;
 				return;
 			case geometry::Stream::Channel::COLOR:
 				out_semantic = RVertexDeclaration::ES_COLOR;
@@ -64,16 +65,83 @@ namespace sb
 				return;
 			case geometry::Stream::Channel::TANGENT:
 				out_semantic = RVertexDeclaration::ES_TANGENT;
-				out_type = RVertexDeclaration::ET_FLOAT3;
+				out_type = RVertexDeclaration::ET_SHORT2N;
 				return;
 			case geometry::Stream::Channel::BINORMAL:
 				out_semantic = RVertexDeclaration::ES_BINORMAL;
-				out_type = RVertexDeclaration::ET_FLOAT3;
+				out_type = RVertexDeclaration::ET_SHORT2N;
 				return;
 			case geometry::Stream::Channel::UNKNOWN:
 				Assert(false);
 			};
 		}
+
+		/// Converts a float to a 16-bit float, rounding to nearest even
+		uint16_t FloatToHalf(float f)
+		{
+			uint32_t x;
+			memory::Memcpy(&x, &f, 4);
+
+			uint32_t sign = (x >> 16) & 0x8000;
+			uint32_t magnitude = x & 0x7fffffff;
+
+			if (magnitude >= 0x7f800000) // Inf or NaN
+				return uint16_t(sign | 0x7c00 | (magnitude > 0x7f800000 ? 0x200 : 0));
+			if (magnitude >= 0x477ff000) // Too large, rounds to infinity
+				return uint16_t(sign | 0x7c00);
+
+			if (magnitude < 0x38800000) // Denormal or zero as half
+			{
+				if (magnitude < 0x33000000)
+					return uint16_t(sign);
+
+				uint32_t mantissa = (magnitude & 0x007fffff) | 0x00800000;
+				uint32_t shift = 126 - (magnitude >> 23);
+				uint32_t half = mantissa >> shift;
+				uint32_t rest = mantissa & ((1u << shift) - 1);
+				uint32_t midpoint = 1u << (shift - 1);
+				if (rest > midpoint || (rest == midpoint && (half & 1)))
+					++half;
+				return uint16_t(sign | half);
+			}
+
+			// Rebias the exponent and round the mantissa, a carry into the exponent is what we want
+			uint32_t half = (magnitude - 0x38000000) >> 13;
+			uint32_t rest = magnitude & 0x1fff;
+			if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+				++half;
+			return uint16_t(sign | half);
+		}
+
+		int16_t FloatToSnorm16(float f)
+		{
+			f = math::ClampFloat(-1.0f, 1.0f, f) * 32767.0f;
+			return int16_t(f >= 0.0f ? f + 0.5f : f - 0.5f);
+		}
+
+		/// Octahedral encoding of a unit vector, the inverse of OctDecode in common.hlsl
+		void OctEncode(const float* v, int16_t* out)
+		{
+			float l1 = fabsf(v[0]) + fabsf(v[1]) + fabsf(v[2]);
+			if (l1 <= 0.0f)
+			{
+				out[0] = out[1] = 0;
+				return;
+			}
+
+			float x = v[0] / l1;
+			float y = v[1] / l1;
+			if (v[2] < 0.0f)
+			{
+				// Fold the lower hemisphere over the diagonals
+				float fx = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+				float fy = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+				x = fx;
+				y = fy;
+			}
+			out[0] = FloatToSnorm16(x);
+			out[1] = FloatToSnorm16(y);
+		}
 	};
 
 
@@ -160,6 +228,9 @@ namespace sb
 							texcoord_stream.stream_offset = channel_it->offset;
 						}
 						break;
+					default:
+						// Not needed for tangent space calculation
+						break;
 					};
 
 				}
@@ -347,12 +418,12 @@ namespace sb
 		uint32_t stream_index = 0;
 
 		bounding_box.max.x = -FLT_MAX;
-		bounding_box.max.x = -FLT_MAX;
-		bounding_box.max.x = -FLT_MAX;
+		bounding_box.max.y = -FLT_MAX;
+		bounding_box.max.z = -FLT_MAX;
 
 		bounding_box.min.x = FLT_MAX;
-		bounding_box.min.x = FLT_MAX;
-		bounding_box.min.x = FLT_MAX;
+		bounding_box.min.y = FLT_MAX;
+		bounding_box.min.z = FLT_MAX;
 
 		// Check if there already is any tangent or binormal streams
 		vector<Stream>::const_iterator stream_it, stream_end;
@@ -384,13 +455,218 @@ namespace sb
 		}
 	}
 
-	void geometry::CompressMesh(geometry::Mesh& mesh)
+	namespace
+	{
+		/// Open addressing hash table of vertices, only stores indices into a vertex buffer owned by the user
+		class VertexTable
+		{
+		public:
+			VertexTable(uint32_t vertex_size) : _vertex_size(vertex_size), _count(0) {}
+
+			/// @param capacity Expected number of vertices
+			void Reserve(uint32_t capacity)
+			{
+				uint32_t size = 16;
+				while (size < capacity + capacity / 2)
+					size *= 2;
+
+				_slots.assign(size, Invalid<uint32_t>());
+				_hashes.assign(size, 0);
+				_count = 0;
+			}
+
+			/// Finds a vertex equal to the specified one, or inserts it as new_index if there is none
+			/// @param vertices Vertex buffer the stored indices refer to
+			/// @return Index of the vertex, new_index if it was inserted
+			uint32_t FindOrInsert(const uint8_t* vertex, uint64_t hash, const uint8_t* vertices, uint32_t new_index)
+			{
+				if ((_count + 1) * 4 > _slots.size() * 3)
+					Grow(vertices);
+
+				uint32_t mask = uint32_t(_slots.size() - 1);
+				for (uint32_t i = uint32_t(hash) & mask;; i = (i + 1) & mask)
+				{
+					if (IsInvalid(_slots[i]))
+					{
+						_slots[i] = new_index;
+						_hashes[i] = hash;
+						++_count;
+						return new_index;
+					}
+
+					// Full comparison, the hash alone isn't trusted
+					if (_hashes[i] == hash && memcmp(vertices + size_t(_slots[i]) * _vertex_size, vertex, _vertex_size) == 0)
+						return _slots[i];
+				}
+			}
+
+		private:
+			void Grow(const uint8_t* vertices)
+			{
+				vector<uint32_t> slots;
+				vector<uint64_t> hashes;
+				slots.swap(_slots);
+				hashes.swap(_hashes);
+
+				_slots.assign(slots.size() * 2, Invalid<uint32_t>());
+				_hashes.assign(slots.size() * 2, 0);
+
+				uint32_t mask = uint32_t(_slots.size() - 1);
+				for (uint32_t s = 0; s < slots.size(); ++s)
+				{
+					if (IsInvalid(slots[s]))
+						continue;
+
+					uint32_t i = uint32_t(hashes[s]) & mask;
+					while (!IsInvalid(_slots[i]))
+						i = (i + 1) & mask;
+
+					_slots[i] = slots[s];
+					_hashes[i] = hashes[s];
+				}
+			}
+
+			uint32_t _vertex_size;
+			uint32_t _count;
+			vector<uint32_t> _slots;
+			vector<uint64_t> _hashes;
+		};
+
+		/// Returns the grid cell containing the coordinate, clamped to keep the conversion defined
+		int64_t WeldCell(float coordinate, float cell_size)
+		{
+			double cell = floor(double(coordinate) / cell_size);
+			if (!(cell > -4e18))
+				cell = -4e18;
+			if (!(cell < 4e18))
+				cell = 4e18;
+			return int64_t(cell);
+		}
+
+		/// Welds positions closer than epsilon together, each position is replaced with the nearest earlier
+		///	position in the stream that is within epsilon. Positions are bucketed in a grid of epsilon sized
+		///	cells, so only the neighbouring cells have to be searched.
+		void WeldPositions(geometry::Stream& stream, uint32_t position_offset, float epsilon)
+		{
+			uint32_t vertex_count = uint32_t(stream.data.size() / stream.stride);
+			float max_distance_sq = epsilon * epsilon;
+
+			// Cells are found by the hash of their coordinates, a collision only adds candidates to the search
+			unordered_map<uint64_t, uint32_t> cells; // Cell => last position kept in the cell
+			cells.reserve(vertex_count);
+			vector<uint32_t> next(vertex_count, Invalid<uint32_t>()); // Previous position kept in the same cell
+
+			for (uint32_t v = 0; v < vertex_count; ++v)
+			{
+				float* position = (float*)&stream.data[size_t(v) * stream.stride + position_offset];
+
+				int64_t cell[3];
+				for (uint32_t k = 0; k < 3; ++k)
+					cell[k] = WeldCell(position[k], epsilon);
+
+				const float* nearest = nullptr;
+				float nearest_distance_sq = max_distance_sq;
+				for (int64_t z = cell[2] - 1; z <= cell[2] + 1; ++z)
+				{
+					for (int64_t y = cell[1] - 1; y <= cell[1] + 1; ++y)
+					{
+						for (int64_t x = cell[0] - 1; x <= cell[0] + 1; ++x)
+						{
+							int64_t neighbour[3] = { x, y, z };
+							unordered_map<uint64_t, uint32_t>::iterator it = cells.find(murmur_hash_64(neighbour, sizeof(neighbour), 0));
+							if (it == cells.end())
+								continue;
+
+							for (uint32_t r = it->second; !IsInvalid(r); r = next[r])
+							{
+								const float* candidate = (const float*)&stream.data[size_t(r) * stream.stride + position_offset];
+								float dx = candidate[0] - position[0];
+								float dy = candidate[1] - position[1];
+								float dz = candidate[2] - position[2];
+								float distance_sq = dx * dx + dy * dy + dz * dz;
+								if (distance_sq <= nearest_distance_sq)
+								{
+									nearest = candidate;
+									nearest_distance_sq = distance_sq;
+								}
+							}
+						}
+					}
+				}
+
+				if (nearest)
+				{
+					memcpy(position, nearest, 3 * sizeof(float));
+					continue;
+				}
+
+				// No position close enough, this one is kept and other positions may weld to it
+				pair<unordered_map<uint64_t, uint32_t>::iterator, bool> result =
+					cells.insert(pair<uint64_t, uint32_t>(murmur_hash_64(cell, sizeof(cell), 0), v));
+				if (!result.second)
+				{
+					next[v] = result.first->second;
+					result.first->second = v;
+				}
+			}
+		}
+
+		/// Range of indices of a mesh, deduplicated on its own before being merged with the other chunks
+		struct CompressChunk
+		{
+			const geometry::Mesh* mesh;
+			uint32_t vertex_size;
+
+			uint32_t begin, end;
+
+			vector<uint8_t> vertices; ///< Unique vertices in this chunk, in the order they are first used
+			vector<uint64_t> hashes;
+			vector<uint32_t> indices; ///< Indices into vertices, one for each index in [begin, end)
+		};
+
+		void CompressChunkJob(void* data, uint32_t index)
+		{
+			CompressChunk& chunk = ((CompressChunk*)data)[index];
+			const geometry::Mesh& mesh = *chunk.mesh;
+
+			VertexTable table(chunk.vertex_size);
+			table.Reserve((chunk.end - chunk.begin) / 4);
+
+			vector<uint8_t> vertex(chunk.vertex_size);
+			chunk.indices.resize(chunk.end - chunk.begin);
+
+			uint32_t vertex_count = 0;
+			for (uint32_t i = chunk.begin; i < chunk.end; ++i)
+			{
+				// Build the vertex for this index
+				uint32_t offset = 0;
+				for (uint32_t stream_idx = 0; stream_idx < mesh.streams.size(); ++stream_idx)
+				{
+					const geometry::Stream& data_stream = mesh.streams[stream_idx];
+					uint32_t old_index = mesh.index_streams[stream_idx].indices[i];
+
+					memory::Memcpy(vertex.data() + offset, &data_stream.data[old_index * data_stream.stride], data_stream.stride);
+					offset += data_stream.stride;
+				}
+
+				uint64_t hash = murmur_hash_64(vertex.data(), chunk.vertex_size, 0);
+				uint32_t index = table.FindOrInsert(vertex.data(), hash, chunk.vertices.data(), vertex_count);
+				if (index == vertex_count)
+				{
+					chunk.vertices.insert(chunk.vertices.end(), vertex.begin(), vertex.end());
+					chunk.hashes.push_back(hash);
+					++vertex_count;
+				}
+				chunk.indices[i - chunk.begin] = index;
+			}
+		}
+	}
+
+	void geometry::CompressMesh(geometry::Mesh& mesh, const CompressSettings& settings, JobPool* job_pool)
 	{
 		Stream new_stream;
 		IndexStream new_index_stream;
 
-		map<uint64_t, uint32_t> hash_to_index; // Maps a vertex hash to a index for the index stream
-
 		uint32_t vertex_size = 0; // For holding the total size (in bytes) of the final vertex
 
 		vector<Stream>::iterator stream_it, stream_end;
@@ -401,6 +677,10 @@ namespace sb
 			channel_it = stream_it->channels.begin(); channel_end = stream_it->channels.end();
 			for (; channel_it != channel_end; ++channel_it)
 			{
+				// Welded before deduplicating, welded vertices then have identical positions
+				if (channel_it->semantic == Stream::Channel::POSITION && settings.weld_epsilon > 0.0f)
+					WeldPositions(*stream_it, channel_it->offset, settings.weld_epsilon);
+
 				new_stream.channels.push_back(*channel_it);
 				new_stream.channels.back().offset = vertex_size;
 				vertex_size += SemanticSize(channel_it->semantic);
@@ -409,45 +689,66 @@ namespace sb
 
 		new_stream.stride = vertex_size;
 
-		LinearAllocatorWithBuffer<128> temp_alloc;
-		uint8_t* tmp_vertex = (uint8_t*)temp_alloc.Allocate(vertex_size);
+		// Chunks are deduplicated in parallel, small meshes aren't worth the threads
+		const uint32_t min_chunk_size = 65536;
 
-		uint32_t new_index = 0;
-		for (uint32_t i = 0; i < mesh.index_count; ++i)
+		uint32_t thread_count = settings.thread_count;
+		if (thread_count == 0)
+			thread_count = job_pool ? job_pool->GetThreadCount() + 1 : 1;
+		uint32_t chunk_count = Max(Min(thread_count, mesh.index_count / min_chunk_size), 1u);
+
+		vector<CompressChunk> chunks(chunk_count);
+		for (uint32_t c = 0; c < chunk_count; ++c)
 		{
-			uint32_t tmp_offset = 0; // Offset for filling the temp vertex
-			// Build the vertex for this index
-			for (uint32_t stream_idx = 0; stream_idx < mesh.streams.size(); ++stream_idx)
-			{
-				Stream& data_stream = mesh.streams[stream_idx];
-				IndexStream& index_stream = mesh.index_streams[stream_idx];
+			CompressChunk& chunk = chunks[c];
+			chunk.mesh = &mesh;
+			chunk.vertex_size = vertex_size;
+			chunk.begin = uint32_t(uint64_t(mesh.index_count) * c / chunk_count);
+			chunk.end = uint32_t(uint64_t(mesh.index_count) * (c + 1) / chunk_count);
+		}
 
-				uint32_t old_index = index_stream.indices[i];
+		if (job_pool)
+		{
+			job_pool->Run(CompressChunkJob, chunks.data(), chunk_count);
+		}
+		else
+		{
+			for (uint32_t c = 0; c < chunk_count; ++c)
+				CompressChunkJob(chunks.data(), c);
+		}
 
-				memory::Memcpy(tmp_vertex + tmp_offset, &data_stream.data[old_index*data_stream.stride], data_stream.stride);
-				tmp_offset += data_stream.stride;
-			}
+		// Merge the chunks in order, giving the same vertex order as deduplicating the whole mesh at once
+		VertexTable table(vertex_size);
+		table.Reserve(uint32_t(chunks[0].hashes.size()) * chunk_count);
 
-			// Find any duplicate versions of the newly built vertex
-			uint64_t h = murmur_hash_64(tmp_vertex, vertex_size, 0);
-			map<uint64_t, uint32_t>::iterator map_it = hash_to_index.find(h);
-			if (map_it != hash_to_index.end())
+		new_index_stream.indices.resize(mesh.index_count);
+
+		uint32_t new_index = 0;
+		vector<uint32_t> remap;
+		for (auto& chunk : chunks)
+		{
+			uint32_t chunk_vertex_count = (uint32_t)chunk.hashes.size();
+			remap.resize(chunk_vertex_count);
+
+			for (uint32_t v = 0; v < chunk_vertex_count; ++v)
 			{
-				// Duplicate found
-				new_index_stream.indices.push_back(map_it->second);
-				continue;
-			}
+				const uint8_t* vertex = chunk.vertices.data() + size_t(v) * vertex_size;
 
-			// Insert vertex
-			uint32_t offset = (uint32_t)new_stream.data.size();
-			new_stream.data.resize(offset + vertex_size);
-			memory::Memcpy(new_stream.data.data() + offset, tmp_vertex, vertex_size);
+				uint32_t index = table.FindOrInsert(vertex, chunk.hashes[v], new_stream.data.data(), new_index);
+				if (index == new_index)
+				{
+					new_stream.data.insert(new_stream.data.end(), vertex, vertex + vertex_size);
+					++new_index;
+				}
+				remap[v] = index;
+			}
 
-			new_index_stream.indices.push_back(new_index);
-			// Add to map
-			hash_to_index[h] = new_index;
+			for (uint32_t i = chunk.begin; i < chunk.end; ++i)
+				new_index_stream.indices[i] = remap[chunk.indices[i - chunk.begin]];
 
-			++new_index;
+			// Release the chunk as soon as possible, large meshes need a lot of memory here
+			vector<uint8_t>().swap(chunk.vertices);
+			vector<uint32_t>().swap(chunk.indices);
 		}
 
 		mesh.streams.clear();
@@ -459,7 +760,7 @@ namespace sb
 
 
 
-	bool geometry::Convert(const geometry::Mesh& mesh, MeshData& mesh_data)
+	bool geometry::Convert(const geometry::Mesh& mesh, const QuantizeSettings& quantize, MeshData& mesh_data)
 	{
 		// In MeshData the data is assumed to be merged into a single vertex stream (or rather vertex stream + index stream)
 		if (mesh.streams.size() != 1 || mesh.index_streams.size() != 1)
@@ -467,42 +768,125 @@ namespace sb
 			return false;
 		}
 
+		const Stream& stream = mesh.streams[0];
+
+		CalculateBounds(mesh, mesh_data.bounding_box);
+
+		// Positions are stored relative to the bounding box. The scale is the same for all axes,
+		//	otherwise dequantizing in the world matrix would skew the normals.
+		mesh_data.position_offset = Vec3f::ZERO;
+		mesh_data.position_scale = 1.0f;
+		if (quantize.position)
+		{
+			const AABB& bounds = mesh_data.bounding_box;
+			float extent = Max(Max(bounds.max.x - bounds.min.x, bounds.max.y - bounds.min.y), bounds.max.z - bounds.min.z);
+
+			mesh_data.position_offset = bounds.min;
+			mesh_data.position_scale = (extent > 0.0f) ? extent : 1.0f;
+		}
+
 		// Build vertex declaration
 		mesh_data.vertex_declaration.Clear();
 
-		for (auto& channel : mesh.streams[0].channels)
+		for (auto& channel : stream.channels)
 		{
 			RVertexDeclaration::Element element;
 			element.slot = 0;
-			GetSemanticAndType(channel.semantic, element.semantic, element.type);
+			GetSemanticAndType(channel.semantic, quantize, element.semantic, element.type);
 			element.sem_index = channel.sem_index;
 
 			mesh_data.vertex_declaration.AddElement(element);
 		}
 
-		uint32_t vertex_buffer_size = (uint32_t)mesh.streams[0].data.size();
+		uint32_t vertex_size = mesh_data.vertex_declaration.VertexSize();
+		uint32_t vertex_count = (uint32_t)stream.data.size() / stream.stride;
+		uint32_t vertex_buffer_size = vertex_size * vertex_count;
 
 		VertexBufferDesc vb_desc;
-		vb_desc.vertex_size = mesh.streams[0].stride;
-		vb_desc.vertex_count = vertex_buffer_size / mesh.streams[0].stride;
+		vb_desc.vertex_size = vertex_size;
+		vb_desc.vertex_count = vertex_count;
 		vb_desc.usage = hardware_buffer::IMMUTABLE;
 		mesh_data.vertex_buffer = RVertexBuffer(vb_desc);
 
+		// All levels of detail share the index buffer, the full detail mesh first
+		uint32_t index_count = mesh.index_count;
+		for (auto& lod : mesh.lods)
+			index_count += (uint32_t)lod.indices.size();
+
 		IndexBufferDesc ib_desc;
 		ib_desc.index_format = index_buffer::INDEX_32; // TODO: Is it worth using 16-bit for smaller meshes?
-		ib_desc.index_count = mesh.index_count;
+		ib_desc.index_count = index_count;
 		ib_desc.usage = hardware_buffer::IMMUTABLE;
 		mesh_data.index_buffer = RIndexBuffer(ib_desc);
 
-		// Copy vertex and index data
+		// Convert vertex data and copy index data
 		mesh_data.vertex_data.resize(vertex_buffer_size);
-		memory::Memcpy(mesh_data.vertex_data.data(), mesh.streams[0].data.data(), vertex_buffer_size);
 
-		mesh_data.index_data.resize(mesh.index_count * sizeof(uint32_t));
+		float inv_scale = 1.0f / mesh_data.position_scale;
+		for (uint32_t v = 0; v < vertex_count; ++v)
+		{
+			const uint8_t* src_vertex = stream.data.data() + v * stream.stride;
+			uint8_t* dst = mesh_data.vertex_data.data() + v * vertex_size;
+
+			for (uint32_t c = 0; c < stream.channels.size(); ++c)
+			{
+				const float* src = (const float*)(src_vertex + stream.channels[c].offset);
+				RVertexDeclaration::ElementType type = mesh_data.vertex_declaration.GetElement(c).type;
+
+				switch (type)
+				{
+				case RVertexDeclaration::ET_USHORT4N:
+				{
+					const float* offset = &mesh_data.position_offset.x;
+
+					uint16_t q[4];
+					for (uint32_t k = 0; k < 3; ++k)
+					{
+						float f = math::ClampFloat(0.0f, 1.0f, (src[k] - offset[k]) * inv_scale);
+						q[k] = uint16_t(f * 65535.0f + 0.5f);
+					}
+					q[3] = 0xffff; // w = 1
+					memory::Memcpy(dst, q, sizeof(q));
+					dst += sizeof(q);
+				}
+				break;
+				case RVertexDeclaration::ET_SHORT2N:
+				{
+					int16_t q[2];
+					OctEncode(src, q);
+					memory::Memcpy(dst, q, sizeof(q));
+					dst += sizeof(q);
+				}
+				break;
+				case RVertexDeclaration::ET_HALF2:
+				{
+					uint16_t h[2] = { FloatToHalf(src[0]), FloatToHalf(src[1]) };
+					memory::Memcpy(dst, h, sizeof(h));
+					dst += sizeof(h);
+				}
+				break;
+				default:
+				{
+					uint32_t size = SemanticSize(stream.channels[c].semantic);
+					memory::Memcpy(dst, src, size);
+					dst += size;
+				}
+				break;
+				};
+			}
+		}
+
+		mesh_data.index_data.resize(index_count * sizeof(uint32_t));
 		memory::Memcpy(mesh_data.index_data.data(), mesh.index_streams[0].indices.data(), mesh.index_count * sizeof(uint32_t));
 
 		uint32_t sub_mesh_offset = 0;
 
+		MeshData::Lod lod_data;
+		lod_data.first_submesh = 0;
+		lod_data.submesh_count = (uint32_t)mesh.sub_meshes.size();
+		lod_data.screen_size = 1.0f;
+		mesh_data.lods.push_back(lod_data);
+
 		for (auto& sub_mesh : mesh.sub_meshes)
 		{
 			MeshData::SubMesh sub_mesh_data;
@@ -515,7 +899,30 @@ namespace sb
 			mesh_data.submeshes.push_back(sub_mesh_data);
 		}
 
-		CalculateBounds(mesh, mesh_data.bounding_box);
+		// Lower levels of detail use the same materials as the full detail mesh
+		for (auto& lod : mesh.lods)
+		{
+			Assert(lod.sub_mesh_counts.size() == mesh.sub_meshes.size());
+
+			memory::Memcpy(mesh_data.index_data.data() + sub_mesh_offset * sizeof(uint32_t), lod.indices.data(),
+				lod.indices.size() * sizeof(uint32_t));
+
+			lod_data.first_submesh = (uint32_t)mesh_data.submeshes.size();
+			lod_data.submesh_count = (uint32_t)lod.sub_mesh_counts.size();
+			lod_data.screen_size = lod.screen_size;
+			mesh_data.lods.push_back(lod_data);
+
+			for (uint32_t i = 0; i < lod.sub_mesh_counts.size(); ++i)
+			{
+				MeshData::SubMesh sub_mesh_data;
+				sub_mesh_data.material_index = i;
+				sub_mesh_data.offset = sub_mesh_offset;
+				sub_mesh_data.size = lod.sub_mesh_counts[i];
+				sub_mesh_offset += lod.sub_mesh_counts[i];
+
+				mesh_data.submeshes.push_back(sub_mesh_data);
+			}
+		}
 
 		return true;
 	}
@@ -8,6 +8,8 @@
 namespace sb
 {
 
+	class JobPool;
+
 	namespace geometry
 	{
 
@@ -53,6 +55,38 @@ namespace sb
 			uint32_t index_count; // Number of indices in the index streams that belong to this sub mesh
 		};
 
+		/// Vertex formats used when converting a mesh to engine format
+		///	Normals, tangents and binormals are always stored octahedral encoded in 2x16 bits.
+		struct QuantizeSettings
+		{
+			QuantizeSettings() : position(true), texcoord(true) {}
+
+			bool position; ///< 16-bit positions relative to the bounding box, see MeshData::position_offset
+			bool texcoord; ///< Half-float texture coordinates
+		};
+
+		struct CompressSettings
+		{
+			CompressSettings() : weld_epsilon(0.0f), thread_count(0) {}
+
+			/// Vertices with positions closer than this distance are welded, the position is replaced with
+			///	the nearest earlier position within the distance. 0 only merges vertices that are exactly equal.
+			float weld_epsilon;
+
+			/// Maximum number of chunks deduplicated in parallel, 0 for one per thread in the job pool
+			uint32_t thread_count;
+		};
+
+		/// Level of detail, a simplified version of the triangle list of a mesh using the same vertices
+		struct Lod
+		{
+			Lod() : screen_size(0.0f) {}
+
+			float screen_size; ///< See LodSettings::screen_size
+			vector<uint32_t> indices;
+			vector<uint32_t> sub_mesh_counts; ///< Number of indices for each sub mesh
+		};
+
 		struct Mesh
 		{
 			enum PrimitiveType
@@ -69,6 +103,8 @@ namespace sb
 			uint32_t index_count; // Number of indices (e.g. 3 for a triangle, 6 for 2 triangles, etc)
 
 			vector<SubMesh> sub_meshes;
+
+			vector<Lod> lods; ///< Lower levels of detail, the full detail mesh is not included
 		};
 
 
@@ -80,11 +116,13 @@ namespace sb
 		void CalculateBounds(const geometry::Mesh& mesh, AABB& bounding_box);
 
 		/// Compresses the specified mesh, merging all streams and calculating new indices
-		void CompressMesh(geometry::Mesh& mesh);
+		///	Duplicate vertices are merged, the resulting vertices are in the order they are first used.
+		///	@param job_pool Pool for deduplicating large meshes in parallel, NULL runs on the calling thread only
+		void CompressMesh(geometry::Mesh& mesh, const CompressSettings& settings = CompressSettings(), JobPool* job_pool = NULL);
 
 		/// Converts a Mesh-object into engine-format MeshData
 		/// @return True if convertion was successful, false if failed
-		bool Convert(const geometry::Mesh& mesh, MeshData& mesh_data);
+		bool Convert(const geometry::Mesh& mesh, const QuantizeSettings& quantize, MeshData& mesh_data);
 
 	};
 
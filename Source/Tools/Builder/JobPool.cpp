@@ -0,0 +1,125 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "JobPool.h"
+
+#include <algorithm>
+
+namespace sb
+{
+
+	JobPool::JobPool(uint32_t thread_count)
+		: _stop(0)
+	{
+		for (uint32_t i = 0; i < thread_count; ++i)
+		{
+			_threads.push_back(new SimpleThread());
+			_threads.back()->Start(ThreadMain, this);
+		}
+	}
+	JobPool::~JobPool()
+	{
+		Assert(_batches.empty());
+
+		thread::InterlockedExchange(&_stop, 1);
+		for (uint32_t i = 0; i < _threads.size(); ++i)
+		{
+			_work_semaphore.Set();
+		}
+		for (SimpleThread* thread : _threads)
+		{
+			thread->Join();
+			delete thread;
+		}
+	}
+	void JobPool::Run(JobFunction function, void* data, uint32_t count)
+	{
+		if (_threads.empty() || count < 2)
+		{
+			for (uint32_t i = 0; i < count; ++i)
+				function(data, i);
+			return;
+		}
+
+		Batch batch;
+		batch.function = function;
+		batch.data = data;
+		batch.count = count;
+		batch.next = 0;
+		batch.remaining = count;
+		{
+			ScopedLock<CriticalSection> lock(_lock);
+			_batches.push_back(&batch);
+		}
+
+		// The calling thread takes a job as well
+		uint32_t wake_count = Min(count - 1, (uint32_t)_threads.size());
+		for (uint32_t i = 0; i < wake_count; ++i)
+		{
+			_work_semaphore.Set();
+		}
+
+		// Only help out with our own jobs, jobs from other batches could keep us busy long after ours are done
+		uint32_t index;
+		while (TakeJob(&batch, index))
+		{
+			RunJob(&batch, index);
+		}
+		batch.done.Wait();
+	}
+	uint32_t JobPool::GetThreadCount() const
+	{
+		return (uint32_t)_threads.size();
+	}
+	//-------------------------------------------------------------------------------
+	bool JobPool::TakeAnyJob(Batch*& batch, uint32_t& index)
+	{
+		ScopedLock<CriticalSection> lock(_lock);
+		if (_batches.empty())
+			return false;
+
+		batch = _batches.front();
+		index = batch->next++;
+		if (batch->next == batch->count)
+			_batches.erase(_batches.begin());
+		return true;
+	}
+	bool JobPool::TakeJob(Batch* batch, uint32_t& index)
+	{
+		ScopedLock<CriticalSection> lock(_lock);
+		if (batch->next == batch->count)
+			return false;
+
+		index = batch->next++;
+		if (batch->next == batch->count)
+			_batches.erase(std::find(_batches.begin(), _batches.end(), batch));
+		return true;
+	}
+	void JobPool::RunJob(Batch* batch, uint32_t index)
+	{
+		batch->function(batch->data, index);
+
+		// The batch lives on the stack of the thread waiting for it, don't touch it after this
+		if (thread::InterlockedDecrement(&batch->remaining) == 0)
+			batch->done.Set();
+	}
+	void JobPool::ThreadMain(void* data)
+	{
+		JobPool* pool = (JobPool*)data;
+		while (true)
+		{
+			pool->_work_semaphore.Wait();
+			if (pool->_stop)
+				break;
+
+			Batch* batch;
+			uint32_t index;
+			while (pool->TakeAnyJob(batch, index))
+			{
+				pool->RunJob(batch, index);
+			}
+		}
+	}
+
+} // namespace sb
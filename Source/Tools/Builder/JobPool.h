@@ -0,0 +1,71 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __BUILDER_JOBPOOL_H__
+#define __BUILDER_JOBPOOL_H__
+
+#include <Foundation/Thread/Thread.h>
+#include <Foundation/Thread/Lock.h>
+#include <Foundation/Thread/Event.h>
+#include <Foundation/Thread/Semaphore.h>
+
+namespace sb
+{
+
+	/// @brief Threads shared by all compilers for splitting up the work on a single asset
+	///
+	///	Compilers already run one asset per worker, so rather than starting threads of their own,
+	///		which gives one thread per processor for each worker, they hand their parallel work to
+	///		this pool. The calling thread works on its own jobs while waiting, so the pool can be
+	///		used from any number of compiler workers at once.
+	class JobPool
+	{
+	public:
+		typedef void(*JobFunction)(void* data, uint32_t index);
+
+		/// @param thread_count Number of threads in the pool, 0 runs all jobs on the calling thread
+		JobPool(uint32_t thread_count);
+		~JobPool();
+
+		/// @brief Runs function for every index in [0, count) and returns when all are done
+		void Run(JobFunction function, void* data, uint32_t count);
+
+		/// @return Number of threads in the pool, not counting the calling thread
+		uint32_t GetThreadCount() const;
+
+	private:
+		const JobPool& operator=(const JobPool&) { return *this; }
+
+		struct Batch
+		{
+			JobFunction function;
+			void* data;
+			uint32_t count;
+			uint32_t next; ///< Next index to hand out, protected by _lock
+			volatile long remaining; ///< Jobs not yet finished
+			Event done;
+		};
+
+		/// @brief Takes the next job of the first batch in the queue
+		///	@return False if there was nothing to do
+		bool TakeAnyJob(Batch*& batch, uint32_t& index);
+
+		/// @brief Takes the next job of the specified batch
+		///	@return False if all jobs of the batch are taken
+		bool TakeJob(Batch* batch, uint32_t& index);
+
+		void RunJob(Batch* batch, uint32_t index);
+
+		static void ThreadMain(void* data);
+
+		CriticalSection _lock;
+		vector<Batch*> _batches; ///< Batches with jobs left to hand out
+
+		Semaphore _work_semaphore;
+		vector<SimpleThread*> _threads;
+		volatile long _stop;
+	};
+
+} // namespace sb
+
+
+#endif // __BUILDER_JOBPOOL_H__
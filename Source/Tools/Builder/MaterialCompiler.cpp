@@ -34,7 +34,7 @@ namespace sb
 			return CompilerSystem::FAILED;
 		}
 
-		ConfigValue& tex_node = material_node["textures"];
+		const ConfigValue& tex_node = material_node["textures"];
 		if (tex_node.IsObject())
 		{
 			ConfigValue::ConstIterator it, end;
@@ -65,6 +65,7 @@ namespace sb
 
 			if (shader_node["name"].IsString())
 			{
+				ScopedLock<CriticalSection> lock(context.shader_database->GetLock());
 				if (!context.shader_database->PreloadPermutation(shader_node["name"].AsString(), options))
 				{
 					SetError("Failed to preload shader.");
@@ -104,6 +105,10 @@ namespace sb
 
 		return CompilerSystem::SUCCESSFUL;
 	}
+	bool MaterialCompiler::IsCacheable() const
+	{
+		return false;
+	}
 	void MaterialCompiler::ParseShaderVariables(const ConfigValue& variables, MaterialData& material_data)
 	{
 		if (!variables.IsArray())
@@ -17,6 +17,9 @@ namespace sb
 
 		CompilerSystem::Result Compile(const FilePath& source_file, const FilePath& target_file, const CompilerSystem::CompilerContext& context);
 
+		/// Materials request shader permutations while compiling so they can't be restored from the build cache
+		bool IsCacheable() const;
+
 
 	private:
 		void ParseShaderVariables(const ConfigValue& variables, MaterialData& material_data);
@@ -15,6 +15,18 @@ namespace sb
 	MeshCompiler::MeshCompiler(const ConfigValue& config)
 		: CompilerSystem::Compiler(config)
 	{
+		ParseSettings(config, _settings);
+
+		const ConfigValue& mesh_settings = config["mesh_settings"];
+		if (mesh_settings.IsObject())
+		{
+			for (ConfigValue::ConstIterator it = mesh_settings.Begin(); it != mesh_settings.End(); ++it)
+			{
+				Settings& settings = _mesh_settings[it->first];
+				settings = _settings;
+				ParseSettings(it->second, settings);
+			}
+		}
 	}
 	MeshCompiler::~MeshCompiler()
 	{
@@ -43,11 +55,21 @@ namespace sb
 		geometry::Mesh mesh;
 		collada.Convert(mesh);
 
+		const Settings& settings = GetSettings(source_file);
+
 		geometry::CalculateTangents(mesh);
-		geometry::CompressMesh(mesh);
+		geometry::CompressMesh(mesh, settings.compress, context.job_pool);
+
+		geometry::OptimizeStats optimize_stats;
+		geometry::OptimizeMesh(mesh, settings.optimize, optimize_stats);
+		logging::Info("Mesh '%s': ACMR %.3f -> %.3f", source_file.c_str(), optimize_stats.acmr_before, optimize_stats.acmr_after);
+
+		geometry::GenerateLods(mesh, settings.lods);
+		if (!mesh.lods.empty())
+			logging::Info("Mesh '%s': %d level(s) of detail", source_file.c_str(), (int)mesh.lods.size());
 
 		MeshData mesh_data;
-		geometry::Convert(mesh, mesh_data);
+		geometry::Convert(mesh, settings.quantize, mesh_data);
 
 		// Also create material resource files in the same folder as the mesh, given they doesn't already exist
 		//	As the material files will be stored in the same folder as the mesh we need to modify the material name.
@@ -82,6 +104,46 @@ namespace sb
 
 		return CompilerSystem::SUCCESSFUL;
 	}
+	uint32_t MeshCompiler::GetVersion() const
+	{
+		return 4; // 2: Optimized index and vertex order, 3: Quantized vertices, 4: Levels of detail
+	}
+	void MeshCompiler::ParseSettings(const ConfigValue& config, Settings& settings)
+	{
+		const ConfigValue& compress = config["compress"];
+		if (compress["weld_epsilon"].IsNumber())
+			settings.compress.weld_epsilon = compress["weld_epsilon"].AsFloat();
+
+		geometry::ParseOptimizeSettings(config["optimize"], settings.optimize);
+
+		const ConfigValue& quantize = config["quantize"];
+		if (quantize["position"].IsBool())
+			settings.quantize.position = quantize["position"].AsBool();
+		if (quantize["texcoord"].IsBool())
+			settings.quantize.texcoord = quantize["texcoord"].AsBool();
+
+		const ConfigValue& lods = config["lods"];
+		if (lods.IsArray())
+		{
+			settings.lods.clear();
+			for (uint32_t i = 0; i < lods.Size(); ++i)
+			{
+				geometry::LodSettings lod;
+				if (lods[i]["ratio"].IsNumber())
+					lod.ratio = lods[i]["ratio"].AsFloat();
+				if (lods[i]["screen_size"].IsNumber())
+					lod.screen_size = lods[i]["screen_size"].AsFloat();
+				settings.lods.push_back(lod);
+			}
+		}
+	}
+	const MeshCompiler::Settings& MeshCompiler::GetSettings(const FilePath& source_file) const
+	{
+		map<string, Settings>::const_iterator it = _mesh_settings.find(source_file.c_str());
+		if (it != _mesh_settings.end())
+			return it->second;
+		return _settings;
+	}
 
 } // namespace sb
 
@@ -4,10 +4,21 @@
 #define __BUILDER_MESHCOMPILER_H__
 
 #include "CompilerSystem.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
 
 namespace sb
 {
 
+	/// Compiles Collada files into meshes
+	///
+	///	The mesh is optimized according to "optimize" (see geometry::OptimizeSettings) and the vertices
+	///		quantized according to "quantize" (see geometry::QuantizeSettings) in the compiler config.
+	///		Vertices closer than "compress.weld_epsilon" are welded together (see geometry::CompressSettings).
+	///		Levels of detail are generated from "lods", an array of geometry::LodSettings,
+	///		e.g. lods = [ { ratio = 0.5 screen_size = 0.3 } { ratio = 0.25 screen_size = 0.15 } ]
+	///		Settings for specific meshes can be overridden in "mesh_settings",
+	///		e.g. mesh_settings = { "Models/skybox.dae" = { optimize = { overdraw = false } } }
 	class MeshCompiler : public CompilerSystem::Compiler
 	{
 	public:
@@ -15,11 +26,25 @@ namespace sb
 		~MeshCompiler();
 
 		CompilerSystem::Result Compile(const FilePath& source_file, const FilePath& target_file, const CompilerSystem::CompilerContext& context);
+		uint32_t GetVersion() const;
 
 
 	private:
+		struct Settings
+		{
+			geometry::CompressSettings compress;
+			geometry::OptimizeSettings optimize;
+			geometry::QuantizeSettings quantize;
+			vector<geometry::LodSettings> lods;
+		};
 
+		/// Parses settings, any values not specified in the config are left untouched
+		static void ParseSettings(const ConfigValue& config, Settings& settings);
 
+		const Settings& GetSettings(const FilePath& source_file) const;
+
+		Settings _settings;
+		map<string, Settings> _mesh_settings;
 	};
 
 } // namespace sb
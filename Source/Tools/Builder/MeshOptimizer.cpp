@@ -0,0 +1,472 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "MeshOptimizer.h"
+
+#include <Foundation/Container/ConfigValue.h>
+
+#include <algorithm>
+#include <math.h>
+
+namespace sb
+{
+
+	namespace
+	{
+		// Constants from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+		const uint32_t FORSYTH_CACHE_SIZE = 32;
+		const float CACHE_DECAY_POWER = 1.5f;
+		const float LAST_TRIANGLE_SCORE = 0.75f;
+		const float VALENCE_BOOST_SCALE = 2.0f;
+		const float VALENCE_BOOST_POWER = 0.5f;
+
+		float VertexScore(int cache_position, uint32_t remaining)
+		{
+			if (remaining == 0)
+				return -1.0f; // Not used by any triangle left to emit
+
+			float score = 0.0f;
+			if (cache_position >= 0)
+			{
+				if (cache_position < 3)
+				{
+					// Vertices of the last triangle get a fixed score, otherwise we would favour
+					//	emitting triangles sharing the same edge over and over.
+					score = LAST_TRIANGLE_SCORE;
+				}
+				else
+				{
+					float s = 1.0f - float(cache_position - 3) / float(FORSYTH_CACHE_SIZE - 3);
+					score = powf(s, CACHE_DECAY_POWER);
+				}
+			}
+
+			// Boost vertices with few triangles left, so that we don't leave lone triangles behind
+			score += VALENCE_BOOST_SCALE * powf((float)remaining, -VALENCE_BOOST_POWER);
+			return score;
+		}
+
+		/// Simulates a FIFO cache, the cache holds all vertices with a timestamp within cache_size
+		///	of the current time. The time only increases on misses, which gives FIFO replacement.
+		struct CacheSimulator
+		{
+			CacheSimulator(uint32_t vertex_count, uint32_t cache_size)
+				: timestamps(vertex_count, 0),
+				time(cache_size + 1),
+				cache_size(cache_size)
+			{
+			}
+
+			/// @return Number of cache misses for the triangle
+			uint32_t Triangle(const uint32_t* tri)
+			{
+				uint32_t misses = 0;
+				for (uint32_t k = 0; k < 3; ++k)
+				{
+					if (time - timestamps[tri[k]] > cache_size)
+					{
+						timestamps[tri[k]] = time++;
+						++misses;
+					}
+				}
+				return misses;
+			}
+
+			void Flush()
+			{
+				time += cache_size + 1;
+			}
+
+			vector<uint32_t> timestamps;
+			uint32_t time;
+			uint32_t cache_size;
+		};
+
+		struct Cluster
+		{
+			uint32_t first_triangle;
+			uint32_t triangle_count;
+			float sort_key;
+		};
+
+		void OptimizeVertexFetch(geometry::Stream& stream, uint32_t* indices, uint32_t index_count)
+		{
+			uint32_t vertex_count = uint32_t(stream.data.size() / stream.stride);
+
+			vector<uint32_t> remap(vertex_count, Invalid<uint32_t>());
+
+			vector<uint8_t> data;
+			data.reserve(stream.data.size());
+
+			uint32_t new_count = 0;
+			for (uint32_t i = 0; i < index_count; ++i)
+			{
+				uint32_t& index = remap[indices[i]];
+				if (IsInvalid(index))
+				{
+					index = new_count++;
+					const uint8_t* vertex = stream.data.data() + indices[i] * stream.stride;
+					data.insert(data.end(), vertex, vertex + stream.stride);
+				}
+				indices[i] = index;
+			}
+
+			// Vertices not referenced by any triangle are dropped
+			stream.data.swap(data);
+		}
+	}
+
+	void geometry::ParseOptimizeSettings(const ConfigValue& config, OptimizeSettings& settings)
+	{
+		if (config["vertex_cache"].IsBool())
+			settings.vertex_cache = config["vertex_cache"].AsBool();
+		if (config["overdraw"].IsBool())
+			settings.overdraw = config["overdraw"].AsBool();
+		if (config["vertex_fetch"].IsBool())
+			settings.vertex_fetch = config["vertex_fetch"].AsBool();
+		if (config["overdraw_threshold"].IsNumber())
+			settings.overdraw_threshold = Max(config["overdraw_threshold"].AsFloat(), 1.0f);
+		if (config["cache_size"].IsNumber())
+			settings.cache_size = Max(config["cache_size"].AsUInt(), 3u);
+	}
+
+	float geometry::CalculateACMR(const uint32_t* indices, uint32_t index_count, uint32_t vertex_count, uint32_t cache_size)
+	{
+		uint32_t triangle_count = index_count / 3;
+		if (triangle_count == 0)
+			return 0.0f;
+
+		CacheSimulator cache(vertex_count, cache_size);
+
+		uint32_t misses = 0;
+		for (uint32_t t = 0; t < triangle_count; ++t)
+		{
+			misses += cache.Triangle(indices + t * 3);
+		}
+		return float(misses) / float(triangle_count);
+	}
+
+	void geometry::OptimizeVertexCache(uint32_t* indices, uint32_t index_count, uint32_t vertex_count)
+	{
+		uint32_t triangle_count = index_count / 3;
+		if (triangle_count == 0)
+			return;
+
+		// Build vertex to triangle adjacency, the triangles of vertex v are found at
+		//	adjacency[offsets[v]] to adjacency[offsets[v] + remaining[v]]
+		vector<uint32_t> offsets(vertex_count + 1, 0);
+		for (uint32_t i = 0; i < triangle_count * 3; ++i)
+		{
+			offsets[indices[i] + 1]++;
+		}
+		for (uint32_t v = 0; v < vertex_count; ++v)
+		{
+			offsets[v + 1] += offsets[v];
+		}
+
+		vector<uint32_t> remaining(vertex_count, 0);
+		vector<uint32_t> adjacency(triangle_count * 3);
+		for (uint32_t i = 0; i < triangle_count * 3; ++i)
+		{
+			uint32_t v = indices[i];
+			adjacency[offsets[v] + remaining[v]++] = i / 3;
+		}
+
+		vector<int> cache_positions(vertex_count, -1);
+		vector<float> vertex_scores(vertex_count);
+		for (uint32_t v = 0; v < vertex_count; ++v)
+		{
+			vertex_scores[v] = VertexScore(-1, remaining[v]);
+		}
+
+		vector<float> triangle_scores(triangle_count);
+		for (uint32_t t = 0; t < triangle_count; ++t)
+		{
+			const uint32_t* tri = indices + t * 3;
+			triangle_scores[t] = vertex_scores[tri[0]] + vertex_scores[tri[1]] + vertex_scores[tri[2]];
+		}
+
+		vector<uint8_t> emitted(triangle_count, 0);
+		vector<uint32_t> output;
+		output.reserve(triangle_count * 3);
+
+		uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+		uint32_t cache_count = 0;
+
+		uint32_t next_unemitted = 0;
+		uint32_t best = Invalid<uint32_t>();
+
+		while (output.size() < triangle_count * 3)
+		{
+			if (IsInvalid(best))
+			{
+				// Nothing in the cache is connected to any triangle left, continue with the next
+				//	triangle in input order rather than searching the whole mesh for the best one.
+				while (emitted[next_unemitted])
+					++next_unemitted;
+				best = next_unemitted;
+			}
+
+			const uint32_t* tri = indices + best * 3;
+			output.insert(output.end(), tri, tri + 3);
+			emitted[best] = 1;
+
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				uint32_t v = tri[k];
+
+				// Remove the triangle from the adjacency of the vertex
+				uint32_t* adj = adjacency.data() + offsets[v];
+				for (uint32_t i = 0; i < remaining[v]; ++i)
+				{
+					if (adj[i] == best)
+					{
+						adj[i] = adj[remaining[v] - 1];
+						break;
+					}
+				}
+				--remaining[v];
+			}
+
+			// The vertices of the triangle move to the front of the cache
+			uint32_t new_cache[FORSYTH_CACHE_SIZE + 3];
+			uint32_t new_count = 0;
+			new_cache[new_count++] = tri[0];
+			new_cache[new_count++] = tri[1];
+			new_cache[new_count++] = tri[2];
+			for (uint32_t i = 0; i < cache_count; ++i)
+			{
+				uint32_t v = cache[i];
+				if (v != tri[0] && v != tri[1] && v != tri[2])
+					new_cache[new_count++] = v;
+			}
+
+			// Update the scores of everything that was or is in the cache, including the vertices
+			//	that just dropped out of it.
+			for (uint32_t i = 0; i < new_count; ++i)
+			{
+				uint32_t v = new_cache[i];
+				cache_positions[v] = (i < FORSYTH_CACHE_SIZE) ? (int)i : -1;
+
+				float score = VertexScore(cache_positions[v], remaining[v]);
+				float diff = score - vertex_scores[v];
+				vertex_scores[v] = score;
+
+				const uint32_t* adj = adjacency.data() + offsets[v];
+				for (uint32_t j = 0; j < remaining[v]; ++j)
+				{
+					triangle_scores[adj[j]] += diff;
+				}
+			}
+
+			cache_count = Min(new_count, FORSYTH_CACHE_SIZE);
+			memory::Memcpy(cache, new_cache, cache_count * sizeof(uint32_t));
+
+			// Next triangle is the best one using any vertex in the cache
+			best = Invalid<uint32_t>();
+			float best_score = -FLT_MAX;
+			for (uint32_t i = 0; i < cache_count; ++i)
+			{
+				uint32_t v = cache[i];
+				const uint32_t* adj = adjacency.data() + offsets[v];
+				for (uint32_t j = 0; j < remaining[v]; ++j)
+				{
+					if (triangle_scores[adj[j]] > best_score)
+					{
+						best_score = triangle_scores[adj[j]];
+						best = adj[j];
+					}
+				}
+			}
+		}
+
+		memory::Memcpy(indices, output.data(), output.size() * sizeof(uint32_t));
+	}
+
+	void geometry::OptimizeOverdraw(uint32_t* indices, uint32_t index_count, const uint8_t* positions, uint32_t stride,
+		uint32_t vertex_count, uint32_t cache_size, float threshold)
+	{
+		uint32_t triangle_count = index_count / 3;
+		if (triangle_count < 2)
+			return;
+
+		// Hard boundaries are where the cache is completely missed, reordering the clusters
+		//	between them doesn't affect the ACMR at all.
+		vector<uint32_t> hard_boundaries;
+		{
+			CacheSimulator cache(vertex_count, cache_size);
+			for (uint32_t t = 0; t < triangle_count; ++t)
+			{
+				if (cache.Triangle(indices + t * 3) == 3 || t == 0)
+					hard_boundaries.push_back(t);
+			}
+			hard_boundaries.push_back(triangle_count);
+		}
+
+		// Split the hard clusters further as soon as the ACMR within the cluster gets close enough to
+		//	the ACMR of the whole mesh. More clusters means better sorting at the cost of cache efficiency.
+		float target_acmr = CalculateACMR(indices, index_count, vertex_count, cache_size) * threshold;
+
+		vector<Cluster> clusters;
+		{
+			CacheSimulator cache(vertex_count, cache_size);
+			for (uint32_t h = 0; h + 1 < hard_boundaries.size(); ++h)
+			{
+				uint32_t end = hard_boundaries[h + 1];
+				uint32_t start = hard_boundaries[h];
+				uint32_t misses = 0;
+
+				cache.Flush();
+				for (uint32_t t = start; t < end; ++t)
+				{
+					misses += cache.Triangle(indices + t * 3);
+
+					if (t + 1 == end || float(misses) <= target_acmr * float(t + 1 - start))
+					{
+						Cluster cluster;
+						cluster.first_triangle = start;
+						cluster.triangle_count = t + 1 - start;
+						cluster.sort_key = 0.0f;
+						clusters.push_back(cluster);
+
+						start = t + 1;
+						misses = 0;
+						cache.Flush();
+					}
+				}
+			}
+		}
+
+		if (clusters.size() < 2)
+			return;
+
+		// Area weighted centroid and normal of each cluster
+		vector<float> centroids(clusters.size() * 3, 0.0f);
+		vector<float> normals(clusters.size() * 3, 0.0f);
+
+		float mesh_centroid[3] = { 0.0f, 0.0f, 0.0f };
+		float mesh_area = 0.0f;
+
+		for (uint32_t c = 0; c < clusters.size(); ++c)
+		{
+			float* centroid = &centroids[c * 3];
+			float* normal = &normals[c * 3];
+			float cluster_area = 0.0f;
+
+			for (uint32_t t = clusters[c].first_triangle; t < clusters[c].first_triangle + clusters[c].triangle_count; ++t)
+			{
+				const float* p0 = (const float*)(positions + indices[t * 3 + 0] * stride);
+				const float* p1 = (const float*)(positions + indices[t * 3 + 1] * stride);
+				const float* p2 = (const float*)(positions + indices[t * 3 + 2] * stride);
+
+				float e0[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+				float e1[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+				float n[3] = { e0[1] * e1[2] - e0[2] * e1[1], e0[2] * e1[0] - e0[0] * e1[2], e0[0] * e1[1] - e0[1] * e1[0] };
+
+				float area = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+				for (uint32_t k = 0; k < 3; ++k)
+				{
+					centroid[k] += (p0[k] + p1[k] + p2[k]) * (area / 3.0f);
+					normal[k] += n[k];
+				}
+				cluster_area += area;
+			}
+
+			for (uint32_t k = 0; k < 3; ++k)
+			{
+				mesh_centroid[k] += centroid[k];
+				if (cluster_area > 0.0f)
+					centroid[k] /= cluster_area;
+			}
+			mesh_area += cluster_area;
+		}
+
+		if (mesh_area > 0.0f)
+		{
+			for (uint32_t k = 0; k < 3; ++k)
+				mesh_centroid[k] /= mesh_area;
+		}
+
+		// Clusters facing away from the center of the mesh are likely to occlude the rest and are drawn first
+		for (uint32_t c = 0; c < clusters.size(); ++c)
+		{
+			const float* centroid = &centroids[c * 3];
+			const float* normal = &normals[c * 3];
+
+			float length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			if (length <= 0.0f)
+				continue;
+
+			clusters[c].sort_key = ((centroid[0] - mesh_centroid[0]) * normal[0] + (centroid[1] - mesh_centroid[1]) * normal[1]
+				+ (centroid[2] - mesh_centroid[2]) * normal[2]) / length;
+		}
+
+		std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b)
+		{
+			return a.sort_key > b.sort_key;
+		});
+
+		vector<uint32_t> output;
+		output.reserve(triangle_count * 3);
+		for (auto& cluster : clusters)
+		{
+			const uint32_t* first = indices + cluster.first_triangle * 3;
+			output.insert(output.end(), first, first + cluster.triangle_count * 3);
+		}
+		memory::Memcpy(indices, output.data(), output.size() * sizeof(uint32_t));
+	}
+
+	void geometry::OptimizeMesh(geometry::Mesh& mesh, const OptimizeSettings& settings, OptimizeStats& stats)
+	{
+		Assert(mesh.prim_type == Mesh::TRIANGLE_LIST);
+		if (mesh.streams.size() != 1 || mesh.index_streams.size() != 1)
+		{
+			logging::Warning("OptimizeMesh: Mesh needs to be compressed before optimizing");
+			return;
+		}
+
+		Stream& stream = mesh.streams[0];
+		uint32_t* indices = mesh.index_streams[0].indices.data();
+		uint32_t vertex_count = uint32_t(stream.data.size() / stream.stride);
+
+		const uint8_t* positions = nullptr;
+		for (auto& channel : stream.channels)
+		{
+			if (channel.semantic == Stream::Channel::POSITION)
+			{
+				positions = stream.data.data() + channel.offset;
+				break;
+			}
+		}
+
+		stats.acmr_before = CalculateACMR(indices, mesh.index_count, vertex_count, settings.cache_size);
+
+		// Triangles can only be reordered within their sub mesh
+		if (settings.vertex_cache)
+		{
+			uint32_t offset = 0;
+			for (uint32_t i = 0; i < mesh.sub_meshes.size() || (i == 0 && mesh.sub_meshes.empty()); ++i)
+			{
+				uint32_t count = mesh.sub_meshes.empty() ? mesh.index_count : mesh.sub_meshes[i].index_count;
+				Assert(offset + count <= mesh.index_count);
+
+				OptimizeVertexCache(indices + offset, count, vertex_count);
+				if (settings.overdraw && positions)
+				{
+					OptimizeOverdraw(indices + offset, count, positions, stream.stride, vertex_count,
+						settings.cache_size, settings.overdraw_threshold);
+				}
+				offset += count;
+			}
+		}
+
+		if (settings.vertex_fetch)
+		{
+			OptimizeVertexFetch(stream, indices, mesh.index_count);
+		}
+
+		stats.acmr_after = CalculateACMR(indices, mesh.index_count, uint32_t(stream.data.size() / stream.stride), settings.cache_size);
+	}
+
+} // namespace sb
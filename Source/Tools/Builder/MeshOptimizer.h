@@ -0,0 +1,65 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __BUILDER_MESHOPTIMIZER_H__
+#define __BUILDER_MESHOPTIMIZER_H__
+
+#include "Geometry.h"
+
+namespace sb
+{
+
+	class ConfigValue;
+
+	namespace geometry
+	{
+		struct OptimizeSettings
+		{
+			OptimizeSettings() : vertex_cache(true), overdraw(true), vertex_fetch(true), overdraw_threshold(1.05f), cache_size(16) {}
+
+			bool vertex_cache; ///< Reorder triangles for post-transform vertex cache reuse
+			bool overdraw; ///< Reorder clusters of triangles front to back, requires vertex_cache
+			bool vertex_fetch; ///< Reorder vertices in the order they are first used
+
+			/// How much worse than the vertex cache optimized order the ACMR may get when splitting the
+			///	mesh into clusters for overdraw optimization, 1.05 allows it to get 5% worse.
+			float overdraw_threshold;
+
+			/// Size of the simulated FIFO vertex cache used when measuring ACMR and building clusters
+			uint32_t cache_size;
+		};
+
+		struct OptimizeStats
+		{
+			OptimizeStats() : acmr_before(0.0f), acmr_after(0.0f) {}
+
+			float acmr_before; ///< Average cache miss ratio, transformed vertices per triangle
+			float acmr_after;
+		};
+
+		/// Parses optimization settings, any values not specified in the config are left untouched
+		void ParseOptimizeSettings(const ConfigValue& config, OptimizeSettings& settings);
+
+		/// Calculates the average cache miss ratio (transformed vertices per triangle) for a
+		///	triangle list using a FIFO cache of the specified size.
+		float CalculateACMR(const uint32_t* indices, uint32_t index_count, uint32_t vertex_count, uint32_t cache_size);
+
+		/// Reorders the triangles to improve post-transform vertex cache reuse (Forsyth)
+		void OptimizeVertexCache(uint32_t* indices, uint32_t index_count, uint32_t vertex_count);
+
+		/// Splits a vertex cache optimized triangle list into clusters and sorts them so that
+		///	triangles facing outwards are drawn first (Tipsify-style), reducing overdraw.
+		/// @param positions Vertex positions, three floats at the start of each vertex
+		/// @param stride Bytes between two vertices in positions
+		void OptimizeOverdraw(uint32_t* indices, uint32_t index_count, const uint8_t* positions, uint32_t stride,
+			uint32_t vertex_count, uint32_t cache_size, float threshold);
+
+		/// Runs the enabled optimizations on every sub mesh of a mesh
+		///	The mesh needs to be compressed (see CompressMesh) first.
+		void OptimizeMesh(geometry::Mesh& mesh, const OptimizeSettings& settings, OptimizeStats& stats);
+
+	};
+
+} // namespace sb
+
+
+#endif // __BUILDER_MESHOPTIMIZER_H__
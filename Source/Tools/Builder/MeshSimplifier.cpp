@@ -0,0 +1,359 @@
+// Copyright 2008-2014 Simon Ekström
+
+#include "Common.h"
+
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <math.h>
+
+namespace sb
+{
+
+	namespace
+	{
+		/// Symmetric 4x4 matrix, sum of squared distances to a set of planes
+		struct Quadric
+		{
+			Quadric() { memset(a, 0, sizeof(a)); }
+
+			// a00, a01, a02, a03, a11, a12, a13, a22, a23, a33
+			double a[10];
+
+			void AddPlane(const double* n, double d, double weight)
+			{
+				a[0] += weight * n[0] * n[0]; a[1] += weight * n[0] * n[1]; a[2] += weight * n[0] * n[2]; a[3] += weight * n[0] * d;
+				a[4] += weight * n[1] * n[1]; a[5] += weight * n[1] * n[2]; a[6] += weight * n[1] * d;
+				a[7] += weight * n[2] * n[2]; a[8] += weight * n[2] * d;
+				a[9] += weight * d * d;
+			}
+			void Add(const Quadric& other)
+			{
+				for (uint32_t i = 0; i < 10; ++i)
+					a[i] += other.a[i];
+			}
+
+			/// @return Error of moving to the specified position
+			double Evaluate(const float* p) const
+			{
+				double x = p[0], y = p[1], z = p[2];
+				return a[0] * x * x + 2.0 * a[1] * x * y + 2.0 * a[2] * x * z + 2.0 * a[3] * x
+					+ a[4] * y * y + 2.0 * a[5] * y * z + 2.0 * a[6] * y
+					+ a[7] * z * z + 2.0 * a[8] * z
+					+ a[9];
+			}
+		};
+
+		struct Collapse
+		{
+			uint32_t from;
+			uint32_t to;
+			double cost;
+
+			bool operator<(const Collapse& other) const
+			{
+				return cost < other.cost;
+			}
+		};
+
+		void Cross(const float* p0, const float* p1, const float* p2, double* n)
+		{
+			double e0[3] = { double(p1[0]) - p0[0], double(p1[1]) - p0[1], double(p1[2]) - p0[2] };
+			double e1[3] = { double(p2[0]) - p0[0], double(p2[1]) - p0[1], double(p2[2]) - p0[2] };
+			n[0] = e0[1] * e1[2] - e0[2] * e1[1];
+			n[1] = e0[2] * e1[0] - e0[0] * e1[2];
+			n[2] = e0[0] * e1[1] - e0[1] * e1[0];
+		}
+
+		/// Vertex to triangle adjacency, the triangles of vertex v are triangles[offsets[v]] to triangles[offsets[v + 1]]
+		struct Adjacency
+		{
+			void Build(const vector<uint32_t>& indices, uint32_t vertex_count)
+			{
+				offsets.assign(vertex_count + 1, 0);
+				for (uint32_t i = 0; i < indices.size(); ++i)
+					offsets[indices[i] + 1]++;
+				for (uint32_t v = 0; v < vertex_count; ++v)
+					offsets[v + 1] += offsets[v];
+
+				fill.assign(offsets.begin(), offsets.end() - 1);
+				triangles.resize(indices.size());
+				for (uint32_t i = 0; i < indices.size(); ++i)
+					triangles[fill[indices[i]]++] = i / 3;
+			}
+
+			vector<uint32_t> offsets;
+			vector<uint32_t> fill;
+			vector<uint32_t> triangles;
+		};
+	}
+
+	void geometry::SimplifyTriangles(const uint32_t* indices, uint32_t index_count, const uint8_t* positions, uint32_t stride,
+		uint32_t vertex_count, uint32_t target_index_count, vector<uint32_t>& result)
+	{
+		result.assign(indices, indices + index_count - (index_count % 3));
+		if (result.size() <= target_index_count)
+			return;
+
+		auto position = [positions, stride](uint32_t v) { return (const float*)(positions + v * stride); };
+
+		// Group vertices sharing the same position, vertices in groups of more than one lie on an
+		//	attribute seam and are never moved.
+		vector<uint32_t> position_ids(vertex_count);
+		vector<uint8_t> locked(vertex_count, 0);
+		{
+			vector<uint32_t> order(vertex_count);
+			for (uint32_t v = 0; v < vertex_count; ++v)
+				order[v] = v;
+
+			std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+			{
+				return memcmp(position(a), position(b), 3 * sizeof(float)) < 0;
+			});
+
+			for (uint32_t i = 0; i < vertex_count;)
+			{
+				uint32_t end = i + 1;
+				while (end < vertex_count && memcmp(position(order[i]), position(order[end]), 3 * sizeof(float)) == 0)
+					++end;
+
+				for (uint32_t j = i; j < end; ++j)
+				{
+					position_ids[order[j]] = order[i];
+					locked[order[j]] = (end - i > 1) ? 1 : 0;
+				}
+				i = end;
+			}
+		}
+
+		// Lock vertices on borders, edges only used by a single triangle
+		{
+			vector<uint64_t> edges;
+			edges.reserve(result.size());
+			for (uint32_t i = 0; i < result.size(); i += 3)
+			{
+				for (uint32_t k = 0; k < 3; ++k)
+				{
+					uint32_t a = position_ids[result[i + k]];
+					uint32_t b = position_ids[result[i + (k + 1) % 3]];
+					edges.push_back((uint64_t(Min(a, b)) << 32) | Max(a, b));
+				}
+			}
+			std::sort(edges.begin(), edges.end());
+
+			vector<uint8_t> border(vertex_count, 0);
+			for (uint32_t i = 0; i < edges.size();)
+			{
+				uint32_t end = i + 1;
+				while (end < edges.size() && edges[end] == edges[i])
+					++end;
+
+				if (end - i == 1)
+				{
+					border[uint32_t(edges[i] >> 32)] = 1;
+					border[uint32_t(edges[i] & 0xffffffff)] = 1;
+				}
+				i = end;
+			}
+			for (uint32_t v = 0; v < vertex_count; ++v)
+			{
+				if (border[position_ids[v]])
+					locked[v] = 1;
+			}
+		}
+
+		// Quadrics of the planes of all triangles around each vertex, weighted by area
+		vector<Quadric> quadrics(vertex_count);
+		for (uint32_t i = 0; i < result.size(); i += 3)
+		{
+			const float* p0 = position(result[i]);
+
+			double n[3];
+			Cross(p0, position(result[i + 1]), position(result[i + 2]), n);
+
+			double length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+			if (length <= 0.0)
+				continue;
+
+			n[0] /= length; n[1] /= length; n[2] /= length;
+			double d = -(n[0] * p0[0] + n[1] * p0[1] + n[2] * p0[2]);
+
+			Quadric q;
+			q.AddPlane(n, d, length * 0.5);
+			for (uint32_t k = 0; k < 3; ++k)
+				quadrics[result[i + k]].Add(q);
+		}
+
+		Adjacency adjacency;
+		vector<Collapse> collapses;
+		vector<uint32_t> remap(vertex_count);
+		vector<uint8_t> touched(vertex_count);
+
+		// Every pass collapses the cheapest edges that don't affect each other, then rebuilds the triangle list
+		while (result.size() > target_index_count)
+		{
+			adjacency.Build(result, vertex_count);
+
+			collapses.clear();
+			for (uint32_t i = 0; i < result.size(); i += 3)
+			{
+				for (uint32_t k = 0; k < 3; ++k)
+				{
+					uint32_t a = result[i + k];
+					uint32_t b = result[i + (k + 1) % 3];
+
+					// Both directions of the edge are considered, it may only be possible to collapse one of them
+					for (uint32_t dir = 0; dir < 2; ++dir)
+					{
+						uint32_t from = dir ? b : a;
+						uint32_t to = dir ? a : b;
+						if (locked[from])
+							continue;
+
+						Collapse collapse;
+						collapse.from = from;
+						collapse.to = to;
+						collapse.cost = quadrics[from].Evaluate(position(to)) + quadrics[to].Evaluate(position(to));
+						collapses.push_back(collapse);
+					}
+				}
+			}
+			if (collapses.empty())
+				break;
+
+			std::sort(collapses.begin(), collapses.end());
+
+			for (uint32_t v = 0; v < vertex_count; ++v)
+				remap[v] = v;
+			touched.assign(vertex_count, 0);
+
+			// Every collapse removes about two triangles
+			uint32_t triangles_to_remove = uint32_t(result.size() - target_index_count) / 3;
+			uint32_t collapse_count = 0;
+
+			for (auto& collapse : collapses)
+			{
+				if (collapse_count * 2 >= triangles_to_remove)
+					break;
+				if (touched[collapse.from] || touched[collapse.to])
+					continue;
+
+				// Reject collapses flipping any of the remaining triangles around the vertex
+				bool flips = false;
+				for (uint32_t t = adjacency.offsets[collapse.from]; t < adjacency.offsets[collapse.from + 1] && !flips; ++t)
+				{
+					const uint32_t* tri = &result[adjacency.triangles[t] * 3];
+					if (tri[0] == collapse.to || tri[1] == collapse.to || tri[2] == collapse.to)
+						continue; // Removed by the collapse
+
+					const float* p[3];
+					const float* moved[3];
+					for (uint32_t k = 0; k < 3; ++k)
+					{
+						p[k] = position(tri[k]);
+						moved[k] = (tri[k] == collapse.from) ? position(collapse.to) : p[k];
+					}
+
+					double before[3], after[3];
+					Cross(p[0], p[1], p[2], before);
+					Cross(moved[0], moved[1], moved[2], after);
+					flips = (before[0] * after[0] + before[1] * after[1] + before[2] * after[2]) <= 0.0;
+				}
+				if (flips)
+					continue;
+
+				remap[collapse.from] = collapse.to;
+				quadrics[collapse.to].Add(quadrics[collapse.from]);
+				++collapse_count;
+
+				// The error and flip tests of anything around the collapsed vertex are out of date until the next pass
+				for (uint32_t t = adjacency.offsets[collapse.from]; t < adjacency.offsets[collapse.from + 1]; ++t)
+				{
+					const uint32_t* tri = &result[adjacency.triangles[t] * 3];
+					touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = 1;
+				}
+			}
+			if (collapse_count == 0)
+				break;
+
+			// Apply collapses and drop the degenerate triangles
+			uint32_t write = 0;
+			for (uint32_t i = 0; i < result.size(); i += 3)
+			{
+				uint32_t a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+				if (a == b || b == c || a == c)
+					continue;
+
+				result[write++] = a;
+				result[write++] = b;
+				result[write++] = c;
+			}
+			result.resize(write);
+		}
+	}
+
+	void geometry::GenerateLods(geometry::Mesh& mesh, const vector<LodSettings>& lods)
+	{
+		mesh.lods.clear();
+		if (lods.empty() || mesh.sub_meshes.empty())
+			return;
+
+		if (mesh.streams.size() != 1 || mesh.index_streams.size() != 1)
+		{
+			logging::Warning("GenerateLods: Mesh needs to be compressed first");
+			return;
+		}
+
+		const Stream& stream = mesh.streams[0];
+		uint32_t vertex_count = uint32_t(stream.data.size() / stream.stride);
+
+		const uint8_t* positions = nullptr;
+		for (auto& channel : stream.channels)
+		{
+			if (channel.semantic == Stream::Channel::POSITION)
+			{
+				positions = stream.data.data() + channel.offset;
+				break;
+			}
+		}
+		if (!positions)
+			return;
+
+		// Start from the full detail mesh
+		Lod previous;
+		previous.indices = mesh.index_streams[0].indices;
+		previous.indices.resize(mesh.index_count);
+		for (auto& sub_mesh : mesh.sub_meshes)
+			previous.sub_mesh_counts.push_back(sub_mesh.index_count);
+
+		vector<uint32_t> simplified;
+		for (auto& settings : lods)
+		{
+			Lod lod;
+			lod.screen_size = settings.screen_size;
+
+			uint32_t offset = 0;
+			for (uint32_t i = 0; i < mesh.sub_meshes.size(); ++i)
+			{
+				uint32_t target = uint32_t(mesh.sub_meshes[i].index_count / 3 * settings.ratio) * 3;
+
+				SimplifyTriangles(previous.indices.data() + offset, previous.sub_mesh_counts[i], positions, stream.stride,
+					vertex_count, target, simplified);
+				OptimizeVertexCache(simplified.data(), (uint32_t)simplified.size(), vertex_count);
+
+				lod.indices.insert(lod.indices.end(), simplified.begin(), simplified.end());
+				lod.sub_mesh_counts.push_back((uint32_t)simplified.size());
+				offset += previous.sub_mesh_counts[i];
+			}
+
+			// Not worth a level of its own if it barely removed anything
+			if (lod.indices.size() * 10 > previous.indices.size() * 9)
+				break;
+
+			mesh.lods.push_back(lod);
+			previous = lod;
+		}
+	}
+
+} // namespace sb
@@ -0,0 +1,47 @@
+// Copyright 2008-2014 Simon Ekström
+
+#ifndef __BUILDER_MESHSIMPLIFIER_H__
+#define __BUILDER_MESHSIMPLIFIER_H__
+
+#include "Geometry.h"
+
+namespace sb
+{
+
+	namespace geometry
+	{
+		struct LodSettings
+		{
+			LodSettings() : ratio(0.5f), screen_size(0.5f) {}
+
+			/// Wanted number of triangles relative to the full detail mesh
+			float ratio;
+
+			/// The level is used when the bounding sphere of the mesh covers less than this
+			///	fraction of the viewport height.
+			float screen_size;
+		};
+
+		/// Simplifies a triangle list with quadric error edge collapses
+		///	Vertices are only moved onto other vertices, so the result uses the same vertex buffer.
+		///	Vertices on borders and attribute seams (several vertices sharing the same position)
+		///	are kept in place to avoid holes and texture stretching.
+		/// @param positions Vertex positions, three floats at the start of each vertex
+		/// @param stride Bytes between two vertices in positions
+		/// @param target_index_count Number of indices to stop at, the result may be larger if the
+		///			mesh can't be simplified any further.
+		/// @param result Receives the simplified triangle list
+		void SimplifyTriangles(const uint32_t* indices, uint32_t index_count, const uint8_t* positions, uint32_t stride,
+			uint32_t vertex_count, uint32_t target_index_count, vector<uint32_t>& result);
+
+		/// Generates levels of detail for a compressed mesh, each level is simplified from the
+		///	previous one. Levels that can't be simplified enough are dropped, along with any
+		///	level after them.
+		void GenerateLods(geometry::Mesh& mesh, const vector<LodSettings>& lods);
+
+	};
+
+} // namespace sb
+
+
+#endif // __BUILDER_MESHSIMPLIFIER_H__
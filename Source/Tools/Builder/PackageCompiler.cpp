@@ -23,31 +23,18 @@ namespace sb
 
 	CompilerSystem::Result PackageCompiler::Compile(const FilePath& source_file, const FilePath& target_file, const CompilerSystem::CompilerContext& context)
 	{
-		uint8_t* source_data = 0;
-		uint32_t length = 0;
-
-		{
-			FileStreamPtr file = context.asset_source->OpenFile(source_file.c_str(), File::READ);
-			if (!file.Get() || file->Length() < 0)
-				return CompilerSystem::FAILED;
-
-			length = (uint32_t)file->Length();
-			source_data = (uint8_t*)memory::Malloc(length); // TODO: Temp alloc
-			file->Read(source_data, length);
-
-		}
+		vector<uint8_t> source_data;
+		if (!ReadAsset(context.asset_source, source_file, source_data))
+			return CompilerSystem::FAILED;
 
 		ConfigValue package;
 
 		simplified_json::Reader reader;
-		if (!reader.Read((const char*)source_data, length, package))
+		if (!reader.Read((const char*)source_data.data(), (int64_t)source_data.size(), package))
 		{
-			memory::Free(source_data); // TODO: Temp alloc
 			SetError(reader.GetErrorMessage().c_str());
-
 			return CompilerSystem::FAILED;
 		}
-		memory::Free(source_data); // TODO: Temp alloc
 
 		vector<uint8_t> data;
 		DynamicMemoryStream stream(&data);
@@ -4,6 +4,7 @@
 
 #include "Settings.h"
 #include <Foundation/Container/ConfigValue.h>
+#include <Foundation/Hash/murmur_hash.h>
 
 namespace sb
 {
@@ -27,6 +28,13 @@ namespace sb
 
 
 	}
+	uint64_t build_settings::Hash(const BuildSettings& settings)
+	{
+		// Hash each member separately to not depend on padding
+		uint64_t hash = murmur_hash_64(&settings.hlsl_optimization_level, sizeof(settings.hlsl_optimization_level), 0);
+		hash = murmur_hash_64(&settings.hlsl_debug, sizeof(settings.hlsl_debug), hash);
+		return hash;
+	}
 
 } // namespace sb
 
@@ -18,6 +18,9 @@ namespace sb
 	namespace build_settings
 	{
 		void Load(const ConfigValue& cfg, BuildSettings& settings);
+
+		/// Hashes all settings, used to tell builds with different settings apart
+		uint64_t Hash(const BuildSettings& settings);
 	};
 
 } // namespace sb
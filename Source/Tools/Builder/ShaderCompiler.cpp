@@ -5,11 +5,14 @@
 #include "ShaderCompiler.h"
 #include "ShaderDatabase.h"
 #include "DependencyDatabase.h"
+#include "JobPool.h"
 #include "D3D11/D3D11Platform.h"
 
+#include <Foundation/Hash/murmur_hash.h>
 #include <Foundation/Json/Json.h>
 #include <Foundation/IO/MemoryStream.h>
 #include <Foundation/IO/FileInputBuffer.h>
+#include <Foundation/Thread/Thread.h>
 
 #include <Engine/Rendering/Shader.h>
 #include <Engine/Rendering/ShaderLibrary.h>
@@ -17,9 +20,74 @@
 namespace sb
 {
 
+	namespace
+	{
+		/// Every step:th permutation of a shader, starting at first, compiled as a single job
+		struct PermutationBatch
+		{
+			PermutationBatch() : platform(NULL), first(0), step(1), failed(NULL) {}
+
+			D3D11Platform* platform; ///< Each batch needs its own as the platform isn't thread safe
+			const ShaderDatabase::Shader* shader;
+
+			const vector<const vector<string>*>* options; ///< Options for each permutation
+			ShaderData* results; ///< Result for each permutation
+
+			uint32_t first;
+			uint32_t step;
+
+			volatile long* failed; ///< Set by the first batch to fail, stopping the others
+			string error;
+		};
+
+		void CompilePermutationBatch(void* data, uint32_t index)
+		{
+			PermutationBatch& batch = ((PermutationBatch*)data)[index];
+
+			for (uint32_t i = batch.first; i < batch.options->size() && !*batch.failed; i += batch.step)
+			{
+				const vector<string>& defines = *(*batch.options)[i];
+				ShaderData& shader_data = batch.results[i];
+
+				string permutation_name;
+				batch.shader->BuildName(defines, permutation_name);
+				shader_data.name = permutation_name;
+
+				// Failed results are cleaned up with the rest of the library
+				if (!batch.platform->Compile(*batch.shader, defines, shader_data))
+				{
+					batch.error = batch.platform->GetError();
+					thread::InterlockedExchange(batch.failed, 1);
+					break;
+				}
+
+				logging::Info("Shader permutation '%s' compiled", permutation_name.c_str());
+			}
+		}
+
+		/// Updates the shader in the database and returns a copy of it
+		ShaderDatabase::Shader UpdateShader(ShaderDatabase& shader_database, const FilePath& source_file,
+			const FilePath& shader_name, const ConfigValue& shader_cfg)
+		{
+			ScopedLock<CriticalSection> lock(shader_database.GetLock());
+			if (!shader_database.HasShader(shader_name.c_str()))
+			{
+				shader_database.InsertShader(source_file, shader_cfg);
+			}
+
+			ShaderDatabase::Shader& shader = shader_database.GetShader(shader_name.c_str());
+			shader.Update(shader_cfg);
+			shader.SetDirty(false);
+			return shader;
+		}
+	}
+
 	ShaderCompiler::ShaderCompiler(const ConfigValue& config)
-		: CompilerSystem::Compiler(config)
+		: CompilerSystem::Compiler(config),
+		_thread_count(0)
 	{
+		if (config["threads"].IsNumber())
+			_thread_count = config["threads"].AsUInt();
 	}
 	ShaderCompiler::~ShaderCompiler()
 	{
@@ -40,39 +108,70 @@ namespace sb
 			return CompilerSystem::FAILED;
 		}
 
-		if (!context.shader_database->HasShader(shader_name.c_str()))
-		{
-			context.shader_database->InsertShader(source_file, shader_cfg);
-		}
-
-		ShaderDatabase::Shader& shader = context.shader_database->GetShader(shader_name.c_str());
-		ShaderDatabase::Shader::PermutationMap& permutations = shader.GetPermutations();
-		shader.Update(shader_cfg);
-		shader.SetDirty(false);
-
-		D3D11Platform platform(source_file.Directory(), context);
-		platform.GetCache().RecordDependencies(source_file, context.dependency_database);
-
-		platform.Precompile(shader);
+		// Materials may add permutations while we're compiling, and the batch threads read the shader
+		//	without holding the database lock, so we work on a copy of the shader.
+		ShaderDatabase::Shader shader = UpdateShader(*context.shader_database, source_file, shader_name, shader_cfg);
+		const ShaderDatabase::Shader::PermutationMap& permutations = shader.GetPermutations();
 
 		ShaderLibrary shader_library;
 		shader_library.permutation_count = (uint32_t)permutations.size();
 		shader_library.permutations = new ShaderData[permutations.size()];
 		shader_library.render_resources = NULL;
 
-		uint32_t i = 0;
+		vector<const vector<string>*> options;
 		for (auto& permutation : permutations)
 		{
-			shader_library.permutations[i] = ShaderData();
+			options.push_back(&permutation.second.options);
+		}
 
-			if (!CompilePermutation(shader, permutation.second.options, context, platform, shader_library.permutations[i]))
-				return CompilerSystem::FAILED;
+		JobPool* job_pool = context.job_pool;
 
-			++i;
+		uint32_t thread_count = _thread_count;
+		if (thread_count == 0)
+			thread_count = job_pool ? job_pool->GetThreadCount() + 1 : 1;
+		uint32_t batch_count = Max(Min(thread_count, (uint32_t)options.size()), 1u);
+
+		volatile long failed = 0;
+		vector<PermutationBatch> batches(batch_count);
+		for (uint32_t b = 0; b < batch_count; ++b)
+		{
+			PermutationBatch& batch = batches[b];
+			batch.platform = new D3D11Platform(source_file.Directory(), context);
+			batch.platform->GetCache().RecordDependencies(source_file, context.dependency_database);
+			batch.platform->Precompile(shader);
+
+			batch.shader = &shader;
+			batch.options = &options;
+			batch.results = shader_library.permutations;
+			batch.first = b;
+			batch.step = batch_count;
+			batch.failed = &failed;
+		}
+
+		if (job_pool)
+		{
+			job_pool->Run(CompilePermutationBatch, batches.data(), batch_count);
+		}
+		else
+		{
+			for (uint32_t b = 0; b < batch_count; ++b)
+				CompilePermutationBatch(batches.data(), b);
 		}
 
 		CompilerSystem::Result res = CompilerSystem::SUCCESSFUL;
-		if (shader_library.permutation_count)
+		if (failed)
+		{
+			for (auto& batch : batches)
+			{
+				if (!batch.error.empty())
+				{
+					SetError(batch.error.c_str());
+					break;
+				}
+			}
+			res = CompilerSystem::FAILED;
+		}
+		else if (shader_library.permutation_count)
 		{
 			vector<uint8_t> shader_target_data;
 			DynamicMemoryStream stream(&shader_target_data);
@@ -87,33 +186,58 @@ namespace sb
 		// Cleanup
 		for (uint32_t p = 0; p < shader_library.permutation_count; ++p)
 		{
-			platform.Cleanup(shader_library.permutations[p]);
+			batches[0].platform->Cleanup(shader_library.permutations[p]);
 		}
 
 		delete[] shader_library.permutations;
 
+		for (auto& batch : batches)
+		{
+			delete batch.platform;
+		}
+
 		return res;
 	}
 
-	bool ShaderCompiler::CompilePermutation(const ShaderDatabase::Shader& shader, const vector<string>& defines,
-		const CompilerSystem::CompilerContext&, D3D11Platform& platform,
-		ShaderData& out_shader_data)
+	uint64_t ShaderCompiler::HashInputs(const FilePath& source_file, const CompilerSystem::CompilerContext& context, uint64_t hash)
 	{
-		string permutation_name;
-		FilePath permutation_path;
+		FilePath shader_name = source_file;
+		shader_name.TrimExtension();
+		shader_name.SetSeparator('/');
 
-		shader.BuildName(defines, permutation_name);
-		out_shader_data.name = permutation_name;
+		ScopedLock<CriticalSection> lock(context.shader_database->GetLock());
+		if (!context.shader_database->HasShader(shader_name.c_str()))
+			return hash;
 
-		if (!platform.Compile(shader, defines, out_shader_data))
+		// Permutations are sorted by name so the hash doesn't depend on the order they were requested in
+		ShaderDatabase::Shader& shader = context.shader_database->GetShader(shader_name.c_str());
+		for (auto& permutation : shader.GetPermutations())
 		{
-			platform.Cleanup(out_shader_data);
-			SetError(platform.GetError().c_str());
-			return false;
+			hash = murmur_hash_64(permutation.first.c_str(), (uint32_t)permutation.first.size() + 1, hash);
 		}
+		return hash;
+	}
+	bool ShaderCompiler::OnSkipCompile(const FilePath& source_file, const CompilerSystem::CompilerContext& context)
+	{
+		FilePath shader_name = source_file;
+		shader_name.TrimExtension();
+		shader_name.SetSeparator('/');
 
-		logging::Info("Shader permutation '%s' compiled", permutation_name.c_str());
+		ConfigValue shader_cfg;
+
+		simplified_json::Reader reader;
+		if (!reader.ReadFile(context.asset_source, source_file.c_str(), shader_cfg))
+			return false;
 
+		ScopedLock<CriticalSection> lock(context.shader_database->GetLock());
+		if (!context.shader_database->HasShader(shader_name.c_str()))
+		{
+			context.shader_database->InsertShader(source_file, shader_cfg);
+		}
+
+		ShaderDatabase::Shader& shader = context.shader_database->GetShader(shader_name.c_str());
+		shader.Update(shader_cfg);
+		shader.SetDirty(false);
 		return true;
 	}
 
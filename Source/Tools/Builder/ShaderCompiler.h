@@ -14,6 +14,12 @@ namespace sb
 	struct ShaderData;
 	struct ShaderResourceReflection;
 	class D3D11Platform;
+
+	/// Compiles shaders and all permutations requested by materials
+	///
+	///	Permutations are split into "threads" batches (0, the default, for one per thread in the shared job pool)
+	///		and compiled in parallel on the job pool.
+	///		Compiled programs are cached by their preprocessed source, see ShaderDatabase::GetProgramCache.
 	class ShaderCompiler : public CompilerSystem::Compiler
 	{
 	public:
@@ -72,9 +78,14 @@ namespace sb
 
 		CompilerSystem::Result Compile(const FilePath& source_file, const FilePath& target_path, const CompilerSystem::CompilerContext& context);
 
+		/// Adds the permutations requested by materials to the hash
+		uint64_t HashInputs(const FilePath& source_file, const CompilerSystem::CompilerContext& context, uint64_t hash);
+
+		/// Updates the shader database as Compile would have
+		bool OnSkipCompile(const FilePath& source_file, const CompilerSystem::CompilerContext& context);
+
 	private:
-		bool CompilePermutation(const ShaderDatabase::Shader& shader, const vector<string>& defines, const CompilerSystem::CompilerContext& context,
-			D3D11Platform& platform, ShaderData& out_shader_data);
+		uint32_t _thread_count;
 
 	};
 
@@ -4,11 +4,81 @@
 
 #include "ShaderDatabase.h"
 
+#include <Foundation/Filesystem/MappedFile.h>
 #include <Foundation/Json/Json.h>
 
+#include <algorithm>
+
 namespace sb
 {
 
+	//-------------------------------------------------------------------------------
+	// Database file layout, all sections are laid out directly after each other:
+	//	FileHeader
+	//	FileShader shaders[shader_count], sorted by id
+	//	uint32_t options[option_count], string offsets of option defines
+	//	FilePermutation permutations[permutation_count]
+	//	uint32_t permutation_options[permutation_option_count], indices into the options of the shader
+	//	char strings[string_size]
+	//-------------------------------------------------------------------------------
+	namespace
+	{
+		const char* DATABASE_FILE = ".builder/shader_database";
+
+		const uint32_t FILE_MAGIC = 0x44534253; // "SBSD"
+		const uint32_t FILE_VERSION = 1;
+
+		struct FileHeader
+		{
+			uint32_t magic;
+			uint32_t version;
+
+			uint32_t shader_count;
+			uint32_t option_count;
+			uint32_t permutation_count;
+			uint32_t permutation_option_count;
+			uint32_t string_size;
+			uint32_t padding;
+		};
+		struct FileShader
+		{
+			uint64_t id;
+			uint32_t name; ///< Offset in the string table
+
+			uint32_t first_option;
+			uint32_t option_count;
+
+			uint32_t first_permutation;
+			uint32_t permutation_count;
+			uint32_t padding;
+		};
+		struct FilePermutation
+		{
+			uint32_t first_option;
+			uint32_t option_count;
+		};
+
+		/// Collects the defines of all options in the shader config
+		void ParseOptions(const char* shader_name, const ConfigValue& shader_cfg, vector<string>& options)
+		{
+			options.clear();
+
+			const ConfigValue& options_node = shader_cfg["options"];
+			if (!options_node.IsArray())
+				return;
+
+			for (uint32_t i = 0; i < options_node.Size(); ++i)
+			{
+				if (!options_node[i].IsObject() || !options_node[i]["define"].IsString())
+				{
+					logging::Warning("Invalid options for shader '%s'.", shader_name);
+					continue;
+				}
+				options.push_back(options_node[i]["define"].AsString());
+			}
+		}
+	}
+
 	//-------------------------------------------------------------------------------
 	ShaderDatabase::Shader::Shader(const FilePath& source_path, const ConfigValue& shader_cfg)
 		: _source(source_path.c_str()),
@@ -21,6 +91,7 @@ namespace sb
 
 		_shader_cfg = shader_cfg;
 		Assert(_shader_cfg.IsObject());
+		ParseOptions(_name.c_str(), _shader_cfg, _options);
 
 		// Always preload a shader with 0 options that we can use as default
 		FilePath name = _name;
@@ -28,6 +99,20 @@ namespace sb
 
 		_permutations.insert(pair<string, Permutation>(name.Get(), Permutation()));
 	}
+	ShaderDatabase::Shader::Shader(const FilePath& source_path, const vector<string>& options)
+		: _source(source_path.c_str()),
+		_options(options),
+		_dirty(false)
+	{
+		FilePath path(source_path);
+		path.TrimExtension();
+		_name = path.Get();
+
+		FilePath name = _name;
+		name.TrimExtension();
+
+		_permutations.insert(pair<string, Permutation>(name.Get(), Permutation()));
+	}
 	ShaderDatabase::Shader::~Shader()
 	{
 	}
@@ -49,8 +134,7 @@ namespace sb
 			return true;
 		}
 
-		ConfigValue& options_node = _shader_cfg["options"];
-		if (!options_node.IsArray())
+		if (_options.empty())
 		{
 			// No options available
 			return false;
@@ -69,6 +153,10 @@ namespace sb
 	{
 		return _permutations;
 	}
+	const ShaderDatabase::Shader::PermutationMap& ShaderDatabase::Shader::GetPermutations() const
+	{
+		return _permutations;
+	}
 	void ShaderDatabase::Shader::BuildName(const vector<string>& options, string& name) const
 	{
 		FilePath tmp = _name;
@@ -83,29 +171,12 @@ namespace sb
 		//	we need to make sure they get translated in the right order.
 
 
-		const ConfigValue& options_node = _shader_cfg["options"];
-		if (!options_node.IsArray())
-		{
-			// No options available
-			return;
-		}
-
-		for (uint32_t i = 0; i < options_node.Size(); ++i)
+		for (auto& option : _options)
 		{
-			if (!options_node[i].IsObject() || !options_node[i]["define"].IsString())
-			{
-				logging::Warning("Invalid options for shader '%s'.", _name.c_str());
-				continue;
-			}
-
-			for (vector<string>::const_iterator cit = options.begin(); cit != options.end(); ++cit)
+			if (std::find(options.begin(), options.end(), option) != options.end())
 			{
-				if (*cit == options_node[i]["define"].AsString())
-				{
-					name += ":";
-					name += options_node[i]["define"].AsString();
-					break;
-				}
+				name += ":";
+				name += option;
 			}
 		}
 
@@ -115,32 +186,9 @@ namespace sb
 		// The given options can be in a different order compared to m_options, therefore
 		//	we need to make sure they get translated in the right order.
 
-		const ConfigValue& options_node = _shader_cfg["options"];
-		if (!options_node.IsArray() || options_node.Size() == 0)
-		{
-			if (options.size() == 0)
-				return true;
-			else
-				return false;
-		}
-
-		vector<string>::const_iterator cit, cend;
-		cit = options.begin(); cend = options.end();
-		for (; cit != cend; ++cit)
+		for (auto& option : options)
 		{
-			bool found = false;
-			for (uint32_t i = 0; i < options_node.Size(); ++i)
-			{
-				Assert(options_node[i].IsObject());
-				Assert(options_node[i]["define"].IsString());
-
-				if (*cit == options_node[i]["define"].AsString())
-				{
-					found = true;
-					break;
-				}
-			}
-			if (!found)
+			if (std::find(_options.begin(), _options.end(), option) == _options.end())
 			{
 				// Invalid shader options
 				return false;
@@ -153,6 +201,7 @@ namespace sb
 	{
 		_shader_cfg = shader_cfg;
 		Assert(_shader_cfg.IsObject());
+		ParseOptions(_name.c_str(), _shader_cfg, _options);
 
 		// Validate all permutations as the options may have changed
 		PermutationMap::iterator it, end;
@@ -181,6 +230,10 @@ namespace sb
 	{
 		return _shader_cfg;
 	}
+	const vector<string>& ShaderDatabase::Shader::GetOptions() const
+	{
+		return _options;
+	}
 	bool ShaderDatabase::Shader::IsDirty() const
 	{
 		return _dirty;
@@ -192,7 +245,8 @@ namespace sb
 
 	//-------------------------------------------------------------------------------
 	ShaderDatabase::ShaderDatabase(FileSource* file_source)
-		: _file_source(file_source)
+		: _file_source(file_source),
+		_program_cache(NULL)
 	{
 	}
 	ShaderDatabase::~ShaderDatabase()
@@ -202,116 +256,158 @@ namespace sb
 	{
 		Assert(_file_source);
 
-		ConfigValue root;
-		root.SetEmptyObject();
+		FileHeader header;
+		memset(&header, 0, sizeof(header));
+		header.magic = FILE_MAGIC;
+		header.version = FILE_VERSION;
 
+		vector<FileShader> shaders;
+		vector<uint32_t> options;
+		vector<FilePermutation> permutations;
+		vector<uint32_t> permutation_options;
+		string strings;
 
-		map<StringId64, Shader>::iterator map_it, map_end;
-		map_it = _shaders.begin(); map_end = _shaders.end();
-		for (; map_it != map_end; ++map_it)
+		// Shaders are already sorted by id as they're stored in a map
+		for (auto& entry : _shaders)
 		{
-			ConfigValue& entry = root[map_it->second.GetName().c_str()];
-			entry.SetEmptyObject();
+			const Shader& shader = entry.second;
+
+			FileShader file_shader;
+			file_shader.id = entry.first.GetId();
+			file_shader.name = (uint32_t)strings.size();
+			file_shader.first_option = (uint32_t)options.size();
+			file_shader.option_count = (uint32_t)shader.GetOptions().size();
+			file_shader.first_permutation = (uint32_t)permutations.size();
+			file_shader.permutation_count = 0;
+			file_shader.padding = 0;
 
-			ConfigValue& permutations = entry["permutations"];
-			permutations.SetEmptyArray();
+			strings += shader.GetName();
+			strings += '\0';
 
-			Shader::PermutationMap::const_iterator it, end;
-			it = map_it->second.GetPermutations().begin(); end = map_it->second.GetPermutations().end();
-			for (; it != end; ++it)
+			for (auto& option : shader.GetOptions())
 			{
-				ConfigValue& permutation = permutations.Append();
-				permutation.SetEmptyArray();
-				for (vector<string>::const_iterator per_it = it->second.options.begin(); per_it != it->second.options.end(); ++per_it)
+				options.push_back((uint32_t)strings.size());
+				strings += option;
+				strings += '\0';
+			}
+
+			for (auto& permutation : shader.GetPermutations())
+			{
+				if (permutation.second.options.empty())
+					continue; // Always there
+
+				FilePermutation file_permutation;
+				file_permutation.first_option = (uint32_t)permutation_options.size();
+				file_permutation.option_count = (uint32_t)permutation.second.options.size();
+				for (auto& option : permutation.second.options)
 				{
-					permutation.Append().SetString(per_it->c_str());
+					vector<string>::const_iterator it = std::find(shader.GetOptions().begin(), shader.GetOptions().end(), option);
+					Assert(it != shader.GetOptions().end());
+					permutation_options.push_back((uint32_t)(it - shader.GetOptions().begin()));
 				}
-
+				permutations.push_back(file_permutation);
+				++file_shader.permutation_count;
 			}
+			shaders.push_back(file_shader);
 		}
 
+		header.shader_count = (uint32_t)shaders.size();
+		header.option_count = (uint32_t)options.size();
+		header.permutation_count = (uint32_t)permutations.size();
+		header.permutation_option_count = (uint32_t)permutation_options.size();
+		header.string_size = (uint32_t)strings.size();
+
 		// Make sure .builder folder exists
 		_file_source->MakeDirectory(".builder");
 
-		FileStreamPtr file = _file_source->OpenFile(".builder/shader_database", File::WRITE);
+		FileStreamPtr file = _file_source->OpenFile(DATABASE_FILE, File::WRITE);
 		if (!file.Get())
 		{
 			logging::Warning("Failed to save shader database");
 			return;
 		}
 
-		json::Writer writer;
-		stringstream ss;
-		writer.Write(root, ss, true);
-
-		file->Write(ss.str().c_str(), ss.str().size());
+		file->Write(&header, sizeof(header));
+		file->Write(shaders.data(), shaders.size() * sizeof(FileShader));
+		file->Write(options.data(), options.size() * sizeof(uint32_t));
+		file->Write(permutations.data(), permutations.size() * sizeof(FilePermutation));
+		file->Write(permutation_options.data(), permutation_options.size() * sizeof(uint32_t));
+		file->Write(strings.data(), strings.size());
 
 		logging::Info("Shader database successfully saved.");
 	}
 	bool ShaderDatabase::Load()
 	{
 		Assert(_file_source);
-		ConfigValue root;
 
-		json::Reader reader;
-		if (!reader.ReadFile(_file_source, ".builder/shader_database", root))
+		MappedFile mapped_file;
+		if (!_file_source->MapFile(DATABASE_FILE, mapped_file) || mapped_file.Size() < sizeof(FileHeader))
 		{
-			logging::Warning("Failed loading shader database: %s", reader.GetErrorMessage().c_str());
+			logging::Warning("Failed loading shader database");
 			return false;
 		}
 
-		FilePath shader_path;
-		vector<string> options;
-
+		const uint8_t* data = mapped_file.Data();
+		const FileHeader* header = (const FileHeader*)data;
 
-		ConfigValue::Iterator it, end;
-		it = root.Begin(); end = root.End();
-		for (; it != end; ++it)
+		uint64_t expected_size = sizeof(FileHeader) + uint64_t(header->shader_count) * sizeof(FileShader)
+			+ uint64_t(header->option_count) * sizeof(uint32_t) + uint64_t(header->permutation_count) * sizeof(FilePermutation)
+			+ uint64_t(header->permutation_option_count) * sizeof(uint32_t) + header->string_size;
+		if (header->magic != FILE_MAGIC || header->version != FILE_VERSION || mapped_file.Size() != expected_size
+			|| (header->string_size != 0 && data[mapped_file.Size() - 1] != '\0'))
 		{
-			StringId64 shader_id(it->first);
-			ConfigValue& entry = it->second;
+			logging::Warning("Failed loading shader database: Invalid file");
+			return false;
+		}
 
-			Assert(entry.IsObject());
-			if (!entry.IsObject())
-				continue;
+		const FileShader* shaders = (const FileShader*)(data + sizeof(FileHeader));
+		const uint32_t* options = (const uint32_t*)(shaders + header->shader_count);
+		const FilePermutation* permutations = (const FilePermutation*)(options + header->option_count);
+		const uint32_t* permutation_options = (const uint32_t*)(permutations + header->permutation_count);
+		const char* strings = (const char*)(permutation_options + header->permutation_option_count);
 
-			shader_path.Set(it->first);
-			shader_path += ".shader_src";
+		FilePath shader_path;
+		vector<string> shader_options;
+		vector<string> permutation;
 
-			ConfigValue shader_cfg;
-			if (!reader.ReadFile(_file_source, shader_path.c_str(), shader_cfg))
+		for (uint32_t i = 0; i < header->shader_count; ++i)
+		{
+			const FileShader& file_shader = shaders[i];
+			if (file_shader.name >= header->string_size
+				|| file_shader.first_option + file_shader.option_count > header->option_count
+				|| file_shader.first_permutation + file_shader.permutation_count > header->permutation_count)
 			{
-				logging::Warning("Failed loading shader '%s': %s", shader_path.c_str(), reader.GetErrorMessage().c_str());
-				continue;
+				logging::Warning("Failed loading shader database: Invalid file");
+				_shaders.clear();
+				return false;
 			}
 
-			_shaders.insert(pair<StringId64, Shader>(shader_id,
-				Shader(shader_path, shader_cfg))).first;
-			options.clear();
+			shader_path.Set(strings + file_shader.name);
+			shader_path += ".shader_src";
 
-			Shader& shader = _shaders.find(shader_id)->second;
+			shader_options.clear();
+			for (uint32_t o = 0; o < file_shader.option_count; ++o)
+				shader_options.push_back(strings + options[file_shader.first_option + o]);
 
-			ConfigValue& permutation_node = entry["permutations"];
-			for (uint32_t i = 0; i < permutation_node.Size(); ++i)
+			StringId64 shader_id(strings + file_shader.name);
+			Shader& shader = _shaders.insert(pair<StringId64, Shader>(shader_id,
+				Shader(shader_path, shader_options))).first->second;
+
+			for (uint32_t p = 0; p < file_shader.permutation_count; ++p)
 			{
-				Assert(permutation_node[i].IsArray());
-				if (!permutation_node[i].IsArray())
-					continue;
-				for (uint32_t j = 0; j < permutation_node[i].Size(); ++j)
-				{
-					Assert(permutation_node[i][j].IsString());
-					if (!permutation_node[i][j].IsString())
-						continue;
+				const FilePermutation& file_permutation = permutations[file_shader.first_permutation + p];
 
-					options.push_back(string(permutation_node[i][j].AsString()));
+				permutation.clear();
+				for (uint32_t o = 0; o < file_permutation.option_count; ++o)
+				{
+					uint32_t option = permutation_options[file_permutation.first_option + o];
+					if (option < shader_options.size())
+						permutation.push_back(shader_options[option]);
 				}
-
-				shader.PreloadPermutation(options);
-				options.clear();
+				shader.PreloadPermutation(permutation);
 			}
 
 			shader.SetDirty(false);
-			shader_path.Clear();
 		}
 
 		logging::Info("Shader database successfully loaded.");
@@ -429,6 +525,19 @@ namespace sb
 		}
 	}
 
+	CriticalSection& ShaderDatabase::GetLock()
+	{
+		return _lock;
+	}
+	void ShaderDatabase::SetProgramCache(BuildCache* cache)
+	{
+		_program_cache = cache;
+	}
+	BuildCache* ShaderDatabase::GetProgramCache() const
+	{
+		return _program_cache;
+	}
+
 	//-------------------------------------------------------------------------------
 	void ShaderDatabase::InsertShader(const FilePath& source_path, const ConfigValue& shader_cfg)
 	{
@@ -8,6 +8,8 @@
 namespace sb
 {
 
+	class BuildCache;
+
 	/// Database keeping track of all needed shaded permutations
 	class ShaderDatabase : NonCopyable
 	{
@@ -29,6 +31,10 @@ namespace sb
 
 		public:
 			Shader(const FilePath& source_path, const ConfigValue& shader_cfg);
+
+			/// Creates a shader without a config, used when loading the database
+			/// @param options Defines of the available options, in the order of the config
+			Shader(const FilePath& source_path, const vector<string>& options);
 			~Shader();
 
 			/// Preload a permutation of this shader, this permutation will then be compiled when
@@ -38,6 +44,7 @@ namespace sb
 			bool PreloadPermutation(const vector<string>& options);
 
 			PermutationMap& GetPermutations();
+			const PermutationMap& GetPermutations() const;
 
 
 			/// Builds a name from the specified options
@@ -55,8 +62,12 @@ namespace sb
 			const string& GetName() const;
 			const AssetSource& GetSource() const;
 
+			/// @remark Shaders loaded from the database have no config until updated by the compiler
 			const ConfigValue& GetConfig() const;
 
+			/// @return Defines of the available options, in the order of the config
+			const vector<string>& GetOptions() const;
+
 
 		private:
 			const Shader& operator=(const Shader&) { return *this; }
@@ -64,6 +75,7 @@ namespace sb
 			string _name;
 			AssetSource _source;
 			ConfigValue _shader_cfg;
+			vector<string> _options;
 			PermutationMap _permutations;
 
 			bool _dirty;
@@ -90,6 +102,7 @@ namespace sb
 		/// Save database to file
 		void Save();
 		/// Load database from file
+		///	@remark The database file holds the options of all shaders, so no shader sources are read
 		bool Load();
 
 		void Clear();
@@ -108,13 +121,23 @@ namespace sb
 		/// Adds all dirty shader sources to the given vector
 		void GetDirtyShaders(vector<AssetSource>& sources) const;
 
-	private:
+		/// Lock that compilers need to hold while accessing the database or any of its shaders,
+		///	as assets are compiled in parallel.
+		CriticalSection& GetLock();
+
+		/// Sets the cache for compiled shader programs, NULL to disable caching
+		void SetProgramCache(BuildCache* cache);
 
+		/// @return Cache for compiled shader programs, NULL if none
+		///	The cache is keyed by the preprocessed program source so it can be used without holding the lock.
+		BuildCache* GetProgramCache() const;
 
 	private:
 		FileSource* _file_source;
+		BuildCache* _program_cache;
 
 		map<StringId64, Shader> _shaders;
+		CriticalSection _lock;
 
 	};
 
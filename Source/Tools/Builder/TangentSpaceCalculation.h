@@ -5,6 +5,7 @@
 
 #include <vector>									// STL vector<> 
 #include <map>										// STL map<,,> multimap<>
+#include <cmath>
 
 // derive your proxy from this class
 // not virtual to save the call overhead
@@ -123,7 +124,7 @@ private:	// -----------------------------------------------------------------
 	};
 
 	// helper to get order for CVertexLoadHelper
-	struct CBaseIndexOrder: public std::binary_function< CBaseIndex, CBaseIndex, bool>
+	struct CBaseIndexOrder
 	{
 		bool operator() ( const CBaseIndex &a, const CBaseIndex &b ) const
 		{
@@ -273,7 +274,7 @@ unsigned int CTangentSpaceCalculation<InputProxy>::CalculateTangentSpace( const
 
 			float div	=(fDeltaU1*fDeltaV2-fDeltaU2*fDeltaV1);
 
-			if(_isnan(div))
+			if(std::isnan(div))
 			{
 				bTextureCoordinatesBroken=true;div=0.0f;
 			}
@@ -369,7 +370,7 @@ unsigned int CTangentSpaceCalculation<InputProxy>::CalculateTangentSpace( const
 
 	// adjust the base vectors per vertex -------------------------------------------
 	{
-		std::vector<CBase33>::iterator it;
+		typename std::vector<CBase33>::iterator it;
 		
 		for(it=m_BaseVectors.begin();it!=m_BaseVectors.end();++it)
 		{
@@ -416,7 +417,7 @@ unsigned int CTangentSpaceCalculation<InputProxy>::AddUV2Base( std::multimap<CBa
 	Indx.m_dwPosNo=indwPosNo;
 	Indx.m_dwNormNo=indwNormNo;
 
-	std::multimap<CBaseIndex,unsigned int,CBaseIndexOrder>::iterator iFind,iFindEnd;
+	typename std::multimap<CBaseIndex,unsigned int,CBaseIndexOrder>::iterator iFind,iFindEnd;
 		
 	iFind = inMap.lower_bound(Indx);
 
@@ -496,7 +497,7 @@ void CTangentSpaceCalculation<InputProxy>::AddNormal2Base( std::multimap<CBaseIn
 	Indx.m_dwPosNo=indwPosNo;
 	Indx.m_dwNormNo=indwNormNo;
 
-	std::multimap<CBaseIndex,unsigned int,CBaseIndexOrder>::iterator iFind = inMap.find(Indx);
+	typename std::multimap<CBaseIndex,unsigned int,CBaseIndexOrder>::iterator iFind = inMap.find(Indx);
 
 	unsigned int dwBaseNIndex;
 
@@ -31,6 +31,25 @@ namespace sb
 			}
 		};
 
+		/// Collects the dds output from nvtt in memory
+		struct MemoryOutputHandler : public nvtt::OutputHandler
+		{
+			vector<uint8_t> data;
+
+			void beginImage(int, int, int, int, int, int)
+			{
+			}
+			bool writeData(const void* src, int size)
+			{
+				const uint8_t* bytes = (const uint8_t*)src;
+				data.insert(data.end(), bytes, bytes + size);
+				return true;
+			}
+			void endImage()
+			{
+			}
+		};
+
 
 	};
 
@@ -140,12 +159,14 @@ namespace sb
 		}
 
 		ErrorHandler error_handler;
+		MemoryOutputHandler output_handler;
 
 		nvtt::InputOptions input_options;
 		nvtt::OutputOptions output_options;
 		nvtt::CompressionOptions compress_options;
 
 		output_options.setErrorHandler(&error_handler);
+		output_options.setOutputHandler(&output_handler);
 
 		if (texture_node["mip_maps"].IsNumber())
 		{
@@ -154,17 +175,6 @@ namespace sb
 		}
 
 
-		FilePath target_path;
-		target_path = context.asset_target->GetFullPath();
-		target_path += "/";
-		target_path += target_file.c_str();
-		target_path.SetSeparator('/');
-
-		// Make sure directory exists
-		context.asset_target->MakeDirectory(target_file.Directory().c_str());
-
-		output_options.setFileName(target_path.c_str());
-
 		// In case we have multiple file sources: Make sure all have the same extension
 		string file_ext = texture_paths[0].Extension();
 		for (uint32_t i = 1; i < texture_paths.size(); ++i)
@@ -293,6 +303,25 @@ namespace sb
 		if (!compressor.process(input_options, compress_options, output_options))
 			return CompilerSystem::FAILED;
 
+		// Convert the dds output to the texture resource format, which stores the mips smallest first for streaming
+		TextureDesc desc;
+		vector<image::Surface> surfaces;
+
+		StaticMemoryStream dds_stream(output_handler.data.data(), output_handler.data.size());
+		dds_image::Load(dds_stream, desc, surfaces);
+
+		vector<uint8_t> data;
+		DynamicMemoryStream stream(&data);
+		texture_resource::Compile(desc, surfaces, stream);
+
+		for (auto& surface : surfaces)
+		{
+			memory::Free(surface.data);
+		}
+
+		if (!WriteAsset(context.asset_target, target_file, data.data(), (uint32_t)data.size()))
+			return CompilerSystem::FAILED;
+
 		return CompilerSystem::SUCCESSFUL;
 	}
 
@@ -3,10 +3,18 @@
 #include "Common.h"
 
 #include "BuildServer.h"
+#include "BuildReport.h"
+
+#ifdef SANDBOX_PLATFORM_WIN
 #include "BuildProgressDialog.h"
 #include "BuildServerDialog.h"
+#else
+#include <signal.h>
+#include <unistd.h>
+#endif
 
 #include <Foundation/Filesystem/FileUtil.h>
+#include <Foundation/Timer/Timer.h>
 
 /// Returns the path to the directory for this binary
 void GetBinariesDir(char* bindir, int size)
@@ -14,17 +22,62 @@ void GetBinariesDir(char* bindir, int size)
 	char* buffer = NULL;
 	bindir[0] = 0;
 
+#ifdef SANDBOX_PLATFORM_WIN
 	if (::GetModuleFileNameA(NULL, bindir, size))
 	{
 		buffer = strrchr(bindir, '\\');
-		if (*buffer)
+		if (buffer)
+		{
+			*(buffer + 1) = '\0';
+		}
+	}
+#else
+	ssize_t len = readlink("/proc/self/exe", bindir, size - 1);
+	if (len > 0)
+	{
+		bindir[len] = '\0';
+		buffer = strrchr(bindir, '/');
+		if (buffer)
 		{
 			*(buffer + 1) = '\0';
 		}
 	}
+	else
+	{
+		bindir[0] = '\0';
+	}
+#endif
 }
 
-bool ParseCommandLine(int argc, char* argv[], string& source_path, string& target_path, bool& server_mode)
+/// Resolves a path given on the command line, relative paths are relative to the working directory
+void BuildPath(string& out, const string& working_dir, const string& path)
+{
+	if (sb::file_util::IsAbsolutePath(path))
+	{
+		out = path;
+		sb::file_util::FixSlashes(out);
+	}
+	else
+	{
+		sb::file_util::BuildOSPath(out, working_dir, path);
+	}
+}
+
+struct CommandLine
+{
+	CommandLine() : source_path("Content"), target_path("Binaries/Content"), server_mode(false), force(false) {}
+
+	string source_path;
+	string target_path;
+	string settings_path;	///< Set with --build, runs the builder without any UI
+	string report_path;		///< JSON report
+	string trace_path;		///< Chrome trace
+
+	bool server_mode;
+	bool force;
+};
+
+bool ParseCommandLine(int argc, char* argv[], CommandLine& cmd)
 {
 	int i = 1;
 	while (i < argc)
@@ -37,26 +90,46 @@ bool ParseCommandLine(int argc, char* argv[], string& source_path, string& targe
 		{
 			if ((strcmp(str + 2, "source") == 0) && (i + 1 < argc))
 			{
-				source_path = argv[++i];
+				cmd.source_path = argv[++i];
 			}
 			else if ((strcmp(str + 2, "target") == 0) && (i + 1 < argc))
 			{
-				target_path = argv[++i];
+				cmd.target_path = argv[++i];
+			}
+			else if ((strcmp(str + 2, "build") == 0) && (i + 1 < argc))
+			{
+				cmd.settings_path = argv[++i];
+			}
+			else if ((strcmp(str + 2, "report") == 0) && (i + 1 < argc))
+			{
+				cmd.report_path = argv[++i];
+			}
+			else if ((strcmp(str + 2, "trace") == 0) && (i + 1 < argc))
+			{
+				cmd.trace_path = argv[++i];
 			}
 			else if ((strcmp(str + 2, "server") == 0))
 			{
-				server_mode = true;
+				cmd.server_mode = true;
+			}
+			else if ((strcmp(str + 2, "force") == 0))
+			{
+				cmd.force = true;
 			}
 		}
 		else // Single '-'
 		{
 			if (str[1] == 's' && (i + 1 < argc))
 			{
-				source_path = argv[++i];
+				cmd.source_path = argv[++i];
 			}
 			else if (str[1] == 't' && (i + 1 < argc))
 			{
-				target_path = argv[++i];
+				cmd.target_path = argv[++i];
+			}
+			else if (str[1] == 'f')
+			{
+				cmd.force = true;
 			}
 		}
 
@@ -65,17 +138,135 @@ bool ParseCommandLine(int argc, char* argv[], string& source_path, string& targe
 	return true;
 }
 
-#if 0
-int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int)
+/// Runs the builder on the calling thread without any UI
+/// @return Process exit code, non-zero if the builder failed to start or any asset failed to compile
+int RunHeadless(sb::BuildServer& builder, const CommandLine& cmd, const string& working_dir)
+{
+	using namespace sb;
+
+	if (!builder.IsInitialized())
+	{
+		logging::Error("Builder failed to initialize");
+		return 1;
+	}
+
+	BuildReport report;
+	builder.SetCallback(&report);
+	builder.Run();
+	builder.SetCallback(NULL);
+
+	int result = 0;
+	if (report.GetFailedCount() != 0)
+	{
+		logging::Warning("%d asset(s) failed to compile", report.GetFailedCount());
+		result = 1;
+	}
+
+	string path;
+	if (!cmd.report_path.empty())
+	{
+		BuildPath(path, working_dir, cmd.report_path);
+		if (!report.Write(path.c_str(), BuildReport::JSON))
+			result = 1;
+	}
+	if (!cmd.trace_path.empty())
+	{
+		BuildPath(path, working_dir, cmd.trace_path);
+		if (!report.Write(path.c_str(), BuildReport::CHROME_TRACE))
+			result = 1;
+	}
+	return result;
+}
+
+#ifdef SANDBOX_PLATFORM_WIN
+void RunWithUI(sb::BuildServer& builder, bool server_mode)
+{
+	using namespace sb;
+
+	BuildUICallback* callback = 0;
+	if (server_mode)
+	{
+		callback = new BuildServerDialog(&builder);
+	}
+	else
+	{
+		callback = new BuildProgressDialog();
+	}
+
+	builder.SetCallback(callback);
+
+	SimpleThread builder_thread;
+	builder_thread.Start(&builder);
+
+	while (builder_thread.IsRunning())
+	{
+		MSG msg;
+		while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
+		{
+			if (msg.message == WM_QUIT)
+			{
+				builder.Stop();
+				break;
+			}
+			TranslateMessage(&msg);
+			DispatchMessage(&msg);
+		}
+		Sleep(1);
+	}
+
+	builder.SetCallback(NULL);
+	delete callback;
+}
 #else
-int main()
+namespace
+{
+	volatile sig_atomic_t g_interrupted = 0;
+
+	void OnInterrupt(int)
+	{
+		g_interrupted = 1;
+	}
+}
+
+/// Runs the builder without any UI, in server mode it keeps running until interrupted
+void RunConsole(sb::BuildServer& builder)
+{
+	using namespace sb;
+
+	// Stopping the builder isn't safe from within a signal handler, so the handler only sets
+	//	a flag which we poll while the builder runs on a thread of its own.
+	signal(SIGINT, OnInterrupt);
+	signal(SIGTERM, OnInterrupt);
+
+	SimpleThread builder_thread;
+	builder_thread.Start(&builder);
+
+	while (builder_thread.IsRunning())
+	{
+		if (g_interrupted)
+		{
+			g_interrupted = 0;
+			builder.Stop();
+		}
+		Sleep(10);
+	}
+	builder_thread.Join();
+
+	signal(SIGINT, SIG_DFL);
+	signal(SIGTERM, SIG_DFL);
+}
 #endif
+
+int main(int argc, char* argv[])
 {
 	using namespace sb;
 
+	int result = 0;
+
 	memory::Initialize();
+	timer::Initialize();
 	{
-		
+
 		char base_path[MAX_PATH];
 		GetBinariesDir(base_path, MAX_PATH);
 
@@ -85,64 +276,48 @@ int main()
 
 		logging::Initialize(log_path.c_str());
 
-		BuildUICallback* callback = 0;
-
-		bool server_mode = false;
-		string source_path = "Content";
-		string target_path = "Binaries/Content";
-
-		ParseCommandLine(__argc, __argv, source_path, target_path, server_mode);
+		CommandLine cmd;
+		ParseCommandLine(argc, argv, cmd);
 
 		// Convert the data paths relative to the working directory
 		char working_dir[FILENAME_MAX];
+#ifdef SANDBOX_PLATFORM_WIN
 		GetCurrentDirectory(sizeof(working_dir), working_dir);
+#else
+		if (!getcwd(working_dir, sizeof(working_dir)))
+			working_dir[0] = '\0';
+#endif
 
 		BuilderParams params;
 		params.base_path = base_path;
-		params.force_recompile = false;
-		params.server = server_mode;
+		params.force_recompile = cmd.force;
+
+		BuildPath(params.source_path, working_dir, cmd.source_path);
+		BuildPath(params.target_path, working_dir, cmd.target_path);
+		if (!cmd.settings_path.empty())
+			BuildPath(params.settings_path, working_dir, cmd.settings_path);
 
-		file_util::BuildOSPath(params.source_path, working_dir, source_path);
-		file_util::BuildOSPath(params.target_path, working_dir, target_path);
+		bool headless = !cmd.settings_path.empty();
+		params.server = cmd.server_mode && !headless;
 
 		BuildServer builder(params);
 
-		if (params.server)
+		if (headless)
 		{
-			callback = new BuildServerDialog(&builder);
+			result = RunHeadless(builder, cmd, working_dir);
 		}
 		else
 		{
-			callback = new BuildProgressDialog();
-		}
-
-		builder.SetCallback(callback);
-
-		SimpleThread builder_thread;
-		builder_thread.Start(&builder);
-
-		while (builder_thread.IsRunning())
-		{
-			MSG msg;
-			while (PeekMessage(&msg, NULL, 0, 0, PM_REMOVE))
-			{
-				if (msg.message == WM_QUIT)
-				{
-					builder.Stop();
-					break;
-				}
-				TranslateMessage(&msg);
-				DispatchMessage(&msg);
-			}
-			Sleep(1);
-		}
-
-		if (callback)
-		{
-			delete callback;
+#ifdef SANDBOX_PLATFORM_WIN
+			RunWithUI(builder, params.server);
+#else
+			// There's no UI outside of Windows, log output is all we get there
+			RunConsole(builder);
+#endif
 		}
-
 	}
 	memory::Shutdown();
 	logging::Shutdown();
+
+	return result;
 }
@@ -37,6 +37,18 @@ local macosx_config = {
 	}
 }
 
+local linux_config = {
+	Env = {
+		CPPDEFS = { "SANDBOX_PLATFORM_LINUX" },
+		CXXOPTS = {
+			"-Werror", "-Wall", "-std=c++11",
+			{ "-O0", "-g"; Config = "*-*-debug" },
+			{ "-O2"; Config = {"*-*-release", "*-*-production"} },
+		},
+		LIBS = { "pthread" },
+	}
+}
+
 Build {
 	Units = "units.lua",
 	Passes = {
@@ -51,6 +63,12 @@ Build {
 			DefaultOnHost = "macosx",
 			Tools = { "clang-osx" },
 		},
+		Config {
+			Name = "linux-gcc",
+			Inherit = linux_config,
+			DefaultOnHost = "linux",
+			Tools = { "gcc" },
+		},
 		Config {
 			Name = "win64-vs2013",
 			Inherit = win32_config,
@@ -78,8 +96,7 @@ Build {
 			{ "SANDBOX_DEVELOPMENT"; Config = {"*-*-debug", "*-*-production"} },
 
 			{ "SANDBOX_FILE_TRACKING"; Config = "*-*-debug" },
-			{ "SANDBOX_MEMORY_TRACKING"; Config = "*-*-debug" },
-			-- { "SANDBOX_VERBOSE_TRACKING"; Config = "*-*-debug" }
+			{ "SANDBOX_MEMORY_TRACKING"; Config = {"*-*-debug", "*-*-production"} },
 			
 		},
 	},
@@ -50,8 +50,10 @@ StaticLibrary {
 			Filters = {
 				{ Pattern = "Win"; Config = {"win32-*-*", "win64-*-*"}; },
 				{ Pattern = "Mac"; Config = "macosx-*-*"; },
-				{ Pattern = "Posix"; Config = "macosx-*-*"; },
+				{ Pattern = "Posix"; Config = {"macosx-*-*", "linux-*-*"}; },
+				{ Pattern = "Linux"; Config = "linux-*-*"; },
 				{ Pattern = "Tests"; Config = {}; },
+				{ Pattern = "Benchmarks"; Config = {}; },
 			},
 		},
 	},
@@ -91,7 +93,8 @@ Program {
 			Filters = {
 				{ Pattern = "Win"; Config = {"win32-*-*", "win64-*-*"}; },
 				{ Pattern = "Mac"; Config = "macosx-*-*"; },
-				{ Pattern = "Posix"; Config = "macosx-*-*"; },
+				{ Pattern = "Posix"; Config = {"macosx-*-*", "linux-*-*"}; },
+				{ Pattern = "Linux"; Config = "linux-*-*"; },
 			},
 		},
 		"Source/Tools/Testing/Framework.h",
@@ -112,6 +115,65 @@ Program {
 	},
 }
 
+Program {
+	Name = "Benchmark_Foundation",
+	Target = "Binaries/$(CURRENT_PLATFORM)/Benchmark_Foundation-$(CURRENT_VARIANT).exe",
+	Depends = { "Foundation" },
+	Env = {
+		CPPPATH = { 
+			"Source/Tools/",
+			"Source/Runtime/Foundation",
+			"Source/Runtime/",
+			"External/lua-5.2.3/include",
+		}, 
+		LIBPATH = {
+			{ 
+				"\"$(DXSDK_DIR)/Lib/x86\"",
+				"External/lua-5.2.3/lib/x86"; 
+				Config = "win32-*-*" 
+			},
+			
+			{ 
+				"\"$(DXSDK_DIR)/Lib/x64\""; 
+				"External/lua-5.2.3/lib/x64";
+				Config = "win64-*-*" 
+			},
+		},
+		PROGOPTS = {
+			{ "/SUBSYSTEM:CONSOLE"; Config = {"win32-*-*", "win64-*-*"} },
+		},
+	},
+
+	Sources = {
+		Setup {},
+		FGlob {
+			Dir = "Source/Runtime/Foundation/Benchmarks",
+			Extensions = { ".cpp", ".h", ".inl" },
+			Filters = {
+				{ Pattern = "Win"; Config = {"win32-*-*", "win64-*-*"}; },
+				{ Pattern = "Mac"; Config = "macosx-*-*"; },
+				{ Pattern = "Posix"; Config = {"macosx-*-*", "linux-*-*"}; },
+				{ Pattern = "Linux"; Config = "linux-*-*"; },
+			},
+		},
+		"Source/Tools/Benchmark/Framework.h",
+		"Source/Tools/Benchmark/Framework.cpp"
+	},
+
+	Libs = { 
+		{ 
+			"kernel32.lib", 
+			"user32.lib", 
+			"gdi32.lib", 
+			"comdlg32.lib", 
+			"advapi32.lib", 
+			"ws2_32.lib", 
+			"liblua52.a";
+			Config = { "win32-*-*", "win64-*-*" } 
+		}
+	},
+}
+
 StaticLibrary {
 	Name = "Engine",
 	Env = {
@@ -235,10 +297,20 @@ Program {
 			Filters = {
 				{ Pattern = "Win"; Config = {"win32-*-*", "win64-*-*"}; },
 				{ Pattern = "Mac"; Config = "macosx-*-*"; },
+				{ Pattern = "Posix"; Config = {"macosx-*-*", "linux-*-*"}; },
+				{ Pattern = "Linux"; Config = "linux-*-*"; },
+				{ Pattern = "D3D11"; Config = {"win32-*-*", "win64-*-*"}; },
+				{ Pattern = "Dialog"; Config = {"win32-*-*", "win64-*-*"}; },
+				{ Pattern = "ShaderCompiler"; Config = {"win32-*-*", "win64-*-*"}; },
+				{ Pattern = "TextureCompiler"; Config = {"win32-*-*", "win64-*-*"}; },
+				{ Pattern = "%.rc$"; Config = {"win32-*-*", "win64-*-*"}; },
 			},
 		},
 	},
-	Depends = { "Foundation", "Engine", "RenderD3D11", "Framework" },
+	Depends = { 
+		"Foundation", "Engine", "Framework",
+		{ "RenderD3D11"; Config = {"win32-*-*", "win64-*-*"} },
+	},
 
 	Libs = 
 		{ 